@@ -131,6 +131,10 @@ std::shared_ptr<Analyzer::Expr> LowerExpr::deep_copy() const {
   return makeExpr<LowerExpr>(arg->deep_copy());
 }
 
+std::shared_ptr<Analyzer::Expr> UpperExpr::deep_copy() const {
+  return makeExpr<UpperExpr>(arg->deep_copy());
+}
+
 std::shared_ptr<Analyzer::Expr> CardinalityExpr::deep_copy() const {
   return makeExpr<CardinalityExpr>(arg->deep_copy());
 }
@@ -157,7 +161,7 @@ std::shared_ptr<Analyzer::Expr> AggExpr::deep_copy() const {
                            aggtype,
                            arg == nullptr ? nullptr : arg->deep_copy(),
                            is_distinct,
-                           error_rate);
+                           arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> CaseExpr::deep_copy() const {
@@ -1533,6 +1537,20 @@ void LowerExpr::group_predicates(std::list<const Expr*>& scan_predicates,
   }
 }
 
+void UpperExpr::group_predicates(std::list<const Expr*>& scan_predicates,
+                                 std::list<const Expr*>& join_predicates,
+                                 std::list<const Expr*>& const_predicates) const {
+  std::set<int> rte_idx_set;
+  arg->collect_rte_idx(rte_idx_set);
+  if (rte_idx_set.size() > 1) {
+    join_predicates.push_back(this);
+  } else if (rte_idx_set.size() == 1) {
+    scan_predicates.push_back(this);
+  } else {
+    const_predicates.push_back(this);
+  }
+}
+
 void CardinalityExpr::group_predicates(std::list<const Expr*>& scan_predicates,
                                        std::list<const Expr*>& join_predicates,
                                        std::list<const Expr*>& const_predicates) const {
@@ -1807,7 +1825,7 @@ std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_with_child_targetlist(
                            aggtype,
                            arg ? arg->rewrite_with_child_targetlist(tlist) : nullptr,
                            is_distinct,
-                           error_rate);
+                           arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_agg_to_var(
@@ -2091,6 +2109,14 @@ bool LowerExpr::operator==(const Expr& rhs) const {
   return *arg == *dynamic_cast<const LowerExpr&>(rhs).get_arg();
 }
 
+bool UpperExpr::operator==(const Expr& rhs) const {
+  if (typeid(rhs) != typeid(UpperExpr)) {
+    return false;
+  }
+
+  return *arg == *dynamic_cast<const UpperExpr&>(rhs).get_arg();
+}
+
 bool CardinalityExpr::operator==(const Expr& rhs) const {
   if (typeid(rhs) != typeid(CardinalityExpr)) {
     return false;
@@ -2182,6 +2208,10 @@ bool AggExpr::operator==(const Expr& rhs) const {
   if (aggtype != rhs_ae.get_aggtype() || is_distinct != rhs_ae.get_is_distinct()) {
     return false;
   }
+  if (arg1 != rhs_ae.get_arg1() &&
+      (!arg1 || !rhs_ae.get_arg1() || !(*arg1 == *rhs_ae.get_arg1()))) {
+    return false;
+  }
   if (arg.get() == rhs_ae.get_arg()) {
     return true;
   }
@@ -2508,6 +2538,10 @@ std::string LowerExpr::toString() const {
   return "LOWER(" + arg->toString() + ") ";
 }
 
+std::string UpperExpr::toString() const {
+  return "UPPER(" + arg->toString() + ") ";
+}
+
 std::string CardinalityExpr::toString() const {
   std::string str{"CARDINALITY("};
   str += arg->toString();
@@ -2570,6 +2604,9 @@ std::string AggExpr::toString() const {
     case kSAMPLE:
       agg = "SAMPLE";
       break;
+    case kAPPROX_QUANTILE:
+      agg = "APPROX_PERCENTILE";
+      break;
   }
   std::string str{"(" + agg};
   if (is_distinct) {
@@ -2580,6 +2617,9 @@ std::string AggExpr::toString() const {
   } else {
     str += "*";
   }
+  if (arg1) {
+    str += ", " + arg1->toString();
+  }
   return str + ") ";
 }
 
@@ -2786,6 +2826,15 @@ void LowerExpr::find_expr(bool (*f)(const Expr*),
   }
 }
 
+void UpperExpr::find_expr(bool (*f)(const Expr*),
+                          std::list<const Expr*>& expr_list) const {
+  if (f(this)) {
+    add_unique(expr_list);
+  } else {
+    arg->find_expr(f, expr_list);
+  }
+}
+
 void CardinalityExpr::find_expr(bool (*f)(const Expr*),
                                 std::list<const Expr*>& expr_list) const {
   if (f(this)) {
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../Tests/TestHelpers.h"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../Import/CopyParams.h"
+#include "../../Import/DelimitedParserUtils.h"
+
+std::once_flag setup_flag;
+void global_setup() {
+  TestHelpers::init_logger_stderr_only();
+}
+
+namespace {
+
+constexpr size_t kNumColumns{6};
+
+// Rows of an int, a double, a timestamp, a short and a long string, and an array. With
+// quoted, the strings are quoted and some hold delimiters and escaped quotes.
+std::string generate_rows(const size_t num_rows, const bool quoted) {
+  std::string rows;
+  for (size_t i = 0; i < num_rows; ++i) {
+    rows += std::to_string(i) + ",";
+    rows += std::to_string(i * 0.25) + ",";
+    rows += "2020-01-" + std::to_string(1 + i % 28) + " 12:34:56,";
+    if (quoted) {
+      rows += "\"str_" + std::to_string(i % 100) + "\",";
+      rows += i % 2 ? "\"a longer string, with a \"\"quote\"\" in it\","
+                    : "\"a longer string without any quote in it\",";
+    } else {
+      rows += "str_" + std::to_string(i % 100) + ",";
+      rows += "a longer string without any quote in it,";
+    }
+    rows += "{" + std::to_string(i % 7) + "," + std::to_string(i % 11) + "}\n";
+  }
+  return rows;
+}
+
+void parse_rows(benchmark::State& state, const bool quoted) {
+  std::call_once(setup_flag, global_setup);
+  const auto rows = generate_rows(state.range(0), quoted);
+  Importer_NS::CopyParams copy_params;
+  copy_params.quoted = quoted;
+  const bool is_array[kNumColumns]{false, false, false, false, false, true};
+  const char* buf_end = rows.data() + rows.size();
+  std::vector<std::string_view> row;
+  for (auto _ : state) {
+    size_t num_rows{0};
+    bool try_single_thread{false};
+    for (const char* p = rows.data(); p < buf_end; p++) {
+      row.clear();
+      std::vector<std::unique_ptr<char[]>> tmp_buffers;
+      p = Importer_NS::delimited_parser::get_row(p,
+                                                 buf_end,
+                                                 buf_end,
+                                                 copy_params,
+                                                 is_array,
+                                                 row,
+                                                 tmp_buffers,
+                                                 try_single_thread);
+      benchmark::DoNotOptimize(row.data());
+      ++num_rows;
+    }
+    CHECK_EQ(num_rows, static_cast<size_t>(state.range(0)));
+    CHECK_EQ(row.size(), kNumColumns);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * rows.size());
+}
+
+}  // namespace
+
+//! Split unquoted rows into fields
+static void BM_GetRowUnquoted(benchmark::State& state) {
+  parse_rows(state, false);
+}
+
+BENCHMARK(BM_GetRowUnquoted)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->Unit(benchmark::kMillisecond);
+
+//! Split rows with quoted strings, half of which hold escaped quotes, into fields
+static void BM_GetRowQuoted(benchmark::State& state) {
+  parse_rows(state, true);
+}
+
+BENCHMARK(BM_GetRowQuoted)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
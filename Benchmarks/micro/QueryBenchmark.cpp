@@ -0,0 +1,338 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../Tests/TestHelpers.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../../Calcite/Calcite.h"
+#include "../../Import/Importer.h"
+#include "../../QueryEngine/ArrowResultSet.h"
+#include "../../QueryEngine/CalciteAdapter.h"
+#include "../../QueryEngine/Execute.h"
+#include "../../QueryEngine/ExternalCacheInvalidators.h"
+#include "../../QueryEngine/JoinHashTableInterface.h"
+#include "../../QueryEngine/RelAlgDagBuilder.h"
+#include "../../QueryEngine/ResultSet.h"
+#include "../../QueryRunner/QueryRunner.h"
+#include "../../Shared/Logger.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+using QR = QueryRunner::QueryRunner;
+
+std::once_flag setup_flag;
+void global_setup() {
+  TestHelpers::init_logger_stderr_only();
+  QR::init(BASE_PATH);
+}
+
+namespace {
+
+const std::vector<std::string> kStrings{
+    "foo", "bar", "baz", "hello", "world", "the", "quick", "brown", "fox", "jumped"};
+
+inline void run_ddl_statement(const std::string& stmt) {
+  QR::get()->runDDLStatement(stmt);
+}
+
+std::shared_ptr<ResultSet> run_query(const std::string& query_str) {
+  return QR::get()->runSQL(query_str, ExecutorDeviceType::CPU);
+}
+
+// Creates a table and loads it with rows of the given generator.
+void create_table(const std::string& table_name,
+                  const std::string& columns,
+                  const size_t num_rows,
+                  const std::function<std::vector<std::string>(size_t)>& generate_row) {
+  run_ddl_statement("DROP TABLE IF EXISTS " + table_name + ";");
+  run_ddl_statement("CREATE TABLE " + table_name + " (" + columns +
+                    ") WITH (FRAGMENT_SIZE=1000000);");
+  auto cat = QR::get()->getCatalog();
+  const auto td = cat->getMetadataForTable(table_name);
+  CHECK(td);
+  auto loader = QR::get()->getLoader(td);
+  CHECK(loader);
+  const auto col_descs = loader->get_column_descs();
+  std::vector<std::unique_ptr<Importer_NS::TypedImportBuffer>> import_buffers;
+  for (const auto cd : col_descs) {
+    import_buffers.push_back(std::make_unique<Importer_NS::TypedImportBuffer>(
+        cd, loader->getStringDict(cd)));
+  }
+  for (size_t i = 0; i < num_rows; ++i) {
+    const auto values = generate_row(i);
+    CHECK_EQ(values.size(), import_buffers.size());
+    size_t col_idx = 0;
+    for (const auto cd : col_descs) {
+      import_buffers[col_idx]->add_value(
+          cd, values[col_idx], /*is_null=*/false, Importer_NS::CopyParams());
+      ++col_idx;
+    }
+  }
+  loader->load(import_buffers, num_rows);
+}
+
+// A table of the given row count, with a column of 1000 distinct values, and one of
+// as many distinct values as a tenth of the rows.
+class GroupByFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) override {
+    std::call_once(setup_flag, global_setup);
+    const size_t num_rows = state.range(0);
+    const size_t num_y_values = std::max(num_rows / 10, size_t(1));
+    create_table("micro_group_by",
+                 "x INT, y BIGINT, z DOUBLE, s TEXT ENCODING DICT(32)",
+                 num_rows,
+                 [num_y_values](const size_t i) -> std::vector<std::string> {
+                   return {std::to_string(i % 1000),
+                           std::to_string((i * 7919) % num_y_values),
+                           std::to_string(i * 0.5),
+                           kStrings[i % kStrings.size()]};
+                 });
+    // loads the columns into the buffer pool
+    run_query("SELECT COUNT(*), SUM(x), SUM(y), SUM(z) FROM micro_group_by;");
+  }
+
+  void TearDown(const ::benchmark::State& state) override {
+    run_ddl_statement("DROP TABLE IF EXISTS micro_group_by;");
+  }
+};
+
+// A dimension table with as many distinct keys as a tenth of the rows of the fact
+// table, each of which is joined with ten fact rows.
+class JoinFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) override {
+    std::call_once(setup_flag, global_setup);
+    const size_t num_rows = state.range(0);
+    const size_t num_keys = std::max(num_rows / 10, size_t(1));
+    create_table("micro_join_dim",
+                 "k INT, v INT",
+                 num_keys,
+                 [](const size_t i) -> std::vector<std::string> {
+                   return {std::to_string(i), std::to_string(i % 100)};
+                 });
+    create_table("micro_join_fact",
+                 "x INT, z DOUBLE",
+                 num_rows,
+                 [num_keys](const size_t i) -> std::vector<std::string> {
+                   return {std::to_string((i * 7919) % num_keys),
+                           std::to_string(i * 0.5)};
+                 });
+    run_query("SELECT COUNT(*), SUM(k), SUM(v) FROM micro_join_dim;");
+    run_query("SELECT COUNT(*), SUM(x), SUM(z) FROM micro_join_fact;");
+  }
+
+  void TearDown(const ::benchmark::State& state) override {
+    JoinHashTableCacheInvalidator::invalidateCaches();
+    run_ddl_statement("DROP TABLE IF EXISTS micro_join_fact;");
+    run_ddl_statement("DROP TABLE IF EXISTS micro_join_dim;");
+  }
+};
+
+// A table to plan queries with IN lists of the given length against.
+class InListPlanFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) override {
+    std::call_once(setup_flag, global_setup);
+    run_ddl_statement("DROP TABLE IF EXISTS micro_in_list;");
+    run_ddl_statement("CREATE TABLE micro_in_list (x INT, y INT);");
+    std::string in_list;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      in_list += (i ? ", " : "") + std::to_string(i * 7);
+    }
+    // Calcite expands both into a flat disjunction of equalities. The leading equality
+    // on another column keeps the second one off the bulk decoding of IN lists.
+    in_list_plan_ = get_plan("SELECT COUNT(*) FROM micro_in_list WHERE x IN (" +
+                             in_list + ");");
+    disjunction_plan_ = get_plan(
+        "SELECT COUNT(*) FROM micro_in_list WHERE y = 1 OR x IN (" + in_list + ");");
+  }
+
+  void TearDown(const ::benchmark::State& state) override {
+    run_ddl_statement("DROP TABLE IF EXISTS micro_in_list;");
+  }
+
+ protected:
+  static std::string get_plan(const std::string& query_str) {
+    auto query_state = QR::create_query_state(QR::get()->getSession(), query_str);
+    return QR::get()
+        ->getCalcite()
+        ->process(query_state->createQueryStateProxy(),
+                  pg_shim(query_str),
+                  {},
+                  true,
+                  false,
+                  false,
+                  true)
+        .plan_result;
+  }
+
+  std::string in_list_plan_;
+  std::string disjunction_plan_;
+};
+
+}  // namespace
+
+//! Group by a column of 1000 distinct values, into a perfect hash table
+BENCHMARK_DEFINE_F(GroupByFixture, PerfectHashGroupBy)(benchmark::State& state) {
+  for (auto _ : state) {
+    run_query("SELECT x, COUNT(*), SUM(z) FROM micro_group_by GROUP BY x;");
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(GroupByFixture, PerfectHashGroupBy)
+    ->RangeMultiplier(10)
+    ->Range(10000, 10000000)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Group by two columns of which the combined range is too wide for a perfect hash table
+BENCHMARK_DEFINE_F(GroupByFixture, BaselineHashGroupBy)(benchmark::State& state) {
+  for (auto _ : state) {
+    run_query("SELECT x, y, COUNT(*), SUM(z) FROM micro_group_by GROUP BY x, y;");
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(GroupByFixture, BaselineHashGroupBy)
+    ->RangeMultiplier(10)
+    ->Range(10000, 10000000)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Convert a projection of all rows to an Arrow record batch in shared memory
+BENCHMARK_DEFINE_F(GroupByFixture, ArrowConversion)(benchmark::State& state) {
+  const auto rows = run_query("SELECT x, y, z, s FROM micro_group_by;");
+  const std::vector<std::string> col_names{"x", "y", "z", "s"};
+  std::shared_ptr<Data_Namespace::DataMgr> data_mgr;  // only used on GPU
+  for (auto _ : state) {
+    ArrowResultSetConverter converter(
+        rows, data_mgr, ExecutorDeviceType::CPU, 0, col_names, -1);
+    const auto arrow_result = converter.getArrowResult();
+    state.PauseTiming();
+    ArrowResultSet::deallocateArrowResultBuffer(
+        arrow_result, ExecutorDeviceType::CPU, 0, data_mgr);
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(GroupByFixture, ArrowConversion)
+    ->RangeMultiplier(10)
+    ->Range(10000, 1000000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Build the perfect join hash table of the dimension table
+BENCHMARK_DEFINE_F(JoinFixture, HashTableBuild)(benchmark::State& state) {
+  auto catalog = QR::get()->getCatalog();
+  auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID);
+  executor->setCatalog(catalog.get());
+  ColumnCacheMap column_cache;
+  std::shared_ptr<JoinHashTableInterface> hash_table;
+  for (auto _ : state) {
+    state.PauseTiming();
+    hash_table.reset();
+    column_cache.clear();
+    JoinHashTableCacheInvalidator::invalidateCaches();
+    state.ResumeTiming();
+    hash_table = JoinHashTableInterface::getSyntheticInstance(
+        "micro_join_fact",
+        "x",
+        "micro_join_dim",
+        "k",
+        Data_Namespace::CPU_LEVEL,
+        JoinHashTableInterface::HashType::OneToOne,
+        /*device_count=*/1,
+        column_cache,
+        executor.get());
+    CHECK(hash_table);
+  }
+  state.SetItemsProcessed(state.iterations() * (state.range(0) / 10));
+}
+
+BENCHMARK_REGISTER_F(JoinFixture, HashTableBuild)
+    ->RangeMultiplier(10)
+    ->Range(10000, 10000000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Probe the cached join hash table of the dimension table with all fact rows
+BENCHMARK_DEFINE_F(JoinFixture, HashJoinProbe)(benchmark::State& state) {
+  const std::string query{
+      "SELECT COUNT(*), SUM(d.v) FROM micro_join_fact f, micro_join_dim d WHERE f.x = "
+      "d.k;"};
+  // builds and caches the hash table
+  run_query(query);
+  for (auto _ : state) {
+    run_query(query);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(JoinFixture, HashJoinProbe)
+    ->RangeMultiplier(10)
+    ->Range(10000, 10000000)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Build the RA DAG of a plan with an IN list, of which the literals are decoded in bulk
+BENCHMARK_DEFINE_F(InListPlanFixture, InListPlanParse)(benchmark::State& state) {
+  const auto catalog = QR::get()->getCatalog();
+  for (auto _ : state) {
+    RelAlgDagBuilder dag_builder(in_list_plan_, *catalog, nullptr);
+    benchmark::DoNotOptimize(dag_builder.getRootNode());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(InListPlanFixture, InListPlanParse)
+    ->RangeMultiplier(10)
+    ->Range(100, 100000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+//! Build the RA DAG of the same IN list behind an equality on another column, which
+//! parses every element on its own
+BENCHMARK_DEFINE_F(InListPlanFixture, DisjunctionPlanParse)(benchmark::State& state) {
+  const auto catalog = QR::get()->getCatalog();
+  for (auto _ : state) {
+    RelAlgDagBuilder dag_builder(disjunction_plan_, *catalog, nullptr);
+    benchmark::DoNotOptimize(dag_builder.getRootNode());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(InListPlanFixture, DisjunctionPlanParse)
+    ->RangeMultiplier(10)
+    ->Range(100, 100000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
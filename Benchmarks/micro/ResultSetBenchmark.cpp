@@ -0,0 +1,175 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../Tests/TestHelpers.h"
+
+#include <benchmark/benchmark.h>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../../QueryEngine/Descriptors/RowSetMemoryOwner.h"
+#include "../../QueryEngine/Execute.h"
+#include "../../QueryEngine/ResultSet.h"
+#include "../../QueryEngine/ResultSetReductionJIT.h"
+#include "../../Tests/ResultSetTestUtils.h"
+
+extern bool g_is_test_env;
+
+std::once_flag setup_flag;
+void global_setup() {
+  // keeps the arenas of the row set memory owners small
+  g_is_test_env = true;
+  TestHelpers::init_logger_stderr_only();
+}
+
+namespace {
+
+std::vector<TargetInfo> generate_target_infos() {
+  return generate_custom_agg_target_infos({8},
+                                          {kMAX, kMIN, kCOUNT, kSUM, kAVG},
+                                          {kBIGINT, kBIGINT, kBIGINT, kBIGINT, kDOUBLE},
+                                          {kBIGINT, kBIGINT, kBIGINT, kBIGINT, kBIGINT});
+}
+
+std::unique_ptr<ResultSet> make_result_set(
+    const std::vector<TargetInfo>& target_infos,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const std::shared_ptr<RowSetMemoryOwner>& row_set_mem_owner,
+    NumberGenerator& generator,
+    const size_t step) {
+  auto rs = std::make_unique<ResultSet>(
+      target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
+  const auto storage = rs->allocateStorage();
+  generator.reset();
+  fill_storage_buffer(
+      storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, step);
+  return rs;
+}
+
+// Reduces two result sets of the given layout, of which every other entry is set.
+void reduce(benchmark::State& state, const QueryMemoryDescriptor& query_mem_desc) {
+  const auto target_infos = generate_target_infos();
+  EvenNumberGenerator generator1;
+  EvenNumberGenerator generator2;
+  // the result sets of an iteration are released along with the buffers of the memory
+  // owner at the start of the next one, outside of the timing
+  std::unique_ptr<ResultSet> rs1;
+  std::unique_ptr<ResultSet> rs2;
+  std::unique_ptr<ResultSetManager> rs_manager;
+  for (auto _ : state) {
+    state.PauseTiming();
+    rs_manager.reset();
+    const auto row_set_mem_owner =
+        std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+    rs1 = make_result_set(target_infos, query_mem_desc, row_set_mem_owner, generator1, 2);
+    rs2 = make_result_set(target_infos, query_mem_desc, row_set_mem_owner, generator2, 2);
+    std::vector<ResultSet*> result_sets{rs1.get(), rs2.get()};
+    rs_manager = std::make_unique<ResultSetManager>();
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(rs_manager->reduce(result_sets));
+  }
+  state.SetItemsProcessed(state.iterations() * query_mem_desc.getEntryCount());
+}
+
+}  // namespace
+
+//! Reduce two perfect hash group by buffers of the given entry count
+static void BM_ReducePerfectHash(benchmark::State& state) {
+  std::call_once(setup_flag, global_setup);
+  const auto query_mem_desc =
+      perfect_hash_one_col_desc(generate_target_infos(), 8, 0, state.range(0) - 1);
+  reduce(state, query_mem_desc);
+}
+
+BENCHMARK(BM_ReducePerfectHash)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Reduce two baseline hash group by buffers of the given entry count
+static void BM_ReduceBaselineHash(benchmark::State& state) {
+  std::call_once(setup_flag, global_setup);
+  auto query_mem_desc = baseline_hash_two_col_desc(generate_target_infos(), 8);
+  query_mem_desc.setEntryCount(state.range(0));
+  reduce(state, query_mem_desc);
+}
+
+BENCHMARK(BM_ReduceBaselineHash)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+namespace {
+
+// Sorts a perfect hash group by buffer of the given entry count on an aggregate.
+void sort(benchmark::State& state, const size_t top_n) {
+  const auto target_infos = generate_target_infos();
+  const auto query_mem_desc =
+      perfect_hash_one_col_desc(target_infos, 8, 0, state.range(0) - 1);
+  ReverseOddOrEvenNumberGenerator generator(state.range(0) - 1);
+  const std::list<Analyzer::OrderEntry> order_entries{{2, false, false}};
+  std::unique_ptr<ResultSet> rs;
+  for (auto _ : state) {
+    state.PauseTiming();
+    rs.reset();
+    const auto row_set_mem_owner =
+        std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+    rs = make_result_set(target_infos, query_mem_desc, row_set_mem_owner, generator, 1);
+    state.ResumeTiming();
+    rs->sort(order_entries, top_n);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+//! Sort all rows of a perfect hash group by buffer of the given entry count
+static void BM_Sort(benchmark::State& state) {
+  std::call_once(setup_flag, global_setup);
+  sort(state, 0);
+}
+
+BENCHMARK(BM_Sort)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Sort the top 100 rows of a perfect hash group by buffer of the given entry count
+static void BM_SortTopN(benchmark::State& state) {
+  std::call_once(setup_flag, global_setup);
+  sort(state, 100);
+}
+
+BENCHMARK(BM_SortTopN)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  ResultSetReductionJIT::clearCache();
+  return 0;
+}
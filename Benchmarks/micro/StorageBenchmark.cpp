@@ -0,0 +1,170 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../Tests/TestHelpers.h"
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../../DataMgr/BufferMgr/CpuBufferMgr/CpuBufferMgr.h"
+#include "../../DataMgr/FileMgr/GlobalFileMgr.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+std::once_flag setup_flag;
+void global_setup() {
+  TestHelpers::init_logger_stderr_only();
+}
+
+namespace {
+
+constexpr size_t kBufferPoolSize{256 * 1024 * 1024};
+constexpr size_t kPageSize{512};
+
+const ChunkKey kFileMgrTableKey{1, 1};
+
+ChunkKey chunk_key(const int fragment_id) {
+  return {1, 1, 1, fragment_id};
+}
+
+class FileMgrDirectory {
+ public:
+  FileMgrDirectory() : path_(boost::filesystem::path(BASE_PATH) / "micro_file_mgr") {
+    boost::filesystem::remove_all(path_);
+    boost::filesystem::create_directories(path_);
+  }
+
+  ~FileMgrDirectory() { boost::filesystem::remove_all(path_); }
+
+  std::string string() const { return path_.string(); }
+
+ private:
+  const boost::filesystem::path path_;
+};
+
+}  // namespace
+
+//! Allocate buffers of the given size in a pool which fits them all, and delete them
+static void BM_BufferMgrAllocate(benchmark::State& state) {
+  std::call_once(setup_flag, global_setup);
+  const size_t buffer_size = state.range(0);
+  const size_t num_buffers = kBufferPoolSize / buffer_size / 2;
+  Buffer_Namespace::CpuBufferMgr buffer_mgr(
+      0, kBufferPoolSize, nullptr, kBufferPoolSize, kPageSize);
+  for (auto _ : state) {
+    for (size_t i = 0; i < num_buffers; ++i) {
+      auto buffer = buffer_mgr.createBuffer(chunk_key(i), kPageSize, buffer_size);
+      buffer->unPin();
+    }
+    for (size_t i = 0; i < num_buffers; ++i) {
+      buffer_mgr.deleteBuffer(chunk_key(i));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_buffers);
+}
+
+BENCHMARK(BM_BufferMgrAllocate)
+    ->RangeMultiplier(8)
+    ->Range(4 * 1024, 16 * 1024 * 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+//! Allocate buffers of the given size in a full pool, each evicting the least recently
+//! used one
+static void BM_BufferMgrEvict(benchmark::State& state) {
+  std::call_once(setup_flag, global_setup);
+  const size_t buffer_size = state.range(0);
+  const size_t num_buffers = kBufferPoolSize / buffer_size;
+  Buffer_Namespace::CpuBufferMgr buffer_mgr(
+      0, kBufferPoolSize, nullptr, kBufferPoolSize, kPageSize);
+  int fragment_id{0};
+  for (size_t i = 0; i < num_buffers; ++i) {
+    auto buffer =
+        buffer_mgr.createBuffer(chunk_key(fragment_id++), kPageSize, buffer_size);
+    buffer->unPin();
+  }
+  for (auto _ : state) {
+    auto buffer =
+        buffer_mgr.createBuffer(chunk_key(fragment_id++), kPageSize, buffer_size);
+    buffer->unPin();
+  }
+  CHECK_LE(buffer_mgr.getNumChunks(), num_buffers);
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_BufferMgrEvict)
+    ->RangeMultiplier(8)
+    ->Range(4 * 1024, 16 * 1024 * 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+//! Write a new chunk of the given size and checkpoint it
+static void BM_FileMgrWrite(benchmark::State& state) {
+  std::call_once(setup_flag, global_setup);
+  const size_t chunk_size = state.range(0);
+  std::vector<int8_t> data(chunk_size, 42);
+  FileMgrDirectory directory;
+  File_Namespace::GlobalFileMgr file_mgr(0, directory.string());
+  int fragment_id{0};
+  for (auto _ : state) {
+    if (fragment_id) {
+      // frees the pages of the previous chunk for reuse, which bounds the file size
+      state.PauseTiming();
+      file_mgr.deleteBuffer(chunk_key(fragment_id - 1));
+      file_mgr.checkpoint(kFileMgrTableKey[0], kFileMgrTableKey[1]);
+      state.ResumeTiming();
+    }
+    auto buffer = file_mgr.createBuffer(chunk_key(fragment_id++));
+    buffer->write(data.data(), chunk_size);
+    file_mgr.checkpoint(kFileMgrTableKey[0], kFileMgrTableKey[1]);
+  }
+  state.SetBytesProcessed(state.iterations() * chunk_size);
+}
+
+BENCHMARK(BM_FileMgrWrite)
+    ->RangeMultiplier(8)
+    ->Range(64 * 1024, 64 * 1024 * 1024)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Read a checkpointed chunk of the given size, mostly from the page cache of the OS
+static void BM_FileMgrRead(benchmark::State& state) {
+  std::call_once(setup_flag, global_setup);
+  const size_t chunk_size = state.range(0);
+  std::vector<int8_t> data(chunk_size, 42);
+  FileMgrDirectory directory;
+  File_Namespace::GlobalFileMgr file_mgr(0, directory.string());
+  auto buffer = file_mgr.createBuffer(chunk_key(0));
+  buffer->write(data.data(), chunk_size);
+  file_mgr.checkpoint(kFileMgrTableKey[0], kFileMgrTableKey[1]);
+  for (auto _ : state) {
+    file_mgr.getBuffer(chunk_key(0))->read(data.data(), chunk_size);
+    benchmark::DoNotOptimize(data.data());
+  }
+  state.SetBytesProcessed(state.iterations() * chunk_size);
+}
+
+BENCHMARK(BM_FileMgrRead)
+    ->RangeMultiplier(8)
+    ->Range(64 * 1024, 64 * 1024 * 1024)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
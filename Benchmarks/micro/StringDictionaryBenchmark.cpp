@@ -0,0 +1,121 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../Tests/TestHelpers.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../../StringDictionary/StringDictionary.h"
+
+std::once_flag setup_flag;
+void global_setup() {
+  TestHelpers::init_logger_stderr_only();
+}
+
+namespace {
+
+// Distinct strings of the given count, numbered with a few digits out of order to spread
+// them over the hash table.
+std::vector<std::string> generate_strings(const size_t count) {
+  std::vector<std::string> strings;
+  strings.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    strings.push_back("string_" + std::to_string((i * 7919) % count) + "_" +
+                      std::to_string(i));
+  }
+  return strings;
+}
+
+}  // namespace
+
+//! Encode a batch of strings of which a quarter are duplicates into a fresh dictionary
+static void BM_GetOrAddBulk(benchmark::State& state) {
+  std::call_once(setup_flag, global_setup);
+  const auto num_strings = static_cast<size_t>(state.range(0));
+  auto strings = generate_strings(num_strings * 3 / 4);
+  strings.insert(strings.end(), strings.begin(), strings.begin() + num_strings / 4);
+  std::vector<int32_t> ids(strings.size());
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto dict = std::make_unique<StringDictionary>("", /*isTemp=*/true, false);
+    state.ResumeTiming();
+    dict->getOrAddBulk(strings, ids.data());
+    benchmark::DoNotOptimize(ids.data());
+    state.PauseTiming();
+    dict.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * strings.size());
+}
+
+BENCHMARK(BM_GetOrAddBulk)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Encode a batch of strings which are all in the dictionary already
+static void BM_GetOrAddBulkExisting(benchmark::State& state) {
+  std::call_once(setup_flag, global_setup);
+  const auto strings = generate_strings(state.range(0));
+  StringDictionary dict("", /*isTemp=*/true, false);
+  std::vector<int32_t> ids(strings.size());
+  dict.getOrAddBulk(strings, ids.data());
+  for (auto _ : state) {
+    dict.getOrAddBulk(strings, ids.data());
+    benchmark::DoNotOptimize(ids.data());
+  }
+  state.SetItemsProcessed(state.iterations() * strings.size());
+}
+
+BENCHMARK(BM_GetOrAddBulkExisting)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Match a LIKE pattern against all strings of a dictionary, without the LIKE cache
+static void BM_GetLike(benchmark::State& state) {
+  std::call_once(setup_flag, global_setup);
+  const auto strings = generate_strings(state.range(0));
+  StringDictionary dict("", /*isTemp=*/true, false);
+  std::vector<int32_t> ids(strings.size());
+  dict.getOrAddBulk(strings, ids.data());
+  const auto generation = dict.storageEntryCount();
+  size_t num_added{0};
+  for (auto _ : state) {
+    state.PauseTiming();
+    // adding a string invalidates the cached result of the pattern
+    dict.getOrAdd("added_" + std::to_string(num_added++));
+    state.ResumeTiming();
+    const auto matches = dict.getLike("%_12%", false, false, '\\', generation);
+    benchmark::DoNotOptimize(matches.data());
+  }
+  state.SetItemsProcessed(state.iterations() * generation);
+}
+
+BENCHMARK(BM_GetLike)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
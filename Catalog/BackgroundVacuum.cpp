@@ -0,0 +1,173 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Catalog/BackgroundVacuum.h"
+
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Catalog/Catalog.h"
+#include "DataMgr/Chunk/Chunk.h"
+#include "LockMgr/LockMgr.h"
+#include "Shared/Logger.h"
+
+namespace Catalog_Namespace {
+
+BackgroundVacuum::BackgroundVacuum(const Catalog& catalog,
+                                   const size_t interval_ms,
+                                   const double threshold,
+                                   const size_t max_bytes_per_sec)
+    : catalog_(catalog)
+    , interval_ms_(interval_ms)
+    , threshold_(threshold)
+    , max_bytes_per_sec_(max_bytes_per_sec) {
+  vacuum_thread_ = std::thread(&BackgroundVacuum::vacuumPeriodically, this);
+}
+
+BackgroundVacuum::~BackgroundVacuum() {
+  {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    stop_ = true;
+  }
+  stop_cv_.notify_all();
+  vacuum_thread_.join();
+}
+
+size_t BackgroundVacuum::vacuum() {
+  std::vector<std::string> table_names;
+  for (const auto td : catalog_.getAllTableMetadata()) {
+    if (td->shard < 0 && !td->isView && td->hasDeletedCol) {
+      table_names.push_back(td->tableName);
+    }
+  }
+  size_t num_vacuumed{0};
+  for (const auto& table_name : table_names) {
+    try {
+      num_vacuumed += vacuumTable(table_name);
+    } catch (const std::exception& e) {
+      // e.g. the table was dropped meanwhile
+      LOG(WARNING) << "Could not vacuum table " << table_name << ": " << e.what();
+    }
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    if (stop_) {
+      break;
+    }
+  }
+  return num_vacuumed;
+}
+
+size_t BackgroundVacuum::vacuumTable(const std::string& table_name) {
+  // the fragments to vacuum, by physical table
+  std::vector<std::pair<int, FragmentDeletedRows>> fragments;
+  int logical_table_id;
+  {
+    const auto td_with_lock =
+        lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+            catalog_, table_name);
+    const auto td = td_with_lock();
+    CHECK(td);
+    logical_table_id = td->tableId;
+    const auto data_lock =
+        lockmgr::TableDataLockMgr::getReadLockForTable(catalog_, table_name);
+    for (const auto physical_td : catalog_.getPhysicalTablesDescriptors(td)) {
+      for (const auto& counts : catalog_.getDeletedRowCounts(physical_td)) {
+        if (counts.num_deleted_rows &&
+            counts.num_deleted_rows >= threshold_ * counts.num_rows) {
+          fragments.emplace_back(physical_td->tableId, counts);
+        }
+      }
+    }
+  }
+
+  size_t num_vacuumed{0};
+  for (const auto& [table_id, counts] : fragments) {
+    {
+      const auto td_with_lock =
+          lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+              catalog_, table_name);
+      const auto td = td_with_lock();
+      if (!td || td->tableId != logical_table_id) {
+        break;  // dropped and created again meanwhile
+      }
+      const auto physical_td = catalog_.getMetadataForTable(table_id);
+      CHECK(physical_td);
+      // read the fragment from disk while queries and inserts go on, the chunks stay
+      // pinned in the CPU buffer pool until compacted
+      std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks;
+      {
+        const auto data_lock =
+            lockmgr::TableDataLockMgr::getReadLockForTable(catalog_, table_name);
+        chunks = catalog_.loadFragmentChunks(physical_td, counts.fragment_id);
+      }
+      // no inserts until the compacted fragment is checkpointed
+      const auto insert_data_lock =
+          lockmgr::InsertDataLockMgr::getWriteLockForTable(catalog_, table_name);
+      VLOG(1) << "Vacuuming fragment " << counts.fragment_id << " of table "
+              << table_name << ", " << counts.num_deleted_rows << " of "
+              << counts.num_rows << " rows deleted";
+      {
+        // the chunks are compacted in place, so no queries meanwhile, which only
+        // takes moving the rows in memory and swapping the fragment metadata
+        const auto data_lock =
+            lockmgr::TableDataLockMgr::getWriteLockForTable(catalog_, table_name);
+        catalog_.vacuumDeletedRows(physical_td, counts.fragment_id, false);
+      }
+      chunks.clear();
+      if (td->persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL) {
+        const auto data_lock =
+            lockmgr::TableDataLockMgr::getReadLockForTable(catalog_, table_name);
+        catalog_.checkpoint(logical_table_id);
+      }
+      ++num_vacuumed;
+    }
+    if (!throttle(counts.num_bytes)) {
+      break;
+    }
+  }
+  if (num_vacuumed) {
+    LOG(INFO) << "Vacuumed " << num_vacuumed << " fragments of table " << table_name;
+  }
+  return num_vacuumed;
+}
+
+bool BackgroundVacuum::throttle(const size_t num_bytes) {
+  std::unique_lock<std::mutex> lock(thread_mutex_);
+  if (max_bytes_per_sec_) {
+    const auto wait_us = static_cast<int64_t>(num_bytes * 1000000 / max_bytes_per_sec_);
+    stop_cv_.wait_for(
+        lock, std::chrono::microseconds(wait_us), [this] { return stop_; });
+  }
+  return !stop_;
+}
+
+void BackgroundVacuum::vacuumPeriodically() {
+  std::unique_lock<std::mutex> lock(thread_mutex_);
+  while (!stop_cv_.wait_for(
+      lock, std::chrono::milliseconds(interval_ms_), [this] { return stop_; })) {
+    lock.unlock();
+    try {
+      vacuum();
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Background vacuum of database " << catalog_.name()
+                 << " failed: " << e.what();
+    }
+    lock.lock();
+  }
+}
+
+}  // namespace Catalog_Namespace
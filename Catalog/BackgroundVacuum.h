@@ -0,0 +1,75 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    BackgroundVacuum.h
+ * @brief   Incremental vacuuming of deleted rows in the background.
+ *
+ * OPTIMIZE TABLE ... WITH (VACUUM='true') compacts every fragment with deleted rows while
+ * holding the table locks for the whole table. The background vacuum instead picks the
+ * fragments of which a large enough fraction of the rows is deleted, and compacts them
+ * one at a time: the table is locked for the compaction of a single fragment, which is
+ * swapped in by a checkpoint before the locks are released. Between two fragments, the
+ * vacuum waits for as long as rewriting the fragment takes at the configured rate, which
+ * bounds the I/O it adds.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Catalog_Namespace {
+
+class Catalog;
+
+class BackgroundVacuum {
+ public:
+  // Vacuums the tables of the catalog every interval_ms milliseconds, rewriting at most
+  // max_bytes_per_sec bytes per second, or without limit if 0.
+  BackgroundVacuum(const Catalog& catalog,
+                   const size_t interval_ms,
+                   const double threshold,
+                   const size_t max_bytes_per_sec);
+
+  ~BackgroundVacuum();
+
+  // Vacuums the fragments of which at least threshold of the rows are deleted, in all
+  // tables of the catalog. Returns the number of fragments vacuumed.
+  size_t vacuum();
+
+ private:
+  size_t vacuumTable(const std::string& table_name);
+  // Waits for the I/O budget spent on rewriting the given bytes. Returns false if the
+  // vacuum is stopped meanwhile.
+  bool throttle(const size_t num_bytes);
+  void vacuumPeriodically();
+
+  const Catalog& catalog_;
+  const size_t interval_ms_;
+  const double threshold_;
+  const size_t max_bytes_per_sec_;
+
+  std::mutex thread_mutex_;
+  std::condition_variable stop_cv_;
+  bool stop_{false};
+  std::thread vacuum_thread_;
+};
+
+}  // namespace Catalog_Namespace
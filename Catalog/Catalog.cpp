@@ -43,6 +43,7 @@
 #include <random>
 #include <regex>
 #include <sstream>
+#include <thread>
 #if BOOST_VERSION >= 106600
 #include <boost/uuid/detail/sha1.hpp>
 #else
@@ -56,10 +57,12 @@
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/TableOptimizer.h"
 
+#include "Catalog/BackgroundVacuum.h"
 #include "DataMgr/FileMgr/FileMgr.h"
 #include "DataMgr/FileMgr/GlobalFileMgr.h"
 #include "DataMgr/ForeignStorage/ForeignStorageInterface.h"
 #include "Fragmenter/Fragmenter.h"
+#include "Fragmenter/InsertLog.h"
 #include "Fragmenter/SortedOrderFragmenter.h"
 #include "LockMgr/LockMgr.h"
 #include "MigrationMgr/MigrationMgr.h"
@@ -94,6 +97,19 @@ extern bool g_cache_string_hash;
 // under unit testing.
 bool g_serialize_temp_tables{false};
 
+// Make inserts durable with a per-database log instead of a table checkpoint, and fold
+// the log into the tables every g_insert_log_fold_interval_ms milliseconds.
+bool g_enable_insert_log{false};
+size_t g_insert_log_fold_interval_ms{5000};
+
+// Vacuum, every g_background_vacuum_interval_ms milliseconds, the fragments of which at
+// least g_background_vacuum_threshold of the rows are deleted, rewriting at most
+// g_background_vacuum_max_mb_per_sec MB per second (0 for no limit).
+bool g_enable_background_vacuum{false};
+size_t g_background_vacuum_interval_ms{60000};
+double g_background_vacuum_threshold{0.2};
+size_t g_background_vacuum_max_mb_per_sec{100};
+
 namespace Catalog_Namespace {
 
 const int DEFAULT_INITIAL_VERSION = 1;  // start at version 1
@@ -185,9 +201,20 @@ Catalog::Catalog(const string& basePath,
   if (g_serialize_temp_tables) {
     boost::filesystem::remove(table_json_filepath(basePath_, currentDB_.dbName));
   }
+  openInsertLog();
+  if (g_enable_background_vacuum && !SysCatalog::instance().isAggregator()) {
+    backgroundVacuum_ =
+        std::make_unique<BackgroundVacuum>(*this,
+                                           g_background_vacuum_interval_ms,
+                                           g_background_vacuum_threshold,
+                                           g_background_vacuum_max_mb_per_sec << 20);
+  }
 }
 
 Catalog::~Catalog() {
+  // vacuuming and folding the insert log wait for the catalog locks
+  backgroundVacuum_.reset();
+  insertLog_.reset();
   cat_write_lock write_lock(this);
   // must clean up heap-allocated TableDescriptor and ColumnDescriptor structs
   for (TableDescriptorMap::iterator tableDescIt = tableDescriptorMap_.begin();
@@ -619,6 +646,16 @@ void Catalog::createFsiSchemasAndDefaultServers() {
   sqliteConnector_.query("END TRANSACTION");
 }
 
+void Catalog::createColumnStatisticsSchema() {
+  cat_sqlite_lock sqlite_lock(this);
+  sqliteConnector_.query(getColumnStatisticsSchema(true));
+}
+
+void Catalog::createSpatialIndexSchema() {
+  cat_sqlite_lock sqlite_lock(this);
+  sqliteConnector_.query(getSpatialIndexSchema(true));
+}
+
 void Catalog::dropFsiSchemasAndTables() {
   std::vector<foreign_storage::ForeignTable> foreign_tables{};
   {
@@ -683,6 +720,20 @@ const std::string Catalog::getForeignTableSchema(bool if_not_exists) {
          "FOREIGN KEY(server_id) REFERENCES omnisci_foreign_servers(id))";
 }
 
+const std::string Catalog::getColumnStatisticsSchema(bool if_not_exists) {
+  return "CREATE TABLE " + (if_not_exists ? std::string{"IF NOT EXISTS "} : "") +
+         "omnisci_column_statistics(table_id integer, column_id integer, " +
+         "num_rows bigint, ndv bigint, null_fraction double, histogram text, " +
+         "most_common_values text, primary key(table_id, column_id), " +
+         "FOREIGN KEY(table_id) REFERENCES mapd_tables(tableid))";
+}
+
+const std::string Catalog::getSpatialIndexSchema(bool if_not_exists) {
+  return "CREATE TABLE " + (if_not_exists ? std::string{"IF NOT EXISTS "} : "") +
+         "omnisci_spatial_indexes(name text primary key, table_id integer, " +
+         "column_id integer, FOREIGN KEY(table_id) REFERENCES mapd_tables(tableid))";
+}
+
 void Catalog::recordOwnershipOfObjectsInObjectPermissions() {
   cat_sqlite_lock sqlite_lock(this);
   sqliteConnector_.query("BEGIN TRANSACTION");
@@ -899,6 +950,8 @@ void Catalog::CheckAndExecuteMigrations() {
   updateDeletedColumnIndicator();
   updateFrontendViewsToDashboards();
   recordOwnershipOfObjectsInObjectPermissions();
+  createColumnStatisticsSchema();
+  createSpatialIndexSchema();
 
   if (g_enable_fsi) {
     createFsiSchemasAndDefaultServers();
@@ -1006,6 +1059,9 @@ void Catalog::buildMaps() {
     addForeignTableDetails();
   }
 
+  buildColumnStatisticsMap();
+  buildSpatialIndexMap();
+
   string columnQuery(
       "SELECT tableid, columnid, name, coltype, colsubtype, coldim, colscale, "
       "is_notnull, compression, comp_param, "
@@ -1883,6 +1939,8 @@ void Catalog::dropColumn(const TableDescriptor& td, const ColumnDescriptor& cd)
   columnDescriptorMap_.erase(columnDescIt);
   columnDescriptorMapById_.erase(ColumnIdKey(cd.tableId, cd.columnId));
   --tableDescriptorMapById_[td.tableId]->nColumns;
+  dropSpatialIndexesUnlocked(td.tableId, cd.columnId);
+  discardFragmentSpatialIndexes(td.tableId, cd.columnId, -1, true);
   // for each shard
   if (td.nShards > 0 && td.shard < 0) {
     for (const auto shard : getPhysicalTablesDescriptors(&td)) {
@@ -2682,9 +2740,30 @@ int32_t Catalog::getTableEpoch(const int32_t db_id, const int32_t table_id) cons
 }
 
 void Catalog::setTableEpoch(const int db_id, const int table_id, int new_epoch) {
+  // keep the insert log from being folded into a table before its logged batches are
+  // replayed
+  std::unique_lock<std::mutex> fold_lock;
+  if (insertLog_) {
+    fold_lock = insertLog_->holdFolding();
+  }
   cat_read_lock read_lock(this);
   LOG(INFO) << "Set table epoch db:" << db_id << " Table ID  " << table_id
             << " back to new epoch " << new_epoch;
+  // Rolling back to the last checkpoint undoes the inserts whose logged batches haven't
+  // been folded yet, replay them. Rolling back further discards them.
+  std::vector<int> replayed_table_ids;
+  const auto roll_back_insert_log = [&](const int physical_table_id) {
+    if (!insertLog_) {
+      return;
+    }
+    if (static_cast<int>(dataMgr_->getTableEpoch(db_id, physical_table_id)) ==
+        new_epoch) {
+      replayed_table_ids.push_back(physical_table_id);
+    } else {
+      insertLog_->discard(physical_table_id);
+    }
+  };
+  roll_back_insert_log(table_id);
   removeChunks(table_id);
   dataMgr_->setTableEpoch(db_id, table_id, new_epoch);
 
@@ -2699,10 +2778,23 @@ void Catalog::setTableEpoch(const int db_id, const int table_id, int new_epoch)
       CHECK(phys_td);
       LOG(INFO) << "Set sharded table epoch db:" << db_id << " Table ID  "
                 << physical_tb_id << " back to new epoch " << new_epoch;
+      roll_back_insert_log(physical_tb_id);
       removeChunks(physical_tb_id);
       dataMgr_->setTableEpoch(db_id, physical_tb_id, new_epoch);
     }
   }
+
+  // the R-trees may cover rows rolled back
+  invalidateSpatialIndexes(getMetadataForTableImpl(table_id, false));
+
+  for (const auto physical_table_id : replayed_table_ids) {
+    insertLog_->replay(physical_table_id,
+                       [this](const int table_id,
+                              const int epoch,
+                              Fragmenter_Namespace::InsertData& insert_data) {
+                         replayInsertLogBatch(table_id, epoch, insert_data);
+                       });
+  }
 }
 
 const ColumnDescriptor* Catalog::getDeletedColumn(const TableDescriptor* td) const {
@@ -2981,6 +3073,13 @@ void Catalog::truncateTable(const TableDescriptor* td) {
     }
   }
   doTruncateTable(td);
+  // statistics describe the old contents, drop them so they don't mislead the planner
+  cat_sqlite_lock sqlite_lock(this);
+  dropColumnStatisticsUnlocked(td->tableId);
+  // spatial indexes are kept, their R-trees went away with the data files
+  for (const auto physical_td : getPhysicalTablesDescriptors(td)) {
+    discardFragmentSpatialIndexes(physical_td->tableId, -1, -1, false);
+  }
 }
 
 void Catalog::doTruncateTable(const TableDescriptor* td) {
@@ -3000,6 +3099,9 @@ void Catalog::doTruncateTable(const TableDescriptor* td) {
   dataMgr_->deleteChunksWithPrefix(chunkKeyPrefix, MemoryLevel::GPU_LEVEL);
 
   dataMgr_->removeTableRelatedDS(currentDB_.dbId, tableId);
+  if (insertLog_) {
+    insertLog_->discard(tableId);
+  }
 
   std::unique_ptr<StringDictionaryClient> client;
   if (SysCatalog::instance().isAggregator()) {
@@ -3147,6 +3249,10 @@ void Catalog::executeDropTableSqliteQueries(const TableDescriptor* td) {
     sqliteConnector_.query_with_text_param(
         "DELETE FROM omnisci_foreign_tables WHERE table_id = ?", std::to_string(tableId));
   }
+  dropColumnStatisticsUnlocked(tableId);
+  dropSpatialIndexesUnlocked(tableId);
+  // the R-trees go away with the data files of the table
+  discardFragmentSpatialIndexes(tableId, -1, -1, false);
 }
 
 void Catalog::renamePhysicalTable(const TableDescriptor* td, const string& newTableName) {
@@ -3536,7 +3642,85 @@ void Catalog::checkpoint(const int logicalTableId) const {
   }
 }
 
+std::string Catalog::getStreamOffsetsPath(const int tableId) const {
+  const auto path =
+      basePath_ + "/mapd_data/DB_" + std::to_string(currentDB_.dbId) + "_STREAM_OFFSETS";
+  return tableId < 0 ? path : path + "/" + std::to_string(tableId);
+}
+
+std::string Catalog::getInsertLogPath() const {
+  return basePath_ + "/mapd_data/DB_" + std::to_string(currentDB_.dbId) + "_INSERT_LOG";
+}
+
+void Catalog::openInsertLog() {
+  if (SysCatalog::instance().isAggregator()) {
+    return;
+  }
+  const auto insert_log_path = getInsertLogPath();
+  // a log left behind while the insert log was enabled still has to be replayed
+  if (!g_enable_insert_log && !boost::filesystem::exists(insert_log_path)) {
+    return;
+  }
+  insertLog_ = std::make_unique<Fragmenter_Namespace::InsertLog>(
+      insert_log_path,
+      g_insert_log_fold_interval_ms,
+      [this](const std::set<int>& table_ids) { checkpointInsertLogTables(table_ids); },
+      [this](const int table_id,
+             const int epoch,
+             Fragmenter_Namespace::InsertData& insert_data) {
+        replayInsertLogBatch(table_id, epoch, insert_data);
+      });
+  if (!g_enable_insert_log) {
+    insertLog_.reset();
+    boost::filesystem::remove_all(insert_log_path);
+  }
+}
+
+void Catalog::checkpointInsertLogTables(const std::set<int>& table_ids) const {
+  for (const auto table_id : table_ids) {
+    std::shared_ptr<Fragmenter_Namespace::AbstractFragmenter> fragmenter;
+    {
+      cat_read_lock read_lock(this);
+      const auto td = getMetadataForTable(table_id);
+      if (!td) {
+        continue;  // dropped since
+      }
+      fragmenter = td->fragmenter;
+    }
+    if (fragmenter) {
+      fragmenter->checkpoint();
+    }
+  }
+}
+
+void Catalog::replayInsertLogBatch(const int table_id,
+                                   const int epoch,
+                                   Fragmenter_Namespace::InsertData& insert_data) const {
+  const auto td = getMetadataForTable(table_id);
+  if (!td || td->persistenceLevel != Data_Namespace::MemoryLevel::DISK_LEVEL) {
+    return;
+  }
+  // a checkpoint since the batch was logged already has it
+  if (epoch < static_cast<int>(dataMgr_->getTableEpoch(currentDB_.dbId, table_id))) {
+    return;
+  }
+  for (const auto column_id : insert_data.columnIds) {
+    if (!getMetadataForColumn(table_id, column_id)) {
+      LOG(WARNING) << "Skipping a logged insert into table " << td->tableName
+                   << " of which column " << column_id << " is gone";
+      return;
+    }
+  }
+  insert_data.databaseId = currentDB_.dbId;
+  CHECK(td->fragmenter);
+  td->fragmenter->insertDataNoCheckpoint(insert_data);
+}
+
 void Catalog::eraseDBData() {
+  // folding the insert log waits for the catalog locks
+  insertLog_.reset();
+  boost::filesystem::remove_all(getInsertLogPath());
+  boost::filesystem::remove_all(getStreamOffsetsPath(-1));
   cat_write_lock write_lock(this);
   // Physically erase all tables and dictionaries from disc and memory
   const auto tables = getAllTableMetadata();
@@ -3570,6 +3754,10 @@ void Catalog::eraseTablePhysicalData(const TableDescriptor* td) {
   if (!td->isView) {
     INJECT_TIMER(Remove_Table);
     dataMgr_->removeTableRelatedDS(currentDB_.dbId, tableId);
+    if (insertLog_) {
+      insertLog_->discard(tableId);
+    }
+    boost::filesystem::remove(getStreamOffsetsPath(tableId));
   }
   calciteMgr_->updateMetadata(currentDB_.dbName, td->tableName);
   {
@@ -3648,27 +3836,496 @@ void Catalog::vacuumDeletedRows(const TableDescriptor* td) const {
   ChunkMetadataVector chunkMetadataVec;
   dataMgr_->getChunkMetadataVecForKeyPrefix(chunkMetadataVec, chunkKeyPrefix);
   for (auto cm : chunkMetadataVec) {
-    // "delete has occured"
-    if (cm.second->chunkStats.max.tinyintval == 1) {
-      UpdelRoll updel_roll;
-      updel_roll.catalog = this;
-      updel_roll.logicalTableId = getLogicalTableId(td->tableId);
-      updel_roll.memoryLevel = Data_Namespace::MemoryLevel::CPU_LEVEL;
-      const auto cd = getMetadataForColumn(td->tableId, cm.first[2]);
+    vacuumFragment(td, cm.first, cm.second);
+  }
+}
+
+void Catalog::vacuumDeletedRows(const TableDescriptor* td,
+                                const int fragmentId,
+                                const bool checkpoint) const {
+  const ColumnDescriptor* cd = getDeletedColumn(td);
+  if (nullptr == cd) {
+    return;
+  }
+  ChunkKey chunkKeyPrefix = {currentDB_.dbId, td->tableId, cd->columnId, fragmentId};
+  ChunkMetadataVector chunkMetadataVec;
+  dataMgr_->getChunkMetadataVecForKeyPrefix(chunkMetadataVec, chunkKeyPrefix);
+  for (auto cm : chunkMetadataVec) {
+    vacuumFragment(td, cm.first, cm.second, checkpoint);
+  }
+}
+
+std::vector<std::shared_ptr<Chunk_NS::Chunk>> Catalog::loadFragmentChunks(
+    const TableDescriptor* td,
+    const int fragmentId) const {
+  std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks;
+  CHECK(td->fragmenter);
+  const auto table_info = td->fragmenter->getFragmentsForQuery();
+  for (const auto& fragment : table_info.fragments) {
+    if (fragment.fragmentId != fragmentId) {
+      continue;
+    }
+    const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+    for (const auto& [column_id, chunk_metadata] : chunk_metadata_map) {
+      const auto cd = getMetadataForColumn(td->tableId, column_id);
+      CHECK(cd);
+      chunks.push_back(Chunk_NS::Chunk::getChunk(
+          cd,
+          &getDataMgr(),
+          {currentDB_.dbId, td->tableId, column_id, fragmentId},
+          Data_Namespace::MemoryLevel::CPU_LEVEL,
+          0,
+          chunk_metadata->numBytes,
+          chunk_metadata->numElements));
+    }
+  }
+  return chunks;
+}
+
+// chunkKey and chunkMetadata are the ones of the deleted column of the fragment
+void Catalog::vacuumFragment(const TableDescriptor* td,
+                             const ChunkKey& chunkKey,
+                             const std::shared_ptr<ChunkMetadata>& chunkMetadata,
+                             const bool checkpoint) const {
+  // "delete has occured"
+  if (chunkMetadata->chunkStats.max.tinyintval != 1) {
+    return;
+  }
+  // compaction moves the rows of the fragment
+  invalidateSpatialIndexes(td, chunkKey[3]);
+  UpdelRoll updel_roll;
+  updel_roll.catalog = this;
+  updel_roll.logicalTableId = getLogicalTableId(td->tableId);
+  updel_roll.memoryLevel = Data_Namespace::MemoryLevel::CPU_LEVEL;
+  const auto cd = getMetadataForColumn(td->tableId, chunkKey[2]);
+  const auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                               &getDataMgr(),
+                                               chunkKey,
+                                               updel_roll.memoryLevel,
+                                               0,
+                                               chunkMetadata->numBytes,
+                                               chunkMetadata->numElements);
+  td->fragmenter->compactRows(this,
+                              td,
+                              chunkKey[3],
+                              td->fragmenter->getVacuumOffsets(chunk),
+                              updel_roll.memoryLevel,
+                              updel_roll);
+  updel_roll.commitUpdate(checkpoint);
+  // the compacted chunks replace the ones cached on the GPUs
+  dataMgr_->deleteChunksWithPrefix({currentDB_.dbId, td->tableId},
+                                   Data_Namespace::MemoryLevel::GPU_LEVEL);
+}
+
+std::vector<FragmentDeletedRows> Catalog::getDeletedRowCounts(
+    const TableDescriptor* td) const {
+  std::vector<FragmentDeletedRows> counts;
+  const ColumnDescriptor* cd = getDeletedColumn(td);
+  if (nullptr == cd) {
+    return counts;
+  }
+  ChunkMetadataVector chunkMetadataVec;
+  dataMgr_->getChunkMetadataVecForKeyPrefix(chunkMetadataVec,
+                                            {currentDB_.dbId, td->tableId});
+  std::map<int, size_t> fragmentBytes;
+  for (const auto& cm : chunkMetadataVec) {
+    fragmentBytes[cm.first[3]] += cm.second->numBytes;
+  }
+  for (const auto& cm : chunkMetadataVec) {
+    if (cm.first[2] != cd->columnId) {
+      continue;
+    }
+    const auto& chunkMetadata = *cm.second;
+    FragmentDeletedRows fragmentCounts{
+        cm.first[3], chunkMetadata.numElements, 0, fragmentBytes[cm.first[3]]};
+    if (chunkMetadata.chunkStats.min.tinyintval == 1) {
+      fragmentCounts.num_deleted_rows = chunkMetadata.numElements;
+    } else if (chunkMetadata.chunkStats.max.tinyintval == 1) {
+      // some rows deleted, count them from the deleted column
       const auto chunk = Chunk_NS::Chunk::getChunk(cd,
                                                    &getDataMgr(),
                                                    cm.first,
-                                                   updel_roll.memoryLevel,
+                                                   Data_Namespace::MemoryLevel::CPU_LEVEL,
                                                    0,
-                                                   cm.second->numBytes,
-                                                   cm.second->numElements);
-      td->fragmenter->compactRows(this,
-                                  td,
-                                  cm.first[3],
-                                  td->fragmenter->getVacuumOffsets(chunk),
-                                  updel_roll.memoryLevel,
-                                  updel_roll);
-      updel_roll.commitUpdate();
+                                                   chunkMetadata.numBytes,
+                                                   chunkMetadata.numElements);
+      const auto buffer = chunk->getBuffer();
+      const auto deleted = buffer->getMemoryPtr();
+      fragmentCounts.num_deleted_rows =
+          buffer->size() - std::count(deleted, deleted + buffer->size(), 0);
+    }
+    counts.push_back(fragmentCounts);
+  }
+  return counts;
+}
+
+void Catalog::buildColumnStatisticsMap() {
+  sqliteConnector_.query(
+      "SELECT table_id, column_id, num_rows, ndv, null_fraction, histogram, "
+      "most_common_values FROM omnisci_column_statistics");
+  const auto num_rows = sqliteConnector_.getNumRows();
+  for (size_t r = 0; r < num_rows; ++r) {
+    auto stats = std::make_shared<ColumnStatistics>();
+    const auto table_id = sqliteConnector_.getData<int>(r, 0);
+    const auto column_id = sqliteConnector_.getData<int>(r, 1);
+    stats->num_rows = sqliteConnector_.getData<int64_t>(r, 2);
+    stats->ndv = sqliteConnector_.getData<int64_t>(r, 3);
+    stats->null_fraction = sqliteConnector_.getData<double>(r, 4);
+    stats->deserializeHistogram(sqliteConnector_.getData<std::string>(r, 5));
+    stats->deserializeMostCommonValues(sqliteConnector_.getData<std::string>(r, 6));
+    columnStatisticsMapById_[ColumnIdKey(table_id, column_id)] = stats;
+  }
+}
+
+void Catalog::dropColumnStatisticsUnlocked(const int table_id) {
+  sqliteConnector_.query_with_text_param(
+      "DELETE FROM omnisci_column_statistics WHERE table_id = ?",
+      std::to_string(table_id));
+  for (auto it = columnStatisticsMapById_.begin();
+       it != columnStatisticsMapById_.end();) {
+    if (std::get<0>(it->first) == table_id) {
+      it = columnStatisticsMapById_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void Catalog::setColumnStatistics(
+    const TableDescriptor* td,
+    const std::map<int, ColumnStatistics>& stats_by_column_id) {
+  cat_write_lock write_lock(this);
+  cat_sqlite_lock sqlite_lock(this);
+  sqliteConnector_.query("BEGIN TRANSACTION");
+  try {
+    sqliteConnector_.query_with_text_param(
+        "DELETE FROM omnisci_column_statistics WHERE table_id = ?",
+        std::to_string(td->tableId));
+    for (const auto& [column_id, stats] : stats_by_column_id) {
+      sqliteConnector_.query_with_text_params(
+          "INSERT INTO omnisci_column_statistics (table_id, column_id, num_rows, ndv, "
+          "null_fraction, histogram, most_common_values) VALUES (?, ?, ?, ?, ?, ?, ?)",
+          std::vector<std::string>{std::to_string(td->tableId),
+                                   std::to_string(column_id),
+                                   std::to_string(stats.num_rows),
+                                   std::to_string(stats.ndv),
+                                   stats.serializeNullFraction(),
+                                   stats.serializeHistogram(),
+                                   stats.serializeMostCommonValues()});
+    }
+  } catch (std::exception& e) {
+    sqliteConnector_.query("ROLLBACK TRANSACTION");
+    throw;
+  }
+  sqliteConnector_.query("END TRANSACTION");
+  for (auto it = columnStatisticsMapById_.begin();
+       it != columnStatisticsMapById_.end();) {
+    if (std::get<0>(it->first) == td->tableId) {
+      it = columnStatisticsMapById_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (const auto& [column_id, stats] : stats_by_column_id) {
+    columnStatisticsMapById_[ColumnIdKey(td->tableId, column_id)] =
+        std::make_shared<const ColumnStatistics>(stats);
+  }
+}
+
+std::shared_ptr<const ColumnStatistics> Catalog::getColumnStatistics(
+    const int table_id,
+    const int column_id) const {
+  cat_read_lock read_lock(this);
+  const auto it = columnStatisticsMapById_.find(ColumnIdKey(table_id, column_id));
+  return it == columnStatisticsMapById_.end() ? nullptr : it->second;
+}
+
+void Catalog::buildSpatialIndexMap() {
+  sqliteConnector_.query("SELECT name, table_id, column_id FROM omnisci_spatial_indexes");
+  const auto num_rows = sqliteConnector_.getNumRows();
+  for (size_t r = 0; r < num_rows; ++r) {
+    auto index = std::make_shared<SpatialIndexDescriptor>();
+    index->index_name = sqliteConnector_.getData<std::string>(r, 0);
+    index->table_id = sqliteConnector_.getData<int>(r, 1);
+    index->column_id = sqliteConnector_.getData<int>(r, 2);
+    spatialIndexMap_[to_upper(index->index_name)] = index;
+  }
+}
+
+void Catalog::dropSpatialIndexesUnlocked(const int table_id, const int column_id) {
+  for (auto it = spatialIndexMap_.begin(); it != spatialIndexMap_.end();) {
+    const auto& index = *it->second;
+    if (index.table_id == table_id && (column_id < 0 || index.column_id == column_id)) {
+      sqliteConnector_.query_with_text_param(
+          "DELETE FROM omnisci_spatial_indexes WHERE name = ?", index.index_name);
+      it = spatialIndexMap_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void Catalog::createSpatialIndex(const std::string& index_name,
+                                 const TableDescriptor* td,
+                                 const ColumnDescriptor* cd) {
+  std::shared_ptr<SpatialIndexDescriptor> index;
+  {
+    cat_write_lock write_lock(this);
+    cat_sqlite_lock sqlite_lock(this);
+    if (spatialIndexMap_.count(to_upper(index_name))) {
+      throw std::runtime_error("Index " + index_name + " already exists.");
+    }
+    if (getSpatialIndex(td->tableId, cd->columnId)) {
+      throw std::runtime_error("Column " + cd->columnName +
+                               " already has a spatial index.");
+    }
+    sqliteConnector_.query_with_text_params(
+        "INSERT INTO omnisci_spatial_indexes (name, table_id, column_id) "
+        "VALUES (?, ?, ?)",
+        std::vector<std::string>{
+            index_name, std::to_string(td->tableId), std::to_string(cd->columnId)});
+    index = std::make_shared<SpatialIndexDescriptor>(
+        SpatialIndexDescriptor{index_name, td->tableId, cd->columnId});
+    spatialIndexMap_[to_upper(index_name)] = index;
+  }
+  // built right away rather than by the first query using it
+  for (const auto physical_td : getPhysicalTablesDescriptors(td)) {
+    const auto table_info =
+        getMetadataForTable(physical_td->tableId)->fragmenter->getFragmentsForQuery();
+    for (const auto& fragment : table_info.fragments) {
+      getFragmentSpatialIndex(*index, fragment);
+    }
+  }
+}
+
+void Catalog::dropSpatialIndex(const std::string& index_name) {
+  cat_write_lock write_lock(this);
+  cat_sqlite_lock sqlite_lock(this);
+  const auto it = spatialIndexMap_.find(to_upper(index_name));
+  if (it == spatialIndexMap_.end()) {
+    throw std::runtime_error("Index " + index_name + " does not exist.");
+  }
+  const auto index = it->second;
+  sqliteConnector_.query_with_text_param(
+      "DELETE FROM omnisci_spatial_indexes WHERE name = ?", index->index_name);
+  spatialIndexMap_.erase(it);
+  const auto td = getMetadataForTableImpl(index->table_id, false);
+  CHECK(td);
+  for (const auto physical_td : getPhysicalTablesDescriptors(td)) {
+    discardFragmentSpatialIndexes(physical_td->tableId, index->column_id, -1, true);
+  }
+}
+
+std::shared_ptr<const SpatialIndexDescriptor> Catalog::getSpatialIndex(
+    const std::string& index_name) const {
+  cat_read_lock read_lock(this);
+  const auto it = spatialIndexMap_.find(to_upper(index_name));
+  return it == spatialIndexMap_.end() ? nullptr : it->second;
+}
+
+std::shared_ptr<const SpatialIndexDescriptor> Catalog::getSpatialIndex(
+    const int table_id,
+    const int column_id) const {
+  cat_read_lock read_lock(this);
+  for (const auto& [index_name, index] : spatialIndexMap_) {
+    if (index->table_id == table_id && index->column_id == column_id) {
+      return index;
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<const FragmentSpatialIndex> Catalog::getFragmentSpatialIndex(
+    const SpatialIndexDescriptor& index,
+    const Fragmenter_Namespace::FragmentInfo& fragment) const {
+  // everything needed from the catalog is looked up before taking the mutex, which is
+  // taken under the catalog locks when the R-trees are invalidated
+  const auto geo_cd = getMetadataForColumn(index.table_id, index.column_id);
+  CHECK(geo_cd);
+  const auto& geo_ti = geo_cd->columnType;
+  const int physical_table_id = fragment.physicalTableId;
+  const auto box_cd = getMetadataForColumn(
+      physical_table_id, get_bounding_box_column_id(geo_ti, index.column_id));
+  CHECK(box_cd);
+  const size_t num_rows = fragment.getPhysicalNumTuples();
+  const auto epoch =
+      static_cast<int32_t>(dataMgr_->getTableEpoch(currentDB_.dbId, physical_table_id));
+  const auto path = getFragmentSpatialIndexPath(
+      physical_table_id, index.column_id, fragment.fragmentId);
+  const ChunkKey box_chunk_key{
+      currentDB_.dbId, physical_table_id, box_cd->columnId, fragment.fragmentId};
+  // the R-tree is only saved once the rows it covers are checkpointed, along with the
+  // epoch of that checkpoint, since rows written after it are lost on a crash
+  const auto is_checkpointed = [&]() {
+    const auto file_mgr = dynamic_cast<File_Namespace::FileMgr*>(
+        dataMgr_->getGlobalFileMgr()->getFileMgr(currentDB_.dbId, physical_table_id));
+    if (!file_mgr || !file_mgr->isBufferOnDevice(box_chunk_key)) {
+      return false;
+    }
+    const auto buffer = file_mgr->getBuffer(box_chunk_key);
+    return !buffer->isDirty() && buffer->has_encoder &&
+           buffer->encoder->getNumElems() == num_rows;
+  };
+
+  // the R-tree is loaded, built and saved outside of the mutex, which is shared by all
+  // the fragments, and only published if no R-tree of the table was discarded meanwhile
+  const auto cache_key =
+      std::make_tuple(physical_table_id, index.column_id, fragment.fragmentId);
+  std::shared_ptr<const FragmentSpatialIndex> fragment_index;
+  bool is_saved{false};
+  size_t generation;
+  {
+    std::lock_guard<std::mutex> lock(fragmentSpatialIndexMutex_);
+    generation = fragmentSpatialIndexGeneration_;
+    const auto it = fragmentSpatialIndexCache_.find(cache_key);
+    if (it != fragmentSpatialIndexCache_.end()) {
+      fragment_index = it->second.index;
+      is_saved = it->second.is_saved;
+    }
+  }
+  const auto cached_fragment_index = fragment_index;
+  if (!fragment_index && !path.empty()) {
+    fragment_index = FragmentSpatialIndex::load(path, epoch - 1);
+    is_saved = fragment_index != nullptr;
+  }
+  if (fragment_index && fragment_index->getNumRowsIndexed() > num_rows) {
+    fragment_index = nullptr;
+    is_saved = false;
+  }
+  const size_t begin_row = fragment_index ? fragment_index->getNumRowsIndexed() : 0;
+  if (!fragment_index || begin_row < num_rows) {
+    std::vector<FragmentSpatialIndex::Node> nodes;
+    if (begin_row < num_rows) {
+      const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+      const auto chunk_meta_it = chunk_metadata_map.find(box_cd->columnId);
+      CHECK(chunk_meta_it != chunk_metadata_map.end());
+      nodes = read_bounding_boxes(*dataMgr_,
+                                  box_cd,
+                                  geo_ti,
+                                  box_chunk_key,
+                                  chunk_meta_it->second,
+                                  begin_row,
+                                  num_rows);
+    }
+    if (fragment_index) {
+      fragment_index = fragment_index->extend(nodes, num_rows);
+    } else {
+      fragment_index = std::make_shared<const FragmentSpatialIndex>(nodes, num_rows);
+    }
+    is_saved = false;
+  }
+  // saved aside, it only replaces the saved R-tree along with publishing
+  std::string staged_path;
+  if (!is_saved && !path.empty() && is_checkpointed()) {
+    std::ostringstream staged_path_oss;
+    staged_path_oss << path << ".staged_" << std::this_thread::get_id();
+    if (fragment_index->save(staged_path_oss.str(), epoch - 1)) {
+      staged_path = staged_path_oss.str();
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(fragmentSpatialIndexMutex_);
+  if (generation != fragmentSpatialIndexGeneration_) {
+    // the rows of the table changed meanwhile, the R-tree only serves the caller
+    if (!staged_path.empty()) {
+      boost::system::error_code ec;
+      boost::filesystem::remove(staged_path, ec);
+    }
+    return fragment_index;
+  }
+  auto& cached_index = fragmentSpatialIndexCache_[cache_key];
+  if (cached_index.index != cached_fragment_index && cached_index.index &&
+      cached_index.index->getNumRowsIndexed() >= num_rows) {
+    // another query published an R-tree covering the same rows first
+    if (!staged_path.empty()) {
+      boost::system::error_code ec;
+      boost::filesystem::remove(staged_path, ec);
+    }
+    return cached_index.index;
+  }
+  cached_index.index = fragment_index;
+  cached_index.is_saved = is_saved;
+  if (!staged_path.empty()) {
+    boost::system::error_code ec;
+    boost::filesystem::rename(staged_path, path, ec);
+    cached_index.is_saved = !ec;
+  }
+  return fragment_index;
+}
+
+void Catalog::invalidateSpatialIndexes(const TableDescriptor* td,
+                                       const int fragment_id) const {
+  CHECK(td);
+  const auto logical_table_id = getLogicalTableId(td->tableId);
+  bool has_spatial_index{false};
+  {
+    cat_read_lock read_lock(this);
+    for (const auto& [index_name, index] : spatialIndexMap_) {
+      has_spatial_index = has_spatial_index || index->table_id == logical_table_id;
+    }
+  }
+  if (!has_spatial_index) {
+    return;
+  }
+  for (const auto physical_td : getPhysicalTablesDescriptors(td)) {
+    discardFragmentSpatialIndexes(physical_td->tableId, -1, fragment_id, true);
+  }
+}
+
+std::string Catalog::getFragmentSpatialIndexPath(const int physical_table_id,
+                                                 const int column_id,
+                                                 const int fragment_id) const {
+  const auto file_mgr = dynamic_cast<File_Namespace::FileMgr*>(
+      dataMgr_->getGlobalFileMgr()->getFileMgr(currentDB_.dbId, physical_table_id));
+  if (!file_mgr) {
+    return "";
+  }
+  return file_mgr->getFileMgrBasePath() + "/spatial_index_" + std::to_string(column_id) +
+         "_" + std::to_string(fragment_id);
+}
+
+void Catalog::discardFragmentSpatialIndexes(const int physical_table_id,
+                                            const int column_id,
+                                            const int fragment_id,
+                                            const bool remove_files) const {
+  const auto matches = [column_id, fragment_id](const int index_column_id,
+                                                const int index_fragment_id) {
+    return (column_id < 0 || index_column_id == column_id) &&
+           (fragment_id < 0 || index_fragment_id == fragment_id);
+  };
+  std::string table_path;
+  if (remove_files) {
+    const auto file_mgr = dynamic_cast<File_Namespace::FileMgr*>(
+        dataMgr_->getGlobalFileMgr()->getFileMgr(currentDB_.dbId, physical_table_id));
+    if (file_mgr) {
+      table_path = file_mgr->getFileMgrBasePath();
+    }
+  }
+  std::lock_guard<std::mutex> lock(fragmentSpatialIndexMutex_);
+  ++fragmentSpatialIndexGeneration_;
+  for (auto it = fragmentSpatialIndexCache_.begin();
+       it != fragmentSpatialIndexCache_.end();) {
+    const auto& [table_id, index_column_id, index_fragment_id] = it->first;
+    if (table_id == physical_table_id && matches(index_column_id, index_fragment_id)) {
+      it = fragmentSpatialIndexCache_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (table_path.empty() || !boost::filesystem::exists(table_path)) {
+    return;
+  }
+  for (const auto& entry : boost::filesystem::directory_iterator(table_path)) {
+    int index_column_id{-1};
+    int index_fragment_id{-1};
+    const auto file_name = entry.path().filename().string();
+    if (std::sscanf(file_name.c_str(),
+                    "spatial_index_%d_%d",
+                    &index_column_id,
+                    &index_fragment_id) == 2 &&
+        matches(index_column_id, index_fragment_id)) {
+      boost::system::error_code ec;
+      boost::filesystem::remove(entry.path(), ec);
     }
   }
 }
@@ -34,7 +34,9 @@
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -66,8 +68,21 @@ class SharedDictionaryDef;
 
 }  // namespace Parser
 
+namespace Fragmenter_Namespace {
+
+class InsertLog;
+struct InsertData;
+
+}  // namespace Fragmenter_Namespace
+
 class TableArchiver;
 
+namespace Chunk_NS {
+
+class Chunk;
+
+}  // namespace Chunk_NS
+
 // SPI means Sequential Positional Index which is equivalent to the input index in a
 // RexInput node
 #define SPIMAP_MAGIC1 (std::numeric_limits<unsigned>::max() / 4)
@@ -77,6 +92,16 @@ class TableArchiver;
 
 namespace Catalog_Namespace {
 
+class BackgroundVacuum;
+
+// Rows and deleted rows of a fragment of a physical table.
+struct FragmentDeletedRows {
+  int fragment_id;
+  size_t num_rows;
+  size_t num_deleted_rows;
+  size_t num_bytes;  // bytes of all the chunks of the fragment
+};
+
 /**
  * @type Catalog
  * @brief class for a per-database catalog.  also includes metadata for the
@@ -234,11 +259,31 @@ class Catalog final {
   void setDeletedColumnUnlocked(const TableDescriptor* td, const ColumnDescriptor* cd);
   int getLogicalTableId(const int physicalTableId) const;
   void checkpoint(const int logicalTableId) const;
+  // Log making inserts durable in place of a checkpoint, nullptr unless enabled by
+  // --enable-insert-log.
+  Fragmenter_Namespace::InsertLog* getInsertLog() const { return insertLog_.get(); }
+  // File holding the stream offsets committed along with a table, or their directory if
+  // tableId is negative.
+  std::string getStreamOffsetsPath(const int tableId) const;
   std::string name() const { return getCurrentDB().dbName; }
   void eraseDBData();
   void eraseTablePhysicalData(const TableDescriptor* td);
   void vacuumDeletedRows(const TableDescriptor* td) const;
   void vacuumDeletedRows(const int logicalTableId) const;
+  // Vacuums a single fragment of a physical table. Without a checkpoint, the caller has
+  // to checkpoint the table.
+  void vacuumDeletedRows(const TableDescriptor* td,
+                         const int fragmentId,
+                         const bool checkpoint = true) const;
+  // Reads the chunks of a fragment of a physical table into the CPU buffer pool, where
+  // they stay while the chunks returned are held. The caller has to hold a read lock on
+  // the table data.
+  std::vector<std::shared_ptr<Chunk_NS::Chunk>> loadFragmentChunks(
+      const TableDescriptor* td,
+      const int fragmentId) const;
+  // Counts the deleted rows of every fragment of a physical table. The caller has to
+  // hold a read lock on the table data.
+  std::vector<FragmentDeletedRows> getDeletedRowCounts(const TableDescriptor* td) const;
   void setForReload(const int32_t tableId);
 
   std::vector<std::string> getTableDataDirectories(const TableDescriptor* td) const;
@@ -267,6 +312,81 @@ class Catalog final {
    */
   static const std::string getForeignServerSchema(bool if_not_exists = false);
 
+  /**
+   * Gets the DDL statement used to create the schema holding column statistics
+   * computed by ANALYZE TABLE.
+   *
+   * @param if_not_exists - flag that indicates whether or not to include
+   * the "IF NOT EXISTS" phrase in the DDL statement
+   * @return string containing DDL statement
+   */
+  static const std::string getColumnStatisticsSchema(bool if_not_exists = false);
+
+  /**
+   * Replaces the persisted statistics of the given (logical) table.
+   *
+   * @param td - table the statistics were computed for
+   * @param stats_by_column_id - statistics keyed by column id
+   */
+  void setColumnStatistics(const TableDescriptor* td,
+                           const std::map<int, ColumnStatistics>& stats_by_column_id);
+
+  /**
+   * Returns the statistics of the given column or nullptr if the table has not been
+   * analyzed.
+   */
+  std::shared_ptr<const ColumnStatistics> getColumnStatistics(const int table_id,
+                                                              const int column_id) const;
+
+  /**
+   * Gets the DDL statement used to create the schema holding the spatial indexes
+   * created by CREATE INDEX ... USING RTREE.
+   *
+   * @param if_not_exists - flag that indicates whether or not to include
+   * the "IF NOT EXISTS" phrase in the DDL statement
+   * @return string containing DDL statement
+   */
+  static const std::string getSpatialIndexSchema(bool if_not_exists = false);
+
+  /**
+   * Creates a spatial index on a geo column of a (logical) table and builds it for the
+   * existing fragments. The caller has to hold a read lock on the table data.
+   */
+  void createSpatialIndex(const std::string& index_name,
+                          const TableDescriptor* td,
+                          const ColumnDescriptor* cd);
+
+  void dropSpatialIndex(const std::string& index_name);
+
+  /**
+   * Returns the spatial index with the given name, or nullptr if there is none.
+   */
+  std::shared_ptr<const SpatialIndexDescriptor> getSpatialIndex(
+      const std::string& index_name) const;
+
+  /**
+   * Returns the spatial index on the given geo column of a logical table, or nullptr if
+   * the column is not indexed.
+   */
+  std::shared_ptr<const SpatialIndexDescriptor> getSpatialIndex(
+      const int table_id,
+      const int column_id) const;
+
+  /**
+   * Returns the R-tree of a fragment, loading it from disk or building it on first use
+   * and adding the rows appended to the fragment since it was built.
+   */
+  std::shared_ptr<const FragmentSpatialIndex> getFragmentSpatialIndex(
+      const SpatialIndexDescriptor& index,
+      const Fragmenter_Namespace::FragmentInfo& fragment) const;
+
+  /**
+   * Discards the R-trees of the given table, or of one of its fragments, after its rows
+   * were changed in place. They are rebuilt on next use.
+   */
+  void invalidateSpatialIndexes(const TableDescriptor* td,
+                                const int fragment_id = -1) const;
+
   /**
    * Creates a new foreign server DB object.
    *
@@ -391,6 +511,8 @@ class Catalog final {
   void updateDeletedColumnIndicator();
   void updateFrontendViewsToDashboards();
   void createFsiSchemasAndDefaultServers();
+  void createColumnStatisticsSchema();
+  void createSpatialIndexSchema();
   void dropFsiSchemasAndTables();
   void recordOwnershipOfObjectsInObjectPermissions();
   void checkDateInDaysColumnMigration();
@@ -454,6 +576,14 @@ class Catalog final {
   LinkDescriptorMapById linkDescriptorMapById_;
   ForeignServerMap foreignServerMap_;
   ForeignServerMapById foreignServerMapById_;
+  ColumnStatisticsMapById columnStatisticsMapById_;
+  SpatialIndexMap spatialIndexMap_;
+  // R-trees of the fragments of the indexed columns, keyed by physical table, column and
+  // fragment ids. Guarded by its own mutex as they are built while queries run.
+  mutable std::mutex fragmentSpatialIndexMutex_;
+  mutable FragmentSpatialIndexCache fragmentSpatialIndexCache_;
+  // counts the discards of R-trees, those built meanwhile are not cached
+  mutable size_t fragmentSpatialIndexGeneration_{0};
 
   SqliteConnector sqliteConnector_;
   DBMetadata currentDB_;
@@ -487,6 +617,38 @@ class Catalog final {
                               const std::string& name_prefix) const;
   void buildForeignServerMap();
   void addForeignTableDetails();
+  void buildColumnStatisticsMap();
+  void dropColumnStatisticsUnlocked(const int table_id);
+  void buildSpatialIndexMap();
+  void dropSpatialIndexesUnlocked(const int table_id, const int column_id = -1);
+  // Path of the saved R-tree of a fragment, empty if the table has no file storage.
+  std::string getFragmentSpatialIndexPath(const int physical_table_id,
+                                          const int column_id,
+                                          const int fragment_id) const;
+  // Forgets the R-trees of a physical table, or only the ones of a column or fragment if
+  // given, and deletes their files unless they go away with the data files of the table.
+  void discardFragmentSpatialIndexes(const int physical_table_id,
+                                     const int column_id,
+                                     const int fragment_id,
+                                     const bool remove_files) const;
+
+  std::string getInsertLogPath() const;
+  void openInsertLog();
+  void checkpointInsertLogTables(const std::set<int>& table_ids) const;
+  void replayInsertLogBatch(const int table_id,
+                            const int epoch,
+                            Fragmenter_Namespace::InsertData& insert_data) const;
+
+  std::unique_ptr<Fragmenter_Namespace::InsertLog> insertLog_;
+
+  void vacuumFragment(const TableDescriptor* td,
+                      const ChunkKey& chunkKey,
+                      const std::shared_ptr<ChunkMetadata>& chunkMetadata,
+                      const bool checkpoint = true) const;
+
+  // Vacuums fragments with many deleted rows in the background, nullptr unless enabled
+  // by --enable-background-vacuum.
+  std::unique_ptr<BackgroundVacuum> backgroundVacuum_;
 
   void setForeignServerProperty(const std::string& server_name,
                                 const std::string& property,
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ColumnStatistics.h
+ * @brief   Per-column statistics computed by ANALYZE TABLE and used for cardinality
+ * estimation.
+ *
+ * Values are kept in the physical domain of the column: integers, dates, times and
+ * decimals (scaled) as their integer representation, floating point as is and
+ * dictionary encoded strings as their dictionary ids.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ColumnStatistics {
+  int64_t num_rows{0};
+  int64_t ndv{0};
+  double null_fraction{0};
+  // Bucket boundaries of an equi-depth histogram over the non-null values; every bucket
+  // holds (approximately) the same number of rows.
+  std::vector<double> histogram_bounds;
+  // Most common non-null values with their frequency as a fraction of all rows.
+  std::vector<std::pair<double, double>> most_common_values;
+
+  static constexpr double kDefaultEqualsSelectivity{0.1};
+  static constexpr double kDefaultRangeSelectivity{1. / 3};
+
+  double mostCommonValuesFraction() const {
+    double fraction{0};
+    for (const auto& mcv : most_common_values) {
+      fraction += mcv.second;
+    }
+    return fraction;
+  }
+
+  // The smallest selectivity estimated, the one of a single row. The statistics are a
+  // snapshot: values missing from them may have been inserted since, and an estimate of
+  // no rows at all would rank any input as free.
+  double minSelectivity() const { return 1. / std::max(num_rows, int64_t(1)); }
+
+  // Fraction of rows equal to a value, assuming a uniform distribution.
+  double averageEqualsSelectivity() const {
+    return std::max(ndv > 0 ? (1. - null_fraction) / ndv : 0, minSelectivity());
+  }
+
+  // Fraction of rows equal to the given value.
+  double estimateEqualsSelectivity(const double value) const {
+    if (num_rows == 0) {
+      return minSelectivity();
+    }
+    for (const auto& mcv : most_common_values) {
+      if (mcv.first == value) {
+        return mcv.second;
+      }
+    }
+    if (!histogram_bounds.empty() &&
+        (value < histogram_bounds.front() || value > histogram_bounds.back())) {
+      return minSelectivity();
+    }
+    const auto remaining_ndv = ndv - static_cast<int64_t>(most_common_values.size());
+    if (remaining_ndv <= 0) {
+      return minSelectivity();
+    }
+    const auto remaining_fraction =
+        std::max(0., 1. - null_fraction - mostCommonValuesFraction());
+    return std::max(remaining_fraction / remaining_ndv, minSelectivity());
+  }
+
+  // Fraction of rows within [lower, upper]; pass infinities for open ranges.
+  double estimateRangeSelectivity(const double lower, const double upper) const {
+    if (lower > upper) {
+      return 0;
+    }
+    if (num_rows == 0) {
+      return minSelectivity();
+    }
+    if (histogram_bounds.size() < 2) {
+      return kDefaultRangeSelectivity;
+    }
+    const size_t bucket_count = histogram_bounds.size() - 1;
+    double covered_buckets{0};
+    for (size_t i = 0; i < bucket_count; ++i) {
+      const auto bucket_lo = histogram_bounds[i];
+      const auto bucket_hi = histogram_bounds[i + 1];
+      if (upper < bucket_lo || lower > bucket_hi) {
+        continue;
+      }
+      if (bucket_hi == bucket_lo) {
+        covered_buckets += 1;
+        continue;
+      }
+      const auto overlap_lo = std::max(lower, bucket_lo);
+      const auto overlap_hi = std::min(upper, bucket_hi);
+      covered_buckets += (overlap_hi - overlap_lo) / (bucket_hi - bucket_lo);
+    }
+    return std::max(std::min(1., covered_buckets / bucket_count) * (1. - null_fraction),
+                    minSelectivity());
+  }
+
+  std::string serializeNullFraction() const {
+    std::ostringstream oss;
+    oss.precision(17);
+    oss << null_fraction;
+    return oss.str();
+  }
+
+  std::string serializeHistogram() const {
+    std::ostringstream oss;
+    oss.precision(17);
+    for (size_t i = 0; i < histogram_bounds.size(); ++i) {
+      oss << (i ? "," : "") << histogram_bounds[i];
+    }
+    return oss.str();
+  }
+
+  std::string serializeMostCommonValues() const {
+    std::ostringstream oss;
+    oss.precision(17);
+    for (size_t i = 0; i < most_common_values.size(); ++i) {
+      oss << (i ? "," : "") << most_common_values[i].first << ":"
+          << most_common_values[i].second;
+    }
+    return oss.str();
+  }
+
+  void deserializeHistogram(const std::string& serialized) {
+    histogram_bounds.clear();
+    std::istringstream iss(serialized);
+    std::string token;
+    while (std::getline(iss, token, ',')) {
+      histogram_bounds.push_back(std::stod(token));
+    }
+  }
+
+  void deserializeMostCommonValues(const std::string& serialized) {
+    most_common_values.clear();
+    std::istringstream iss(serialized);
+    std::string token;
+    while (std::getline(iss, token, ',')) {
+      const auto sep = token.find(':');
+      if (sep == std::string::npos) {
+        continue;
+      }
+      most_common_values.emplace_back(std::stod(token.substr(0, sep)),
+                                      std::stod(token.substr(sep + 1)));
+    }
+  }
+};
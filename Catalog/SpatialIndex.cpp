@@ -0,0 +1,212 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Catalog/SpatialIndex.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "Catalog/ColumnDescriptor.h"
+#include "DataMgr/Chunk/Chunk.h"
+#include "Shared/Logger.h"
+#include "Shared/geo_compression.h"
+
+namespace {
+
+constexpr int32_t kSpatialIndexVersion{1};
+
+template <typename T>
+void write_value(std::ofstream& index_file, const T& value) {
+  index_file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool read_value(std::ifstream& index_file, T& value) {
+  return static_cast<bool>(index_file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+}  // namespace
+
+FragmentSpatialIndex::FragmentSpatialIndex(const std::vector<Node>& nodes,
+                                           const size_t num_rows_indexed)
+    : num_rows_indexed_(num_rows_indexed), rtree_(nodes) {}
+
+bool FragmentSpatialIndex::intersects(const BoundingBox& bounding_box) const {
+  return rtree_.qbegin(boost::geometry::index::intersects(bounding_box)) !=
+         rtree_.qend();
+}
+
+bool FragmentSpatialIndex::intersects(const FragmentSpatialIndex& other) const {
+  if (rtree_.empty() || other.rtree_.empty() ||
+      !boost::geometry::intersects(rtree_.bounds(), other.rtree_.bounds())) {
+    return false;
+  }
+  // probe the larger tree with the rows of the smaller one, most pairs of fragments
+  // either don't overlap at all or have a match among the first rows probed
+  const auto& probe = size() <= other.size() ? *this : other;
+  const auto& build = size() <= other.size() ? other : *this;
+  for (const auto& node : probe.rtree_) {
+    if (build.intersects(node.first)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<uint32_t> FragmentSpatialIndex::query(const BoundingBox& bounding_box) const {
+  std::vector<uint32_t> row_offsets;
+  for (auto it = rtree_.qbegin(boost::geometry::index::intersects(bounding_box));
+       it != rtree_.qend();
+       ++it) {
+    row_offsets.push_back(it->second);
+  }
+  return row_offsets;
+}
+
+std::unique_ptr<FragmentSpatialIndex> FragmentSpatialIndex::extend(
+    const std::vector<Node>& nodes,
+    const size_t num_rows_indexed) const {
+  CHECK_GE(num_rows_indexed, num_rows_indexed_);
+  // the appended rows are inserted into a copy, packing all the rows again costs a lot
+  // more than the slightly looser tree
+  auto extended = std::make_unique<FragmentSpatialIndex>(*this);
+  extended->num_rows_indexed_ = num_rows_indexed;
+  extended->rtree_.insert(nodes.begin(), nodes.end());
+  return extended;
+}
+
+bool FragmentSpatialIndex::save(const std::string& path, const int32_t epoch) const {
+  // written aside and renamed, so that a crash never leaves a torn index behind
+  const auto tmp_path = path + ".tmp";
+  {
+    std::ofstream index_file(tmp_path, std::ios::binary | std::ios::trunc);
+    write_value(index_file, kSpatialIndexVersion);
+    write_value(index_file, epoch);
+    write_value(index_file, static_cast<uint64_t>(num_rows_indexed_));
+    write_value(index_file, static_cast<uint64_t>(rtree_.size()));
+    for (const auto& node : rtree_) {
+      write_value(index_file, node.first.min_corner().get<0>());
+      write_value(index_file, node.first.min_corner().get<1>());
+      write_value(index_file, node.first.max_corner().get<0>());
+      write_value(index_file, node.first.max_corner().get<1>());
+      write_value(index_file, node.second);
+    }
+    index_file.flush();
+    if (!index_file) {
+      LOG(WARNING) << "Could not write the spatial index to " << tmp_path;
+      return false;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str())) {
+    LOG(WARNING) << "Could not rename the spatial index to " << path;
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<FragmentSpatialIndex> FragmentSpatialIndex::load(
+    const std::string& path,
+    const int32_t max_epoch) {
+  std::ifstream index_file(path, std::ios::binary);
+  int32_t version{0};
+  int32_t epoch{0};
+  uint64_t num_rows_indexed{0};
+  uint64_t num_nodes{0};
+  if (!read_value(index_file, version) || version != kSpatialIndexVersion ||
+      !read_value(index_file, epoch) || epoch > max_epoch ||
+      !read_value(index_file, num_rows_indexed) ||
+      !read_value(index_file, num_nodes) || num_nodes > num_rows_indexed) {
+    return nullptr;
+  }
+  std::vector<Node> nodes(num_nodes);
+  for (auto& node : nodes) {
+    double min_x, min_y, max_x, max_y;
+    if (!read_value(index_file, min_x) || !read_value(index_file, min_y) ||
+        !read_value(index_file, max_x) || !read_value(index_file, max_y) ||
+        !read_value(index_file, node.second)) {
+      LOG(WARNING) << "Ignoring truncated spatial index " << path;
+      return nullptr;
+    }
+    node.first = BoundingBox(Point(min_x, min_y), Point(max_x, max_y));
+  }
+  return std::make_unique<FragmentSpatialIndex>(nodes, num_rows_indexed);
+}
+
+bool is_spatial_index_supported(const SQLTypeInfo& geo_ti) {
+  return geo_ti.get_type() == kPOINT || geo_ti.get_type() == kPOLYGON ||
+         geo_ti.get_type() == kMULTIPOLYGON;
+}
+
+int get_bounding_box_column_id(const SQLTypeInfo& geo_ti, const int geo_column_id) {
+  CHECK(geo_ti.get_type() == kPOINT || geo_ti.has_bounds());
+  if (geo_ti.get_type() == kPOINT) {
+    return geo_column_id + 1;
+  }
+  return geo_column_id + geo_ti.get_physical_coord_cols() + 1;
+}
+
+std::vector<FragmentSpatialIndex::Node> read_bounding_boxes(
+    Data_Namespace::DataMgr& data_mgr,
+    const ColumnDescriptor* box_cd,
+    const SQLTypeInfo& geo_ti,
+    const ChunkKey& chunk_key,
+    const std::shared_ptr<ChunkMetadata>& chunk_metadata,
+    const size_t begin_row,
+    const size_t end_row) {
+  using BoundingBox = FragmentSpatialIndex::BoundingBox;
+  using Point = FragmentSpatialIndex::Point;
+  std::vector<FragmentSpatialIndex::Node> nodes;
+  if (begin_row >= end_row) {
+    return nodes;
+  }
+  CHECK_LE(end_row, chunk_metadata->numElements);
+  const auto chunk = Chunk_NS::Chunk::getChunk(box_cd,
+                                               &data_mgr,
+                                               chunk_key,
+                                               Data_Namespace::CPU_LEVEL,
+                                               0,
+                                               chunk_metadata->numBytes,
+                                               chunk_metadata->numElements);
+  auto chunk_iter = chunk->begin_iterator(chunk_metadata, 0, 1);
+  const bool is_point = geo_ti.get_type() == kPOINT;
+  nodes.reserve(end_row - begin_row);
+  for (size_t row = begin_row; row < end_row; ++row) {
+    ArrayDatum ad;
+    bool is_end;
+    if (is_point) {
+      ChunkIter_get_nth_point_coords(&chunk_iter, row, &ad, &is_end);
+    } else {
+      ChunkIter_get_nth(&chunk_iter, row, &ad, &is_end);
+    }
+    CHECK(!is_end);
+    if (ad.is_null) {
+      continue;
+    }
+    if (is_point) {
+      const auto coords = geospatial::decompress_coords<double, SQLTypeInfo>(
+          geo_ti, ad.pointer, ad.length);
+      CHECK_EQ(coords->size(), size_t(2));
+      const Point point((*coords)[0], (*coords)[1]);
+      nodes.emplace_back(BoundingBox(point, point), row);
+    } else {
+      CHECK_EQ(ad.length, 4 * sizeof(double));
+      const auto bounds = reinterpret_cast<const double*>(ad.pointer);
+      nodes.emplace_back(
+          BoundingBox(Point(bounds[0], bounds[1]), Point(bounds[2], bounds[3])), row);
+    }
+  }
+  return nodes;
+}
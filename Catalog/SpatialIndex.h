@@ -0,0 +1,124 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    SpatialIndex.h
+ * @brief   R-tree over the bounding boxes of the rows of a geo column, one per fragment.
+ *
+ * Spatial indexes are created by CREATE INDEX ... USING RTREE on a POINT, POLYGON or
+ * MULTIPOLYGON column. The R-tree of a fragment is saved next to the data files of the
+ * table and rows appended to the fragment are added to it the next time it is used. The
+ * executor skips the outer table fragments in which no row bounding box intersects the
+ * one of a spatial predicate's constant geometry or, for spatial joins, of any inner row.
+ * Only whole outer fragments are skipped: inner tables are still read in full and
+ * overlaps joins still build their hash table from every inner row.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "DataMgr/ChunkMetadata.h"
+
+struct ColumnDescriptor;
+
+namespace Data_Namespace {
+class DataMgr;
+}  // namespace Data_Namespace
+
+struct SpatialIndexDescriptor {
+  std::string index_name;
+  // the logical table and geo column
+  int table_id;
+  int column_id;
+};
+
+class FragmentSpatialIndex;
+
+struct CachedFragmentSpatialIndex {
+  std::shared_ptr<const FragmentSpatialIndex> index;
+  // whether the saved index covers all the rows of this one
+  bool is_saved{false};
+};
+
+class FragmentSpatialIndex {
+ public:
+  using Point = boost::geometry::model::point<double, 2, boost::geometry::cs::cartesian>;
+  using BoundingBox = boost::geometry::model::box<Point>;
+  // bounding box of a row and its offset in the fragment
+  using Node = std::pair<BoundingBox, uint32_t>;
+  using RTree = boost::geometry::index::rtree<Node, boost::geometry::index::rstar<16>>;
+
+  // Bulk loads the tree. num_rows_indexed counts the rows read, null ones included.
+  FragmentSpatialIndex(const std::vector<Node>& nodes, const size_t num_rows_indexed);
+
+  size_t getNumRowsIndexed() const { return num_rows_indexed_; }
+
+  size_t size() const { return rtree_.size(); }
+
+  // Returns whether the bounding box of a row intersects the given one.
+  bool intersects(const BoundingBox& bounding_box) const;
+
+  // Returns whether the bounding box of a row intersects the one of a row of other.
+  bool intersects(const FragmentSpatialIndex& other) const;
+
+  // Returns the offsets of the rows whose bounding box intersects the given one.
+  std::vector<uint32_t> query(const BoundingBox& bounding_box) const;
+
+  // Returns a copy of this index with the given rows inserted.
+  std::unique_ptr<FragmentSpatialIndex> extend(const std::vector<Node>& nodes,
+                                               const size_t num_rows_indexed) const;
+
+  // Saves the index along with the epoch of the checkpoint its rows were written by.
+  // Returns false if it could not be saved.
+  bool save(const std::string& path, const int32_t epoch) const;
+
+  // Returns the saved index, or nullptr if there is none, it is unreadable or it was
+  // saved at a later epoch than max_epoch.
+  static std::unique_ptr<FragmentSpatialIndex> load(const std::string& path,
+                                                    const int32_t max_epoch);
+
+ private:
+  size_t num_rows_indexed_;
+  RTree rtree_;
+};
+
+// Returns whether a spatial index can be created on columns of the given type.
+bool is_spatial_index_supported(const SQLTypeInfo& geo_ti);
+
+// Returns the id of the physical column the bounding boxes of the rows of a geo column
+// are read from: the coords of a POINT column, the bounds of other geo types.
+int get_bounding_box_column_id(const SQLTypeInfo& geo_ti, const int geo_column_id);
+
+// Reads the bounding boxes of the rows [begin_row, end_row) of a chunk, skipping null
+// geometries. box_cd is the coords column of a POINT column and the bounds column of
+// other geo types, geo_ti the type of the logical geo column.
+std::vector<FragmentSpatialIndex::Node> read_bounding_boxes(
+    Data_Namespace::DataMgr& data_mgr,
+    const ColumnDescriptor* box_cd,
+    const SQLTypeInfo& geo_ti,
+    const ChunkKey& chunk_key,
+    const std::shared_ptr<ChunkMetadata>& chunk_metadata,
+    const size_t begin_row,
+    const size_t end_row);
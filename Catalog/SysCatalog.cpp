@@ -1079,6 +1079,8 @@ void SysCatalog::createDatabase(const string& name, int owner) {
     dbConn->query_with_text_params(
         "INSERT INTO mapd_record_ownership_marker (dummy) VALUES (?1)",
         std::vector<std::string>{std::to_string(owner)});
+    dbConn->query(Catalog::getColumnStatisticsSchema());
+    dbConn->query(Catalog::getSpatialIndexSchema());
 
     if (g_enable_fsi) {
       dbConn->query(Catalog::getForeignServerSchema());
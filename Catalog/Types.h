@@ -22,10 +22,12 @@
 #include <unordered_map>
 
 #include "Catalog/ColumnDescriptor.h"
+#include "Catalog/ColumnStatistics.h"
 #include "Catalog/DashboardDescriptor.h"
 #include "Catalog/DictDescriptor.h"
 #include "Catalog/ForeignServer.h"
 #include "Catalog/LinkDescriptor.h"
+#include "Catalog/SpatialIndex.h"
 #include "Catalog/TableDescriptor.h"
 
 namespace Catalog_Namespace {
@@ -48,4 +50,9 @@ using ForeignServerMap =
     std::map<std::string, std::shared_ptr<foreign_storage::ForeignServer>>;
 using ForeignServerMapById =
     std::map<int, std::shared_ptr<foreign_storage::ForeignServer>>;
+using ColumnStatisticsMapById =
+    std::map<ColumnIdKey, std::shared_ptr<const ColumnStatistics>>;
+using SpatialIndexMap = std::map<std::string, std::shared_ptr<SpatialIndexDescriptor>>;
+using FragmentSpatialIndexCache =
+    std::map<std::tuple<int, int, int>, CachedFragmentSpatialIndex>;
 }  // namespace Catalog_Namespace
@@ -28,6 +28,7 @@
 #include "DataMgr/BufferMgr/Buffer.h"
 #include "Shared/Logger.h"
 #include "Shared/measure.h"
+#include "Shared/scope.h"
 
 using namespace std;
 
@@ -604,6 +605,7 @@ void BufferMgr::deleteBuffersWithPrefix(const ChunkKey& key_prefix, const bool)
                            // reserveBuffer which needs segs_mutex_ and then
                            // chunk_index_mutex_
   std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  ++num_prefix_deletions_;
   auto startChunkIt = chunk_index_.lower_bound(key_prefix);
   if (startChunkIt == chunk_index_.end()) {
     return;
@@ -702,6 +704,8 @@ void BufferMgr::checkpoint(const int db_id, const int tb_id) {
 /// Returns a pointer to the Buffer holding the chunk, if it exists; otherwise,
 /// throws a runtime_error.
 AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t num_bytes) {
+  ++num_demand_fetches_;
+  ScopeGuard end_demand_fetch = [this] { --num_demand_fetches_; };
   std::lock_guard<std::mutex> lock(global_mutex_);  // granular lock
 
   std::unique_lock<std::mutex> sized_segs_lock(sized_segs_mutex_);
@@ -718,27 +722,131 @@ AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t num_bytes
 
     if (buffer_it->second->buffer->size() < num_bytes) {
       // need to fetch part of buffer we don't have - up to numBytes
-      parent_mgr_->fetchBuffer(key, buffer_it->second->buffer, num_bytes);
+      fetchFromParent(key, buffer_it->second->buffer, num_bytes);
     }
+    recordAccess(key, buffer_it->second->buffer);
     return buffer_it->second->buffer;
   } else {  // If wasn't in pool then we need to fetch it
     sized_segs_lock.unlock();
     // createChunk pins for us
     AbstractBuffer* buffer = createBuffer(key, page_size_, num_bytes);
     try {
-      parent_mgr_->fetchBuffer(
-          key, buffer, num_bytes);  // this should put buffer in a BufferSegment
+      // this should put buffer in a BufferSegment
+      fetchFromParent(key, buffer, num_bytes);
     } catch (std::runtime_error& error) {
       LOG(FATAL) << "Get chunk - Could not find chunk " << keyToString(key)
                  << " in buffer pool or parent buffer pools. Error was " << error.what();
     }
+    recordAccess(key, buffer);
     return buffer;
   }
 }
 
+void BufferMgr::fetchFromParent(const ChunkKey& key,
+                                AbstractBuffer* buffer,
+                                const size_t num_bytes) {
+  const auto size_before = buffer->isUpdated() ? size_t(0) : buffer->size();
+  parent_mgr_->fetchBuffer(key, buffer, num_bytes);
+  if (buffer->size() > size_before) {
+    num_bytes_fetched_ += buffer->size() - size_before;
+  }
+}
+
+void BufferMgr::recordAccess(const ChunkKey& key, const AbstractBuffer* buffer) {
+  std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  auto& stats = chunk_access_stats_[key];
+  ++stats.access_count;
+  stats.last_touched = buffer_epoch_;
+  stats.num_bytes = buffer->size();
+}
+
+ChunkAccessHistory BufferMgr::getChunkAccessHistory() {
+  ChunkAccessHistory history;
+  {
+    std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+    history.assign(chunk_access_stats_.begin(), chunk_access_stats_.end());
+  }
+  std::sort(history.begin(), history.end(), [](const auto& lhs, const auto& rhs) {
+    if (lhs.second.access_count != rhs.second.access_count) {
+      return lhs.second.access_count > rhs.second.access_count;
+    }
+    return lhs.second.last_touched > rhs.second.last_touched;
+  });
+  return history;
+}
+
+void BufferMgr::setChunkAccessHistory(const ChunkAccessHistory& history) {
+  std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  // replays the history from the least to the most recent, so that the epochs of the
+  // chunks keep their order
+  for (auto it = history.rbegin(); it != history.rend(); ++it) {
+    if (it->second.access_count < 2) {
+      continue;
+    }
+    auto& stats = chunk_access_stats_[it->first];
+    stats.access_count += it->second.access_count / 2;
+    stats.last_touched = buffer_epoch_++;
+    stats.num_bytes = std::max(stats.num_bytes, it->second.num_bytes);
+  }
+}
+
+size_t BufferMgr::warmBuffer(const ChunkKey& key) {
+  CHECK(parent_mgr_);
+  mapd_shared_lock<mapd_shared_mutex> warm_buffers_lock(warm_buffers_mutex_);
+  size_t num_prefix_deletions;
+  {
+    std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+    // the parent level would bring back the storage of a dropped table when looked up
+    if (removed_tables_.count({key[0], key[1]})) {
+      return 0;
+    }
+    num_prefix_deletions = num_prefix_deletions_;
+  }
+  if (isBufferOnDevice(key) || !parent_mgr_->isBufferOnDevice(key)) {
+    return 0;
+  }
+  const auto num_bytes = parent_mgr_->getBuffer(key)->size();
+  if (num_bytes == 0) {
+    return 0;
+  }
+  // the chunk is read into an anonymous buffer, which is sized up front so that the
+  // read does not allocate, and which is only put under the key of the chunk once read
+  auto buffer = dynamic_cast<Buffer*>(alloc(num_bytes));
+  CHECK(buffer);
+  try {
+    fetchFromParent(key, buffer, num_bytes);
+  } catch (...) {
+    buffer->unPin();
+    free(buffer);
+    throw;
+  }
+  {
+    std::lock_guard<std::mutex> lock(global_mutex_);  // granular lock
+    std::lock_guard<std::mutex> sized_segs_lock(sized_segs_mutex_);
+    std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+    // a query may have requested the chunk meanwhile, or its table may have been
+    // truncated or dropped
+    if (chunk_index_.find(key) == chunk_index_.end() &&
+        num_prefix_deletions_ == num_prefix_deletions) {
+      auto seg_it = buffer->seg_it_;
+      chunk_index_.erase(seg_it->chunk_key);
+      seg_it->chunk_key = key;
+      seg_it->last_touched = buffer_epoch_++;
+      chunk_index_[key] = seg_it;
+      buffer->unPin();
+      return num_bytes;
+    }
+  }
+  buffer->unPin();
+  free(buffer);
+  return 0;
+}
+
 void BufferMgr::fetchBuffer(const ChunkKey& key,
                             AbstractBuffer* dest_buffer,
                             const size_t num_bytes) {
+  ++num_demand_fetches_;
+  ScopeGuard end_demand_fetch = [this] { --num_demand_fetches_; };
   std::unique_lock<std::mutex> lock(global_mutex_);  // granular lock
   std::unique_lock<std::mutex> sized_segs_lock(sized_segs_mutex_);
   std::unique_lock<std::mutex> chunk_index_lock(chunk_index_mutex_);
@@ -752,7 +860,7 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
     CHECK(parent_mgr_ != 0);
     buffer = createBuffer(key, page_size_, num_bytes);  // will pin buffer
     try {
-      parent_mgr_->fetchBuffer(key, buffer, num_bytes);
+      fetchFromParent(key, buffer, num_bytes);
     } catch (std::runtime_error& error) {
       LOG(FATAL) << "Could not fetch parent buffer " << keyToString(key);
     }
@@ -761,7 +869,7 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
     buffer->pin();
     if (num_bytes > buffer->size()) {
       try {
-        parent_mgr_->fetchBuffer(key, buffer, num_bytes);
+        fetchFromParent(key, buffer, num_bytes);
       } catch (std::runtime_error& error) {
         LOG(FATAL) << "Could not fetch parent buffer " << keyToString(key);
       }
@@ -786,6 +894,7 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
   }
   dest_buffer->setSize(chunk_size);
   dest_buffer->syncEncoder(buffer);
+  recordAccess(key, buffer);
   buffer->unPin();
 }
 
@@ -878,6 +987,14 @@ const std::vector<BufferList>& BufferMgr::getSlabSegments() {
 }
 
 void BufferMgr::removeTableRelatedDS(const int db_id, const int table_id) {
-  UNREACHABLE();
+  const ChunkKey table_prefix{db_id, table_id};
+  deleteBuffersWithPrefix(table_prefix);
+  std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  removed_tables_.insert(table_prefix);
+  auto stats_it = chunk_access_stats_.lower_bound(table_prefix);
+  while (stats_it != chunk_access_stats_.end() &&
+         std::equal(table_prefix.begin(), table_prefix.end(), stats_it->first.begin())) {
+    stats_it = chunk_access_stats_.erase(stats_it);
+  }
 }
 }  // namespace Buffer_Namespace
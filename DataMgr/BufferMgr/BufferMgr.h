@@ -26,16 +26,21 @@
 
 #define BOOST_STACKTRACE_GNU_SOURCE_NOT_REQUIRED 1
 
+#include <atomic>
 #include <iostream>
 #include <list>
 #include <map>
 #include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
 
 #include <boost/stacktrace.hpp>
 
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/AbstractBufferMgr.h"
 #include "DataMgr/BufferMgr/BufferSeg.h"
+#include "Shared/mapd_shared_mutex.h"
 #include "Shared/types.h"
 
 class OutOfMemory : public std::runtime_error {
@@ -87,6 +92,15 @@ using namespace Data_Namespace;
 
 namespace Buffer_Namespace {
 
+/// How often and how recently a chunk was requested from a buffer pool.
+struct ChunkAccessStats {
+  size_t access_count{0};
+  unsigned int last_touched{0};  /// buffer epoch of the last access
+  size_t num_bytes{0};           /// size of the chunk when last accessed
+};
+
+using ChunkAccessHistory = std::vector<std::pair<ChunkKey, ChunkAccessStats>>;
+
 /**
  * @class   BufferMgr
  * @brief
@@ -125,6 +139,30 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   size_t getPageSize();
   bool isAllocationCapped() override;
   const std::vector<BufferList>& getSlabSegments();
+  /// Returns the number of bytes fetched into the pool from the parent level so far.
+  size_t getNumBytesFetched() const { return num_bytes_fetched_; }
+  /// Returns the number of getBuffer and fetchBuffer calls currently in progress.
+  int getNumDemandFetches() const { return num_demand_fetches_; }
+
+  /// Returns the chunks requested so far, most frequently requested first, and the most
+  /// recently requested first among those requested as often.
+  ChunkAccessHistory getChunkAccessHistory();
+  /// Seeds the access stats with a history saved by an earlier run, in the order of
+  /// getChunkAccessHistory(). The access counts are halved, so that chunks which are no
+  /// longer requested age out of the history over a few restarts.
+  void setChunkAccessHistory(const ChunkAccessHistory& history);
+  /// Loads the chunk into the pool from the parent level, unless it is already there or
+  /// does not exist. The chunk is read outside of the global lock, so that several
+  /// chunks can be loaded in parallel without holding up getBuffer. Returns the number
+  /// of bytes loaded. The chunk is dropped if chunks were deleted from the pool by
+  /// prefix while it was read, since it may belong to a table truncated meanwhile.
+  /// Chunks of tables whose storage was removed by removeTableRelatedDS are skipped.
+  size_t warmBuffer(const ChunkKey& key);
+  /// Holds off warmBuffer, e.g. while the storage of a table is removed from the parent
+  /// level, since warmBuffer reads chunks without table locks.
+  mapd_unique_lock<mapd_shared_mutex> lockWarmBuffers() {
+    return mapd_unique_lock<mapd_shared_mutex>(warm_buffers_mutex_);
+  }
 
   /// Creates a chunk with the specified key and page size.
   AbstractBuffer* createBuffer(const ChunkKey& key,
@@ -186,6 +224,10 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   BufferList::iterator findFreeBufferInSlab(const size_t slab_num,
                                             const size_t num_pages_requested);
   int getBufferId();
+  void fetchFromParent(const ChunkKey& key,
+                       AbstractBuffer* buffer,
+                       const size_t num_bytes);
+  void recordAccess(const ChunkKey& key, const AbstractBuffer* buffer);
   virtual void addSlab(const size_t slab_size) = 0;
   virtual void freeAllMem() = 0;
   virtual void allocateBuffer(BufferList::iterator seg_it,
@@ -207,6 +249,12 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   AbstractBufferMgr* parent_mgr_;
   int max_buffer_id_;
   unsigned int buffer_epoch_;
+  std::atomic<size_t> num_bytes_fetched_{0};
+  std::atomic<int> num_demand_fetches_{0};
+  std::map<ChunkKey, ChunkAccessStats> chunk_access_stats_;  // chunk_index_mutex_
+  size_t num_prefix_deletions_{0};                          // chunk_index_mutex_
+  std::set<ChunkKey> removed_tables_;  // prefixes of tables removed, chunk_index_mutex_
+  mapd_shared_mutex warm_buffers_mutex_;
 
   BufferList unsized_segs_;
 
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/BufferMgr/BufferPoolWarmup.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <vector>
+
+#include "Shared/Logger.h"
+#include "Shared/measure.h"
+
+namespace Buffer_Namespace {
+
+namespace {
+
+constexpr int kHistoryVersion{1};
+constexpr unsigned kMaxWarmupThreads{8};
+// database, table, column, fragment and varlen part
+constexpr size_t kMaxChunkKeySize{5};
+
+}  // namespace
+
+BufferPoolWarmup::BufferPoolWarmup(BufferMgr* buffer_mgr,
+                                   ChunkAccessHistory history,
+                                   const size_t max_num_bytes)
+    : buffer_mgr_(buffer_mgr)
+    , history_(std::move(history))
+    , max_num_bytes_(max_num_bytes) {
+  warmup_thread_ = std::thread(&BufferPoolWarmup::warmUp, this);
+}
+
+BufferPoolWarmup::~BufferPoolWarmup() {
+  {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    stop_ = true;
+  }
+  stop_cv_.notify_all();
+  wait();
+}
+
+void BufferPoolWarmup::wait() {
+  if (warmup_thread_.joinable()) {
+    warmup_thread_.join();
+  }
+}
+
+void BufferPoolWarmup::warmUp() {
+  const auto thread_count = std::max(
+      1u, std::min(std::thread::hardware_concurrency(), kMaxWarmupThreads));
+  auto clock_begin = timer_start();
+  std::vector<std::future<void>> loader_futures;
+  for (unsigned i = 0; i < thread_count; ++i) {
+    loader_futures.emplace_back(
+        std::async(std::launch::async, &BufferPoolWarmup::loadChunks, this));
+  }
+  for (auto& loader_future : loader_futures) {
+    try {
+      loader_future.get();
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Buffer pool warm-up stopped: " << e.what();
+    }
+  }
+  LOG(INFO) << "Buffer pool warm-up loaded " << num_chunks_loaded_ << " chunks ("
+            << num_bytes_loaded_ << " bytes) in " << timer_stop(clock_begin) << " ms";
+}
+
+void BufferPoolWarmup::loadChunks() {
+  while (waitForDemandFetches()) {
+    const auto chunk_idx = claimChunk();
+    if (chunk_idx == history_.size()) {
+      return;
+    }
+    const auto num_bytes = buffer_mgr_->warmBuffer(history_[chunk_idx].first);
+    if (num_bytes) {
+      num_bytes_loaded_ += num_bytes;
+      ++num_chunks_loaded_;
+    }
+  }
+}
+
+size_t BufferPoolWarmup::claimChunk() {
+  std::lock_guard<std::mutex> lock(claim_mutex_);
+  // the size of the chunk at the time of the history counts against the budget, the
+  // size loaded only differs if the chunk was appended to since
+  for (; next_chunk_idx_ < history_.size(); ++next_chunk_idx_) {
+    const auto num_bytes = history_[next_chunk_idx_].second.num_bytes;
+    if (num_bytes_claimed_ + num_bytes <= max_num_bytes_) {
+      num_bytes_claimed_ += num_bytes;
+      return next_chunk_idx_++;
+    }
+  }
+  return next_chunk_idx_;
+}
+
+bool BufferPoolWarmup::waitForDemandFetches() {
+  std::unique_lock<std::mutex> lock(thread_mutex_);
+  while (!stop_ && buffer_mgr_->getNumDemandFetches() > 0) {
+    stop_cv_.wait_for(lock, std::chrono::milliseconds(1));
+  }
+  return !stop_;
+}
+
+void BufferPoolWarmup::writeHistory(const std::string& path,
+                                    const ChunkAccessHistory& history,
+                                    const size_t max_num_bytes) {
+  // written aside and renamed, so that a crash never leaves a torn history behind
+  const auto tmp_path = path + ".tmp";
+  {
+    std::ofstream history_file(tmp_path, std::ios::trunc);
+    history_file << kHistoryVersion << "\n";
+    size_t num_bytes{0};
+    for (const auto& [chunk_key, stats] : history) {
+      num_bytes += stats.num_bytes;
+      if (num_bytes > max_num_bytes) {
+        break;
+      }
+      history_file << stats.access_count << " " << stats.num_bytes << " "
+                   << chunk_key.size();
+      for (const auto key_part : chunk_key) {
+        history_file << " " << key_part;
+      }
+      history_file << "\n";
+    }
+    history_file.flush();
+    if (!history_file) {
+      LOG(WARNING) << "Could not write the buffer pool history to " << tmp_path;
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str())) {
+    LOG(WARNING) << "Could not rename the buffer pool history to " << path;
+  }
+}
+
+ChunkAccessHistory BufferPoolWarmup::readHistory(const std::string& path) {
+  ChunkAccessHistory history;
+  std::ifstream history_file(path);
+  int version{0};
+  if (!(history_file >> version)) {
+    return history;
+  }
+  if (version != kHistoryVersion) {
+    LOG(WARNING) << "Ignoring buffer pool history " << path << " of version " << version;
+    return history;
+  }
+  ChunkAccessStats stats;
+  size_t key_size{0};
+  while (history_file >> stats.access_count >> stats.num_bytes >> key_size) {
+    if (key_size == 0 || key_size > kMaxChunkKeySize) {
+      break;
+    }
+    ChunkKey chunk_key(key_size);
+    for (auto& key_part : chunk_key) {
+      history_file >> key_part;
+    }
+    if (!history_file) {
+      break;
+    }
+    history.emplace_back(std::move(chunk_key), stats);
+  }
+  return history;
+}
+
+}  // namespace Buffer_Namespace
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    BufferPoolWarmup.h
+ * @brief   Reloading of the hottest chunks into a buffer pool after a restart.
+ *
+ * The access history of the pool, the chunks requested most often and most recently,
+ * is saved to a small file at checkpoints and at shutdown. On startup, the chunks of the
+ * history are loaded back into the pool in the background, hottest first, until a
+ * fraction of the pool is filled. The chunks are read by a few threads in parallel.
+ * Queries run meanwhile: the warm-up does not start reading another chunk while a query
+ * is fetching chunks into the pool.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "DataMgr/BufferMgr/BufferMgr.h"
+
+namespace Buffer_Namespace {
+
+class BufferPoolWarmup {
+ public:
+  // Loads the chunks of the history into the pool, up to max_num_bytes.
+  BufferPoolWarmup(BufferMgr* buffer_mgr,
+                   ChunkAccessHistory history,
+                   const size_t max_num_bytes);
+
+  ~BufferPoolWarmup();
+
+  // Waits for the warm-up to finish.
+  void wait();
+
+  size_t getNumChunksLoaded() const { return num_chunks_loaded_; }
+
+  // Writes the head of the history, as many chunks as fit in max_num_bytes.
+  static void writeHistory(const std::string& path,
+                           const ChunkAccessHistory& history,
+                           const size_t max_num_bytes);
+
+  // Returns the saved history, or an empty one if there is none or it is unreadable.
+  static ChunkAccessHistory readHistory(const std::string& path);
+
+ private:
+  void warmUp();
+  void loadChunks();
+  // Returns the index of the hottest chunk left which fits in the budget, or the size
+  // of the history if there is none.
+  size_t claimChunk();
+  // Waits for the queries fetching chunks into the pool. Returns false if the warm-up
+  // is stopped meanwhile.
+  bool waitForDemandFetches();
+
+  BufferMgr* buffer_mgr_;
+  const ChunkAccessHistory history_;
+  const size_t max_num_bytes_;
+
+  std::mutex claim_mutex_;
+  size_t next_chunk_idx_{0};
+  size_t num_bytes_claimed_{0};
+  std::atomic<size_t> num_bytes_loaded_{0};
+  std::atomic<size_t> num_chunks_loaded_{0};
+
+  std::mutex thread_mutex_;
+  std::condition_variable stop_cv_;
+  bool stop_{false};
+  std::thread warmup_thread_;
+};
+
+}  // namespace Buffer_Namespace
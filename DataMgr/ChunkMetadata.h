@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cstddef>
+#include <optional>
 #include "../Shared/sqltypes.h"
 #include "Shared/types.h"
 
@@ -28,11 +29,27 @@ struct ChunkStats {
   bool has_nulls;
 };
 
+// Bounding box of the geometries of a chunk of the point coords or bounds of a geo
+// column, null geometries excluded.
+struct ChunkBoundingBox {
+  double min_x;
+  double min_y;
+  double max_x;
+  double max_y;
+
+  bool operator==(const ChunkBoundingBox& that) const {
+    return min_x == that.min_x && min_y == that.min_y && max_x == that.max_x &&
+           max_y == that.max_y;
+  }
+};
+
 struct ChunkMetadata {
   SQLTypeInfo sqlType;
   size_t numBytes;
   size_t numElements;
   ChunkStats chunkStats;
+  // only known for the chunks of geo columns holding coords of points or bounds
+  std::optional<ChunkBoundingBox> boundingBox;
 
   ChunkMetadata(const SQLTypeInfo& sql_type,
                 const size_t num_bytes,
@@ -118,7 +135,8 @@ struct ChunkMetadata {
            numElements == that.numElements &&
            DatumEqual(chunkStats.min, that.chunkStats.min, sqlType) &&
            DatumEqual(chunkStats.max, that.chunkStats.max, sqlType) &&
-           chunkStats.has_nulls == that.chunkStats.has_nulls;
+           chunkStats.has_nulls == that.chunkStats.has_nulls &&
+           boundingBox == that.boundingBox;
   }
 };
 
@@ -20,6 +20,7 @@
  */
 
 #include "DataMgr/DataMgr.h"
+#include "BufferMgr/BufferPoolWarmup.h"
 #include "BufferMgr/CpuBufferMgr/CpuBufferMgr.h"
 #include "BufferMgr/GpuCudaBufferMgr/GpuCudaBufferMgr.h"
 #include "CudaMgr/CudaMgr.h"
@@ -46,6 +47,13 @@ extern bool g_enable_fsi;
 
 namespace Data_Namespace {
 
+namespace {
+
+// the history is also saved at shutdown, the checkpoints only bound what a crash loses
+constexpr auto kBufferPoolHistoryWriteInterval = std::chrono::minutes(1);
+
+}  // namespace
+
 DataMgr::DataMgr(const string& dataDir,
                  const SystemParameters& system_parameters,
                  const bool useGpus,
@@ -53,7 +61,9 @@ DataMgr::DataMgr(const string& dataDir,
                  const int startGpu,
                  const size_t reservedGpuMem,
                  const size_t numReaderThreads)
-    : dataDir_(dataDir) {
+    : dataDir_(dataDir)
+    , enableBufferPoolWarmup_(system_parameters.enable_buffer_pool_warmup)
+    , bufferPoolHistoryWriteTime_(std::chrono::steady_clock::now()) {
   if (useGpus) {
     try {
       cudaMgr_ = std::make_unique<CudaMgr_Namespace::CudaMgr>(numGpus, startGpu);
@@ -70,9 +80,16 @@ DataMgr::DataMgr(const string& dataDir,
 
   populateMgrs(system_parameters, numReaderThreads);
   createTopLevelMetadata();
+  if (enableBufferPoolWarmup_) {
+    startBufferPoolWarmup(system_parameters.buffer_pool_warmup_fraction);
+  }
 }
 
 DataMgr::~DataMgr() {
+  if (enableBufferPoolWarmup_) {
+    bufferPoolWarmup_.reset();
+    writeBufferPoolHistory(/*force=*/true);
+  }
   int numLevels = bufferMgrs_.size();
   for (int level = numLevels - 1; level >= 0; --level) {
     for (size_t device = 0; device < bufferMgrs_[level].size(); device++) {
@@ -379,6 +396,19 @@ std::string DataMgr::dumpLevel(const MemoryLevel memLevel) {
   }
 }
 
+size_t DataMgr::getNumBytesFetched(const MemoryLevel memLevel) const {
+  if (memLevel == MemoryLevel::DISK_LEVEL || bufferMgrs_.size() <= memLevel) {
+    return 0;
+  }
+  size_t num_bytes{0};
+  for (int device = 0; device < levelSizes_[memLevel]; ++device) {
+    const auto buffer_mgr = dynamic_cast<BufferMgr*>(bufferMgrs_[memLevel][device]);
+    CHECK(buffer_mgr);
+    num_bytes += buffer_mgr->getNumBytesFetched();
+  }
+  return num_bytes;
+}
+
 void DataMgr::clearMemory(const MemoryLevel memLevel) {
   // if gpu we need to iterate through all the buffermanagers for each card
   if (memLevel == MemoryLevel::GPU_LEVEL) {
@@ -490,6 +520,9 @@ void DataMgr::checkpoint(const int db_id, const int tb_id) {
       (*deviceIt)->checkpoint(db_id, tb_id);
     }
   }
+  if (enableBufferPoolWarmup_) {
+    writeBufferPoolHistory(/*force=*/false);
+  }
 }
 
 void DataMgr::checkpoint() {
@@ -501,8 +534,56 @@ void DataMgr::checkpoint() {
   }
 }
 
+std::string DataMgr::getBufferPoolHistoryPath() const {
+  return (boost::filesystem::path(dataDir_) / "buffer_pool_history").string();
+}
+
+void DataMgr::startBufferPoolWarmup(const double warmup_fraction) {
+  auto cpu_buffer_mgr = dynamic_cast<BufferMgr*>(bufferMgrs_[MemoryLevel::CPU_LEVEL][0]);
+  CHECK(cpu_buffer_mgr);
+  auto history = BufferPoolWarmup::readHistory(getBufferPoolHistoryPath());
+  if (history.empty()) {
+    return;
+  }
+  // keeps the history of the chunks which are not requested until the next shutdown
+  cpu_buffer_mgr->setChunkAccessHistory(history);
+  const size_t max_num_bytes = cpu_buffer_mgr->getMaxSize() * warmup_fraction;
+  LOG(INFO) << "Reloading up to " << (float)max_num_bytes / (1024 * 1024)
+            << "M of the " << history.size()
+            << " chunks of the buffer pool history into the CPU buffer pool";
+  bufferPoolWarmup_ = std::make_unique<BufferPoolWarmup>(
+      cpu_buffer_mgr, std::move(history), max_num_bytes);
+}
+
+void DataMgr::waitForBufferPoolWarmup() {
+  if (bufferPoolWarmup_) {
+    bufferPoolWarmup_->wait();
+  }
+}
+
+void DataMgr::writeBufferPoolHistory(const bool force) {
+  auto cpu_buffer_mgr = dynamic_cast<BufferMgr*>(bufferMgrs_[MemoryLevel::CPU_LEVEL][0]);
+  CHECK(cpu_buffer_mgr);
+  std::lock_guard<std::mutex> lock(bufferPoolHistoryMutex_);
+  if (!force && std::chrono::steady_clock::now() <
+                    bufferPoolHistoryWriteTime_ + kBufferPoolHistoryWriteInterval) {
+    return;
+  }
+  BufferPoolWarmup::writeHistory(getBufferPoolHistoryPath(),
+                                 cpu_buffer_mgr->getChunkAccessHistory(),
+                                 cpu_buffer_mgr->getMaxSize());
+  bufferPoolHistoryWriteTime_ = std::chrono::steady_clock::now();
+}
+
 void DataMgr::removeTableRelatedDS(const int db_id, const int tb_id) {
+  // the warm-up of the CPU buffer pool reads chunks without table locks, hence it is held
+  // off while the storage of the table goes away, and what it loaded of the table after
+  // the caller deleted its chunks from the pool is dropped with its access history
+  auto cpu_buffer_mgr = dynamic_cast<BufferMgr*>(bufferMgrs_[MemoryLevel::CPU_LEVEL][0]);
+  CHECK(cpu_buffer_mgr);
+  const auto warm_buffers_lock = cpu_buffer_mgr->lockWarmBuffers();
   bufferMgrs_[0][0]->removeTableRelatedDS(db_id, tb_id);
+  cpu_buffer_mgr->removeTableRelatedDS(db_id, tb_id);
 }
 
 void DataMgr::setTableEpoch(const int db_id, const int tb_id, const int start_epoch) {
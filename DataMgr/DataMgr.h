@@ -29,9 +29,12 @@
 #include "BufferMgr/BufferMgr.h"
 #include "MemoryLevel.h"
 
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -41,6 +44,10 @@ class FileBuffer;
 class GlobalFileMgr;
 }  // namespace File_Namespace
 
+namespace Buffer_Namespace {
+class BufferPoolWarmup;
+}
+
 namespace CudaMgr_Namespace {
 class CudaMgr;
 }
@@ -130,7 +137,11 @@ class DataMgr {
                         const int deviceId);
   std::vector<MemoryInfo> getMemoryInfo(const MemoryLevel memLevel);
   std::string dumpLevel(const MemoryLevel memLevel);
+  // bytes fetched into the buffer pools of the level from the level below, so far
+  size_t getNumBytesFetched(const MemoryLevel memLevel) const;
   void clearMemory(const MemoryLevel memLevel);
+  // waits for the chunks of the access history to be reloaded into the CPU buffer pool
+  void waitForBufferPoolWarmup();
 
   // const std::map<ChunkKey, File_Namespace::FileBuffer *> & getChunkMap();
   const std::map<ChunkKey, File_Namespace::FileBuffer*>& getChunkMap();
@@ -168,6 +179,10 @@ class DataMgr {
   void convertDB(const std::string basePath);
   void checkpoint();  // checkpoint for whole DB, called from convertDB proc only
   void createTopLevelMetadata() const;
+  std::string getBufferPoolHistoryPath() const;
+  void startBufferPoolWarmup(const double warmup_fraction);
+  // writes the access history of the CPU buffer pool, at most once a minute unless forced
+  void writeBufferPoolHistory(const bool force);
 
   std::vector<std::vector<AbstractBufferMgr*>> bufferMgrs_;
   std::unique_ptr<CudaMgr_Namespace::CudaMgr> cudaMgr_;
@@ -176,6 +191,10 @@ class DataMgr {
   size_t reservedGpuMem_;
   std::map<ChunkKey, std::shared_ptr<mapd_shared_mutex>> chunkMutexMap_;
   mapd_shared_mutex chunkMutexMapMutex_;
+  bool enableBufferPoolWarmup_;
+  std::unique_ptr<Buffer_Namespace::BufferPoolWarmup> bufferPoolWarmup_;
+  std::mutex bufferPoolHistoryMutex_;
+  std::chrono::steady_clock::time_point bufferPoolHistoryWriteTime_;
 };
 
 std::ostream& operator<<(std::ostream& os, const DataMgr::SystemMemoryUsage&);
@@ -30,11 +30,13 @@
 #include <cstring>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 #include "AbstractBuffer.h"
 #include "ChunkMetadata.h"
 #include "Encoder.h"
+#include "Shared/geo_compression_runtime.h"
 
 using Data_Namespace::AbstractBuffer;
 
@@ -98,12 +100,14 @@ class FixedLengthArrayNoneEncoder : public Encoder {
   void getMetadata(const std::shared_ptr<ChunkMetadata>& chunkMetadata) override {
     Encoder::getMetadata(chunkMetadata);  // call on parent class
     chunkMetadata->fillChunkStats(elem_min, elem_max, has_nulls);
+    chunkMetadata->boundingBox = bounding_box_known ? bounding_box : std::nullopt;
   }
 
   // Only called from the executor for synthesized meta-information.
   std::shared_ptr<ChunkMetadata> getMetadata(const SQLTypeInfo& ti) override {
     auto chunk_metadata = std::make_shared<ChunkMetadata>(
         ti, 0, 0, ChunkStats{elem_min, elem_max, has_nulls});
+    chunk_metadata->boundingBox = bounding_box_known ? bounding_box : std::nullopt;
     return chunk_metadata;
   }
 
@@ -138,6 +142,16 @@ class FixedLengthArrayNoneEncoder : public Encoder {
     fwrite((int8_t*)&elem_max, sizeof(Datum), 1, f);
     fwrite((int8_t*)&has_nulls, sizeof(bool), 1, f);
     fwrite((int8_t*)&initialized, sizeof(bool), 1, f);
+    // the bounding box follows the original metadata, with a checksum of both so that
+    // it is only trusted if it was written along with the stats before it
+    BoundingBoxTrailer trailer;
+    trailer.bounding_box_known = bounding_box_known;
+    trailer.has_bounding_box = bounding_box_known && bounding_box.has_value();
+    if (trailer.has_bounding_box) {
+      trailer.bounding_box = *bounding_box;
+    }
+    trailer.checksum = getMetadataChecksum(trailer);
+    fwrite((int8_t*)&trailer, sizeof(BoundingBoxTrailer), 1, f);
   }
 
   void readMetadata(FILE* f) override {
@@ -147,6 +161,21 @@ class FixedLengthArrayNoneEncoder : public Encoder {
     fread((int8_t*)&elem_max, sizeof(Datum), 1, f);
     fread((int8_t*)&has_nulls, sizeof(bool), 1, f);
     fread((int8_t*)&initialized, sizeof(bool), 1, f);
+    // metadata written before bounding boxes were kept has none, the page holds
+    // whatever was there before. The rows of such a chunk are not covered by any box,
+    // it stays unknown unless the chunk is empty.
+    BoundingBoxTrailer trailer;
+    bounding_box = std::nullopt;
+    if (fread((int8_t*)&trailer, sizeof(BoundingBoxTrailer), 1, f) == 1 &&
+        trailer.magic == kBoundingBoxMagic &&
+        trailer.checksum == getMetadataChecksum(trailer)) {
+      bounding_box_known = trailer.bounding_box_known;
+      if (trailer.has_bounding_box) {
+        bounding_box = trailer.bounding_box;
+      }
+    } else {
+      bounding_box_known = num_elems_ == 0;
+    }
   }
 
   void copyMetadata(const Encoder* copyFromEncoder) override {
@@ -157,6 +186,15 @@ class FixedLengthArrayNoneEncoder : public Encoder {
     elem_max = array_encoder->elem_max;
     has_nulls = array_encoder->has_nulls;
     initialized = array_encoder->initialized;
+    bounding_box = array_encoder->bounding_box;
+    bounding_box_known = array_encoder->bounding_box_known;
+  }
+
+  // Starts the bounding box over, for callers about to pass every row of the chunk
+  // through updateMetadata.
+  void resetBoundingBox() {
+    bounding_box = std::nullopt;
+    bounding_box_known = true;
   }
 
   void updateMetadata(int8_t* array) {
@@ -221,14 +259,101 @@ class FixedLengthArrayNoneEncoder : public Encoder {
   Datum elem_max;
   bool has_nulls;
   bool initialized;
+  // Geo columns keep the coords of points and the bounds of other geometries in fixed
+  // length arrays, the bounding box of a chunk of those is kept along with the stats.
+  // Plain arrays of the same types get one as well, it is never looked at.
+  // No box with bounding_box_known set means no non-null rows yet, while chunks
+  // loaded without a trustworthy box don't know theirs until all rows are seen again.
+  std::optional<ChunkBoundingBox> bounding_box;
+  bool bounding_box_known{true};
 
  private:
+  static constexpr uint32_t kBoundingBoxMagic{0x42425832};  // "BBX2"
+
+  struct BoundingBoxTrailer {
+    uint32_t magic{kBoundingBoxMagic};
+    bool bounding_box_known{true};
+    bool has_bounding_box{false};
+    ChunkBoundingBox bounding_box{0, 0, 0, 0};
+    uint64_t checksum{0};
+  };
+
+  // FNV-1a over the stats and the bounding box
+  uint64_t getMetadataChecksum(const BoundingBoxTrailer& trailer) const {
+    uint64_t checksum{0xcbf29ce484222325ULL};
+    const auto hash_bytes = [&checksum](const void* data, const size_t size) {
+      const auto bytes = reinterpret_cast<const uint8_t*>(data);
+      for (size_t i = 0; i < size; ++i) {
+        checksum = (checksum ^ bytes[i]) * 0x100000001b3ULL;
+      }
+    };
+    hash_bytes(&num_elems_, sizeof(num_elems_));
+    hash_bytes(&elem_min, sizeof(elem_min));
+    hash_bytes(&elem_max, sizeof(elem_max));
+    hash_bytes(&has_nulls, sizeof(has_nulls));
+    hash_bytes(&initialized, sizeof(initialized));
+    hash_bytes(&trailer.bounding_box_known, sizeof(trailer.bounding_box_known));
+    hash_bytes(&trailer.has_bounding_box, sizeof(trailer.has_bounding_box));
+    hash_bytes(&trailer.bounding_box, sizeof(trailer.bounding_box));
+    return checksum;
+  }
+
   std::mutex EncoderMutex_;
   size_t array_size;
 
   bool is_null(int8_t* array) { return is_null(buffer_->sql_type, array); }
 
+  void update_bounding_box(const ArrayDatum& array) {
+    const auto& ti = buffer_->sql_type;
+    if (array.length != array_size) {
+      return;
+    }
+    ChunkBoundingBox array_box;
+    if (ti.get_subtype() == kDOUBLE && array_size == 4 * sizeof(double)) {
+      // bounds: min x, min y, max x, max y
+      const auto bounds = reinterpret_cast<const double*>(array.pointer);
+      if (array.is_null || bounds[0] == NULL_ARRAY_DOUBLE || bounds[0] == NULL_DOUBLE) {
+        return;
+      }
+      array_box = {bounds[0], bounds[1], bounds[2], bounds[3]};
+    } else if (ti.get_subtype() == kTINYINT && array_size == 2 * sizeof(int32_t)) {
+      // compressed point coords, the byte stats can't tell null points apart
+      const auto coords = reinterpret_cast<const int32_t*>(array.pointer);
+      if (Geo_namespace::is_null_point_longitude_geoint32(coords[0])) {
+        return;
+      }
+      const auto x = Geo_namespace::decompress_longitude_coord_geoint32(coords[0]);
+      const auto y = Geo_namespace::decompress_lattitude_coord_geoint32(coords[1]);
+      array_box = {x, y, x, y};
+    } else if (ti.get_subtype() == kTINYINT && array_size == 2 * sizeof(double)) {
+      // uncompressed point coords
+      const auto coords = reinterpret_cast<const double*>(array.pointer);
+      if (coords[0] == NULL_ARRAY_DOUBLE) {
+        return;
+      }
+      array_box = {coords[0], coords[1], coords[0], coords[1]};
+    } else {
+      return;
+    }
+    if (!bounding_box_known) {
+      if (num_elems_ > 0) {
+        // the rows already in the chunk may lie outside of a box of the new ones
+        return;
+      }
+      resetBoundingBox();
+    }
+    if (!bounding_box) {
+      bounding_box = array_box;
+      return;
+    }
+    bounding_box->min_x = std::min(bounding_box->min_x, array_box.min_x);
+    bounding_box->min_y = std::min(bounding_box->min_y, array_box.min_y);
+    bounding_box->max_x = std::max(bounding_box->max_x, array_box.max_x);
+    bounding_box->max_y = std::max(bounding_box->max_y, array_box.max_y);
+  }
+
   void update_elem_stats(const ArrayDatum& array) {
+    update_bounding_box(array);
     if (array.is_null) {
       has_nulls = true;
     }
@@ -115,6 +115,11 @@ class AbstractFragmenter {
    */
   virtual void insertDataNoCheckpoint(InsertData& insertDataStruct) = 0;
 
+  /**
+   * @brief Checkpoints the table, holding off concurrent inserts
+   */
+  virtual void checkpoint() = 0;
+
   /**
    * @brief Will truncate table to less than maxRows by dropping
    * fragments
@@ -0,0 +1,518 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Fragmenter/InsertLog.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+
+#include "Shared/Logger.h"
+#include "Shared/checked_alloc.h"
+
+namespace Fragmenter_Namespace {
+
+namespace {
+
+/*
+ * A segment of the log is a sequence of records. A record is a 32 bytes header, made of
+ * the magic number, the record type, the table id, the epoch, the payload size, a CRC32
+ * of the rest of the header and the payload and 4 bytes of padding, followed by the
+ * payload. The payload of a batch is its row count and column count followed by the
+ * values of every column.
+ */
+constexpr uint32_t kRecordMagic{0x4f4d494c};
+constexpr size_t kChecksummedHeaderSize{24};
+constexpr size_t kHeaderSize{32};
+
+enum class RecordType : uint32_t { Batch = 1, Discard = 2 };
+
+// How the values of a column are passed in its DataBlockPtr.
+enum class ColumnKind : uint8_t { Numbers = 0, Strings = 1, Arrays = 2 };
+
+ColumnKind get_column_kind(const SQLTypeInfo& ti) {
+  if (ti.is_geometry() || (ti.is_string() && ti.get_compression() == kENCODING_NONE)) {
+    return ColumnKind::Strings;
+  }
+  return ti.is_array() ? ColumnKind::Arrays : ColumnKind::Numbers;
+}
+
+template <typename T>
+void append_value(std::string& out, const T value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void append_bytes(std::string& out, const void* bytes, const size_t size) {
+  append_value<uint64_t>(out, size);
+  if (size) {
+    out.append(static_cast<const char*>(bytes), size);
+  }
+}
+
+template <typename T>
+T read_value(const char* ptr) {
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  return value;
+}
+
+class PayloadReader {
+ public:
+  PayloadReader(const std::string& payload)
+      : ptr_(payload.data()), end_(payload.data() + payload.size()) {}
+
+  template <typename T>
+  T read() {
+    return read_value<T>(take(sizeof(T)));
+  }
+
+  const char* take(const size_t size) {
+    if (static_cast<size_t>(end_ - ptr_) < size) {
+      throw std::runtime_error("Insert log batch is truncated");
+    }
+    const auto ptr = ptr_;
+    ptr_ += size;
+    return ptr;
+  }
+
+ private:
+  const char* ptr_;
+  const char* end_;
+};
+
+uint32_t get_checksum(const char* header, const std::string& payload) {
+  boost::crc_32_type crc;
+  crc.process_bytes(header, kChecksummedHeaderSize);
+  crc.process_bytes(payload.data(), payload.size());
+  return crc.checksum();
+}
+
+std::string make_record(const RecordType type,
+                        const int table_id,
+                        const int epoch,
+                        const std::string& payload) {
+  std::string record;
+  record.reserve(kHeaderSize + payload.size());
+  append_value<uint32_t>(record, kRecordMagic);
+  append_value<uint32_t>(record, static_cast<uint32_t>(type));
+  append_value<int32_t>(record, table_id);
+  append_value<int32_t>(record, epoch);
+  append_value<uint64_t>(record, payload.size());
+  CHECK_EQ(record.size(), kChecksummedHeaderSize);
+  append_value<uint32_t>(record, get_checksum(record.data(), payload));
+  append_value<uint32_t>(record, 0);
+  CHECK_EQ(record.size(), kHeaderSize);
+  record += payload;
+  return record;
+}
+
+struct LoggedRecord {
+  RecordType type;
+  int table_id;
+  int epoch;
+  std::string payload;
+};
+
+// Reads the records of a segment up to the first torn or corrupt one, which can only be
+// the one being written when the server went down.
+void read_segment(const std::string& path, std::vector<LoggedRecord>& records) {
+  if (!boost::filesystem::exists(path)) {
+    return;
+  }
+  std::ifstream segment(path, std::ios::binary);
+  if (!segment) {
+    throw std::runtime_error("Could not open insert log segment " + path);
+  }
+  char header[kHeaderSize];
+  while (segment.read(header, kHeaderSize)) {
+    if (read_value<uint32_t>(header) != kRecordMagic) {
+      LOG(WARNING) << "Ignoring the tail of insert log segment " << path
+                   << " from a corrupt record";
+      return;
+    }
+    LoggedRecord record;
+    record.type = static_cast<RecordType>(read_value<uint32_t>(header + 4));
+    record.table_id = read_value<int32_t>(header + 8);
+    record.epoch = read_value<int32_t>(header + 12);
+    record.payload.resize(read_value<uint64_t>(header + 16));
+    if (!segment.read(&record.payload[0], record.payload.size()) ||
+        get_checksum(header, record.payload) != read_value<uint32_t>(header + 24)) {
+      LOG(WARNING) << "Ignoring the tail of insert log segment " << path
+                   << " from a torn record";
+      return;
+    }
+    records.push_back(std::move(record));
+  }
+}
+
+// A logged batch along with the buffers its InsertData points to.
+struct DecodedBatch {
+  InsertData insert_data;
+  std::vector<std::unique_ptr<int8_t[]>> numbers;
+  std::vector<std::unique_ptr<std::vector<std::string>>> strings;
+  std::vector<std::unique_ptr<std::vector<ArrayDatum>>> arrays;
+};
+
+void decode(const std::string& payload, DecodedBatch& batch) {
+  PayloadReader reader(payload);
+  auto& insert_data = batch.insert_data;
+  insert_data.numRows = reader.read<uint64_t>();
+  const auto column_count = reader.read<uint32_t>();
+  for (size_t i = 0; i < column_count; ++i) {
+    insert_data.columnIds.push_back(reader.read<int32_t>());
+    DataBlockPtr data_block;
+    const auto kind = static_cast<ColumnKind>(reader.read<uint8_t>());
+    switch (kind) {
+      case ColumnKind::Numbers: {
+        const auto size = reader.read<uint64_t>();
+        batch.numbers.emplace_back(new int8_t[size]);
+        std::memcpy(batch.numbers.back().get(), reader.take(size), size);
+        data_block.numbersPtr = batch.numbers.back().get();
+        break;
+      }
+      case ColumnKind::Strings: {
+        batch.strings.emplace_back(std::make_unique<std::vector<std::string>>());
+        auto& strings = *batch.strings.back();
+        strings.resize(reader.read<uint64_t>());
+        for (auto& str : strings) {
+          const auto size = reader.read<uint64_t>();
+          str.assign(reader.take(size), size);
+        }
+        data_block.stringsPtr = &strings;
+        break;
+      }
+      case ColumnKind::Arrays: {
+        batch.arrays.emplace_back(std::make_unique<std::vector<ArrayDatum>>());
+        auto& arrays = *batch.arrays.back();
+        const auto array_count = reader.read<uint64_t>();
+        for (size_t j = 0; j < array_count; ++j) {
+          const bool is_null = reader.read<uint8_t>();
+          const bool has_data = reader.read<uint8_t>();
+          const auto length = reader.read<uint64_t>();
+          int8_t* data{nullptr};
+          if (has_data) {
+            data = static_cast<int8_t*>(checked_malloc(length));
+            std::memcpy(data, reader.take(length), length);
+          }
+          arrays.emplace_back(length, data, is_null);
+        }
+        data_block.arraysPtr = &arrays;
+        break;
+      }
+      default:
+        throw std::runtime_error("Insert log batch has an unknown column kind");
+    }
+    insert_data.data.push_back(data_block);
+  }
+  insert_data.bypass.assign(column_count, false);
+}
+
+void sync_file(const int fd) {
+#ifdef __APPLE__
+  const int status = fcntl(fd, 51);
+#else
+  const int status = fdatasync(fd);
+#endif
+  if (status != 0) {
+    LOG(FATAL) << "Could not sync insert log to disk";
+  }
+}
+
+// Makes the creation of a segment durable.
+void sync_directory(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0 || fsync(fd) != 0) {
+    LOG(FATAL) << "Could not sync insert log directory " << path << " to disk";
+  }
+  ::close(fd);
+}
+
+}  // namespace
+
+InsertLog::InsertLog(const std::string& path,
+                     const size_t fold_interval_ms,
+                     CheckpointTables checkpoint_tables,
+                     const ReplayBatch& replay_batch)
+    : path_(path)
+    , fold_interval_ms_(fold_interval_ms)
+    , checkpoint_tables_(std::move(checkpoint_tables)) {
+  boost::filesystem::create_directories(path_);
+  // the segments left behind by the previous run
+  uint64_t last_segment{0};
+  first_segment_ = std::numeric_limits<uint64_t>::max();
+  for (const auto& entry : boost::filesystem::directory_iterator(path_)) {
+    const auto& file = entry.path();
+    if (file.extension() != ".log") {
+      continue;
+    }
+    const uint64_t segment = std::stoull(file.stem().string());
+    first_segment_ = std::min(first_segment_, segment);
+    last_segment = std::max(last_segment, segment);
+    std::vector<LoggedRecord> records;
+    read_segment(file.string(), records);
+    for (const auto& record : records) {
+      if (record.type == RecordType::Batch) {
+        dirty_tables_.insert(record.table_id);
+      }
+    }
+  }
+  if (!last_segment) {
+    first_segment_ = 1;
+  }
+  // a fresh segment keeps a torn record at the end of the last one from hiding the
+  // records appended after it
+  segment_ = last_segment + 1;
+  fd_ = openSegment(segment_);
+  replay(-1, replay_batch);
+  fold();
+  fold_thread_ = std::thread(&InsertLog::foldPeriodically, this);
+}
+
+InsertLog::~InsertLog() {
+  {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    stop_ = true;
+  }
+  stop_cv_.notify_all();
+  fold_thread_.join();
+  std::unique_lock<std::mutex> lock(mutex_);
+  closeSegment(lock);
+}
+
+std::string InsertLog::encode(const InsertData& insert_data,
+                              const std::vector<SQLTypeInfo>& column_types) {
+  CHECK_EQ(insert_data.columnIds.size(), insert_data.data.size());
+  CHECK_EQ(insert_data.columnIds.size(), column_types.size());
+  std::string batch;
+  append_value<uint64_t>(batch, insert_data.numRows);
+  append_value<uint32_t>(batch, insert_data.columnIds.size());
+  for (size_t i = 0; i < insert_data.columnIds.size(); ++i) {
+    const auto& ti = column_types[i];
+    const auto& data_block = insert_data.data[i];
+    const auto kind = get_column_kind(ti);
+    append_value<int32_t>(batch, insert_data.columnIds[i]);
+    append_value<uint8_t>(batch, static_cast<uint8_t>(kind));
+    switch (kind) {
+      case ColumnKind::Numbers:
+        append_bytes(batch, data_block.numbersPtr, insert_data.numRows * ti.get_size());
+        break;
+      case ColumnKind::Strings:
+        append_value<uint64_t>(batch, data_block.stringsPtr->size());
+        for (const auto& str : *data_block.stringsPtr) {
+          append_bytes(batch, str.data(), str.size());
+        }
+        break;
+      case ColumnKind::Arrays:
+        append_value<uint64_t>(batch, data_block.arraysPtr->size());
+        for (const auto& array : *data_block.arraysPtr) {
+          append_value<uint8_t>(batch, array.is_null);
+          append_value<uint8_t>(batch, array.pointer != nullptr);
+          append_value<uint64_t>(batch, array.length);
+          if (array.pointer) {
+            batch.append(reinterpret_cast<const char*>(array.pointer), array.length);
+          }
+        }
+        break;
+    }
+  }
+  return batch;
+}
+
+uint64_t InsertLog::append(const int table_id,
+                           const int epoch,
+                           const std::string& batch) {
+  const auto record = make_record(RecordType::Batch, table_id, epoch, batch);
+  std::lock_guard<std::mutex> lock(mutex_);
+  write(record);
+  dirty_tables_.insert(table_id);
+  return appended_position_;
+}
+
+void InsertLog::sync(const uint64_t position) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (synced_position_ < position) {
+    if (syncing_) {
+      // the fdatasync in progress may not cover the position, check again once it's done
+      sync_cv_.wait(lock);
+      continue;
+    }
+    // sync everything appended so far on behalf of all waiting inserters
+    syncing_ = true;
+    const auto target_position = appended_position_;
+    const auto fd = fd_;
+    lock.unlock();
+    sync_file(fd);
+    lock.lock();
+    syncing_ = false;
+    synced_position_ = std::max(synced_position_, target_position);
+    sync_cv_.notify_all();
+  }
+}
+
+void InsertLog::discard(const int table_id) {
+  const auto record = make_record(RecordType::Discard, table_id, 0, {});
+  uint64_t position;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write(record);
+    position = appended_position_;
+  }
+  sync(position);
+}
+
+void InsertLog::replay(const int table_id, const ReplayBatch& replay_batch) const {
+  std::vector<LoggedRecord> records;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto segment = first_segment_; segment <= segment_; ++segment) {
+      read_segment(segmentPath(segment), records);
+    }
+  }
+  std::vector<LoggedRecord> batches;
+  for (auto& record : records) {
+    if (table_id >= 0 && record.table_id != table_id) {
+      continue;
+    }
+    if (record.type == RecordType::Discard) {
+      batches.erase(std::remove_if(batches.begin(),
+                                   batches.end(),
+                                   [&record](const LoggedRecord& batch) {
+                                     return batch.table_id == record.table_id;
+                                   }),
+                    batches.end());
+    } else {
+      batches.push_back(std::move(record));
+    }
+  }
+  for (const auto& batch : batches) {
+    DecodedBatch decoded_batch;
+    decode(batch.payload, decoded_batch);
+    decoded_batch.insert_data.tableId = batch.table_id;
+    replay_batch(batch.table_id, batch.epoch, decoded_batch.insert_data);
+  }
+}
+
+void InsertLog::fold() {
+  std::lock_guard<std::mutex> fold_lock(fold_mutex_);
+  std::set<int> table_ids;
+  uint64_t first_segment;
+  uint64_t last_segment;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (first_segment_ == segment_ && !segment_size_) {
+      return;
+    }
+    // batches appended from here on go to the next segment, which isn't folded
+    const auto fd = openSegment(segment_ + 1);
+    closeSegment(lock);
+    fd_ = fd;
+    first_segment = first_segment_;
+    last_segment = segment_++;
+    segment_size_ = 0;
+    table_ids.swap(dirty_tables_);
+  }
+  try {
+    checkpoint_tables_(table_ids);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dirty_tables_.insert(table_ids.begin(), table_ids.end());
+    throw;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    first_segment_ = last_segment + 1;
+  }
+  for (auto segment = first_segment; segment <= last_segment; ++segment) {
+    boost::filesystem::remove(segmentPath(segment));
+  }
+  VLOG(1) << "Folded insert log " << path_ << " into " << table_ids.size() << " tables";
+}
+
+std::string InsertLog::segmentPath(const uint64_t segment) const {
+  return path_ + "/" + std::to_string(segment) + ".log";
+}
+
+int InsertLog::openSegment(const uint64_t segment) const {
+  const auto segment_path = segmentPath(segment);
+  const int fd = ::open(segment_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("Could not create insert log segment " + segment_path +
+                             ": " + std::strerror(errno));
+  }
+  sync_directory(path_);
+  return fd;
+}
+
+void InsertLog::closeSegment(std::unique_lock<std::mutex>& lock) {
+  sync_cv_.wait(lock, [this] { return !syncing_; });
+  if (fd_ < 0) {
+    return;
+  }
+  sync_file(fd_);
+  ::close(fd_);
+  fd_ = -1;
+  synced_position_ = appended_position_;
+  sync_cv_.notify_all();
+}
+
+void InsertLog::write(const std::string& record) {
+  size_t written{0};
+  while (written < record.size()) {
+    const auto ret = ::write(fd_, record.data() + written, record.size() - written);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      const std::string error = std::strerror(errno);
+      // drop the partial record, lest it hides the records appended after it
+      if (ftruncate(fd_, segment_size_) != 0) {
+        LOG(FATAL) << "Could not truncate insert log segment " << segmentPath(segment_);
+      }
+      throw std::runtime_error("Could not append to insert log segment " +
+                               segmentPath(segment_) + ": " + error);
+    }
+    written += ret;
+  }
+  segment_size_ += record.size();
+  appended_position_ += record.size();
+}
+
+void InsertLog::foldPeriodically() {
+  std::unique_lock<std::mutex> lock(thread_mutex_);
+  while (!stop_cv_.wait_for(lock, std::chrono::milliseconds(fold_interval_ms_), [this] {
+    return stop_;
+  })) {
+    lock.unlock();
+    try {
+      fold();
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Could not fold insert log " << path_ << ": " << e.what();
+    }
+    lock.lock();
+  }
+}
+
+}  // namespace Fragmenter_Namespace
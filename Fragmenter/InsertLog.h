@@ -0,0 +1,127 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    InsertLog.h
+ * @brief   Append-only log which makes small inserts durable without a table checkpoint.
+ *
+ * A checkpoint writes the metadata of every dirty chunk of a table and syncs all its
+ * files and its epoch file. Paying for it on every small insert dominates the cost of
+ * frequent small loads. With the insert log, an inserted batch is appended to a
+ * per-database log instead and made durable by a single sequential fdatasync. Inserters
+ * which sync concurrently share one fdatasync (group commit).
+ *
+ * Logged batches are folded into the tables in the background: the tables with logged
+ * batches are checkpointed and the log segments holding the batches are removed. At
+ * startup, and when a table is rolled back to its last checkpoint, the batches which
+ * didn't make it into a checkpoint are replayed. A batch is tagged with the epoch of its
+ * table at insertion, hence the batches already covered by a checkpoint are told apart
+ * by their epoch being older than the current epoch of the table.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Fragmenter/Fragmenter.h"
+#include "Shared/sqltypes.h"
+
+namespace Fragmenter_Namespace {
+
+class InsertLog {
+ public:
+  // Checkpoints the given physical tables.
+  using CheckpointTables = std::function<void(const std::set<int>& table_ids)>;
+  // Inserts a logged batch into a physical table, given the epoch it was logged at.
+  using ReplayBatch =
+      std::function<void(const int table_id, const int epoch, InsertData& insert_data)>;
+
+  // Opens the log kept in the directory at path, creating it if needed, replays the
+  // batches left behind by the previous run and folds them. From then on, the log is
+  // folded every fold_interval_ms milliseconds in the background.
+  InsertLog(const std::string& path,
+            const size_t fold_interval_ms,
+            CheckpointTables checkpoint_tables,
+            const ReplayBatch& replay_batch);
+
+  ~InsertLog();
+
+  // Encodes a batch for append(). Has to be called before the batch is inserted, since
+  // insertion amends it.
+  static std::string encode(const InsertData& insert_data,
+                            const std::vector<SQLTypeInfo>& column_types);
+
+  // Appends a batch inserted into a table at the given epoch of the table and returns the
+  // position of the log to sync() to make the batch durable.
+  uint64_t append(const int table_id, const int epoch, const std::string& batch);
+
+  // Returns once the log is durable up to the given position.
+  void sync(const uint64_t position);
+
+  // Drops the logged batches of a table, e.g. when it's truncated or dropped.
+  void discard(const int table_id);
+
+  // Calls replay_batch on the logged batches of the given table, or of all tables if
+  // table_id is negative, oldest first. Folding must be held off by the caller.
+  void replay(const int table_id, const ReplayBatch& replay_batch) const;
+
+  // Checkpoints the tables with logged batches and removes the folded log segments.
+  void fold();
+
+  // Holds off folding, e.g. while a table is rolled back and its batches are replayed.
+  std::unique_lock<std::mutex> holdFolding() {
+    return std::unique_lock<std::mutex>(fold_mutex_);
+  }
+
+ private:
+  std::string segmentPath(const uint64_t segment) const;
+  int openSegment(const uint64_t segment) const;
+  void closeSegment(std::unique_lock<std::mutex>& lock);
+  void write(const std::string& record);
+  void foldPeriodically();
+
+  const std::string path_;
+  const size_t fold_interval_ms_;
+  const CheckpointTables checkpoint_tables_;
+
+  mutable std::mutex mutex_;  // protects the members below, up to fold_mutex_
+  std::condition_variable sync_cv_;
+  int fd_{-1};
+  uint64_t segment_{0};            // the segment appended to
+  uint64_t first_segment_{0};      // the oldest segment which hasn't been folded yet
+  uint64_t segment_size_{0};       // bytes appended to the segment
+  uint64_t appended_position_{0};  // bytes appended since the log was opened
+  uint64_t synced_position_{0};    // bytes known to be durable
+  bool syncing_{false};            // whether an fdatasync is in progress
+  std::set<int> dirty_tables_;     // tables with batches in unfolded segments
+
+  std::mutex fold_mutex_;  // serializes folding, replaying and rolling back
+
+  std::mutex thread_mutex_;
+  std::condition_variable stop_cv_;
+  bool stop_{false};
+  std::thread fold_thread_;
+};
+
+}  // namespace Fragmenter_Namespace
@@ -28,6 +28,7 @@
 
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/DataMgr.h"
+#include "Fragmenter/InsertLog.h"
 #include "LockMgr/LockMgr.h"
 #include "Shared/Logger.h"
 #include "Shared/checked_alloc.h"
@@ -360,19 +361,50 @@ FragmentInfo* InsertOrderFragmenter::getFragmentInfo(const int fragment_id) cons
 }
 
 void InsertOrderFragmenter::insertData(InsertData& insertDataStruct) {
+  // the batches replicating a new column (ALTER TABLE ADD COLUMN) aren't logged
+  auto insert_log = defaultInsertLevel_ == Data_Namespace::DISK_LEVEL &&
+                            insertDataStruct.replicate_count == 0
+                        ? catalog_->getInsertLog()
+                        : nullptr;
   // TODO: this local lock will need to be centralized when ALTER COLUMN is added, bc
   try {
-    mapd_unique_lock<mapd_shared_mutex> insertLock(
-        insertMutex_);  // prevent two threads from trying to insert into the same table
-                        // simultaneously
-
-    insertDataImpl(insertDataStruct);
+    uint64_t log_position{0};
+    {
+      std::string batch;
+      if (insert_log) {
+        // encode ahead of insertion, which amends the batch
+        std::vector<SQLTypeInfo> column_types;
+        for (const auto columnId : insertDataStruct.columnIds) {
+          const auto columnDesc =
+              catalog_->getMetadataForColumn(physicalTableId_, columnId);
+          CHECK(columnDesc);
+          column_types.push_back(columnDesc->columnType);
+        }
+        batch = InsertLog::encode(insertDataStruct, column_types);
+      }
 
-    if (defaultInsertLevel_ ==
-        Data_Namespace::DISK_LEVEL) {  // only checkpoint if data is resident on disk
-      dataMgr_->checkpoint(
-          chunkKeyPrefix_[0],
-          chunkKeyPrefix_[1]);  // need to checkpoint here to remove window for corruption
+      mapd_unique_lock<mapd_shared_mutex> insertLock(
+          insertMutex_);  // prevent two threads from trying to insert into the same table
+                          // simultaneously
+
+      insertDataImpl(insertDataStruct);
+
+      if (insert_log) {
+        // the log makes the batch durable, the table is checkpointed when the log is
+        // folded
+        log_position = insert_log->append(
+            physicalTableId_,
+            dataMgr_->getTableEpoch(chunkKeyPrefix_[0], chunkKeyPrefix_[1]),
+            batch);
+      } else if (defaultInsertLevel_ == Data_Namespace::DISK_LEVEL) {
+        // only checkpoint if data is resident on disk, need to checkpoint here to remove
+        // window for corruption
+        dataMgr_->checkpoint(chunkKeyPrefix_[0], chunkKeyPrefix_[1]);
+      }
+    }
+    if (log_position) {
+      // wait outside of the insert lock, such that concurrent inserts share an fdatasync
+      insert_log->sync(log_position);
     }
   } catch (...) {
     int32_t tableEpoch =
@@ -395,6 +427,13 @@ void InsertOrderFragmenter::insertDataNoCheckpoint(InsertData& insertDataStruct)
   insertDataImpl(insertDataStruct);
 }
 
+void InsertOrderFragmenter::checkpoint() {
+  mapd_unique_lock<mapd_shared_mutex> insertLock(insertMutex_);
+  if (defaultInsertLevel_ == Data_Namespace::DISK_LEVEL) {
+    dataMgr_->checkpoint(chunkKeyPrefix_[0], chunkKeyPrefix_[1]);
+  }
+}
+
 void InsertOrderFragmenter::replicateData(const InsertData& insertDataStruct) {
   // synchronize concurrent accesses to fragmentInfoVec_
   mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
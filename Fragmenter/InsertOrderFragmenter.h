@@ -88,6 +88,8 @@ class InsertOrderFragmenter : public AbstractFragmenter {
 
   void insertDataNoCheckpoint(InsertData& insertDataStruct) override;
 
+  void checkpoint() override;
+
   void dropFragmentsToSize(const size_t maxRows) override;
 
   void updateChunkStats(
@@ -1236,6 +1236,13 @@ void InsertOrderFragmenter::compactRows(const Catalog_Namespace::Catalog* catalo
       auto daddr = data_addr;
       auto element_size =
           col_type.is_fixlen_array() ? col_type.get_size() : get_element_size(col_type);
+      if (col_type.is_fixlen_array()) {
+        // every kept row is passed through below, which recomputes the bounding box
+        auto encoder =
+            dynamic_cast<FixedLengthArrayNoneEncoder*>(data_buffer->encoder.get());
+        CHECK(encoder);
+        encoder->resetBoundingBox();
+      }
       for (size_t irow = 0; irow < nrows_to_keep; ++irow, daddr += element_size) {
         if (col_type.is_fixlen_array()) {
           auto encoder =
@@ -1244,13 +1251,13 @@ void InsertOrderFragmenter::compactRows(const Catalog_Namespace::Catalog* catalo
           encoder->updateMetadata((int8_t*)daddr);
         } else if (col_type.is_fp()) {
           set_chunk_stats(col_type,
-                          data_addr,
+                          daddr,
                           has_null_per_thread[ci],
                           min_double_per_thread[ci],
                           max_double_per_thread[ci]);
         } else {
           set_chunk_stats(col_type,
-                          data_addr,
+                          daddr,
                           has_null_per_thread[ci],
                           min_int64t_per_thread[ci],
                           max_int64t_per_thread[ci]);
@@ -1308,14 +1315,14 @@ void InsertOrderFragmenter::compactRows(const Catalog_Namespace::Catalog* catalo
 
 }  // namespace Fragmenter_Namespace
 
-void UpdelRoll::commitUpdate() {
+void UpdelRoll::commitUpdate(const bool checkpoint) {
   if (nullptr == catalog) {
     return;
   }
   const auto td = catalog->getMetadataForTable(logicalTableId);
   CHECK(td);
   // checkpoint all shards regardless, or epoch becomes out of sync
-  if (td->persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL) {
+  if (checkpoint && td->persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL) {
     catalog->checkpoint(logicalTableId);
   }
   // for each dirty fragment
@@ -477,18 +477,23 @@ void TypedImportBuffer::addDictEncodedString(const std::vector<std::string>& str
     }
     string_view_vec.push_back(str);
   }
+  // the ids of the rows added by id come first
+  const auto offset = dict_encoded_count_;
   switch (column_desc_->columnType.get_size()) {
     case 1:
-      string_dict_i8_buffer_->resize(string_view_vec.size());
-      string_dict_->getOrAddBulk(string_view_vec, string_dict_i8_buffer_->data());
+      string_dict_i8_buffer_->resize(offset + string_view_vec.size());
+      string_dict_->getOrAddBulk(string_view_vec,
+                                 string_dict_i8_buffer_->data() + offset);
       break;
     case 2:
-      string_dict_i16_buffer_->resize(string_view_vec.size());
-      string_dict_->getOrAddBulk(string_view_vec, string_dict_i16_buffer_->data());
+      string_dict_i16_buffer_->resize(offset + string_view_vec.size());
+      string_dict_->getOrAddBulk(string_view_vec,
+                                 string_dict_i16_buffer_->data() + offset);
       break;
     case 4:
-      string_dict_i32_buffer_->resize(string_view_vec.size());
-      string_dict_->getOrAddBulk(string_view_vec, string_dict_i32_buffer_->data());
+      string_dict_i32_buffer_->resize(offset + string_view_vec.size());
+      string_dict_->getOrAddBulk(string_view_vec,
+                                 string_dict_i32_buffer_->data() + offset);
       break;
     default:
       CHECK(false);
@@ -845,6 +850,194 @@ size_t TypedImportBuffer::convert_arrow_val_to_import_buffer(
   return buffer.size();
 }
 
+// copies a slice of fixed width Arrow values (RHS) of the same representation as the
+// TypedImportBuffer (LHS) at once, then overwrites the null values
+template <typename ARROW_TYPE, typename DATA_TYPE>
+size_t TypedImportBuffer::copy_arrow_values_to_import_buffer(
+    const ColumnDescriptor* cd,
+    const Array& array,
+    std::vector<DATA_TYPE>& buffer,
+    const ArraySliceRange& slice_range,
+    Importer_NS::BadRowsTracker* const bad_rows_tracker) {
+  static_assert(sizeof(typename ARROW_TYPE::c_type) == sizeof(DATA_TYPE),
+                "Arrow values differ in width");
+  const auto& numeric_array = static_cast<const NumericArray<ARROW_TYPE>&>(array);
+  const auto values = numeric_array.raw_values() + slice_range.first;
+  const auto offset = buffer.size();
+  const auto count = slice_range.second - slice_range.first;
+  if (std::is_integral<DATA_TYPE>::value && sizeof(DATA_TYPE) < sizeof(int64_t)) {
+    // as in ArrowValue<int64_t>, the null sentinel isn't a valid narrow integer; leave
+    // reporting it to the conversion of every value
+    for (size_t i = 0; i < count; ++i) {
+      if (values[i] == std::numeric_limits<DATA_TYPE>::lowest() &&
+          !array.IsNull(slice_range.first + i)) {
+        return convert_arrow_val_to_import_buffer(
+            cd, array, buffer, slice_range, bad_rows_tracker);
+      }
+    }
+  }
+  buffer.resize(offset + count);
+  memcpy(buffer.data() + offset, values, count * sizeof(DATA_TYPE));
+  if (array.null_count()) {
+    const DATA_TYPE null_value =
+        std::is_floating_point<DATA_TYPE>::value
+            ? static_cast<DATA_TYPE>(inline_fp_null_val(cd->columnType))
+            : static_cast<DATA_TYPE>(inline_fixed_encoding_null_val(cd->columnType));
+    for (size_t i = 0; i < count; ++i) {
+      if (array.IsNull(slice_range.first + i)) {
+        buffer[offset + i] = null_value;
+      }
+    }
+  }
+  return buffer.size();
+}
+
+namespace {
+
+// the unit of the Arrow timestamps stored as is in a timestamp column
+TimeUnit::type timestamp_unit(const SQLTypeInfo& ti) {
+  switch (ti.get_dimension()) {
+    case 3:
+      return TimeUnit::MILLI;
+    case 6:
+      return TimeUnit::MICRO;
+    case 9:
+      return TimeUnit::NANO;
+    default:
+      return TimeUnit::SECOND;
+  }
+}
+
+template <typename ARROW_TYPE>
+void get_arrow_dictionary_indices(const Array& array,
+                                  const ArraySliceRange& slice_range,
+                                  const int64_t dictionary_size,
+                                  std::vector<int64_t>& indices) {
+  const auto& index_array = static_cast<const NumericArray<ARROW_TYPE>&>(array);
+  for (size_t row = slice_range.first; row < slice_range.second; ++row) {
+    if (index_array.IsNull(row)) {
+      // past the dictionary values, stands for the null string
+      indices.push_back(dictionary_size);
+    } else {
+      const int64_t index = index_array.Value(row);
+      if (index < 0 || index >= dictionary_size) {
+        arrow_throw_if(true, "Arrow dictionary index out of range");
+      }
+      indices.push_back(index);
+    }
+  }
+}
+
+template <typename T>
+void encode_arrow_dictionary(StringDictionary* string_dict,
+                             const std::vector<std::string_view>& dictionary_strings,
+                             const std::vector<int64_t>& indices,
+                             std::vector<T>& ids) {
+  std::vector<T> dictionary_ids(dictionary_strings.size());
+  string_dict->getOrAddBulk(dictionary_strings, dictionary_ids.data());
+  const auto offset = ids.size();
+  ids.resize(offset + indices.size());
+  for (size_t i = 0; i < indices.size(); ++i) {
+    ids[offset + i] = dictionary_ids[indices[i]];
+  }
+}
+
+}  // namespace
+
+// appends a slice of a dictionary encoded Arrow array of strings (RHS) to
+// TypedImportBuffer (LHS). The dictionary values, rather than the rows, are looked up
+// in the string dictionary of the column.
+size_t TypedImportBuffer::convert_arrow_dictionary_to_import_buffer(
+    const ColumnDescriptor* cd,
+    const Array& array,
+    const ArraySliceRange& slice_range) {
+  const auto& dict_array = static_cast<const DictionaryArray&>(array);
+  const auto& dictionary = *dict_array.dictionary();
+  arrow_throw_if(dictionary.type_id() != Type::BINARY &&
+                     dictionary.type_id() != Type::STRING,
+                 "Expected dictionary of strings");
+  const auto& dictionary_values = static_cast<const BinaryArray&>(dictionary);
+  // the empty string past the dictionary values encodes to null
+  std::vector<std::string_view> dictionary_strings(dictionary.length() + 1);
+  for (int64_t i = 0; i < dictionary.length(); ++i) {
+    if (!dictionary.IsNull(i)) {
+      int32_t length;
+      const auto value = dictionary_values.GetValue(i, &length);
+      dictionary_strings[i] = {reinterpret_cast<const char*>(value),
+                               static_cast<size_t>(length)};
+    }
+  }
+
+  const auto& index_array = *dict_array.indices();
+  std::vector<int64_t> indices;
+  indices.reserve(slice_range.second - slice_range.first);
+  switch (index_array.type_id()) {
+    case Type::INT8:
+      get_arrow_dictionary_indices<Int8Type>(
+          index_array, slice_range, dictionary.length(), indices);
+      break;
+    case Type::INT16:
+      get_arrow_dictionary_indices<Int16Type>(
+          index_array, slice_range, dictionary.length(), indices);
+      break;
+    case Type::INT32:
+      get_arrow_dictionary_indices<Int32Type>(
+          index_array, slice_range, dictionary.length(), indices);
+      break;
+    case Type::INT64:
+      get_arrow_dictionary_indices<Int64Type>(
+          index_array, slice_range, dictionary.length(), indices);
+      break;
+    default:
+      arrow_throw_if(true, "Expected integer dictionary indices");
+  }
+
+  // rows already added as strings have to be followed by strings
+  if (cd->columnType.get_compression() != kENCODING_DICT || !string_buffer_->empty()) {
+    string_buffer_->reserve(string_buffer_->size() + indices.size());
+    for (const auto index : indices) {
+      string_buffer_->emplace_back(dictionary_strings[index]);
+    }
+    return dict_encoded_count_ + string_buffer_->size();
+  }
+  // Only the dictionary values the slice references are encoded, a large Arrow dictionary
+  // is shared by all the batches of a stream. The indices are renumbered to the
+  // referenced values.
+  std::vector<int64_t> referenced_positions(dictionary_strings.size(), -1);
+  std::vector<std::string_view> referenced_strings;
+  for (auto& index : indices) {
+    auto& position = referenced_positions[index];
+    if (position < 0) {
+      const auto& str = dictionary_strings[index];
+      if (str.size() > StringDictionary::MAX_STRLEN) {
+        throw std::runtime_error("String too long for dictionary encoding.");
+      }
+      position = referenced_strings.size();
+      referenced_strings.push_back(str);
+    }
+    index = position;
+  }
+  CHECK(string_dict_);
+  switch (cd->columnType.get_size()) {
+    case 1:
+      encode_arrow_dictionary(
+          string_dict_, referenced_strings, indices, *string_dict_i8_buffer_);
+      break;
+    case 2:
+      encode_arrow_dictionary(
+          string_dict_, referenced_strings, indices, *string_dict_i16_buffer_);
+      break;
+    case 4:
+      encode_arrow_dictionary(
+          string_dict_, referenced_strings, indices, *string_dict_i32_buffer_);
+      break;
+    default:
+      CHECK(false);
+  }
+  dict_encoded_count_ += indices.size();
+  return dict_encoded_count_;
+}
+
 size_t TypedImportBuffer::add_arrow_values(const ColumnDescriptor* cd,
                                            const Array& col,
                                            const bool exact_type_match,
@@ -868,41 +1061,68 @@ size_t TypedImportBuffer::add_arrow_values(const ColumnDescriptor* cd,
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::INT8, "Expected int8 type");
       }
+      if (col.type_id() == Type::INT8) {
+        return copy_arrow_values_to_import_buffer<Int8Type>(
+            cd, col, *tinyint_buffer_, slice_range, bad_rows_tracker);
+      }
       return convert_arrow_val_to_import_buffer(
           cd, col, *tinyint_buffer_, slice_range, bad_rows_tracker);
     case kSMALLINT:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::INT16, "Expected int16 type");
       }
+      if (col.type_id() == Type::INT16) {
+        return copy_arrow_values_to_import_buffer<Int16Type>(
+            cd, col, *smallint_buffer_, slice_range, bad_rows_tracker);
+      }
       return convert_arrow_val_to_import_buffer(
           cd, col, *smallint_buffer_, slice_range, bad_rows_tracker);
     case kINT:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::INT32, "Expected int32 type");
       }
+      if (col.type_id() == Type::INT32) {
+        return copy_arrow_values_to_import_buffer<Int32Type>(
+            cd, col, *int_buffer_, slice_range, bad_rows_tracker);
+      }
       return convert_arrow_val_to_import_buffer(
           cd, col, *int_buffer_, slice_range, bad_rows_tracker);
     case kBIGINT:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::INT64, "Expected int64 type");
       }
+      if (col.type_id() == Type::INT64) {
+        return copy_arrow_values_to_import_buffer<Int64Type>(
+            cd, col, *bigint_buffer_, slice_range, bad_rows_tracker);
+      }
       return convert_arrow_val_to_import_buffer(
           cd, col, *bigint_buffer_, slice_range, bad_rows_tracker);
     case kFLOAT:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::FLOAT, "Expected float type");
       }
+      if (col.type_id() == Type::FLOAT) {
+        return copy_arrow_values_to_import_buffer<FloatType>(
+            cd, col, *float_buffer_, slice_range, bad_rows_tracker);
+      }
       return convert_arrow_val_to_import_buffer(
           cd, col, *float_buffer_, slice_range, bad_rows_tracker);
     case kDOUBLE:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::DOUBLE, "Expected double type");
       }
+      if (col.type_id() == Type::DOUBLE) {
+        return copy_arrow_values_to_import_buffer<DoubleType>(
+            cd, col, *double_buffer_, slice_range, bad_rows_tracker);
+      }
       return convert_arrow_val_to_import_buffer(
           cd, col, *double_buffer_, slice_range, bad_rows_tracker);
     case kTEXT:
     case kVARCHAR:
     case kCHAR:
+      if (col.type_id() == Type::DICTIONARY) {
+        return convert_arrow_dictionary_to_import_buffer(cd, col, slice_range);
+      }
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::BINARY && col.type_id() != Type::STRING,
                        "Expected string type");
@@ -920,6 +1140,12 @@ size_t TypedImportBuffer::add_arrow_values(const ColumnDescriptor* cd,
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::TIMESTAMP, "Expected timestamp type");
       }
+      if (col.type_id() == Type::TIMESTAMP &&
+          static_cast<const TimestampType&>(*col.type()).unit() ==
+              timestamp_unit(cd->columnType)) {
+        return copy_arrow_values_to_import_buffer<TimestampType>(
+            cd, col, *bigint_buffer_, slice_range, bad_rows_tracker);
+      }
       return convert_arrow_val_to_import_buffer(
           cd, col, *bigint_buffer_, slice_range, bad_rows_tracker);
     case kDATE:
@@ -2595,9 +2821,16 @@ void Loader::distributeToShards(std::vector<OneShardBuffers>& all_shard_import_b
         case kTEXT:
         case kVARCHAR:
         case kCHAR: {
-          CHECK_LT(row_index, input_buffer->getStringBuffer()->size());
+          const auto dict_encoded_count = input_buffer->getDictEncodedCount();
+          if (row_index < dict_encoded_count) {
+            shard_output_buffers[col_idx]->addDictEncodedId(
+                int_value_at(*input_buffer, row_index));
+            break;
+          }
+          CHECK_LT(row_index - dict_encoded_count,
+                   input_buffer->getStringBuffer()->size());
           shard_output_buffers[col_idx]->addString(
-              (*input_buffer->getStringBuffer())[row_index]);
+              (*input_buffer->getStringBuffer())[row_index - dict_encoded_count]);
           break;
         }
         case kTIME:
@@ -249,8 +249,31 @@ class TypedImportBuffer : boost::noncopyable {
     string_array_buffer_->push_back(arr);
   }
 
+  // Encodes the strings of the rows following the ones added by addDictEncodedId().
   void addDictEncodedString(const std::vector<std::string>& string_vec);
 
+  // Adds a row by its string id, ahead of any row added as a string.
+  void addDictEncodedId(const int64_t id) {
+    CHECK(string_buffer_->empty());
+    switch (column_desc_->columnType.get_size()) {
+      case 1:
+        string_dict_i8_buffer_->push_back(id);
+        break;
+      case 2:
+        string_dict_i16_buffer_->push_back(id);
+        break;
+      case 4:
+        string_dict_i32_buffer_->push_back(id);
+        break;
+      default:
+        CHECK(false);
+    }
+    ++dict_encoded_count_;
+  }
+
+  // Number of rows added by their string id, which precede the rows in the string buffer.
+  size_t getDictEncodedCount() const { return dict_encoded_count_; }
+
   void addDictEncodedStringArray(
       const std::vector<std::vector<std::string>>& string_array_vec) {
     CHECK(string_dict_);
@@ -407,6 +430,7 @@ class TypedImportBuffer : boost::noncopyable {
       case kVARCHAR:
       case kCHAR: {
         string_buffer_->clear();
+        dict_encoded_count_ = 0;
         if (column_desc_->columnType.get_compression() == kENCODING_DICT) {
           switch (column_desc_->columnType.get_size()) {
             case 1:
@@ -480,6 +504,15 @@ class TypedImportBuffer : boost::noncopyable {
                                             std::vector<DATA_TYPE>& buffer,
                                             const ArraySliceRange& slice_range,
                                             BadRowsTracker* const bad_rows_tracker);
+  template <typename ARROW_TYPE, typename DATA_TYPE>
+  size_t copy_arrow_values_to_import_buffer(const ColumnDescriptor* cd,
+                                            const arrow::Array& array,
+                                            std::vector<DATA_TYPE>& buffer,
+                                            const ArraySliceRange& slice_range,
+                                            BadRowsTracker* const bad_rows_tracker);
+  size_t convert_arrow_dictionary_to_import_buffer(const ColumnDescriptor* cd,
+                                                   const arrow::Array& array,
+                                                   const ArraySliceRange& slice_range);
   template <typename DATA_TYPE>
   auto del_values(std::vector<DATA_TYPE>& buffer, BadRowsTracker* const bad_rows_tracker);
   auto del_values(const SQLTypes type, BadRowsTracker* const bad_rows_tracker);
@@ -509,6 +542,7 @@ class TypedImportBuffer : boost::noncopyable {
   const ColumnDescriptor* column_desc_;
   StringDictionary* string_dict_;
   size_t replicate_count_ = 0;
+  size_t dict_encoded_count_ = 0;
 };
 
 class Loader {
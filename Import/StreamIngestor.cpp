@@ -0,0 +1,491 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Import/StreamIngestor.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+#include <boost/filesystem.hpp>
+
+#include "Import/DelimitedParserUtils.h"
+#include "Shared/Logger.h"
+#include "Shared/geo_types.h"
+
+namespace Importer_NS {
+
+namespace {
+
+// How long the ingestion thread waits for a row before it checks whether to stop.
+constexpr std::chrono::milliseconds kPollInterval{100};
+// How long a file at its end is left alone before it's read again.
+constexpr std::chrono::milliseconds kTailInterval{50};
+constexpr size_t kReadSize{1 << 16};
+constexpr bool kPromotePolygonToMultipolygon{true};
+// Committed offsets kept, such that a table rolled back a few epochs resumes from the
+// offset committed at the epoch it was rolled back to.
+constexpr size_t kOffsetHistorySize{1024};
+
+void sync_directory(const std::string& path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(FATAL) << "Failed to open directory " << path << ": " << strerror(errno);
+  }
+  if (fsync(fd)) {
+    LOG(FATAL) << "Failed to sync directory " << path << ": " << strerror(errno);
+  }
+  close(fd);
+}
+
+}  // namespace
+
+FileStreamSource::FileStreamSource(const std::string& path, const char line_delim)
+    : path_(path), line_delim_(line_delim) {
+  // non blocking, such that opening a named pipe doesn't wait for a writer
+  fd_ = open(path.c_str(), O_RDONLY | O_NONBLOCK);
+  if (fd_ < 0) {
+    throw std::runtime_error("Failed to open stream source " + path + ": " +
+                             strerror(errno));
+  }
+  struct stat st;
+  if (fstat(fd_, &st) || (!S_ISREG(st.st_mode) && !S_ISFIFO(st.st_mode))) {
+    close(fd_);
+    throw std::runtime_error("Stream source " + path +
+                             " is neither a file nor a named pipe");
+  }
+  is_fifo_ = S_ISFIFO(st.st_mode);
+}
+
+FileStreamSource::~FileStreamSource() {
+  close(fd_);
+}
+
+void FileStreamSource::seek(const int64_t offset) {
+  buffer_.clear();
+  scanned_size_ = 0;
+  offset_ = offset;
+  if (!is_fifo_ && lseek(fd_, offset, SEEK_SET) < 0) {
+    throw std::runtime_error("Failed to seek stream source " + path_ + ": " +
+                             strerror(errno));
+  }
+}
+
+bool FileStreamSource::next(std::string& row,
+                            int64_t& offset,
+                            const std::chrono::milliseconds timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (true) {
+    const auto delim_pos = buffer_.find(line_delim_, scanned_size_);
+    if (delim_pos != std::string::npos) {
+      row.assign(buffer_, 0, delim_pos + 1);
+      buffer_.erase(0, delim_pos + 1);
+      scanned_size_ = 0;
+      offset_ += delim_pos + 1;
+      offset = offset_;
+      return true;
+    }
+    scanned_size_ = buffer_.size();
+    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    if (left.count() <= 0) {
+      return false;
+    }
+    read(left);
+  }
+}
+
+bool FileStreamSource::read(const std::chrono::milliseconds timeout) {
+  if (is_fifo_) {
+    struct pollfd pfd {
+      fd_, POLLIN, 0
+    };
+    if (poll(&pfd, 1, timeout.count()) <= 0) {
+      return false;
+    }
+  }
+  char buf[kReadSize];
+  const auto read_size = ::read(fd_, buf, sizeof(buf));
+  if (read_size < 0) {
+    if (errno == EAGAIN || errno == EINTR) {
+      return false;
+    }
+    throw std::runtime_error("Failed to read stream source " + path_ + ": " +
+                             strerror(errno));
+  }
+  if (read_size == 0) {
+    // at the end of the file, or a named pipe without writers: wait for more
+    std::this_thread::sleep_for(std::min(timeout, kTailInterval));
+    return false;
+  }
+  buffer_.append(buf, read_size);
+  return true;
+}
+
+StreamIngestor::StreamIngestor(std::shared_ptr<Catalog_Namespace::Catalog> catalog,
+                               const std::string& table_name,
+                               std::unique_ptr<StreamSource> source,
+                               const StreamIngestionParams& params)
+    : catalog_(catalog)
+    , table_name_(table_name)
+    , source_(std::move(source))
+    , params_(params) {
+  CHECK(catalog_);
+  CHECK(source_);
+  {
+    const auto table_lock =
+        lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+            *catalog_, table_name_);
+    const auto td = table_lock();
+    CHECK(td);
+    if (td->isView) {
+      throw std::runtime_error("Cannot ingest a stream into view " + table_name_);
+    }
+    offsets_path_ = catalog_->getStreamOffsetsPath(td->tableId);
+    boost::filesystem::create_directories(
+        boost::filesystem::path(offsets_path_).parent_path());
+    offsets_ = readOffsets();
+    committed_ = getResumeOffset(
+        catalog_->getTableEpoch(catalog_->getCurrentDB().dbId, td->tableId));
+  }
+  source_->seek(committed_.offset);
+  batch_offset_ = committed_.offset;
+  status_.running = true;
+  status_.committed_offset = committed_.offset;
+  thread_ = std::thread(&StreamIngestor::run, this);
+}
+
+StreamIngestor::~StreamIngestor() {
+  stop();
+}
+
+void StreamIngestor::stop() {
+  {
+    std::lock_guard<std::mutex> lock(status_mutex_);
+    stop_ = true;
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+StreamIngestionStatus StreamIngestor::getStatus() const {
+  std::lock_guard<std::mutex> lock(status_mutex_);
+  return status_;
+}
+
+void StreamIngestor::run() {
+  try {
+    std::string row;
+    int64_t offset;
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(status_mutex_);
+        if (stop_) {
+          break;
+        }
+      }
+      auto timeout = kPollInterval;
+      if (!batch_rows_.empty()) {
+        const auto flush_left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            batch_start_ + params_.flush_interval - std::chrono::steady_clock::now());
+        timeout = std::max(std::min(timeout, flush_left), std::chrono::milliseconds(0));
+      }
+      if (source_->next(row, offset, timeout)) {
+        if (batch_rows_.empty()) {
+          batch_start_ = std::chrono::steady_clock::now();
+        }
+        batch_rows_.push_back(std::move(row));
+        batch_offset_ = offset;
+      }
+      if (!batch_rows_.empty() && (batch_rows_.size() >= params_.flush_row_count ||
+                                   std::chrono::steady_clock::now() - batch_start_ >=
+                                       params_.flush_interval)) {
+        flush();
+      }
+    }
+    if (!batch_rows_.empty()) {
+      flush();
+    }
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Stream ingestion into table " << table_name_
+               << " failed: " << e.what();
+    closeBatch();
+    std::lock_guard<std::mutex> lock(status_mutex_);
+    status_.error = e.what();
+  }
+  std::lock_guard<std::mutex> lock(status_mutex_);
+  status_.running = false;
+}
+
+void StreamIngestor::openBatch() {
+  table_lock_ = std::make_unique<lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>>(
+      lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+          *catalog_, table_name_));
+  const auto td = (*table_lock_)();
+  if (!td) {
+    throw std::runtime_error("Table " + table_name_ + " no longer exists");
+  }
+  loader_ = std::make_unique<Loader>(*catalog_, td);
+  import_buffers_ = setup_column_loaders(td, loader_.get());
+  const auto& col_descs = loader_->get_column_descs();
+  is_array_.reset(new bool[col_descs.size()]);
+  column_count_ = 0;
+  for (const auto cd : col_descs) {
+    if (!cd->isGeoPhyCol) {
+      is_array_[column_count_++] = cd->columnType.get_type() == kARRAY;
+    }
+  }
+  batch_row_count_ = 0;
+}
+
+void StreamIngestor::addRow(const std::string& row) {
+  const auto& copy_params = params_.copy_params;
+  std::vector<std::string_view> fields;
+  std::vector<std::unique_ptr<char[]>> tmp_buffers;
+  bool try_single_thread{false};
+  delimited_parser::get_row(row.data(),
+                            row.data() + row.size(),
+                            row.data() + row.size(),
+                            copy_params,
+                            is_array_.get(),
+                            fields,
+                            tmp_buffers,
+                            try_single_thread);
+  const auto reject = [this](const std::string& reason) {
+    LOG(ERROR) << "Stream ingestion into table " << table_name_
+               << " rejected a row: " << reason;
+    std::lock_guard<std::mutex> lock(status_mutex_);
+    ++status_.rows_rejected;
+  };
+  if (fields.size() != column_count_) {
+    reject("expected " + std::to_string(column_count_) + " fields, got " +
+           std::to_string(fields.size()));
+    return;
+  }
+
+  size_t field_idx = 0;
+  size_t col_idx = 0;
+  try {
+    const auto& col_descs = loader_->get_column_descs();
+    for (auto cd_it = col_descs.begin(); cd_it != col_descs.end(); ++cd_it) {
+      const auto cd = *cd_it;
+      const auto& col_ti = cd->columnType;
+      const auto& field = fields[field_idx++];
+      const bool is_null = field == copy_params.null_str || field == "NULL" ||
+                           (!col_ti.is_string() && field.empty());
+      if (col_ti.get_physical_cols() == 0) {
+        import_buffers_[col_idx++]->add_value(cd, field, is_null, copy_params);
+        continue;
+      }
+      // geo: the base column holds a null string, the physical columns the geometry
+      import_buffers_[col_idx++]->add_value(cd, copy_params.null_str, true, copy_params);
+      std::vector<double> coords;
+      std::vector<double> bounds;
+      std::vector<int> ring_sizes;
+      std::vector<int> poly_rings;
+      SQLTypeInfo import_ti{col_ti};
+      if (is_null) {
+        if (col_ti.get_notnull()) {
+          throw std::runtime_error("NULL geo for column " + cd->columnName);
+        }
+        Geo_namespace::GeoTypesFactory::getNullGeoColumns(import_ti,
+                                                          coords,
+                                                          bounds,
+                                                          ring_sizes,
+                                                          poly_rings,
+                                                          kPromotePolygonToMultipolygon);
+      } else {
+        if (!Geo_namespace::GeoTypesFactory::getGeoColumns(
+                std::string(field),
+                import_ti,
+                coords,
+                bounds,
+                ring_sizes,
+                poly_rings,
+                kPromotePolygonToMultipolygon)) {
+          throw std::runtime_error("Failed to extract valid geometry for column " +
+                                   cd->columnName);
+        }
+        if (col_ti.get_type() != import_ti.get_type() &&
+            !(import_ti.get_type() == kPOLYGON && col_ti.get_type() == kMULTIPOLYGON)) {
+          throw std::runtime_error("Imported geometry doesn't match the type of column " +
+                                   cd->columnName);
+        }
+      }
+      Importer::set_geo_physical_import_buffer(*catalog_,
+                                               cd,
+                                               import_buffers_,
+                                               col_idx,
+                                               coords,
+                                               bounds,
+                                               ring_sizes,
+                                               poly_rings,
+                                               0);
+      // skip the physical columns
+      std::advance(cd_it, col_ti.get_physical_cols());
+    }
+  } catch (const std::exception& e) {
+    // take back the values of the row added so far
+    for (size_t i = 0; i < col_idx; ++i) {
+      import_buffers_[i]->pop_value();
+    }
+    reject(e.what());
+    return;
+  }
+  ++batch_row_count_;
+}
+
+// The table schema read lock is only held while a batch is flushed, such that DDL on the
+// table isn't blocked while rows are buffered.
+void StreamIngestor::flush() {
+  CHECK(!batch_rows_.empty());
+  try {
+    openBatch();
+    for (const auto& row : batch_rows_) {
+      addRow(row);
+    }
+    if (batch_row_count_) {
+      const auto insert_data_lock =
+          lockmgr::InsertDataLockMgr::getWriteLockForTable(*catalog_, table_name_);
+      const auto start_epoch = loader_->getTableEpoch();
+      bool loaded = false;
+      try {
+        loaded = loader_->loadNoCheckpoint(import_buffers_, batch_row_count_);
+        if (loaded) {
+          for (auto& buffer : import_buffers_) {
+            if (!buffer->stringDictCheckpoint()) {
+              loaded = false;
+            }
+          }
+        }
+      } catch (...) {
+        loader_->setTableEpoch(start_epoch);
+        throw;
+      }
+      if (!loaded) {
+        loader_->setTableEpoch(start_epoch);
+        throw std::runtime_error("Failed to load a batch into table " + table_name_);
+      }
+      loader_->checkpoint();
+      // record the epoch the checkpoint actually moved the table to, while no other
+      // writer can move it further
+      const CommittedOffset committed{loader_->getTableEpoch(), batch_offset_};
+      offsets_.push_back(committed);
+      if (offsets_.size() > kOffsetHistorySize) {
+        offsets_.pop_front();
+      }
+      writeOffsets();
+      committed_ = committed;
+      std::lock_guard<std::mutex> lock(status_mutex_);
+      status_.rows_loaded += batch_row_count_;
+      status_.committed_offset = committed_.offset;
+    }
+  } catch (...) {
+    closeBatch();
+    throw;
+  }
+  closeBatch();
+}
+
+void StreamIngestor::closeBatch() {
+  import_buffers_.clear();
+  loader_.reset();
+  is_array_.reset();
+  table_lock_.reset();
+  batch_rows_.clear();
+  batch_row_count_ = 0;
+}
+
+// The offsets file holds the committed offsets, one per line with the epoch of the table
+// its checkpoint produced, oldest first.
+std::deque<StreamIngestor::CommittedOffset> StreamIngestor::readOffsets() const {
+  std::deque<CommittedOffset> offsets;
+  std::ifstream offsets_file(offsets_path_);
+  if (!offsets_file) {
+    return offsets;
+  }
+  CommittedOffset committed;
+  while (offsets_file >> committed.epoch >> committed.offset) {
+    offsets.push_back(committed);
+  }
+  if (!offsets_file.eof()) {
+    throw std::runtime_error("Corrupt stream offsets file " + offsets_path_);
+  }
+  return offsets;
+}
+
+// The rows committed at epochs past the one of the table were rolled back along with it,
+// they are ingested again from the last offset committed at an epoch still in the table.
+StreamIngestor::CommittedOffset StreamIngestor::getResumeOffset(
+    const int32_t table_epoch) {
+  const bool history_trimmed = offsets_.size() >= kOffsetHistorySize;
+  while (!offsets_.empty() && offsets_.back().epoch > table_epoch) {
+    LOG(WARNING) << "Table " << table_name_ << " was rolled back to epoch "
+                 << table_epoch << ", past the stream offset "
+                 << offsets_.back().offset << " committed at epoch "
+                 << offsets_.back().epoch;
+    offsets_.pop_back();
+  }
+  if (!offsets_.empty()) {
+    return offsets_.back();
+  }
+  if (history_trimmed) {
+    throw std::runtime_error("Table " + table_name_ + " was rolled back to epoch " +
+                             std::to_string(table_epoch) +
+                             ", past the oldest stream offset kept in " + offsets_path_ +
+                             ". Remove the file to ingest the stream from its start.");
+  }
+  return {0, 0};
+}
+
+void StreamIngestor::writeOffsets() const {
+  const auto tmp_path = offsets_path_ + ".tmp";
+  std::ostringstream oss;
+  for (const auto& committed : offsets_) {
+    oss << committed.epoch << ' ' << committed.offset << '\n';
+  }
+  const auto contents = oss.str();
+  const int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open stream offsets file " + tmp_path + ": " +
+                             strerror(errno));
+  }
+  if (write(fd, contents.data(), contents.size()) !=
+      static_cast<ssize_t>(contents.size())) {
+    close(fd);
+    throw std::runtime_error("Failed to write stream offsets file " + tmp_path);
+  }
+  if (fsync(fd)) {
+    LOG(FATAL) << "Failed to sync stream offsets file " << tmp_path << ": "
+               << strerror(errno);
+  }
+  close(fd);
+  boost::filesystem::rename(tmp_path, offsets_path_);
+  sync_directory(boost::filesystem::path(offsets_path_).parent_path().string());
+}
+
+}  // namespace Importer_NS
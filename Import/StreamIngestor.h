@@ -0,0 +1,167 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    StreamIngestor.h
+ * @brief   Server side ingestion of a stream of delimited rows into a table.
+ *
+ * A stream ingestor binds a table to a stream source, e.g. a file being tailed or a named
+ * pipe. The rows of the source are buffered as they arrive and loaded in micro-batches,
+ * flushed once a number of rows is buffered or the oldest buffered row has waited for a
+ * while. A batch is committed by a checkpoint of the table. Once the checkpoint
+ * succeeded, the offset of the source past the batch is recorded with the epoch the
+ * checkpoint produced. An ingestion restarted after a crash resumes after the last
+ * recorded offset; a batch checkpointed right before the crash but not yet recorded is
+ * ingested again, i.e. delivery is at least once. An ingestion into a table rolled back
+ * to an earlier epoch resumes after the last offset recorded at or before that epoch.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Import/CopyParams.h"
+#include "Import/Importer.h"
+#include "LockMgr/LockMgr.h"
+
+namespace Importer_NS {
+
+// Source of the rows of a stream. A message queue consumer, e.g. for Kafka, implements it
+// with message offsets.
+class StreamSource {
+ public:
+  virtual ~StreamSource() {}
+
+  // Resumes the stream after the rows up to the given offset, as committed by an earlier
+  // ingestion. Offsets start at 0.
+  virtual void seek(const int64_t offset) = 0;
+
+  // Gets the next row, ending with its line delimiter, and the offset past it. Waits for
+  // it at most timeout and returns false if no row arrived in time.
+  virtual bool next(std::string& row,
+                    int64_t& offset,
+                    const std::chrono::milliseconds timeout) = 0;
+};
+
+// Reads the rows of a file, following it as it grows, or of a named pipe. Offsets are
+// byte offsets; a named pipe can't seek, hence it continues from wherever it stands.
+class FileStreamSource : public StreamSource {
+ public:
+  FileStreamSource(const std::string& path, const char line_delim);
+
+  ~FileStreamSource() override;
+
+  void seek(const int64_t offset) override;
+
+  bool next(std::string& row,
+            int64_t& offset,
+            const std::chrono::milliseconds timeout) override;
+
+ private:
+  bool read(const std::chrono::milliseconds timeout);
+
+  const std::string path_;
+  const char line_delim_;
+  int fd_;
+  bool is_fifo_;
+  std::string buffer_;      // bytes read past the last row returned
+  int64_t offset_{0};       // offset of the front of buffer_
+  size_t scanned_size_{0};  // bytes of buffer_ known not to hold a line delimiter
+};
+
+struct StreamIngestionParams {
+  CopyParams copy_params;
+  size_t flush_row_count{100000};  // rows buffered before a batch is flushed
+  // time the oldest buffered row waits at most before a batch is flushed
+  std::chrono::milliseconds flush_interval{1000};
+};
+
+struct StreamIngestionStatus {
+  bool running{false};
+  size_t rows_loaded{0};
+  size_t rows_rejected{0};
+  int64_t committed_offset{0};
+  std::string error;  // why the ingestion stopped, if it failed
+};
+
+class StreamIngestor {
+ public:
+  // Starts ingesting the source into a table, after the offset committed by the last
+  // ingestion into the table.
+  StreamIngestor(std::shared_ptr<Catalog_Namespace::Catalog> catalog,
+                 const std::string& table_name,
+                 std::unique_ptr<StreamSource> source,
+                 const StreamIngestionParams& params);
+
+  ~StreamIngestor();
+
+  // Stops the ingestion once the buffered rows are committed.
+  void stop();
+
+  StreamIngestionStatus getStatus() const;
+
+  const std::string& getTableName() const { return table_name_; }
+
+ private:
+  struct CommittedOffset {
+    int32_t epoch;  // the epoch of the table produced by the checkpoint of the offset
+    int64_t offset;
+  };
+
+  void run();
+  void openBatch();
+  void addRow(const std::string& row);
+  void flush();
+  void closeBatch();
+  std::deque<CommittedOffset> readOffsets() const;
+  CommittedOffset getResumeOffset(const int32_t table_epoch);
+  void writeOffsets() const;
+
+  const std::shared_ptr<Catalog_Namespace::Catalog> catalog_;
+  const std::string table_name_;
+  const std::unique_ptr<StreamSource> source_;
+  const StreamIngestionParams params_;
+  std::string offsets_path_;
+  std::deque<CommittedOffset> offsets_;  // committed offsets in the order of their epochs
+  CommittedOffset committed_{0, 0};
+
+  // rows buffered for the next batch
+  std::vector<std::string> batch_rows_;
+  int64_t batch_offset_{0};  // offset past the last buffered row
+  std::chrono::steady_clock::time_point batch_start_;
+
+  // the batch being flushed, which holds the table schema read lock
+  std::unique_ptr<lockmgr::AbstractLockContainer<const TableDescriptor*>> table_lock_;
+  std::unique_ptr<Loader> loader_;
+  std::vector<std::unique_ptr<TypedImportBuffer>> import_buffers_;
+  std::unique_ptr<bool[]> is_array_;
+  size_t column_count_{0};  // columns of a row, i.e. without the physical ones
+  size_t batch_row_count_{0};  // rows of the batch parsed into the import buffers
+
+  mutable std::mutex status_mutex_;
+  StreamIngestionStatus status_;
+  bool stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace Importer_NS
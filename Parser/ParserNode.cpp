@@ -53,6 +53,7 @@
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
 #include "QueryEngine/RelAlgExecutor.h"
+#include "QueryEngine/TableOptimizer.h"
 #include "ReservedKeywords.h"
 #include "Shared/StringTransform.h"
 #include "Shared/TimeGM.h"
@@ -3090,6 +3091,117 @@ void RenameTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
   catalog.renameTable(td, *new_table_name);
 }
 
+void AnalyzeTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
+  auto& catalog = session.getCatalog();
+  const auto td_with_lock =
+      lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+          catalog, *table_, false);
+  const auto td = td_with_lock();
+  if (!td || !session.checkDBAccessPrivileges(DBObjectType::TableDBObjectType,
+                                              AccessPrivileges::SELECT_FROM_TABLE,
+                                              *table_)) {
+    throw std::runtime_error("Table " + *table_ + " does not exist.");
+  }
+  if (td->isView) {
+    throw std::runtime_error("ANALYZE TABLE command is not supported on views.");
+  }
+
+  size_t histogram_buckets{100};
+  size_t most_common_values_count{10};
+  size_t sample_size{30000};
+  for (const auto& p : options_) {
+    const IntLiteral* int_literal = dynamic_cast<const IntLiteral*>(p->get_value());
+    if (boost::iequals(*p->get_name(), "histogram_buckets")) {
+      if (int_literal == nullptr || int_literal->get_intval() <= 0) {
+        throw std::runtime_error("histogram_buckets option must be a positive integer.");
+      }
+      histogram_buckets = int_literal->get_intval();
+    } else if (boost::iequals(*p->get_name(), "most_common_values")) {
+      if (int_literal == nullptr || int_literal->get_intval() < 0) {
+        throw std::runtime_error(
+            "most_common_values option must be a non-negative integer.");
+      }
+      most_common_values_count = int_literal->get_intval();
+    } else if (boost::iequals(*p->get_name(), "sample_size")) {
+      if (int_literal == nullptr || int_literal->get_intval() <= 0) {
+        throw std::runtime_error("sample_size option must be a positive integer.");
+      }
+      sample_size = int_literal->get_intval();
+    } else {
+      throw std::runtime_error("Invalid option for ANALYZE TABLE: " + *p->get_name());
+    }
+  }
+
+  // acquire read lock on table data
+  const auto data_lock = lockmgr::TableDataLockMgr::getReadLockForTable(catalog, *table_);
+
+  auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID);
+  const TableOptimizer optimizer(td, executor.get(), catalog);
+  catalog.setColumnStatistics(
+      td,
+      optimizer.computeColumnStatistics(
+          histogram_buckets, most_common_values_count, sample_size));
+}
+
+void CreateIndexStmt::execute(const Catalog_Namespace::SessionInfo& session) {
+  auto& catalog = session.getCatalog();
+  if (!boost::iequals(*index_type_, "RTREE")) {
+    throw std::runtime_error("Index type " + *index_type_ +
+                             " is not supported, only RTREE indexes can be created.");
+  }
+  const auto td_with_lock =
+      lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+          catalog, *table_, false);
+  const auto td = td_with_lock();
+  if (!td || !session.checkDBAccessPrivileges(DBObjectType::TableDBObjectType,
+                                              AccessPrivileges::ALTER_TABLE,
+                                              *table_)) {
+    throw std::runtime_error("Table " + *table_ + " does not exist.");
+  }
+  if (td->isView) {
+    throw std::runtime_error("CREATE INDEX command is not supported on views.");
+  }
+  if (table_is_temporary(td)) {
+    throw std::runtime_error(
+        "CREATE INDEX command is not supported on temporary tables.");
+  }
+  if (td->storageType == StorageType::FOREIGN_TABLE) {
+    throw std::runtime_error("CREATE INDEX command is not supported on foreign tables.");
+  }
+  const auto cd = catalog.getMetadataForColumn(td->tableId, *column_);
+  if (!cd) {
+    throw std::runtime_error("Column " + *column_ + " does not exist.");
+  }
+  if (!is_spatial_index_supported(cd->columnType)) {
+    throw std::runtime_error(
+        "RTREE indexes can only be created on POINT, POLYGON or MULTIPOLYGON columns.");
+  }
+
+  // acquire read lock on table data, the R-trees are built from the current rows
+  const auto data_lock = lockmgr::TableDataLockMgr::getReadLockForTable(catalog, *table_);
+
+  catalog.createSpatialIndex(*index_name_, td, cd);
+}
+
+void DropIndexStmt::execute(const Catalog_Namespace::SessionInfo& session) {
+  auto& catalog = session.getCatalog();
+  const auto index = catalog.getSpatialIndex(*index_name_);
+  if (!index) {
+    throw std::runtime_error("Index " + *index_name_ + " does not exist.");
+  }
+  const auto index_td = catalog.getMetadataForTable(index->table_id);
+  CHECK(index_td);
+  const auto td_with_lock =
+      lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+          catalog, index_td->tableName, false);
+  if (!session.checkDBAccessPrivileges(DBObjectType::TableDBObjectType,
+                                       AccessPrivileges::ALTER_TABLE,
+                                       index_td->tableName)) {
+    throw std::runtime_error("Index " + *index_name_ + " does not exist.");
+  }
+  catalog.dropSpatialIndex(*index_name_);
+}
+
 void DDLStmt::setColumnDescriptor(ColumnDescriptor& cd, const ColumnDef* coldef) {
   bool not_null;
   const ColumnConstraintDef* cc = coldef->get_column_constraint();
@@ -1195,6 +1195,73 @@ class OptimizeTableStmt : public DDLStmt {
   std::list<std::unique_ptr<NameValueAssign>> options_;
 };
 
+/*
+ * @type AnalyzeTableStmt
+ * @brief ANALYZE TABLE statement: computes column statistics used for join ordering
+ */
+class AnalyzeTableStmt : public DDLStmt {
+ public:
+  AnalyzeTableStmt(std::string* table, std::list<NameValueAssign*>* o) : table_(table) {
+    CHECK(table_);
+    if (o) {
+      for (const auto e : *o) {
+        options_.emplace_back(e);
+      }
+      delete o;
+    }
+  }
+
+  const std::string getTableName() const { return *(table_.get()); }
+
+  void execute(const Catalog_Namespace::SessionInfo& session) override;
+
+ private:
+  std::unique_ptr<std::string> table_;
+  std::list<std::unique_ptr<NameValueAssign>> options_;
+};
+
+/*
+ * @type CreateIndexStmt
+ * @brief CREATE INDEX statement: creates an R-tree spatial index on a geo column
+ */
+class CreateIndexStmt : public DDLStmt {
+ public:
+  CreateIndexStmt(std::string* index_name,
+                  std::string* table,
+                  std::string* column,
+                  std::string* index_type)
+      : index_name_(index_name), table_(table), column_(column), index_type_(index_type) {
+    CHECK(index_name_);
+    CHECK(table_);
+    CHECK(column_);
+    CHECK(index_type_);
+  }
+
+  void execute(const Catalog_Namespace::SessionInfo& session) override;
+
+ private:
+  std::unique_ptr<std::string> index_name_;
+  std::unique_ptr<std::string> table_;
+  std::unique_ptr<std::string> column_;
+  std::unique_ptr<std::string> index_type_;
+};
+
+/*
+ * @type DropIndexStmt
+ * @brief DROP INDEX statement
+ */
+class DropIndexStmt : public DDLStmt {
+ public:
+  DropIndexStmt(std::string* index_name) : index_name_(index_name) {
+    CHECK(index_name_);
+  }
+
+  void execute(const Catalog_Namespace::SessionInfo& session) override;
+
+ private:
+  std::unique_ptr<std::string> index_name_;
+};
+
 class ValidateStmt : public DDLStmt {
  public:
   ValidateStmt(std::string* type, std::list<NameValueAssign*>* with_opts) : type_(type) {
@@ -1344,40 +1411,67 @@ class DumpRestoreTableStmtBase : public DDLStmt {
     };
     std::unique_ptr<std::list<NameValueAssign*>, decltype(options_deleter)> options_ptr(
         options, options_deleter);
-    std::vector<std::string> allowed_compression_programs{"lz4", "gzip", "none"};
+    std::vector<std::string> allowed_compression_programs{"zlib", "lz4", "gzip", "none"};
+    std::string format;
     // specialize decompressor or break on osx bsdtar...
     if (options) {
       for (const auto option : *options) {
         if (boost::iequals(*option->get_name(), "compression")) {
           if (const auto str_literal =
                   dynamic_cast<const StringLiteral*>(option->get_value())) {
-            compression = *str_literal->get_stringval();
-            const std::string lowercase_compression =
-                boost::algorithm::to_lower_copy(compression);
+            compression =
+                boost::algorithm::to_lower_copy(*str_literal->get_stringval());
             if (allowed_compression_programs.end() ==
                 std::find(allowed_compression_programs.begin(),
                           allowed_compression_programs.end(),
-                          lowercase_compression)) {
+                          compression)) {
               throw std::runtime_error("Compression program " + compression +
                                        " is not supported.");
             }
           } else {
             throw std::runtime_error("Compression option must be a string.");
           }
+        } else if (boost::iequals(*option->get_name(), "format")) {
+          if (const auto str_literal =
+                  dynamic_cast<const StringLiteral*>(option->get_value())) {
+            format = boost::algorithm::to_lower_copy(*str_literal->get_stringval());
+            if (format != "tar" && format != "native") {
+              throw std::runtime_error("Archive format " + format + " is not supported.");
+            }
+          } else {
+            throw std::runtime_error("Format option must be a string.");
+          }
         } else {
           throw std::runtime_error("Invalid WITH option: " + *option->get_name());
         }
       }
     }
-    // default lz4 compression, next gzip, or none.
-    if (compression.empty()) {
+    // the native archive format, compressed in-process with zlib, is opt-in with
+    // FORMAT='native' or COMPRESSION='zlib'. tar archives stay the default, compressed by
+    // lz4, next gzip, or none. restore detects the format and compression of an archive.
+    if (format.empty()) {
+      format = compression == "zlib" ? "native" : "tar";
+    }
+    if (format == "native") {
+      if (compression.empty()) {
+        compression = "zlib";
+      } else if (compression != "zlib" && compression != "none") {
+        throw std::runtime_error("Compression program " + compression +
+                                 " is not supported for native archives.");
+      }
+      return;
+    }
+    if (compression == "zlib") {
+      throw std::runtime_error("Compression program zlib requires native archives.");
+    }
+    if (compression.empty() && !is_restore) {
       if (boost::process::search_path(compression = "gzip").string().empty()) {
         if (boost::process::search_path(compression = "lz4").string().empty()) {
           compression = "none";
         }
       }
     }
-    if (boost::iequals(compression, "none")) {
+    if (compression.empty() || compression == "none") {
       compression.clear();
     } else {
       std::map<std::string, std::string> decompression{{"lz4", "unlz4"},
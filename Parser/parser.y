@@ -102,16 +102,16 @@ using namespace Parser;
 
 	/* literal keyword tokens */
 
-%token ADD ALL ALTER AMMSC ANY ARCHIVE ARRAY AS ASC AUTHORIZATION BETWEEN BIGINT BOOLEAN BY
+%token ADD ALL ALTER AMMSC ANALYZE ANY ARCHIVE ARRAY AS ASC AUTHORIZATION BETWEEN BIGINT BOOLEAN BY
 %token CASE CAST CHAR_LENGTH CHARACTER CHECK CLOSE CLUSTER COLUMN COMMIT CONTINUE COPY CREATE CURRENT
 %token CURSOR DATABASE DATAFRAME DATE DATETIME DATE_TRUNC DECIMAL DECLARE DEFAULT DELETE DESC DICTIONARY DISTINCT DOUBLE DROP
 %token DUMP ELSE END EXISTS EXTRACT FETCH FIRST FLOAT FOR FOREIGN FOUND FROM
-%token GEOGRAPHY GEOMETRY GRANT GROUP HAVING IF ILIKE IN INSERT INTEGER INTO
+%token GEOGRAPHY GEOMETRY GRANT GROUP HAVING IF ILIKE IN INDEX INSERT INTEGER INTO
 %token IS LANGUAGE LAST LENGTH LIKE LIMIT LINESTRING MOD MULTIPOLYGON NOW NULLX NUMERIC OF OFFSET ON OPEN OPTIMIZE
 %token OPTIMIZED OPTION ORDER PARAMETER POINT POLYGON PRECISION PRIMARY PRIVILEGES PROCEDURE
 %token SERVER SMALLINT SOME TABLE TEMPORARY TEXT THEN TIME TIMESTAMP TINYINT TO TRUNCATE UNION
 %token PUBLIC REAL REFERENCES RENAME RESTORE REVOKE ROLE ROLLBACK SCHEMA SELECT SET SHARD SHARED SHOW
-%token UNIQUE UPDATE USER VALIDATE VALUES VIEW WHEN WHENEVER WHERE WITH WORK EDIT ACCESS DASHBOARD SQL EDITOR
+%token UNIQUE UPDATE USER USING VALIDATE VALUES VIEW WHEN WHENEVER WHERE WITH WORK EDIT ACCESS DASHBOARD SQL EDITOR
 
 %start sql_list
 
@@ -153,6 +153,9 @@ sql:		/* schema {	$<nodeval>$ = $<nodeval>1; } */
 	| revoke_privileges_statement { $<nodeval>$ = $<nodeval>1; }
 	| grant_role_statement { $<nodeval>$ = $<nodeval>1; }
 	| optimize_table_statement { $<nodeval>$ = $<nodeval>1; }
+	| analyze_table_statement { $<nodeval>$ = $<nodeval>1; }
+	| create_index_statement { $<nodeval>$ = $<nodeval>1; }
+	| drop_index_statement { $<nodeval>$ = $<nodeval>1; }
 	| validate_system_statement { $<nodeval>$ = $<nodeval>1; }
 	| revoke_role_statement { $<nodeval>$ = $<nodeval>1; }
 	| dump_table_statement { $<nodeval>$ = $<nodeval>1; }
@@ -426,6 +429,27 @@ optimize_table_statement:
 		}
 		;
 
+analyze_table_statement:
+		ANALYZE TABLE table opt_with_option_list
+		{
+			$<nodeval>$ = TrackedPtr<Node>::make(lexer.parsed_node_tokens_, new AnalyzeTableStmt(($<stringval>3)->release(), reinterpret_cast<std::list<NameValueAssign*>*>(($<listval>4)->release())));
+		}
+		;
+
+create_index_statement:
+		CREATE INDEX NAME ON table '(' column ')' USING NAME
+		{
+			$<nodeval>$ = TrackedPtr<Node>::make(lexer.parsed_node_tokens_, new CreateIndexStmt(($<stringval>3)->release(), ($<stringval>5)->release(), ($<stringval>7)->release(), ($<stringval>10)->release()));
+		}
+		;
+
+drop_index_statement:
+		DROP INDEX NAME
+		{
+			$<nodeval>$ = TrackedPtr<Node>::make(lexer.parsed_node_tokens_, new DropIndexStmt(($<stringval>3)->release()));
+		}
+		;
+
 validate_system_statement:
 		VALIDATE CLUSTER opt_with_option_list
 		{
@@ -1137,6 +1161,7 @@ table:
 	}
 	/* |	NAME '.' NAME { $$ = new TableRef(($<stringval>1)->release(), ($<stringval>3)->release()); } */
     | 	QUOTED_IDENTIFIER { $<stringval>$ = $<stringval>1; }
+    | 	non_reserved_keyword { $<stringval>$ = $<stringval>1; }
 	;
 
 opt_table:
@@ -1312,6 +1337,12 @@ column:
 		$<stringval>$ = $<stringval>1;
 	}
     | 	QUOTED_IDENTIFIER { $<stringval>$ = $<stringval>1; }
+    | 	non_reserved_keyword { $<stringval>$ = $<stringval>1; }
+	;
+
+	/* keywords of statements which may still name tables and columns */
+non_reserved_keyword:
+	INDEX { $<stringval>$ = $<stringval>1; }
 	;
 
 /*
@@ -273,8 +273,8 @@ std::set<DecodedJoinHashBufferEntry> BaselineJoinHashTable::toSet(
 
 BaselineJoinHashTable::CompositeKeyInfo BaselineJoinHashTable::getCompositeKeyInfo()
     const {
-  std::vector<const void*> sd_inner_proxy_per_key;
-  std::vector<const void*> sd_outer_proxy_per_key;
+  std::vector<const StringDictionaryProxy*> sd_inner_proxy_per_key;
+  std::vector<const StringDictionaryProxy*> sd_outer_proxy_per_key;
   std::vector<ChunkKey> cache_key_chunks;  // used for the cache key
   for (const auto& inner_outer_pair : inner_outer_pairs_) {
     const auto inner_col = inner_outer_pair.first;
@@ -305,6 +305,27 @@ BaselineJoinHashTable::CompositeKeyInfo BaselineJoinHashTable::getCompositeKeyIn
   return {sd_inner_proxy_per_key, sd_outer_proxy_per_key, cache_key_chunks};
 }
 
+BaselineJoinHashTable::KeyTranslationMaps BaselineJoinHashTable::buildKeyTranslationMaps(
+    const CompositeKeyInfo& composite_key_info) {
+  KeyTranslationMaps key_translation_maps;
+  const auto& sd_inner_proxy_per_key = composite_key_info.sd_inner_proxy_per_key;
+  const auto& sd_outer_proxy_per_key = composite_key_info.sd_outer_proxy_per_key;
+  CHECK_EQ(sd_inner_proxy_per_key.size(), sd_outer_proxy_per_key.size());
+  for (size_t i = 0; i < sd_inner_proxy_per_key.size(); ++i) {
+    StringDictionaryProxy::TranslationMap translation_map;
+    if (sd_inner_proxy_per_key[i]) {
+      CHECK(sd_outer_proxy_per_key[i]);
+      translation_map =
+          sd_inner_proxy_per_key[i]->buildTranslationMap(sd_outer_proxy_per_key[i]);
+    }
+    key_translation_maps.sd_inner_to_outer_translation_maps.push_back(
+        translation_map.data());
+    key_translation_maps.sd_min_inner_elems.push_back(translation_map.min_id);
+    key_translation_maps.translation_maps.push_back(std::move(translation_map));
+  }
+  return key_translation_maps;
+}
+
 void BaselineJoinHashTable::reify() {
   auto timer = DEBUG_TIMER(__func__);
   CHECK_LT(0, device_count_);
@@ -628,6 +649,7 @@ int BaselineJoinHashTable::initHashTableOnCpu(
   if (cpu_hash_table_buff_) {
     return 0;
   }
+  const auto key_translation_maps = buildKeyTranslationMaps(composite_key_info);
   const auto key_component_width = getKeyComponentWidth();
   const auto key_component_count = getKeyComponentCount();
   const auto entry_size =
@@ -698,7 +720,7 @@ int BaselineJoinHashTable::initHashTableOnCpu(
     fill_cpu_buff_threads.emplace_back(std::async(
         std::launch::async,
         [this,
-         &composite_key_info,
+         &key_translation_maps,
          &join_columns,
          &join_column_types,
          key_component_count,
@@ -708,13 +730,13 @@ int BaselineJoinHashTable::initHashTableOnCpu(
          thread_count] {
           switch (key_component_width) {
             case 4: {
-              const auto key_handler =
-                  GenericKeyHandler(key_component_count,
-                                    true,
-                                    &join_columns[0],
-                                    &join_column_types[0],
-                                    &composite_key_info.sd_inner_proxy_per_key[0],
-                                    &composite_key_info.sd_outer_proxy_per_key[0]);
+              const auto key_handler = GenericKeyHandler(
+                  key_component_count,
+                  true,
+                  &join_columns[0],
+                  &join_column_types[0],
+                  &key_translation_maps.sd_inner_to_outer_translation_maps[0],
+                  &key_translation_maps.sd_min_inner_elems[0]);
               return fill_baseline_hash_join_buff_32(
                   &(*cpu_hash_table_buff_)[0],
                   entry_count_,
@@ -728,13 +750,13 @@ int BaselineJoinHashTable::initHashTableOnCpu(
               break;
             }
             case 8: {
-              const auto key_handler =
-                  GenericKeyHandler(key_component_count,
-                                    true,
-                                    &join_columns[0],
-                                    &join_column_types[0],
-                                    &composite_key_info.sd_inner_proxy_per_key[0],
-                                    &composite_key_info.sd_outer_proxy_per_key[0]);
+              const auto key_handler = GenericKeyHandler(
+                  key_component_count,
+                  true,
+                  &join_columns[0],
+                  &join_column_types[0],
+                  &key_translation_maps.sd_inner_to_outer_translation_maps[0],
+                  &key_translation_maps.sd_min_inner_elems[0]);
               return fill_baseline_hash_join_buff_64(
                   &(*cpu_hash_table_buff_)[0],
                   entry_count_,
@@ -772,33 +794,35 @@ int BaselineJoinHashTable::initHashTableOnCpu(
       case 4: {
         const auto composite_key_dict =
             reinterpret_cast<int32_t*>(&(*cpu_hash_table_buff_)[0]);
-        fill_one_to_many_baseline_hash_table_32(one_to_many_buff,
-                                                composite_key_dict,
-                                                entry_count_,
-                                                -1,
-                                                key_component_count,
-                                                join_columns,
-                                                join_column_types,
-                                                join_bucket_info,
-                                                composite_key_info.sd_inner_proxy_per_key,
-                                                composite_key_info.sd_outer_proxy_per_key,
-                                                thread_count);
+        fill_one_to_many_baseline_hash_table_32(
+            one_to_many_buff,
+            composite_key_dict,
+            entry_count_,
+            -1,
+            key_component_count,
+            join_columns,
+            join_column_types,
+            join_bucket_info,
+            key_translation_maps.sd_inner_to_outer_translation_maps,
+            key_translation_maps.sd_min_inner_elems,
+            thread_count);
         break;
       }
       case 8: {
         const auto composite_key_dict =
             reinterpret_cast<int64_t*>(&(*cpu_hash_table_buff_)[0]);
-        fill_one_to_many_baseline_hash_table_64(one_to_many_buff,
-                                                composite_key_dict,
-                                                entry_count_,
-                                                -1,
-                                                key_component_count,
-                                                join_columns,
-                                                join_column_types,
-                                                join_bucket_info,
-                                                composite_key_info.sd_inner_proxy_per_key,
-                                                composite_key_info.sd_outer_proxy_per_key,
-                                                thread_count);
+        fill_one_to_many_baseline_hash_table_64(
+            one_to_many_buff,
+            composite_key_dict,
+            entry_count_,
+            -1,
+            key_component_count,
+            join_columns,
+            join_column_types,
+            join_bucket_info,
+            key_translation_maps.sd_inner_to_outer_translation_maps,
+            key_translation_maps.sd_min_inner_elems,
+            thread_count);
         break;
       }
       default:
@@ -1225,6 +1249,9 @@ void BaselineJoinHashTable::initHashTableOnCpuFromCache(const HashTableCacheKey&
       layout_ = kv.second.type;
       entry_count_ = kv.second.entry_count;
       emitted_keys_count_ = kv.second.emitted_keys_count;
+      if (auto query_profile = executor_->getQueryProfile()) {
+        query_profile->addHashTableCacheHit();
+      }
       break;
     } else {
       VLOG(1) << hash_table_cache_.size()
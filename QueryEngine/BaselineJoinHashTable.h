@@ -18,6 +18,7 @@
 
 #include "../Analyzer/Analyzer.h"
 #include "../DataMgr/MemoryLevel.h"
+#include "../StringDictionary/StringDictionaryProxy.h"
 #include "ColumnarResults.h"
 #include "Descriptors/RowSetMemoryOwner.h"
 #include "HashJoinRuntime.h"
@@ -182,13 +183,24 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
       const std::vector<InnerOuter>& inner_outer_pairs) const;
 
   struct CompositeKeyInfo {
-    std::vector<const void*> sd_inner_proxy_per_key;
-    std::vector<const void*> sd_outer_proxy_per_key;
+    std::vector<const StringDictionaryProxy*> sd_inner_proxy_per_key;
+    std::vector<const StringDictionaryProxy*> sd_outer_proxy_per_key;
     std::vector<ChunkKey> cache_key_chunks;  // used for the cache key
   };
 
   CompositeKeyInfo getCompositeKeyInfo() const;
 
+  // Inner to outer dictionary translation maps of the string key components, null for
+  // the other components. Holds on to the maps while the hash table is built.
+  struct KeyTranslationMaps {
+    std::vector<StringDictionaryProxy::TranslationMap> translation_maps;
+    std::vector<const int32_t*> sd_inner_to_outer_translation_maps;
+    std::vector<int32_t> sd_min_inner_elems;
+  };
+
+  static KeyTranslationMaps buildKeyTranslationMaps(
+      const CompositeKeyInfo& composite_key_info);
+
   void reify();
 
   void reifyForDevice(const ColumnsForDevice& columns_for_device,
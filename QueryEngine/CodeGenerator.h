@@ -176,6 +176,8 @@ class CodeGenerator {
 
   llvm::Value* codegen(const Analyzer::LowerExpr*, const CompilationOptions&);
 
+  llvm::Value* codegen(const Analyzer::UpperExpr*, const CompilationOptions&);
+
   llvm::Value* codegen(const Analyzer::LikeExpr*, const CompilationOptions&);
 
   llvm::Value* codegen(const Analyzer::RegexpExpr*, const CompilationOptions&);
@@ -394,6 +396,22 @@ class CodeGenerator {
                                  const char escape_char,
                                  const CompilationOptions&);
 
+  // Nested LOWER / UPPER functions on a dictionary encoded string, evaluated for the
+  // whole dictionary at once.
+  llvm::Value* codegenDictStringOps(const Analyzer::Expr*, const CompilationOptions&);
+
+  llvm::Value* codegenDictCharLength(const Analyzer::CharLengthExpr*,
+                                     const Analyzer::Expr* dict_arg,
+                                     const CompilationOptions&);
+
+  // Loads the entry of a per-dictionary map for the given string id, the ids the map
+  // doesn't cover go through the fallback_fname external function instead.
+  llvm::Value* codegenStringIdMapLookup(
+      llvm::Value* str_id_lv,
+      const StringDictionaryProxy::TranslationMap& map,
+      const std::string& fallback_fname,
+      const std::vector<llvm::Value*>& fallback_args);
+
   // Returns the IR value which holds true iff at least one match has been found for outer
   // join, null if there's no outer join condition on the given nesting level.
   llvm::Value* foundOuterJoinMatch(const ssize_t nesting_level) const;
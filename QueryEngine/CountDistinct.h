@@ -25,6 +25,7 @@
 #ifndef QUERYENGINE_COUNTDISTINCT_H
 #define QUERYENGINE_COUNTDISTINCT_H
 
+#include "CountDistinctSets.h"
 #include "Descriptors/CountDistinctDescriptor.h"
 #include "HyperLogLog.h"
 
@@ -93,8 +94,11 @@ inline int64_t count_distinct_set_size(
     }
     return bitmap_set_size(set_vals, count_distinct_desc.bitmapSizeBytes());
   }
-  CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
-  return reinterpret_cast<std::set<int64_t>*>(set_handle)->size();
+  if (count_distinct_desc.impl_type_ == CountDistinctImplType::SparseBitmap) {
+    return reinterpret_cast<CountDistinctSparseBitmap*>(set_handle)->size();
+  }
+  CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::HashSet);
+  return reinterpret_cast<CountDistinctHashSet*>(set_handle)->size();
 }
 
 inline void count_distinct_set_union(
@@ -141,12 +145,18 @@ inline void count_distinct_set_union(
                                       : old_count_distinct_desc.bitmapPaddedSizeBytes();
       bitmap_set_union(new_set, old_set, bitmap_byte_sz);
     }
+  } else if (new_count_distinct_desc.impl_type_ == CountDistinctImplType::SparseBitmap) {
+    CHECK(old_count_distinct_desc.impl_type_ == CountDistinctImplType::SparseBitmap);
+    auto old_set = reinterpret_cast<CountDistinctSparseBitmap*>(old_set_handle);
+    auto new_set = reinterpret_cast<CountDistinctSparseBitmap*>(new_set_handle);
+    new_set->merge(*old_set);
+    *old_set = *new_set;
   } else {
-    CHECK(old_count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
-    auto old_set = reinterpret_cast<std::set<int64_t>*>(old_set_handle);
-    auto new_set = reinterpret_cast<std::set<int64_t>*>(new_set_handle);
-    new_set->insert(old_set->begin(), old_set->end());
-    old_set->insert(new_set->begin(), new_set->end());
+    CHECK(old_count_distinct_desc.impl_type_ == CountDistinctImplType::HashSet);
+    auto old_set = reinterpret_cast<CountDistinctHashSet*>(old_set_handle);
+    auto new_set = reinterpret_cast<CountDistinctHashSet*>(new_set_handle);
+    new_set->merge(*old_set);
+    old_set->assign(*new_set);
   }
 }
 
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/CountDistinctSets.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "QueryEngine/Descriptors/RowSetMemoryOwner.h"
+#include "Shared/Logger.h"
+
+void CountDistinctHashSet::merge(const CountDistinctHashSet& other) {
+  if (&other == this) {
+    return;
+  }
+  has_empty_slot_val_ = has_empty_slot_val_ || other.has_empty_slot_val_;
+  if (!other.slot_count_) {
+    return;
+  }
+  // sizes the slots for the union up front, rather than growing while inserting
+  size_t capacity = std::max(capacity_, kInitialCapacity);
+  while (2 * (slot_count_ + other.slot_count_) >= capacity) {
+    capacity *= 2;
+  }
+  if (capacity != capacity_) {
+    rehash(capacity);
+  }
+  for (size_t i = 0; i < other.capacity_; ++i) {
+    if (other.slots_[i] != kEmptySlot) {
+      insert(other.slots_[i]);
+    }
+  }
+}
+
+void CountDistinctHashSet::assign(const CountDistinctHashSet& other) {
+  if (&other == this) {
+    return;
+  }
+  if (capacity_ != other.capacity_) {
+    slots_ = other.capacity_ ? reinterpret_cast<int64_t*>(row_set_mem_owner_->allocate(
+                                   other.capacity_ * sizeof(int64_t)))
+                             : nullptr;
+    capacity_ = other.capacity_;
+  }
+  std::copy(other.slots_, other.slots_ + other.capacity_, slots_);
+  slot_count_ = other.slot_count_;
+  has_empty_slot_val_ = other.has_empty_slot_val_;
+}
+
+void CountDistinctHashSet::grow() {
+  rehash(capacity_ ? 2 * capacity_ : kInitialCapacity);
+}
+
+void CountDistinctHashSet::rehash(const size_t capacity) {
+  CHECK(row_set_mem_owner_);
+  CHECK_EQ(capacity & (capacity - 1), size_t(0));
+  const auto old_slots = slots_;
+  const auto old_capacity = capacity_;
+  // the old slots are released along with the arena of the query
+  slots_ = reinterpret_cast<int64_t*>(
+      row_set_mem_owner_->allocate(capacity * sizeof(int64_t)));
+  std::fill(slots_, slots_ + capacity, kEmptySlot);
+  capacity_ = capacity;
+  const auto mask = capacity_ - 1;
+  for (size_t i = 0; i < old_capacity; ++i) {
+    const auto val = old_slots[i];
+    if (val == kEmptySlot) {
+      continue;
+    }
+    auto slot_idx = hash(val) & mask;
+    while (slots_[slot_idx] != kEmptySlot) {
+      slot_idx = (slot_idx + 1) & mask;
+    }
+    slots_[slot_idx] = val;
+  }
+}
+
+void CountDistinctSparseBitmap::insert(const int64_t val) {
+  const auto uval = static_cast<uint64_t>(val);
+  if (insertIntoContainer(getContainer(uval >> 16), uval & 0xffff)) {
+    ++size_;
+  }
+}
+
+void CountDistinctSparseBitmap::merge(const CountDistinctSparseBitmap& other) {
+  if (&other == this) {
+    return;
+  }
+  std::vector<Container> containers;
+  containers.reserve(containers_.size() + other.containers_.size());
+  auto lhs_it = containers_.begin();
+  auto rhs_it = other.containers_.begin();
+  while (lhs_it != containers_.end() || rhs_it != other.containers_.end()) {
+    if (rhs_it == other.containers_.end() ||
+        (lhs_it != containers_.end() && lhs_it->key < rhs_it->key)) {
+      containers.push_back(std::move(*lhs_it++));
+    } else if (lhs_it == containers_.end() || rhs_it->key < lhs_it->key) {
+      containers.push_back(*rhs_it++);
+    } else {
+      mergeContainers(*lhs_it, *rhs_it++);
+      containers.push_back(std::move(*lhs_it++));
+    }
+  }
+  containers_ = std::move(containers);
+  last_container_idx_ = 0;
+  size_ = 0;
+  for (const auto& container : containers_) {
+    size_ += container.cardinality;
+  }
+}
+
+bool CountDistinctSparseBitmap::insertIntoContainer(Container& container,
+                                                    const uint16_t low_bits) {
+  if (!container.words.empty()) {
+    auto& word = container.words[low_bits >> 6];
+    const auto bit = uint64_t(1) << (low_bits & 63);
+    if (word & bit) {
+      return false;
+    }
+    word |= bit;
+    ++container.cardinality;
+    return true;
+  }
+  auto& values = container.values;
+  const auto it = std::lower_bound(values.begin(), values.end(), low_bits);
+  if (it != values.end() && *it == low_bits) {
+    return false;
+  }
+  if (values.size() == kMaxArrayCardinality) {
+    convertToBitmap(container);
+    return insertIntoContainer(container, low_bits);
+  }
+  values.insert(it, low_bits);
+  ++container.cardinality;
+  return true;
+}
+
+void CountDistinctSparseBitmap::mergeContainers(Container& lhs, const Container& rhs) {
+  CHECK_EQ(lhs.key, rhs.key);
+  if (lhs.words.empty() && rhs.words.empty()) {
+    std::vector<uint16_t> values;
+    values.reserve(lhs.values.size() + rhs.values.size());
+    std::set_union(lhs.values.begin(),
+                   lhs.values.end(),
+                   rhs.values.begin(),
+                   rhs.values.end(),
+                   std::back_inserter(values));
+    lhs.values = std::move(values);
+    lhs.cardinality = lhs.values.size();
+    if (lhs.cardinality > kMaxArrayCardinality) {
+      convertToBitmap(lhs);
+    }
+    return;
+  }
+  if (lhs.words.empty()) {
+    convertToBitmap(lhs);
+  }
+  if (rhs.words.empty()) {
+    for (const auto low_bits : rhs.values) {
+      lhs.words[low_bits >> 6] |= uint64_t(1) << (low_bits & 63);
+    }
+  } else {
+    for (size_t i = 0; i < lhs.words.size(); ++i) {
+      lhs.words[i] |= rhs.words[i];
+    }
+  }
+  lhs.cardinality = 0;
+  for (const auto word : lhs.words) {
+    lhs.cardinality += __builtin_popcountll(word);
+  }
+}
+
+void CountDistinctSparseBitmap::convertToBitmap(Container& container) {
+  CHECK(container.words.empty());
+  container.words.assign((1 << 16) / 64, 0);
+  for (const auto low_bits : container.values) {
+    container.words[low_bits >> 6] |= uint64_t(1) << (low_bits & 63);
+  }
+  container.values.clear();
+  container.values.shrink_to_fit();
+}
+
+CountDistinctSparseBitmap::Container& CountDistinctSparseBitmap::getContainer(
+    const uint64_t key) {
+  if (last_container_idx_ < containers_.size() &&
+      containers_[last_container_idx_].key == key) {
+    return containers_[last_container_idx_];
+  }
+  auto it = std::lower_bound(
+      containers_.begin(),
+      containers_.end(),
+      key,
+      [](const Container& container, const uint64_t key) { return container.key < key; });
+  if (it == containers_.end() || it->key != key) {
+    it = containers_.insert(it, Container{key, 0, {}, {}});
+  }
+  last_container_idx_ = std::distance(containers_.begin(), it);
+  return *it;
+}
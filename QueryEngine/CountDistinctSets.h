@@ -0,0 +1,163 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    CountDistinctSets.h
+ * @brief   Sets used for exact COUNT(DISTINCT) when the range of the argument is too
+ * wide for a bitmap.
+ *
+ * CountDistinctHashSet is an open addressing hash set of which the slots are allocated
+ * from the arena of the query, for arguments without a usable range or with values
+ * spread thinly across it. CountDistinctSparseBitmap splits the values in chunks of
+ * 2^16 by their high bits, each stored either as a sorted array or as a bitmap once it
+ * gets dense, like a roaring bitmap. Both merge in time linear in their sizes.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Shared/likely.h"
+
+class RowSetMemoryOwner;
+
+class CountDistinctHashSet {
+ public:
+  explicit CountDistinctHashSet(RowSetMemoryOwner* row_set_mem_owner)
+      : row_set_mem_owner_(row_set_mem_owner) {}
+
+  CountDistinctHashSet(const CountDistinctHashSet&) = delete;
+  CountDistinctHashSet& operator=(const CountDistinctHashSet&) = delete;
+
+  void insert(const int64_t val) {
+    if (UNLIKELY(val == kEmptySlot)) {
+      has_empty_slot_val_ = true;
+      return;
+    }
+    // keeps the load factor under one half, probe sequences stay short
+    if (UNLIKELY(2 * slot_count_ >= capacity_)) {
+      grow();
+    }
+    const auto mask = capacity_ - 1;
+    for (auto slot_idx = hash(val) & mask;; slot_idx = (slot_idx + 1) & mask) {
+      if (slots_[slot_idx] == val) {
+        return;
+      }
+      if (slots_[slot_idx] == kEmptySlot) {
+        slots_[slot_idx] = val;
+        ++slot_count_;
+        return;
+      }
+    }
+  }
+
+  size_t size() const { return slot_count_ + (has_empty_slot_val_ ? 1 : 0); }
+
+  // Adds the values of the other set to this one.
+  void merge(const CountDistinctHashSet& other);
+
+  // Replaces the values of this set with those of the other one.
+  void assign(const CountDistinctHashSet& other);
+
+  template <typename FUNC>
+  void forEach(FUNC func) const {
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (slots_[i] != kEmptySlot) {
+        func(slots_[i]);
+      }
+    }
+    if (has_empty_slot_val_) {
+      func(kEmptySlot);
+    }
+  }
+
+ private:
+  static constexpr int64_t kEmptySlot{std::numeric_limits<int64_t>::min()};
+  static constexpr size_t kInitialCapacity{8};
+
+  static uint64_t hash(const int64_t val) {
+    // the finalizer of MurmurHash3, spreads consecutive values across the slots
+    uint64_t h = static_cast<uint64_t>(val);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  void grow();
+  void rehash(const size_t capacity);
+
+  RowSetMemoryOwner* row_set_mem_owner_;
+  int64_t* slots_{nullptr};
+  size_t capacity_{0};
+  size_t slot_count_{0};
+  bool has_empty_slot_val_{false};
+};
+
+class CountDistinctSparseBitmap {
+ public:
+  void insert(const int64_t val);
+
+  size_t size() const { return size_; }
+
+  // Adds the values of the other bitmap to this one.
+  void merge(const CountDistinctSparseBitmap& other);
+
+  template <typename FUNC>
+  void forEach(FUNC func) const {
+    for (const auto& container : containers_) {
+      const auto high_bits = container.key << 16;
+      if (container.words.empty()) {
+        for (const auto low_bits : container.values) {
+          func(static_cast<int64_t>(high_bits | low_bits));
+        }
+        continue;
+      }
+      for (size_t i = 0; i < container.words.size(); ++i) {
+        for (auto word = container.words[i]; word; word &= word - 1) {
+          func(static_cast<int64_t>(high_bits | (i << 6) | __builtin_ctzll(word)));
+        }
+      }
+    }
+  }
+
+ private:
+  // Past this many values, a bitmap of the 2^16 values of a container is smaller than
+  // the sorted array of them.
+  static constexpr size_t kMaxArrayCardinality{4096};
+
+  struct Container {
+    uint64_t key;                  // the high 48 bits of the values
+    size_t cardinality;
+    std::vector<uint16_t> values;  // sorted low bits, until the container gets dense
+    std::vector<uint64_t> words;   // bitmap of the low bits, once it is
+  };
+
+  static bool insertIntoContainer(Container& container, const uint16_t low_bits);
+  static void mergeContainers(Container& lhs, const Container& rhs);
+  static void convertToBitmap(Container& container);
+
+  Container& getContainer(const uint64_t key);
+
+  std::vector<Container> containers_;  // sorted by key
+  size_t last_container_idx_{0};       // values of a group tend to be clustered
+  size_t size_{0};
+};
@@ -79,6 +79,10 @@ class DeepCopyVisitor : public ScalarExprVisitor<std::shared_ptr<Analyzer::Expr>
     return makeExpr<Analyzer::LowerExpr>(visit(expr->get_arg()));
   }
 
+  RetType visitUpper(const Analyzer::UpperExpr* expr) const override {
+    return makeExpr<Analyzer::UpperExpr>(visit(expr->get_arg()));
+  }
+
   RetType visitCardinality(const Analyzer::CardinalityExpr* cardinality) const override {
     return makeExpr<Analyzer::CardinalityExpr>(visit(cardinality->get_arg()));
   }
@@ -230,7 +234,7 @@ class DeepCopyVisitor : public ScalarExprVisitor<std::shared_ptr<Analyzer::Expr>
                                        agg->get_aggtype(),
                                        arg,
                                        agg->get_is_distinct(),
-                                       agg->get_error_rate());
+                                       agg->get_arg1());
   }
 
   RetType visitOffsetInFragment(const Analyzer::OffsetInFragment*) const override {
@@ -145,9 +145,16 @@ void QueryFragmentDescriptor::buildFragmentPerKernelMapForUnion(
 
     for (size_t i = 0; i < fragments->size(); ++i) {
       const auto& fragment = (*fragments)[i];
-      const auto skip_frag = executor->skipFragment(
+      auto skip_frag = executor->skipFragment(
           table_desc, fragment, ra_exe_unit.simple_quals, frag_offsets, i);
+      if (skip_frag == std::pair<bool, int64_t>(false, -1)) {
+        skip_frag.first =
+            executor->skipFragmentGeoBounds(table_desc, ra_exe_unit, fragment) ||
+            executor->skipFragmentSpatialIndex(table_desc, ra_exe_unit, fragment) ||
+            executor->skipFragmentJoinKeyBounds(table_desc, fragment);
+      }
       if (skip_frag.first) {
+        ++num_skipped_outer_fragments_;
         continue;
       }
       rowid_lookup_key_ = std::max(rowid_lookup_key_, skip_frag.second);
@@ -247,9 +254,16 @@ void QueryFragmentDescriptor::buildFragmentPerKernelMap(
     }
 
     const auto& fragment = (*outer_fragments)[i];
-    const auto skip_frag = executor->skipFragment(
+    auto skip_frag = executor->skipFragment(
         outer_table_desc, fragment, ra_exe_unit.simple_quals, frag_offsets, i);
+    if (skip_frag == std::pair<bool, int64_t>(false, -1)) {
+      skip_frag.first =
+          executor->skipFragmentGeoBounds(outer_table_desc, ra_exe_unit, fragment) ||
+          executor->skipFragmentSpatialIndex(outer_table_desc, ra_exe_unit, fragment) ||
+          executor->skipFragmentJoinKeyBounds(outer_table_desc, fragment);
+    }
     if (skip_frag.first) {
+      ++num_skipped_outer_fragments_;
       continue;
     }
     rowid_lookup_key_ = std::max(rowid_lookup_key_, skip_frag.second);
@@ -338,7 +352,14 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
       skip_frag = executor->skipFragmentInnerJoins(
           outer_table_desc, ra_exe_unit, fragment, frag_offsets, outer_frag_id);
     }
+    if (skip_frag == std::pair<bool, int64_t>(false, -1)) {
+      skip_frag.first =
+          executor->skipFragmentGeoBounds(outer_table_desc, ra_exe_unit, fragment) ||
+          executor->skipFragmentSpatialIndex(outer_table_desc, ra_exe_unit, fragment) ||
+          executor->skipFragmentJoinKeyBounds(outer_table_desc, fragment);
+    }
     if (skip_frag.first) {
+      ++num_skipped_outer_fragments_;
       continue;
     }
     const int device_id =
@@ -140,10 +140,14 @@ class QueryFragmentDescriptor {
     return rowid_lookup_key_ < 0 && !execution_kernels_per_device_.empty();
   }
 
+  // outer table fragments which the kernel map left out based on their metadata
+  size_t getNumSkippedOuterFragments() const { return num_skipped_outer_fragments_; }
+
  protected:
   std::vector<size_t> allowed_outer_fragment_indices_;
   size_t outer_fragments_size_ = 0;
   int64_t rowid_lookup_key_ = -1;
+  size_t num_skipped_outer_fragments_ = 0;
 
   std::map<int, const TableFragments*> selected_tables_fragments_;
 
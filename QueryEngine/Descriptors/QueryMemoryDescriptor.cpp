@@ -143,7 +143,7 @@ int8_t pick_baseline_key_width(const RelAlgExecutionUnit& ra_exe_unit,
 }
 
 bool use_streaming_top_n(const RelAlgExecutionUnit& ra_exe_unit,
-                         const bool output_columnar) {
+                         const ExecutorDeviceType device_type) {
   if (g_cluster) {
     return false;  // TODO(miyu)
   }
@@ -157,24 +157,25 @@ bool use_streaming_top_n(const RelAlgExecutionUnit& ra_exe_unit,
     }
   }
 
-  // TODO: Allow streaming top n for columnar output
-  if (!output_columnar && ra_exe_unit.sort_info.order_entries.size() == 1 &&
-      ra_exe_unit.sort_info.limit &&
-      ra_exe_unit.sort_info.algorithm == SortAlgorithm::StreamingTopN) {
-    const auto only_order_entry = ra_exe_unit.sort_info.order_entries.front();
-    CHECK_GT(only_order_entry.tle_no, int(0));
-    CHECK_LE(static_cast<size_t>(only_order_entry.tle_no),
-             ra_exe_unit.target_exprs.size());
-    const auto order_entry_expr = ra_exe_unit.target_exprs[only_order_entry.tle_no - 1];
-    const auto n = ra_exe_unit.sort_info.offset + ra_exe_unit.sort_info.limit;
-    if ((order_entry_expr->get_type_info().is_number() ||
-         order_entry_expr->get_type_info().is_time()) &&
-        n <= 100000) {  // TODO(miyu): relax?
-      return true;
+  const auto& order_entries = ra_exe_unit.sort_info.order_entries;
+  // the heaps are row-wise, a columnar output hint is overridden by the caller; keys
+  // made of several columns are only compared by the CPU runtime
+  if (order_entries.empty() ||
+      (order_entries.size() > 1 && device_type != ExecutorDeviceType::CPU) ||
+      !ra_exe_unit.sort_info.limit ||
+      ra_exe_unit.sort_info.algorithm != SortAlgorithm::StreamingTopN) {
+    return false;
+  }
+  for (const auto& order_entry : order_entries) {
+    CHECK_GT(order_entry.tle_no, int(0));
+    CHECK_LE(static_cast<size_t>(order_entry.tle_no), ra_exe_unit.target_exprs.size());
+    const auto& oe_ti = ra_exe_unit.target_exprs[order_entry.tle_no - 1]->get_type_info();
+    if (!oe_ti.is_number() && !oe_ti.is_time()) {
+      return false;
     }
   }
-
-  return false;
+  const auto n = ra_exe_unit.sort_info.offset + ra_exe_unit.sort_info.limit;
+  return n <= 100000;  // TODO(miyu): relax?
 }
 
 }  // namespace
@@ -325,8 +326,10 @@ std::unique_ptr<QueryMemoryDescriptor> QueryMemoryDescriptor::init(
     case QueryDescriptionType::Projection: {
       CHECK(!must_use_baseline_sort);
 
-      if (streaming_top_n_hint && use_streaming_top_n(ra_exe_unit, output_columnar)) {
+      if (streaming_top_n_hint && use_streaming_top_n(ra_exe_unit, device_type)) {
         streaming_top_n = true;
+        // the output has at most n rows, no point in a columnar layout for it
+        output_columnar = false;
         entry_count = ra_exe_unit.sort_info.offset + ra_exe_unit.sort_info.limit;
       } else {
         if (ra_exe_unit.use_bump_allocator) {
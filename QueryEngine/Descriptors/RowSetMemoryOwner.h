@@ -18,6 +18,7 @@
 
 #include <boost/noncopyable.hpp>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
@@ -25,8 +26,10 @@
 #include <vector>
 
 #include "DataMgr/AbstractBuffer.h"
+#include "QueryEngine/CountDistinctSets.h"
 #include "Shared/ArenaAllocator.h"
 #include "Shared/Logger.h"
+#include "Shared/TDigest.h"
 #include "StringDictionary/StringDictionaryProxy.h"
 
 class ResultSet;
@@ -64,9 +67,25 @@ class RowSetMemoryOwner : boost::noncopyable {
         CountDistinctBitmapBuffer{count_distinct_buffer, bytes, physical_buffer});
   }
 
-  void addCountDistinctSet(std::set<int64_t>* count_distinct_set) {
+  // The set and its slots live in the arena, and are released along with it.
+  CountDistinctHashSet* allocateCountDistinctHashSet() {
+    CHECK(allocator_);
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    return new (allocator_->allocate(sizeof(CountDistinctHashSet)))
+        CountDistinctHashSet(this);
+  }
+
+  CountDistinctSparseBitmap* allocateCountDistinctSparseBitmap() {
     std::lock_guard<std::mutex> lock(state_mutex_);
-    count_distinct_sets_.push_back(count_distinct_set);
+    count_distinct_sparse_bitmaps_.emplace_back(
+        std::make_unique<CountDistinctSparseBitmap>());
+    return count_distinct_sparse_bitmaps_.back().get();
+  }
+
+  TDigest* allocateTDigest(const double q) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    t_digests_.emplace_back(std::make_unique<TDigest>(q));
+    return t_digests_.back().get();
   }
 
   void addGroupByBuffer(int64_t* group_by_buffer) {
@@ -143,9 +162,6 @@ class RowSetMemoryOwner : boost::noncopyable {
   }
 
   ~RowSetMemoryOwner() {
-    for (auto count_distinct_set : count_distinct_sets_) {
-      delete count_distinct_set;
-    }
     for (auto group_by_buffer : group_by_buffers_) {
       free(group_by_buffer);
     }
@@ -176,7 +192,8 @@ class RowSetMemoryOwner : boost::noncopyable {
   };
 
   std::vector<CountDistinctBitmapBuffer> count_distinct_bitmaps_;
-  std::vector<std::set<int64_t>*> count_distinct_sets_;
+  std::vector<std::unique_ptr<CountDistinctSparseBitmap>> count_distinct_sparse_bitmaps_;
+  std::vector<std::unique_ptr<TDigest>> t_digests_;
   std::vector<int64_t*> group_by_buffers_;
   std::vector<void*> varlen_buffers_;
   std::list<std::string> strings_;
@@ -48,6 +48,7 @@
 #include "Shared/SystemParameters.h"
 #include "Shared/TypedDataAccessors.h"
 #include "Shared/checked_alloc.h"
+#include "Shared/geo_compression.h"
 #include "Shared/measure.h"
 #include "Shared/misc.h"
 #include "Shared/scope.h"
@@ -59,6 +60,7 @@
 #include "StringDictionaryGenerations.h"
 
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 
@@ -68,6 +70,7 @@
 #include <future>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <set>
 #include <thread>
 
@@ -92,11 +95,16 @@ bool g_enable_overlaps_hashjoin{false};
 bool g_enable_hashjoin_many_to_many{false};
 bool g_cache_string_hash{false};
 size_t g_overlaps_max_table_size_bytes{1024 * 1024 * 1024};
+size_t g_hash_join_radix_partition_threshold{32 * 1024 * 1024};
+bool g_enable_join_runtime_filters{true};
+bool g_enable_geo_fragment_skipping{true};
 bool g_strip_join_covered_quals{false};
 size_t g_constrained_by_in_threshold{10};
 size_t g_big_group_threshold{20000};
+size_t g_reduction_radix_partition_threshold{32 * 1024 * 1024};
 bool g_enable_window_functions{true};
 bool g_enable_table_functions{false};
+size_t g_table_function_min_slice_rows{100000};
 size_t g_max_memory_allocation_size{2000000000};  // set to max slab size
 size_t g_min_memory_allocation_size{
     256};  // minimum memory allocation required for projection query output buffer
@@ -104,8 +112,10 @@ size_t g_min_memory_allocation_size{
 bool g_enable_bump_allocator{false};
 double g_bump_allocator_step_reduction{0.75};
 bool g_enable_direct_columnarization{true};
+bool g_enable_top_n_pruning{true};
 extern bool g_enable_experimental_string_functions;
 bool g_enable_runtime_query_interrupt{false};
+bool g_enable_query_profile{false};
 unsigned g_runtime_query_interrupt_frequency{1000};
 size_t g_gpu_smem_threshold{
     4096};  // GPU shared memory threshold (in bytes), if larger
@@ -882,6 +892,17 @@ ResultSetPtr Executor::reduceMultiDeviceResults(
         targets, ExecutorDeviceType::CPU, QueryMemoryDescriptor(), nullptr, this);
   }
 
+  const auto& sort_info = ra_exe_unit.sort_info;
+  if (g_enable_top_n_pruning && !g_cluster && sort_info.order_entries.size() == 1 &&
+      sort_info.limit) {
+    std::vector<ResultSet*> result_sets;
+    for (const auto& result : results_per_device) {
+      result_sets.push_back(result.first.get());
+    }
+    ResultSetManager::pruneTopNGroups(
+        result_sets, sort_info.order_entries.front(), sort_info.limit + sort_info.offset);
+  }
+
   return reduceMultiDeviceResultSets(
       results_per_device,
       row_set_mem_owner,
@@ -1347,6 +1368,7 @@ ResultSetPtr Executor::executeWorkUnitImpl(
         std::lock_guard<std::mutex> compilation_lock(compilation_mutex_);
         compilation_queue_time_ms_ += timer_stop(clock_begin);
 
+        const auto compilation_clock_begin = timer_start();
         std::tie(query_comp_desc_owned, query_mem_desc_owned) =
             execution_dispatch.compile(max_groups_buffer_entry_guess,
                                        crt_min_byte_width,
@@ -1362,6 +1384,11 @@ ResultSetPtr Executor::executeWorkUnitImpl(
                                        column_fetcher,
                                        has_cardinality_estimation);
         CHECK(query_comp_desc_owned);
+        if (query_profile_) {
+          query_profile_->addCompilation(
+              timer_stop<std::chrono::steady_clock::time_point,
+                         std::chrono::microseconds>(compilation_clock_begin));
+        }
         crt_min_byte_width = query_comp_desc_owned->getMinByteWidth();
       } catch (CompilationRetryNoCompaction&) {
         crt_min_byte_width = MAX_BYTE_WIDTH_SUPPORTED;
@@ -1384,7 +1411,8 @@ ResultSetPtr Executor::executeWorkUnitImpl(
       plan_state_->target_exprs_.push_back(target_expr);
     }
 
-    auto dispatch = [&execution_dispatch,
+    auto dispatch = [this,
+                     &execution_dispatch,
                      &column_fetcher,
                      &eo,
                      parent_thread_id = logger::thread_id()](
@@ -1397,6 +1425,7 @@ ResultSetPtr Executor::executeWorkUnitImpl(
                         const int64_t rowid_lookup_key) {
       DEBUG_TIMER_NEW_THREAD(parent_thread_id);
       INJECT_TIMER(execution_dispatch_run);
+      const auto kernel_clock_begin = timer_start();
       execution_dispatch.run(chosen_device_type,
                              chosen_device_id,
                              eo,
@@ -1406,6 +1435,15 @@ ResultSetPtr Executor::executeWorkUnitImpl(
                              frag_list,
                              kernel_dispatch_mode,
                              rowid_lookup_key);
+      if (query_profile_) {
+        CHECK(!frag_list.empty());
+        query_profile_->addKernel(
+            {chosen_device_type,
+             chosen_device_id,
+             frag_list.front().fragment_ids,
+             timer_stop<std::chrono::steady_clock::time_point,
+                        std::chrono::microseconds>(kernel_clock_begin)});
+      }
     };
 
     QueryFragmentDescriptor fragment_descriptor(
@@ -1640,17 +1678,22 @@ void fill_entries_for_empty_input(std::vector<TargetInfo>& target_infos,
         entry.push_back(reinterpret_cast<int64_t>(count_distinct_buffer));
         continue;
       }
-      if (count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet) {
-        auto count_distinct_set = new std::set<int64_t>();
-        CHECK(row_set_mem_owner);
-        row_set_mem_owner->addCountDistinctSet(count_distinct_set);
-        entry.push_back(reinterpret_cast<int64_t>(count_distinct_set));
+      if (count_distinct_desc.impl_type_ == CountDistinctImplType::HashSet) {
+        entry.push_back(
+            reinterpret_cast<int64_t>(row_set_mem_owner->allocateCountDistinctHashSet()));
+        continue;
+      }
+      if (count_distinct_desc.impl_type_ == CountDistinctImplType::SparseBitmap) {
+        entry.push_back(reinterpret_cast<int64_t>(
+            row_set_mem_owner->allocateCountDistinctSparseBitmap()));
         continue;
       }
     }
     const bool float_argument_input = takes_float_argument(agg_info);
     if (agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
       entry.push_back(0);
+    } else if (agg_info.agg_kind == kAPPROX_QUANTILE) {
+      entry.push_back(0);  // no t-digest, read as null
     } else if (agg_info.agg_kind == kAVG) {
       entry.push_back(inline_null_val(agg_info.sql_type, float_argument_input));
       entry.push_back(0);
@@ -1942,6 +1985,10 @@ void Executor::dispatchFragments(
                                              use_multifrag_kernel,
                                              g_inner_join_fragment_skipping,
                                              this);
+  if (query_profile_) {
+    query_profile_->addFragmentsSkipped(
+        fragment_descriptor.getNumSkippedOuterFragments());
+  }
   if (eo.with_watchdog && fragment_descriptor.shouldCheckWorkUnitWatchdog()) {
     checkWorkUnitWatchdog(ra_exe_unit, table_infos, *catalog_, device_type, device_count);
   }
@@ -2690,9 +2737,11 @@ int32_t Executor::executePlanWithoutGroupBy(
       for (int i = 0; i < num_iterations; i++) {
         int64_t val1;
         const bool float_argument_input = takes_float_argument(agg_info);
-        if (is_distinct_target(agg_info)) {
+        if (is_distinct_target(agg_info) || agg_info.agg_kind == kAPPROX_QUANTILE) {
+          // every fragment points to the same set, bitmap or t-digest
           CHECK(agg_info.agg_kind == kCOUNT ||
-                agg_info.agg_kind == kAPPROX_COUNT_DISTINCT);
+                agg_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+                agg_info.agg_kind == kAPPROX_QUANTILE);
           val1 = out_vec[out_vec_idx][0];
           error_code = 0;
         } else {
@@ -2987,6 +3036,7 @@ Executor::JoinHashTableOrError Executor::buildHashTableForQualifier(
     throw QueryExecutionError(ERR_INTERRUPTED);
   }
   try {
+    const auto clock_begin = timer_start();
     auto tbl =
         JoinHashTableInterface::getInstance(qual_bin_oper,
                                             query_infos,
@@ -2995,6 +3045,11 @@ Executor::JoinHashTableOrError Executor::buildHashTableForQualifier(
                                             deviceCountForMemoryLevel(memory_level),
                                             column_cache,
                                             this);
+    if (query_profile_) {
+      query_profile_->addHashTable(
+          timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(
+              clock_begin));
+    }
     return {tbl, ""};
   } catch (const HashJoinFail& e) {
     return {nullptr, e.what()};
@@ -3340,6 +3395,468 @@ std::pair<bool, int64_t> Executor::skipFragmentInnerJoins(
   return skip_frag;
 }
 
+namespace {
+
+// The R-trees and the chunk metadata hold bounding boxes computed either from the
+// compressed coords of the rows or from the coords before compression, the ones of
+// constants are widened to make up for the rounding of the compression.
+constexpr double kBoundingBoxTolerance{1e-5};
+
+bool is_geo_arg_begin(const Analyzer::Expr* arg) {
+  const auto& arg_ti = arg->get_type_info();
+  if (dynamic_cast<const Analyzer::ColumnVar*>(arg)) {
+    return arg_ti.is_geometry();
+  }
+  return dynamic_cast<const Analyzer::Constant*>(arg) && arg_ti.get_type() == kARRAY &&
+         arg_ti.get_subtype() == kTINYINT;
+}
+
+// Returns the first argument of each geometry of a binary geo function call, or an
+// empty vector for geometries transformed to another SRID.
+std::vector<const Analyzer::Expr*> get_binary_geo_function_args(
+    const Analyzer::FunctionOper* func_oper) {
+  // compression and SRID of both inputs, then the output SRID
+  constexpr size_t num_trailing_args{5};
+  if (func_oper->getArity() < num_trailing_args + 2) {
+    return {};
+  }
+  const size_t num_geo_args = func_oper->getArity() - num_trailing_args;
+  std::vector<int32_t> trailing_args;
+  for (size_t i = num_geo_args; i < func_oper->getArity(); ++i) {
+    const auto int_const = dynamic_cast<const Analyzer::Constant*>(func_oper->getArg(i));
+    if (!int_const || int_const->get_type_info().get_type() != kINT) {
+      return {};
+    }
+    trailing_args.push_back(int_const->get_constval().intval);
+  }
+  if (trailing_args[1] != trailing_args[4] || trailing_args[3] != trailing_args[4] ||
+      !is_geo_arg_begin(func_oper->getArg(0))) {
+    return {};
+  }
+  for (size_t i = 1; i < num_geo_args; ++i) {
+    if (is_geo_arg_begin(func_oper->getArg(i))) {
+      return {func_oper->getArg(0), func_oper->getArg(i)};
+    }
+  }
+  return {};
+}
+
+// Returns the first argument of each geometry of an ST_Contains or ST_Intersects call,
+// both only hold for a pair of rows whose bounding boxes intersect. Returns an empty
+// vector for other expressions and for geometries transformed to another SRID.
+std::vector<const Analyzer::Expr*> get_spatial_predicate_geo_args(
+    const Analyzer::Expr* qual) {
+  const auto func_oper = dynamic_cast<const Analyzer::FunctionOper*>(qual);
+  if (!func_oper) {
+    return {};
+  }
+  const auto func_name = func_oper->getName();
+  if (!boost::algorithm::starts_with(func_name, "ST_Contains_") &&
+      !boost::algorithm::starts_with(func_name, "ST_Intersects_")) {
+    return {};
+  }
+  return get_binary_geo_function_args(func_oper);
+}
+
+std::optional<FragmentSpatialIndex::BoundingBox> get_literal_bounding_box(
+    const Analyzer::Constant* coords) {
+  if (coords->get_is_null()) {
+    return std::nullopt;
+  }
+  std::vector<int8_t> compressed_coords;
+  for (const auto& value : coords->get_value_list()) {
+    const auto byte_const = dynamic_cast<const Analyzer::Constant*>(value.get());
+    CHECK(byte_const);
+    compressed_coords.push_back(byte_const->get_constval().tinyintval);
+  }
+  const auto decompressed_coords = geospatial::decompress_coords<double, SQLTypeInfo>(
+      coords->get_type_info(), compressed_coords.data(), compressed_coords.size());
+  if (decompressed_coords->size() < 2) {
+    return std::nullopt;
+  }
+  double min_x{std::numeric_limits<double>::max()};
+  double min_y{std::numeric_limits<double>::max()};
+  double max_x{std::numeric_limits<double>::lowest()};
+  double max_y{std::numeric_limits<double>::lowest()};
+  for (size_t i = 0; i + 1 < decompressed_coords->size(); i += 2) {
+    min_x = std::min(min_x, (*decompressed_coords)[i]);
+    max_x = std::max(max_x, (*decompressed_coords)[i]);
+    min_y = std::min(min_y, (*decompressed_coords)[i + 1]);
+    max_y = std::max(max_y, (*decompressed_coords)[i + 1]);
+  }
+  using Point = FragmentSpatialIndex::Point;
+  return FragmentSpatialIndex::BoundingBox(
+      Point(min_x - kBoundingBoxTolerance, min_y - kBoundingBoxTolerance),
+      Point(max_x + kBoundingBoxTolerance, max_y + kBoundingBoxTolerance));
+}
+
+}  // namespace
+
+/*
+ *   The skipFragmentSpatialIndex looks for ST_Contains and ST_Intersects calls among the
+ * conjunctive quals of the execution unit and of its inner joins which have an argument
+ * with a spatial index on a column of the table. The fragment is skipped if the
+ * bounding box of none of its rows intersects:
+ *   - the one of the other argument, for a literal geometry
+ *   - the one of any row of the other argument, for a column of an inner table with a
+ *     spatial index as well
+ * Only the fragments of the outer table are passed here, the inner tables of a join are
+ * never pruned.
+ *
+ * TODO: use the trees of an indexed inner column as the prebuilt inner side of an
+ * overlaps join, instead of building and auto-tuning an OverlapsJoinHashTable per query.
+ */
+bool Executor::skipFragmentSpatialIndex(
+    const InputDescriptor& table_desc,
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const Fragmenter_Namespace::FragmentInfo& fragment) {
+  const int table_id = table_desc.getTableId();
+  if (table_id <= 0) {
+    return false;
+  }
+  CHECK(catalog_);
+  std::list<std::shared_ptr<Analyzer::Expr>> quals(ra_exe_unit.quals);
+  for (const auto& join_condition : ra_exe_unit.join_quals) {
+    if (join_condition.type == JoinType::INNER) {
+      quals.insert(quals.end(), join_condition.quals.begin(), join_condition.quals.end());
+    }
+  }
+  for (const auto& qual : quals) {
+    const auto geo_args = get_spatial_predicate_geo_args(qual.get());
+    if (geo_args.empty()) {
+      continue;
+    }
+    for (size_t i = 0; i < geo_args.size(); ++i) {
+      const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(geo_args[i]);
+      if (!col_var || col_var->get_table_id() != table_id ||
+          col_var->get_rte_idx() != table_desc.getNestLevel()) {
+        continue;
+      }
+      const auto index = catalog_->getSpatialIndex(table_id, col_var->get_column_id());
+      if (!index) {
+        continue;
+      }
+      const auto other_arg = geo_args[1 - i];
+      if (const auto literal = dynamic_cast<const Analyzer::Constant*>(other_arg)) {
+        const auto bounding_box = get_literal_bounding_box(literal);
+        if (bounding_box &&
+            !catalog_->getFragmentSpatialIndex(*index, fragment)->intersects(
+                *bounding_box)) {
+          VLOG(1) << "Skipping fragment " << fragment.fragmentId << " of table "
+                  << table_id << " using spatial index " << index->index_name;
+          return true;
+        }
+        continue;
+      }
+      const auto inner_col_var = dynamic_cast<const Analyzer::ColumnVar*>(other_arg);
+      CHECK(inner_col_var);
+      if (table_desc.getNestLevel() != 0 || inner_col_var->get_rte_idx() == 0 ||
+          inner_col_var->get_table_id() <= 0) {
+        continue;
+      }
+      const auto inner_index = catalog_->getSpatialIndex(inner_col_var->get_table_id(),
+                                                         inner_col_var->get_column_id());
+      if (!inner_index) {
+        continue;
+      }
+      const auto fragment_index = catalog_->getFragmentSpatialIndex(*index, fragment);
+      bool has_match{false};
+      for (const auto& inner_fragment :
+           getTableInfo(inner_col_var->get_table_id()).fragments) {
+        if (fragment_index->intersects(
+                *catalog_->getFragmentSpatialIndex(*inner_index, inner_fragment))) {
+          has_match = true;
+          break;
+        }
+      }
+      if (!has_match) {
+        VLOG(1) << "Skipping fragment " << fragment.fragmentId << " of table "
+                << table_id << " using spatial indexes " << index->index_name << " and "
+                << inner_index->index_name;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+namespace {
+
+std::optional<double> get_numeric_constant(const Analyzer::Expr* expr) {
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+  if (!constant || constant->get_is_null()) {
+    return std::nullopt;
+  }
+  const auto& ti = constant->get_type_info();
+  const auto& datum = constant->get_constval();
+  switch (ti.get_type()) {
+    case kDOUBLE:
+      return datum.doubleval;
+    case kFLOAT:
+      return datum.floatval;
+    case kTINYINT:
+      return datum.tinyintval;
+    case kSMALLINT:
+      return datum.smallintval;
+    case kINT:
+      return datum.intval;
+    case kBIGINT:
+      return datum.bigintval;
+    default:
+      return std::nullopt;
+  }
+}
+
+SQLOps commute_comparison(const SQLOps op) {
+  switch (op) {
+    case kLT:
+      return kGT;
+    case kLE:
+      return kGE;
+    case kGT:
+      return kLT;
+    case kGE:
+      return kLE;
+    default:
+      return op;
+  }
+}
+
+// Returns whether no value in [min_value, max_value] compares true to the constant.
+bool is_range_excluded(const SQLOps op,
+                       const double min_value,
+                       const double max_value,
+                       const double value) {
+  switch (op) {
+    case kLT:
+      return min_value >= value;
+    case kLE:
+      return min_value > value;
+    case kGT:
+      return max_value <= value;
+    case kGE:
+      return max_value < value;
+    case kEQ:
+      return value < min_value || value > max_value;
+    default:
+      return false;
+  }
+}
+
+double get_bounding_box_distance(const ChunkBoundingBox& chunk_box,
+                                 const FragmentSpatialIndex::BoundingBox& other_box) {
+  const double dx = std::max({0.,
+                              other_box.min_corner().get<0>() - chunk_box.max_x,
+                              chunk_box.min_x - other_box.max_corner().get<0>()});
+  const double dy = std::max({0.,
+                              other_box.min_corner().get<1>() - chunk_box.max_y,
+                              chunk_box.min_y - other_box.max_corner().get<1>()});
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+}  // namespace
+
+/*
+ *   The skipFragmentGeoBounds looks for predicates on geo columns of the table among the
+ * conjunctive quals of the execution unit and of its inner joins, and skips the fragment
+ * when the bounding box of the chunk of the column can't satisfy any of them:
+ *   - ST_Contains and ST_Intersects with a literal geometry whose bounding box doesn't
+ *     intersect the one of the chunk
+ *   - comparisons of ST_X or ST_Y of a point column to a constant out of the range of
+ *     the chunk
+ *   - ST_Distance to a literal geometry (and ST_DWithin, which is translated to it) less
+ *     than a constant smaller than the distance between the bounding boxes
+ * Geodesic distances are left alone, the chunk boxes hold cartesian coords.
+ */
+bool Executor::skipFragmentGeoBounds(const InputDescriptor& table_desc,
+                                     const RelAlgExecutionUnit& ra_exe_unit,
+                                     const Fragmenter_Namespace::FragmentInfo& fragment) {
+  const int table_id = table_desc.getTableId();
+  if (!g_enable_geo_fragment_skipping || table_id <= 0) {
+    return false;
+  }
+  CHECK(catalog_);
+  const auto get_chunk_bounding_box =
+      [&](const Analyzer::Expr* expr) -> std::optional<ChunkBoundingBox> {
+    const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr);
+    if (!col_var || col_var->get_table_id() != table_id ||
+        col_var->get_rte_idx() != table_desc.getNestLevel()) {
+      return std::nullopt;
+    }
+    const auto& geo_ti = col_var->get_type_info();
+    if (!geo_ti.is_geometry() || (geo_ti.get_type() != kPOINT && !geo_ti.has_bounds())) {
+      return std::nullopt;
+    }
+    const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+    const auto chunk_meta_it = chunk_metadata_map.find(
+        get_bounding_box_column_id(geo_ti, col_var->get_column_id()));
+    if (chunk_meta_it == chunk_metadata_map.end() ||
+        !chunk_meta_it->second->boundingBox) {
+      return std::nullopt;
+    }
+    auto chunk_box = *chunk_meta_it->second->boundingBox;
+    chunk_box.min_x -= kBoundingBoxTolerance;
+    chunk_box.min_y -= kBoundingBoxTolerance;
+    chunk_box.max_x += kBoundingBoxTolerance;
+    chunk_box.max_y += kBoundingBoxTolerance;
+    return chunk_box;
+  };
+  const auto get_column_and_literal_boxes = [&](const std::vector<const Analyzer::Expr*>&
+                                                    geo_args)
+      -> std::optional<std::pair<ChunkBoundingBox, FragmentSpatialIndex::BoundingBox>> {
+    for (size_t i = 0; i < geo_args.size(); ++i) {
+      const auto chunk_box = get_chunk_bounding_box(geo_args[i]);
+      const auto literal = dynamic_cast<const Analyzer::Constant*>(geo_args[1 - i]);
+      if (!chunk_box || !literal) {
+        continue;
+      }
+      const auto literal_box = get_literal_bounding_box(literal);
+      if (literal_box) {
+        return std::make_pair(*chunk_box, *literal_box);
+      }
+    }
+    return std::nullopt;
+  };
+
+  std::list<std::shared_ptr<Analyzer::Expr>> quals(ra_exe_unit.quals);
+  for (const auto& join_condition : ra_exe_unit.join_quals) {
+    if (join_condition.type == JoinType::INNER) {
+      quals.insert(quals.end(), join_condition.quals.begin(), join_condition.quals.end());
+    }
+  }
+  for (const auto& qual : quals) {
+    const auto geo_args = get_spatial_predicate_geo_args(qual.get());
+    if (!geo_args.empty()) {
+      const auto boxes = get_column_and_literal_boxes(geo_args);
+      if (boxes && get_bounding_box_distance(boxes->first, boxes->second) > 0) {
+        VLOG(1) << "Skipping fragment " << fragment.fragmentId << " of table "
+                << table_id << " on the bounding box of a geo column";
+        return true;
+      }
+      continue;
+    }
+    const auto comp_expr = dynamic_cast<const Analyzer::BinOper*>(qual.get());
+    if (!comp_expr || !IS_COMPARISON(comp_expr->get_optype())) {
+      continue;
+    }
+    auto op = comp_expr->get_optype();
+    auto func_oper =
+        dynamic_cast<const Analyzer::FunctionOper*>(comp_expr->get_left_operand());
+    auto value = get_numeric_constant(comp_expr->get_right_operand());
+    if (!func_oper) {
+      func_oper =
+          dynamic_cast<const Analyzer::FunctionOper*>(comp_expr->get_right_operand());
+      value = get_numeric_constant(comp_expr->get_left_operand());
+      op = commute_comparison(op);
+    }
+    if (!func_oper || !value) {
+      continue;
+    }
+    const auto func_name = func_oper->getName();
+    if (func_name == "ST_X_Point" || func_name == "ST_Y_Point") {
+      // the point, its compression, input SRID and output SRID
+      if (func_oper->getArity() != 4) {
+        continue;
+      }
+      const auto input_srid =
+          dynamic_cast<const Analyzer::Constant*>(func_oper->getArg(2));
+      const auto output_srid =
+          dynamic_cast<const Analyzer::Constant*>(func_oper->getArg(3));
+      if (!input_srid || !output_srid ||
+          input_srid->get_constval().intval != output_srid->get_constval().intval) {
+        continue;
+      }
+      const auto chunk_box = get_chunk_bounding_box(func_oper->getArg(0));
+      if (!chunk_box) {
+        continue;
+      }
+      const bool is_x = func_name == "ST_X_Point";
+      if (is_range_excluded(op,
+                            is_x ? chunk_box->min_x : chunk_box->min_y,
+                            is_x ? chunk_box->max_x : chunk_box->max_y,
+                            *value)) {
+        VLOG(1) << "Skipping fragment " << fragment.fragmentId << " of table "
+                << table_id << " on the bounding box of a geo column";
+        return true;
+      }
+      continue;
+    }
+    if (boost::algorithm::starts_with(func_name, "ST_Distance_") &&
+        !boost::algorithm::ends_with(func_name, "_Geodesic") &&
+        (op == kLT || op == kLE)) {
+      const auto boxes =
+          get_column_and_literal_boxes(get_binary_geo_function_args(func_oper));
+      if (!boxes) {
+        continue;
+      }
+      auto distance = get_bounding_box_distance(boxes->first, boxes->second);
+      if (boost::algorithm::ends_with(func_name, "_Squared")) {
+        distance *= distance;
+      }
+      if (is_range_excluded(op, distance, distance, *value)) {
+        VLOG(1) << "Skipping fragment " << fragment.fragmentId << " of table "
+                << table_id << " on the bounding box of a geo column";
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/*
+ *   The skipFragmentJoinKeyBounds skips a fragment of the outer table when the range of
+ * the join key of one of the inner hash joins in the fragment is out of the bounds of
+ * the keys in the built hash table: no row of the fragment can find a match. Only
+ * integer and decimal keys are checked, their chunk metadata holds the values as stored.
+ */
+bool Executor::skipFragmentJoinKeyBounds(
+    const InputDescriptor& table_desc,
+    const Fragmenter_Namespace::FragmentInfo& fragment) {
+  if (!g_enable_join_runtime_filters || !plan_state_ || table_desc.getTableId() <= 0) {
+    return false;
+  }
+  CHECK(catalog_);
+  const auto& join_info = plan_state_->join_info_;
+  CHECK_EQ(join_info.join_hash_tables_.size(), join_info.equi_join_tautologies_.size());
+  for (const auto table_idx : join_info.inner_join_table_indices_) {
+    CHECK_LT(table_idx, join_info.join_hash_tables_.size());
+    const auto key_bounds = join_info.join_hash_tables_[table_idx]->getKeyBounds();
+    const auto& qual_bin_oper = join_info.equi_join_tautologies_[table_idx];
+    if (!key_bounds || qual_bin_oper->get_optype() != kEQ) {
+      continue;
+    }
+    const auto inner_outer = normalize_column_pair(qual_bin_oper->get_left_operand(),
+                                                   qual_bin_oper->get_right_operand(),
+                                                   *catalog_,
+                                                   getTemporaryTables());
+    const auto outer_col = dynamic_cast<const Analyzer::ColumnVar*>(inner_outer.second);
+    if (!outer_col || outer_col->get_table_id() != table_desc.getTableId() ||
+        outer_col->get_rte_idx() != table_desc.getNestLevel()) {
+      continue;
+    }
+    const auto& outer_ti = outer_col->get_type_info();
+    if (!outer_ti.is_integer() && !outer_ti.is_decimal()) {
+      continue;
+    }
+    const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+    const auto chunk_meta_it = chunk_metadata_map.find(outer_col->get_column_id());
+    if (chunk_meta_it == chunk_metadata_map.end()) {
+      continue;
+    }
+    const auto& chunk_stats = chunk_meta_it->second->chunkStats;
+    const auto chunk_min = extract_min_stat(chunk_stats, outer_ti);
+    const auto chunk_max = extract_max_stat(chunk_stats, outer_ti);
+    if (key_bounds->first > key_bounds->second || chunk_max < key_bounds->first ||
+        chunk_min > key_bounds->second) {
+      VLOG(1) << "Skipping fragment " << fragment.fragmentId << " of table "
+              << table_desc.getTableId() << ", no key of the hash table for "
+              << qual_bin_oper->toString() << " in it";
+      return true;
+    }
+  }
+  return false;
+}
+
 AggregatedColRange Executor::computeColRangesCache(
     const std::unordered_set<PhysicalInput>& phys_inputs) {
   AggregatedColRange agg_col_range_cache;
@@ -30,6 +30,7 @@
 #include "LoopControlFlow/JoinLoop.h"
 #include "NvidiaKernel.h"
 #include "PlanState.h"
+#include "QueryProfile.h"
 #include "RelAlgExecutionUnit.h"
 #include "RelAlgTranslator.h"
 #include "StringDictionaryGenerations.h"
@@ -372,6 +373,9 @@ class Executor {
 
   const TemporaryTables* getTemporaryTables() const;
 
+  // The profile of the running query, if it is collected.
+  QueryProfile* getQueryProfile() const { return query_profile_; }
+
   Fragmenter_Namespace::TableInfo getTableInfo(const int table_id) const;
 
   const TableGeneration& getTableGeneration(const int table_id) const;
@@ -883,6 +887,17 @@ class Executor {
       const std::vector<uint64_t>& frag_offsets,
       const size_t frag_idx);
 
+  bool skipFragmentSpatialIndex(const InputDescriptor& table_desc,
+                                const RelAlgExecutionUnit& ra_exe_unit,
+                                const Fragmenter_Namespace::FragmentInfo& fragment);
+
+  bool skipFragmentGeoBounds(const InputDescriptor& table_desc,
+                             const RelAlgExecutionUnit& ra_exe_unit,
+                             const Fragmenter_Namespace::FragmentInfo& fragment);
+
+  bool skipFragmentJoinKeyBounds(const InputDescriptor& table_desc,
+                                 const Fragmenter_Namespace::FragmentInfo& fragment);
+
   AggregatedColRange computeColRangesCache(
       const std::unordered_set<PhysicalInput>& phys_inputs);
   StringDictionaryGenerations computeStringDictionaryGenerations(
@@ -987,6 +1002,7 @@ class Executor {
 
   int64_t kernel_queue_time_ms_ = 0;
   int64_t compilation_queue_time_ms_ = 0;
+  QueryProfile* query_profile_{nullptr};
 
   // Singleton instance used for an execution unit which is a project with window
   // functions.
@@ -668,6 +668,17 @@ class ConstantFoldingVisitor : public DeepCopyVisitor {
     return makeExpr<Analyzer::LowerExpr>(lower_expr->get_own_arg());
   }
 
+  std::shared_ptr<Analyzer::Expr> visitUpper(
+      const Analyzer::UpperExpr* upper_expr) const override {
+    const auto constant_arg_expr =
+        dynamic_cast<const Analyzer::Constant*>(upper_expr->get_arg());
+    if (constant_arg_expr) {
+      return Parser::StringLiteral::analyzeValue(
+          boost::locale::to_upper(*constant_arg_expr->get_constval().stringval));
+    }
+    return makeExpr<Analyzer::UpperExpr>(upper_expr->get_own_arg());
+  }
+
  protected:
   mutable std::unordered_map<const Analyzer::Expr*, const SQLTypeInfo> casts_;
   mutable int32_t num_overflows_;
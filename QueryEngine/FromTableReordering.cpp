@@ -19,7 +19,9 @@
 #include "Execute.h"
 #include "RangeTableIndexVisitor.h"
 
+#include <limits>
 #include <numeric>
+#include <optional>
 #include <queue>
 #include <regex>
 
@@ -28,6 +30,20 @@ namespace {
 using cost_t = unsigned;
 using node_t = size_t;
 
+// The cost of entering a nest level through the join qualifiers with another one, and
+// the number of its rows estimated to match each row of the other one.
+struct JoinEdgeCost {
+  cost_t qual_cost;
+  double fan_out;
+
+  bool operator<(const JoinEdgeCost& that) const {
+    return qual_cost != that.qual_cost ? qual_cost < that.qual_cost
+                                       : fan_out < that.fan_out;
+  }
+};
+
+using JoinCostGraph = std::vector<std::map<node_t, JoinEdgeCost>>;
+
 static std::unordered_map<SQLTypes, cost_t> GEO_TYPE_COSTS{{kPOINT, 60},
                                                            {kLINESTRING, 70},
                                                            {kPOLYGON, 80},
@@ -72,13 +88,259 @@ std::pair<cost_t, cost_t> get_join_qual_cost(const Analyzer::Expr* qual,
   return {100, 100};
 }
 
-// Builds a graph with nesting levels as nodes and join condition costs as edges.
-std::vector<std::map<node_t, cost_t>> build_join_cost_graph(
+const Analyzer::ColumnVar* get_column_var(const Analyzer::Expr* expr) {
+  const auto uoper = dynamic_cast<const Analyzer::UOper*>(expr);
+  if (uoper && uoper->get_optype() == kCAST &&
+      uoper->get_type_info().is_integer() &&
+      uoper->get_operand()->get_type_info().is_integer()) {
+    expr = uoper->get_operand();
+  }
+  return dynamic_cast<const Analyzer::ColumnVar*>(expr);
+}
+
+// Returns the value of a constant in the domain column statistics are kept in.
+std::optional<double> get_constant_value(const Analyzer::Expr* expr) {
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+  if (!constant || constant->get_is_null()) {
+    return std::nullopt;
+  }
+  const auto& ti = constant->get_type_info();
+  const auto datum = constant->get_constval();
+  switch (ti.get_type()) {
+    case kFLOAT:
+      return datum.floatval;
+    case kDOUBLE:
+      return datum.doubleval;
+    case kBOOLEAN:
+    case kTINYINT:
+    case kSMALLINT:
+    case kINT:
+    case kBIGINT:
+    case kDECIMAL:
+    case kNUMERIC:
+    case kTIME:
+    case kTIMESTAMP:
+    case kDATE:
+      return extract_from_datum(datum, ti);
+    default:
+      return std::nullopt;
+  }
+}
+
+std::shared_ptr<const ColumnStatistics> get_column_statistics(
+    const Analyzer::ColumnVar* col_var,
+    const Executor* executor) {
+  if (!col_var || !executor || !executor->getCatalog() ||
+      col_var->get_table_id() < 0) {
+    return nullptr;
+  }
+  return executor->getCatalog()->getColumnStatistics(col_var->get_table_id(),
+                                                     col_var->get_column_id());
+}
+
+SQLOps flip_comparison(const SQLOps optype) {
+  switch (optype) {
+    case kLT:
+      return kGT;
+    case kLE:
+      return kGE;
+    case kGT:
+      return kLT;
+    case kGE:
+      return kLE;
+    default:
+      return optype;
+  }
+}
+
+// Lower and upper bounds accumulated from the range qualifiers on a single column.
+struct ColumnRange {
+  std::shared_ptr<const ColumnStatistics> stats;
+  double lower{-std::numeric_limits<double>::infinity()};
+  double upper{std::numeric_limits<double>::infinity()};
+};
+
+using ColumnRanges = std::map<std::pair<int, int>, ColumnRange>;
+
+// Estimates the fraction of rows which pass a single table qualifier. Range comparisons
+// against constants are accumulated in column_ranges instead, so that both sides of a
+// BETWEEN are evaluated against the histogram together.
+double get_qual_selectivity(const Analyzer::Expr* qual,
+                            const Executor* executor,
+                            ColumnRanges* column_ranges) {
+  const auto in_values = dynamic_cast<const Analyzer::InValues*>(qual);
+  if (in_values) {
+    const auto stats =
+        get_column_statistics(get_column_var(in_values->get_arg()), executor);
+    if (!stats) {
+      return 1.;
+    }
+    double selectivity{0};
+    for (const auto& in_value : in_values->get_value_list()) {
+      const auto value = get_constant_value(in_value.get());
+      selectivity += value ? stats->estimateEqualsSelectivity(*value)
+                           : stats->averageEqualsSelectivity();
+    }
+    return std::min(selectivity, 1.);
+  }
+  const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual);
+  if (!bin_oper) {
+    return 1.;
+  }
+  auto optype = bin_oper->get_optype();
+  if (optype == kAND) {
+    return get_qual_selectivity(bin_oper->get_left_operand(), executor, nullptr) *
+           get_qual_selectivity(bin_oper->get_right_operand(), executor, nullptr);
+  }
+  if (optype == kOR) {
+    const auto lhs_selectivity =
+        get_qual_selectivity(bin_oper->get_left_operand(), executor, nullptr);
+    const auto rhs_selectivity =
+        get_qual_selectivity(bin_oper->get_right_operand(), executor, nullptr);
+    return lhs_selectivity + rhs_selectivity - lhs_selectivity * rhs_selectivity;
+  }
+  if (!IS_COMPARISON(optype)) {
+    return 1.;
+  }
+  auto col_var = get_column_var(bin_oper->get_left_operand());
+  auto const_expr = bin_oper->get_right_operand();
+  if (!col_var) {
+    col_var = get_column_var(bin_oper->get_right_operand());
+    const_expr = bin_oper->get_left_operand();
+    optype = flip_comparison(optype);
+  }
+  if (!dynamic_cast<const Analyzer::Constant*>(const_expr)) {
+    return 1.;
+  }
+  const auto stats = get_column_statistics(col_var, executor);
+  if (!stats) {
+    return 1.;
+  }
+  const auto value = get_constant_value(const_expr);
+  if (!value) {
+    // Dictionary encoded strings: the literal doesn't map to an id, assume uniformity.
+    const auto equals_selectivity = stats->averageEqualsSelectivity();
+    switch (optype) {
+      case kEQ:
+        return equals_selectivity;
+      case kNE:
+        return std::max(stats->minSelectivity(),
+                        1. - stats->null_fraction - equals_selectivity);
+      default:
+        return ColumnStatistics::kDefaultRangeSelectivity;
+    }
+  }
+  switch (optype) {
+    case kEQ:
+      return stats->estimateEqualsSelectivity(*value);
+    case kNE:
+      return std::max(
+          stats->minSelectivity(),
+          1. - stats->null_fraction - stats->estimateEqualsSelectivity(*value));
+    case kLT:
+    case kLE:
+    case kGT:
+    case kGE: {
+      if (!column_ranges) {
+        return optype == kLT || optype == kLE
+                   ? stats->estimateRangeSelectivity(
+                         -std::numeric_limits<double>::infinity(), *value)
+                   : stats->estimateRangeSelectivity(
+                         *value, std::numeric_limits<double>::infinity());
+      }
+      auto& range = (*column_ranges)[std::make_pair(col_var->get_table_id(),
+                                                    col_var->get_column_id())];
+      range.stats = stats;
+      if (optype == kLT || optype == kLE) {
+        range.upper = std::min(range.upper, *value);
+      } else {
+        range.lower = std::max(range.lower, *value);
+      }
+      return 1.;
+    }
+    default:
+      return 1.;
+  }
+}
+
+// Estimates the number of rows of each nest level which survive the single table
+// qualifiers, using the statistics collected by ANALYZE TABLE. Nest levels without
+// statistics keep the number of tuples in the table.
+std::vector<double> estimate_nest_level_cardinalities(
     const JoinQualsPerNestingLevel& left_deep_join_quals,
     const std::vector<InputTableInfo>& table_infos,
     const Executor* executor) {
+  std::vector<double> cardinalities;
+  for (const auto& table_info : table_infos) {
+    cardinalities.push_back(table_info.info.getNumTuplesUpperBound());
+  }
+  if (!executor) {
+    return cardinalities;
+  }
+  std::vector<ColumnRanges> column_ranges(table_infos.size());
+  AllRangeTableIndexVisitor visitor;
+  for (const auto& current_level_join_conditions : left_deep_join_quals) {
+    for (const auto& qual : current_level_join_conditions.quals) {
+      const auto qual_nest_levels = visitor.visit(qual.get());
+      if (qual_nest_levels.size() != 1) {
+        continue;
+      }
+      const auto nest_level = *qual_nest_levels.begin();
+      CHECK_GE(nest_level, 0);
+      CHECK_LT(static_cast<size_t>(nest_level), table_infos.size());
+      cardinalities[nest_level] *=
+          get_qual_selectivity(qual.get(), executor, &column_ranges[nest_level]);
+    }
+  }
+  for (size_t nest_level = 0; nest_level < table_infos.size(); ++nest_level) {
+    for (const auto& column_range : column_ranges[nest_level]) {
+      const auto& range = column_range.second;
+      cardinalities[nest_level] *=
+          range.stats->estimateRangeSelectivity(range.lower, range.upper);
+    }
+    VLOG(1) << "Estimated cardinality for nest level " << nest_level << ": "
+            << cardinalities[nest_level] << " (of "
+            << table_infos[nest_level].info.getNumTuplesUpperBound() << " tuples)";
+  }
+  return cardinalities;
+}
+
+// Returns the number of distinct join keys of an equi-join qualifier between columns,
+// the larger one of both sides, each bounded by the estimated rows of its nest level.
+// Returns no estimate unless both columns have statistics.
+std::optional<double> estimate_join_key_ndv(const Analyzer::Expr* qual,
+                                            const std::vector<double>& cardinalities,
+                                            const Executor* executor) {
+  const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual);
+  if (!bin_oper || !IS_EQUIVALENCE(bin_oper->get_optype())) {
+    return std::nullopt;
+  }
+  double ndv{1};
+  for (const auto operand :
+       {bin_oper->get_left_operand(), bin_oper->get_right_operand()}) {
+    const auto col_var = get_column_var(operand);
+    const auto stats = get_column_statistics(col_var, executor);
+    if (!stats || stats->ndv <= 0) {
+      return std::nullopt;
+    }
+    const auto nest_level = col_var->get_rte_idx();
+    CHECK_GE(nest_level, 0);
+    CHECK_LT(static_cast<size_t>(nest_level), cardinalities.size());
+    ndv = std::max(ndv,
+                   std::min(static_cast<double>(stats->ndv), cardinalities[nest_level]));
+  }
+  return ndv;
+}
+
+// Builds a graph with nesting levels as nodes and join condition costs as edges. The
+// fan out of an edge is the estimated number of rows of the nest level it enters which
+// match a row of the other one, which is 1 without statistics on the join keys.
+JoinCostGraph build_join_cost_graph(const JoinQualsPerNestingLevel& left_deep_join_quals,
+                                    const std::vector<InputTableInfo>& table_infos,
+                                    const std::vector<double>& cardinalities,
+                                    const Executor* executor) {
   CHECK_EQ(left_deep_join_quals.size() + 1, table_infos.size());
-  std::vector<std::map<node_t, cost_t>> join_cost_graph(table_infos.size());
+  JoinCostGraph join_cost_graph(table_infos.size());
   AllRangeTableIndexVisitor visitor;
   // Build the constraints graph: nodes are nest levels, edges are the existence of
   // qualifiers between levels.
@@ -96,11 +358,21 @@ std::vector<std::map<node_t, cost_t>> build_join_cost_graph(
 
       // Get the {lhs, rhs} cost for the qual
       const auto cost_pair = get_join_qual_cost(qual.get(), executor);
+      const auto join_key_ndv =
+          estimate_join_key_ndv(qual.get(), cardinalities, executor);
+      const JoinEdgeCost rhs_cost{
+          cost_pair.second,
+          join_key_ndv ? cardinalities[rhs_nest_level] / *join_key_ndv : 1};
+      const JoinEdgeCost lhs_cost{
+          cost_pair.first,
+          join_key_ndv ? cardinalities[lhs_nest_level] / *join_key_ndv : 1};
+      // Keep the cheapest qual between two levels, the most selective one among quals
+      // of the same cost.
       const auto edge_it = join_cost_graph[lhs_nest_level].find(rhs_nest_level);
       if (edge_it == join_cost_graph[lhs_nest_level].end() ||
-          edge_it->second > cost_pair.second) {
-        join_cost_graph[lhs_nest_level][rhs_nest_level] = cost_pair.second;
-        join_cost_graph[rhs_nest_level][lhs_nest_level] = cost_pair.first;
+          rhs_cost < edge_it->second) {
+        join_cost_graph[lhs_nest_level][rhs_nest_level] = rhs_cost;
+        join_cost_graph[rhs_nest_level][lhs_nest_level] = lhs_cost;
       }
     }
   }
@@ -140,13 +412,13 @@ class SchedulingDependencyTracking {
 // The tree edge for traversal of the cost graph.
 struct TraversalEdge {
   node_t nest_level;
-  cost_t join_cost;
+  JoinEdgeCost join_cost;
 };
 
 // Builds dependency tracking based on left joins and based on geo costs.
 SchedulingDependencyTracking build_dependency_tracking(
     const JoinQualsPerNestingLevel& left_deep_join_quals,
-    const std::vector<std::map<node_t, cost_t>>& join_cost_graph) {
+    const JoinCostGraph& join_cost_graph) {
   SchedulingDependencyTracking dependency_tracking(left_deep_join_quals.size() + 1);
   // Add directed graph edges for left join dependencies.
   // See also start_it inside traverse_join_cost_graph(). These
@@ -164,10 +436,11 @@ SchedulingDependencyTracking build_dependency_tracking(
   for (size_t idx1 = 0; idx1 < join_cost_graph.size(); ++idx1) {
     for (auto& inner_map : join_cost_graph[idx1]) {
       auto& idx2 = inner_map.first;
-      auto& cost_forward = inner_map.second;
+      // only the qual costs, the estimated fan out doesn't constrain the order
+      const auto cost_forward = inner_map.second.qual_cost;
       auto reverse_it = join_cost_graph[idx2].find(idx1);
       CHECK(reverse_it != join_cost_graph[idx2].end());
-      auto& cost_backward = reverse_it->second;
+      const auto cost_backward = reverse_it->second.qual_cost;
       if (cost_forward > cost_backward) {
         dependency_tracking.addEdge(idx1, idx2);
       }
@@ -180,7 +453,7 @@ SchedulingDependencyTracking build_dependency_tracking(
 // before the ones which constraint it are scheduled and it favors equi joins over loop
 // joins.
 std::vector<node_t> traverse_join_cost_graph(
-    const std::vector<std::map<node_t, cost_t>>& join_cost_graph,
+    const JoinCostGraph& join_cost_graph,
     const std::vector<InputTableInfo>& table_infos,
     const std::function<bool(const node_t lhs_nest_level, const node_t rhs_nest_level)>&
         compare_node,
@@ -211,7 +484,7 @@ std::vector<node_t> traverse_join_cost_graph(
     CHECK(start_it != remaining_nest_levels.end());
     std::priority_queue<TraversalEdge, std::vector<TraversalEdge>, decltype(compare_edge)>
         worklist(compare_edge);
-    worklist.push(TraversalEdge{*start_it, 0});
+    worklist.push(TraversalEdge{*start_it, {0, 1}});
     const auto it_ok = visited.insert(*start_it);
     CHECK(it_ok.second);
     while (!worklist.empty()) {
@@ -241,21 +514,28 @@ std::vector<node_t> get_node_input_permutation(
     const JoinQualsPerNestingLevel& left_deep_join_quals,
     const std::vector<InputTableInfo>& table_infos,
     const Executor* executor) {
+  // Use the estimated number of tuples after filtering in each table to break ties in
+  // BFS. The smaller inputs end up on the inner side, where the hash tables are built.
+  const auto cardinalities =
+      estimate_nest_level_cardinalities(left_deep_join_quals, table_infos, executor);
   const auto join_cost_graph =
-      build_join_cost_graph(left_deep_join_quals, table_infos, executor);
-  // Use the number of tuples in each table to break ties in BFS.
-  const auto compare_node = [&table_infos](const node_t lhs_nest_level,
-                                           const node_t rhs_nest_level) {
-    return table_infos[lhs_nest_level].info.getNumTuplesUpperBound() <
-           table_infos[rhs_nest_level].info.getNumTuplesUpperBound();
+      build_join_cost_graph(left_deep_join_quals, table_infos, cardinalities, executor);
+  const auto compare_node = [&cardinalities](const node_t lhs_nest_level,
+                                             const node_t rhs_nest_level) {
+    return cardinalities[lhs_nest_level] < cardinalities[rhs_nest_level];
   };
   const auto compare_edge = [&compare_node](const TraversalEdge& lhs_edge,
                                             const TraversalEdge& rhs_edge) {
-    // Only use the number of tuples as a tie-breaker, if costs are equal.
-    if (lhs_edge.join_cost == rhs_edge.join_cost) {
-      return compare_node(lhs_edge.nest_level, rhs_edge.nest_level);
+    // Among quals of the same cost, join the inputs which match the fewest rows first,
+    // which keeps the intermediate results small. Only use the number of tuples as a
+    // tie-breaker, if those are equal too.
+    if (lhs_edge.join_cost.qual_cost != rhs_edge.join_cost.qual_cost) {
+      return lhs_edge.join_cost.qual_cost < rhs_edge.join_cost.qual_cost;
+    }
+    if (lhs_edge.join_cost.fan_out != rhs_edge.join_cost.fan_out) {
+      return lhs_edge.join_cost.fan_out > rhs_edge.join_cost.fan_out;
     }
-    return lhs_edge.join_cost < rhs_edge.join_cost;
+    return compare_node(lhs_edge.nest_level, rhs_edge.nest_level);
   };
   return traverse_join_cost_graph(
       join_cost_graph, table_infos, compare_node, compare_edge, left_deep_join_quals);
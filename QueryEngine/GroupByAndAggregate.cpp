@@ -31,6 +31,7 @@
 #include "TargetExprBuilder.h"
 
 #include "../CudaMgr/CudaMgr.h"
+#include "../Shared/TDigest.h"
 #include "../Shared/checked_alloc.h"
 #include "../Utils/ChunkIter.h"
 #include "DataMgr/BufferMgr/BufferMgr.h"
@@ -103,6 +104,16 @@ bool has_count_distinct(const RelAlgExecutionUnit& ra_exe_unit) {
   return false;
 }
 
+bool has_approx_quantile(const RelAlgExecutionUnit& ra_exe_unit) {
+  for (const auto& target_expr : ra_exe_unit.target_exprs) {
+    const auto agg_info = get_target_info(target_expr, g_bigint_count);
+    if (agg_info.is_agg && agg_info.agg_kind == kAPPROX_QUANTILE) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool is_column_range_too_big_for_perfect_hash(const ColRangeInfo& col_range_info,
                                               const int64_t max_entry_count) {
   try {
@@ -113,6 +124,28 @@ bool is_column_range_too_big_for_perfect_hash(const ColRangeInfo& col_range_info
   }
 }
 
+// Picks the set for the exact count distinct of an integer argument of which the range
+// is too wide for a bitmap. An array container of a sparse bitmap costs two bytes per
+// value, plus its own overhead, while a hash set slot costs sixteen at the load factor
+// the set keeps, so the sparse bitmap wins once its containers of 2^16 values are
+// expected to hold a few values each. The largest input bounds the number of values.
+CountDistinctImplType choose_count_distinct_set_impl(
+    const ColRangeInfo& arg_range_info,
+    const std::vector<InputTableInfo>& query_infos) {
+  constexpr double kMinValuesPerContainer{8};
+  size_t cardinality_estimate{0};
+  for (const auto& query_info : query_infos) {
+    cardinality_estimate =
+        std::max(cardinality_estimate, query_info.info.getNumTuplesUpperBound());
+  }
+  const auto range =
+      static_cast<double>(arg_range_info.max) - static_cast<double>(arg_range_info.min);
+  const auto container_count = std::max(range / (1 << 16), 1.0);
+  return cardinality_estimate / container_count >= kMinValuesPerContainer
+             ? CountDistinctImplType::SparseBitmap
+             : CountDistinctImplType::HashSet;
+}
+
 }  // namespace
 
 ColRangeInfo GroupByAndAggregate::getColRangeInfo() {
@@ -332,6 +365,8 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
   // For the sake of managing risk, use the new result set way very selectively for
   // this case only (alongside the baseline layout we've enabled for a while now).
   bool must_use_baseline_sort = shard_count;
+  // the t-digests of APPROX_PERCENTILE are only allocated for row-wise buffers
+  const bool output_columnar = output_columnar_hint && !has_approx_quantile(ra_exe_unit_);
   std::unique_ptr<QueryMemoryDescriptor> query_mem_desc;
   while (true) {
     query_mem_desc = initQueryMemoryDescriptorImpl(allow_multifrag,
@@ -340,7 +375,7 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
                                                    sort_on_gpu_hint,
                                                    render_info,
                                                    must_use_baseline_sort,
-                                                   output_columnar_hint);
+                                                   output_columnar);
     CHECK(query_mem_desc);
     if (query_mem_desc->sortOnGpu() &&
         (query_mem_desc->getBufferSizeBytes(device_type_) +
@@ -560,10 +595,10 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
       ColRangeInfo no_range_info{QueryDescriptionType::Projection, 0, 0, 0, false};
       auto arg_range_info =
           arg_ti.is_fp() ? no_range_info : getExprRangeInfo(agg_expr->get_arg());
-      CountDistinctImplType count_distinct_impl_type{CountDistinctImplType::StdSet};
+      CountDistinctImplType count_distinct_impl_type{CountDistinctImplType::HashSet};
       int64_t bitmap_sz_bits{0};
       if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
-        const auto error_rate = agg_expr->get_error_rate();
+        const auto error_rate = agg_expr->get_arg1();
         if (error_rate) {
           CHECK(error_rate->get_type_info().get_type() == kINT);
           CHECK_GE(error_rate->get_constval().intval, 1);
@@ -590,18 +625,21 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
           bitmap_sz_bits = arg_range_info.max - arg_range_info.min + 1;
           const int64_t MAX_BITMAP_BITS{8 * 1000 * 1000 * 1000L};
           if (bitmap_sz_bits <= 0 || bitmap_sz_bits > MAX_BITMAP_BITS) {
-            count_distinct_impl_type = CountDistinctImplType::StdSet;
+            count_distinct_impl_type =
+                bitmap_sz_bits > 0
+                    ? choose_count_distinct_set_impl(arg_range_info, query_infos_)
+                    : CountDistinctImplType::HashSet;
           }
         }
       }
       if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT &&
-          count_distinct_impl_type == CountDistinctImplType::StdSet &&
+          count_distinct_impl_type == CountDistinctImplType::HashSet &&
           !(arg_ti.is_array() || arg_ti.is_geometry())) {
         count_distinct_impl_type = CountDistinctImplType::Bitmap;
       }
 
       if (g_enable_watchdog && !(arg_range_info.isEmpty()) &&
-          count_distinct_impl_type == CountDistinctImplType::StdSet) {
+          count_distinct_impl_type != CountDistinctImplType::Bitmap) {
         throw WatchdogException("Cannot use a fast path for COUNT distinct");
       }
       const auto sub_bitmap_count =
@@ -1013,6 +1051,10 @@ llvm::Value* GroupByAndAggregate::codegenOutputSlot(
   const int32_t row_size_quad = query_mem_desc.didOutputColumnar()
                                     ? 0
                                     : query_mem_desc.getRowSize() / sizeof(int64_t);
+  if (query_mem_desc.useStreamingTopN() &&
+      ra_exe_unit_.sort_info.order_entries.size() > 1) {
+    return codegenCompositeTopNSlot(groups_buffer, query_mem_desc, co, row_size_quad);
+  }
   CodeGenerator code_generator(executor_);
   if (query_mem_desc.useStreamingTopN()) {
     const auto& only_order_entry = ra_exe_unit_.sort_info.order_entries.front();
@@ -1089,6 +1131,80 @@ llvm::Value* GroupByAndAggregate::codegenOutputSlot(
   }
 }
 
+// Passes the keys of a heap ordered by several columns, and how to compare them, to
+// get_bin_from_k_heap_composite as arrays of 64-bit integers on the stack.
+llvm::Value* GroupByAndAggregate::codegenCompositeTopNSlot(
+    llvm::Value* groups_buffer,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const CompilationOptions& co,
+    const int32_t row_size_quad) {
+  CHECK(co.device_type == ExecutorDeviceType::CPU);
+  const auto& order_entries = ra_exe_unit_.sort_info.order_entries;
+  const size_t component_quads =
+      sizeof(streaming_top_n::HeapKeyComponent) / sizeof(int64_t);
+  const auto i64_ty = llvm::Type::getInt64Ty(LL_CONTEXT);
+  auto components_lv = LL_BUILDER.CreateAlloca(
+      i64_ty, LL_INT(static_cast<uint32_t>(order_entries.size() * component_quads)));
+  auto keys_lv = LL_BUILDER.CreateAlloca(
+      i64_ty, LL_INT(static_cast<uint32_t>(order_entries.size())));
+  CodeGenerator code_generator(executor_);
+  for (size_t i = 0; i < order_entries.size(); ++i) {
+    const auto& order_entry = order_entries[i];
+    CHECK_GE(order_entry.tle_no, int(1));
+    const size_t target_idx = order_entry.tle_no - 1;
+    CHECK_LT(target_idx, ra_exe_unit_.target_exprs.size());
+    const auto order_entry_expr = ra_exe_unit_.target_exprs[target_idx];
+    const auto& oe_ti = order_entry_expr->get_type_info();
+    const auto key_slot_idx =
+        get_heap_key_slot_index(ra_exe_unit_.target_exprs, target_idx);
+    const auto chosen_bytes =
+        static_cast<size_t>(query_mem_desc.getPaddedSlotWidthBytes(key_slot_idx));
+    CHECK(chosen_bytes == 4 || chosen_bytes == 8);
+    auto order_entry_lv = executor_->cgen_state_->castToTypeIn(
+        code_generator.codegen(order_entry_expr, true, co).front(), chosen_bytes * 8);
+    int64_t null_key{0};
+    if (oe_ti.is_integer() || oe_ti.is_decimal() || oe_ti.is_time()) {
+      null_key = chosen_bytes == 4 ? static_cast<int32_t>(inline_int_null_val(oe_ti))
+                                   : static_cast<int64_t>(inline_int_null_val(oe_ti));
+      order_entry_lv = LL_BUILDER.CreateSExt(order_entry_lv, i64_ty);
+    } else {
+      CHECK(oe_ti.is_fp());
+      const double null_val = order_entry_lv->getType()->isDoubleTy()
+                                  ? static_cast<double>(inline_fp_null_val(oe_ti))
+                                  : static_cast<float>(inline_fp_null_val(oe_ti));
+      null_key = *reinterpret_cast<const int64_t*>(&null_val);
+      order_entry_lv = LL_BUILDER.CreateBitCast(
+          LL_BUILDER.CreateFPExt(order_entry_lv, llvm::Type::getDoubleTy(LL_CONTEXT)),
+          i64_ty);
+    }
+    const streaming_top_n::HeapKeyComponent component{
+        static_cast<int64_t>(query_mem_desc.getColOffInBytes(key_slot_idx)),
+        static_cast<int64_t>(chosen_bytes),
+        oe_ti.is_fp(),
+        order_entry.is_desc,
+        !oe_ti.get_notnull(),
+        order_entry.nulls_first,
+        null_key};
+    const auto component_quad_ptr = reinterpret_cast<const int64_t*>(&component);
+    for (size_t j = 0; j < component_quads; ++j) {
+      LL_BUILDER.CreateStore(
+          LL_INT(component_quad_ptr[j]),
+          LL_BUILDER.CreateGEP(components_lv,
+                               LL_INT(static_cast<uint32_t>(i * component_quads + j))));
+    }
+    LL_BUILDER.CreateStore(
+        order_entry_lv, LL_BUILDER.CreateGEP(keys_lv, LL_INT(static_cast<uint32_t>(i))));
+  }
+  const uint32_t n = ra_exe_unit_.sort_info.offset + ra_exe_unit_.sort_info.limit;
+  return emitCall("get_bin_from_k_heap_composite",
+                  {groups_buffer,
+                   LL_INT(n),
+                   LL_INT(row_size_quad),
+                   components_lv,
+                   LL_INT(static_cast<uint32_t>(order_entries.size())),
+                   keys_lv});
+}
+
 std::tuple<llvm::Value*, llvm::Value*> GroupByAndAggregate::codegenGroupBy(
     const QueryMemoryDescriptor& query_mem_desc,
     const CompilationOptions& co,
@@ -1637,7 +1753,7 @@ void GroupByAndAggregate::codegenEstimator(
 }
 
 extern "C" void agg_count_distinct(int64_t* agg, const int64_t val) {
-  reinterpret_cast<std::set<int64_t>*>(*agg)->insert(val);
+  reinterpret_cast<CountDistinctHashSet*>(*agg)->insert(val);
 }
 
 extern "C" void agg_count_distinct_skip_val(int64_t* agg,
@@ -1648,6 +1764,18 @@ extern "C" void agg_count_distinct_skip_val(int64_t* agg,
   }
 }
 
+extern "C" void agg_count_distinct_sparse_bitmap(int64_t* agg, const int64_t val) {
+  reinterpret_cast<CountDistinctSparseBitmap*>(*agg)->insert(val);
+}
+
+extern "C" void agg_count_distinct_sparse_bitmap_skip_val(int64_t* agg,
+                                                          const int64_t val,
+                                                          const int64_t skip_val) {
+  if (val != skip_val) {
+    agg_count_distinct_sparse_bitmap(agg, val);
+  }
+}
+
 void GroupByAndAggregate::codegenCountDistinct(
     const size_t target_idx,
     const Analyzer::Expr* target_expr,
@@ -1682,6 +1810,9 @@ void GroupByAndAggregate::codegenCountDistinct(
   if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::Bitmap) {
     agg_fname += "_bitmap";
     agg_args.push_back(LL_INT(static_cast<int64_t>(count_distinct_descriptor.min_val)));
+  } else if (count_distinct_descriptor.impl_type_ ==
+             CountDistinctImplType::SparseBitmap) {
+    agg_fname += "_sparse_bitmap";
   }
   if (agg_info.skip_null_val) {
     auto null_lv = executor_->cgen_state_->castToTypeIn(
@@ -1716,6 +1847,39 @@ void GroupByAndAggregate::codegenCountDistinct(
   }
 }
 
+extern "C" void agg_approx_quantile(int64_t* agg, const double val) {
+  reinterpret_cast<TDigest*>(*agg)->add(val);
+}
+
+extern "C" void agg_approx_quantile_skip_val(int64_t* agg,
+                                             const double val,
+                                             const double skip_val) {
+  if (val != skip_val) {
+    agg_approx_quantile(agg, val);
+  }
+}
+
+void GroupByAndAggregate::codegenApproxQuantile(const Analyzer::Expr* target_expr,
+                                                std::vector<llvm::Value*>& agg_args,
+                                                const ExecutorDeviceType device_type) {
+  if (device_type == ExecutorDeviceType::GPU) {
+    // the t-digests live in host memory
+    throw QueryMustRunOnCpu();
+  }
+  const auto& arg_ti =
+      static_cast<const Analyzer::AggExpr*>(target_expr)->get_arg()->get_type_info();
+  // Decimals are added as their scaled integer representation and scaled down when the
+  // quantile is read from the result set.
+  agg_args.back() = executor_->castToFP(agg_args.back());
+  std::string agg_fname{"agg_approx_quantile"};
+  if (!arg_ti.get_notnull()) {
+    agg_fname += "_skip_val";
+    agg_args.push_back(executor_->cgen_state_->inlineFpNull(SQLTypeInfo(kDOUBLE, false)));
+  }
+  executor_->cgen_state_->emitExternalCall(
+      agg_fname, llvm::Type::getVoidTy(LL_CONTEXT), agg_args);
+}
+
 llvm::Value* GroupByAndAggregate::getAdditionalLiteral(const int32_t off) {
   CHECK_LT(off, 0);
   const auto lit_buff_lv = get_arg_by_name(ROW_FUNC, "literals");
@@ -196,6 +196,11 @@ class GroupByAndAggregate {
                                  const CompilationOptions& co,
                                  DiamondCodegen& diamond_codegen);
 
+  llvm::Value* codegenCompositeTopNSlot(llvm::Value* groups_buffer,
+                                        const QueryMemoryDescriptor& query_mem_desc,
+                                        const CompilationOptions& co,
+                                        const int32_t row_size_quad);
+
   std::tuple<llvm::Value*, llvm::Value*> codegenGroupBy(
       const QueryMemoryDescriptor& query_mem_desc,
       const CompilationOptions& co,
@@ -271,6 +276,10 @@ class GroupByAndAggregate {
                             const QueryMemoryDescriptor&,
                             const ExecutorDeviceType);
 
+  void codegenApproxQuantile(const Analyzer::Expr* target_expr,
+                             std::vector<llvm::Value*>& agg_args,
+                             const ExecutorDeviceType);
+
   llvm::Value* getAdditionalLiteral(const int32_t off);
 
   std::vector<llvm::Value*> codegenAggArg(const Analyzer::Expr* target_expr,
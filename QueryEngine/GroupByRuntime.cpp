@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "JoinBloomFilterInl.h"
 #include "JoinHashImpl.h"
 #include "MurmurHash.h"
 
@@ -311,6 +312,41 @@ extern "C" ALWAYS_INLINE DEVICE int64_t hash_join_idx_nullable(int64_t hash_buff
   return key != null_val ? hash_join_idx(hash_buff, key, min_key, max_key) : -1;
 }
 
+// Same as hash_join_idx, the Bloom filter on the keys of the table is checked first to
+// avoid loading the entry of a key which isn't there when the table isn't cache resident.
+extern "C" ALWAYS_INLINE DEVICE int64_t
+hash_join_idx_bloom_filtered(int64_t hash_buff,
+                             const int64_t key,
+                             const int64_t min_key,
+                             const int64_t max_key,
+                             const int64_t bloom_filter,
+                             const int64_t bloom_filter_bit_mask) {
+  if (key >= min_key && key <= max_key &&
+      join_bloom_filter_may_contain(reinterpret_cast<const uint64_t*>(bloom_filter),
+                                    bloom_filter_bit_mask,
+                                    key)) {
+    return *SUFFIX(get_hash_slot)(reinterpret_cast<int32_t*>(hash_buff), key, min_key);
+  }
+  return -1;
+}
+
+extern "C" ALWAYS_INLINE DEVICE int64_t
+hash_join_idx_nullable_bloom_filtered(int64_t hash_buff,
+                                      const int64_t key,
+                                      const int64_t min_key,
+                                      const int64_t max_key,
+                                      const int64_t null_val,
+                                      const int64_t bloom_filter,
+                                      const int64_t bloom_filter_bit_mask) {
+  return key != null_val ? hash_join_idx_bloom_filtered(hash_buff,
+                                                        key,
+                                                        min_key,
+                                                        max_key,
+                                                        bloom_filter,
+                                                        bloom_filter_bit_mask)
+                         : -1;
+}
+
 extern "C" ALWAYS_INLINE DEVICE int64_t
 bucketized_hash_join_idx_bitwise(int64_t hash_buff,
                                  const int64_t key,
@@ -41,6 +41,7 @@
 #endif
 #include "../Shared/funcannotations.h"
 
+#include <algorithm>
 #include <cmath>
 #include <numeric>
 
@@ -67,19 +68,15 @@ namespace {
  * ignore any element ID that is not in the dictionary corresponding to t1_s.x or is
  * outside the range of column t1_s.
  */
-inline int64_t translate_str_id_to_outer_dict(const int64_t elem,
-                                              const int64_t min_elem,
-                                              const int64_t max_elem,
-                                              const void* sd_inner_proxy,
-                                              const void* sd_outer_proxy) {
-  CHECK(sd_outer_proxy);
-  const auto sd_inner_dict_proxy =
-      static_cast<const StringDictionaryProxy*>(sd_inner_proxy);
-  const auto sd_outer_dict_proxy =
-      static_cast<const StringDictionaryProxy*>(sd_outer_proxy);
-  const auto elem_str = sd_inner_dict_proxy->getString(elem);
-  const auto outer_id = sd_outer_dict_proxy->getIdOfString(elem_str);
-  if (outer_id > max_elem || outer_id < min_elem) {
+inline int64_t translate_str_id_to_outer_dict(
+    const int64_t elem,
+    const int64_t min_elem,
+    const int64_t max_elem,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem) {
+  const auto outer_id = sd_inner_to_outer_translation_map[elem - min_inner_elem];
+  if (outer_id == StringDictionary::INVALID_STR_ID || outer_id > max_elem ||
+      outer_id < min_elem) {
     return StringDictionary::INVALID_STR_ID;
   }
   return outer_id;
@@ -116,8 +113,8 @@ DEVICE auto fill_hash_join_buff_impl(int32_t* buff,
                                      const int32_t invalid_slot_val,
                                      const JoinColumn join_column,
                                      const JoinColumnTypeInfo type_info,
-                                     const void* sd_inner_proxy,
-                                     const void* sd_outer_proxy,
+                                     const int32_t* sd_inner_to_outer_translation_map,
+                                     const int32_t min_inner_elem,
                                      const int32_t cpu_thread_idx,
                                      const int32_t cpu_thread_count,
                                      SLOT_SELECTOR slot_sel) {
@@ -140,10 +137,14 @@ DEVICE auto fill_hash_join_buff_impl(int32_t* buff,
       }
     }
 #ifndef __CUDACC__
-    if (sd_inner_proxy &&
+    if (sd_inner_to_outer_translation_map &&
         (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      const auto outer_id = translate_str_id_to_outer_dict(
-          elem, type_info.min_val, type_info.max_val, sd_inner_proxy, sd_outer_proxy);
+      const auto outer_id =
+          translate_str_id_to_outer_dict(elem,
+                                         type_info.min_val,
+                                         type_info.max_val,
+                                         sd_inner_to_outer_translation_map,
+                                         min_inner_elem);
       if (outer_id == StringDictionary::INVALID_STR_ID) {
         continue;
       }
@@ -160,15 +161,16 @@ DEVICE auto fill_hash_join_buff_impl(int32_t* buff,
   return 0;
 };
 
-DEVICE int SUFFIX(fill_hash_join_buff_bucketized)(int32_t* buff,
-                                                  const int32_t invalid_slot_val,
-                                                  const JoinColumn join_column,
-                                                  const JoinColumnTypeInfo type_info,
-                                                  const void* sd_inner_proxy,
-                                                  const void* sd_outer_proxy,
-                                                  const int32_t cpu_thread_idx,
-                                                  const int32_t cpu_thread_count,
-                                                  const int64_t bucket_normalization) {
+DEVICE int SUFFIX(fill_hash_join_buff_bucketized)(
+    int32_t* buff,
+    const int32_t invalid_slot_val,
+    const JoinColumn join_column,
+    const JoinColumnTypeInfo type_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const int32_t cpu_thread_idx,
+    const int32_t cpu_thread_count,
+    const int64_t bucket_normalization) {
   auto slot_selector = [&](auto elem) {
     return SUFFIX(get_bucketized_hash_slot)(
         buff, elem, type_info.min_val, bucket_normalization);
@@ -177,8 +179,8 @@ DEVICE int SUFFIX(fill_hash_join_buff_bucketized)(int32_t* buff,
                                   invalid_slot_val,
                                   join_column,
                                   type_info,
-                                  sd_inner_proxy,
-                                  sd_outer_proxy,
+                                  sd_inner_to_outer_translation_map,
+                                  min_inner_elem,
                                   cpu_thread_idx,
                                   cpu_thread_count,
                                   slot_selector);
@@ -188,8 +190,8 @@ DEVICE int SUFFIX(fill_hash_join_buff)(int32_t* buff,
                                        const int32_t invalid_slot_val,
                                        const JoinColumn join_column,
                                        const JoinColumnTypeInfo type_info,
-                                       const void* sd_inner_proxy,
-                                       const void* sd_outer_proxy,
+                                       const int32_t* sd_inner_to_outer_translation_map,
+                                       const int32_t min_inner_elem,
                                        const int32_t cpu_thread_idx,
                                        const int32_t cpu_thread_count) {
   auto slot_selector = [&](auto elem) {
@@ -199,24 +201,25 @@ DEVICE int SUFFIX(fill_hash_join_buff)(int32_t* buff,
                                   invalid_slot_val,
                                   join_column,
                                   type_info,
-                                  sd_inner_proxy,
-                                  sd_outer_proxy,
+                                  sd_inner_to_outer_translation_map,
+                                  min_inner_elem,
                                   cpu_thread_idx,
                                   cpu_thread_count,
                                   slot_selector);
 }
 
 template <typename SLOT_SELECTOR>
-DEVICE int fill_hash_join_buff_sharded_impl(int32_t* buff,
-                                            const int32_t invalid_slot_val,
-                                            const JoinColumn join_column,
-                                            const JoinColumnTypeInfo type_info,
-                                            const ShardInfo shard_info,
-                                            const void* sd_inner_proxy,
-                                            const void* sd_outer_proxy,
-                                            const int32_t cpu_thread_idx,
-                                            const int32_t cpu_thread_count,
-                                            SLOT_SELECTOR slot_sel) {
+DEVICE int fill_hash_join_buff_sharded_impl(
+    int32_t* buff,
+    const int32_t invalid_slot_val,
+    const JoinColumn join_column,
+    const JoinColumnTypeInfo type_info,
+    const ShardInfo shard_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const int32_t cpu_thread_idx,
+    const int32_t cpu_thread_count,
+    SLOT_SELECTOR slot_sel) {
 #ifdef __CUDACC__
   int32_t start = threadIdx.x + blockDim.x * blockIdx.x;
   int32_t step = blockDim.x * gridDim.x;
@@ -240,10 +243,14 @@ DEVICE int fill_hash_join_buff_sharded_impl(int32_t* buff,
       }
     }
 #ifndef __CUDACC__
-    if (sd_inner_proxy &&
+    if (sd_inner_to_outer_translation_map &&
         (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      const auto outer_id = translate_str_id_to_outer_dict(
-          elem, type_info.min_val, type_info.max_val, sd_inner_proxy, sd_outer_proxy);
+      const auto outer_id =
+          translate_str_id_to_outer_dict(elem,
+                                         type_info.min_val,
+                                         type_info.max_val,
+                                         sd_inner_to_outer_translation_map,
+                                         min_inner_elem);
       if (outer_id == StringDictionary::INVALID_STR_ID) {
         continue;
       }
@@ -266,8 +273,8 @@ DEVICE int SUFFIX(fill_hash_join_buff_sharded_bucketized)(
     const JoinColumn join_column,
     const JoinColumnTypeInfo type_info,
     const ShardInfo shard_info,
-    const void* sd_inner_proxy,
-    const void* sd_outer_proxy,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
     const int32_t cpu_thread_idx,
     const int32_t cpu_thread_count,
     const int64_t bucket_normalization) {
@@ -286,22 +293,23 @@ DEVICE int SUFFIX(fill_hash_join_buff_sharded_bucketized)(
                                           join_column,
                                           type_info,
                                           shard_info,
-                                          sd_inner_proxy,
-                                          sd_outer_proxy,
+                                          sd_inner_to_outer_translation_map,
+                                          min_inner_elem,
                                           cpu_thread_idx,
                                           cpu_thread_count,
                                           slot_selector);
 }
 
-DEVICE int SUFFIX(fill_hash_join_buff_sharded)(int32_t* buff,
-                                               const int32_t invalid_slot_val,
-                                               const JoinColumn join_column,
-                                               const JoinColumnTypeInfo type_info,
-                                               const ShardInfo shard_info,
-                                               const void* sd_inner_proxy,
-                                               const void* sd_outer_proxy,
-                                               const int32_t cpu_thread_idx,
-                                               const int32_t cpu_thread_count) {
+DEVICE int SUFFIX(fill_hash_join_buff_sharded)(
+    int32_t* buff,
+    const int32_t invalid_slot_val,
+    const JoinColumn join_column,
+    const JoinColumnTypeInfo type_info,
+    const ShardInfo shard_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const int32_t cpu_thread_idx,
+    const int32_t cpu_thread_count) {
   auto slot_selector = [&](auto elem) {
     return SUFFIX(get_hash_slot_sharded)(buff,
                                          elem,
@@ -315,8 +323,8 @@ DEVICE int SUFFIX(fill_hash_join_buff_sharded)(int32_t* buff,
                                           join_column,
                                           type_info,
                                           shard_info,
-                                          sd_inner_proxy,
-                                          sd_outer_proxy,
+                                          sd_inner_to_outer_translation_map,
+                                          min_inner_elem,
                                           cpu_thread_idx,
                                           cpu_thread_count,
                                           slot_selector);
@@ -539,8 +547,8 @@ DEVICE void count_matches_impl(int32_t* count_buff,
                                const JoinColumnTypeInfo type_info
 #ifndef __CUDACC__
                                ,
-                               const void* sd_inner_proxy,
-                               const void* sd_outer_proxy,
+                               const int32_t* sd_inner_to_outer_translation_map,
+                               const int32_t min_inner_elem,
                                const int32_t cpu_thread_idx,
                                const int32_t cpu_thread_count
 #endif
@@ -564,10 +572,14 @@ DEVICE void count_matches_impl(int32_t* count_buff,
       }
     }
 #ifndef __CUDACC__
-    if (sd_inner_proxy &&
+    if (sd_inner_to_outer_translation_map &&
         (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      const auto outer_id = translate_str_id_to_outer_dict(
-          elem, type_info.min_val, type_info.max_val, sd_inner_proxy, sd_outer_proxy);
+      const auto outer_id =
+          translate_str_id_to_outer_dict(elem,
+                                         type_info.min_val,
+                                         type_info.max_val,
+                                         sd_inner_to_outer_translation_map,
+                                         min_inner_elem);
       if (outer_id == StringDictionary::INVALID_STR_ID) {
         continue;
       }
@@ -587,8 +599,8 @@ GLOBAL void SUFFIX(count_matches)(int32_t* count_buff,
                                   const JoinColumnTypeInfo type_info
 #ifndef __CUDACC__
                                   ,
-                                  const void* sd_inner_proxy,
-                                  const void* sd_outer_proxy,
+                                  const int32_t* sd_inner_to_outer_translation_map,
+                                  const int32_t min_inner_elem,
                                   const int32_t cpu_thread_idx,
                                   const int32_t cpu_thread_count
 #endif
@@ -602,8 +614,8 @@ GLOBAL void SUFFIX(count_matches)(int32_t* count_buff,
                      type_info
 #ifndef __CUDACC__
                      ,
-                     sd_inner_proxy,
-                     sd_outer_proxy,
+                     sd_inner_to_outer_translation_map,
+                     min_inner_elem,
                      cpu_thread_idx,
                      cpu_thread_count
 #endif
@@ -611,19 +623,20 @@ GLOBAL void SUFFIX(count_matches)(int32_t* count_buff,
                      slot_sel);
 }
 
-GLOBAL void SUFFIX(count_matches_bucketized)(int32_t* count_buff,
-                                             const int32_t invalid_slot_val,
-                                             const JoinColumn join_column,
-                                             const JoinColumnTypeInfo type_info
+GLOBAL void SUFFIX(count_matches_bucketized)(
+    int32_t* count_buff,
+    const int32_t invalid_slot_val,
+    const JoinColumn join_column,
+    const JoinColumnTypeInfo type_info
 #ifndef __CUDACC__
-                                             ,
-                                             const void* sd_inner_proxy,
-                                             const void* sd_outer_proxy,
-                                             const int32_t cpu_thread_idx,
-                                             const int32_t cpu_thread_count
+    ,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const int32_t cpu_thread_idx,
+    const int32_t cpu_thread_count
 #endif
-                                             ,
-                                             const int64_t bucket_normalization) {
+    ,
+    const int64_t bucket_normalization) {
   auto slot_sel = [bucket_normalization, &type_info](auto count_buff, auto elem) {
     return SUFFIX(get_bucketized_hash_slot)(
         count_buff, elem, type_info.min_val, bucket_normalization);
@@ -634,8 +647,8 @@ GLOBAL void SUFFIX(count_matches_bucketized)(int32_t* count_buff,
                      type_info
 #ifndef __CUDACC__
                      ,
-                     sd_inner_proxy,
-                     sd_outer_proxy,
+                     sd_inner_to_outer_translation_map,
+                     min_inner_elem,
                      cpu_thread_idx,
                      cpu_thread_count
 #endif
@@ -643,17 +656,18 @@ GLOBAL void SUFFIX(count_matches_bucketized)(int32_t* count_buff,
                      slot_sel);
 }
 
-GLOBAL void SUFFIX(count_matches_sharded)(int32_t* count_buff,
-                                          const int32_t invalid_slot_val,
-                                          const JoinColumn join_column,
-                                          const JoinColumnTypeInfo type_info,
-                                          const ShardInfo shard_info
+GLOBAL void SUFFIX(count_matches_sharded)(
+    int32_t* count_buff,
+    const int32_t invalid_slot_val,
+    const JoinColumn join_column,
+    const JoinColumnTypeInfo type_info,
+    const ShardInfo shard_info
 #ifndef __CUDACC__
-                                          ,
-                                          const void* sd_inner_proxy,
-                                          const void* sd_outer_proxy,
-                                          const int32_t cpu_thread_idx,
-                                          const int32_t cpu_thread_count
+    ,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const int32_t cpu_thread_idx,
+    const int32_t cpu_thread_count
 #endif
 ) {
 #ifdef __CUDACC__
@@ -674,10 +688,14 @@ GLOBAL void SUFFIX(count_matches_sharded)(int32_t* count_buff,
       }
     }
 #ifndef __CUDACC__
-    if (sd_inner_proxy &&
+    if (sd_inner_to_outer_translation_map &&
         (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      const auto outer_id = translate_str_id_to_outer_dict(
-          elem, type_info.min_val, type_info.max_val, sd_inner_proxy, sd_outer_proxy);
+      const auto outer_id =
+          translate_str_id_to_outer_dict(elem,
+                                         type_info.min_val,
+                                         type_info.max_val,
+                                         sd_inner_to_outer_translation_map,
+                                         min_inner_elem);
       if (outer_id == StringDictionary::INVALID_STR_ID) {
         continue;
       }
@@ -780,8 +798,8 @@ DEVICE void fill_row_ids_impl(int32_t* buff,
                               const JoinColumnTypeInfo type_info
 #ifndef __CUDACC__
                               ,
-                              const void* sd_inner_proxy,
-                              const void* sd_outer_proxy,
+                              const int32_t* sd_inner_to_outer_translation_map,
+                              const int32_t min_inner_elem,
                               const int32_t cpu_thread_idx,
                               const int32_t cpu_thread_count
 #endif
@@ -810,10 +828,14 @@ DEVICE void fill_row_ids_impl(int32_t* buff,
       }
     }
 #ifndef __CUDACC__
-    if (sd_inner_proxy &&
+    if (sd_inner_to_outer_translation_map &&
         (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      const auto outer_id = translate_str_id_to_outer_dict(
-          elem, type_info.min_val, type_info.max_val, sd_inner_proxy, sd_outer_proxy);
+      const auto outer_id =
+          translate_str_id_to_outer_dict(elem,
+                                         type_info.min_val,
+                                         type_info.max_val,
+                                         sd_inner_to_outer_translation_map,
+                                         min_inner_elem);
       if (outer_id == StringDictionary::INVALID_STR_ID) {
         continue;
       }
@@ -839,8 +861,8 @@ GLOBAL void SUFFIX(fill_row_ids)(int32_t* buff,
                                  const JoinColumnTypeInfo type_info
 #ifndef __CUDACC__
                                  ,
-                                 const void* sd_inner_proxy,
-                                 const void* sd_outer_proxy,
+                                 const int32_t* sd_inner_to_outer_translation_map,
+                                 const int32_t min_inner_elem,
                                  const int32_t cpu_thread_idx,
                                  const int32_t cpu_thread_count
 #endif
@@ -856,8 +878,8 @@ GLOBAL void SUFFIX(fill_row_ids)(int32_t* buff,
                     type_info
 #ifndef __CUDACC__
                     ,
-                    sd_inner_proxy,
-                    sd_outer_proxy,
+                    sd_inner_to_outer_translation_map,
+                    min_inner_elem,
                     cpu_thread_idx,
                     cpu_thread_count
 #endif
@@ -865,20 +887,21 @@ GLOBAL void SUFFIX(fill_row_ids)(int32_t* buff,
                     slot_sel);
 }
 
-GLOBAL void SUFFIX(fill_row_ids_bucketized)(int32_t* buff,
-                                            const int32_t hash_entry_count,
-                                            const int32_t invalid_slot_val,
-                                            const JoinColumn join_column,
-                                            const JoinColumnTypeInfo type_info
+GLOBAL void SUFFIX(fill_row_ids_bucketized)(
+    int32_t* buff,
+    const int32_t hash_entry_count,
+    const int32_t invalid_slot_val,
+    const JoinColumn join_column,
+    const JoinColumnTypeInfo type_info
 #ifndef __CUDACC__
-                                            ,
-                                            const void* sd_inner_proxy,
-                                            const void* sd_outer_proxy,
-                                            const int32_t cpu_thread_idx,
-                                            const int32_t cpu_thread_count
+    ,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const int32_t cpu_thread_idx,
+    const int32_t cpu_thread_count
 #endif
-                                            ,
-                                            const int64_t bucket_normalization) {
+    ,
+    const int64_t bucket_normalization) {
   auto slot_sel = [&type_info, bucket_normalization](auto pos_buff, auto elem) {
     return SUFFIX(get_bucketized_hash_slot)(
         pos_buff, elem, type_info.min_val, bucket_normalization);
@@ -890,8 +913,8 @@ GLOBAL void SUFFIX(fill_row_ids_bucketized)(int32_t* buff,
                     type_info
 #ifndef __CUDACC__
                     ,
-                    sd_inner_proxy,
-                    sd_outer_proxy,
+                    sd_inner_to_outer_translation_map,
+                    min_inner_elem,
                     cpu_thread_idx,
                     cpu_thread_count
 #endif
@@ -908,8 +931,8 @@ DEVICE void fill_row_ids_sharded_impl(int32_t* buff,
                                       const ShardInfo shard_info
 #ifndef __CUDACC__
                                       ,
-                                      const void* sd_inner_proxy,
-                                      const void* sd_outer_proxy,
+                                      const int32_t* sd_inner_to_outer_translation_map,
+                                      const int32_t min_inner_elem,
                                       const int32_t cpu_thread_idx,
                                       const int32_t cpu_thread_count
 #endif
@@ -939,10 +962,14 @@ DEVICE void fill_row_ids_sharded_impl(int32_t* buff,
       }
     }
 #ifndef __CUDACC__
-    if (sd_inner_proxy &&
+    if (sd_inner_to_outer_translation_map &&
         (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      const auto outer_id = translate_str_id_to_outer_dict(
-          elem, type_info.min_val, type_info.max_val, sd_inner_proxy, sd_outer_proxy);
+      const auto outer_id =
+          translate_str_id_to_outer_dict(elem,
+                                         type_info.min_val,
+                                         type_info.max_val,
+                                         sd_inner_to_outer_translation_map,
+                                         min_inner_elem);
       if (outer_id == StringDictionary::INVALID_STR_ID) {
         continue;
       }
@@ -969,8 +996,8 @@ GLOBAL void SUFFIX(fill_row_ids_sharded)(int32_t* buff,
                                          const ShardInfo shard_info
 #ifndef __CUDACC__
                                          ,
-                                         const void* sd_inner_proxy,
-                                         const void* sd_outer_proxy,
+                                         const int32_t* sd_inner_to_outer_translation_map,
+                                         const int32_t min_inner_elem,
                                          const int32_t cpu_thread_idx,
                                          const int32_t cpu_thread_count
 #endif
@@ -991,8 +1018,8 @@ GLOBAL void SUFFIX(fill_row_ids_sharded)(int32_t* buff,
                     type_info
 #ifndef __CUDACC__
                     ,
-                    sd_inner_proxy,
-                    sd_outer_proxy,
+                    sd_inner_to_outer_translation_map,
+                    min_inner_elem,
                     cpu_thread_idx,
                     cpu_thread_count
 #endif
@@ -1000,21 +1027,22 @@ GLOBAL void SUFFIX(fill_row_ids_sharded)(int32_t* buff,
                     slot_sel);
 }
 
-GLOBAL void SUFFIX(fill_row_ids_sharded_bucketized)(int32_t* buff,
-                                                    const int32_t hash_entry_count,
-                                                    const int32_t invalid_slot_val,
-                                                    const JoinColumn join_column,
-                                                    const JoinColumnTypeInfo type_info,
-                                                    const ShardInfo shard_info
+GLOBAL void SUFFIX(fill_row_ids_sharded_bucketized)(
+    int32_t* buff,
+    const int32_t hash_entry_count,
+    const int32_t invalid_slot_val,
+    const JoinColumn join_column,
+    const JoinColumnTypeInfo type_info,
+    const ShardInfo shard_info
 #ifndef __CUDACC__
-                                                    ,
-                                                    const void* sd_inner_proxy,
-                                                    const void* sd_outer_proxy,
-                                                    const int32_t cpu_thread_idx,
-                                                    const int32_t cpu_thread_count
+    ,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const int32_t cpu_thread_idx,
+    const int32_t cpu_thread_count
 #endif
-                                                    ,
-                                                    const int64_t bucket_normalization) {
+    ,
+    const int64_t bucket_normalization) {
   auto slot_sel = [&shard_info, &type_info, bucket_normalization](auto pos_buff,
                                                                   auto elem) {
     return SUFFIX(get_bucketized_hash_slot_sharded)(pos_buff,
@@ -1033,8 +1061,8 @@ GLOBAL void SUFFIX(fill_row_ids_sharded_bucketized)(int32_t* buff,
                     type_info
 #ifndef __CUDACC__
                     ,
-                    sd_inner_proxy,
-                    sd_outer_proxy,
+                    sd_inner_to_outer_translation_map,
+                    min_inner_elem,
                     cpu_thread_idx,
                     cpu_thread_count
 #endif
@@ -1294,22 +1322,26 @@ void fill_one_to_many_hash_table_impl(int32_t* buff,
                                       const int32_t invalid_slot_val,
                                       const JoinColumn& join_column,
                                       const JoinColumnTypeInfo& type_info,
-                                      const void* sd_inner_proxy,
-                                      const void* sd_outer_proxy,
+                                      const int32_t* sd_inner_to_outer_translation_map,
+                                      const int32_t min_inner_elem,
                                       const unsigned cpu_thread_count,
+                                      const bool counts_filled,
                                       COUNT_MATCHES_LAUNCH_FUNCTOR count_matches_func,
                                       FILL_ROW_IDS_LAUNCH_FUNCTOR fill_row_ids_func) {
   int32_t* pos_buff = buff;
   int32_t* count_buff = buff + hash_entry_count;
-  memset(count_buff, 0, hash_entry_count * sizeof(int32_t));
-  std::vector<std::future<void>> counter_threads;
-  for (unsigned cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
-    counter_threads.push_back(std::async(
-        std::launch::async, count_matches_func, cpu_thread_idx, cpu_thread_count));
-  }
+  if (!counts_filled) {
+    memset(count_buff, 0, hash_entry_count * sizeof(int32_t));
+    std::vector<std::future<void>> counter_threads;
+    for (unsigned cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count;
+         ++cpu_thread_idx) {
+      counter_threads.push_back(std::async(
+          std::launch::async, count_matches_func, cpu_thread_idx, cpu_thread_count));
+    }
 
-  for (auto& child : counter_threads) {
-    child.get();
+    for (auto& child : counter_threads) {
+      child.get();
+    }
   }
 
   std::vector<int32_t> count_copy(hash_entry_count, 0);
@@ -1356,23 +1388,24 @@ void fill_one_to_many_hash_table(int32_t* buff,
                                  const int32_t invalid_slot_val,
                                  const JoinColumn& join_column,
                                  const JoinColumnTypeInfo& type_info,
-                                 const void* sd_inner_proxy,
-                                 const void* sd_outer_proxy,
-                                 const unsigned cpu_thread_count) {
+                                 const int32_t* sd_inner_to_outer_translation_map,
+                                 const int32_t min_inner_elem,
+                                 const unsigned cpu_thread_count,
+                                 const bool counts_filled) {
   auto launch_count_matches = [count_buff = buff + hash_entry_info.hash_entry_count,
                                invalid_slot_val,
                                &join_column,
                                &type_info,
-                               sd_inner_proxy,
-                               sd_outer_proxy](auto cpu_thread_idx,
+                               sd_inner_to_outer_translation_map,
+                               min_inner_elem](auto cpu_thread_idx,
                                                auto cpu_thread_count) {
     SUFFIX(count_matches)
     (count_buff,
      invalid_slot_val,
      join_column,
      type_info,
-     sd_inner_proxy,
-     sd_outer_proxy,
+     sd_inner_to_outer_translation_map,
+     min_inner_elem,
      cpu_thread_idx,
      cpu_thread_count);
   };
@@ -1381,8 +1414,8 @@ void fill_one_to_many_hash_table(int32_t* buff,
                               invalid_slot_val,
                               &join_column,
                               &type_info,
-                              sd_inner_proxy,
-                              sd_outer_proxy](auto cpu_thread_idx,
+                              sd_inner_to_outer_translation_map,
+                              min_inner_elem](auto cpu_thread_idx,
                                               auto cpu_thread_count) {
     SUFFIX(fill_row_ids)
     (buff,
@@ -1390,8 +1423,8 @@ void fill_one_to_many_hash_table(int32_t* buff,
      invalid_slot_val,
      join_column,
      type_info,
-     sd_inner_proxy,
-     sd_outer_proxy,
+     sd_inner_to_outer_translation_map,
+     min_inner_elem,
      cpu_thread_idx,
      cpu_thread_count);
   };
@@ -1401,21 +1434,24 @@ void fill_one_to_many_hash_table(int32_t* buff,
                                    invalid_slot_val,
                                    join_column,
                                    type_info,
-                                   sd_inner_proxy,
-                                   sd_outer_proxy,
+                                   sd_inner_to_outer_translation_map,
+                                   min_inner_elem,
                                    cpu_thread_count,
+                                   counts_filled,
                                    launch_count_matches,
                                    launch_fill_row_ids);
 }
 
-void fill_one_to_many_hash_table_bucketized(int32_t* buff,
-                                            const HashEntryInfo hash_entry_info,
-                                            const int32_t invalid_slot_val,
-                                            const JoinColumn& join_column,
-                                            const JoinColumnTypeInfo& type_info,
-                                            const void* sd_inner_proxy,
-                                            const void* sd_outer_proxy,
-                                            const unsigned cpu_thread_count) {
+void fill_one_to_many_hash_table_bucketized(
+    int32_t* buff,
+    const HashEntryInfo hash_entry_info,
+    const int32_t invalid_slot_val,
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const unsigned cpu_thread_count,
+    const bool counts_filled) {
   auto bucket_normalization = hash_entry_info.bucket_normalization;
   auto hash_entry_count = hash_entry_info.getNormalizedHashEntryCount();
   auto launch_count_matches = [bucket_normalization,
@@ -1423,16 +1459,16 @@ void fill_one_to_many_hash_table_bucketized(int32_t* buff,
                                invalid_slot_val,
                                &join_column,
                                &type_info,
-                               sd_inner_proxy,
-                               sd_outer_proxy](auto cpu_thread_idx,
+                               sd_inner_to_outer_translation_map,
+                               min_inner_elem](auto cpu_thread_idx,
                                                auto cpu_thread_count) {
     SUFFIX(count_matches_bucketized)
     (count_buff,
      invalid_slot_val,
      join_column,
      type_info,
-     sd_inner_proxy,
-     sd_outer_proxy,
+     sd_inner_to_outer_translation_map,
+     min_inner_elem,
      cpu_thread_idx,
      cpu_thread_count,
      bucket_normalization);
@@ -1443,8 +1479,8 @@ void fill_one_to_many_hash_table_bucketized(int32_t* buff,
                               invalid_slot_val,
                               &join_column,
                               &type_info,
-                              sd_inner_proxy,
-                              sd_outer_proxy](auto cpu_thread_idx,
+                              sd_inner_to_outer_translation_map,
+                              min_inner_elem](auto cpu_thread_idx,
                                               auto cpu_thread_count) {
     SUFFIX(fill_row_ids_bucketized)
     (buff,
@@ -1452,8 +1488,8 @@ void fill_one_to_many_hash_table_bucketized(int32_t* buff,
      invalid_slot_val,
      join_column,
      type_info,
-     sd_inner_proxy,
-     sd_outer_proxy,
+     sd_inner_to_outer_translation_map,
+     min_inner_elem,
      cpu_thread_idx,
      cpu_thread_count,
      bucket_normalization);
@@ -1464,13 +1500,316 @@ void fill_one_to_many_hash_table_bucketized(int32_t* buff,
                                    invalid_slot_val,
                                    join_column,
                                    type_info,
-                                   sd_inner_proxy,
-                                   sd_outer_proxy,
+                                   sd_inner_to_outer_translation_map,
+                                   min_inner_elem,
                                    cpu_thread_count,
+                                   counts_filled,
                                    launch_count_matches,
                                    launch_fill_row_ids);
 }
 
+namespace {
+
+// A row of the build side of a join along with the slot of its key in the hash table.
+struct PartitionedJoinEntry {
+  int32_t slot;
+  int32_t index;
+};
+
+// Partitions of the rows of the build side of a join on the high bits of their slot,
+// each one covers a contiguous range of the hash table which fits in the cache.
+struct JoinPartitions {
+  std::vector<PartitionedJoinEntry> entries;
+  // the entries of partition i are in [offsets[i], offsets[i + 1])
+  std::vector<size_t> offsets;
+};
+
+// The slots of a partition span 256KB of the hash table, about the size of a L2 cache,
+// unless that takes more than 2^11 partitions: scattering the rows to more than a few
+// thousand partitions in a single pass thrashes the TLB.
+constexpr size_t kMinPartitionSlotBits{16};
+constexpr size_t kMaxPartitionBits{11};
+
+// Rows are routed to their partition through a cache line sized buffer per thread and
+// partition, written out once full.
+constexpr size_t kWriteCombiningEntries{64 / sizeof(PartitionedJoinEntry)};
+
+// Returns the slot of the key of a row of the build side, or -1 if the row is left out
+// of the hash table, the same way fill_hash_join_buff_impl and count_matches_impl do.
+inline int64_t get_partitioned_join_slot(
+    int64_t elem,
+    const JoinColumnTypeInfo& type_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const int64_t bucket_normalization) {
+  if (elem == type_info.null_val) {
+    if (type_info.uses_bw_eq) {
+      elem = type_info.translated_null_val;
+    } else {
+      return -1;
+    }
+  }
+  if (sd_inner_to_outer_translation_map &&
+      (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
+    const auto outer_id =
+        translate_str_id_to_outer_dict(elem,
+                                       type_info.min_val,
+                                       type_info.max_val,
+                                       sd_inner_to_outer_translation_map,
+                                       min_inner_elem);
+    if (outer_id == StringDictionary::INVALID_STR_ID) {
+      return -1;
+    }
+    elem = outer_id;
+  }
+  CHECK_GE(elem, type_info.min_val)
+      << "Element " << elem << " less than min val " << type_info.min_val;
+  return (elem - type_info.min_val) / bucket_normalization;
+}
+
+size_t get_partition_slot_bits(const size_t hash_entry_count) {
+  size_t slot_bits{kMinPartitionSlotBits};
+  while ((hash_entry_count >> slot_bits) >= (size_t(1) << kMaxPartitionBits)) {
+    ++slot_bits;
+  }
+  return slot_bits;
+}
+
+template <typename FUNC>
+void run_on_cpu_threads(const unsigned cpu_thread_count, FUNC func) {
+  std::vector<std::future<void>> threads;
+  for (unsigned cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
+    threads.push_back(std::async(std::launch::async, func, cpu_thread_idx));
+  }
+  for (auto& child : threads) {
+    child.get();
+  }
+}
+
+JoinPartitions partition_join_column(const JoinColumn& join_column,
+                                     const JoinColumnTypeInfo& type_info,
+                                     const int32_t* sd_inner_to_outer_translation_map,
+                                     const int32_t min_inner_elem,
+                                     const int64_t bucket_normalization,
+                                     const size_t hash_entry_count,
+                                     const size_t slot_bits,
+                                     const unsigned cpu_thread_count) {
+  const size_t partition_count = ((hash_entry_count - 1) >> slot_bits) + 1;
+  const auto for_each_slot = [&](const unsigned cpu_thread_idx, auto func) {
+    JoinColumnTyped col{&join_column, &type_info};
+    for (auto item : col.slice(cpu_thread_idx, cpu_thread_count)) {
+      const auto slot = get_partitioned_join_slot(item.element,
+                                                  type_info,
+                                                  sd_inner_to_outer_translation_map,
+                                                  min_inner_elem,
+                                                  bucket_normalization);
+      if (slot >= 0) {
+        func(PartitionedJoinEntry{static_cast<int32_t>(slot),
+                                  static_cast<int32_t>(item.index)});
+      }
+    }
+  };
+
+  // histogram of the partitions of the rows seen by each thread
+  std::vector<std::vector<size_t>> thread_offsets(
+      cpu_thread_count, std::vector<size_t>(partition_count, 0));
+  run_on_cpu_threads(cpu_thread_count, [&](const unsigned cpu_thread_idx) {
+    auto& counts = thread_offsets[cpu_thread_idx];
+    for_each_slot(cpu_thread_idx, [&counts, slot_bits](const PartitionedJoinEntry entry) {
+      ++counts[entry.slot >> slot_bits];
+    });
+  });
+
+  JoinPartitions partitions;
+  partitions.offsets.resize(partition_count + 1);
+  size_t offset{0};
+  for (size_t partition = 0; partition < partition_count; ++partition) {
+    partitions.offsets[partition] = offset;
+    for (auto& counts : thread_offsets) {
+      const auto count = counts[partition];
+      counts[partition] = offset;
+      offset += count;
+    }
+  }
+  partitions.offsets[partition_count] = offset;
+  partitions.entries.resize(offset);
+
+  run_on_cpu_threads(cpu_thread_count, [&](const unsigned cpu_thread_idx) {
+    auto& offsets = thread_offsets[cpu_thread_idx];
+    std::vector<PartitionedJoinEntry> buffers(partition_count * kWriteCombiningEntries);
+    std::vector<uint8_t> buffer_sizes(partition_count, 0);
+    const auto flush = [&](const size_t partition) {
+      std::memcpy(&partitions.entries[offsets[partition]],
+                  &buffers[partition * kWriteCombiningEntries],
+                  buffer_sizes[partition] * sizeof(PartitionedJoinEntry));
+      offsets[partition] += buffer_sizes[partition];
+      buffer_sizes[partition] = 0;
+    };
+    for_each_slot(cpu_thread_idx, [&](const PartitionedJoinEntry entry) {
+      const size_t partition = entry.slot >> slot_bits;
+      buffers[partition * kWriteCombiningEntries + buffer_sizes[partition]] = entry;
+      if (++buffer_sizes[partition] == kWriteCombiningEntries) {
+        flush(partition);
+      }
+    });
+    for (size_t partition = 0; partition < partition_count; ++partition) {
+      flush(partition);
+    }
+  });
+  return partitions;
+}
+
+}  // namespace
+
+int fill_hash_join_buff_bucketized_partitioned(
+    int32_t* buff,
+    const HashEntryInfo hash_entry_info,
+    const int32_t invalid_slot_val,
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const unsigned cpu_thread_count) {
+  const auto hash_entry_count = hash_entry_info.getNormalizedHashEntryCount();
+  const auto slot_bits = get_partition_slot_bits(hash_entry_count);
+  const auto partitions = partition_join_column(join_column,
+                                                type_info,
+                                                sd_inner_to_outer_translation_map,
+                                                min_inner_elem,
+                                                hash_entry_info.bucket_normalization,
+                                                hash_entry_count,
+                                                slot_bits,
+                                                cpu_thread_count);
+  const size_t partition_count = partitions.offsets.size() - 1;
+  int err{0};
+  // every partition is filled by a single thread, no need for atomics
+  run_on_cpu_threads(cpu_thread_count, [&](const unsigned cpu_thread_idx) {
+    for (size_t partition = cpu_thread_idx; partition < partition_count;
+         partition += cpu_thread_count) {
+      for (size_t i = partitions.offsets[partition];
+           i < partitions.offsets[partition + 1];
+           ++i) {
+        const auto& entry = partitions.entries[i];
+        if (buff[entry.slot] != invalid_slot_val) {
+          __sync_val_compare_and_swap(&err, 0, -1);
+          return;
+        }
+        buff[entry.slot] = entry.index;
+      }
+    }
+  });
+  return err;
+}
+
+void fill_one_to_many_hash_table_bucketized_partitioned(
+    int32_t* buff,
+    const HashEntryInfo hash_entry_info,
+    const int32_t invalid_slot_val,
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const unsigned cpu_thread_count,
+    const bool counts_filled) {
+  const auto hash_entry_count = hash_entry_info.getNormalizedHashEntryCount();
+  const auto slot_bits = get_partition_slot_bits(hash_entry_count);
+  const auto partitions = partition_join_column(join_column,
+                                                type_info,
+                                                sd_inner_to_outer_translation_map,
+                                                min_inner_elem,
+                                                hash_entry_info.bucket_normalization,
+                                                hash_entry_count,
+                                                slot_bits,
+                                                cpu_thread_count);
+  const size_t partition_count = partitions.offsets.size() - 1;
+  int32_t* pos_buff = buff;
+  int32_t* count_buff = buff + hash_entry_count;
+  int32_t* id_buff = count_buff + hash_entry_count;
+  // every partition is counted and filled by a single thread, no need for atomics
+  auto launch_count_matches = [&](auto cpu_thread_idx, auto cpu_thread_count) {
+    for (size_t partition = cpu_thread_idx; partition < partition_count;
+         partition += cpu_thread_count) {
+      for (size_t i = partitions.offsets[partition];
+           i < partitions.offsets[partition + 1];
+           ++i) {
+        ++count_buff[partitions.entries[i].slot];
+      }
+    }
+  };
+  auto launch_fill_row_ids = [&](auto cpu_thread_idx, auto cpu_thread_count) {
+    for (size_t partition = cpu_thread_idx; partition < partition_count;
+         partition += cpu_thread_count) {
+      for (size_t i = partitions.offsets[partition];
+           i < partitions.offsets[partition + 1];
+           ++i) {
+        const auto& entry = partitions.entries[i];
+        CHECK_NE(pos_buff[entry.slot], invalid_slot_val);
+        id_buff[pos_buff[entry.slot] + count_buff[entry.slot]++] = entry.index;
+      }
+    }
+  };
+
+  fill_one_to_many_hash_table_impl(buff,
+                                   hash_entry_count,
+                                   invalid_slot_val,
+                                   join_column,
+                                   type_info,
+                                   sd_inner_to_outer_translation_map,
+                                   min_inner_elem,
+                                   cpu_thread_count,
+                                   counts_filled,
+                                   launch_count_matches,
+                                   launch_fill_row_ids);
+}
+
+size_t get_partitioned_build_size_bytes(const size_t row_count,
+                                        const size_t hash_entry_count,
+                                        const unsigned cpu_thread_count) {
+  const size_t partition_count =
+      ((hash_entry_count - 1) >> get_partition_slot_bits(hash_entry_count)) + 1;
+  return row_count * sizeof(PartitionedJoinEntry) +
+         (partition_count + 1) * sizeof(size_t) +
+         cpu_thread_count * partition_count *
+             (kWriteCombiningEntries * sizeof(PartitionedJoinEntry) + sizeof(size_t) +
+              sizeof(uint8_t));
+}
+
+int32_t count_hash_join_keys_bucketized(int32_t* count_buff,
+                                        const HashEntryInfo hash_entry_info,
+                                        const int32_t invalid_slot_val,
+                                        const JoinColumn& join_column,
+                                        const JoinColumnTypeInfo& type_info,
+                                        const int32_t* sd_inner_to_outer_translation_map,
+                                        const int32_t min_inner_elem,
+                                        const unsigned cpu_thread_count) {
+  const size_t hash_entry_count = hash_entry_info.getNormalizedHashEntryCount();
+  memset(count_buff, 0, hash_entry_count * sizeof(int32_t));
+  run_on_cpu_threads(cpu_thread_count, [&](const unsigned cpu_thread_idx) {
+    SUFFIX(count_matches_bucketized)
+    (count_buff,
+     invalid_slot_val,
+     join_column,
+     type_info,
+     sd_inner_to_outer_translation_map,
+     min_inner_elem,
+     cpu_thread_idx,
+     cpu_thread_count,
+     hash_entry_info.bucket_normalization);
+  });
+  std::vector<int32_t> max_counts(cpu_thread_count, 0);
+  const size_t step = (hash_entry_count + cpu_thread_count - 1) / cpu_thread_count;
+  run_on_cpu_threads(cpu_thread_count, [&](const unsigned cpu_thread_idx) {
+    const auto begin = std::min(cpu_thread_idx * step, hash_entry_count);
+    const auto end = std::min(begin + step, hash_entry_count);
+    max_counts[cpu_thread_idx] =
+        std::accumulate(count_buff + begin,
+                        count_buff + end,
+                        int32_t(0),
+                        [](const int32_t a, const int32_t b) { return std::max(a, b); });
+  });
+  return *std::max_element(max_counts.begin(), max_counts.end());
+}
+
 template <typename COUNT_MATCHES_LAUNCH_FUNCTOR, typename FILL_ROW_IDS_LAUNCH_FUNCTOR>
 void fill_one_to_many_hash_table_sharded_impl(
     int32_t* buff,
@@ -1479,8 +1818,8 @@ void fill_one_to_many_hash_table_sharded_impl(
     const JoinColumn& join_column,
     const JoinColumnTypeInfo& type_info,
     const ShardInfo& shard_info,
-    const void* sd_inner_proxy,
-    const void* sd_outer_proxy,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
     const unsigned cpu_thread_count,
     COUNT_MATCHES_LAUNCH_FUNCTOR count_matches_launcher,
     FILL_ROW_IDS_LAUNCH_FUNCTOR fill_row_ids_launcher) {
@@ -1539,8 +1878,8 @@ void fill_one_to_many_hash_table_sharded(int32_t* buff,
                                          const JoinColumn& join_column,
                                          const JoinColumnTypeInfo& type_info,
                                          const ShardInfo& shard_info,
-                                         const void* sd_inner_proxy,
-                                         const void* sd_outer_proxy,
+                                         const int32_t* sd_inner_to_outer_translation_map,
+                                         const int32_t min_inner_elem,
                                          const unsigned cpu_thread_count) {
   auto launch_count_matches = [count_buff = buff + hash_entry_count,
                                invalid_slot_val,
@@ -1549,8 +1888,8 @@ void fill_one_to_many_hash_table_sharded(int32_t* buff,
                                &shard_info
 #ifndef __CUDACC__
                                ,
-                               sd_inner_proxy,
-                               sd_outer_proxy
+                               sd_inner_to_outer_translation_map,
+                               min_inner_elem
 #endif
   ](auto cpu_thread_idx, auto cpu_thread_count) {
     return SUFFIX(count_matches_sharded)(count_buff,
@@ -1560,8 +1899,8 @@ void fill_one_to_many_hash_table_sharded(int32_t* buff,
                                          shard_info
 #ifndef __CUDACC__
                                          ,
-                                         sd_inner_proxy,
-                                         sd_outer_proxy,
+                                         sd_inner_to_outer_translation_map,
+                                         min_inner_elem,
                                          cpu_thread_idx,
                                          cpu_thread_count
 #endif
@@ -1576,8 +1915,8 @@ void fill_one_to_many_hash_table_sharded(int32_t* buff,
                               &shard_info
 #ifndef __CUDACC__
                               ,
-                              sd_inner_proxy,
-                              sd_outer_proxy
+                              sd_inner_to_outer_translation_map,
+                              min_inner_elem
 #endif
   ](auto cpu_thread_idx, auto cpu_thread_count) {
     return SUFFIX(fill_row_ids_sharded)(buff,
@@ -1588,8 +1927,8 @@ void fill_one_to_many_hash_table_sharded(int32_t* buff,
                                         shard_info
 #ifndef __CUDACC__
                                         ,
-                                        sd_inner_proxy,
-                                        sd_outer_proxy,
+                                        sd_inner_to_outer_translation_map,
+                                        min_inner_elem,
                                         cpu_thread_idx,
                                         cpu_thread_count);
 #endif
@@ -1603,8 +1942,8 @@ void fill_one_to_many_hash_table_sharded(int32_t* buff,
                                            shard_info
 #ifndef __CUDACC__
                                            ,
-                                           sd_inner_proxy,
-                                           sd_outer_proxy,
+                                           sd_inner_to_outer_translation_map,
+                                           min_inner_elem,
                                            cpu_thread_count
 #endif
                                            ,
@@ -1734,8 +2073,8 @@ void fill_one_to_many_baseline_hash_table(
     const std::vector<JoinColumn>& join_column_per_key,
     const std::vector<JoinColumnTypeInfo>& type_info_per_key,
     const std::vector<JoinBucketInfo>& join_buckets_per_key,
-    const std::vector<const void*>& sd_inner_proxy_per_key,
-    const std::vector<const void*>& sd_outer_proxy_per_key,
+    const std::vector<const int32_t*>& sd_inner_to_outer_translation_maps,
+    const std::vector<int32_t>& sd_min_inner_elems,
     const size_t cpu_thread_count) {
   int32_t* pos_buff = buff;
   int32_t* count_buff = buff + hash_entry_count;
@@ -1773,16 +2112,17 @@ void fill_one_to_many_baseline_hash_table(
            &hash_entry_count,
            &join_column_per_key,
            &type_info_per_key,
-           &sd_inner_proxy_per_key,
-           &sd_outer_proxy_per_key,
+           &sd_inner_to_outer_translation_maps,
+           &sd_min_inner_elems,
            cpu_thread_idx,
            cpu_thread_count] {
-            const auto key_handler = GenericKeyHandler(key_component_count,
-                                                       true,
-                                                       &join_column_per_key[0],
-                                                       &type_info_per_key[0],
-                                                       &sd_inner_proxy_per_key[0],
-                                                       &sd_outer_proxy_per_key[0]);
+            const auto key_handler = GenericKeyHandler(
+                key_component_count,
+                true,
+                &join_column_per_key[0],
+                &type_info_per_key[0],
+                &sd_inner_to_outer_translation_maps[0],
+                &sd_min_inner_elems[0]);
             count_matches_baseline(count_buff,
                                    composite_key_dict,
                                    hash_entry_count,
@@ -1857,8 +2197,8 @@ void fill_one_to_many_baseline_hash_table(
                                           key_component_count,
                                           &join_column_per_key,
                                           &type_info_per_key,
-                                          &sd_inner_proxy_per_key,
-                                          &sd_outer_proxy_per_key,
+                                          &sd_inner_to_outer_translation_maps,
+                                          &sd_min_inner_elems,
                                           cpu_thread_idx,
                                           cpu_thread_count] {
                                            const auto key_handler = GenericKeyHandler(
@@ -1866,8 +2206,8 @@ void fill_one_to_many_baseline_hash_table(
                                                true,
                                                &join_column_per_key[0],
                                                &type_info_per_key[0],
-                                               &sd_inner_proxy_per_key[0],
-                                               &sd_outer_proxy_per_key[0]);
+                                               &sd_inner_to_outer_translation_maps[0],
+                                               &sd_min_inner_elems[0]);
                                            SUFFIX(fill_row_ids_baseline)
                                            (buff,
                                             composite_key_dict,
@@ -1895,8 +2235,8 @@ void fill_one_to_many_baseline_hash_table_32(
     const std::vector<JoinColumn>& join_column_per_key,
     const std::vector<JoinColumnTypeInfo>& type_info_per_key,
     const std::vector<JoinBucketInfo>& join_bucket_info,
-    const std::vector<const void*>& sd_inner_proxy_per_key,
-    const std::vector<const void*>& sd_outer_proxy_per_key,
+    const std::vector<const int32_t*>& sd_inner_to_outer_translation_maps,
+    const std::vector<int32_t>& sd_min_inner_elems,
     const int32_t cpu_thread_count) {
   fill_one_to_many_baseline_hash_table<int32_t>(buff,
                                                 composite_key_dict,
@@ -1906,8 +2246,8 @@ void fill_one_to_many_baseline_hash_table_32(
                                                 join_column_per_key,
                                                 type_info_per_key,
                                                 join_bucket_info,
-                                                sd_inner_proxy_per_key,
-                                                sd_outer_proxy_per_key,
+                                                sd_inner_to_outer_translation_maps,
+                                                sd_min_inner_elems,
                                                 cpu_thread_count);
 }
 
@@ -1920,8 +2260,8 @@ void fill_one_to_many_baseline_hash_table_64(
     const std::vector<JoinColumn>& join_column_per_key,
     const std::vector<JoinColumnTypeInfo>& type_info_per_key,
     const std::vector<JoinBucketInfo>& join_bucket_info,
-    const std::vector<const void*>& sd_inner_proxy_per_key,
-    const std::vector<const void*>& sd_outer_proxy_per_key,
+    const std::vector<const int32_t*>& sd_inner_to_outer_translation_maps,
+    const std::vector<int32_t>& sd_min_inner_elems,
     const int32_t cpu_thread_count) {
   fill_one_to_many_baseline_hash_table<int64_t>(buff,
                                                 composite_key_dict,
@@ -1931,8 +2271,8 @@ void fill_one_to_many_baseline_hash_table_64(
                                                 join_column_per_key,
                                                 type_info_per_key,
                                                 join_bucket_info,
-                                                sd_inner_proxy_per_key,
-                                                sd_outer_proxy_per_key,
+                                                sd_inner_to_outer_translation_maps,
+                                                sd_min_inner_elems,
                                                 cpu_thread_count);
 }
 
@@ -147,8 +147,8 @@ int fill_hash_join_buff_bucketized(int32_t* buff,
                                    const int32_t invalid_slot_val,
                                    const JoinColumn join_column,
                                    const JoinColumnTypeInfo type_info,
-                                   const void* sd_inner,
-                                   const void* sd_outer,
+                                   const int32_t* sd_inner_to_outer_translation_map,
+                                   const int32_t min_inner_elem,
                                    const int32_t cpu_thread_idx,
                                    const int32_t cpu_thread_count,
                                    const int64_t bucket_normalization);
@@ -157,8 +157,8 @@ int fill_hash_join_buff(int32_t* buff,
                         const int32_t invalid_slot_val,
                         const JoinColumn join_column,
                         const JoinColumnTypeInfo type_info,
-                        const void* sd_inner,
-                        const void* sd_outer,
+                        const int32_t* sd_inner_to_outer_translation_map,
+                        const int32_t min_inner_elem,
                         const int32_t cpu_thread_idx,
                         const int32_t cpu_thread_count);
 
@@ -204,33 +204,78 @@ void fill_hash_join_buff_on_device_sharded_bucketized(int32_t* buff,
                                                       const size_t grid_size_x,
                                                       const int64_t bucket_normalization);
 
+// Counts the rows of every key of a perfect hash table in count_buff, laid out like the
+// counts of a one-to-many table, and returns the largest count. The one-to-many builds
+// below take the counts as they are when counts_filled is set.
+int32_t count_hash_join_keys_bucketized(int32_t* count_buff,
+                                        const HashEntryInfo hash_entry_info,
+                                        const int32_t invalid_slot_val,
+                                        const JoinColumn& join_column,
+                                        const JoinColumnTypeInfo& type_info,
+                                        const int32_t* sd_inner_to_outer_translation_map,
+                                        const int32_t min_inner_elem,
+                                        const unsigned cpu_thread_count);
+
 void fill_one_to_many_hash_table(int32_t* buff,
                                  const HashEntryInfo hash_entry_info,
                                  const int32_t invalid_slot_val,
                                  const JoinColumn& join_column,
                                  const JoinColumnTypeInfo& type_info,
-                                 const void* sd_inner_proxy,
-                                 const void* sd_outer_proxy,
-                                 const unsigned cpu_thread_count);
-
-void fill_one_to_many_hash_table_bucketized(int32_t* buff,
-                                            const HashEntryInfo hash_entry_info,
-                                            const int32_t invalid_slot_val,
-                                            const JoinColumn& join_column,
-                                            const JoinColumnTypeInfo& type_info,
-                                            const void* sd_inner_proxy,
-                                            const void* sd_outer_proxy,
-                                            const unsigned cpu_thread_count);
-
-void fill_one_to_many_hash_table_sharded_bucketized(int32_t* buff,
-                                                    const HashEntryInfo hash_entry_info,
-                                                    const int32_t invalid_slot_val,
-                                                    const JoinColumn& join_column,
-                                                    const JoinColumnTypeInfo& type_info,
-                                                    const ShardInfo& shard_info,
-                                                    const void* sd_inner_proxy,
-                                                    const void* sd_outer_proxy,
-                                                    const unsigned cpu_thread_count);
+                                 const int32_t* sd_inner_to_outer_translation_map,
+                                 const int32_t min_inner_elem,
+                                 const unsigned cpu_thread_count,
+                                 const bool counts_filled = false);
+
+void fill_one_to_many_hash_table_bucketized(
+    int32_t* buff,
+    const HashEntryInfo hash_entry_info,
+    const int32_t invalid_slot_val,
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const unsigned cpu_thread_count,
+    const bool counts_filled = false);
+
+// Cache conscious builds of large hash tables on CPU: the rows of the build side are
+// first partitioned on the slot of their key, then each partition of the hash table is
+// filled by a single thread. The hash tables are laid out the same way.
+int fill_hash_join_buff_bucketized_partitioned(
+    int32_t* buff,
+    const HashEntryInfo hash_entry_info,
+    const int32_t invalid_slot_val,
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const unsigned cpu_thread_count);
+
+void fill_one_to_many_hash_table_bucketized_partitioned(
+    int32_t* buff,
+    const HashEntryInfo hash_entry_info,
+    const int32_t invalid_slot_val,
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const unsigned cpu_thread_count,
+    const bool counts_filled = false);
+
+// The memory the partitions of the build side take, besides the hash table itself.
+size_t get_partitioned_build_size_bytes(const size_t row_count,
+                                        const size_t hash_entry_count,
+                                        const unsigned cpu_thread_count);
+
+void fill_one_to_many_hash_table_sharded_bucketized(
+    int32_t* buff,
+    const HashEntryInfo hash_entry_info,
+    const int32_t invalid_slot_val,
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info,
+    const ShardInfo& shard_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const unsigned cpu_thread_count);
 
 void fill_one_to_many_hash_table_on_device(int32_t* buff,
                                            const HashEntryInfo hash_entry_info,
@@ -340,8 +385,8 @@ void fill_one_to_many_baseline_hash_table_32(
     const std::vector<JoinColumn>& join_column_per_key,
     const std::vector<JoinColumnTypeInfo>& type_info_per_key,
     const std::vector<JoinBucketInfo>& join_bucket_info,
-    const std::vector<const void*>& sd_inner_proxy_per_key,
-    const std::vector<const void*>& sd_outer_proxy_per_key,
+    const std::vector<const int32_t*>& sd_inner_to_outer_translation_maps,
+    const std::vector<int32_t>& sd_min_inner_elems,
     const int32_t cpu_thread_count);
 
 void fill_one_to_many_baseline_hash_table_64(
@@ -353,8 +398,8 @@ void fill_one_to_many_baseline_hash_table_64(
     const std::vector<JoinColumn>& join_column_per_key,
     const std::vector<JoinColumnTypeInfo>& type_info_per_key,
     const std::vector<JoinBucketInfo>& join_bucket_info,
-    const std::vector<const void*>& sd_inner_proxy_per_key,
-    const std::vector<const void*>& sd_outer_proxy_per_key,
+    const std::vector<const int32_t*>& sd_inner_to_outer_translation_maps,
+    const std::vector<int32_t>& sd_min_inner_elems,
     const int32_t cpu_thread_count);
 
 void fill_one_to_many_baseline_hash_table_on_device_32(
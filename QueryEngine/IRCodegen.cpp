@@ -93,6 +93,10 @@ std::vector<llvm::Value*> CodeGenerator::codegen(const Analyzer::Expr* expr,
   if (lower_expr) {
     return {codegen(lower_expr, co)};
   }
+  auto upper_expr = dynamic_cast<const Analyzer::UpperExpr*>(expr);
+  if (upper_expr) {
+    return {codegen(upper_expr, co)};
+  }
   auto cardinality_expr = dynamic_cast<const Analyzer::CardinalityExpr*>(expr);
   if (cardinality_expr) {
     return {codegen(cardinality_expr, co)};
@@ -438,6 +442,10 @@ std::shared_ptr<JoinHashTableInterface> Executor::buildCurrentLevelHashTable(
       current_level_hash_table = hash_table_or_error.hash_table;
     }
     if (hash_table_or_error.hash_table) {
+      if (current_level_join_conditions.type == JoinType::INNER) {
+        plan_state_->join_info_.inner_join_table_indices_.insert(
+            plan_state_->join_info_.join_hash_tables_.size());
+      }
       plan_state_->join_info_.join_hash_tables_.push_back(hash_table_or_error.hash_table);
       plan_state_->join_info_.equi_join_tautologies_.push_back(qual_bin_oper);
     } else {
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    JoinBloomFilterInl.h
+ * @brief   Bloom filter on the keys of a perfect join hash table, checked by the probe
+ *          side before loading the hash table entry. Two bits are set per key; the
+ *          number of bits is a power of two and bit_mask is that number minus one.
+ */
+
+#ifndef QUERYENGINE_JOINBLOOMFILTERINL_H
+#define QUERYENGINE_JOINBLOOMFILTERINL_H
+
+#include <cstdint>
+#include "../Shared/funcannotations.h"
+
+// Finalizer of the 64-bit MurmurHash3, consecutive keys must spread over the filter.
+FORCE_INLINE DEVICE uint64_t join_bloom_filter_hash(const int64_t key) {
+  uint64_t h = static_cast<uint64_t>(key);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdLLU;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53LLU;
+  h ^= h >> 33;
+  return h;
+}
+
+// Position of the first (idx 0) or the second (idx 1) bit of a key with the given hash.
+FORCE_INLINE DEVICE uint64_t join_bloom_filter_bit(const uint64_t h,
+                                                   const int idx,
+                                                   const uint64_t bit_mask) {
+  return (idx ? (h >> 32) | (h << 32) : h) & bit_mask;
+}
+
+FORCE_INLINE DEVICE bool join_bloom_filter_may_contain(const uint64_t* bits,
+                                                       const uint64_t bit_mask,
+                                                       const int64_t key) {
+  const auto h = join_bloom_filter_hash(key);
+  const auto bit1 = join_bloom_filter_bit(h, 0, bit_mask);
+  const auto bit2 = join_bloom_filter_bit(h, 1, bit_mask);
+  return ((bits[bit1 >> 6] >> (bit1 & 63)) & 1) && ((bits[bit2 >> 6] >> (bit2 & 63)) & 1);
+}
+
+#endif  // QUERYENGINE_JOINBLOOMFILTERINL_H
@@ -20,10 +20,12 @@
 #include "Execute.h"
 #include "ExpressionRewrite.h"
 #include "HashJoinRuntime.h"
+#include "JoinBloomFilterInl.h"
 #include "RangeTableIndexVisitor.h"
 #include "RuntimeFunctions.h"
 #include "Shared/Logger.h"
 
+#include <algorithm>
 #include <future>
 #include <numeric>
 #include <thread>
@@ -259,6 +261,12 @@ std::vector<std::pair<JoinHashTable::JoinHashTableCacheKey,
                       std::shared_ptr<std::vector<int32_t>>>>
     JoinHashTable::join_hash_table_cache_;
 std::mutex JoinHashTable::join_hash_table_cache_mutex_;
+std::map<ChunkKey, JoinHashTable::HashTypeCacheEntry> JoinHashTable::hash_type_cache_;
+std::mutex JoinHashTable::hash_type_cache_mutex_;
+std::vector<std::pair<std::weak_ptr<std::vector<int32_t>>,
+                      std::shared_ptr<const JoinHashTable::RuntimeFilters>>>
+    JoinHashTable::runtime_filters_cache_;
+std::mutex JoinHashTable::runtime_filters_cache_mutex_;
 
 size_t get_shard_count(const Analyzer::BinOper* join_condition,
                        const Executor* executor) {
@@ -410,6 +418,7 @@ std::shared_ptr<JoinHashTable> JoinHashTable::getInstance(
                                                        device_count));
   try {
     join_hash_table->reify();
+    join_hash_table->buildRuntimeFilters();
   } catch (const TableMustBeReplicated& e) {
     // Throw a runtime error to abort the query
     join_hash_table->freeHashBufferMemory();
@@ -504,6 +513,20 @@ void JoinHashTable::reify() {
       static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
     throw TooManyHashEntries();
   }
+  // Tables of intermediate results are built once, there is no point in counting keys.
+  const bool cache_hash_type = hash_type_ == JoinHashTableInterface::HashType::OneToOne &&
+                               inner_col->get_table_id() > 0;
+  const auto hash_type_cache_key = genHashTypeCacheKey(inner_col);
+  const auto num_tuples = query_info.getNumTuples();
+  if (cache_hash_type) {
+    std::lock_guard<std::mutex> hash_type_cache_lock(hash_type_cache_mutex_);
+    const auto it = hash_type_cache_.find(hash_type_cache_key);
+    if (it != hash_type_cache_.end() && it->second.num_tuples == num_tuples) {
+      hash_type_ = it->second.hash_type;
+    } else {
+      count_keys_ = true;
+    }
+  }
 #ifdef HAVE_CUDA
   gpu_hash_table_buff_.resize(device_count_);
   gpu_hash_table_err_buff_.resize(device_count_);
@@ -558,6 +581,138 @@ void JoinHashTable::reify() {
       init_thread.get();
     }
   }
+  count_keys_ = false;
+  key_counts_ = {};
+  if (cache_hash_type) {
+    std::lock_guard<std::mutex> hash_type_cache_lock(hash_type_cache_mutex_);
+    hash_type_cache_[hash_type_cache_key] = {hash_type_, num_tuples};
+  }
+}
+
+namespace {
+
+// Smaller tables stay in cache, checking a Bloom filter first wouldn't save much.
+constexpr size_t kMinBloomFilteredTableBytes{8 * 1024 * 1024};
+// Two bits are set per key, which gives a false positive rate around 1.4%.
+constexpr size_t kBloomFilterBitsPerKey{16};
+
+void add_to_bloom_filter(uint64_t* bits, const uint64_t bit_mask, const int64_t key) {
+  const auto h = join_bloom_filter_hash(key);
+  for (int idx = 0; idx < 2; ++idx) {
+    const auto bit = join_bloom_filter_bit(h, idx, bit_mask);
+    __atomic_fetch_or(&bits[bit >> 6], uint64_t(1) << (bit & 63), __ATOMIC_RELAXED);
+  }
+}
+
+}  // namespace
+
+// Derives the filters the probe side checks before the hash table from the keys of the
+// built table: the bounds of the keys, which allow skipping the outer fragments without
+// any of them, and a Bloom filter when the table is too big to be cache resident and
+// sparse enough for the filter to be much smaller. The offsets buffer of both layouts
+// holds -1 for the keys which aren't in the table.
+void JoinHashTable::buildRuntimeFilters() {
+  key_bounds_ = std::nullopt;
+  runtime_filters_.reset();
+  if (!g_enable_join_runtime_filters || isBitwiseEq()) {
+    return;
+  }
+  key_bounds_ = std::make_pair(col_range_.getIntMin(), col_range_.getIntMax());
+  if (!cpu_hash_table_buff_ || shardCount() ||
+      col_var_->get_type_info().get_type() == kDATE) {
+    return;
+  }
+  std::lock_guard<std::mutex> runtime_filters_cache_lock(runtime_filters_cache_mutex_);
+  runtime_filters_cache_.erase(
+      std::remove_if(runtime_filters_cache_.begin(),
+                     runtime_filters_cache_.end(),
+                     [](const auto& kv) { return kv.first.expired(); }),
+      runtime_filters_cache_.end());
+  for (const auto& kv : runtime_filters_cache_) {
+    if (kv.first.lock() == cpu_hash_table_buff_) {
+      runtime_filters_ = kv.second;
+      key_bounds_ = runtime_filters_->key_bounds;
+      return;
+    }
+  }
+
+  CHECK_LE(hash_entry_count_, cpu_hash_table_buff_->size());
+  const auto buff = cpu_hash_table_buff_->data();
+  const auto min_key = col_range_.getIntMin();
+  const size_t thread_count = cpu_threads();
+  const auto thread_entry_count = (hash_entry_count_ + thread_count - 1) / thread_count;
+  std::vector<std::future<std::tuple<size_t, size_t, size_t>>> scan_threads;
+  for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    const auto start_index = std::min(thread_idx * thread_entry_count, hash_entry_count_);
+    const auto end_index = std::min(start_index + thread_entry_count, hash_entry_count_);
+    scan_threads.push_back(std::async(std::launch::async, [buff, start_index, end_index] {
+      size_t first_idx{end_index};
+      size_t last_idx{end_index};
+      size_t key_count{0};
+      for (size_t i = start_index; i < end_index; ++i) {
+        if (buff[i] != -1) {
+          first_idx = key_count ? first_idx : i;
+          last_idx = i;
+          ++key_count;
+        }
+      }
+      return std::make_tuple(first_idx, last_idx, key_count);
+    }));
+  }
+  size_t first_key_idx{hash_entry_count_};
+  size_t last_key_idx{0};
+  size_t key_count{0};
+  for (auto& scan_thread : scan_threads) {
+    const auto [first_idx, last_idx, thread_key_count] = scan_thread.get();
+    if (thread_key_count) {
+      first_key_idx = std::min(first_key_idx, first_idx);
+      last_key_idx = std::max(last_key_idx, last_idx);
+      key_count += thread_key_count;
+    }
+  }
+  auto runtime_filters = std::make_shared<RuntimeFilters>();
+  // An empty table can't match anything, min > max then.
+  runtime_filters->key_bounds =
+      key_count ? std::make_pair(min_key + static_cast<int64_t>(first_key_idx),
+                                 min_key + static_cast<int64_t>(last_key_idx))
+                : std::make_pair(std::numeric_limits<int64_t>::max(),
+                                 std::numeric_limits<int64_t>::min());
+
+  const auto table_bytes = cpu_hash_table_buff_->size() * sizeof(int32_t);
+  size_t bit_count{64};
+  while (bit_count < key_count * kBloomFilterBitsPerKey) {
+    bit_count *= 2;
+  }
+  if (key_count && table_bytes >= kMinBloomFilteredTableBytes &&
+      bit_count / 8 * 4 <= table_bytes) {
+    auto& bloom_filter = runtime_filters->bloom_filter;
+    bloom_filter.resize(bit_count / 64);
+    const auto bits = bloom_filter.data();
+    const auto bit_mask = bit_count - 1;
+    std::vector<std::future<void>> fill_threads;
+    for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+      const auto start_index =
+          std::min(thread_idx * thread_entry_count, hash_entry_count_);
+      const auto end_index =
+          std::min(start_index + thread_entry_count, hash_entry_count_);
+      fill_threads.push_back(std::async(
+          std::launch::async, [buff, bits, bit_mask, min_key, start_index, end_index] {
+            for (size_t i = start_index; i < end_index; ++i) {
+              if (buff[i] != -1) {
+                add_to_bloom_filter(bits, bit_mask, min_key + static_cast<int64_t>(i));
+              }
+            }
+          }));
+    }
+    for (auto& fill_thread : fill_threads) {
+      fill_thread.get();
+    }
+    VLOG(1) << "Built a Bloom filter of " << bit_count << " bits on the " << key_count
+            << " keys of the perfect hash table for qual: " << qual_bin_oper_->toString();
+  }
+  runtime_filters_ = runtime_filters;
+  key_bounds_ = runtime_filters_->key_bounds;
+  runtime_filters_cache_.emplace_back(cpu_hash_table_buff_, runtime_filters_);
 }
 
 ChunkKey JoinHashTable::genHashTableKey(
@@ -585,6 +740,16 @@ ChunkKey JoinHashTable::genHashTableKey(
   return hash_table_key;
 }
 
+// Bitwise equality turns the nulls into keys as well. The cached layout is only used as
+// long as the row count of the table is the one it was found for, a table which changes
+// size replaces the entry instead of adding one.
+ChunkKey JoinHashTable::genHashTypeCacheKey(const Analyzer::ColumnVar* inner_col) const {
+  return {executor_->getCatalog()->getCurrentDB().dbId,
+          inner_col->get_table_id(),
+          inner_col->get_column_id(),
+          isBitwiseEq()};
+}
+
 void JoinHashTable::reifyOneToOneForDevice(
     const std::vector<Fragmenter_Namespace::FragmentInfo>& fragments,
     const int device_id,
@@ -708,6 +873,41 @@ void JoinHashTable::checkHashJoinReplicationConstraint(const int table_id) const
   }
 }
 
+namespace {
+
+// Large hash tables are filled a cache sized partition at a time, see
+// fill_hash_join_buff_bucketized_partitioned. Only the build is partitioned, the
+// generated code still probes the whole table one row at a time. The partitions copy
+// the build side, so the plain build is used when the copy doesn't fit in the part of
+// the CPU buffer pool which is still free.
+bool use_radix_partitioned_build(const size_t hash_entry_count,
+                                 const size_t buff_entry_count,
+                                 const JoinColumn& join_column,
+                                 const unsigned cpu_thread_count,
+                                 Data_Namespace::DataMgr& data_mgr) {
+  if (!g_hash_join_radix_partition_threshold ||
+      buff_entry_count * sizeof(int32_t) <= g_hash_join_radix_partition_threshold) {
+    return false;
+  }
+  const auto partitions_size = get_partitioned_build_size_bytes(
+      join_column.num_elems, hash_entry_count, cpu_thread_count);
+  size_t free_size{0};
+  for (const auto& memory_info :
+       data_mgr.getMemoryInfo(Data_Namespace::MemoryLevel::CPU_LEVEL)) {
+    free_size += (memory_info.maxNumPages - memory_info.numPageAllocated) *
+                 memory_info.pageSize;
+  }
+  if (partitions_size > free_size) {
+    VLOG(1) << "Not partitioning the hash table build, its partitions need "
+            << partitions_size << " bytes and the CPU buffer pool has " << free_size
+            << " bytes free";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 void JoinHashTable::initOneToOneHashTableOnCpu(
     const JoinColumn& join_column,
     const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
@@ -718,10 +918,9 @@ void JoinHashTable::initOneToOneHashTableOnCpu(
   CHECK(inner_col);
   const auto& ti = inner_col->get_type_info();
   if (!cpu_hash_table_buff_) {
-    cpu_hash_table_buff_ = std::make_shared<std::vector<int32_t>>(
-        hash_entry_info.getNormalizedHashEntryCount());
     const StringDictionaryProxy* sd_inner_proxy{nullptr};
     const StringDictionaryProxy* sd_outer_proxy{nullptr};
+    StringDictionaryProxy::TranslationMap sd_inner_to_outer_translation_map;
     if (ti.is_string()) {
       CHECK_EQ(kENCODING_DICT, ti.get_compression());
       sd_inner_proxy = executor_->getStringDictionaryProxy(
@@ -732,8 +931,36 @@ void JoinHashTable::initOneToOneHashTableOnCpu(
       sd_outer_proxy = executor_->getStringDictionaryProxy(
           outer_col->get_comp_param(), executor_->row_set_mem_owner_, true);
       CHECK(sd_outer_proxy);
+      sd_inner_to_outer_translation_map =
+          sd_inner_proxy->buildTranslationMap(sd_outer_proxy);
     }
     int thread_count = cpu_threads();
+    const JoinColumnTypeInfo type_info{static_cast<size_t>(ti.get_size()),
+                                       col_range_.getIntMin(),
+                                       col_range_.getIntMax(),
+                                       inline_fixed_encoding_null_val(ti),
+                                       isBitwiseEq(),
+                                       col_range_.getIntMax() + 1,
+                                       get_join_column_type_kind(ti)};
+    if (count_keys_) {
+      std::vector<int32_t> key_counts(hash_entry_info.getNormalizedHashEntryCount());
+      const auto max_key_count =
+          count_hash_join_keys_bucketized(key_counts.data(),
+                                          hash_entry_info,
+                                          hash_join_invalid_val,
+                                          join_column,
+                                          type_info,
+                                          sd_inner_to_outer_translation_map.data(),
+                                          sd_inner_to_outer_translation_map.min_id,
+                                          thread_count);
+      if (max_key_count > 1) {
+        // The one-to-many table starts from these counts, nothing else was built.
+        key_counts_ = std::move(key_counts);
+        throw NeedsOneToManyHash();
+      }
+    }
+    cpu_hash_table_buff_ = std::make_shared<std::vector<int32_t>>(
+        hash_entry_info.getNormalizedHashEntryCount());
     std::vector<std::thread> init_cpu_buff_threads;
     for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
       init_cpu_buff_threads.emplace_back(
@@ -750,38 +977,47 @@ void JoinHashTable::initOneToOneHashTableOnCpu(
     }
     init_cpu_buff_threads.clear();
     int err{0};
-    for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
-      init_cpu_buff_threads.emplace_back([this,
-                                          hash_join_invalid_val,
-                                          &join_column,
-                                          sd_inner_proxy,
-                                          sd_outer_proxy,
-                                          thread_idx,
-                                          thread_count,
-                                          &ti,
-                                          &err,
-                                          hash_entry_info] {
-        int partial_err =
-            fill_hash_join_buff_bucketized(&(*cpu_hash_table_buff_)[0],
-                                           hash_join_invalid_val,
-                                           join_column,
-                                           {static_cast<size_t>(ti.get_size()),
-                                            col_range_.getIntMin(),
-                                            col_range_.getIntMax(),
-                                            inline_fixed_encoding_null_val(ti),
-                                            isBitwiseEq(),
-                                            col_range_.getIntMax() + 1,
-                                            get_join_column_type_kind(ti)},
-                                           sd_inner_proxy,
-                                           sd_outer_proxy,
-                                           thread_idx,
-                                           thread_count,
-                                           hash_entry_info.bucket_normalization);
-        __sync_val_compare_and_swap(&err, 0, partial_err);
-      });
-    }
-    for (auto& t : init_cpu_buff_threads) {
-      t.join();
+    if (use_radix_partitioned_build(hash_entry_info.getNormalizedHashEntryCount(),
+                                    hash_entry_info.getNormalizedHashEntryCount(),
+                                    join_column,
+                                    thread_count,
+                                    executor_->getCatalog()->getDataMgr())) {
+      err = fill_hash_join_buff_bucketized_partitioned(
+          &(*cpu_hash_table_buff_)[0],
+          hash_entry_info,
+          hash_join_invalid_val,
+          join_column,
+          type_info,
+          sd_inner_to_outer_translation_map.data(),
+          sd_inner_to_outer_translation_map.min_id,
+          thread_count);
+    } else {
+      for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+        init_cpu_buff_threads.emplace_back([this,
+                                            hash_join_invalid_val,
+                                            &join_column,
+                                            &sd_inner_to_outer_translation_map,
+                                            thread_idx,
+                                            thread_count,
+                                            &type_info,
+                                            &err,
+                                            hash_entry_info] {
+          int partial_err =
+              fill_hash_join_buff_bucketized(&(*cpu_hash_table_buff_)[0],
+                                             hash_join_invalid_val,
+                                             join_column,
+                                             type_info,
+                                             sd_inner_to_outer_translation_map.data(),
+                                             sd_inner_to_outer_translation_map.min_id,
+                                             thread_idx,
+                                             thread_count,
+                                             hash_entry_info.bucket_normalization);
+          __sync_val_compare_and_swap(&err, 0, partial_err);
+        });
+      }
+      for (auto& t : init_cpu_buff_threads) {
+        t.join();
+      }
     }
     if (err) {
       cpu_hash_table_buff_.reset();
@@ -812,6 +1048,7 @@ void JoinHashTable::initOneToManyHashTableOnCpu(
       2 * hash_entry_info.getNormalizedHashEntryCount() + join_column.num_elems);
   const StringDictionaryProxy* sd_inner_proxy{nullptr};
   const StringDictionaryProxy* sd_outer_proxy{nullptr};
+  StringDictionaryProxy::TranslationMap sd_inner_to_outer_translation_map;
   if (ti.is_string()) {
     CHECK_EQ(kENCODING_DICT, ti.get_compression());
     sd_inner_proxy = executor_->getStringDictionaryProxy(
@@ -822,6 +1059,8 @@ void JoinHashTable::initOneToManyHashTableOnCpu(
     sd_outer_proxy = executor_->getStringDictionaryProxy(
         outer_col->get_comp_param(), executor_->row_set_mem_owner_, true);
     CHECK(sd_outer_proxy);
+    sd_inner_to_outer_translation_map =
+        sd_inner_proxy->buildTranslationMap(sd_outer_proxy);
   }
   int thread_count = cpu_threads();
   std::vector<std::future<void>> init_threads;
@@ -840,8 +1079,38 @@ void JoinHashTable::initOneToManyHashTableOnCpu(
   for (auto& child : init_threads) {
     child.get();
   }
-
-  if (ti.get_type() == kDATE) {
+  // The keys may have been counted already, while trying to build a one-to-one table.
+  const auto hash_entry_count = hash_entry_info.getNormalizedHashEntryCount();
+  const bool counts_filled = key_counts_.size() == hash_entry_count;
+  if (counts_filled) {
+    std::copy(key_counts_.begin(),
+              key_counts_.end(),
+              cpu_hash_table_buff_->begin() + hash_entry_count);
+    key_counts_ = {};
+  }
+
+  if (use_radix_partitioned_build(hash_entry_count,
+                                  2 * hash_entry_count,
+                                  join_column,
+                                  thread_count,
+                                  executor_->getCatalog()->getDataMgr())) {
+    fill_one_to_many_hash_table_bucketized_partitioned(
+        &(*cpu_hash_table_buff_)[0],
+        hash_entry_info,
+        hash_join_invalid_val,
+        join_column,
+        {static_cast<size_t>(ti.get_size()),
+         col_range_.getIntMin(),
+         col_range_.getIntMax(),
+         inline_fixed_encoding_null_val(ti),
+         isBitwiseEq(),
+         col_range_.getIntMax() + 1,
+         get_join_column_type_kind(ti)},
+        sd_inner_to_outer_translation_map.data(),
+        sd_inner_to_outer_translation_map.min_id,
+        thread_count,
+        counts_filled);
+  } else if (ti.get_type() == kDATE) {
     fill_one_to_many_hash_table_bucketized(&(*cpu_hash_table_buff_)[0],
                                            hash_entry_info,
                                            hash_join_invalid_val,
@@ -853,9 +1122,10 @@ void JoinHashTable::initOneToManyHashTableOnCpu(
                                             isBitwiseEq(),
                                             col_range_.getIntMax() + 1,
                                             get_join_column_type_kind(ti)},
-                                           sd_inner_proxy,
-                                           sd_outer_proxy,
-                                           thread_count);
+                                           sd_inner_to_outer_translation_map.data(),
+                                           sd_inner_to_outer_translation_map.min_id,
+                                           thread_count,
+                                           counts_filled);
   } else {
     fill_one_to_many_hash_table(&(*cpu_hash_table_buff_)[0],
                                 hash_entry_info,
@@ -868,9 +1138,10 @@ void JoinHashTable::initOneToManyHashTableOnCpu(
                                  isBitwiseEq(),
                                  col_range_.getIntMax() + 1,
                                  get_join_column_type_kind(ti)},
-                                sd_inner_proxy,
-                                sd_outer_proxy,
-                                thread_count);
+                                sd_inner_to_outer_translation_map.data(),
+                                sd_inner_to_outer_translation_map.min_id,
+                                thread_count,
+                                counts_filled);
   }
 }
 
@@ -1177,6 +1448,9 @@ void JoinHashTable::initHashTableOnCpuFromCache(
     if (kv.first == cache_key) {
       std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
       cpu_hash_table_buff_ = kv.second;
+      if (auto query_profile = executor_->getQueryProfile()) {
+        query_profile->addHashTableCacheHit();
+      }
       break;
     }
   }
@@ -1290,6 +1564,18 @@ std::vector<llvm::Value*> JoinHashTable::getHashJoinArgs(llvm::Value* hash_ptr,
   return hash_join_idx_args;
 }
 
+std::vector<llvm::Value*> JoinHashTable::getBloomFilterArgs(
+    const CompilationOptions& co) const {
+  if (!runtime_filters_ || runtime_filters_->bloom_filter.empty() ||
+      co.device_type != ExecutorDeviceType::CPU) {
+    return {};
+  }
+  const auto& bloom_filter = runtime_filters_->bloom_filter;
+  const auto bit_mask = static_cast<int64_t>(bloom_filter.size() * 64 - 1);
+  return {executor_->cgen_state_->llInt(reinterpret_cast<int64_t>(bloom_filter.data())),
+          executor_->cgen_state_->llInt(bit_mask)};
+}
+
 HashJoinMatchingSet JoinHashTable::codegenMatchingSet(const CompilationOptions& co,
                                                       const size_t index) {
   const auto cols = get_cols(
@@ -1312,7 +1598,8 @@ HashJoinMatchingSet JoinHashTable::codegenMatchingSet(const CompilationOptions&
                             isBitwiseEq(),
                             sub_buff_size,
                             executor_,
-                            bucketize);
+                            bucketize,
+                            getBloomFilterArgs(co));
 }
 
 HashJoinMatchingSet JoinHashTable::codegenMatchingSet(
@@ -1322,7 +1609,8 @@ HashJoinMatchingSet JoinHashTable::codegenMatchingSet(
     const bool is_bw_eq,
     const int64_t sub_buff_size,
     Executor* executor,
-    bool is_bucketized) {
+    bool is_bucketized,
+    const std::vector<llvm::Value*>& bloom_filter_args) {
   using namespace std::string_literals;
 
   std::string fname(is_bucketized ? "bucketized_hash_join_idx"s : "hash_join_idx"s);
@@ -1336,8 +1624,15 @@ HashJoinMatchingSet JoinHashTable::codegenMatchingSet(
   if (!is_bw_eq && col_is_nullable) {
     fname += "_nullable";
   }
+  auto hash_join_idx_args = hash_join_idx_args_in;
+  if (!bloom_filter_args.empty()) {
+    CHECK(!is_bucketized && !is_bw_eq && !is_sharded);
+    fname += "_bloom_filtered";
+    hash_join_idx_args.insert(
+        hash_join_idx_args.end(), bloom_filter_args.begin(), bloom_filter_args.end());
+  }
 
-  const auto slot_lv = executor->cgen_state_->emitCall(fname, hash_join_idx_args_in);
+  const auto slot_lv = executor->cgen_state_->emitCall(fname, hash_join_idx_args);
   const auto slot_valid_lv = executor->cgen_state_->ir_builder_.CreateICmpSGE(
       slot_lv, executor->cgen_state_->llInt(int64_t(0)));
 
@@ -1346,7 +1641,6 @@ HashJoinMatchingSet JoinHashTable::codegenMatchingSet(
 
   auto count_ptr = executor->cgen_state_->ir_builder_.CreateAdd(
       pos_ptr, executor->cgen_state_->llInt(sub_buff_size));
-  auto hash_join_idx_args = hash_join_idx_args_in;
   hash_join_idx_args[0] = executor->cgen_state_->ir_builder_.CreatePtrToInt(
       count_ptr, llvm::Type::getInt64Ty(executor->cgen_state_->context_));
 
@@ -1506,7 +1800,7 @@ llvm::Value* JoinHashTable::codegenSlot(const CompilationOptions& co,
   auto hash_ptr = codegenHashTableLoad(index);
   CHECK(hash_ptr);
   const int shard_count = shardCount();
-  const auto hash_join_idx_args = getHashJoinArgs(hash_ptr, key_col, shard_count, co);
+  auto hash_join_idx_args = getHashJoinArgs(hash_ptr, key_col, shard_count, co);
 
   const auto& key_col_ti = key_col->get_type_info();
   std::string fname((key_col_ti.get_type() == kDATE) ? "bucketized_hash_join_idx"s
@@ -1522,6 +1816,12 @@ llvm::Value* JoinHashTable::codegenSlot(const CompilationOptions& co,
   if (!isBitwiseEq() && !key_col_ti.get_notnull()) {
     fname += "_nullable";
   }
+  const auto bloom_filter_args = getBloomFilterArgs(co);
+  if (!bloom_filter_args.empty()) {
+    fname += "_bloom_filtered";
+    hash_join_idx_args.insert(
+        hash_join_idx_args.end(), bloom_filter_args.begin(), bloom_filter_args.end());
+  }
   return executor_->cgen_state_->emitCall(fname, hash_join_idx_args);
 }
 
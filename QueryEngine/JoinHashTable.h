@@ -41,6 +41,7 @@
 #include <cuda.h>
 #endif
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
@@ -48,6 +49,9 @@
 class Executor;
 struct HashEntryInfo;
 
+extern size_t g_hash_join_radix_partition_threshold;
+extern bool g_enable_join_runtime_filters;
+
 class JoinHashTable : public JoinHashTableInterface {
  public:
   //! Make hash table from an in-flight SQL query's parse tree etc.
@@ -100,6 +104,10 @@ class JoinHashTable : public JoinHashTableInterface {
 
   size_t payloadBufferOff() const noexcept override;
 
+  std::optional<std::pair<int64_t, int64_t>> getKeyBounds() const noexcept override {
+    return key_bounds_;
+  }
+
   static HashJoinMatchingSet codegenMatchingSet(
       const std::vector<llvm::Value*>& hash_join_idx_args_in,
       const bool is_sharded,
@@ -107,7 +115,8 @@ class JoinHashTable : public JoinHashTableInterface {
       const bool is_bw_eq,
       const int64_t sub_buff_size,
       Executor* executor,
-      const bool is_bucketized = false);
+      const bool is_bucketized = false,
+      const std::vector<llvm::Value*>& bloom_filter_args = {});
 
   static llvm::Value* codegenHashTableLoad(const size_t table_idx, Executor* executor);
 
@@ -115,8 +124,12 @@ class JoinHashTable : public JoinHashTableInterface {
     VLOG(1) << "Invalidate " << join_hash_table_cache_.size()
             << " cached baseline hashtable.";
     return []() -> void {
-      std::lock_guard<std::mutex> guard(join_hash_table_cache_mutex_);
-      join_hash_table_cache_.clear();
+      {
+        std::lock_guard<std::mutex> guard(join_hash_table_cache_mutex_);
+        join_hash_table_cache_.clear();
+      }
+      std::lock_guard<std::mutex> guard(hash_type_cache_mutex_);
+      hash_type_cache_.clear();
     };
   }
 
@@ -151,6 +164,7 @@ class JoinHashTable : public JoinHashTableInterface {
       , hash_type_(preferred_hash_type)
       , hash_entry_count_(0)
       , col_range_(col_range)
+      , count_keys_(false)
       , executor_(executor)
       , column_cache_(column_cache)
       , device_count_(device_count) {
@@ -163,6 +177,8 @@ class JoinHashTable : public JoinHashTableInterface {
       const Analyzer::Expr* outer_col,
       const Analyzer::ColumnVar* inner_col) const;
 
+  ChunkKey genHashTypeCacheKey(const Analyzer::ColumnVar* inner_col) const;
+
   void reify();
   void reifyOneToOneForDevice(
       const std::vector<Fragmenter_Namespace::FragmentInfo>& fragments,
@@ -215,6 +231,10 @@ class JoinHashTable : public JoinHashTableInterface {
                                             const int shard_count,
                                             const CompilationOptions& co);
 
+  void buildRuntimeFilters();
+
+  std::vector<llvm::Value*> getBloomFilterArgs(const CompilationOptions& co) const;
+
   bool isBitwiseEq() const;
 
   void freeHashBufferMemory();
@@ -242,6 +262,17 @@ class JoinHashTable : public JoinHashTableInterface {
   std::vector<Data_Namespace::AbstractBuffer*> gpu_hash_table_err_buff_;
 #endif
   ExpressionRange col_range_;
+  // Set when the layout of the table isn't known yet: the keys are counted before the
+  // build, the counts are kept for the one-to-many table if some key isn't unique.
+  bool count_keys_;
+  std::vector<int32_t> key_counts_;
+  // Filters on the keys of the table for the probe side, see buildRuntimeFilters().
+  struct RuntimeFilters {
+    std::pair<int64_t, int64_t> key_bounds;
+    std::vector<uint64_t> bloom_filter;
+  };
+  std::optional<std::pair<int64_t, int64_t>> key_bounds_;
+  std::shared_ptr<const RuntimeFilters> runtime_filters_;
   Executor* executor_;
   ColumnCacheMap& column_cache_;
   const int device_count_;
@@ -265,6 +296,20 @@ class JoinHashTable : public JoinHashTableInterface {
       std::pair<JoinHashTableCacheKey, std::shared_ptr<std::vector<int32_t>>>>
       join_hash_table_cache_;
   static std::mutex join_hash_table_cache_mutex_;
+  // Layout of the last table built on a column, which tells whether its keys are unique,
+  // along with the row count of its table then, see genHashTypeCacheKey().
+  struct HashTypeCacheEntry {
+    HashType hash_type;
+    size_t num_tuples;
+  };
+  static std::map<ChunkKey, HashTypeCacheEntry> hash_type_cache_;
+  static std::mutex hash_type_cache_mutex_;
+  // The filters of a CPU table are kept for as long as the table is, the code generated
+  // for the probe refers to the Bloom filter by address and can be reused as well.
+  static std::vector<std::pair<std::weak_ptr<std::vector<int32_t>>,
+                               std::shared_ptr<const RuntimeFilters>>>
+      runtime_filters_cache_;
+  static std::mutex runtime_filters_cache_mutex_;
 };
 
 // TODO(alex): Functions below need to be moved to a separate translation unit, they don't
@@ -18,6 +18,7 @@
 
 #include <llvm/IR/Value.h>
 #include <cstdint>
+#include <optional>
 #include <set>
 #include <string>
 #include "Allocators/ThrustAllocator.h"
@@ -132,6 +133,12 @@ class JoinHashTableInterface {
 
   virtual size_t payloadBufferOff() const noexcept = 0;
 
+  //! Bounds of the keys in the hash table, if known. No row of the outer table with a
+  //! join key out of these bounds can find a match.
+  virtual std::optional<std::pair<int64_t, int64_t>> getKeyBounds() const noexcept {
+    return std::nullopt;
+  }
+
   JoinColumn fetchJoinColumn(
       const Analyzer::ColumnVar* hash_col,
       const std::vector<Fragmenter_Namespace::FragmentInfo>& fragment_info,
@@ -208,6 +208,9 @@ void verify_function_ir(const llvm::Function* func) {
 std::vector<std::pair<void*, void*>> Executor::getCodeFromCache(const CodeCacheKey& key,
                                                                 const CodeCache& cache) {
   auto it = cache.find(key);
+  if (query_profile_) {
+    query_profile_->addCodeCacheLookup(it != cache.cend());
+  }
   if (it != cache.cend()) {
     delete cgen_state_->module_;
     cgen_state_->module_ = it->second.second;
@@ -1348,6 +1351,9 @@ std::vector<std::string> get_agg_fnames(const std::vector<Analyzer::Expr*>& targ
       case kAPPROX_COUNT_DISTINCT:
         result.emplace_back("agg_approximate_count_distinct");
         break;
+      case kAPPROX_QUANTILE:
+        result.emplace_back("agg_approx_quantile");
+        break;
       default:
         CHECK(false);
     }
@@ -1965,7 +1971,8 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
     for (size_t i = 0; i < num_count_distinct_descs; i++) {
       const auto& count_distinct_descriptor =
           query_mem_desc->getCountDistinctDescriptor(i);
-      if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::StdSet ||
+      if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::HashSet ||
+          count_distinct_descriptor.impl_type_ == CountDistinctImplType::SparseBitmap ||
           (count_distinct_descriptor.impl_type_ != CountDistinctImplType::Invalid &&
            !co.hoist_literals)) {
         throw QueryMustRunOnCpu();
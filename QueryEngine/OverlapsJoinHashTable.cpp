@@ -507,6 +507,7 @@ int OverlapsJoinHashTable::initHashTableOnCpu(
     return 0;
   }
   CHECK(layoutRequiresAdditionalBuffers(layout));
+  const auto key_translation_maps = buildKeyTranslationMaps(composite_key_info);
   const auto key_component_width = getKeyComponentWidth();
   const auto key_component_count = join_bucket_info[0].bucket_sizes_for_dimension.size();
   const auto entry_size = key_component_count * key_component_width;
@@ -622,33 +623,35 @@ int OverlapsJoinHashTable::initHashTableOnCpu(
     case 4: {
       const auto composite_key_dict =
           reinterpret_cast<int32_t*>(&(*cpu_hash_table_buff_)[0]);
-      fill_one_to_many_baseline_hash_table_32(one_to_many_buff,
-                                              composite_key_dict,
-                                              entry_count_,
-                                              -1,
-                                              key_component_count,
-                                              join_columns,
-                                              join_column_types,
-                                              join_bucket_info,
-                                              composite_key_info.sd_inner_proxy_per_key,
-                                              composite_key_info.sd_outer_proxy_per_key,
-                                              thread_count);
+      fill_one_to_many_baseline_hash_table_32(
+          one_to_many_buff,
+          composite_key_dict,
+          entry_count_,
+          -1,
+          key_component_count,
+          join_columns,
+          join_column_types,
+          join_bucket_info,
+          key_translation_maps.sd_inner_to_outer_translation_maps,
+          key_translation_maps.sd_min_inner_elems,
+          thread_count);
       break;
     }
     case 8: {
       const auto composite_key_dict =
           reinterpret_cast<int64_t*>(&(*cpu_hash_table_buff_)[0]);
-      fill_one_to_many_baseline_hash_table_64(one_to_many_buff,
-                                              composite_key_dict,
-                                              entry_count_,
-                                              -1,
-                                              key_component_count,
-                                              join_columns,
-                                              join_column_types,
-                                              join_bucket_info,
-                                              composite_key_info.sd_inner_proxy_per_key,
-                                              composite_key_info.sd_outer_proxy_per_key,
-                                              thread_count);
+      fill_one_to_many_baseline_hash_table_64(
+          one_to_many_buff,
+          composite_key_dict,
+          entry_count_,
+          -1,
+          key_component_count,
+          join_columns,
+          join_column_types,
+          join_bucket_info,
+          key_translation_maps.sd_inner_to_outer_translation_maps,
+          key_translation_maps.sd_min_inner_elems,
+          thread_count);
       break;
     }
     default:
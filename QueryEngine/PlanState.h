@@ -36,6 +36,7 @@ struct JoinInfo {
                                // fold them to true during code generation
   std::vector<std::shared_ptr<JoinHashTableInterface>> join_hash_tables_;
   std::unordered_set<size_t> sharded_range_table_indices_;
+  std::unordered_set<size_t> inner_join_table_indices_;  // tables of inner joins only
 };
 
 struct PlanState {
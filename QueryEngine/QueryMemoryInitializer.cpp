@@ -28,6 +28,10 @@
 
 namespace {
 
+// Stand for the bitmap size of the count distinct slots which hold a set instead.
+constexpr ssize_t kHashSetSize{-1};
+constexpr ssize_t kSparseBitmapSize{-2};
+
 inline void check_total_bitmap_memory(const QueryMemoryDescriptor& query_mem_desc) {
   const int32_t groups_buffer_entry_count = query_mem_desc.getEntryCount();
   if (g_enable_watchdog) {
@@ -191,6 +195,7 @@ QueryMemoryInitializer::QueryMemoryInitializer(
 
   if (render_allocator_map || !query_mem_desc.isGroupBy()) {
     allocateCountDistinctBuffers(query_mem_desc, false, executor);
+    allocateTDigests(query_mem_desc, false, executor);
     if (render_info && render_info->useCudaBuffers()) {
       return;
     }
@@ -411,6 +416,7 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
   const size_t col_base_off{query_mem_desc.getColOffInBytes(0)};
 
   auto agg_bitmap_size = allocateCountDistinctBuffers(query_mem_desc, true, executor);
+  auto quantile_params = allocateTDigests(query_mem_desc, true, executor);
   auto buffer_ptr = reinterpret_cast<int8_t*>(groups_buffer);
 
   const auto query_mem_desc_fixedup =
@@ -426,7 +432,8 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
                          &buffer_ptr[col_base_off],
                          bin,
                          init_vals,
-                         agg_bitmap_size);
+                         agg_bitmap_size,
+                         quantile_params);
       }
     }
     return;
@@ -439,7 +446,8 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
                      &buffer_ptr[col_base_off],
                      bin,
                      init_vals,
-                     agg_bitmap_size);
+                     agg_bitmap_size,
+                     quantile_params);
   }
 }
 
@@ -520,18 +528,26 @@ void QueryMemoryInitializer::initColumnarGroups(
   }
 }
 
-void QueryMemoryInitializer::initColumnPerRow(const QueryMemoryDescriptor& query_mem_desc,
-                                              int8_t* row_ptr,
-                                              const size_t bin,
-                                              const std::vector<int64_t>& init_vals,
-                                              const std::vector<ssize_t>& bitmap_sizes) {
+void QueryMemoryInitializer::initColumnPerRow(
+    const QueryMemoryDescriptor& query_mem_desc,
+    int8_t* row_ptr,
+    const size_t bin,
+    const std::vector<int64_t>& init_vals,
+    const std::vector<ssize_t>& bitmap_sizes,
+    const std::vector<QuantileParam>& quantile_params) {
   int8_t* col_ptr = row_ptr;
   size_t init_vec_idx = 0;
   for (size_t col_idx = 0; col_idx < query_mem_desc.getSlotCount();
        col_ptr += query_mem_desc.getNextColOffInBytes(col_ptr, bin, col_idx++)) {
     const ssize_t bm_sz{bitmap_sizes[col_idx]};
     int64_t init_val{0};
-    if (!bm_sz || !query_mem_desc.isGroupBy()) {
+    if (query_mem_desc.isGroupBy() && quantile_params[col_idx]) {
+      CHECK_EQ(static_cast<size_t>(query_mem_desc.getPaddedSlotWidthBytes(col_idx)),
+               sizeof(int64_t));
+      init_val = reinterpret_cast<int64_t>(
+          row_set_mem_owner_->allocateTDigest(*quantile_params[col_idx]));
+      ++init_vec_idx;
+    } else if (!bm_sz || !query_mem_desc.isGroupBy()) {
       if (query_mem_desc.getPaddedSlotWidthBytes(col_idx) > 0) {
         CHECK_LT(init_vec_idx, init_vals.size());
         init_val = init_vals[init_vec_idx++];
@@ -539,8 +555,11 @@ void QueryMemoryInitializer::initColumnPerRow(const QueryMemoryDescriptor& query
     } else {
       CHECK_EQ(static_cast<size_t>(query_mem_desc.getPaddedSlotWidthBytes(col_idx)),
                sizeof(int64_t));
-      init_val =
-          bm_sz > 0 ? allocateCountDistinctBitmap(bm_sz) : allocateCountDistinctSet();
+      init_val = bm_sz > 0 ? allocateCountDistinctBitmap(bm_sz)
+                           : allocateCountDistinctSet(
+                                 bm_sz == kSparseBitmapSize
+                                     ? CountDistinctImplType::SparseBitmap
+                                     : CountDistinctImplType::HashSet);
       ++init_vec_idx;
     }
     switch (query_mem_desc.getPaddedSlotWidthBytes(col_idx)) {
@@ -629,11 +648,14 @@ std::vector<ssize_t> QueryMemoryInitializer::allocateCountDistinctBuffers(
           init_agg_vals_[agg_col_idx] = allocateCountDistinctBitmap(bitmap_byte_sz);
         }
       } else {
-        CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
         if (deferred) {
-          agg_bitmap_size[agg_col_idx] = -1;
+          agg_bitmap_size[agg_col_idx] =
+              count_distinct_desc.impl_type_ == CountDistinctImplType::SparseBitmap
+                  ? kSparseBitmapSize
+                  : kHashSetSize;
         } else {
-          init_agg_vals_[agg_col_idx] = allocateCountDistinctSet();
+          init_agg_vals_[agg_col_idx] =
+              allocateCountDistinctSet(count_distinct_desc.impl_type_);
         }
       }
     }
@@ -655,10 +677,47 @@ int64_t QueryMemoryInitializer::allocateCountDistinctBitmap(const size_t bitmap_
       row_set_mem_owner_->allocateCountDistinctBuffer(bitmap_byte_sz));
 }
 
-int64_t QueryMemoryInitializer::allocateCountDistinctSet() {
-  auto count_distinct_set = new std::set<int64_t>();
-  row_set_mem_owner_->addCountDistinctSet(count_distinct_set);
-  return reinterpret_cast<int64_t>(count_distinct_set);
+int64_t QueryMemoryInitializer::allocateCountDistinctSet(
+    const CountDistinctImplType impl_type) {
+  if (impl_type == CountDistinctImplType::SparseBitmap) {
+    return reinterpret_cast<int64_t>(
+        row_set_mem_owner_->allocateCountDistinctSparseBitmap());
+  }
+  CHECK(impl_type == CountDistinctImplType::HashSet);
+  return reinterpret_cast<int64_t>(row_set_mem_owner_->allocateCountDistinctHashSet());
+}
+
+// deferred is true for group by queries; initGroups will allocate a t-digest
+// for each group slot
+std::vector<QueryMemoryInitializer::QuantileParam>
+QueryMemoryInitializer::allocateTDigests(const QueryMemoryDescriptor& query_mem_desc,
+                                         const bool deferred,
+                                         const Executor* executor) {
+  const size_t agg_col_count{query_mem_desc.getSlotCount()};
+  std::vector<QuantileParam> quantile_params(deferred ? agg_col_count : 0);
+
+  CHECK_GE(agg_col_count, executor->plan_state_->target_exprs_.size());
+  for (size_t target_idx = 0; target_idx < executor->plan_state_->target_exprs_.size();
+       ++target_idx) {
+    const auto target_expr = executor->plan_state_->target_exprs_[target_idx];
+    const auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(target_expr);
+    if (agg_expr && agg_expr->get_aggtype() == kAPPROX_QUANTILE) {
+      const auto agg_col_idx = query_mem_desc.getSlotIndexForSingleSlotCol(target_idx);
+      CHECK_LT(static_cast<size_t>(agg_col_idx), agg_col_count);
+      CHECK_EQ(static_cast<size_t>(query_mem_desc.getLogicalSlotWidthBytes(agg_col_idx)),
+               sizeof(int64_t));
+      CHECK(agg_expr->get_arg1());
+      const auto q = agg_expr->get_arg1()->get_constval().doubleval;
+      if (deferred) {
+        quantile_params[agg_col_idx] = q;
+      } else {
+        init_agg_vals_[agg_col_idx] =
+            reinterpret_cast<int64_t>(row_set_mem_owner_->allocateTDigest(q));
+      }
+    }
+  }
+
+  return quantile_params;
 }
 
 #ifdef HAVE_CUDA
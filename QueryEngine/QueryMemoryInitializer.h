@@ -25,6 +25,7 @@
 #include "Rendering/RenderAllocator.h"
 
 #include <memory>
+#include <optional>
 
 #ifdef HAVE_CUDA
 #include <cuda.h>
@@ -121,6 +122,9 @@ class QueryMemoryInitializer {
                                  const bool prepend_index_buffer) const;
 
  private:
+  // quantile of the t-digest to allocate for an APPROX_PERCENTILE slot
+  using QuantileParam = std::optional<double>;
+
   void initGroupByBuffer(int64_t* buffer,
                          const RelAlgExecutionUnit& ra_exe_unit,
                          const QueryMemoryDescriptor& query_mem_desc,
@@ -144,7 +148,8 @@ class QueryMemoryInitializer {
                         int8_t* row_ptr,
                         const size_t bin,
                         const std::vector<int64_t>& init_vals,
-                        const std::vector<ssize_t>& bitmap_sizes);
+                        const std::vector<ssize_t>& bitmap_sizes,
+                        const std::vector<QuantileParam>& quantile_params);
 
   void allocateCountDistinctGpuMem(const QueryMemoryDescriptor& query_mem_desc);
 
@@ -155,7 +160,11 @@ class QueryMemoryInitializer {
 
   int64_t allocateCountDistinctBitmap(const size_t bitmap_byte_sz);
 
-  int64_t allocateCountDistinctSet();
+  int64_t allocateCountDistinctSet(const CountDistinctImplType impl_type);
+
+  std::vector<QuantileParam> allocateTDigests(const QueryMemoryDescriptor& query_mem_desc,
+                                              const bool deferred,
+                                              const Executor* executor);
 
 #ifdef HAVE_CUDA
   GpuGroupByBuffers prepareTopNHeapsDevBuffer(const QueryMemoryDescriptor& query_mem_desc,
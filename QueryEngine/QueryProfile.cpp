@@ -0,0 +1,151 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/QueryProfile.h"
+
+#include <sstream>
+
+#include "Shared/Logger.h"
+
+void QueryProfile::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  steps_.clear();
+  step_open_ = false;
+}
+
+void QueryProfile::beginStep(const unsigned node_id,
+                             const std::string& node_name,
+                             const size_t input_rows,
+                             const size_t cpu_bytes_fetched,
+                             const size_t gpu_bytes_fetched) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // a step which threw is left open, and replaced by the step retrying it
+  if (step_open_) {
+    steps_.pop_back();
+  }
+  QueryStepProfile step;
+  step.node_id = node_id;
+  step.node_name = node_name;
+  step.input_rows = input_rows;
+  // holds the totals until the step ends
+  step.cpu_bytes_fetched = cpu_bytes_fetched;
+  step.gpu_bytes_fetched = gpu_bytes_fetched;
+  steps_.push_back(std::move(step));
+  step_open_ = true;
+}
+
+void QueryProfile::endStep(const size_t output_rows,
+                           const size_t cpu_bytes_fetched,
+                           const size_t gpu_bytes_fetched,
+                           const int64_t execution_time_us) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto step = getOpenStep();
+  CHECK(step);
+  step->output_rows = output_rows;
+  step->cpu_bytes_fetched = cpu_bytes_fetched - step->cpu_bytes_fetched;
+  step->gpu_bytes_fetched = gpu_bytes_fetched - step->gpu_bytes_fetched;
+  step->execution_time_us = execution_time_us;
+  for (const auto& kernel : step->kernels) {
+    step->fragments_scanned += kernel.fragment_ids.size();
+  }
+  step_open_ = false;
+}
+
+void QueryProfile::addFragmentsSkipped(const size_t fragment_count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto step = getOpenStep()) {
+    step->fragments_skipped += fragment_count;
+  }
+}
+
+void QueryProfile::addCompilation(const int64_t compilation_time_us) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto step = getOpenStep()) {
+    step->compilation_time_us += compilation_time_us;
+  }
+}
+
+void QueryProfile::addCodeCacheLookup(const bool hit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto step = getOpenStep()) {
+    ++(hit ? step->code_cache_hits : step->code_cache_misses);
+  }
+}
+
+void QueryProfile::addHashTable(const int64_t build_time_us) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto step = getOpenStep()) {
+    ++step->hash_tables;
+    step->hash_table_build_time_us += build_time_us;
+  }
+}
+
+void QueryProfile::addHashTableCacheHit() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto step = getOpenStep()) {
+    ++step->hash_table_cache_hits;
+  }
+}
+
+void QueryProfile::addKernel(KernelProfile kernel) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto step = getOpenStep()) {
+    step->kernels.push_back(std::move(kernel));
+  }
+}
+
+std::vector<QueryStepProfile> QueryProfile::getSteps() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return step_open_ ? std::vector<QueryStepProfile>(steps_.begin(), steps_.end() - 1)
+                    : steps_;
+}
+
+QueryStepProfile* QueryProfile::getOpenStep() {
+  return step_open_ ? &steps_.back() : nullptr;
+}
+
+std::string QueryProfile::toString() const {
+  std::ostringstream oss;
+  const auto steps = getSteps();
+  for (size_t i = 0; i < steps.size(); ++i) {
+    const auto& step = steps[i];
+    oss << i + 1 << " : " << step.node_name << " " << step.node_id
+        << " rows: " << step.input_rows << " -> " << step.output_rows
+        << ", time: " << step.execution_time_us << " us"
+        << ", fragments scanned: " << step.fragments_scanned
+        << ", skipped: " << step.fragments_skipped
+        << ", bytes fetched: CPU " << step.cpu_bytes_fetched << " GPU "
+        << step.gpu_bytes_fetched << ", compilation: " << step.compilation_time_us
+        << " us, code cache hits: " << step.code_cache_hits << "/"
+        << step.code_cache_hits + step.code_cache_misses;
+    if (step.hash_tables) {
+      oss << ", hash tables: " << step.hash_tables
+          << " (cache hits: " << step.hash_table_cache_hits
+          << ", build: " << step.hash_table_build_time_us << " us)";
+    }
+    oss << "\n";
+    for (const auto& kernel : step.kernels) {
+      oss << "    kernel on "
+          << (kernel.device_type == ExecutorDeviceType::GPU ? "GPU " : "CPU ")
+          << kernel.device_id << " fragments: [";
+      for (size_t j = 0; j < kernel.fragment_ids.size(); ++j) {
+        oss << (j ? ", " : "") << kernel.fragment_ids[j];
+      }
+      oss << "], time: " << kernel.duration_us << " us\n";
+    }
+  }
+  return oss.str();
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    QueryProfile.h
+ * @brief   Structured profile of the execution of a query, step by step.
+ *
+ * A profile is attached to the executor for the duration of a query. The relational
+ * algebra executor opens a step for every node it executes, and the executor, the
+ * join hash tables and the code cache add what they did to the step which is open.
+ * Nothing is recorded when no profile is attached.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "QueryEngine/CompilationOptions.h"
+
+struct KernelProfile {
+  ExecutorDeviceType device_type;
+  int device_id;
+  std::vector<size_t> fragment_ids;  // of the outer table
+  int64_t duration_us;
+};
+
+struct QueryStepProfile {
+  unsigned node_id{0};
+  std::string node_name;
+  size_t input_rows{0};
+  size_t output_rows{0};
+  size_t fragments_scanned{0};
+  size_t fragments_skipped{0};
+  size_t cpu_bytes_fetched{0};  // from disk into the CPU buffer pool
+  size_t gpu_bytes_fetched{0};  // from the CPU buffer pool into the GPU ones
+  size_t hash_tables{0};
+  size_t hash_table_cache_hits{0};
+  int64_t hash_table_build_time_us{0};
+  int64_t compilation_time_us{0};  // includes the hash table builds
+  size_t code_cache_hits{0};
+  size_t code_cache_misses{0};
+  int64_t execution_time_us{0};
+  std::vector<KernelProfile> kernels;
+};
+
+class QueryProfile {
+ public:
+  void clear();
+
+  void beginStep(const unsigned node_id,
+                 const std::string& node_name,
+                 const size_t input_rows,
+                 const size_t cpu_bytes_fetched,
+                 const size_t gpu_bytes_fetched);
+  // The byte counts are the totals of the data manager, of which the step gets the
+  // difference with those passed to beginStep().
+  void endStep(const size_t output_rows,
+               const size_t cpu_bytes_fetched,
+               const size_t gpu_bytes_fetched,
+               const int64_t execution_time_us);
+
+  void addFragmentsSkipped(const size_t fragment_count);
+  void addCompilation(const int64_t compilation_time_us);
+  void addCodeCacheLookup(const bool hit);
+  void addHashTable(const int64_t build_time_us);
+  void addHashTableCacheHit();
+  void addKernel(KernelProfile kernel);
+
+  std::vector<QueryStepProfile> getSteps() const;
+
+  // Renders the steps as the text EXPLAIN ANALYZE returns, one line per step.
+  std::string toString() const;
+
+ private:
+  QueryStepProfile* getOpenStep();
+
+  mutable std::mutex mutex_;
+  std::vector<QueryStepProfile> steps_;
+  bool step_open_{false};
+};
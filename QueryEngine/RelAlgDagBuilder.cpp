@@ -30,6 +30,7 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <algorithm>
 #include <string>
 #include <unordered_set>
 
@@ -640,15 +641,48 @@ std::unique_ptr<RexAbstractInput> parse_abstract_input(
   return std::unique_ptr<RexAbstractInput>(new RexAbstractInput(json_i64(input)));
 }
 
-std::unique_ptr<RexLiteral> parse_literal(const rapidjson::Value& expr) {
-  CHECK(expr.IsObject());
-  const auto& literal = field(expr, "literal");
-  const auto type = to_sql_type(json_str(field(expr, "type")));
-  const auto target_type = to_sql_type(json_str(field(expr, "target_type")));
-  const auto scale = json_i64(field(expr, "scale"));
-  const auto precision = json_i64(field(expr, "precision"));
-  const auto type_scale = json_i64(field(expr, "type_scale"));
-  const auto type_precision = json_i64(field(expr, "type_precision"));
+// Everything about a literal but its value.
+struct LiteralType {
+  SQLTypes type;
+  SQLTypes target_type;
+  int64_t scale;
+  int64_t precision;
+  int64_t type_scale;
+  int64_t type_precision;
+};
+
+LiteralType parse_literal_type(const rapidjson::Value& expr) {
+  return {to_sql_type(json_str(field(expr, "type"))),
+          to_sql_type(json_str(field(expr, "target_type"))),
+          json_i64(field(expr, "scale")),
+          json_i64(field(expr, "precision")),
+          json_i64(field(expr, "type_scale")),
+          json_i64(field(expr, "type_precision"))};
+}
+
+// Whether two literals only differ by their value. Calcite writes the fields of all
+// literals in the same order, they're compared pairwise without looking them up.
+bool same_literal_type(const rapidjson::Value& lhs, const rapidjson::Value& rhs) {
+  if (lhs.MemberCount() != rhs.MemberCount()) {
+    return false;
+  }
+  for (auto lhs_it = lhs.MemberBegin(), rhs_it = rhs.MemberBegin();
+       lhs_it != lhs.MemberEnd();
+       ++lhs_it, ++rhs_it) {
+    if (lhs_it->name != rhs_it->name) {
+      return false;
+    }
+    if (lhs_it->name != "literal" && lhs_it->value != rhs_it->value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<RexLiteral> make_literal(const rapidjson::Value& literal,
+                                         const LiteralType& literal_type) {
+  const auto [type, target_type, scale, precision, type_scale, type_precision] =
+      literal_type;
   if (literal.IsNull()) {
     return std::unique_ptr<RexLiteral>(new RexLiteral(target_type));
   }
@@ -711,6 +745,11 @@ std::unique_ptr<RexLiteral> parse_literal(const rapidjson::Value& expr) {
   return nullptr;
 }
 
+std::unique_ptr<RexLiteral> parse_literal(const rapidjson::Value& expr) {
+  CHECK(expr.IsObject());
+  return make_literal(field(expr, "literal"), parse_literal_type(expr));
+}
+
 std::unique_ptr<const RexScalar> parse_scalar_expr(const rapidjson::Value& expr,
                                                    const Catalog_Namespace::Catalog& cat,
                                                    RelAlgDagBuilder& root_dag_builder);
@@ -867,6 +906,57 @@ std::unique_ptr<const RexSubQuery> parse_subquery(const rapidjson::Value& expr,
   return subquery->deepCopy();
 }
 
+// Calcite expands IN lists into a disjunction of equalities, between the same input and
+// a literal each. The equalities of long lists are decoded in bulk: the type of the
+// comparisons and of the literals is decoded once for the whole list.
+constexpr unsigned kMinBulkDecodedInListSize{16};
+
+bool is_in_list_element(const rapidjson::Value& expr) {
+  if (!expr.IsObject() || expr.MemberCount() != 3) {
+    return false;
+  }
+  const auto op_it = expr.FindMember("op");
+  const auto operands_it = expr.FindMember("operands");
+  if (op_it == expr.MemberEnd() || !op_it->value.IsString() || op_it->value != "=" ||
+      operands_it == expr.MemberEnd() || !operands_it->value.IsArray() ||
+      operands_it->value.Size() != 2 || !expr.HasMember("type")) {
+    return false;
+  }
+  const auto& input = operands_it->value[0];
+  const auto& literal = operands_it->value[1];
+  return input.IsObject() && input.HasMember("input") && literal.IsObject() &&
+         literal.HasMember("literal");
+}
+
+// Returns no expressions if the disjunction isn't an IN list, or a short one.
+std::vector<std::unique_ptr<const RexScalar>> parse_in_list(const rapidjson::Value& arr) {
+  std::vector<std::unique_ptr<const RexScalar>> exprs;
+  if (arr.Size() < kMinBulkDecodedInListSize || !is_in_list_element(arr[0])) {
+    return exprs;
+  }
+  const auto& eq_type = field(arr[0], "type");
+  const auto& input = field(arr[0], "operands")[0];
+  const auto& first_literal = field(arr[0], "operands")[1];
+  const auto ti = parse_type(eq_type);
+  const auto literal_type = parse_literal_type(first_literal);
+  exprs.reserve(arr.Size());
+  for (auto it = arr.Begin(); it != arr.End(); ++it) {
+    if (!is_in_list_element(*it)) {
+      return {};
+    }
+    const auto& operands = field(*it, "operands");
+    if (operands[0] != input || field(*it, "type") != eq_type ||
+        !same_literal_type(operands[1], first_literal)) {
+      return {};
+    }
+    std::vector<std::unique_ptr<const RexScalar>> eq_operands;
+    eq_operands.emplace_back(parse_abstract_input(operands[0]));
+    eq_operands.emplace_back(make_literal(field(operands[1], "literal"), literal_type));
+    exprs.emplace_back(new RexOperator(kEQ, eq_operands, ti));
+  }
+  return exprs;
+}
+
 std::unique_ptr<RexOperator> parse_operator(const rapidjson::Value& expr,
                                             const Catalog_Namespace::Catalog& cat,
                                             RelAlgDagBuilder& root_dag_builder) {
@@ -876,7 +966,11 @@ std::unique_ptr<RexOperator> parse_operator(const rapidjson::Value& expr,
   const auto op = is_quantifier ? kFUNCTION : to_sql_op(op_name);
   const auto& operators_json_arr = field(expr, "operands");
   CHECK(operators_json_arr.IsArray());
-  auto operands = parse_expr_array(operators_json_arr, cat, root_dag_builder);
+  auto operands = op == kOR ? parse_in_list(operators_json_arr)
+                            : std::vector<std::unique_ptr<const RexScalar>>{};
+  if (operands.empty()) {
+    operands = parse_expr_array(operators_json_arr, cat, root_dag_builder);
+  }
   const auto type_it = expr.FindMember("type");
   CHECK(type_it != expr.MemberEnd());
   auto ti = parse_type(type_it->value);
@@ -965,7 +1059,9 @@ std::unique_ptr<const RexAgg> parse_aggregate_expr(const rapidjson::Value& expr)
   const auto distinct = json_bool(field(expr, "distinct"));
   const auto agg_ti = parse_type(field(expr, "type"));
   const auto operands = indices_from_json_array(field(expr, "operands"));
-  if (operands.size() > 1 && (operands.size() != 2 || agg != kAPPROX_COUNT_DISTINCT)) {
+  if (operands.size() > 1 &&
+      (operands.size() != 2 ||
+       (agg != kAPPROX_COUNT_DISTINCT && agg != kAPPROX_QUANTILE))) {
     throw QueryNotSupported("Multiple arguments for aggregates aren't supported");
   }
   return std::unique_ptr<const RexAgg>(new RexAgg(agg, distinct, agg_ti, operands));
@@ -2365,8 +2461,14 @@ RelAlgDagBuilder::RelAlgDagBuilder(const std::string& query_ra,
                                    const Catalog_Namespace::Catalog& cat,
                                    const RenderInfo* render_info)
     : cat_(cat), render_info_(render_info) {
-  rapidjson::Document query_ast;
-  query_ast.Parse(query_ra.c_str());
+  // The DOM is allocated from an arena sized after the plan, its strings point into a
+  // copy of the plan parsed in place instead of being copied one at a time.
+  std::vector<char> query_ra_buffer(query_ra.begin(), query_ra.end());
+  query_ra_buffer.push_back('\0');
+  rapidjson::MemoryPoolAllocator<> query_ast_allocator(
+      std::max(size_t(64 * 1024), 2 * query_ra.size()));
+  rapidjson::Document query_ast(&query_ast_allocator);
+  query_ast.ParseInsitu(query_ra_buffer.data());
   VLOG(2) << "Parsing query RA JSON: " << query_ra;
   if (query_ast.HasParseError()) {
     query_ast.GetParseError();
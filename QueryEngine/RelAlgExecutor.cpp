@@ -286,6 +286,11 @@ ExecutionResult RelAlgExecutor::executeRelAlgQueryNoRetry(const CompilationOptio
 
   int64_t queue_time_ms = timer_stop(clock_begin);
   ScopeGuard row_set_holder = [this] { cleanupPostExecution(); };
+  if (query_profile_) {
+    // a retry of the query replaces the profile of the failed attempt
+    query_profile_->clear();
+    executor_->query_profile_ = query_profile_.get();
+  }
   const auto phys_inputs = get_physical_inputs(cat_, &ra);
   const auto phys_table_ids = get_physical_table_inputs(&ra);
   executor_->setCatalog(&cat_);
@@ -379,6 +384,7 @@ void RelAlgExecutor::cleanupPostExecution() {
   CHECK(executor_);
   executor_->row_set_mem_owner_ = nullptr;
   executor_->lit_str_dict_proxy_ = nullptr;
+  executor_->query_profile_ = nullptr;
 }
 
 namespace {
@@ -536,12 +542,104 @@ ExecutionResult RelAlgExecutor::executeRelAlgSubSeq(
   return seq.getDescriptor(interval.second - 1)->getResult();
 }
 
+namespace {
+
+std::string get_node_name(const RelAlgNode* node) {
+  if (dynamic_cast<const RelCompound*>(node)) {
+    return "RelCompound";
+  }
+  if (dynamic_cast<const RelProject*>(node)) {
+    return "RelProject";
+  }
+  if (dynamic_cast<const RelAggregate*>(node)) {
+    return "RelAggregate";
+  }
+  if (dynamic_cast<const RelFilter*>(node)) {
+    return "RelFilter";
+  }
+  if (dynamic_cast<const RelSort*>(node)) {
+    return "RelSort";
+  }
+  if (dynamic_cast<const RelLogicalValues*>(node)) {
+    return "RelLogicalValues";
+  }
+  if (dynamic_cast<const RelModify*>(node)) {
+    return "RelModify";
+  }
+  if (dynamic_cast<const RelLogicalUnion*>(node)) {
+    return "RelLogicalUnion";
+  }
+  if (dynamic_cast<const RelTableFunction*>(node)) {
+    return "RelTableFunction";
+  }
+  return "RelAlgNode";
+}
+
+// Rows of the inputs of the node, from the table metadata for scans and from the
+// results of the earlier steps otherwise. The inputs of a join are those of the node.
+size_t get_input_row_count(const RelAlgNode* node,
+                           const TemporaryTables& temporary_tables,
+                           const Executor* executor) {
+  size_t row_count{0};
+  for (size_t i = 0; i < node->inputCount(); ++i) {
+    const auto input = node->getInput(i);
+    const auto scan = dynamic_cast<const RelScan*>(input);
+    if (scan) {
+      const auto td = scan->getTableDescriptor();
+      CHECK(td);
+      row_count += executor->getTableInfo(td->tableId).getNumTuples();
+      continue;
+    }
+    if (dynamic_cast<const RelLeftDeepInnerJoin*>(input)) {
+      row_count += get_input_row_count(input, temporary_tables, executor);
+      continue;
+    }
+    const auto it = temporary_tables.find(-input->getId());
+    if (it != temporary_tables.end() && it->second) {
+      row_count += it->second->peekRowCount();
+    }
+  }
+  return row_count;
+}
+
+}  // namespace
+
 void RelAlgExecutor::executeRelAlgStep(const RaExecutionSequence& seq,
                                        const size_t step_idx,
                                        const CompilationOptions& co,
                                        const ExecutionOptions& eo,
                                        RenderInfo* render_info,
                                        const int64_t queue_time_ms) {
+  auto query_profile = executor_->getQueryProfile();
+  const auto body = seq.getDescriptor(step_idx)->getBody();
+  if (!query_profile || body->isNop()) {
+    executeRelAlgStepImpl(seq, step_idx, co, eo, render_info, queue_time_ms);
+    return;
+  }
+  const auto& data_mgr = cat_.getDataMgr();
+  query_profile->beginStep(body->getId(),
+                           get_node_name(body),
+                           get_input_row_count(body, temporary_tables_, executor_),
+                           data_mgr.getNumBytesFetched(Data_Namespace::CPU_LEVEL),
+                           data_mgr.getNumBytesFetched(Data_Namespace::GPU_LEVEL));
+  const auto clock_begin = timer_start();
+  executeRelAlgStepImpl(seq, step_idx, co, eo, render_info, queue_time_ms);
+  const auto execution_time_us =
+      timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(
+          clock_begin);
+  const auto& rows = seq.getDescriptor(step_idx)->getResult().getRows();
+  query_profile->endStep(rows ? rows->peekRowCount() : 0,
+                         data_mgr.getNumBytesFetched(Data_Namespace::CPU_LEVEL),
+                         data_mgr.getNumBytesFetched(Data_Namespace::GPU_LEVEL),
+                         execution_time_us);
+}
+
+void RelAlgExecutor::executeRelAlgStepImpl(const RaExecutionSequence& seq,
+                                           const size_t step_idx,
+                                           const CompilationOptions& co,
+                                           const ExecutionOptions& eo,
+                                           RenderInfo* render_info,
+                                           const int64_t queue_time_ms) {
   INJECT_TIMER(executeRelAlgStep);
   auto timer = DEBUG_TIMER(__func__);
   WindowProjectNodeContext::reset(executor_);
@@ -1383,6 +1481,8 @@ void RelAlgExecutor::executeUpdate(const RelAlgNode* node,
                                        update_callback,
                                        is_aggregate);
               update_params.finalizeTransaction();
+              // geo values are updated in place, the R-trees are rebuilt on next use
+              cat_.invalidateSpatialIndexes(update_params.getTableDescriptor());
             };
 
         if (update_params.tableIsTemporary()) {
@@ -2579,8 +2679,7 @@ RelAlgExecutionUnit decide_approx_count_distinct_implementation(
     const auto sub_bitmap_count =
         get_count_distinct_sub_bitmap_count(bitmap_sz_bits, ra_exe_unit, device_type);
     int64_t approx_bitmap_sz_bits{0};
-    const auto error_rate =
-        static_cast<Analyzer::AggExpr*>(target_expr)->get_error_rate();
+    const auto error_rate = static_cast<Analyzer::AggExpr*>(target_expr)->get_arg1();
     if (error_rate) {
       CHECK(error_rate->get_type_info().get_type() == kINT);
       CHECK_GE(error_rate->get_constval().intval, 1);
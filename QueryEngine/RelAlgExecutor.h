@@ -149,6 +149,11 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
 
   Executor* getExecutor() const;
 
+  // Collects the profile of the next queries run by this executor into the given one.
+  void setQueryProfile(std::shared_ptr<QueryProfile> query_profile) {
+    query_profile_ = query_profile;
+  }
+
   void cleanupPostExecution();
 
   static std::string getErrorMessageFromCode(const int32_t error_code);
@@ -166,6 +171,13 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                          RenderInfo*,
                          const int64_t queue_time_ms);
 
+  void executeRelAlgStepImpl(const RaExecutionSequence& seq,
+                             const size_t step_idx,
+                             const CompilationOptions&,
+                             const ExecutionOptions&,
+                             RenderInfo*,
+                             const int64_t queue_time_ms);
+
   void executeUpdate(const RelAlgNode* node,
                      const CompilationOptions& co,
                      const ExecutionOptions& eo,
@@ -363,6 +375,7 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
   std::vector<std::shared_ptr<Analyzer::Expr>> target_exprs_owned_;  // TODO(alex): remove
   std::unordered_map<unsigned, AggregatedResult> leaf_results_;
   int64_t queue_time_ms_;
+  std::shared_ptr<QueryProfile> query_profile_;
   static SpeculativeTopNBlacklist speculative_topn_blacklist_;
   static const size_t max_groups_buffer_entry_default_guess{16384};
 
@@ -207,6 +207,9 @@ bool is_agg_supported_for_type(const SQLAgg& agg_kind, const SQLTypeInfo& arg_ti
       !(arg_ti.is_number() || arg_ti.is_boolean() || arg_ti.is_time())) {
     return false;
   }
+  if (agg_kind == kAPPROX_QUANTILE && !arg_ti.is_number()) {
+    return false;
+  }
 
   return true;
 }
@@ -220,21 +223,45 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateAggregateRex(
   const bool is_distinct = rex->isDistinct();
   const bool takes_arg{rex->size() > 0};
   std::shared_ptr<Analyzer::Expr> arg_expr;
-  std::shared_ptr<Analyzer::Constant> err_rate;
+  std::shared_ptr<Analyzer::Constant> arg1;  // 2nd aggregate parameter
   if (takes_arg) {
     const auto operand = rex->getOperand(0);
     CHECK_LT(operand, scalar_sources.size());
     CHECK_LE(rex->size(), 2u);
     arg_expr = scalar_sources[operand];
     if (agg_kind == kAPPROX_COUNT_DISTINCT && rex->size() == 2) {
-      err_rate = std::dynamic_pointer_cast<Analyzer::Constant>(
+      arg1 = std::dynamic_pointer_cast<Analyzer::Constant>(
           scalar_sources[rex->getOperand(1)]);
-      if (!err_rate || err_rate->get_type_info().get_type() != kINT ||
-          err_rate->get_constval().intval < 1 || err_rate->get_constval().intval > 100) {
+      if (!arg1 || arg1->get_type_info().get_type() != kINT ||
+          arg1->get_constval().intval < 1 || arg1->get_constval().intval > 100) {
         throw std::runtime_error(
             "APPROX_COUNT_DISTINCT's second parameter should be SMALLINT literal between "
             "1 and 100");
       }
+    } else if (agg_kind == kAPPROX_QUANTILE) {
+      // APPROX_MEDIAN(x) is APPROX_PERCENTILE(x, 0.5)
+      Datum median;
+      median.doubleval = 0.5;
+      arg1 = makeExpr<Analyzer::Constant>(kDOUBLE, false, median);
+      if (rex->size() == 2) {
+        const auto quantile = std::dynamic_pointer_cast<Analyzer::Constant>(
+            scalar_sources[rex->getOperand(1)]);
+        if (!quantile || quantile->get_is_null() ||
+            !quantile->get_type_info().is_number()) {
+          throw std::runtime_error(
+              "APPROX_PERCENTILE's second parameter should be a numeric literal between "
+              "0 and 1");
+        }
+        arg1 = std::dynamic_pointer_cast<Analyzer::Constant>(
+            quantile->deep_copy()->add_cast(SQLTypeInfo(kDOUBLE, true)));
+        CHECK(arg1);
+        const auto q = arg1->get_constval().doubleval;
+        if (!(0 <= q && q <= 1)) {
+          throw std::runtime_error(
+              "APPROX_PERCENTILE's second parameter should be a numeric literal between "
+              "0 and 1");
+        }
+      }
     }
     const auto& arg_ti = arg_expr->get_type_info();
     if (!is_agg_supported_for_type(agg_kind, arg_ti)) {
@@ -243,7 +270,7 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateAggregateRex(
     }
   }
   const auto agg_ti = get_agg_type(agg_kind, arg_expr.get());
-  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, err_rate);
+  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateLiteral(
@@ -595,11 +622,11 @@ void fill_dictionary_encoded_in_vals(
     std::atomic<size_t>& total_in_vals_count,
     const ResultSet* values_rowset,
     const std::pair<int64_t, int64_t> values_rowset_slice,
-    const StringDictionaryProxy* source_dict,
-    const StringDictionaryProxy* dest_dict,
+    const StringDictionaryProxy::TranslationMap& source_to_dest_translation_map,
     const int64_t needle_null_val) {
   CHECK(in_vals.empty());
-  bool dicts_are_equal = source_dict == dest_dict;
+  // the translation map is empty when both sides share the dictionary
+  bool dicts_are_equal = !source_to_dest_translation_map.ids;
   for (auto index = values_rowset_slice.first; index < values_rowset_slice.second;
        ++index) {
     const auto row = values_rowset->getOneColRow(index);
@@ -612,7 +639,7 @@ void fill_dictionary_encoded_in_vals(
       const int string_id =
           row.value == needle_null_val
               ? needle_null_val
-              : dest_dict->getIdOfString(source_dict->getString(row.value));
+              : source_to_dest_translation_map.translate(row.value);
       if (string_id != StringDictionary::INVALID_STR_ID) {
         in_vals.push_back(string_id);
       }
@@ -756,6 +783,18 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::getInIntegerSetExpr(
     return nullptr;
   }
   std::atomic<size_t> total_in_vals_count{0};
+  StringDictionaryProxy::TranslationMap source_to_dest_translation_map;
+  if (arg_type.is_string() && !g_cluster) {
+    // translate the whole source dictionary once instead of every value of the subquery
+    const auto dd = executor_->getStringDictionaryProxy(
+        arg_type.get_comp_param(), val_set.getRowSetMemOwner(), true);
+    const auto sd = executor_->getStringDictionaryProxy(
+        col_type.get_comp_param(), val_set.getRowSetMemOwner(), true);
+    CHECK(sd);
+    if (sd != dd) {
+      source_to_dest_translation_map = sd->buildTranslationMap(dd);
+    }
+  }
   for (size_t i = 0,
               start_entry = 0,
               stride = (entry_count + fetcher_count - 1) / fetcher_count;
@@ -771,16 +810,13 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::getInIntegerSetExpr(
       const DictRef source_dict_ref(col_type.get_comp_param(), cat_.getDatabaseId());
       const auto dd = executor_->getStringDictionaryProxy(
           arg_type.get_comp_param(), val_set.getRowSetMemOwner(), true);
-      const auto sd = executor_->getStringDictionaryProxy(
-          col_type.get_comp_param(), val_set.getRowSetMemOwner(), true);
-      CHECK(sd);
       const auto needle_null_val = inline_int_null_val(arg_type);
       fetcher_threads.push_back(std::async(
           std::launch::async,
           [this,
            &val_set,
            &total_in_vals_count,
-           sd,
+           &source_to_dest_translation_map,
            dd,
            source_dict_ref,
            dest_dict_ref,
@@ -802,8 +838,7 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::getInIntegerSetExpr(
                                               total_in_vals_count,
                                               &val_set,
                                               {start, end},
-                                              sd,
-                                              dd,
+                                              source_to_dest_translation_map,
                                               needle_null_val);
             }
           },
@@ -1217,7 +1252,7 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateCurrentUser(
   return Parser::UserLiteral::get(user);
 }
 
-std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateLower(
+std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateLowerOrUpper(
     const RexFunctionOperator* rex_function) const {
   const auto& args = translateFunctionArgs(rex_function);
   CHECK_EQ(size_t(1), args.size());
@@ -1225,6 +1260,9 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateLower(
 
   if (args[0]->get_type_info().is_dict_encoded_string() ||
       dynamic_cast<Analyzer::Constant*>(args[0].get())) {
+    if (rex_function->getName() == "UPPER"sv) {
+      return makeExpr<Analyzer::UpperExpr>(args[0]);
+    }
     return makeExpr<Analyzer::LowerExpr>(args[0]);
   }
 
@@ -1420,8 +1458,9 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateFunction(
   if (rex_function->getName() == "CURRENT_USER"sv) {
     return translateCurrentUser(rex_function);
   }
-  if (g_enable_experimental_string_functions && rex_function->getName() == "LOWER"sv) {
-    return translateLower(rex_function);
+  if (g_enable_experimental_string_functions &&
+      func_resolve(rex_function->getName(), "LOWER"sv, "UPPER"sv)) {
+    return translateLowerOrUpper(rex_function);
   }
   if (func_resolve(rex_function->getName(), "CARDINALITY"sv, "ARRAY_LENGTH"sv)) {
     return translateCardinality(rex_function);
@@ -114,7 +114,7 @@ class RelAlgTranslator {
 
   std::shared_ptr<Analyzer::Expr> translateCurrentUser(const RexFunctionOperator*) const;
 
-  std::shared_ptr<Analyzer::Expr> translateLower(const RexFunctionOperator*) const;
+  std::shared_ptr<Analyzer::Expr> translateLowerOrUpper(const RexFunctionOperator*) const;
 
   std::shared_ptr<Analyzer::Expr> translateCardinality(const RexFunctionOperator*) const;
 
@@ -49,7 +49,8 @@ std::vector<int64_t> initialize_target_values_for_storage(
   std::vector<int64_t> target_init_vals;
   for (const auto& target_info : targets) {
     if (target_info.agg_kind == kCOUNT ||
-        target_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
+        target_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+        target_info.agg_kind == kAPPROX_QUANTILE) {
       target_init_vals.push_back(0);
       continue;
     }
@@ -357,6 +358,13 @@ void ResultSet::setCachedRowCount(const size_t row_count) const {
   cached_row_count_ = row_count;
 }
 
+size_t ResultSet::peekRowCount() const {
+  const ssize_t cached_row_count = cached_row_count_;
+  const auto row_count = rowCount();
+  cached_row_count_ = cached_row_count;
+  return row_count;
+}
+
 size_t ResultSet::binSearchRowCount() const {
   if (!storage_) {
     return 0;
@@ -744,6 +752,23 @@ bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
         }
         return use_desc_cmp ? lhs_sz > rhs_sz : lhs_sz < rhs_sz;
       }
+      if (UNLIKELY(agg_info.is_agg && agg_info.agg_kind == kAPPROX_QUANTILE)) {
+        // the slots point to t-digests, empty ones are read as nulls
+        const auto lhs_dval = approx_quantile_value(lhs_v.i1);
+        const auto rhs_dval = approx_quantile_value(rhs_v.i1);
+        if (std::isnan(lhs_dval) || std::isnan(rhs_dval)) {
+          if (std::isnan(lhs_dval) && std::isnan(rhs_dval)) {
+            continue;
+          }
+          return std::isnan(lhs_dval)
+                     ? (use_heap_ ? !order_entry.nulls_first : order_entry.nulls_first)
+                     : (use_heap_ ? order_entry.nulls_first : !order_entry.nulls_first);
+        }
+        if (lhs_dval == rhs_dval) {
+          continue;
+        }
+        return use_desc_cmp ? lhs_dval > rhs_dval : lhs_dval < rhs_dval;
+      }
       if (lhs_v.i1 == rhs_v.i1) {
         continue;
       }
@@ -986,6 +1011,7 @@ std::tuple<std::vector<bool>, size_t> ResultSet::getSupportedSingleSlotTargetBit
     const auto& target = targets_[target_idx];
     if (single_slot_targets[target_idx] &&
         (is_distinct_target(target) ||
+         (target.is_agg && target.agg_kind == kAPPROX_QUANTILE) ||
          (target.is_agg && target.agg_kind == kSAMPLE && target.sql_type == kFLOAT))) {
       single_slot_targets[target_idx] = false;
       num_single_slot_targets--;
@@ -144,6 +144,11 @@ class ResultSetStorage {
                               const size_t that_entry_count,
                               const ResultSetStorage& that) const;
 
+  // Reduces all of `those` into this (empty) baseline buffer at once, partitioned by
+  // the home slot of the entries so that each thread works on a cache sized part.
+  void reduceRadixPartitioned(const std::vector<const ResultSetStorage*>& those,
+                              const ReductionCode& reduction_code) const;
+
   void reduceOneEntrySlotsBaseline(int64_t* this_entry_slots,
                                    const int64_t* that_buff,
                                    const size_t that_entry_idx,
@@ -373,7 +378,8 @@ class ResultSet {
 
   size_t getCurrentRowBufferIndex() const;
 
-  std::vector<TargetValue> getRowAt(const size_t index) const;
+  std::vector<TargetValue> getRowAt(const size_t index,
+                                    const std::vector<bool>& targets_to_skip = {}) const;
 
   TargetValue getRowAt(const size_t row_idx,
                        const size_t col_idx,
@@ -409,6 +415,10 @@ class ResultSet {
 
   void setCachedRowCount(const size_t row_count) const;
 
+  // Same as rowCount(), but leaves the cached row count as it was: the result can still
+  // be limited, sorted or appended to, which expect no cached row count.
+  size_t peekRowCount() const;
+
   size_t entryCount() const;
 
   size_t getBufferSizeBytes(const ExecutorDeviceType device_type) const;
@@ -911,6 +921,14 @@ class ResultSetManager {
 
   void rewriteVarlenAggregates(ResultSet*);
 
+  // Erases the groups which can't make the first n rows of the reduction of the given
+  // partial results, ordered by the aggregate in order_entry. Returns false and leaves
+  // the partial results untouched if the order or the partial results don't qualify or
+  // if no group can be ruled out.
+  static bool pruneTopNGroups(const std::vector<ResultSet*>& result_sets,
+                              const Analyzer::OrderEntry& order_entry,
+                              const size_t n);
+
  private:
   std::shared_ptr<ResultSet> rs_;
 };
@@ -924,6 +942,14 @@ int64_t lazy_decode(const ColumnLazyFetchInfo& col_lazy_fetch,
                     const int8_t* byte_stream,
                     const int64_t pos);
 
+// Reads the quantile of the t-digest an APPROX_PERCENTILE slot points to, NaN if the
+// digest is missing or empty.
+double approx_quantile_value(const int64_t t_digest_handle);
+
+// Merges the t-digest the that_ptr slot points to into the one the this_ptr slot points
+// to, or makes the this_ptr slot point to it if it doesn't point to one yet.
+void approx_quantile_merge(int8_t* this_ptr, const int8_t* that_ptr);
+
 void fill_empty_key(void* key_ptr, const size_t key_count, const size_t key_width);
 
 bool can_use_parallel_algorithms(const ResultSet& rows);
@@ -31,6 +31,7 @@
 #include "ResultSetGeoSerialization.h"
 #include "RuntimeFunctions.h"
 #include "Shared/SqlTypesLayout.h"
+#include "Shared/TDigest.h"
 #include "Shared/geo_compression.h"
 #include "Shared/sqltypes.h"
 #include "TypePunning.h"
@@ -259,13 +260,15 @@ OneIntegerColumnRow ResultSet::getOneColRow(const size_t global_entry_idx) const
   return {*ival_ptr, true};
 }
 
-std::vector<TargetValue> ResultSet::getRowAt(const size_t logical_index) const {
+std::vector<TargetValue> ResultSet::getRowAt(
+    const size_t logical_index,
+    const std::vector<bool>& targets_to_skip /* = {}*/) const {
   if (logical_index >= entryCount()) {
     return {};
   }
   const auto entry_idx =
       permutation_.empty() ? logical_index : permutation_[logical_index];
-  return getRowAt(entry_idx, true, false, false);
+  return getRowAt(entry_idx, true, false, false, targets_to_skip);
 }
 
 std::vector<TargetValue> ResultSet::getRowAtNoTranslations(
@@ -760,6 +763,13 @@ size_t ResultSet::getBufferSizeBytes(const ExecutorDeviceType device_type) const
   return storage_->query_mem_desc_.getBufferSizeBytes(device_type);
 }
 
+double approx_quantile_value(const int64_t t_digest_handle) {
+  if (!t_digest_handle) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return reinterpret_cast<TDigest*>(t_digest_handle)->quantile();
+}
+
 int64_t lazy_decode(const ColumnLazyFetchInfo& col_lazy_fetch,
                     const int8_t* byte_stream,
                     const int64_t pos) {
@@ -1839,6 +1849,17 @@ TargetValue ResultSet::makeTargetValue(const int8_t* ptr,
       }
     }
   }
+  if (target_info.is_agg && target_info.agg_kind == kAPPROX_QUANTILE) {
+    const auto dval = approx_quantile_value(ival);
+    if (std::isnan(dval)) {
+      return ScalarTargetValue(NULL_DOUBLE);
+    }
+    // decimals have been digested as their scaled integer representation
+    return ScalarTargetValue(
+        target_info.agg_arg_type.is_decimal()
+            ? dval / exp_to_scale(target_info.agg_arg_type.get_scale())
+            : dval);
+  }
   if (chosen_type.is_fp()) {
     switch (actual_compact_sz) {
       case 8: {
@@ -29,6 +29,7 @@
 #include "ResultSetReductionJIT.h"
 #include "RuntimeFunctions.h"
 #include "Shared/SqlTypesLayout.h"
+#include "Shared/TDigest.h"
 
 #include "Shared/likely.h"
 #include "Shared/thread_count.h"
@@ -36,10 +37,12 @@
 #include <llvm/ExecutionEngine/GenericValue.h>
 
 #include <algorithm>
+#include <atomic>
 #include <future>
 #include <numeric>
 
 extern bool g_enable_dynamic_watchdog;
+extern size_t g_reduction_radix_partition_threshold;
 
 namespace {
 
@@ -53,6 +56,16 @@ size_t get_row_qw_count(const QueryMemoryDescriptor& query_mem_desc) {
   return row_bytes / 8;
 }
 
+// The partial results of a baseline group by are reduced radix partitioned when the
+// reduced buffer is too big for the serial, cache oblivious reduction to do well.
+bool use_radix_partitioned_reduction(const size_t result_set_count,
+                                     const QueryMemoryDescriptor& query_mem_desc) {
+  return result_set_count > 1 && g_reduction_radix_partition_threshold &&
+         query_mem_desc.getEntryCount() <= std::numeric_limits<uint32_t>::max() &&
+         query_mem_desc.getEntryCount() * get_row_bytes(query_mem_desc) >
+             g_reduction_radix_partition_threshold;
+}
+
 std::vector<int64_t> make_key(const int64_t* buff,
                               const size_t entry_count,
                               const size_t key_count) {
@@ -882,6 +895,232 @@ void ResultSetStorage::reduceOneSlotBaseline(int64_t* this_buff,
                 {});
 }
 
+namespace {
+
+// The reduced buffer is split in partitions of this size, each of them reduced by
+// a single thread.
+constexpr size_t kGroupPartitionBytes{512 * 1024};
+
+struct PartitionedGroupEntry {
+  uint32_t home_slot;
+  uint32_t storage_idx;
+  uint32_t entry_idx;
+};
+
+// Returns the slot in [home_slot, end_slot) where the linear probing for the key
+// stops, either on the matching key or on an empty entry, end_slot otherwise.
+template <typename T>
+size_t find_probe_end_row_wise(const int64_t* buff,
+                               const size_t home_slot,
+                               const size_t end_slot,
+                               const T* key,
+                               const size_t key_count,
+                               const size_t row_qw_count) {
+  for (size_t slot = home_slot; slot < end_slot; ++slot) {
+    const auto slot_key = reinterpret_cast<const T*>(buff + slot * row_qw_count);
+    if (*slot_key == get_empty_key<T>() || std::equal(key, key + key_count, slot_key)) {
+      return slot;
+    }
+  }
+  return end_slot;
+}
+
+size_t find_probe_end_col_wise(const int64_t* buff,
+                               const size_t entry_count,
+                               const size_t home_slot,
+                               const size_t end_slot,
+                               const int64_t* key,
+                               const size_t key_count) {
+  for (size_t slot = home_slot; slot < end_slot; ++slot) {
+    if (buff[slot] == EMPTY_KEY_64) {
+      return slot;
+    }
+    size_t i = 0;
+    while (i < key_count && buff[slot + i * entry_count] == key[i]) {
+      ++i;
+    }
+    if (i == key_count) {
+      return slot;
+    }
+  }
+  return end_slot;
+}
+
+}  // namespace
+
+// Reduces the partial results of a baseline hash group by with the reduced buffer
+// split in cache sized partitions of slots. The entries of all partial results are
+// first radix partitioned by their home slot, then every partition is reduced by a
+// single thread without contention. An entry whose probe sequence leaves its
+// partition is deferred and reduced after all partitions are done, which keeps the
+// layout identical to the one built by the regular reduction. Only the reduction is
+// partitioned: the kernels still aggregate into a buffer per thread sized by the query
+// memory descriptor, without spilling to partitions when it fills up.
+void ResultSetStorage::reduceRadixPartitioned(
+    const std::vector<const ResultSetStorage*>& those,
+    const ReductionCode& reduction_code) const {
+  CHECK(query_mem_desc_.getQueryDescriptionType() ==
+        QueryDescriptionType::GroupByBaselineHash);
+  CHECK(!query_mem_desc_.hasKeylessHash());
+  const auto entry_count = query_mem_desc_.getEntryCount();
+  CHECK_GT(entry_count, size_t(0));
+  CHECK_LE(entry_count, size_t(std::numeric_limits<uint32_t>::max()));
+  const auto key_count = query_mem_desc_.getGroupbyColCount();
+  const auto key_width = query_mem_desc_.getEffectiveKeyWidth();
+  const auto row_qw_count = get_row_qw_count(query_mem_desc_);
+  const bool output_columnar = query_mem_desc_.didOutputColumnar();
+  const auto this_buff_i64 = reinterpret_cast<const int64_t*>(buff_);
+  const size_t partition_entry_count =
+      std::max(kGroupPartitionBytes / (row_qw_count * sizeof(int64_t)), size_t(1));
+  const size_t partition_count =
+      (entry_count + partition_entry_count - 1) / partition_entry_count;
+
+  const auto get_home_slot = [&](const ResultSetStorage& that,
+                                 const size_t entry_idx) -> uint32_t {
+    const auto that_buff_i64 = reinterpret_cast<const int64_t*>(that.buff_);
+    if (output_columnar) {
+      const auto key = make_key(
+          &that_buff_i64[entry_idx], that.query_mem_desc_.getEntryCount(), key_count);
+      return key_hash(&key[0], key_count, sizeof(int64_t)) % entry_count;
+    }
+    return key_hash(&that_buff_i64[entry_idx * row_qw_count], key_count, key_width) %
+           entry_count;
+  };
+  const auto get_probe_end = [&](const PartitionedGroupEntry& entry,
+                                 const size_t end_slot) -> size_t {
+    const auto& that = *those[entry.storage_idx];
+    const auto that_buff_i64 = reinterpret_cast<const int64_t*>(that.buff_);
+    if (output_columnar) {
+      const auto key = make_key(&that_buff_i64[entry.entry_idx],
+                                that.query_mem_desc_.getEntryCount(),
+                                key_count);
+      return find_probe_end_col_wise(
+          this_buff_i64, entry_count, entry.home_slot, end_slot, &key[0], key_count);
+    }
+    const auto key = &that_buff_i64[entry.entry_idx * row_qw_count];
+    switch (key_width) {
+      case 4:
+        return find_probe_end_row_wise(this_buff_i64,
+                                       entry.home_slot,
+                                       end_slot,
+                                       reinterpret_cast<const int32_t*>(key),
+                                       key_count,
+                                       row_qw_count);
+      case 8:
+        return find_probe_end_row_wise(
+            this_buff_i64, entry.home_slot, end_slot, key, key_count, row_qw_count);
+      default:
+        CHECK(false);
+    }
+    return end_slot;
+  };
+  const auto reduce_entry = [&](const PartitionedGroupEntry& entry) {
+    const auto& that = *those[entry.storage_idx];
+    const auto that_entry_count = that.query_mem_desc_.getEntryCount();
+    if (reduction_code.ir_reduce_loop) {
+      run_reduction_code(reduction_code,
+                         buff_,
+                         that.buff_,
+                         entry.entry_idx,
+                         entry.entry_idx + 1,
+                         that_entry_count,
+                         &query_mem_desc_,
+                         &that.query_mem_desc_,
+                         nullptr);
+    } else {
+      reduceOneEntryBaseline(buff_, that.buff_, entry.entry_idx, that_entry_count, that);
+    }
+  };
+  const size_t thread_count = cpu_threads();
+  const auto run_on_threads = [thread_count](const auto& func) {
+    std::vector<std::future<void>> threads;
+    for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+      threads.emplace_back(std::async(std::launch::async, func, thread_idx));
+    }
+    for (auto& thread : threads) {
+      thread.wait();
+    }
+    for (auto& thread : threads) {
+      thread.get();
+    }
+  };
+
+  std::vector<std::vector<PartitionedGroupEntry>> thread_entries(thread_count);
+  std::vector<std::vector<size_t>> thread_offsets(thread_count,
+                                                  std::vector<size_t>(partition_count));
+  run_on_threads([&](const size_t thread_idx) {
+    auto& entries = thread_entries[thread_idx];
+    auto& histogram = thread_offsets[thread_idx];
+    for (size_t storage_idx = 0; storage_idx < those.size(); ++storage_idx) {
+      const auto& that = *those[storage_idx];
+      const auto that_entry_count = that.query_mem_desc_.getEntryCount();
+      const auto thread_entry_count =
+          (that_entry_count + thread_count - 1) / thread_count;
+      const auto start_index =
+          std::min(thread_idx * thread_entry_count, that_entry_count);
+      const auto end_index =
+          std::min(start_index + thread_entry_count, that_entry_count);
+      for (size_t entry_idx = start_index; entry_idx < end_index; ++entry_idx) {
+        if (that.isEmptyEntry(entry_idx)) {
+          continue;
+        }
+        const auto home_slot = get_home_slot(that, entry_idx);
+        ++histogram[home_slot / partition_entry_count];
+        entries.push_back({home_slot,
+                           static_cast<uint32_t>(storage_idx),
+                           static_cast<uint32_t>(entry_idx)});
+      }
+    }
+  });
+
+  // Turn the per thread histograms into the positions where each thread writes the
+  // entries of every partition, grouped by partition.
+  std::vector<size_t> partition_offsets(partition_count + 1);
+  size_t offset = 0;
+  for (size_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+    partition_offsets[partition_idx] = offset;
+    for (auto& offsets : thread_offsets) {
+      const auto count = offsets[partition_idx];
+      offsets[partition_idx] = offset;
+      offset += count;
+    }
+  }
+  partition_offsets[partition_count] = offset;
+  std::vector<PartitionedGroupEntry> partitioned_entries(offset);
+  run_on_threads([&](const size_t thread_idx) {
+    auto& offsets = thread_offsets[thread_idx];
+    for (const auto& entry : thread_entries[thread_idx]) {
+      partitioned_entries[offsets[entry.home_slot / partition_entry_count]++] = entry;
+    }
+    std::vector<PartitionedGroupEntry>().swap(thread_entries[thread_idx]);
+  });
+
+  std::atomic<size_t> next_partition_idx{0};
+  std::vector<std::vector<PartitionedGroupEntry>> deferred_entries(thread_count);
+  run_on_threads([&](const size_t thread_idx) {
+    for (size_t partition_idx = next_partition_idx++; partition_idx < partition_count;
+         partition_idx = next_partition_idx++) {
+      const auto partition_end =
+          std::min((partition_idx + 1) * partition_entry_count, entry_count);
+      for (size_t i = partition_offsets[partition_idx];
+           i < partition_offsets[partition_idx + 1];
+           ++i) {
+        const auto& entry = partitioned_entries[i];
+        if (get_probe_end(entry, partition_end) < partition_end) {
+          reduce_entry(entry);
+        } else {
+          deferred_entries[thread_idx].push_back(entry);
+        }
+      }
+    }
+  });
+  for (const auto& entries : deferred_entries) {
+    for (const auto& entry : entries) {
+      reduce_entry(entry);
+    }
+  }
+}
+
 // During the reduction of two result sets using the baseline strategy, we first create a
 // big enough buffer to hold the entries for both and we move the entries from the first
 // into it before doing the reduction as usual (into the first buffer).
@@ -1033,6 +1272,18 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
                             executor));
     auto result_storage = rs_->allocateStorage(first_result.target_init_vals_);
     rs_->initializeStorage();
+    if (result_sets.front()->serialized_varlen_buffer_.empty() &&
+        use_radix_partitioned_reduction(result_sets.size(), query_mem_desc)) {
+      std::vector<const ResultSetStorage*> those;
+      for (const auto result_set : result_sets) {
+        those.push_back(result_set->storage_.get());
+      }
+      ResultSetReductionJIT reduction_jit(
+          rs_->getQueryMemDesc(), rs_->getTargetInfos(), rs_->getTargetInitVals());
+      const auto reduction_code = reduction_jit.codegen();
+      result_storage->reduceRadixPartitioned(those, reduction_code);
+      return rs_.get();
+    }
     switch (query_mem_desc.getEffectiveKeyWidth()) {
       case 4:
         first_result.moveEntriesToBuffer<int32_t>(result_storage->getUnderlyingBuffer(),
@@ -1439,6 +1690,11 @@ void ResultSetStorage::reduceOneSlot(
         AGGREGATE_ONE_COUNT(this_ptr1, that_ptr1, chosen_bytes);
         break;
       }
+      case kAPPROX_QUANTILE: {
+        CHECK_EQ(static_cast<size_t>(chosen_bytes), sizeof(int64_t));
+        approx_quantile_merge(this_ptr1, that_ptr1);
+        break;
+      }
       case kAVG: {
         // Ignore float argument compaction for count component for fear of its overflow
         AGGREGATE_ONE_COUNT(this_ptr2,
@@ -1558,6 +1814,21 @@ void ResultSetStorage::reduceOneCountDistinctSlot(int8_t* this_ptr1,
       *new_set_ptr, *old_set_ptr, new_count_distinct_desc, old_count_distinct_desc);
 }
 
+void approx_quantile_merge(int8_t* this_ptr, const int8_t* that_ptr) {
+  CHECK(this_ptr && that_ptr);
+  auto this_handle = reinterpret_cast<int64_t*>(this_ptr);
+  const auto that_handle = *reinterpret_cast<const int64_t*>(that_ptr);
+  if (!that_handle || that_handle == *this_handle) {
+    return;
+  }
+  if (!*this_handle) {
+    *this_handle = that_handle;
+    return;
+  }
+  reinterpret_cast<TDigest*>(*this_handle)
+      ->merge(*reinterpret_cast<const TDigest*>(that_handle));
+}
+
 bool ResultSetStorage::reduceSingleRow(const int8_t* row_ptr,
                                        const int8_t warp_count,
                                        const bool is_columnar,
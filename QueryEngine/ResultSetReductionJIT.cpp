@@ -457,6 +457,10 @@ extern "C" void count_distinct_set_union_jit_rt(const int64_t new_set_handle,
       new_set_handle, old_set_handle, new_count_distinct_desc, old_count_distinct_desc);
 }
 
+extern "C" void approx_quantile_jit_rt(int8_t* this_ptr1, const int8_t* that_ptr1) {
+  approx_quantile_merge(this_ptr1, that_ptr1);
+}
+
 extern "C" void get_group_value_reduction_rt(int8_t* groups_buffer,
                                              const int8_t* key,
                                              const uint32_t key_count,
@@ -1118,6 +1122,15 @@ void ResultSetReductionJIT::reduceOneAggregateSlot(Value* this_ptr1,
       emit_aggregate_one_count(this_ptr1, that_ptr1, chosen_bytes, ir_reduce_one_entry);
       break;
     }
+    case kAPPROX_QUANTILE: {
+      CHECK_EQ(static_cast<size_t>(chosen_bytes), sizeof(int64_t));
+      ir_reduce_one_entry->add<ExternalCall>(
+          "approx_quantile_jit_rt",
+          Type::Void,
+          std::vector<const Value*>{this_ptr1, that_ptr1},
+          "");
+      break;
+    }
     case kAVG: {
       // Ignore float argument compaction for count component for fear of its overflow
       emit_aggregate_one_count(this_ptr2,
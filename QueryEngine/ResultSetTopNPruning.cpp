@@ -0,0 +1,309 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ResultSetTopNPruning.cpp
+ * @brief   Pruning of the groups which can't make the top n of a grouped query before
+ * its partial results are reduced.
+ *
+ * For GROUP BY ... ORDER BY <aggregate> LIMIT n, every group of every partial (per
+ * kernel) result is reduced and sorted, although only n of them are returned. A
+ * threshold algorithm narrows the reduction down to the groups which can make the top n:
+ *
+ *  1. The best n groups of every partial result are the candidates.
+ *  2. The final values of the candidates are computed from all partial results; the n-th
+ *     best of them is the threshold.
+ *  3. In every partial result with more than n groups, a group which isn't a candidate
+ *     is at most as good as the n-th best group of the partial result. This bounds the
+ *     final value of all other groups. If the bound is worse than the threshold, these
+ *     groups are erased from the partial results and only the candidates are reduced.
+ *
+ * The outcome is exact: if the bound doesn't rule out the other groups, the partial
+ * results are left alone and reduced as usual.
+ */
+
+#include "../Analyzer/Analyzer.h"
+#include "../Shared/thread_count.h"
+#include "ResultSet.h"
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <unordered_map>
+
+namespace {
+
+// How the values of a group in the partial results make up its final value.
+enum class TopNCombine { Add, Best, Worst };
+
+// Scores are oriented such that greater is better, i.e. the aggregate value itself for
+// descending orders and its negation for ascending ones.
+bool get_top_n_combine(const TargetInfo& target_info,
+                       const bool is_desc,
+                       TopNCombine& combine) {
+  if (!target_info.is_agg || target_info.is_distinct) {
+    return false;
+  }
+  switch (target_info.agg_kind) {
+    case kCOUNT:
+      combine = TopNCombine::Add;
+      return true;
+    case kSUM:
+    case kMIN:
+    case kMAX:
+      // null values would need the null ordering of the sort
+      if (target_info.skip_null_val) {
+        return false;
+      }
+      if (target_info.agg_kind == kSUM) {
+        combine = TopNCombine::Add;
+      } else {
+        combine = (target_info.agg_kind == kMAX) == is_desc ? TopNCombine::Best
+                                                             : TopNCombine::Worst;
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+struct GroupKeyHash {
+  size_t operator()(const std::vector<int64_t>& key) const {
+    return boost::hash_range(key.begin(), key.end());
+  }
+};
+
+using CandidateMap = std::unordered_map<std::vector<int64_t>, size_t, GroupKeyHash>;
+
+// Calls func for the index of every partial result, on up to cpu_threads() threads.
+template <typename F>
+void for_each_partial_result(const size_t partial_count, F func) {
+  const size_t thread_count = std::min(partial_count, static_cast<size_t>(cpu_threads()));
+  std::vector<std::future<void>> futures;
+  for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    futures.emplace_back(
+        std::async(std::launch::async, [&func, thread_idx, thread_count, partial_count] {
+          for (size_t i = thread_idx; i < partial_count; i += thread_count) {
+            func(i);
+          }
+        }));
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+}
+
+}  // namespace
+
+bool ResultSetManager::pruneTopNGroups(const std::vector<ResultSet*>& result_sets,
+                                       const Analyzer::OrderEntry& order_entry,
+                                       const size_t n) {
+  if (result_sets.size() < 2 || !n) {
+    return false;
+  }
+  const auto first_rs = result_sets.front();
+  CHECK(first_rs);
+  CHECK_GT(order_entry.tle_no, 0);
+  const size_t target_idx = order_entry.tle_no - 1;
+  CHECK_LT(target_idx, first_rs->targets_.size());
+  const auto& target_info = first_rs->targets_[target_idx];
+  TopNCombine combine;
+  if (!get_top_n_combine(target_info, order_entry.is_desc, combine)) {
+    return false;
+  }
+  std::vector<const ResultSetStorage*> partials;
+  for (const auto rs : result_sets) {
+    CHECK(rs);
+    const auto storage = rs->storage_.get();
+    if (!storage || !rs->appended_storage_.empty() ||
+        rs->device_type_ != ExecutorDeviceType::CPU) {
+      return false;
+    }
+    const auto& query_mem_desc = storage->query_mem_desc_;
+    const auto hash_type = query_mem_desc.getQueryDescriptionType();
+    if ((hash_type != QueryDescriptionType::GroupByBaselineHash &&
+         hash_type != QueryDescriptionType::GroupByPerfectHash) ||
+        query_mem_desc.hasKeylessHash() || query_mem_desc.didOutputColumnar()) {
+      return false;
+    }
+    partials.push_back(storage);
+  }
+
+  const auto& query_mem_desc = partials.front()->query_mem_desc_;
+  const auto key_count = query_mem_desc.getGroupbyColCount();
+  const auto key_width = query_mem_desc.getEffectiveKeyWidth();
+  const auto slot_idx = query_mem_desc.getColSlotContext().getSlotsForCol(target_idx)[0];
+  const auto slot_width = query_mem_desc.getPaddedSlotWidthBytes(slot_idx);
+  const auto slot_off = align_to_int64(get_key_bytes_rowwise(query_mem_desc)) +
+                        get_byteoff_of_slot(slot_idx, query_mem_desc);
+  const bool is_fp = target_info.sql_type.is_fp();
+  const bool is_desc = order_entry.is_desc;
+
+  const auto read_key = [key_count, key_width](const int8_t* row_ptr,
+                                               std::vector<int64_t>& key) {
+    key.resize(key_count);
+    for (size_t i = 0; i < key_count; ++i) {
+      key[i] = read_int_from_buff(row_ptr + i * key_width, key_width);
+    }
+  };
+  const auto read_score = [slot_off, slot_width, is_fp, is_desc](const int8_t* row_ptr) {
+    const auto slot_ptr = row_ptr + slot_off;
+    long double value;
+    if (is_fp) {
+      value = slot_width == sizeof(float) ? *reinterpret_cast<const float*>(slot_ptr)
+                                          : *reinterpret_cast<const double*>(slot_ptr);
+    } else {
+      value = read_int_from_buff(slot_ptr, slot_width);
+    }
+    return is_desc ? value : -value;
+  };
+
+  // 1. the best n groups of every partial result
+  struct PartialTopN {
+    std::vector<size_t> entries;
+    long double kth_score{0};
+    bool full{false};  // whether the partial result has groups beyond its best n
+  };
+  std::vector<PartialTopN> partial_top_ns(partials.size());
+  for_each_partial_result(partials.size(), [&](const size_t partial_idx) {
+    const auto storage = partials[partial_idx];
+    std::vector<std::pair<long double, size_t>> scored_entries;
+    for (size_t i = 0; i < storage->query_mem_desc_.getEntryCount(); ++i) {
+      if (!storage->isEmptyEntry(i)) {
+        const auto row_ptr = row_ptr_rowwise(storage->buff_, query_mem_desc, i);
+        scored_entries.emplace_back(read_score(row_ptr), i);
+      }
+    }
+    auto& partial_top_n = partial_top_ns[partial_idx];
+    partial_top_n.full = scored_entries.size() > n;
+    if (partial_top_n.full) {
+      std::nth_element(scored_entries.begin(),
+                       scored_entries.begin() + (n - 1),
+                       scored_entries.end(),
+                       [](const std::pair<long double, size_t>& lhs,
+                          const std::pair<long double, size_t>& rhs) {
+                         return lhs.first > rhs.first;
+                       });
+      partial_top_n.kth_score = scored_entries[n - 1].first;
+      scored_entries.resize(n);
+    }
+    for (const auto& scored_entry : scored_entries) {
+      partial_top_n.entries.push_back(scored_entry.second);
+    }
+  });
+  if (std::none_of(
+          partial_top_ns.begin(), partial_top_ns.end(), [](const PartialTopN& top_n) {
+            return top_n.full;
+          })) {
+    return false;  // every group is a candidate
+  }
+
+  CandidateMap candidates;
+  std::vector<int64_t> key;
+  for (size_t i = 0; i < partials.size(); ++i) {
+    for (const auto entry_idx : partial_top_ns[i].entries) {
+      read_key(row_ptr_rowwise(partials[i]->buff_, query_mem_desc, entry_idx), key);
+      candidates.emplace(key, candidates.size());
+    }
+  }
+  CHECK_GE(candidates.size(), n);
+
+  // 2. the final values of the candidates and the threshold
+  std::vector<std::vector<std::pair<size_t, long double>>> partial_scores(
+      partials.size());
+  for_each_partial_result(partials.size(), [&](const size_t partial_idx) {
+    const auto storage = partials[partial_idx];
+    std::vector<int64_t> key;
+    for (size_t i = 0; i < storage->query_mem_desc_.getEntryCount(); ++i) {
+      if (storage->isEmptyEntry(i)) {
+        continue;
+      }
+      const auto row_ptr = row_ptr_rowwise(storage->buff_, query_mem_desc, i);
+      read_key(row_ptr, key);
+      const auto it = candidates.find(key);
+      if (it != candidates.end()) {
+        partial_scores[partial_idx].emplace_back(it->second, read_score(row_ptr));
+      }
+    }
+  });
+  std::vector<long double> candidate_scores(candidates.size());
+  std::vector<bool> has_score(candidates.size(), false);
+  for (const auto& scores : partial_scores) {
+    for (const auto& [candidate_idx, score] : scores) {
+      auto& candidate_score = candidate_scores[candidate_idx];
+      if (!has_score[candidate_idx]) {
+        candidate_score = score;
+        has_score[candidate_idx] = true;
+      } else if (combine == TopNCombine::Add) {
+        candidate_score += score;
+      } else if (combine == TopNCombine::Best) {
+        candidate_score = std::max(candidate_score, score);
+      } else {
+        candidate_score = std::min(candidate_score, score);
+      }
+    }
+  }
+  std::nth_element(candidate_scores.begin(),
+                   candidate_scores.begin() + (n - 1),
+                   candidate_scores.end(),
+                   std::greater<long double>());
+  const auto threshold = candidate_scores[n - 1];
+
+  // 3. the bound on the final value of any other group
+  long double bound{0};
+  bool has_bound{false};
+  for (const auto& partial_top_n : partial_top_ns) {
+    if (!partial_top_n.full) {
+      continue;
+    }
+    if (combine == TopNCombine::Add) {
+      // a group missing from a partial result gets nothing from it
+      bound += std::max<long double>(partial_top_n.kth_score, 0);
+    } else {
+      bound = has_bound ? std::max(bound, partial_top_n.kth_score)
+                        : partial_top_n.kth_score;
+    }
+    has_bound = true;
+  }
+  CHECK(has_bound);
+  if (!(bound < threshold)) {
+    VLOG(1) << "Top " << n << " pruning not possible, bound " << bound
+            << " isn't below threshold " << threshold;
+    return false;
+  }
+
+  // Every partial result loses the same groups, hence the perfect hash reduction, which
+  // doesn't check whether the destination entry is empty, never reduces into an erased
+  // entry.
+  for_each_partial_result(partials.size(), [&](const size_t partial_idx) {
+    const auto storage = partials[partial_idx];
+    std::vector<int64_t> key;
+    for (size_t i = 0; i < storage->query_mem_desc_.getEntryCount(); ++i) {
+      if (storage->isEmptyEntry(i)) {
+        continue;
+      }
+      const auto row_ptr = row_ptr_rowwise(storage->buff_, query_mem_desc, i);
+      read_key(row_ptr, key);
+      if (!candidates.count(key)) {
+        fill_empty_key(row_ptr, key_count, key_width);
+      }
+    }
+  });
+  VLOG(1) << "Top " << n << " pruning kept " << candidates.size() << " groups";
+  return true;
+}
@@ -68,6 +68,10 @@ class ScalarExprVisitor {
     if (lower) {
       return visitLower(lower);
     }
+    const auto upper = dynamic_cast<const Analyzer::UpperExpr*>(expr);
+    if (upper) {
+      return visitUpper(upper);
+    }
     const auto cardinality = dynamic_cast<const Analyzer::CardinalityExpr*>(expr);
     if (cardinality) {
       return visitCardinality(cardinality);
@@ -193,6 +197,10 @@ class ScalarExprVisitor {
     return visit(lower_expr->get_arg());
   }
 
+  virtual T visitUpper(const Analyzer::UpperExpr* upper_expr) const {
+    return visit(upper_expr->get_arg());
+  }
+
   virtual T visitCardinality(const Analyzer::CardinalityExpr* cardinality) const {
     T result = defaultResult();
     result = aggregateResult(result, visit(cardinality->get_arg()));
@@ -40,6 +40,18 @@ std::vector<int8_t> get_rows_copy_from_heaps(const int64_t* heaps,
                                              const size_t n,
                                              const size_t thread_count);
 
+// A component of the key of a heap ordered by several columns, passed to
+// get_bin_from_k_heap_composite as an array of 64-bit integers.
+struct HeapKeyComponent {
+  int64_t offset;       // of the key slot in the heap rows, in bytes
+  int64_t width;        // of the key slot, 4 or 8 bytes
+  int64_t is_fp;        // floating point keys are passed as the bits of a double
+  int64_t min_heap;     // whether the component is sorted in descending order
+  int64_t has_null;
+  int64_t nulls_first;
+  int64_t null_key;
+};
+
 }  // namespace streaming_top_n
 
 struct RelAlgExecutionUnit;
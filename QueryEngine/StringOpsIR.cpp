@@ -22,6 +22,8 @@
 
 #include <boost/locale/conversion.hpp>
 
+#include <algorithm>
+
 extern "C" uint64_t string_decode(int8_t* chunk_iter_, int64_t pos) {
   auto chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);
   VarlenDatum vd;
@@ -55,15 +57,108 @@ extern "C" int32_t string_compress(const int64_t ptr_and_len,
   return string_dict_proxy->getIdOfString(raw_str);
 }
 
-extern "C" int32_t lower_encoded(int32_t string_id, int64_t string_dict_proxy_address) {
-  StringDictionaryProxy* string_dict_proxy =
+extern "C" int32_t char_length_encoded(const char* str, const int32_t str_len);
+
+// LOWER / UPPER of one string id, used for the ids the per-dictionary map doesn't cover.
+extern "C" int32_t apply_string_ops_encoded(const int32_t string_id,
+                                            const int64_t string_op_translation_address,
+                                            const int64_t string_dict_proxy_address) {
+  const auto string_op_translation =
+      reinterpret_cast<const StringDictionaryProxy::StringOpTranslation*>(
+          string_op_translation_address);
+  auto string_dict_proxy =
       reinterpret_cast<StringDictionaryProxy*>(string_dict_proxy_address);
-  auto str = string_dict_proxy->getString(string_id);
-  return string_dict_proxy->getOrAddTransient(boost::locale::to_lower(str));
+  const auto str = string_dict_proxy->getString(string_id);
+  return string_dict_proxy->getOrAddTransient(string_op_translation->transform(str));
+}
+
+// Same for the string lengths.
+extern "C" int32_t char_length_dict_encoded(const int32_t string_id,
+                                            const int64_t string_dict_proxy_address,
+                                            const int32_t calc_encoded_length,
+                                            const int32_t int_null) {
+  if (string_id == NULL_INT) {
+    return int_null;
+  }
+  const auto string_dict_proxy =
+      reinterpret_cast<const StringDictionaryProxy*>(string_dict_proxy_address);
+  // other rows can add transient strings concurrently, don't hold on to their bytes
+  if (!calc_encoded_length) {
+    return static_cast<int32_t>(string_dict_proxy->getStringLength(string_id));
+  }
+  const auto str = string_dict_proxy->getString(string_id);
+  return char_length_encoded(str.c_str(), str.size());
+}
+
+namespace {
+
+enum class StringOpKind { LOWER, UPPER };
+
+// Collects the LOWER / UPPER functions wrapping a string, innermost first, and returns
+// the string they apply to.
+const Analyzer::Expr* get_string_ops(const Analyzer::Expr* expr,
+                                     std::vector<StringOpKind>& string_ops) {
+  while (true) {
+    if (const auto lower_expr = dynamic_cast<const Analyzer::LowerExpr*>(expr)) {
+      string_ops.push_back(StringOpKind::LOWER);
+      expr = lower_expr->get_arg();
+    } else if (const auto upper_expr = dynamic_cast<const Analyzer::UpperExpr*>(expr)) {
+      string_ops.push_back(StringOpKind::UPPER);
+      expr = upper_expr->get_arg();
+    } else {
+      break;
+    }
+  }
+  std::reverse(string_ops.begin(), string_ops.end());
+  return expr;
+}
+
+std::string get_string_ops_name(const std::vector<StringOpKind>& string_ops) {
+  std::string name;
+  for (const auto string_op : string_ops) {
+    name += string_op == StringOpKind::LOWER ? "LOWER;" : "UPPER;";
+  }
+  return name;
+}
+
+// Dictionaries up to this size are always mapped, building the map is cheap.
+const size_t kMaxUnconditionalStringMapEntries{10000};
+
+// Evaluating a string function for the whole dictionary only pays off when the query
+// scans at least as many rows as the dictionary has strings.
+bool use_string_dictionary_map(const StringDictionaryProxy* string_dictionary_proxy,
+                               const std::vector<InputTableInfo>& query_infos) {
+  const auto generation = string_dictionary_proxy->getGeneration();
+  CHECK_GE(generation, 0);
+  const auto entry_count = static_cast<size_t>(generation);
+  if (entry_count <= kMaxUnconditionalStringMapEntries) {
+    return true;
+  }
+  size_t rows_scanned{0};
+  for (const auto& query_info : query_infos) {
+    rows_scanned += query_info.info.getNumTuplesUpperBound();
+  }
+  return entry_count <= rows_scanned;
+}
+
+std::string apply_string_ops(const std::vector<StringOpKind>& string_ops,
+                             std::string str) {
+  for (const auto string_op : string_ops) {
+    str = string_op == StringOpKind::LOWER ? boost::locale::to_lower(str)
+                                           : boost::locale::to_upper(str);
+  }
+  return str;
 }
 
+}  // namespace
+
 llvm::Value* CodeGenerator::codegen(const Analyzer::CharLengthExpr* expr,
                                     const CompilationOptions& co) {
+  const auto cast_expr = dynamic_cast<const Analyzer::UOper*>(expr->get_arg());
+  if (cast_expr && cast_expr->get_optype() == kCAST &&
+      cast_expr->get_operand()->get_type_info().is_dict_encoded_string()) {
+    return codegenDictCharLength(expr, cast_expr->get_operand(), co);
+  }
   auto str_lv = codegen(expr->get_arg(), true, co);
   if (str_lv.size() != 3) {
     CHECK_EQ(size_t(1), str_lv.size());
@@ -102,23 +197,127 @@ llvm::Value* CodeGenerator::codegen(const Analyzer::KeyForStringExpr* expr,
 
 llvm::Value* CodeGenerator::codegen(const Analyzer::LowerExpr* expr,
                                     const CompilationOptions& co) {
+  return codegenDictStringOps(expr, co);
+}
+
+llvm::Value* CodeGenerator::codegen(const Analyzer::UpperExpr* expr,
+                                    const CompilationOptions& co) {
+  return codegenDictStringOps(expr, co);
+}
+
+llvm::Value* CodeGenerator::codegenDictStringOps(const Analyzer::Expr* expr,
+                                                 const CompilationOptions& co) {
   if (co.device_type == ExecutorDeviceType::GPU) {
     throw QueryMustRunOnCpu();
   }
 
-  auto str_id_lv = codegen(expr->get_arg(), true, co);
+  std::vector<StringOpKind> string_ops;
+  const auto str_arg = get_string_ops(expr, string_ops);
+  auto str_id_lv = codegen(str_arg, true, co);
   CHECK_EQ(size_t(1), str_id_lv.size());
 
   const auto string_dictionary_proxy = executor()->getStringDictionaryProxy(
       expr->get_type_info().get_comp_param(), executor()->getRowSetMemoryOwner(), true);
   CHECK(string_dictionary_proxy);
+  // The whole chain is applied to every string of the dictionary once per query, rows
+  // only look up the id of the result; large dictionaries over few rows go row by row.
+  const bool build_map =
+      use_string_dictionary_map(string_dictionary_proxy, cgen_state_->query_infos_);
+  const auto& string_op_translation = string_dictionary_proxy->getStringOpTranslation(
+      get_string_ops_name(string_ops),
+      [string_ops](const std::string& str) { return apply_string_ops(string_ops, str); },
+      build_map);
 
-  std::vector<llvm::Value*> args{
+  const std::vector<llvm::Value*> string_op_args{
       str_id_lv[0],
+      cgen_state_->llInt(reinterpret_cast<int64_t>(&string_op_translation)),
       cgen_state_->llInt(reinterpret_cast<int64_t>(string_dictionary_proxy))};
+  if (!build_map) {
+    return cgen_state_->emitExternalCall("apply_string_ops_encoded",
+                                         get_int_type(32, cgen_state_->context_),
+                                         string_op_args);
+  }
+  return codegenStringIdMapLookup(str_id_lv[0],
+                                  string_op_translation.ids,
+                                  "apply_string_ops_encoded",
+                                  string_op_args);
+}
 
-  return cgen_state_->emitExternalCall(
-      "lower_encoded", get_int_type(32, cgen_state_->context_), args);
+llvm::Value* CodeGenerator::codegenDictCharLength(const Analyzer::CharLengthExpr* expr,
+                                                  const Analyzer::Expr* dict_arg,
+                                                  const CompilationOptions& co) {
+  if (co.device_type == ExecutorDeviceType::GPU) {
+    throw QueryMustRunOnCpu();
+  }
+
+  auto str_id_lv = codegen(dict_arg, true, co);
+  CHECK_EQ(size_t(1), str_id_lv.size());
+
+  const auto string_dictionary_proxy =
+      executor()->getStringDictionaryProxy(dict_arg->get_type_info().get_comp_param(),
+                                           executor()->getRowSetMemoryOwner(),
+                                           true);
+  CHECK(string_dictionary_proxy);
+  const bool calc_encoded_length = expr->get_calc_encoded_length();
+  const std::vector<llvm::Value*> char_length_args{
+      str_id_lv[0],
+      cgen_state_->llInt(reinterpret_cast<int64_t>(string_dictionary_proxy)),
+      cgen_state_->llInt(static_cast<int32_t>(calc_encoded_length)),
+      cgen_state_->inlineIntNull(expr->get_type_info())};
+  if (!use_string_dictionary_map(string_dictionary_proxy, cgen_state_->query_infos_)) {
+    return cgen_state_->emitExternalCall("char_length_dict_encoded",
+                                         get_int_type(32, cgen_state_->context_),
+                                         char_length_args);
+  }
+  const auto& lengths = string_dictionary_proxy->getStringValueMap(
+      calc_encoded_length ? "CHAR_LENGTH" : "LENGTH",
+      [calc_encoded_length](const std::string& str) {
+        return calc_encoded_length ? char_length_encoded(str.c_str(), str.size())
+                                   : static_cast<int32_t>(str.size());
+      });
+
+  return codegenStringIdMapLookup(
+      str_id_lv[0], lengths, "char_length_dict_encoded", char_length_args);
+}
+
+llvm::Value* CodeGenerator::codegenStringIdMapLookup(
+    llvm::Value* str_id_lv,
+    const StringDictionaryProxy::TranslationMap& map,
+    const std::string& fallback_fname,
+    const std::vector<llvm::Value*>& fallback_args) {
+  CHECK(map.ids);
+  auto& builder = cgen_state_->ir_builder_;
+  auto& context = cgen_state_->context_;
+  const auto i32_type = get_int_type(32, context);
+  const auto idx_lv =
+      builder.CreateSub(cgen_state_->castToTypeIn(str_id_lv, 64),
+                        cgen_state_->llInt(static_cast<int64_t>(map.min_id)));
+  // ids below min_id wrap around and fail the unsigned comparison as well
+  const auto in_map_lv = builder.CreateICmpULT(
+      idx_lv, cgen_state_->llInt(static_cast<int64_t>(map.ids->size())));
+  auto func = builder.GetInsertBlock()->getParent();
+  auto map_lookup_bb = llvm::BasicBlock::Create(context, "map_lookup", func);
+  auto map_fallback_bb = llvm::BasicBlock::Create(context, "map_fallback", func);
+  auto map_done_bb = llvm::BasicBlock::Create(context, "map_done", func);
+  builder.CreateCondBr(in_map_lv, map_lookup_bb, map_fallback_bb);
+
+  builder.SetInsertPoint(map_lookup_bb);
+  const auto map_lv =
+      builder.CreateIntToPtr(cgen_state_->llInt(reinterpret_cast<int64_t>(map.data())),
+                             i32_type->getPointerTo());
+  const auto mapped_lv = builder.CreateLoad(builder.CreateGEP(map_lv, idx_lv));
+  builder.CreateBr(map_done_bb);
+
+  builder.SetInsertPoint(map_fallback_bb);
+  const auto fallback_lv =
+      cgen_state_->emitExternalCall(fallback_fname, i32_type, fallback_args);
+  builder.CreateBr(map_done_bb);
+
+  builder.SetInsertPoint(map_done_bb);
+  auto result_lv = builder.CreatePHI(i32_type, 2);
+  result_lv->addIncoming(mapped_lv, map_lookup_bb);
+  result_lv->addIncoming(fallback_lv, map_fallback_bb);
+  return result_lv;
 }
 
 llvm::Value* CodeGenerator::codegen(const Analyzer::LikeExpr* expr,
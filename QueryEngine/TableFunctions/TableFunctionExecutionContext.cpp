@@ -20,7 +20,13 @@
 #include "QueryEngine/ColumnFetcher.h"
 #include "QueryEngine/GpuMemUtils.h"
 #include "QueryEngine/TableFunctions/TableFunctionCompilationContext.h"
+#include "QueryEngine/TableFunctions/TableFunctionsFactory.h"
 #include "Shared/Logger.h"
+#include "Shared/thread_count.h"
+
+#include <future>
+
+extern size_t g_table_function_min_slice_rows;
 
 namespace {
 
@@ -82,25 +88,11 @@ ResultSetPtr TableFunctionExecutionContext::execute(
     device_allocator.reset(new CudaAllocator(&data_mgr, device_id));
   }
 
+  // the column inputs are fetched by fetchColumnInputs(), the literals are set up once
   std::vector<const int8_t*> col_buf_ptrs;
-  ssize_t element_count = -1;
   for (const auto& input_expr : exe_unit.input_exprs) {
-    if (auto col_var = dynamic_cast<Analyzer::ColumnVar*>(input_expr)) {
-      auto [col_buf, buf_elem_count] = ColumnFetcher::getOneColumnFragment(
-          executor,
-          *col_var,
-          table_info.info.fragments.front(),
-          device_type == ExecutorDeviceType::CPU ? Data_Namespace::MemoryLevel::CPU_LEVEL
-                                                 : Data_Namespace::MemoryLevel::GPU_LEVEL,
-          device_id,
-          chunks_owner,
-          column_fetcher.columnarized_table_cache_);
-      if (element_count < 0) {
-        element_count = static_cast<ssize_t>(buf_elem_count);
-      } else {
-        CHECK_EQ(static_cast<ssize_t>(buf_elem_count), element_count);
-      }
-      col_buf_ptrs.push_back(col_buf);
+    if (dynamic_cast<Analyzer::ColumnVar*>(input_expr)) {
+      col_buf_ptrs.push_back(nullptr);
     } else if (const auto& constant_val = dynamic_cast<Analyzer::Constant*>(input_expr)) {
       // TODO(adb): Unify literal handling with rest of system, either in Codegen or as a
       // separate serialization component
@@ -160,19 +152,34 @@ ResultSetPtr TableFunctionExecutionContext::execute(
   }
   CHECK_EQ(col_buf_ptrs.size(), exe_unit.input_exprs.size());
 
-  CHECK_GE(element_count, ssize_t(0));
+  const auto& table_function =
+      table_functions::TableFunctionsFactory::get(exe_unit.table_func_name);
+  if (device_type == ExecutorDeviceType::CPU && table_function.isRowParallel()) {
+    return launchCpuCodeRowParallel(exe_unit,
+                                    table_info,
+                                    compilation_context,
+                                    column_fetcher,
+                                    col_buf_ptrs,
+                                    executor);
+  }
+
+  const auto element_count = fetchColumnInputs(exe_unit,
+                                               table_info.info.fragments.front(),
+                                               column_fetcher,
+                                               device_type,
+                                               device_id,
+                                               col_buf_ptrs,
+                                               chunks_owner,
+                                               executor);
   switch (device_type) {
     case ExecutorDeviceType::CPU:
-      return launchCpuCode(exe_unit,
-                           compilation_context,
-                           col_buf_ptrs,
-                           static_cast<size_t>(element_count),
-                           executor);
+      return launchCpuCode(
+          exe_unit, compilation_context, col_buf_ptrs, element_count, executor);
     case ExecutorDeviceType::GPU:
       return launchGpuCode(exe_unit,
                            compilation_context,
                            col_buf_ptrs,
-                           static_cast<size_t>(element_count),
+                           element_count,
                            /*device_id=*/0,
                            executor);
   }
@@ -180,6 +187,112 @@ ResultSetPtr TableFunctionExecutionContext::execute(
   return nullptr;
 }
 
+size_t TableFunctionExecutionContext::fetchColumnInputs(
+    const TableFunctionExecutionUnit& exe_unit,
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const ColumnFetcher& column_fetcher,
+    const ExecutorDeviceType device_type,
+    const int device_id,
+    std::vector<const int8_t*>& col_buf_ptrs,
+    std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner,
+    Executor* executor) {
+  CHECK_EQ(col_buf_ptrs.size(), exe_unit.input_exprs.size());
+  ssize_t element_count = -1;
+  for (size_t i = 0; i < exe_unit.input_exprs.size(); ++i) {
+    const auto col_var = dynamic_cast<Analyzer::ColumnVar*>(exe_unit.input_exprs[i]);
+    if (!col_var) {
+      continue;
+    }
+    auto [col_buf, buf_elem_count] = ColumnFetcher::getOneColumnFragment(
+        executor,
+        *col_var,
+        fragment,
+        device_type == ExecutorDeviceType::CPU ? Data_Namespace::MemoryLevel::CPU_LEVEL
+                                               : Data_Namespace::MemoryLevel::GPU_LEVEL,
+        device_id,
+        chunks_owner,
+        column_fetcher.columnarized_table_cache_);
+    if (element_count < 0) {
+      element_count = static_cast<ssize_t>(buf_elem_count);
+    } else {
+      CHECK_EQ(static_cast<ssize_t>(buf_elem_count), element_count);
+    }
+    col_buf_ptrs[i] = col_buf;
+  }
+  CHECK_GE(element_count, ssize_t(0));
+  return static_cast<size_t>(element_count);
+}
+
+ResultSetPtr TableFunctionExecutionContext::launchCpuCodeRowParallel(
+    const TableFunctionExecutionUnit& exe_unit,
+    const InputTableInfo& table_info,
+    const TableFunctionCompilationContext* compilation_context,
+    const ColumnFetcher& column_fetcher,
+    const std::vector<const int8_t*>& literal_buf_ptrs,
+    Executor* executor) {
+  std::vector<ResultSetPtr> results;
+  // The fragments are processed one at a time, such that only the inputs of the current
+  // fragment are held in memory; each fragment is split into slices processed in
+  // parallel, each with its own output buffer.
+  for (const auto& fragment : table_info.info.fragments) {
+    std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
+    auto col_buf_ptrs = literal_buf_ptrs;
+    const auto element_count = fetchColumnInputs(exe_unit,
+                                                 fragment,
+                                                 column_fetcher,
+                                                 ExecutorDeviceType::CPU,
+                                                 /*device_id=*/0,
+                                                 col_buf_ptrs,
+                                                 chunks_owner,
+                                                 executor);
+    const size_t min_slice_rows = std::max(g_table_function_min_slice_rows, size_t(1));
+    const size_t slice_count =
+        std::max(std::min(static_cast<size_t>(cpu_threads()),
+                          (element_count + min_slice_rows - 1) / min_slice_rows),
+                 size_t(1));
+    const size_t slice_rows =
+        std::max((element_count + slice_count - 1) / slice_count, size_t(1));
+    std::vector<std::future<ResultSetPtr>> slice_futures;
+    // an empty fragment still gets one invocation
+    for (size_t slice_start = 0; slice_start < std::max(element_count, size_t(1));
+         slice_start += slice_rows) {
+      const auto slice_end = std::min(slice_start + slice_rows, element_count);
+      std::vector<const int8_t*> slice_buf_ptrs;
+      for (size_t i = 0; i < exe_unit.input_exprs.size(); ++i) {
+        const auto col_var = dynamic_cast<Analyzer::ColumnVar*>(exe_unit.input_exprs[i]);
+        if (col_var && col_buf_ptrs[i]) {
+          const auto elem_size = col_var->get_type_info().get_size();
+          CHECK_GT(elem_size, 0);
+          slice_buf_ptrs.push_back(col_buf_ptrs[i] + slice_start * elem_size);
+        } else {
+          slice_buf_ptrs.push_back(col_buf_ptrs[i]);
+        }
+      }
+      const auto slice_elem_count = slice_end - slice_start;
+      slice_futures.emplace_back(std::async(
+          std::launch::async,
+          [this, &exe_unit, compilation_context, executor, slice_elem_count](
+              std::vector<const int8_t*> slice_buf_ptrs) {
+            return launchCpuCode(exe_unit,
+                                 compilation_context,
+                                 slice_buf_ptrs,
+                                 slice_elem_count,
+                                 executor);
+          },
+          std::move(slice_buf_ptrs)));
+    }
+    for (auto& slice_future : slice_futures) {
+      results.push_back(slice_future.get());
+    }
+  }
+  CHECK(!results.empty());
+  auto& first = results.front();
+  for (size_t i = 1; i < results.size(); ++i) {
+    first->append(*results[i]);
+  }
+  return first;
+}
+
 ResultSetPtr TableFunctionExecutionContext::launchCpuCode(
     const TableFunctionExecutionUnit& exe_unit,
     const TableFunctionCompilationContext* compilation_context,
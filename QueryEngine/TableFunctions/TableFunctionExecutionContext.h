@@ -25,6 +25,14 @@ class TableFunctionCompilationContext;
 class ColumnFetcher;
 class Executor;
 
+namespace Chunk_NS {
+class Chunk;
+}  // namespace Chunk_NS
+
+namespace Fragmenter_Namespace {
+class FragmentInfo;
+}  // namespace Fragmenter_Namespace
+
 class TableFunctionExecutionContext {
  public:
   TableFunctionExecutionContext(std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner)
@@ -42,6 +50,25 @@ class TableFunctionExecutionContext {
                        Executor* executor);
 
  private:
+  // Fetches the column inputs of the given fragment into the positions of col_buf_ptrs
+  // which correspond to columns, returns their element count.
+  size_t fetchColumnInputs(const TableFunctionExecutionUnit& exe_unit,
+                           const Fragmenter_Namespace::FragmentInfo& fragment,
+                           const ColumnFetcher& column_fetcher,
+                           const ExecutorDeviceType device_type,
+                           const int device_id,
+                           std::vector<const int8_t*>& col_buf_ptrs,
+                           std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner,
+                           Executor* executor);
+  // Invokes a row parallel table function on slices of its input fragments concurrently
+  // and concatenates the outputs.
+  ResultSetPtr launchCpuCodeRowParallel(
+      const TableFunctionExecutionUnit& exe_unit,
+      const InputTableInfo& table_info,
+      const TableFunctionCompilationContext* compilation_context,
+      const ColumnFetcher& column_fetcher,
+      const std::vector<const int8_t*>& literal_buf_ptrs,
+      Executor* executor);
   ResultSetPtr launchCpuCode(const TableFunctionExecutionUnit& exe_unit,
                              const TableFunctionCompilationContext* compilation_context,
                              std::vector<const int8_t*>& col_buf_ptrs,
@@ -58,9 +58,12 @@ void TableFunctionsFactory::add(const std::string& name,
                                 const TableFunctionOutputRowSizer sizer,
                                 const std::vector<ExtArgumentType>& input_args,
                                 const std::vector<ExtArgumentType>& output_args,
-                                bool is_runtime) {
+                                bool is_runtime,
+                                bool is_row_parallel) {
   functions_.insert(std::make_pair(
-      name, TableFunction(name, sizer, input_args, output_args, is_runtime)));
+      name,
+      TableFunction(
+          name, sizer, input_args, output_args, is_runtime, is_row_parallel)));
 }
 
 std::once_flag init_flag;
@@ -77,7 +80,9 @@ void TableFunctionsFactory::init() {
                                      ExtArgumentType::PInt32,
                                      ExtArgumentType::PInt64,
                                      ExtArgumentType::PInt64},
-        std::vector<ExtArgumentType>{ExtArgumentType::PDouble});
+        std::vector<ExtArgumentType>{ExtArgumentType::PDouble},
+        /*is_runtime=*/false,
+        /*is_row_parallel=*/true);
   });
 }
 
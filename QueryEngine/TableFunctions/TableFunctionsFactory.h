@@ -40,12 +40,14 @@ class TableFunction {
                 const TableFunctionOutputRowSizer output_sizer,
                 const std::vector<ExtArgumentType>& input_args,
                 const std::vector<ExtArgumentType>& output_args,
-                bool is_runtime)
+                bool is_runtime,
+                bool is_row_parallel)
       : name_(name)
       , output_sizer_(output_sizer)
       , input_args_(input_args)
       , output_args_(output_args)
-      , is_runtime_(is_runtime) {}
+      , is_runtime_(is_runtime)
+      , is_row_parallel_(is_row_parallel) {}
 
   std::vector<ExtArgumentType> getArgs() const {
     std::vector<ExtArgumentType> args;
@@ -68,12 +70,17 @@ class TableFunction {
 
   bool isRuntime() const { return is_runtime_; }
 
+  // Row parallel table functions compute their output rows from disjoint slices of their
+  // input independently, hence can be invoked on every slice concurrently.
+  bool isRowParallel() const { return is_row_parallel_; }
+
  private:
   const std::string name_;
   const TableFunctionOutputRowSizer output_sizer_;
   const std::vector<ExtArgumentType> input_args_;
   const std::vector<ExtArgumentType> output_args_;
   const bool is_runtime_;
+  const bool is_row_parallel_;
 };
 
 class TableFunctionsFactory {
@@ -82,7 +89,8 @@ class TableFunctionsFactory {
                   const TableFunctionOutputRowSizer sizer,
                   const std::vector<ExtArgumentType>& input_args,
                   const std::vector<ExtArgumentType>& output_args,
-                  bool is_runtime = false);
+                  bool is_runtime = false,
+                  bool is_row_parallel = false);
 
   static const TableFunction& get(const std::string& name);
 
@@ -18,9 +18,15 @@
 
 #include "Analyzer/Analyzer.h"
 #include "QueryEngine/Execute.h"
+#include "QueryEngine/HyperLogLog.h"
+#include "QueryEngine/HyperLogLogRank.h"
+#include "QueryEngine/MurmurHash.h"
 #include "Shared/Logger.h"
 #include "Shared/scope.h"
 
+#include <mutex>
+#include <random>
+
 TableOptimizer::TableOptimizer(const TableDescriptor* td,
                                Executor* executor,
                                const Catalog_Namespace::Catalog& cat)
@@ -29,6 +35,11 @@ TableOptimizer::TableOptimizer(const TableDescriptor* td,
 }
 namespace {
 
+// Serializes the optimizers which run their queries on the same executor, since they
+// swap its row set memory owner and catalog. The execute mutex is only held shared, so
+// that queries on other executors go on meanwhile.
+std::mutex optimizer_executor_mutex;
+
 template <typename T>
 T read_scalar_target_value(const TargetValue& tv) {
   const auto stv = boost::get<ScalarTargetValue>(&tv);
@@ -110,11 +121,119 @@ inline ExecutionOptions get_execution_options() {
       false, false, false, false, false, false, false, false, 0, false, false, 0, false};
 }
 
+// Accumulates the values of a column across fragments and shards.
+class ColumnStatisticsCollector {
+ public:
+  ColumnStatisticsCollector(const size_t sample_size)
+      : hll_registers_(1 << kHllBits, 0), sample_size_(sample_size), rng_(0) {}
+
+  void addNull() { ++num_rows_; }
+
+  void addValue(const double value) {
+    ++num_rows_;
+    ++num_non_null_;
+    const auto hash = MurmurHash64A(&value, sizeof(value), 0);
+    const auto index = hash >> (64 - kHllBits);
+    const auto rank = get_rank(hash << kHllBits, 64 - kHllBits);
+    hll_registers_[index] = std::max(hll_registers_[index], rank);
+    // reservoir sampling
+    if (sample_.size() < sample_size_) {
+      sample_.push_back(value);
+    } else {
+      std::uniform_int_distribution<size_t> dist(0, num_non_null_ - 1);
+      const auto slot = dist(rng_);
+      if (slot < sample_size_) {
+        sample_[slot] = value;
+      }
+    }
+  }
+
+  ColumnStatistics finalize(const size_t histogram_buckets,
+                            const size_t most_common_values_count) {
+    ColumnStatistics stats;
+    stats.num_rows = num_rows_;
+    if (num_rows_ == 0) {
+      return stats;
+    }
+    stats.null_fraction = static_cast<double>(num_rows_ - num_non_null_) / num_rows_;
+    if (sample_.empty()) {
+      return stats;
+    }
+    std::sort(sample_.begin(), sample_.end());
+    std::vector<std::pair<double, size_t>> value_counts;
+    for (const auto value : sample_) {
+      if (value_counts.empty() || value_counts.back().first != value) {
+        value_counts.emplace_back(value, 0);
+      }
+      ++value_counts.back().second;
+    }
+    // the sketch can undercount small columns, the sample gives a lower bound
+    stats.ndv = std::min(
+        std::max(static_cast<int64_t>(hll_size(hll_registers_.data(), kHllBits)),
+                 static_cast<int64_t>(value_counts.size())),
+        num_non_null_);
+
+    const double non_null_fraction = 1. - stats.null_fraction;
+    const double average_count = static_cast<double>(sample_.size()) / stats.ndv;
+    std::sort(value_counts.begin(),
+              value_counts.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+    for (const auto& value_count : value_counts) {
+      if (stats.most_common_values.size() >= most_common_values_count ||
+          value_count.second < 2 || value_count.second <= average_count) {
+        break;
+      }
+      stats.most_common_values.emplace_back(
+          value_count.first,
+          non_null_fraction * value_count.second / sample_.size());
+    }
+
+    const auto bucket_count = std::min(histogram_buckets, sample_.size());
+    for (size_t i = 0; i <= bucket_count && bucket_count > 0; ++i) {
+      const auto idx = std::min(i * sample_.size() / bucket_count, sample_.size() - 1);
+      stats.histogram_bounds.push_back(sample_[idx]);
+    }
+    return stats;
+  }
+
+ private:
+  static constexpr uint32_t kHllBits{14};
+
+  int64_t num_rows_{0};
+  int64_t num_non_null_{0};
+  std::vector<uint8_t> hll_registers_;
+  const size_t sample_size_;
+  std::vector<double> sample_;
+  std::mt19937_64 rng_;
+};
+
+// Reads a projected value in the domain used by ColumnStatistics, nullopt for nulls.
+std::optional<double> read_statistics_value(const TargetValue& tv,
+                                            const SQLTypeInfo& ti) {
+  const auto stv = boost::get<ScalarTargetValue>(&tv);
+  CHECK(stv);
+  if (ti.is_fp()) {
+    if (ti.get_type() == kFLOAT) {
+      const auto val = *boost::get<float>(stv);
+      return val == inline_fp_null_value<float>() ? std::nullopt
+                                                  : std::optional<double>(val);
+    }
+    const auto val = *boost::get<double>(stv);
+    return val == inline_fp_null_value<double>() ? std::nullopt
+                                                 : std::optional<double>(val);
+  }
+  const auto val = *boost::get<int64_t>(stv);
+  const auto null_val = ti.is_string() ? inline_int_null_value<int32_t>()
+                                       : inline_int_null_val(get_logical_type_info(ti));
+  return val == null_val ? std::nullopt : std::optional<double>(val);
+}
+
 }  // namespace
 
 void TableOptimizer::recomputeMetadata() const {
   INJECT_TIMER(optimizeMetadata);
-  mapd_unique_lock<mapd_shared_mutex> lock(executor_->execute_mutex_);
+  mapd_shared_lock<mapd_shared_mutex> execute_lock(executor_->execute_mutex_);
+  std::lock_guard<std::mutex> executor_lock(optimizer_executor_mutex);
 
   LOG(INFO) << "Recomputing metadata for " << td_->tableName;
 
@@ -342,6 +461,94 @@ void TableOptimizer::recomputeMetadata() const {
   }
 }
 
+std::map<int, ColumnStatistics> TableOptimizer::computeColumnStatistics(
+    const size_t histogram_buckets,
+    const size_t most_common_values_count,
+    const size_t sample_size) const {
+  INJECT_TIMER(computeColumnStatistics);
+  mapd_shared_lock<mapd_shared_mutex> execute_lock(executor_->execute_mutex_);
+  std::lock_guard<std::mutex> executor_lock(optimizer_executor_mutex);
+
+  LOG(INFO) << "Computing column statistics for " << td_->tableName;
+
+  CHECK_GE(td_->tableId, 0);
+
+  std::vector<const TableDescriptor*> table_descriptors;
+  if (td_->nShards > 0) {
+    const auto physical_tds = cat_.getPhysicalTablesDescriptors(td_);
+    table_descriptors.insert(
+        table_descriptors.begin(), physical_tds.begin(), physical_tds.end());
+  } else {
+    table_descriptors.push_back(td_);
+  }
+
+  std::map<int, ColumnStatisticsCollector> collectors;
+  const auto col_descs =
+      cat_.getAllColumnMetadataForTable(td_->tableId, false, false, false);
+  for (const auto td : table_descriptors) {
+    ScopeGuard row_set_holder = [this] { executor_->row_set_mem_owner_ = nullptr; };
+    executor_->row_set_mem_owner_ = std::make_shared<RowSetMemoryOwner>();
+    executor_->catalog_ = &cat_;
+    const auto table_id = td->tableId;
+
+    for (const auto& cd : col_descs) {
+      const auto& ti = cd->columnType;
+      if (ti.is_varlen() || ti.is_geometry() ||
+          (ti.is_string() && ti.get_compression() != kENCODING_DICT)) {
+        continue;
+      }
+      const auto column_id = cd->columnId;
+      const auto input_col_desc =
+          std::make_shared<const InputColDescriptor>(column_id, table_id, 0);
+      std::shared_ptr<Analyzer::Expr> target_expr =
+          makeExpr<Analyzer::ColumnVar>(ti, table_id, column_id, 0);
+      if (ti.is_string()) {
+        // statistics of dictionary encoded columns are kept over the string ids
+        target_expr = makeExpr<Analyzer::KeyForStringExpr>(target_expr);
+      }
+      const auto ra_exe_unit = build_ra_exe_unit(input_col_desc, {target_expr.get()});
+      const auto table_infos = get_table_infos(ra_exe_unit, executor_);
+      CHECK_EQ(table_infos.size(), size_t(1));
+
+      const auto co = get_compilation_options(ExecutorDeviceType::CPU);
+      const auto eo = get_execution_options();
+
+      auto& collector =
+          collectors.emplace(column_id, ColumnStatisticsCollector(sample_size))
+              .first->second;
+      const auto& target_ti = target_expr->get_type_info();
+      Executor::PerFragmentCallBack collect_statistics_callback =
+          [&collector, &target_ti](
+              ResultSetPtr results,
+              const Fragmenter_Namespace::FragmentInfo& fragment_info) {
+            while (true) {
+              const auto row = results->getNextRow(false, false);
+              if (row.empty()) {
+                break;
+              }
+              CHECK_EQ(row.size(), size_t(1));
+              const auto value = read_statistics_value(row[0], target_ti);
+              if (value) {
+                collector.addValue(*value);
+              } else {
+                collector.addNull();
+              }
+            }
+          };
+
+      executor_->executeWorkUnitPerFragment(
+          ra_exe_unit, table_infos[0], co, eo, cat_, collect_statistics_callback);
+    }
+  }
+
+  std::map<int, ColumnStatistics> stats_by_column_id;
+  for (auto& [column_id, collector] : collectors) {
+    stats_by_column_id.emplace(
+        column_id, collector.finalize(histogram_buckets, most_common_values_count));
+  }
+  return stats_by_column_id;
+}
+
 void TableOptimizer::vacuumDeletedRows() const {
   const auto table_id = td_->tableId;
   cat_.vacuumDeletedRows(table_id);
@@ -51,6 +51,17 @@ class TableOptimizer {
    */
   void vacuumDeletedRows() const;
 
+  /**
+   * @brief Computes the statistics used for cardinality estimation for each scalar
+   * column of the table: number of distinct values (through HyperLogLog), null fraction
+   * and, from a uniform sample of the rows, an equi-depth histogram and the most common
+   * values. Returns the statistics keyed by column id, physical shards are merged.
+   */
+  std::map<int, ColumnStatistics> computeColumnStatistics(
+      const size_t histogram_buckets,
+      const size_t most_common_values_count,
+      const size_t sample_size) const;
+
  private:
   const TableDescriptor* td_;
   Executor* executor_;
@@ -67,6 +67,8 @@ std::vector<std::string> agg_fn_base_names(const TargetInfo& target_info) {
       return {"checked_single_agg_id"};
     case kSAMPLE:
       return {"agg_id"};
+    case kAPPROX_QUANTILE:
+      return {"agg_approx_quantile"};
     default:
       UNREACHABLE() << "Unrecognized agg kind: " << std::to_string(target_info.agg_kind);
   }
@@ -406,6 +408,9 @@ void TargetExprCodegen::codegenAggregate(
       CHECK(!chosen_type.is_fp());
       group_by_and_agg->codegenCountDistinct(
           target_idx, target_expr, agg_args, query_mem_desc, co.device_type);
+    } else if (target_info.agg_kind == kAPPROX_QUANTILE) {
+      CHECK_EQ(agg_chosen_bytes, sizeof(int64_t));
+      group_by_and_agg->codegenApproxQuantile(target_expr, agg_args, co.device_type);
     } else {
       const auto& arg_ti = target_info.agg_arg_type;
       if (need_skip_null && !arg_ti.is_geometry()) {
@@ -184,7 +184,8 @@ inline TCountDistinctImplType::type count_distinct_impl_type_to_thrift(
   switch (impl_type) {
     THRIFT_COUNTDESCRIPTORIMPL_CASE(Invalid)
     THRIFT_COUNTDESCRIPTORIMPL_CASE(Bitmap)
-    THRIFT_COUNTDESCRIPTORIMPL_CASE(StdSet)
+    THRIFT_COUNTDESCRIPTORIMPL_CASE(HashSet)
+    THRIFT_COUNTDESCRIPTORIMPL_CASE(SparseBitmap)
     default:
       CHECK(false);
   }
@@ -219,7 +220,12 @@ inline CountDistinctImplType count_distinct_impl_type_from_thrift(
   switch (impl_type) {
     UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(Invalid)
     UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(Bitmap)
-    UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(StdSet)
+    UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(HashSet)
+    UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(SparseBitmap)
+    case TCountDistinctImplType::StdSet:
+      throw std::runtime_error(
+          "COUNT(DISTINCT) buffers of the std::set implementation are not supported "
+          "anymore");
     default:
       CHECK(false);
   }
@@ -22,6 +22,7 @@
  * Copyright (c) 2017 MapD Technologies, Inc.  All rights reserved.
  */
 #include "../Shared/funcannotations.h"
+#include "StreamingTopN.h"
 
 enum class HeapOrdering { MIN, MAX };
 
@@ -79,12 +80,107 @@ struct KeyComparator {
   const NullsOrdering nulls_ordering;
 };
 
-template <typename KeyT = int64_t, typename NodeT = int64_t>
+// The key of a heap ordered by several columns, either in a heap row or, for the
+// candidate row, in an array of its components.
+struct CompositeKey {
+  const int8_t* row;
+  const int64_t* components;
+};
+
+template <typename NodeT = int64_t>
+struct CompositeKeyAccessor {
+  DEVICE CompositeKeyAccessor(const int8_t* rows, const size_t row_stride)
+      : buffer(rows), stride(row_stride) {}
+  ALWAYS_INLINE DEVICE CompositeKey get(const NodeT rowid) const {
+    return {buffer + stride * rowid, nullptr};
+  }
+
+  const int8_t* buffer;
+  const size_t stride;
+};
+
+ALWAYS_INLINE DEVICE int64_t
+read_heap_key_component(const int8_t* row_ptr,
+                        const streaming_top_n::HeapKeyComponent& component) {
+  const auto slot_ptr = row_ptr + component.offset;
+  if (component.is_fp) {
+    const double value = component.width == 4
+                             ? *reinterpret_cast<const float*>(slot_ptr)
+                             : *reinterpret_cast<const double*>(slot_ptr);
+    return *reinterpret_cast<const int64_t*>(&value);
+  }
+  return component.width == 4 ? *reinterpret_cast<const int32_t*>(slot_ptr)
+                              : *reinterpret_cast<const int64_t*>(slot_ptr);
+}
+
+ALWAYS_INLINE DEVICE void write_heap_key_component(
+    int8_t* row_ptr,
+    const streaming_top_n::HeapKeyComponent& component,
+    const int64_t key) {
+  const auto slot_ptr = row_ptr + component.offset;
+  if (component.is_fp) {
+    const auto value = *reinterpret_cast<const double*>(&key);
+    if (component.width == 4) {
+      *reinterpret_cast<float*>(slot_ptr) = value;
+    } else {
+      *reinterpret_cast<double*>(slot_ptr) = value;
+    }
+  } else if (component.width == 4) {
+    *reinterpret_cast<int32_t*>(slot_ptr) = key;
+  } else {
+    *reinterpret_cast<int64_t*>(slot_ptr) = key;
+  }
+}
+
+// Compares keys lexicographically, each component the way KeyComparator does.
+struct CompositeKeyComparator {
+  DEVICE CompositeKeyComparator(const streaming_top_n::HeapKeyComponent* key_components,
+                                const uint32_t key_component_count)
+      : components(key_components), component_count(key_component_count) {}
+  ALWAYS_INLINE DEVICE bool operator()(const CompositeKey& lhs,
+                                       const CompositeKey& rhs) const {
+    for (uint32_t i = 0; i < component_count; ++i) {
+      const auto& component = components[i];
+      const auto lhs_key = lhs.components ? lhs.components[i]
+                                          : read_heap_key_component(lhs.row, component);
+      const auto rhs_key = rhs.components ? rhs.components[i]
+                                          : read_heap_key_component(rhs.row, component);
+      if (component.has_null) {
+        const bool lhs_null = lhs_key == component.null_key;
+        const bool rhs_null = rhs_key == component.null_key;
+        if (lhs_null && rhs_null) {
+          continue;
+        }
+        if (lhs_null || rhs_null) {
+          return component.nulls_first ? rhs_null : lhs_null;
+        }
+      }
+      if (component.is_fp) {
+        const auto lhs_value = *reinterpret_cast<const double*>(&lhs_key);
+        const auto rhs_value = *reinterpret_cast<const double*>(&rhs_key);
+        if (lhs_value != rhs_value) {
+          return component.min_heap ? lhs_value < rhs_value : lhs_value > rhs_value;
+        }
+      } else if (lhs_key != rhs_key) {
+        return component.min_heap ? lhs_key < rhs_key : lhs_key > rhs_key;
+      }
+    }
+    return false;
+  }
+
+  const streaming_top_n::HeapKeyComponent* components;
+  const uint32_t component_count;
+};
+
+template <typename KeyT = int64_t,
+          typename NodeT = int64_t,
+          typename Comparator = KeyComparator<KeyT>,
+          typename Accessor = KeyAccessor<KeyT, NodeT>>
 ALWAYS_INLINE DEVICE void sift_down(NodeT* heap,
                                     const size_t heap_size,
                                     const NodeT curr_idx,
-                                    const KeyComparator<KeyT>& compare,
-                                    const KeyAccessor<KeyT, NodeT>& accessor) {
+                                    const Comparator& compare,
+                                    const Accessor& accessor) {
   for (NodeT i = curr_idx, last = static_cast<NodeT>(heap_size); i < last;) {
 #ifdef __CUDACC__
     const auto left_child = min(2 * i + 1, last);
@@ -120,11 +216,14 @@ ALWAYS_INLINE DEVICE void sift_down(NodeT* heap,
   }
 }
 
-template <typename KeyT = int64_t, typename NodeT = int64_t>
+template <typename KeyT = int64_t,
+          typename NodeT = int64_t,
+          typename Comparator = KeyComparator<KeyT>,
+          typename Accessor = KeyAccessor<KeyT, NodeT>>
 ALWAYS_INLINE DEVICE void sift_up(NodeT* heap,
                                   const NodeT curr_idx,
-                                  const KeyComparator<KeyT>& compare,
-                                  const KeyAccessor<KeyT, NodeT>& accessor) {
+                                  const Comparator& compare,
+                                  const Accessor& accessor) {
   for (NodeT i = curr_idx; i > 0 && (i - 1) < i;) {
     const auto parent = (i - 1) / 2;
     const auto curr_key = accessor.get(heap[i]);
@@ -261,3 +360,50 @@ DEF_GET_BIN_FROM_K_HEAP(int32_t)
 DEF_GET_BIN_FROM_K_HEAP(int64_t)
 DEF_GET_BIN_FROM_K_HEAP(float)
 DEF_GET_BIN_FROM_K_HEAP(double)
+
+// Same as get_bin_from_k_heap_impl, for a heap ordered by several columns. The key
+// components of the current row are passed as 64-bit integers, floating point ones as
+// the bits of a double. This function only works on rowwise layout.
+extern "C" NEVER_INLINE DEVICE int64_t* get_bin_from_k_heap_composite(
+    int64_t* heaps,
+    const uint32_t k,
+    const uint32_t row_size_quad,
+    const int64_t* key_components,
+    const uint32_t key_component_count,
+    const int64_t* curr_key) {
+  const int32_t thread_global_index = pos_start_impl(nullptr);
+  const int32_t thread_count = pos_step_impl();
+  int64_t& node_count = heaps[thread_global_index];
+  int64_t* heap_ptr = heaps + thread_count + thread_global_index * k;
+  int64_t* rows_ptr =
+      heaps + thread_count + thread_count * k + thread_global_index * row_size_quad * k;
+  const auto components =
+      reinterpret_cast<const streaming_top_n::HeapKeyComponent*>(key_components);
+  CompositeKeyComparator compare(components, key_component_count);
+  CompositeKeyAccessor<int64_t> accessor(reinterpret_cast<int8_t*>(rows_ptr),
+                                         row_size_quad * sizeof(int64_t));
+  int64_t bin_index{0};
+  if (node_count < static_cast<int64_t>(k)) {
+    bin_index = node_count++;
+    heap_ptr[bin_index] = bin_index;
+    auto row_ptr = reinterpret_cast<int8_t*>(rows_ptr + bin_index * row_size_quad);
+    for (uint32_t i = 0; i < key_component_count; ++i) {
+      write_heap_key_component(row_ptr, components[i], curr_key[i]);
+    }
+    sift_up<int64_t, int64_t>(heap_ptr, bin_index, compare, accessor);
+  } else {
+    bin_index = heap_ptr[0];
+    auto row_ptr = reinterpret_cast<int8_t*>(rows_ptr + bin_index * row_size_quad);
+    if (compare(CompositeKey{nullptr, curr_key}, CompositeKey{row_ptr, nullptr})) {
+      return nullptr;
+    }
+    // kick out
+    for (uint32_t i = 0; i < key_component_count; ++i) {
+      write_heap_key_component(row_ptr, components[i], curr_key[i]);
+    }
+    sift_down<int64_t, int64_t>(heap_ptr, node_count, 0, compare, accessor);
+  }
+  auto row_ptr = rows_ptr + bin_index * row_size_quad;
+  row_ptr[0] = bin_index;
+  return row_ptr + 1;
+}
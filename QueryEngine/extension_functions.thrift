@@ -63,6 +63,10 @@ struct TUserDefinedTableFunction {
   3: i32 sizerArgPos,
   4: list<TExtArgumentType> inputArgTypes,
   5: list<TExtArgumentType> outputArgTypes,
-  6: list<TExtArgumentType> sqlArgTypes
+  6: list<TExtArgumentType> sqlArgTypes,
+  /* Whether the output rows computed from disjoint slices of the input rows are
+     independent, which allows invoking the UDTF on the slices of its input concurrently
+     and concatenating the outputs. */
+  7: bool rowParallel = false
 }
 
@@ -23,7 +23,9 @@ struct TColSlotContext {
 enum TCountDistinctImplType {
   Invalid,
   Bitmap,
-  StdSet
+  StdSet,  // no longer produced, kept so that the values below don't change
+  HashSet,
+  SparseBitmap
 }
 
 struct TCountDistinctDescriptor {
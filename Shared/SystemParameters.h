@@ -54,6 +54,12 @@ struct SystemParameters {
   size_t calcite_timeout =
       5000;  // calcite send/receive timeout (connect timeout hard coded to 2s)
   int num_executors = 1;
+  bool enable_buffer_pool_warmup = false;    // reload the hottest chunks on startup
+  double buffer_pool_warmup_fraction = 0.5;  // fraction of the CPU pool to reload
+  size_t max_paged_results_per_session = 8;  // open paged results of a session
+  size_t paged_result_idle_timeout = 300;    // seconds a paged result is kept unfetched
+  size_t paged_result_lock_timeout = 10;     // same, for one holding table locks
+  size_t paged_results_max_mem_bytes = size_t(1) << 31;  // all paged results together
 
   SystemParameters() : cuda_block_size(0), cuda_grid_size(0), calcite_max_mem(1024) {}
 };
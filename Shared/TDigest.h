@@ -0,0 +1,181 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    TDigest.h
+ * @brief   Mergeable t-digest used by the APPROX_PERCENTILE and APPROX_MEDIAN
+ * aggregates.
+ *
+ * A merging t-digest (Dunning, "Computing Extremely Accurate Quantiles Using
+ * t-Digests") summarizes a distribution as a sorted list of weighted centroids. The size
+ * of a centroid is bounded by the k1 scale function, which keeps centroids near the
+ * tails small and the estimates of extreme quantiles accurate. Added values are buffered
+ * and merged into the centroids once the buffer fills up, so the memory used by a digest
+ * is bounded by its compression regardless of the number of added values.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+class TDigest {
+ public:
+  static constexpr double kDefaultCompression{100};
+
+  explicit TDigest(const double q, const double compression = kDefaultCompression)
+      : q_(q)
+      , compression_(compression)
+      , buffer_capacity_(static_cast<size_t>(5 * compression))
+      , min_(std::numeric_limits<double>::infinity())
+      , max_(-std::numeric_limits<double>::infinity()) {}
+
+  // Quantile computed by quantile(), in [0, 1].
+  double quantileParam() const { return q_; }
+
+  bool empty() const { return centroids_.empty() && buffer_.empty(); }
+
+  void add(const double value) {
+    if (std::isnan(value)) {
+      return;
+    }
+    addCentroid({value, 1});
+  }
+
+  // Merges the values summarized by that into this digest.
+  void merge(const TDigest& that) {
+    for (const auto& centroid : that.centroids_) {
+      addCentroid(centroid);
+    }
+    for (const auto& centroid : that.buffer_) {
+      addCentroid(centroid);
+    }
+    // the centroids of that may have absorbed its extreme values
+    min_ = std::min(min_, that.min_);
+    max_ = std::max(max_, that.max_);
+  }
+
+  // Estimates the quantile q of the added values; NaN if no value has been added.
+  // Flushes the buffered values, hence not const. Unlike add() and merge(), which are
+  // only called by the thread owning the digest, concurrent calls are safe: a result set
+  // can be read (e.g. sorted) by several threads at once.
+  double quantile(const double q) {
+    std::lock_guard<std::mutex> lock(flush_mutex_);
+    flush();
+    if (centroids_.empty()) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (centroids_.size() == 1) {
+      return centroids_.front().mean;
+    }
+    const auto index = std::max(0., std::min(1., q)) * total_weight_;
+    // the mean of a centroid sits at the center of the weight it covers
+    const auto& first = centroids_.front();
+    if (index < first.weight / 2) {
+      return interpolate(min_, first.mean, index / (first.weight / 2));
+    }
+    double weight_so_far{first.weight / 2};
+    for (size_t i = 0; i + 1 < centroids_.size(); ++i) {
+      const auto& lhs = centroids_[i];
+      const auto& rhs = centroids_[i + 1];
+      const auto gap = (lhs.weight + rhs.weight) / 2;
+      if (index < weight_so_far + gap) {
+        return interpolate(lhs.mean, rhs.mean, (index - weight_so_far) / gap);
+      }
+      weight_so_far += gap;
+    }
+    const auto& last = centroids_.back();
+    const auto tail = last.weight / 2;
+    return interpolate(last.mean, max_, std::min(1., (index - weight_so_far) / tail));
+  }
+
+  double quantile() { return quantile(q_); }
+
+ private:
+  struct Centroid {
+    double mean;
+    double weight;
+
+    bool operator<(const Centroid& that) const { return mean < that.mean; }
+  };
+
+  static double interpolate(const double lo, const double hi, const double fraction) {
+    return lo + (hi - lo) * fraction;
+  }
+
+  // k1 scale function, maps a quantile to the index of its centroid
+  double scale(const double q) const {
+    return compression_ / (2 * M_PI) * std::asin(2 * q - 1);
+  }
+
+  double inverseScale(const double k) const {
+    return (std::sin(std::min(k * 2 * M_PI / compression_, M_PI / 2)) + 1) / 2;
+  }
+
+  void addCentroid(const Centroid& centroid) {
+    buffer_.push_back(centroid);
+    min_ = std::min(min_, centroid.mean);
+    max_ = std::max(max_, centroid.mean);
+    if (buffer_.size() >= buffer_capacity_) {
+      flush();
+    }
+  }
+
+  // Merges the buffered values into the centroids.
+  void flush() {
+    if (buffer_.empty()) {
+      return;
+    }
+    buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+    std::sort(buffer_.begin(), buffer_.end());
+    centroids_.clear();
+    total_weight_ = 0;
+    for (const auto& centroid : buffer_) {
+      total_weight_ += centroid.weight;
+    }
+    double weight_so_far{0};
+    double weight_limit = total_weight_ * inverseScale(scale(0) + 1);
+    auto current = buffer_.front();
+    for (size_t i = 1; i < buffer_.size(); ++i) {
+      const auto& next = buffer_[i];
+      if (weight_so_far + current.weight + next.weight <= weight_limit) {
+        current.weight += next.weight;
+        current.mean += (next.mean - current.mean) * next.weight / current.weight;
+      } else {
+        weight_so_far += current.weight;
+        weight_limit =
+            total_weight_ * inverseScale(scale(weight_so_far / total_weight_) + 1);
+        centroids_.push_back(current);
+        current = next;
+      }
+    }
+    centroids_.push_back(current);
+    buffer_.clear();
+  }
+
+  const double q_;
+  const double compression_;
+  const size_t buffer_capacity_;
+  std::vector<Centroid> centroids_;  // sorted by mean
+  std::vector<Centroid> buffer_;
+  double total_weight_{0};  // weight of the centroids, excluding the buffer
+  double min_;
+  double max_;
+  std::mutex flush_mutex_;
+};
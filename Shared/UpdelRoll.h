@@ -67,7 +67,9 @@ struct UpdelRoll {
   bool is_varlen_update = false;
 
   void cancelUpdate();
-  void commitUpdate();
+  // Without a checkpoint, the changed chunks stay dirty in the buffer pool until the
+  // next checkpoint of the table.
+  void commitUpdate(const bool checkpoint = true);
 };
 
 #endif
@@ -76,7 +76,8 @@ enum SQLAgg {
   kCOUNT,
   kAPPROX_COUNT_DISTINCT,
   kSAMPLE,
-  kSINGLE_VALUE
+  kSINGLE_VALUE,
+  kAPPROX_QUANTILE
 };
 
 enum class SqlWindowFunctionKind {
@@ -33,6 +33,7 @@
 
 #include <future>
 #include <iostream>
+#include <numeric>
 #include <string_view>
 #include <thread>
 
@@ -99,6 +100,62 @@ uint32_t rk_hash(const std::string_view& str) {
   }
   return str_hash;
 }
+
+// The hash index file holds this header, followed by the string id hash table and, if
+// the hashes are materialized, by the hashes of the strings. It covers the first
+// str_count strings of the dictionary, of which the last one is fingerprinted by its
+// end in the payload and its hash. The checksum covers the header and the tables.
+struct HashIndexHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t materialized_hashes;
+  uint64_t str_count;
+  uint64_t payload_file_off;
+  uint64_t hash_table_size;
+  uint64_t rk_hashes_size;
+  uint32_t last_str_hash;
+  uint32_t padding;
+  uint64_t checksum;
+};
+
+constexpr uint64_t kHashIndexMagic{0x5844494853444d4fULL};
+constexpr uint32_t kHashIndexVersion{1};
+
+uint64_t hash_index_checksum(uint64_t checksum, const void* data, const size_t bytes) {
+  CHECK_EQ(bytes % sizeof(uint32_t), size_t(0));
+  const auto words = reinterpret_cast<const uint32_t*>(data);
+  for (size_t i = 0; i < bytes / sizeof(uint32_t); ++i) {
+    checksum = (checksum ^ words[i]) * 0x100000001b3ULL;
+  }
+  return checksum;
+}
+
+uint64_t hash_index_checksum(const HashIndexHeader& header,
+                             const int32_t* hash_table,
+                             const uint32_t* rk_hashes) {
+  auto unchecked_header = header;
+  unchecked_header.checksum = 0;
+  auto checksum =
+      hash_index_checksum(0xcbf29ce484222325ULL, &unchecked_header, sizeof(header));
+  checksum = hash_index_checksum(
+      checksum, hash_table, header.hash_table_size * sizeof(*hash_table));
+  return hash_index_checksum(
+      checksum, rk_hashes, header.rk_hashes_size * sizeof(*rk_hashes));
+}
+
+bool write_fully(const int fd, const void* data, const size_t bytes) {
+  auto remaining = bytes;
+  auto ptr = reinterpret_cast<const char*>(data);
+  while (remaining) {
+    const auto written = write(fd, ptr, remaining);
+    if (written < 0) {
+      return false;
+    }
+    ptr += written;
+    remaining -= written;
+  }
+  return true;
+}
 }  // namespace
 
 bool g_enable_stringdict_parallel{false};
@@ -116,6 +173,7 @@ StringDictionary::StringDictionary(const std::string& folder,
     , rk_hashes_(initial_capacity)
     , isTemp_(isTemp)
     , materialize_hashes_(materializeHashes)
+    , hash_index_str_count_(0)
     , payload_fd_(-1)
     , offset_fd_(-1)
     , offset_map_(nullptr)
@@ -135,8 +193,14 @@ StringDictionary::StringDictionary(const std::string& folder,
     offsets_path_ = (storage_path / boost::filesystem::path("DictOffsets")).string();
     const auto payload_path =
         (storage_path / boost::filesystem::path("DictPayload")).string();
+    hash_index_path_ =
+        (storage_path / boost::filesystem::path("DictHashIndex")).string();
     payload_fd_ = checked_open(payload_path.c_str(), recover);
     offset_fd_ = checked_open(offsets_path_.c_str(), recover);
+    if (!recover) {
+      boost::system::error_code ec;
+      boost::filesystem::remove(hash_index_path_, ec);
+    }
     payload_file_size_ = file_size(payload_fd_);
     offset_file_size_ = file_size(offset_fd_);
   }
@@ -157,6 +221,11 @@ StringDictionary::StringDictionary(const std::string& folder,
         LOG(WARNING) << "Offsets " << offsets_path_ << " file is truncated";
       }
       const uint64_t str_count = bytes / sizeof(StringIdxEntry);
+      if (loadHashIndex(str_count)) {
+        mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+        recoverStringsAfterHashIndex(str_count);
+        return;
+      }
       // at this point we know the size of the StringDict we need to load
       // so lets reallocate the vector to the correct size
       const uint64_t max_entries = round_up_p2(str_count * 2 + 1);
@@ -225,6 +294,161 @@ void StringDictionary::processDictionaryFutures(
   dictionary_futures.clear();
 }
 
+/**
+ * Loads the string id hash table, and the hashes of the strings if they are
+ * materialized, from the hash index persisted by the last checkpoint which wrote one.
+ * Returns false if there is no index, or if it doesn't match the strings in storage, in
+ * which case the caller rebuilds the table from the strings.
+ */
+bool StringDictionary::loadHashIndex(const size_t max_str_count) {
+  const auto fd = open(hash_index_path_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  const auto index_file_size = file_size(fd);
+  if (index_file_size < sizeof(HashIndexHeader)) {
+    close(fd);
+    LOG(WARNING) << "Ignoring truncated dictionary hash index " << hash_index_path_;
+    return false;
+  }
+  auto index_map = mmap(nullptr, index_file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (index_map == MAP_FAILED) {
+    LOG(WARNING) << "Could not map the dictionary hash index " << hash_index_path_;
+    return false;
+  }
+  const auto header = *reinterpret_cast<const HashIndexHeader*>(index_map);
+  const auto hash_table = reinterpret_cast<const int32_t*>(
+      reinterpret_cast<const int8_t*>(index_map) + sizeof(HashIndexHeader));
+  const auto rk_hashes =
+      reinterpret_cast<const uint32_t*>(hash_table + header.hash_table_size);
+  std::string stale_reason;
+  if (header.magic != kHashIndexMagic || header.version != kHashIndexVersion) {
+    stale_reason = "unknown format";
+  } else if (sizeof(HashIndexHeader) + header.hash_table_size * sizeof(int32_t) +
+                 header.rk_hashes_size * sizeof(uint32_t) !=
+             index_file_size) {
+    stale_reason = "truncated";
+  } else if (bool(header.materialized_hashes) != materialize_hashes_) {
+    stale_reason = "built with materialized hashes " +
+                   std::to_string(header.materialized_hashes);
+  } else if (!header.str_count || header.str_count > max_str_count ||
+             header.hash_table_size <= 2 * header.str_count ||
+             (materialize_hashes_ && header.rk_hashes_size <= header.str_count)) {
+    stale_reason = "string count " + std::to_string(header.str_count) +
+                   " doesn't fit the storage";
+  } else {
+    const auto last_str = getStringFromStorage(header.str_count - 1);
+    const auto last_str_meta = offset_map_ + header.str_count - 1;
+    if (last_str.canary || last_str_meta->off + last_str_meta->size !=
+                               header.payload_file_off ||
+        rk_hash(std::string_view(last_str.c_str_ptr, last_str.size)) !=
+            header.last_str_hash) {
+      stale_reason = "last string doesn't match the storage";
+    } else if (hash_index_checksum(header, hash_table, rk_hashes) != header.checksum) {
+      stale_reason = "checksum mismatch";
+    }
+  }
+  if (stale_reason.empty()) {
+    string_id_hash_table_.assign(hash_table, hash_table + header.hash_table_size);
+    rk_hashes_.assign(rk_hashes, rk_hashes + header.rk_hashes_size);
+    str_count_ = header.str_count;
+    payload_file_off_ = header.payload_file_off;
+    hash_index_str_count_ = header.str_count;
+  } else {
+    LOG(WARNING) << "Rebuilding the dictionary hash index " << hash_index_path_ << ", "
+                 << stale_reason;
+  }
+  checked_munmap(index_map, index_file_size);
+  return stale_reason.empty();
+}
+
+// Adds the strings which made it to storage after the hash index was last written.
+void StringDictionary::recoverStringsAfterHashIndex(const size_t max_str_count) {
+  while (str_count_ < max_str_count) {
+    const auto recovered = getStringFromStorage(str_count_);
+    if (recovered.canary) {
+      break;
+    }
+    if (fillRateIsHigh(str_count_)) {
+      increaseCapacity();
+    }
+    const auto hash = rk_hash(std::string_view(recovered.c_str_ptr, recovered.size));
+    const auto bucket = computeUniqueBucketWithHash(hash, string_id_hash_table_);
+    string_id_hash_table_[bucket] = static_cast<int32_t>(str_count_);
+    if (materialize_hashes_) {
+      rk_hashes_[str_count_] = hash;
+    }
+    payload_file_off_ += recovered.size;
+    ++str_count_;
+  }
+  if (str_count_ > hash_index_str_count_) {
+    VLOG(1) << "Recovered " << str_count_ - hash_index_str_count_
+            << " strings past the hash index " << hash_index_path_;
+  }
+}
+
+/**
+ * Persists the hash table, and the materialized hashes, so that the next open of the
+ * dictionary doesn't hash every string again. The index is written to a temporary file
+ * which replaces the previous one, so a crash leaves either of them whole. Rewriting it
+ * is proportional to the size of the dictionary, hence it is only done once the
+ * strings added since the last write amount to an eighth of those covered by it; the
+ * strings past the index are hashed on open.
+ */
+bool StringDictionary::writeHashIndex() {
+  std::lock_guard<std::mutex> hash_index_lock(hash_index_mutex_);
+  // the tables are copied under the read lock, which isn't held while they are written
+  // and synced, so adding strings isn't blocked on the disk
+  HashIndexHeader header{};
+  std::vector<int32_t> hash_table;
+  std::vector<uint32_t> rk_hashes;
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    if (!str_count_ ||
+        (str_count_ - hash_index_str_count_) * 8 < hash_index_str_count_) {
+      return true;
+    }
+    const auto last_str = getStringFromStorage(str_count_ - 1);
+    CHECK(!last_str.canary);
+    header.magic = kHashIndexMagic;
+    header.version = kHashIndexVersion;
+    header.materialized_hashes = materialize_hashes_;
+    header.str_count = str_count_;
+    header.payload_file_off = payload_file_off_;
+    header.last_str_hash = rk_hash(std::string_view(last_str.c_str_ptr, last_str.size));
+    hash_table = string_id_hash_table_;
+    if (materialize_hashes_) {
+      rk_hashes = rk_hashes_;
+    }
+  }
+  header.hash_table_size = hash_table.size();
+  header.rk_hashes_size = rk_hashes.size();
+  header.checksum = hash_index_checksum(header, hash_table.data(), rk_hashes.data());
+
+  const auto tmp_path = hash_index_path_ + ".tmp";
+  const auto fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    LOG(ERROR) << "Could not create the dictionary hash index " << tmp_path;
+    return false;
+  }
+  bool ret = write_fully(fd, &header, sizeof(header));
+  ret = ret &&
+        write_fully(fd, hash_table.data(), header.hash_table_size * sizeof(int32_t));
+  ret = ret &&
+        write_fully(fd, rk_hashes.data(), header.rk_hashes_size * sizeof(uint32_t));
+  ret = ret && (fsync(fd) == 0);
+  close(fd);
+  ret = ret && (rename(tmp_path.c_str(), hash_index_path_.c_str()) == 0);
+  if (!ret) {
+    LOG(ERROR) << "Could not write the dictionary hash index " << hash_index_path_;
+    unlink(tmp_path.c_str());
+    return false;
+  }
+  hash_index_str_count_ = header.str_count;
+  return true;
+}
+
 StringDictionary::StringDictionary(const LeafHostInfo& host, const DictRef dict_ref)
     : strings_cache_(nullptr)
     , client_(new StringDictionaryClient(host, dict_ref, true))
@@ -855,16 +1079,6 @@ std::vector<int32_t> StringDictionary::getCompare(const std::string& pattern,
   return ret;
 }
 
-namespace {
-
-bool is_regexp_like(const std::string& str,
-                    const std::string& pattern,
-                    const char escape) {
-  return regexp_like(str.c_str(), str.size(), pattern.c_str(), pattern.size(), escape);
-}
-
-}  // namespace
-
 std::vector<int32_t> StringDictionary::getRegexpLike(const std::string& pattern,
                                                      const char escape,
                                                      const size_t generation) const {
@@ -883,22 +1097,22 @@ std::vector<int32_t> StringDictionary::getRegexpLike(const std::string& pattern,
   CHECK_GT(worker_count, 0);
   std::vector<std::vector<int32_t>> worker_results(worker_count);
   CHECK_LE(generation, str_count_);
+  // Every worker matches a contiguous range of the payloads in place, regexp_like only
+  // compiles the pattern once per thread.
+  const size_t step = (generation + worker_count - 1) / worker_count;
   for (int worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
-    workers.emplace_back([&worker_results,
-                          &pattern,
-                          generation,
-                          escape,
-                          worker_idx,
-                          worker_count,
-                          this]() {
-      for (size_t string_id = worker_idx; string_id < generation;
-           string_id += worker_count) {
-        const auto str = getStringUnlocked(string_id);
-        if (is_regexp_like(str, pattern, escape)) {
-          worker_results[worker_idx].push_back(string_id);
-        }
-      }
-    });
+    workers.emplace_back(
+        [&worker_results, &pattern, generation, escape, worker_idx, step, this]() {
+          const size_t begin = std::min(worker_idx * step, generation);
+          const size_t end = std::min(begin + step, generation);
+          for (size_t string_id = begin; string_id < end; ++string_id) {
+            const auto str = getStringBytesChecked(string_id);
+            if (regexp_like(
+                    str.first, str.second, pattern.c_str(), pattern.size(), escape)) {
+              worker_results[worker_idx].push_back(string_id);
+            }
+          }
+        });
   }
   for (auto& worker : workers) {
     worker.join();
@@ -964,6 +1178,96 @@ std::shared_ptr<const std::vector<std::string>> StringDictionary::copyStrings()
   return strings_cache_;
 }
 
+std::shared_ptr<const std::vector<int32_t>> StringDictionary::getTranslationMap(
+    const std::shared_ptr<StringDictionary>& dest_dict,
+    const size_t source_generation,
+    const size_t dest_generation) const {
+  CHECK(dest_dict);
+  {
+    std::lock_guard<std::mutex> cache_lock(translation_map_cache_mutex_);
+    for (auto it = translation_map_cache_.begin(); it != translation_map_cache_.end();) {
+      const auto cached_dest_dict = it->dest_dict.lock();
+      if (!cached_dest_dict) {
+        // the destination dictionary has been dropped
+        it = translation_map_cache_.erase(it);
+        continue;
+      }
+      if (cached_dest_dict == dest_dict && it->source_generation == source_generation &&
+          it->dest_generation == dest_generation) {
+        translation_map_cache_.splice(
+            translation_map_cache_.begin(), translation_map_cache_, it);
+        return it->translation_map;
+      }
+      ++it;
+    }
+  }
+
+  auto translation_map =
+      std::make_shared<std::vector<int32_t>>(source_generation, INVALID_STR_ID);
+  if (dest_dict.get() == this) {
+    std::iota(translation_map->begin(),
+              translation_map->begin() + std::min(source_generation, dest_generation),
+              0);
+  } else if (client_ || dest_dict->client_) {
+    for (size_t string_id = 0; string_id < source_generation; ++string_id) {
+      (*translation_map)[string_id] = truncate_to_generation(
+          dest_dict->getIdOfString(getString(string_id)), dest_generation);
+    }
+  } else {
+    // always lock the dictionaries in the same order to avoid deadlocks with a
+    // translation in the opposite direction
+    const auto first_dict = std::min<const StringDictionary*>(this, dest_dict.get());
+    const auto second_dict = std::max<const StringDictionary*>(this, dest_dict.get());
+    mapd_shared_lock<mapd_shared_mutex> first_read_lock(first_dict->rw_mutex_);
+    mapd_shared_lock<mapd_shared_mutex> second_read_lock(second_dict->rw_mutex_);
+    buildTranslationMap(*translation_map, dest_dict.get(), dest_generation);
+  }
+
+  std::lock_guard<std::mutex> cache_lock(translation_map_cache_mutex_);
+  translation_map_cache_.push_front(
+      {dest_dict, source_generation, dest_generation, translation_map});
+  // a dictionary is usually joined against a handful of other dictionaries
+  constexpr size_t max_cached_translation_maps{8};
+  if (translation_map_cache_.size() > max_cached_translation_maps) {
+    translation_map_cache_.pop_back();
+  }
+  return translation_map;
+}
+
+void StringDictionary::buildTranslationMap(std::vector<int32_t>& translation_map,
+                                           const StringDictionary* dest_dict,
+                                           const size_t dest_generation) const {
+  CHECK_LE(translation_map.size(), str_count_);
+  auto translate = [this, &translation_map, dest_dict, dest_generation](
+                       const size_t start_id, const size_t end_id) {
+    for (size_t string_id = start_id; string_id < end_id; ++string_id) {
+      const auto str = getStringFromStorageFast(string_id);
+      const auto dest_id =
+          dest_dict->string_id_hash_table_[dest_dict->computeBucket(
+              rk_hash(str), str, dest_dict->string_id_hash_table_)];
+      translation_map[string_id] = truncate_to_generation(dest_id, dest_generation);
+    }
+  };
+  const size_t entry_count = translation_map.size();
+  const bool multithreaded = entry_count > 10000;
+  const auto worker_count =
+      multithreaded ? static_cast<size_t>(cpu_threads()) : size_t(1);
+  CHECK_GT(worker_count, 0UL);
+  if (!multithreaded) {
+    translate(0, entry_count);
+    return;
+  }
+  std::vector<std::future<void>> workers;
+  const auto stride = (entry_count + (worker_count - 1)) / worker_count;
+  for (size_t start = 0; start < entry_count; start += stride) {
+    workers.push_back(std::async(
+        std::launch::async, translate, start, std::min(start + stride, entry_count)));
+  }
+  for (auto& worker : workers) {
+    worker.get();
+  }
+}
+
 bool StringDictionary::fillRateIsHigh(const size_t num_strings) const noexcept {
   return string_id_hash_table_.size() <= num_strings * 2;
 }
@@ -1357,6 +1661,8 @@ bool StringDictionary::checkpoint() noexcept {
   ret = ret && (msync((void*)payload_map_, payload_file_size_, MS_SYNC) == 0);
   ret = ret && (fsync(offset_fd_) == 0);
   ret = ret && (fsync(payload_fd_) == 0);
+  // the index is only written once the strings it covers are durable
+  ret = ret && writeHashIndex();
   return ret;
 }
 
@@ -23,7 +23,10 @@
 #include "LeafHostInfo.h"
 
 #include <future>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -104,6 +107,21 @@ class StringDictionary {
       const StringDictionary* source_dict,
       const std::map<int32_t, std::string> transient_mapping = {});
 
+  /**
+   * @brief Returns a dense map from the ids of this dictionary to the ids of the same
+   * strings in \p dest_dict
+   *
+   * The map covers the ids [0, source_generation) and holds INVALID_STR_ID for strings
+   * which don't exist in the first dest_generation entries of the destination
+   * dictionary. It is built in parallel and cached per destination dictionary and pair of
+   * generations, so repeated joins and IN predicates between the same dictionaries don't
+   * translate every string again.
+   */
+  std::shared_ptr<const std::vector<int32_t>> getTranslationMap(
+      const std::shared_ptr<StringDictionary>& dest_dict,
+      const size_t source_generation,
+      const size_t dest_generation) const;
+
   static void populate_string_array_ids(
       std::vector<std::vector<int32_t>>& dest_array_ids,
       StringDictionary* dest_dict,
@@ -129,6 +147,13 @@ class StringDictionary {
     int32_t diff;
   };
 
+  struct TranslationMapCacheEntry {
+    std::weak_ptr<StringDictionary> dest_dict;
+    size_t source_generation;
+    size_t dest_generation;
+    std::shared_ptr<const std::vector<int32_t>> translation_map;
+  };
+
   struct PayloadString {
     char* c_str_ptr;
     size_t size;
@@ -138,6 +163,9 @@ class StringDictionary {
   void processDictionaryFutures(
       std::vector<std::future<std::vector<std::pair<uint32_t, unsigned int>>>>&
           dictionary_futures);
+  bool loadHashIndex(const size_t max_str_count);
+  void recoverStringsAfterHashIndex(const size_t max_str_count);
+  bool writeHashIndex();
   bool fillRateIsHigh(const size_t num_strings) const noexcept;
   void increaseCapacity() noexcept;
   template <class String>
@@ -191,6 +219,9 @@ class StringDictionary {
   std::vector<int32_t> getEquals(std::string pattern,
                                  std::string comp_operator,
                                  size_t generation);
+  void buildTranslationMap(std::vector<int32_t>& translation_map,
+                           const StringDictionary* dest_dict,
+                           const size_t dest_generation) const;
   void buildSortedCache();
   void insertInSortedCache(std::string str, int32_t str_id);
   void sortCache(std::vector<int32_t>& cache);
@@ -204,6 +235,8 @@ class StringDictionary {
   bool isTemp_;
   bool materialize_hashes_;
   std::string offsets_path_;
+  std::string hash_index_path_;
+  size_t hash_index_str_count_;  // strings covered by the persisted hash index
   int payload_fd_;
   int offset_fd_;
   StringIdxEntry* offset_map_;
@@ -212,12 +245,16 @@ class StringDictionary {
   size_t payload_file_size_;
   size_t payload_file_off_;
   mutable mapd_shared_mutex rw_mutex_;
+  std::mutex hash_index_mutex_;
   mutable std::map<std::tuple<std::string, bool, bool, char>, std::vector<int32_t>>
       like_cache_;
   mutable std::map<std::pair<std::string, char>, std::vector<int32_t>> regex_cache_;
   mutable std::map<std::string, int32_t> equal_cache_;
   mutable DictionaryCache<std::string, compare_cache_value_t> compare_cache_;
   mutable std::shared_ptr<std::vector<std::string>> strings_cache_;
+  // most recently used first
+  mutable std::list<TranslationMapCacheEntry> translation_map_cache_;
+  mutable std::mutex translation_map_cache_mutex_;
   std::unique_ptr<StringDictionaryClient> client_;
   std::unique_ptr<StringDictionaryClient> client_no_timeout_;
 
@@ -24,6 +24,7 @@
 
 #include <sys/fcntl.h>
 
+#include <future>
 #include <thread>
 
 StringDictionaryProxy::StringDictionaryProxy(std::shared_ptr<StringDictionary> sd,
@@ -100,6 +101,174 @@ std::string StringDictionaryProxy::getString(int32_t string_id) const {
   return it->second;
 }
 
+StringDictionaryProxy::TranslationMap StringDictionaryProxy::buildTranslationMap(
+    const StringDictionaryProxy* dest_proxy) const {
+  CHECK(dest_proxy);
+  const auto dest_generation = dest_proxy->getGeneration();
+  CHECK_GE(dest_generation, 0);
+  // The ids stored in a column can be past the generation of the proxy, translate the
+  // whole source dictionary.
+  const auto source_entry_count = string_dict_->storageEntryCount();
+  auto dict_translation_map = string_dict_->getTranslationMap(
+      dest_proxy->string_dict_, source_entry_count, dest_generation);
+  std::map<int32_t, std::string> source_transients;
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    source_transients = transient_int_to_str_;
+  }
+  std::map<int32_t, std::string> dest_transients;
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(dest_proxy->rw_mutex_);
+    dest_transients = dest_proxy->transient_int_to_str_;
+  }
+  if (source_transients.empty() && dest_transients.empty()) {
+    return {dict_translation_map, 0};
+  }
+
+  // transient ids are negative and grow downwards from -2
+  const int32_t min_id = source_transients.empty() ? 0 : source_transients.begin()->first;
+  auto ids = std::make_shared<std::vector<int32_t>>(source_entry_count - min_id,
+                                                    StringDictionary::INVALID_STR_ID);
+  std::copy(dict_translation_map->begin(),
+            dict_translation_map->end(),
+            ids->begin() - min_id);
+  for (const auto& [dest_id, str] : dest_transients) {
+    const auto source_id = string_dict_->getIdOfString(str);
+    if (source_id != StringDictionary::INVALID_STR_ID &&
+        static_cast<size_t>(source_id) < source_entry_count &&
+        (*ids)[source_id - min_id] == StringDictionary::INVALID_STR_ID) {
+      (*ids)[source_id - min_id] = dest_id;
+    }
+  }
+  for (const auto& [source_id, str] : source_transients) {
+    (*ids)[source_id - min_id] = dest_proxy->getIdOfString(str);
+  }
+  return {ids, min_id};
+}
+
+namespace {
+
+// Parallelize the string functions over large dictionaries only.
+size_t string_op_worker_count(const size_t entry_count) {
+  return entry_count > 10000 ? static_cast<size_t>(cpu_threads()) : size_t(1);
+}
+
+// Runs func(worker_idx, begin, end) over contiguous ranges of the ids [0, entry_count).
+template <typename F>
+void for_each_id_range(const size_t entry_count, const size_t worker_count, F func) {
+  CHECK_GT(worker_count, 0UL);
+  if (worker_count == 1) {
+    func(size_t(0), size_t(0), entry_count);
+    return;
+  }
+  std::vector<std::future<void>> workers;
+  const size_t stride = (entry_count + worker_count - 1) / worker_count;
+  for (size_t worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+    const size_t begin = std::min(worker_idx * stride, entry_count);
+    const size_t end = std::min(begin + stride, entry_count);
+    workers.push_back(std::async(std::launch::async, func, worker_idx, begin, end));
+  }
+  for (auto& worker : workers) {
+    worker.get();
+  }
+}
+
+}  // namespace
+
+const StringDictionaryProxy::StringOpTranslation&
+StringDictionaryProxy::getStringOpTranslation(const std::string& transform_name,
+                                              const StringTransform& transform,
+                                              const bool build_map) {
+  std::lock_guard<std::mutex> maps_lock(string_op_maps_mutex_);
+  auto& translation = string_op_translations_[transform_name];
+  if (!translation.transform) {
+    translation.transform = transform;
+  }
+  if (!build_map || translation.ids.ids) {
+    return translation;
+  }
+  CHECK_GE(generation_, 0);
+  const size_t entry_count = generation_;
+  std::map<int32_t, std::string> transients;
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    transients = transient_int_to_str_;
+  }
+  // transient ids are negative and grow downwards from -2
+  const int32_t min_id = transients.empty() ? 0 : transients.begin()->first;
+  auto ids = std::make_shared<std::vector<int32_t>>(entry_count - min_id,
+                                                    StringDictionary::INVALID_STR_ID);
+  // Strings are transformed and looked up in the dictionary in parallel, only the
+  // results missing from the dictionary are added as transients under the write lock.
+  const auto worker_count = string_op_worker_count(entry_count);
+  std::vector<std::vector<std::pair<int32_t, std::string>>> worker_misses(worker_count);
+  for_each_id_range(
+      entry_count,
+      worker_count,
+      [this, &ids, &worker_misses, &transform, min_id](
+          const size_t worker_idx, const size_t begin, const size_t end) {
+        auto& misses = worker_misses[worker_idx];
+        for (size_t string_id = begin; string_id < end; ++string_id) {
+          const auto str = string_dict_->getString(string_id);
+          auto transformed_str = transform(str);
+          auto& transformed_id = (*ids)[string_id - min_id];
+          if (transformed_str == str) {
+            transformed_id = string_id;
+            continue;
+          }
+          transformed_id = truncate_to_generation(
+              string_dict_->getIdOfString(transformed_str), generation_);
+          if (transformed_id == StringDictionary::INVALID_STR_ID) {
+            misses.emplace_back(string_id, std::move(transformed_str));
+          }
+        }
+      });
+  for (const auto& misses : worker_misses) {
+    for (const auto& [string_id, transformed_str] : misses) {
+      (*ids)[string_id - min_id] = getOrAddTransient(transformed_str);
+    }
+  }
+  for (const auto& [string_id, str] : transients) {
+    (*ids)[string_id - min_id] = getOrAddTransient(transform(str));
+  }
+  translation.ids = {ids, min_id};
+  return translation;
+}
+
+const StringDictionaryProxy::TranslationMap& StringDictionaryProxy::getStringValueMap(
+    const std::string& func_name,
+    const StringToInt& func) {
+  std::lock_guard<std::mutex> maps_lock(string_op_maps_mutex_);
+  const auto it = string_value_maps_.find(func_name);
+  if (it != string_value_maps_.end()) {
+    return it->second;
+  }
+  CHECK_GE(generation_, 0);
+  const size_t entry_count = generation_;
+  std::map<int32_t, std::string> transients;
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    transients = transient_int_to_str_;
+  }
+  const int32_t min_id = transients.empty() ? 0 : transients.begin()->first;
+  auto values = std::make_shared<std::vector<int32_t>>(entry_count - min_id);
+  for_each_id_range(
+      entry_count,
+      string_op_worker_count(entry_count),
+      [this, &values, &func, min_id](const size_t, const size_t begin, const size_t end) {
+        for (size_t string_id = begin; string_id < end; ++string_id) {
+          (*values)[string_id - min_id] = func(string_dict_->getString(string_id));
+        }
+      });
+  for (const auto& [string_id, str] : transients) {
+    (*values)[string_id - min_id] = func(str);
+  }
+  const auto it_ok =
+      string_value_maps_.emplace(func_name, TranslationMap{values, min_id});
+  CHECK(it_ok.second);
+  return it_ok.first->second;
+}
+
 namespace {
 
 bool is_like(const std::string& str,
@@ -217,6 +386,17 @@ std::pair<const char*, size_t> StringDictionaryProxy::getStringBytes(
   return std::make_pair(it->second.c_str(), it->second.size());
 }
 
+size_t StringDictionaryProxy::getStringLength(int32_t string_id) const {
+  if (string_id >= 0) {
+    return string_dict_->getStringBytes(string_id).second;
+  }
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  CHECK_NE(StringDictionary::INVALID_STR_ID, string_id);
+  auto it = transient_int_to_str_.find(string_id);
+  CHECK(it != transient_int_to_str_.end());
+  return it->second.size();
+}
+
 size_t StringDictionaryProxy::storageEntryCount() const {
   return string_dict_.get()->storageEntryCount();
 }
@@ -20,7 +20,10 @@
 #include "../Shared/mapd_shared_mutex.h"
 #include "StringDictionary.h"
 
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -28,6 +31,33 @@
 // used to access a StringDictionary when transient strings are involved
 class StringDictionaryProxy {
  public:
+  // Dense map from the ids of a proxy, transient ones included, to the ids of the same
+  // strings in another proxy; ids[id - min_id] is the translated id, or INVALID_STR_ID.
+  struct TranslationMap {
+    std::shared_ptr<const std::vector<int32_t>> ids;
+    int32_t min_id{0};
+
+    const int32_t* data() const { return ids ? ids->data() : nullptr; }
+
+    int32_t translate(const int32_t id) const {
+      const int64_t idx = static_cast<int64_t>(id) - min_id;
+      return ids && idx >= 0 && idx < static_cast<int64_t>(ids->size())
+                 ? (*ids)[idx]
+                 : StringDictionary::INVALID_STR_ID;
+    }
+  };
+
+  using StringTransform = std::function<std::string(const std::string&)>;
+  using StringToInt = std::function<int32_t(const std::string&)>;
+
+  // Ids of the strings a transform returns for the ids of a proxy. Ids the map doesn't
+  // cover, transient strings added after it was built or every id when no map was built,
+  // are transformed one at a time.
+  struct StringOpTranslation {
+    TranslationMap ids;
+    StringTransform transform;
+  };
+
   StringDictionaryProxy(std::shared_ptr<StringDictionary> sd, const ssize_t generation);
 
   int32_t getOrAdd(const std::string& str) noexcept;
@@ -39,6 +69,8 @@ class StringDictionaryProxy {
       const std::string& str) const;  // disregard generation, only used by QueryRenderer
   std::string getString(int32_t string_id) const;
   std::pair<const char*, size_t> getStringBytes(int32_t string_id) const noexcept;
+  // Same as getStringBytes(string_id).second, safe while transients are being added.
+  size_t getStringLength(int32_t string_id) const;
   size_t storageEntryCount() const;
   void updateGeneration(const ssize_t generation) noexcept;
 
@@ -52,6 +84,22 @@ class StringDictionaryProxy {
 
   std::vector<int32_t> getRegexpLike(const std::string& pattern, const char escape) const;
 
+  // Translates every id of this proxy to dest_proxy at once; the translation between the
+  // underlying dictionaries is cached by the source dictionary.
+  TranslationMap buildTranslationMap(const StringDictionaryProxy* dest_proxy) const;
+
+  // Applies transform to every string of this proxy in parallel, once per proxy and
+  // transform name; results missing from the dictionary are added as transient strings.
+  // Without build_map only the transform is kept, the map stays empty.
+  const StringOpTranslation& getStringOpTranslation(const std::string& transform_name,
+                                                    const StringTransform& transform,
+                                                    const bool build_map = true);
+
+  // Same for functions of a string to an integer, e.g. its length; the map holds the
+  // values instead of ids.
+  const TranslationMap& getStringValueMap(const std::string& func_name,
+                                          const StringToInt& func);
+
   const std::map<int32_t, std::string> getTransientMapping() const {
     return transient_int_to_str_;
   }
@@ -62,5 +110,8 @@ class StringDictionaryProxy {
   std::map<std::string, int32_t> transient_str_to_int_;
   ssize_t generation_;
   mutable mapd_shared_mutex rw_mutex_;
+  std::map<std::string, StringOpTranslation> string_op_translations_;
+  std::map<std::string, TranslationMap> string_value_maps_;
+  std::mutex string_op_maps_mutex_;
 };
 #endif  // STRINGDICTIONARY_STRINGDICTIONARYPROXY_H
@@ -0,0 +1,571 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TableArchiver/TableArchive.h"
+
+#include <zlib.h>
+#include <algorithm>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <stdexcept>
+
+#include "Shared/Logger.h"
+#include "Shared/thread_count.h"
+
+namespace {
+
+constexpr char kTableArchiveMagic[8] = {'O', 'M', 'N', 'I', 'T', 'B', 'L', 'A'};
+constexpr uint32_t kTableArchiveVersion{1};
+constexpr size_t kTableArchiveHeaderSize{sizeof(kTableArchiveMagic) + sizeof(uint32_t)};
+constexpr size_t kTableArchiveFooterSize{sizeof(uint64_t) + sizeof(kTableArchiveMagic)};
+constexpr size_t kTableArchiveBlockSize{4 * 1024 * 1024};
+constexpr size_t kTableArchiveMaxPathSize{4096};
+
+struct FileCloser {
+  void operator()(std::FILE* f) const { std::fclose(f); }
+};
+
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+void write_bytes(std::FILE* file,
+                 const void* data,
+                 const size_t size,
+                 const std::string& path) {
+  if (size && std::fwrite(data, 1, size, file) != size) {
+    throw std::runtime_error("Failed to write " + path + ": " + std::strerror(errno));
+  }
+}
+
+template <typename T>
+void write_value(std::FILE* file, const T value, const std::string& path) {
+  write_bytes(file, &value, sizeof(T), path);
+}
+
+void read_bytes(std::FILE* file, void* data, const size_t size, const std::string& path) {
+  if (size && std::fread(data, 1, size, file) != size) {
+    throw std::runtime_error("Failed to read archive " + path + ": " +
+                             (std::feof(file) ? "unexpected end of file"
+                                              : std::strerror(errno)));
+  }
+}
+
+template <typename T>
+T read_value(std::FILE* file, const std::string& path) {
+  T value;
+  read_bytes(file, &value, sizeof(T), path);
+  return value;
+}
+
+void seek(std::FILE* file, const uint64_t offset, const std::string& path) {
+  if (std::fseek(file, static_cast<long>(offset), SEEK_SET)) {
+    throw std::runtime_error("Failed to seek in archive " + path + ": " +
+                             std::strerror(errno));
+  }
+}
+
+// Archived paths are extracted relative to a destination directory and therefore must
+// not point outside of it.
+void check_entry_path(const std::string& entry_path, const std::string& archive_path) {
+  const boost::filesystem::path path(entry_path);
+  bool is_valid = !entry_path.empty() && path.is_relative();
+  for (const auto& component : path) {
+    is_valid = is_valid && component != "..";
+  }
+  if (!is_valid) {
+    throw std::runtime_error("Invalid path " + entry_path + " in archive " +
+                             archive_path);
+  }
+}
+
+FilePtr create_file(const std::string& path) {
+  boost::filesystem::create_directories(boost::filesystem::path(path).parent_path());
+  FilePtr file(std::fopen(path.c_str(), "wb"));
+  if (!file) {
+    throw std::runtime_error("Failed to create " + path + ": " + std::strerror(errno));
+  }
+  return file;
+}
+
+void compress_block(const std::vector<char>& data,
+                    std::vector<char>& stored_data,
+                    bool& compressed) {
+  uLongf stored_size = compressBound(data.size());
+  stored_data.resize(stored_size);
+  const auto status = compress2(reinterpret_cast<Bytef*>(stored_data.data()),
+                                &stored_size,
+                                reinterpret_cast<const Bytef*>(data.data()),
+                                data.size(),
+                                Z_BEST_SPEED);
+  if (status != Z_OK) {
+    throw std::runtime_error("Failed to compress archive block: " +
+                             std::string(zError(status)));
+  }
+  // blocks which don't compress are stored as is
+  compressed = stored_size < data.size();
+  stored_data.resize(compressed ? stored_size : 0);
+}
+
+void decompress_block(const TableArchiveBlock& block,
+                      std::vector<char>& stored_data,
+                      std::vector<char>& data,
+                      const std::string& archive_path) {
+  if (!block.compressed) {
+    data = std::move(stored_data);
+    return;
+  }
+  uLongf size = block.size;
+  data.resize(size);
+  const auto status = uncompress(reinterpret_cast<Bytef*>(data.data()),
+                                 &size,
+                                 reinterpret_cast<const Bytef*>(stored_data.data()),
+                                 stored_data.size());
+  if (status != Z_OK || size != block.size) {
+    throw std::runtime_error("Corrupted block at offset " + std::to_string(block.offset) +
+                             " in archive " + archive_path);
+  }
+  stored_data.clear();
+}
+
+}  // namespace
+
+// Logs the progress and the throughput of writing or extracting an archive in steps of
+// ten percent.
+class TableArchiveProgress {
+ public:
+  TableArchiveProgress(const std::string& operation,
+                       const std::string& archive_path,
+                       const uint64_t total_bytes)
+      : operation_(operation)
+      , archive_path_(archive_path)
+      , total_bytes_(total_bytes)
+      , processed_bytes_(0)
+      , next_report_percent_(kReportPercentStep)
+      , start_time_(std::chrono::steady_clock::now()) {}
+
+  void update(const uint64_t bytes) {
+    processed_bytes_ += bytes;
+    if (!total_bytes_) {
+      return;
+    }
+    const auto percent = std::min<uint64_t>(100, processed_bytes_ * 100 / total_bytes_);
+    if (percent >= next_report_percent_ && percent < 100) {
+      LOG(INFO) << operation_ << " " << archive_path_ << ": " << percent << "% ("
+                << processed_bytes_ << " of " << total_bytes_ << " bytes, "
+                << getThroughput() << " MB/s)";
+      next_report_percent_ = percent - percent % kReportPercentStep + kReportPercentStep;
+    }
+  }
+
+  void finish() const {
+    LOG(INFO) << operation_ << " " << archive_path_ << " completed: " << processed_bytes_
+              << " bytes in " << getElapsedSeconds() << " s (" << getThroughput()
+              << " MB/s)";
+  }
+
+ private:
+  double getElapsedSeconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_)
+        .count();
+  }
+
+  double getThroughput() const {
+    const auto elapsed_seconds = getElapsedSeconds();
+    return elapsed_seconds > 0 ? processed_bytes_ / (1024. * 1024.) / elapsed_seconds
+                               : 0;
+  }
+
+  static constexpr uint64_t kReportPercentStep{10};
+
+  const std::string operation_;
+  const std::string archive_path_;
+  const uint64_t total_bytes_;
+  uint64_t processed_bytes_;
+  uint64_t next_report_percent_;
+  const std::chrono::steady_clock::time_point start_time_;
+};
+
+TableArchiveWriter::TableArchiveWriter(const std::string& archive_path,
+                                       const bool compress)
+    : archive_path_(archive_path), compress_(compress), offset_(0), total_bytes_(0) {}
+
+void TableArchiveWriter::addFile(const std::string& entry_path,
+                                 const std::string& content) {
+  entries_.push_back({entry_path, false, content.size(), {}});
+  entry_sources_.emplace_back("", content);
+  total_bytes_ += content.size();
+}
+
+void TableArchiveWriter::addPath(const std::string& base_path,
+                                 const std::string& entry_path) {
+  const auto path = boost::filesystem::path(base_path) / entry_path;
+  if (boost::filesystem::is_directory(path)) {
+    entries_.push_back({entry_path, true, 0, {}});
+    entry_sources_.emplace_back(path.string(), "");
+    // archive directory trees in a deterministic order
+    std::vector<std::string> file_names;
+    boost::filesystem::directory_iterator end_it;
+    for (boost::filesystem::directory_iterator fit(path); fit != end_it; ++fit) {
+      file_names.push_back(fit->path().filename().string());
+    }
+    std::sort(file_names.begin(), file_names.end());
+    for (const auto& file_name : file_names) {
+      addPath(base_path, entry_path + "/" + file_name);
+    }
+  } else if (boost::filesystem::is_regular_file(path)) {
+    const auto size = boost::filesystem::file_size(path);
+    entries_.push_back({entry_path, false, size, {}});
+    entry_sources_.emplace_back(path.string(), "");
+    total_bytes_ += size;
+  } else {
+    throw std::runtime_error("Failed to archive " + path.string() +
+                             ": not a regular file or directory.");
+  }
+}
+
+void TableArchiveWriter::write() {
+  TableArchiveProgress progress("Dumping table to archive", archive_path_, total_bytes_);
+  try {
+    FilePtr archive(std::fopen(archive_path_.c_str(), "wb"));
+    if (!archive) {
+      throw std::runtime_error("Failed to create archive " + archive_path_ + ": " +
+                               std::strerror(errno));
+    }
+    write_bytes(
+        archive.get(), kTableArchiveMagic, sizeof(kTableArchiveMagic), archive_path_);
+    write_value(archive.get(), kTableArchiveVersion, archive_path_);
+    offset_ = kTableArchiveHeaderSize;
+    for (size_t entry_index = 0; entry_index < entries_.size(); ++entry_index) {
+      writeEntry(archive.get(), entry_index, progress);
+    }
+    flushBlocks(archive.get(), progress);
+    writeIndex(archive.get());
+    if (std::fflush(archive.get())) {
+      throw std::runtime_error("Failed to write " + archive_path_ + ": " +
+                               std::strerror(errno));
+    }
+  } catch (...) {
+    pending_blocks_.clear();
+    boost::system::error_code ec;
+    boost::filesystem::remove(archive_path_, ec);
+    throw;
+  }
+  progress.finish();
+}
+
+void TableArchiveWriter::writeEntry(std::FILE* archive,
+                                    const size_t entry_index,
+                                    TableArchiveProgress& progress) {
+  auto& entry = entries_[entry_index];
+  const auto& [source_path, content] = entry_sources_[entry_index];
+  if (entry.is_directory) {
+    return;
+  }
+  // keep at most one block per thread in memory
+  const size_t max_pending_blocks = std::max(cpu_threads(), 1);
+  auto queue_block = [&](std::vector<char>&& data) {
+    pending_blocks_.push_back({entry_index, std::move(data), {}, false});
+    if (pending_blocks_.size() >= max_pending_blocks) {
+      flushBlocks(archive, progress);
+    }
+  };
+  if (source_path.empty()) {
+    for (size_t pos = 0; pos < content.size(); pos += kTableArchiveBlockSize) {
+      const auto end = std::min(content.size(), pos + kTableArchiveBlockSize);
+      queue_block(std::vector<char>(content.begin() + pos, content.begin() + end));
+    }
+    return;
+  }
+  FilePtr file(std::fopen(source_path.c_str(), "rb"));
+  if (!file) {
+    throw std::runtime_error("Failed to open " + source_path + ": " +
+                             std::strerror(errno));
+  }
+  // read up to the end of file, which may have grown under concurrent inserts
+  entry.size = 0;
+  while (true) {
+    std::vector<char> data(kTableArchiveBlockSize);
+    const auto read_size = std::fread(data.data(), 1, data.size(), file.get());
+    if (read_size < data.size() && std::ferror(file.get())) {
+      throw std::runtime_error("Failed to read " + source_path + ": " +
+                               std::strerror(errno));
+    }
+    if (!read_size) {
+      break;
+    }
+    data.resize(read_size);
+    entry.size += read_size;
+    queue_block(std::move(data));
+  }
+}
+
+void TableArchiveWriter::flushBlocks(std::FILE* archive, TableArchiveProgress& progress) {
+  if (compress_) {
+    std::vector<std::future<void>> compression_threads;
+    for (auto& pending_block : pending_blocks_) {
+      compression_threads.push_back(std::async(std::launch::async, [&pending_block] {
+        compress_block(pending_block.data,
+                       pending_block.stored_data,
+                       pending_block.compressed);
+      }));
+    }
+    for (auto& compression_thread : compression_threads) {
+      compression_thread.wait();
+    }
+    for (auto& compression_thread : compression_threads) {
+      compression_thread.get();
+    }
+  }
+  for (const auto& pending_block : pending_blocks_) {
+    const auto& stored_data =
+        pending_block.compressed ? pending_block.stored_data : pending_block.data;
+    write_bytes(archive, stored_data.data(), stored_data.size(), archive_path_);
+    entries_[pending_block.entry_index].blocks.push_back({offset_,
+                                                          stored_data.size(),
+                                                          pending_block.data.size(),
+                                                          pending_block.compressed});
+    offset_ += stored_data.size();
+    progress.update(pending_block.data.size());
+  }
+  pending_blocks_.clear();
+}
+
+void TableArchiveWriter::writeIndex(std::FILE* archive) {
+  const uint64_t index_offset = offset_;
+  write_value<uint64_t>(archive, entries_.size(), archive_path_);
+  for (const auto& entry : entries_) {
+    write_value<uint32_t>(archive, entry.path.size(), archive_path_);
+    write_bytes(archive, entry.path.data(), entry.path.size(), archive_path_);
+    write_value<uint8_t>(archive, entry.is_directory, archive_path_);
+    write_value<uint64_t>(archive, entry.size, archive_path_);
+    write_value<uint64_t>(archive, entry.blocks.size(), archive_path_);
+    for (const auto& block : entry.blocks) {
+      write_value<uint64_t>(archive, block.offset, archive_path_);
+      write_value<uint64_t>(archive, block.stored_size, archive_path_);
+      write_value<uint64_t>(archive, block.size, archive_path_);
+      write_value<uint8_t>(archive, block.compressed, archive_path_);
+    }
+  }
+  write_value<uint64_t>(archive, index_offset, archive_path_);
+  write_bytes(archive, kTableArchiveMagic, sizeof(kTableArchiveMagic), archive_path_);
+}
+
+TableArchiveReader::TableArchiveReader(const std::string& archive_path)
+    : archive_path_(archive_path), archive_(std::fopen(archive_path.c_str(), "rb")) {
+  if (!archive_) {
+    throw std::runtime_error("Failed to open archive " + archive_path_ + ": " +
+                             std::strerror(errno));
+  }
+  try {
+    readIndex();
+  } catch (...) {
+    std::fclose(archive_);
+    throw;
+  }
+}
+
+TableArchiveReader::~TableArchiveReader() {
+  std::fclose(archive_);
+}
+
+bool TableArchiveReader::isTableArchive(const std::string& archive_path) {
+  FilePtr archive(std::fopen(archive_path.c_str(), "rb"));
+  char magic[sizeof(kTableArchiveMagic)];
+  return archive && std::fread(magic, 1, sizeof(magic), archive.get()) == sizeof(magic) &&
+         !std::memcmp(magic, kTableArchiveMagic, sizeof(magic));
+}
+
+void TableArchiveReader::readIndex() {
+  const auto invalid_archive = [this](const std::string& reason) {
+    return std::runtime_error("Invalid archive " + archive_path_ + ": " + reason);
+  };
+  if (std::fseek(archive_, 0, SEEK_END)) {
+    throw std::runtime_error("Failed to seek in archive " + archive_path_ + ": " +
+                             std::strerror(errno));
+  }
+  const auto file_size = static_cast<uint64_t>(std::ftell(archive_));
+  if (file_size < kTableArchiveHeaderSize + kTableArchiveFooterSize) {
+    throw invalid_archive("file is too small");
+  }
+  char magic[sizeof(kTableArchiveMagic)];
+  seek(archive_, 0, archive_path_);
+  read_bytes(archive_, magic, sizeof(magic), archive_path_);
+  if (std::memcmp(magic, kTableArchiveMagic, sizeof(magic))) {
+    throw invalid_archive("bad header");
+  }
+  const auto version = read_value<uint32_t>(archive_, archive_path_);
+  if (version > kTableArchiveVersion) {
+    throw invalid_archive("unsupported version " + std::to_string(version));
+  }
+  const auto index_end = file_size - kTableArchiveFooterSize;
+  seek(archive_, index_end, archive_path_);
+  const auto index_offset = read_value<uint64_t>(archive_, archive_path_);
+  read_bytes(archive_, magic, sizeof(magic), archive_path_);
+  if (std::memcmp(magic, kTableArchiveMagic, sizeof(magic)) ||
+      index_offset < kTableArchiveHeaderSize || index_offset > index_end) {
+    throw invalid_archive("bad footer");
+  }
+  seek(archive_, index_offset, archive_path_);
+  const auto entry_count = read_value<uint64_t>(archive_, archive_path_);
+  for (uint64_t i = 0; i < entry_count; ++i) {
+    TableArchiveEntry entry;
+    const auto path_size = read_value<uint32_t>(archive_, archive_path_);
+    if (path_size > kTableArchiveMaxPathSize) {
+      throw invalid_archive("bad index");
+    }
+    entry.path.resize(path_size);
+    read_bytes(archive_, entry.path.data(), path_size, archive_path_);
+    check_entry_path(entry.path, archive_path_);
+    entry.is_directory = read_value<uint8_t>(archive_, archive_path_);
+    entry.size = read_value<uint64_t>(archive_, archive_path_);
+    const auto block_count = read_value<uint64_t>(archive_, archive_path_);
+    uint64_t size{0};
+    for (uint64_t j = 0; j < block_count; ++j) {
+      TableArchiveBlock block;
+      block.offset = read_value<uint64_t>(archive_, archive_path_);
+      block.stored_size = read_value<uint64_t>(archive_, archive_path_);
+      block.size = read_value<uint64_t>(archive_, archive_path_);
+      block.compressed = read_value<uint8_t>(archive_, archive_path_);
+      if (block.offset < kTableArchiveHeaderSize ||
+          block.offset + block.stored_size > index_offset ||
+          (!block.compressed && block.stored_size != block.size)) {
+        throw invalid_archive("bad index");
+      }
+      size += block.size;
+      entry.blocks.push_back(block);
+    }
+    if (size != entry.size) {
+      throw invalid_archive("bad index");
+    }
+    entries_.push_back(std::move(entry));
+  }
+}
+
+void TableArchiveReader::readBlock(PendingBlock& pending_block) const {
+  seek(archive_, pending_block.block.offset, archive_path_);
+  pending_block.stored_data.resize(pending_block.block.stored_size);
+  read_bytes(archive_,
+             pending_block.stored_data.data(),
+             pending_block.stored_data.size(),
+             archive_path_);
+}
+
+std::string TableArchiveReader::readFile(const std::string& entry_path) const {
+  const auto it = std::find_if(entries_.begin(), entries_.end(), [&](const auto& entry) {
+    return !entry.is_directory && entry.path == entry_path;
+  });
+  if (it == entries_.end()) {
+    throw std::runtime_error("File " + entry_path + " not found in archive " +
+                             archive_path_);
+  }
+  std::string content;
+  content.reserve(it->size);
+  for (const auto& block : it->blocks) {
+    PendingBlock pending_block{0, block, {}, {}};
+    readBlock(pending_block);
+    decompress_block(
+        block, pending_block.stored_data, pending_block.data, archive_path_);
+    content.append(pending_block.data.begin(), pending_block.data.end());
+  }
+  return content;
+}
+
+void TableArchiveReader::extract(
+    const std::vector<std::pair<std::string, std::string>>& dir_paths) const {
+  // resolve destinations of the archived files to extract
+  std::vector<std::pair<const TableArchiveEntry*, std::string>> files;
+  uint64_t total_bytes{0};
+  for (const auto& entry : entries_) {
+    for (const auto& [src_dir, dst_dir] : dir_paths) {
+      if (entry.path == src_dir || boost::starts_with(entry.path, src_dir + "/")) {
+        const auto dst_path = dst_dir + entry.path.substr(src_dir.size());
+        if (entry.is_directory) {
+          boost::filesystem::create_directories(dst_path);
+        } else {
+          files.emplace_back(&entry, dst_path);
+          total_bytes += entry.size;
+        }
+        break;
+      }
+    }
+  }
+  TableArchiveProgress progress(
+      "Restoring table from archive", archive_path_, total_bytes);
+  // read blocks in archive order, decompress them in parallel and append them to the
+  // files they belong to
+  const size_t max_pending_blocks = std::max(cpu_threads(), 1);
+  std::vector<PendingBlock> pending_blocks;
+  FilePtr file;
+  size_t file_index = files.size();
+  auto close_file = [&] {
+    if (file && std::fflush(file.get())) {
+      throw std::runtime_error("Failed to write " + files[file_index].second + ": " +
+                               std::strerror(errno));
+    }
+    file.reset();
+  };
+  auto flush_blocks = [&] {
+    std::vector<std::future<void>> decompression_threads;
+    for (auto& pending_block : pending_blocks) {
+      decompression_threads.push_back(std::async(std::launch::async, [&] {
+        decompress_block(pending_block.block,
+                         pending_block.stored_data,
+                         pending_block.data,
+                         archive_path_);
+      }));
+    }
+    for (auto& decompression_thread : decompression_threads) {
+      decompression_thread.wait();
+    }
+    for (auto& decompression_thread : decompression_threads) {
+      decompression_thread.get();
+    }
+    for (const auto& pending_block : pending_blocks) {
+      if (pending_block.file_index != file_index) {
+        close_file();
+        file = create_file(files[pending_block.file_index].second);
+        file_index = pending_block.file_index;
+      }
+      write_bytes(file.get(),
+                  pending_block.data.data(),
+                  pending_block.data.size(),
+                  files[file_index].second);
+      progress.update(pending_block.data.size());
+    }
+    pending_blocks.clear();
+  };
+  for (size_t i = 0; i < files.size(); ++i) {
+    const auto entry = files[i].first;
+    if (entry->blocks.empty()) {
+      create_file(files[i].second);
+      continue;
+    }
+    for (const auto& block : entry->blocks) {
+      pending_blocks.push_back({i, block, {}, {}});
+      readBlock(pending_blocks.back());
+      if (pending_blocks.size() >= max_pending_blocks) {
+        flush_blocks();
+      }
+    }
+  }
+  flush_blocks();
+  close_file();
+  progress.finish();
+}
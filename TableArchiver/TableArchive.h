@@ -0,0 +1,126 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    TableArchive.h
+ * @brief   Native archive format of DUMP TABLE and RESTORE TABLE.
+ *
+ * An archive consists of a header, the contents of the archived files split into
+ * independently (zlib) compressed blocks, an index of the archived files and their
+ * blocks, and a footer pointing to the index:
+ *
+ *   magic | version | blocks ... | index | index offset | magic
+ *
+ * Blocks are compressed and decompressed in parallel, and single files (e.g. the table
+ * schema) are read by seeking to their blocks instead of scanning the whole archive.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+class TableArchiveProgress;
+
+struct TableArchiveBlock {
+  uint64_t offset;       // offset of the stored block in the archive
+  uint64_t stored_size;  // size of the stored, possibly compressed, block
+  uint64_t size;         // size of the uncompressed block
+  bool compressed;
+};
+
+struct TableArchiveEntry {
+  std::string path;  // relative path of the file or directory in the archive
+  bool is_directory;
+  uint64_t size;
+  std::vector<TableArchiveBlock> blocks;
+};
+
+class TableArchiveWriter {
+ public:
+  TableArchiveWriter(const std::string& archive_path, const bool compress);
+
+  // Adds a file with the given content.
+  void addFile(const std::string& entry_path, const std::string& content);
+
+  // Adds the file or the directory tree at base_path/entry_path as entry_path.
+  void addPath(const std::string& base_path, const std::string& entry_path);
+
+  // Writes the archive. Removes the partially written archive on failure.
+  void write();
+
+ private:
+  struct PendingBlock {
+    size_t entry_index;
+    std::vector<char> data;
+    std::vector<char> stored_data;
+    bool compressed;
+  };
+
+  void writeEntry(std::FILE* archive,
+                  const size_t entry_index,
+                  TableArchiveProgress& progress);
+  void flushBlocks(std::FILE* archive, TableArchiveProgress& progress);
+  void writeIndex(std::FILE* archive);
+
+  const std::string archive_path_;
+  const bool compress_;
+  std::vector<TableArchiveEntry> entries_;
+  // absolute path of a file to archive, or the content of an added file
+  std::vector<std::pair<std::string, std::string>> entry_sources_;
+  std::vector<PendingBlock> pending_blocks_;
+  uint64_t offset_;
+  uint64_t total_bytes_;
+};
+
+class TableArchiveReader {
+ public:
+  explicit TableArchiveReader(const std::string& archive_path);
+
+  TableArchiveReader(const TableArchiveReader&) = delete;
+
+  ~TableArchiveReader();
+
+  // Checks whether the file at archive_path is an archive of the native format.
+  static bool isTableArchive(const std::string& archive_path);
+
+  const std::vector<TableArchiveEntry>& getEntries() const { return entries_; }
+
+  // Returns the content of a file in the archive.
+  std::string readFile(const std::string& entry_path) const;
+
+  // Extracts every archived directory tree in dir_paths (pairs of an archived directory
+  // and its destination directory) straight into its destination directory.
+  void extract(const std::vector<std::pair<std::string, std::string>>& dir_paths) const;
+
+ private:
+  struct PendingBlock {
+    size_t file_index;
+    TableArchiveBlock block;
+    std::vector<char> stored_data;
+    std::vector<char> data;
+  };
+
+  void readBlock(PendingBlock& pending_block) const;
+  void readIndex();
+
+  const std::string archive_path_;
+  std::FILE* archive_;
+  std::vector<TableArchiveEntry> entries_;
+};
@@ -24,6 +24,7 @@
 #include <cstdio>
 #include <cstring>
 #include <exception>
+#include <fstream>
 #include <list>
 #include <memory>
 #include <regex>
@@ -40,6 +41,7 @@
 #include "Shared/ThreadController.h"
 #include "Shared/measure.h"
 #include "Shared/thread_count.h"
+#include "TableArchiver/TableArchive.h"
 
 extern bool g_cluster;
 bool g_test_rollback_dump_restore{false};
@@ -121,6 +123,31 @@ inline std::string run(const std::string& cmd, const std::string& chdir = "") {
   return output;
 }
 
+// Archives in the native format are written for the in-process compression options;
+// other options are those of tar for an external compression program.
+inline bool is_native_compression(const std::string& compression) {
+  return compression == "zlib" || compression == "none";
+}
+
+// Returns the tar option to decompress a tar archive, detecting the compression program
+// from the archive if it was not given by the statement.
+std::string get_tar_decompression(const std::string& archive_path,
+                                  const std::string& compression) {
+  if (!compression.empty() && !is_native_compression(compression)) {
+    return compression;
+  }
+  unsigned char magic[4] = {0};
+  std::ifstream archive(archive_path, std::ios::binary);
+  archive.read(reinterpret_cast<char*>(magic), sizeof(magic));
+  if (magic[0] == 0x1f && magic[1] == 0x8b) {
+    return "--use-compress-program=gunzip";
+  }
+  if (magic[0] == 0x04 && magic[1] == 0x22 && magic[2] == 0x4d && magic[3] == 0x18) {
+    return "--use-compress-program=unlz4";
+  }
+  return "";
+}
+
 inline std::string simple_file_cat(const std::string& archive_path,
                                    const std::string& file_name,
                                    const std::string& compression) {
@@ -136,16 +163,28 @@ inline std::string simple_file_cat(const std::string& archive_path,
   run("tar " + compression + " -xvf " + get_quoted_string(archive_path) + " " +
           opt_occurrence + " " + file_name,
       temp_dir.string());
-  const auto output = run("cat " + (temp_dir / file_name).string());
+  std::ifstream file((temp_dir / file_name).string());
+  const std::string output{std::istreambuf_iterator<char>(file),
+                           std::istreambuf_iterator<char>()};
   boost::filesystem::remove_all(temp_dir);
   return output;
 }
 
+inline std::string read_archive_file(const std::string& archive_path,
+                                     const std::string& file_name,
+                                     const std::string& compression) {
+  if (TableArchiveReader::isTableArchive(archive_path)) {
+    return TableArchiveReader(archive_path).readFile(file_name);
+  }
+  return simple_file_cat(
+      archive_path, file_name, get_tar_decompression(archive_path, compression));
+}
+
 inline std::string get_table_schema(const std::string& archive_path,
                                     const std::string& table,
                                     const std::string& compression) {
   const auto schema_str =
-      simple_file_cat(archive_path, table_schema_filename, compression);
+      read_archive_file(archive_path, table_schema_filename, compression);
   std::regex regex("@T");
   return std::regex_replace(schema_str, regex, table);
 }
@@ -235,6 +274,37 @@ void rename_table_directories(const File_Namespace::GlobalFileMgr* global_file_m
   }
 }
 
+// Extract data and dict dirs of a table from a native archive straight into the
+// respective dirs of the destination table.
+void extract_table_directories(
+    const std::string& archive_path,
+    const std::string& base_path,
+    const std::vector<std::string>& data_file_dirs,
+    const std::unordered_map<std::string, std::string>& dict_paths_map) {
+  TableArchiveReader archive_reader(archive_path);
+  // src data dirs are archived in the order of dst data dirs, ref. dumpTable
+  std::vector<std::pair<std::string, std::string>> dir_paths;
+  for (const auto& entry : archive_reader.getEntries()) {
+    if (entry.is_directory && entry.path.find('/') == std::string::npos &&
+        boost::istarts_with(entry.path, "table_")) {
+      if (dir_paths.size() == data_file_dirs.size()) {
+        throw std::runtime_error("Unmatched number of table data directories");
+      }
+      dir_paths.emplace_back(entry.path,
+                             base_path + "/" + data_file_dirs[dir_paths.size()]);
+    }
+  }
+  if (dir_paths.size() != data_file_dirs.size()) {
+    throw std::runtime_error("Unmatched number of table data directories");
+  }
+  for (const auto& dit : dict_paths_map) {
+    if (!dit.first.empty() && !dit.second.empty()) {
+      dir_paths.emplace_back(dit.first, base_path + "/" + dit.second);
+    }
+  }
+  archive_reader.extract(dir_paths);
+}
+
 }  // namespace
 
 void TableArchiver::dumpTable(const TableDescriptor* td,
@@ -250,8 +320,45 @@ void TableArchiver::dumpTable(const TableDescriptor* td,
   if (td->isView || td->persistenceLevel != Data_Namespace::MemoryLevel::DISK_LEVEL) {
     throw std::runtime_error("Dumping view or temporary table is not supported.");
   }
-  // collect paths of files to archive
+  // Prevent modification of the table schema during a dump operation, while allowing
+  // concurrent inserts.
+  auto table_read_lock =
+      lockmgr::TableSchemaLockMgr::getReadLockForTable(*cat_, td->tableName);
   const auto global_file_mgr = cat_->getDataMgr().getGlobalFileMgr();
+  // - gen schema file
+  const auto schema_str = cat_->dumpSchema(td);
+  // - gen column-old-info file
+  const auto cds = cat_->getAllColumnMetadataForTable(td->tableId, true, true, true);
+  std::vector<std::string> column_oldinfo;
+  std::transform(cds.begin(),
+                 cds.end(),
+                 std::back_inserter(column_oldinfo),
+                 [&](const auto cd) -> std::string {
+                   return cd->columnName + ":" + std::to_string(cd->columnId) + ":" +
+                          cat_->getColumnDictDirectory(cd);
+                 });
+  const auto column_oldinfo_str = boost::algorithm::join(column_oldinfo, " ");
+  // - gen table epoch
+  const auto epoch = cat_->getTableEpoch(cat_->getCurrentDB().dbId, td->tableId);
+  // - collect table data and dict file paths ...
+  const auto data_file_dirs = cat_->getTableDataDirectories(td);
+  const auto dict_file_dirs = cat_->getTableDictDirectories(td);
+  if (is_native_compression(compression)) {
+    // stream the files straight into the archive, compressing blocks in parallel
+    TableArchiveWriter archive_writer(archive_path, compression != "none");
+    archive_writer.addFile(table_schema_filename, schema_str);
+    archive_writer.addFile(table_oldinfo_filename, column_oldinfo_str);
+    archive_writer.addFile(table_epoch_filename, std::to_string(epoch));
+    for (const auto& dir : data_file_dirs) {
+      archive_writer.addPath(abs_path(global_file_mgr), dir);
+    }
+    for (const auto& dir : dict_file_dirs) {
+      archive_writer.addPath(abs_path(global_file_mgr), dir);
+    }
+    archive_writer.write();
+    return;
+  }
+  // collect paths of files to archive by tar
   std::vector<std::string> file_paths;
   auto file_writer = [&file_paths, global_file_mgr](const std::string& file_name,
                                                     const std::string& file_type,
@@ -269,45 +376,18 @@ void TableArchiver::dumpTable(const TableDescriptor* td,
     }
     file_paths.push_back(file_name);
   };
-  // Prevent modification of the table schema during a dump operation, while allowing
-  // concurrent inserts.
-  auto table_read_lock =
-      lockmgr::TableSchemaLockMgr::getReadLockForTable(*cat_, td->tableName);
-  const auto table_name = td->tableName;
-  {
-    // - gen schema file
-    const auto schema_str = cat_->dumpSchema(td);
-    file_writer(table_schema_filename, "table schema", schema_str);
-    // - gen column-old-info file
-    const auto cds = cat_->getAllColumnMetadataForTable(td->tableId, true, true, true);
-    std::vector<std::string> column_oldinfo;
-    std::transform(cds.begin(),
-                   cds.end(),
-                   std::back_inserter(column_oldinfo),
-                   [&](const auto cd) -> std::string {
-                     return cd->columnName + ":" + std::to_string(cd->columnId) + ":" +
-                            cat_->getColumnDictDirectory(cd);
-                   });
-    const auto column_oldinfo_str = boost::algorithm::join(column_oldinfo, " ");
-    file_writer(table_oldinfo_filename, "table old info", column_oldinfo_str);
-    // - gen table epoch
-    const auto epoch = cat_->getTableEpoch(cat_->getCurrentDB().dbId, td->tableId);
-    file_writer(table_epoch_filename, "table epoch", std::to_string(epoch));
-    // - collect table data file paths ...
-    const auto data_file_dirs = cat_->getTableDataDirectories(td);
-    file_paths.insert(file_paths.end(), data_file_dirs.begin(), data_file_dirs.end());
-    // - collect table dict file paths ...
-    const auto dict_file_dirs = cat_->getTableDictDirectories(td);
-    file_paths.insert(file_paths.end(), dict_file_dirs.begin(), dict_file_dirs.end());
-    // tar takes time. release cat lock to yield the cat to concurrent CREATE statements.
-  }
+  file_writer(table_schema_filename, "table schema", schema_str);
+  file_writer(table_oldinfo_filename, "table old info", column_oldinfo_str);
+  file_writer(table_epoch_filename, "table epoch", std::to_string(epoch));
+  file_paths.insert(file_paths.end(), data_file_dirs.begin(), data_file_dirs.end());
+  file_paths.insert(file_paths.end(), dict_file_dirs.begin(), dict_file_dirs.end());
   // run tar to archive the files ... this may take a while !!
   run("tar " + compression + " -cvf " + get_quoted_string(archive_path) + " " +
           boost::algorithm::join(file_paths, " "),
       abs_path(global_file_mgr));
 }
 
-// Restore data and dict files of a table from a tgz archive.
+// Restore data and dict files of a table from a native or tar archive.
 void TableArchiver::restoreTable(const Catalog_Namespace::SessionInfo& session,
                                  const TableDescriptor* td,
                                  const std::string& archive_path,
@@ -330,19 +410,23 @@ void TableArchiver::restoreTable(const Catalog_Namespace::SessionInfo& session,
   const auto insert_data_lock =
       lockmgr::InsertDataLockMgr::getWriteLockForTable(*cat_, td->tableName);
 
-  // untar takes time. no grab of cat lock to yield to concurrent CREATE stmts.
+  // extraction takes time. no grab of cat lock to yield to concurrent CREATE stmts.
   const auto global_file_mgr = cat_->getDataMgr().getGlobalFileMgr();
-  // dirs where src files are untarred and dst files are backed up
+  const bool is_native_archive = TableArchiveReader::isTableArchive(archive_path);
+  // dirs where src files of tar archives are untarred and dst files are backed up
   constexpr static const auto temp_data_basename = "_data";
   constexpr static const auto temp_back_basename = "_back";
   const auto temp_data_dir = abs_path(global_file_mgr) + "/" + temp_data_basename;
   const auto temp_back_dir = abs_path(global_file_mgr) + "/" + temp_back_basename;
   // clean up tmp dirs and files in any case
   auto tmp_files_cleaner = [&](void*) {
-    run("rm -rf " + temp_data_dir + " " + temp_back_dir);
-    run("rm -f " + abs_path(global_file_mgr) + "/" + table_schema_filename);
-    run("rm -f " + abs_path(global_file_mgr) + "/" + table_oldinfo_filename);
-    run("rm -f " + abs_path(global_file_mgr) + "/" + table_epoch_filename);
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(temp_data_dir, ec);
+    boost::filesystem::remove_all(temp_back_dir, ec);
+    for (const auto file_name :
+         {table_schema_filename, table_oldinfo_filename, table_epoch_filename}) {
+      boost::filesystem::remove(abs_path(global_file_mgr) + "/" + file_name, ec);
+    }
   };
   std::unique_ptr<decltype(tmp_files_cleaner), decltype(tmp_files_cleaner)> tfc(
       &tmp_files_cleaner, tmp_files_cleaner);
@@ -381,7 +465,7 @@ void TableArchiver::restoreTable(const Catalog_Namespace::SessionInfo& session,
   }
   // extract src table column ids (ALL columns incl. system/virtual/phy geo cols)
   const auto all_src_oldinfo_str =
-      simple_file_cat(archive_path, table_oldinfo_filename, compression);
+      read_archive_file(archive_path, table_oldinfo_filename, compression);
   std::vector<std::string> src_oldinfo_strs;
   boost::algorithm::split(src_oldinfo_strs,
                           all_src_oldinfo_str,
@@ -434,16 +518,22 @@ void TableArchiver::restoreTable(const Catalog_Namespace::SessionInfo& session,
     was_table_altered = was_table_altered || it.first != it.second;
   });
   VLOG(3) << "was_table_altered = " << was_table_altered;
-  // extract all data files to a temp dir. will swap with dst table dir after all set,
-  // otherwise will corrupt table in case any bad thing happens in the middle.
-  run("rm -rf " + temp_data_dir);
-  run("mkdir -p " + temp_data_dir);
-  run("tar " + compression + " -xvf " + get_quoted_string(archive_path), temp_data_dir);
-  // if table was ever altered after it was created, update column ids in chunk headers.
-  if (was_table_altered) {
-    const auto time_ms = measure<>::execution(
-        [&]() { adjust_altered_table_files(temp_data_dir, column_ids_map); });
-    VLOG(3) << "adjust_altered_table_files: " << time_ms << " ms";
+  if (!is_native_archive) {
+    // extract all data files of a tar archive to a temp dir. will swap with dst table
+    // dir after all set, otherwise will corrupt table in case any bad thing happens in
+    // the middle.
+    boost::filesystem::remove_all(temp_data_dir);
+    boost::filesystem::create_directories(temp_data_dir);
+    run("tar " + get_tar_decompression(archive_path, compression) + " -xvf " +
+            get_quoted_string(archive_path),
+        temp_data_dir);
+    // if table was ever altered after it was created, update column ids in chunk
+    // headers.
+    if (was_table_altered) {
+      const auto time_ms = measure<>::execution(
+          [&]() { adjust_altered_table_files(temp_data_dir, column_ids_map); });
+      VLOG(3) << "adjust_altered_table_files: " << time_ms << " ms";
+    }
   }
   // finally,,, swap table data/dict dirs!
   const auto data_file_dirs = cat_->getTableDataDirectories(td);
@@ -457,24 +547,39 @@ void TableArchiver::restoreTable(const Catalog_Namespace::SessionInfo& session,
              std::back_inserter(both_file_dirs));
   bool backup_completed = false;
   try {
-    run("rm -rf " + temp_back_dir);
-    run("mkdir -p " + temp_back_dir);
+    boost::filesystem::remove_all(temp_back_dir);
+    boost::filesystem::create_directories(temp_back_dir);
     for (const auto& dir : both_file_dirs) {
       const auto dir_full_path = abs_path(global_file_mgr) + "/" + dir;
       if (boost::filesystem::is_directory(dir_full_path)) {
-        run("mv " + dir_full_path + " " + temp_back_dir);
+        boost::filesystem::rename(dir_full_path, temp_back_dir + "/" + dir);
       }
     }
     backup_completed = true;
-    // accord src data dirs to dst
-    rename_table_directories(
-        cat_->getDataMgr().getGlobalFileMgr(), temp_data_dir, data_file_dirs, "table_");
-    // accord src dict dirs to dst
-    for (const auto& dit : dict_paths_map) {
-      if (!dit.first.empty() && !dit.second.empty()) {
-        const auto src_dict_path = temp_data_dir + "/" + dit.first;
-        const auto dst_dict_path = abs_path(global_file_mgr) + "/" + dit.second;
-        run("mv " + src_dict_path + " " + dst_dict_path);
+    if (is_native_archive) {
+      // extract src data and dict dirs straight into dst dirs, no temp copy needed
+      extract_table_directories(
+          archive_path, abs_path(global_file_mgr), data_file_dirs, dict_paths_map);
+      if (was_table_altered) {
+        const auto time_ms = measure<>::execution([&]() {
+          for (const auto& dir : data_file_dirs) {
+            adjust_altered_table_files(abs_path(global_file_mgr) + "/" + dir,
+                                       column_ids_map);
+          }
+        });
+        VLOG(3) << "adjust_altered_table_files: " << time_ms << " ms";
+      }
+    } else {
+      // accord src data dirs to dst
+      rename_table_directories(
+          cat_->getDataMgr().getGlobalFileMgr(), temp_data_dir, data_file_dirs, "table_");
+      // accord src dict dirs to dst
+      for (const auto& dit : dict_paths_map) {
+        if (!dit.first.empty() && !dit.second.empty()) {
+          const auto src_dict_path = temp_data_dir + "/" + dit.first;
+          const auto dst_dict_path = abs_path(global_file_mgr) + "/" + dit.second;
+          boost::filesystem::rename(src_dict_path, dst_dict_path);
+        }
       }
     }
     // throw if sanity test forces a rollback
@@ -485,25 +590,28 @@ void TableArchiver::restoreTable(const Catalog_Namespace::SessionInfo& session,
     // once backup is completed, whatever in abs_path(global_file_mgr) is the "src"
     // dirs that are to be rolled back and discarded
     if (backup_completed) {
-      run("rm -rf " + boost::algorithm::join(both_file_dirs, " "),
-          abs_path(global_file_mgr));
+      for (const auto& dir : both_file_dirs) {
+        boost::filesystem::remove_all(abs_path(global_file_mgr) + "/" + dir);
+      }
     }
     // complete rollback by recovering original "dst" table dirs from backup dir
     boost::filesystem::path base_path(temp_back_dir);
     boost::filesystem::directory_iterator end_it;
     for (boost::filesystem::directory_iterator fit(base_path); fit != end_it; ++fit) {
-      run("mv " + fit->path().string() + " .", abs_path(global_file_mgr));
+      boost::filesystem::rename(
+          fit->path(),
+          boost::filesystem::path(abs_path(global_file_mgr)) / fit->path().filename());
     }
     throw;
   }
   // set for reloading table from the restored/migrated files
-  const auto epoch = simple_file_cat(archive_path, table_epoch_filename, compression);
+  const auto epoch = read_archive_file(archive_path, table_epoch_filename, compression);
   cat_->setTableEpoch(
       cat_->getCurrentDB().dbId, td->tableId, boost::lexical_cast<int>(epoch));
 }
 
-// Migrate a table, which doesn't exist in current db, from a tar ball to the db.
-// This actually creates the table and restores data/dict files from the tar ball.
+// Migrate a table, which doesn't exist in current db, from an archive to the db.
+// This actually creates the table and restores data/dict files from the archive.
 void TableArchiver::restoreTable(const Catalog_Namespace::SessionInfo& session,
                                  const std::string& table_name,
                                  const std::string& archive_path,
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file BufferPoolWarmupTest.cpp
+ * @brief Test suite for the reloading of the buffer pool access history on startup
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "DataMgr/BufferMgr/BufferPoolWarmup.h"
+#include "DataMgr/DataMgr.h"
+#include "TestHelpers.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+namespace {
+
+constexpr size_t kPoolSize{64 * 1024 * 1024};
+constexpr size_t kChunkSize{1024 * 1024};
+constexpr int kNumChunks{4};
+
+ChunkKey get_chunk_key(const int fragment_id) {
+  return {1, 1, 1, fragment_id};
+}
+
+std::vector<int8_t> get_chunk_data(const int fragment_id) {
+  return std::vector<int8_t>(kChunkSize, static_cast<int8_t>(fragment_id + 1));
+}
+
+}  // namespace
+
+class BufferPoolWarmupTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    boost::filesystem::remove_all(data_path_);
+    boost::filesystem::create_directories(data_path_);
+  }
+
+  void TearDown() override { boost::filesystem::remove_all(data_path_); }
+
+  std::unique_ptr<Data_Namespace::DataMgr> createDataMgr(const double warmup_fraction) {
+    SystemParameters system_parameters;
+    system_parameters.cpu_buffer_mem_bytes = kPoolSize;
+    system_parameters.enable_buffer_pool_warmup = true;
+    system_parameters.buffer_pool_warmup_fraction = warmup_fraction;
+    return std::make_unique<Data_Namespace::DataMgr>(
+        data_path_.string(), system_parameters, false, 0);
+  }
+
+  // Writes the chunks, then requests the first one three times, the second one twice
+  // and the third one once.
+  void populate() {
+    auto data_mgr = createDataMgr(1);
+    for (int fragment_id = 0; fragment_id < kNumChunks; ++fragment_id) {
+      auto chunk_data = get_chunk_data(fragment_id);
+      auto buffer = data_mgr->createChunkBuffer(get_chunk_key(fragment_id),
+                                                MemoryLevel::DISK_LEVEL);
+      buffer->append(chunk_data.data(), chunk_data.size());
+    }
+    data_mgr->checkpoint(1, 1);
+    for (int fragment_id = 0; fragment_id < kNumChunks - 1; ++fragment_id) {
+      for (int i = 0; i < kNumChunks - 1 - fragment_id; ++i) {
+        data_mgr->getChunkBuffer(get_chunk_key(fragment_id), MemoryLevel::CPU_LEVEL)
+            ->unPin();
+      }
+    }
+  }
+
+  const boost::filesystem::path data_path_{
+      boost::filesystem::path(BASE_PATH) / "buffer_pool_warmup_test"};
+};
+
+TEST_F(BufferPoolWarmupTest, ReloadHottestChunks) {
+  populate();
+  const auto history = Buffer_Namespace::BufferPoolWarmup::readHistory(
+      (data_path_ / "buffer_pool_history").string());
+  ASSERT_EQ(history.size(), size_t(kNumChunks - 1));
+  for (int fragment_id = 0; fragment_id < kNumChunks - 1; ++fragment_id) {
+    EXPECT_EQ(history[fragment_id].first, get_chunk_key(fragment_id));
+    EXPECT_EQ(history[fragment_id].second.access_count,
+              size_t(kNumChunks - 1 - fragment_id));
+    EXPECT_EQ(history[fragment_id].second.num_bytes, kChunkSize);
+  }
+
+  // room for the two hottest chunks only
+  auto data_mgr = createDataMgr(2.5 * kChunkSize / kPoolSize);
+  data_mgr->waitForBufferPoolWarmup();
+  EXPECT_TRUE(data_mgr->isBufferOnDevice(get_chunk_key(0), MemoryLevel::CPU_LEVEL, 0));
+  EXPECT_TRUE(data_mgr->isBufferOnDevice(get_chunk_key(1), MemoryLevel::CPU_LEVEL, 0));
+  EXPECT_FALSE(data_mgr->isBufferOnDevice(get_chunk_key(2), MemoryLevel::CPU_LEVEL, 0));
+  EXPECT_FALSE(data_mgr->isBufferOnDevice(get_chunk_key(3), MemoryLevel::CPU_LEVEL, 0));
+  EXPECT_EQ(data_mgr->getNumBytesFetched(MemoryLevel::CPU_LEVEL), 2 * kChunkSize);
+
+  auto buffer = data_mgr->getChunkBuffer(get_chunk_key(1), MemoryLevel::CPU_LEVEL);
+  ASSERT_EQ(buffer->size(), kChunkSize);
+  const auto chunk_data = get_chunk_data(1);
+  EXPECT_EQ(std::memcmp(buffer->getMemoryPtr(), chunk_data.data(), kChunkSize), 0);
+  buffer->unPin();
+  EXPECT_EQ(data_mgr->getNumBytesFetched(MemoryLevel::CPU_LEVEL), 2 * kChunkSize);
+}
+
+TEST_F(BufferPoolWarmupTest, KeepHistoryOfChunksNotRequested) {
+  populate();
+  // nothing is reloaded, the history is saved again at shutdown
+  createDataMgr(0).reset();
+  const auto history = Buffer_Namespace::BufferPoolWarmup::readHistory(
+      (data_path_ / "buffer_pool_history").string());
+  ASSERT_EQ(history.size(), size_t(2));
+  EXPECT_EQ(history[0].first, get_chunk_key(0));
+  EXPECT_EQ(history[0].second.access_count, size_t(1));
+  EXPECT_EQ(history[1].first, get_chunk_key(1));
+  EXPECT_EQ(history[1].second.access_count, size_t(1));
+}
+
+TEST_F(BufferPoolWarmupTest, DropTableDuringWarmup) {
+  populate();
+  auto data_mgr = createDataMgr(1);
+  // races with the warm-up, which must neither keep nor record chunks of the table
+  data_mgr->deleteChunksWithPrefix({1, 1}, MemoryLevel::CPU_LEVEL);
+  data_mgr->removeTableRelatedDS(1, 1);
+  data_mgr->waitForBufferPoolWarmup();
+  for (int fragment_id = 0; fragment_id < kNumChunks; ++fragment_id) {
+    EXPECT_FALSE(data_mgr->isBufferOnDevice(
+        get_chunk_key(fragment_id), MemoryLevel::CPU_LEVEL, 0));
+  }
+  data_mgr.reset();
+  // looking up the chunks of a dropped table must not bring back its storage
+  EXPECT_FALSE(boost::filesystem::exists(data_path_ / "table_1_1"));
+  const auto history = Buffer_Namespace::BufferPoolWarmup::readHistory(
+      (data_path_ / "buffer_pool_history").string());
+  EXPECT_TRUE(history.empty());
+}
+
+TEST_F(BufferPoolWarmupTest, NoHistory) {
+  auto data_mgr = createDataMgr(1);
+  data_mgr->waitForBufferPoolWarmup();
+  EXPECT_EQ(data_mgr->getNumBytesFetched(MemoryLevel::CPU_LEVEL), size_t(0));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
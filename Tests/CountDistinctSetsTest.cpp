@@ -0,0 +1,155 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file CountDistinctSetsTest.cpp
+ * @brief Test suite for the sets used by exact COUNT(DISTINCT)
+ */
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "QueryEngine/CountDistinctSets.h"
+#include "QueryEngine/Descriptors/RowSetMemoryOwner.h"
+#include "TestHelpers.h"
+
+namespace {
+
+template <typename SET>
+std::set<int64_t> to_std_set(const SET& count_distinct_set) {
+  std::set<int64_t> values;
+  count_distinct_set.forEach([&values](const int64_t val) {
+    const auto it_ok = values.insert(val);
+    CHECK(it_ok.second);
+  });
+  return values;
+}
+
+// Values in a few clusters, some of them dense enough for bitmap containers, and a
+// few outliers across the whole range.
+std::vector<int64_t> generate_values(const size_t count, const uint32_t seed) {
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<int64_t> cluster_dist(0, 3);
+  std::uniform_int_distribution<int64_t> offset_dist(0, 20000);
+  std::uniform_int_distribution<int64_t> any_dist;
+  std::vector<int64_t> values;
+  for (size_t i = 0; i < count; ++i) {
+    if (i % 100 == 0) {
+      values.push_back(any_dist(gen));
+    } else {
+      values.push_back(cluster_dist(gen) * 1000000 - 2000000 + offset_dist(gen));
+    }
+  }
+  values.push_back(std::numeric_limits<int64_t>::min());
+  values.push_back(std::numeric_limits<int64_t>::max());
+  return values;
+}
+
+}  // namespace
+
+TEST(CountDistinctHashSet, Insert) {
+  RowSetMemoryOwner row_set_mem_owner(1024 * 1024);
+  auto hash_set = row_set_mem_owner.allocateCountDistinctHashSet();
+  EXPECT_EQ(hash_set->size(), size_t(0));
+  const auto values = generate_values(50000, 1);
+  std::set<int64_t> expected;
+  for (const auto val : values) {
+    hash_set->insert(val);
+    expected.insert(val);
+  }
+  EXPECT_EQ(hash_set->size(), expected.size());
+  EXPECT_EQ(to_std_set(*hash_set), expected);
+}
+
+TEST(CountDistinctHashSet, Merge) {
+  RowSetMemoryOwner row_set_mem_owner(1024 * 1024);
+  auto lhs = row_set_mem_owner.allocateCountDistinctHashSet();
+  auto rhs = row_set_mem_owner.allocateCountDistinctHashSet();
+  auto empty = row_set_mem_owner.allocateCountDistinctHashSet();
+  std::set<int64_t> expected;
+  for (const auto val : generate_values(20000, 2)) {
+    lhs->insert(val);
+    expected.insert(val);
+  }
+  for (const auto val : generate_values(30000, 3)) {
+    rhs->insert(val);
+    expected.insert(val);
+  }
+  lhs->merge(*rhs);
+  lhs->merge(*empty);
+  EXPECT_EQ(lhs->size(), expected.size());
+  EXPECT_EQ(to_std_set(*lhs), expected);
+  rhs->assign(*lhs);
+  EXPECT_EQ(to_std_set(*rhs), expected);
+  empty->merge(*lhs);
+  EXPECT_EQ(to_std_set(*empty), expected);
+}
+
+TEST(CountDistinctSparseBitmap, Insert) {
+  CountDistinctSparseBitmap sparse_bitmap;
+  EXPECT_EQ(sparse_bitmap.size(), size_t(0));
+  const auto values = generate_values(50000, 4);
+  std::set<int64_t> expected;
+  for (const auto val : values) {
+    sparse_bitmap.insert(val);
+    expected.insert(val);
+  }
+  EXPECT_EQ(sparse_bitmap.size(), expected.size());
+  EXPECT_EQ(to_std_set(sparse_bitmap), expected);
+}
+
+TEST(CountDistinctSparseBitmap, Merge) {
+  CountDistinctSparseBitmap lhs;
+  CountDistinctSparseBitmap rhs;
+  std::set<int64_t> expected;
+  // only the first of the containers gets dense on its own in lhs
+  for (int64_t val = 0; val < 5000; ++val) {
+    lhs.insert(val);
+    expected.insert(val);
+  }
+  for (const auto val : generate_values(20000, 5)) {
+    lhs.insert(val);
+    expected.insert(val);
+  }
+  for (const auto val : generate_values(30000, 6)) {
+    rhs.insert(val);
+    expected.insert(val);
+  }
+  lhs.merge(rhs);
+  EXPECT_EQ(lhs.size(), expected.size());
+  EXPECT_EQ(to_std_set(lhs), expected);
+  CountDistinctSparseBitmap empty;
+  empty.merge(lhs);
+  EXPECT_EQ(empty.size(), expected.size());
+  EXPECT_EQ(to_std_set(empty), expected);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -28,6 +28,7 @@
 
 #include "QueryEngine/ResultSet.h"
 #include "QueryRunner/QueryRunner.h"
+#include "TableArchiver/TableArchive.h"
 #include "TestHelpers.h"
 
 #ifndef BASE_PATH
@@ -182,14 +183,12 @@ void dump_restore(const bool migrate,
 }
 
 void dump_restore(const bool migrate, const bool alter, const bool rollback) {
-  // test two compression modes only so as not to hold cit back too much
-  if (boost::process::search_path("lz4").string().empty()) {
-    dump_restore(migrate, alter, rollback, {});  // gzip
-    dump_restore(migrate, alter, rollback, {"compression='none'"});
-  } else {
-    dump_restore(migrate, alter, rollback, {});  // lz4
-    dump_restore(migrate, alter, rollback, {"compression='gzip'"});
-  }
+  // test two tar compression modes only so as not to hold cit back too much
+  dump_restore(migrate, alter, rollback, {});  // gzip or lz4
+  dump_restore(migrate, alter, rollback, {"compression='none'"});
+  // native archives, compressed or not
+  dump_restore(migrate, alter, rollback, {"format='native'"});  // zlib
+  dump_restore(migrate, alter, rollback, {"format='native'", "compression='none'"});
 }
 
 using DumpRestoreTest_Unsharded = DumpRestoreTest<1>;
@@ -226,6 +225,41 @@ void BODY_F(DumpRestoreTest, DumpMigrate_Altered) {
 void BODY_F(DumpRestoreTest, DumpMigrate_Altered_Rollback) {
   dump_restore(true, true, true);
 }
+// restore detects the format and the compression of an archive
+void BODY_F(DumpRestoreTest, DumpMigrate_DetectFormat) {
+  g_test_rollback_dump_restore = false;
+  for (const std::string compression : {"gzip", "none"}) {
+    reset();
+    EXPECT_NO_THROW(run_ddl_statement("DUMP TABLE t TO '" + tar_ball_path +
+                                      "' WITH (compression='" + compression + "');"));
+    EXPECT_NO_THROW(run_ddl_statement("RESTORE TABLE x FROM '" + tar_ball_path + "';"));
+    EXPECT_NO_THROW(check_table("x", false, 0));
+  }
+}
+// dumps are tar files unless the native format is asked for, tar files dumped by
+// earlier versions still restore
+void BODY_F(DumpRestoreTest, DumpMigrate_DefaultTar) {
+  g_test_rollback_dump_restore = false;
+  for (const std::string with_options :
+       {"", " WITH (compression='none')", " WITH (compression='gzip')"}) {
+    reset();
+    EXPECT_NO_THROW(run_ddl_statement("DUMP TABLE t TO '" + tar_ball_path + "'" +
+                                      with_options + ";"));
+    EXPECT_FALSE(TableArchiveReader::isTableArchive(tar_ball_path));
+    EXPECT_NO_THROW(run_ddl_statement("RESTORE TABLE x FROM '" + tar_ball_path + "';"));
+    EXPECT_NO_THROW(check_table("x", false, 0));
+  }
+  for (const std::string with_options :
+       {" WITH (format='native')", " WITH (compression='zlib')"}) {
+    reset();
+    EXPECT_NO_THROW(run_ddl_statement("DUMP TABLE t TO '" + tar_ball_path + "'" +
+                                      with_options + ";"));
+    EXPECT_TRUE(TableArchiveReader::isTableArchive(tar_ball_path));
+  }
+  EXPECT_THROW(run_ddl_statement("DUMP TABLE t TO '" + tar_ball_path +
+                                 "' WITH (format='native', compression='gzip');"),
+               std::runtime_error);
+}
 
 // restore table tests
 TEST_UNSHARDED_AND_SHARDED(DumpRestoreTest, DumpRestore)
@@ -237,6 +271,8 @@ TEST_UNSHARDED_AND_SHARDED(DumpRestoreTest, DumpMigrate)
 TEST_UNSHARDED_AND_SHARDED(DumpRestoreTest, DumpMigrate_Rollback)
 TEST_UNSHARDED_AND_SHARDED(DumpRestoreTest, DumpMigrate_Altered)
 TEST_UNSHARDED_AND_SHARDED(DumpRestoreTest, DumpMigrate_Altered_Rollback)
+TEST_UNSHARDED_AND_SHARDED(DumpRestoreTest, DumpMigrate_DetectFormat)
+TEST_UNSHARDED_AND_SHARDED(DumpRestoreTest, DumpMigrate_DefaultTar)
 
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
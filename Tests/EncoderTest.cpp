@@ -24,8 +24,10 @@
 
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/Encoder.h"
+#include "DataMgr/FixedLengthArrayNoneEncoder.h"
 #include "DataMgr/MemoryLevel.h"
 #include "Shared/DatumFetchers.h"
+#include "Shared/geo_compression_runtime.h"
 #include "TestHelpers.h"
 
 #ifndef BASE_PATH
@@ -767,6 +769,140 @@ TYPED_TEST(FixedLengthArrayNoneEncoderUpdateStatsTest, TypedTest) {
   TestFixture::runTest();
 }
 
+class FixedLengthArrayNoneEncoderBoundingBoxTest : public EncoderUpdateStatsTest {
+ protected:
+  void createGeoEncoder(const SQLTypes subtype, const int size) {
+    auto sql_type_info = SQLTypeInfo(kARRAY, false);
+    sql_type_info.set_subtype(subtype);
+    sql_type_info.set_size(size);
+    createEncoder(sql_type_info);
+  }
+
+  std::optional<ChunkBoundingBox> getBoundingBox() {
+    auto chunk_metadata = std::make_shared<ChunkMetadata>();
+    buffer_->encoder->getMetadata(chunk_metadata);
+    return chunk_metadata->boundingBox;
+  }
+};
+
+TEST_F(FixedLengthArrayNoneEncoderBoundingBoxTest, Bounds) {
+  createGeoEncoder(kDOUBLE, 4 * sizeof(double));
+  std::vector<std::vector<double>> data = {
+      {0, 1, 2, 3},
+      {NULL_ARRAY_DOUBLE, NULL_DOUBLE, NULL_DOUBLE, NULL_DOUBLE},
+      {-5, 2, 1, 10}};
+  updateWithArrayData(convertToArrayDatum(data, ArrayDatum()));
+  const auto bounding_box = getBoundingBox();
+  ASSERT_TRUE(bounding_box);
+  EXPECT_EQ(*bounding_box, ChunkBoundingBox({-5, 1, 2, 10}));
+}
+
+TEST_F(FixedLengthArrayNoneEncoderBoundingBoxTest, CompressedPoints) {
+  createGeoEncoder(kTINYINT, 2 * sizeof(int32_t));
+  std::vector<std::vector<int32_t>> data;
+  for (const auto& point : std::vector<std::pair<double, double>>{{-70, 40}, {10, -20}}) {
+    data.push_back(
+        {static_cast<int32_t>(
+             Geo_namespace::compress_longitude_coord_geoint32(point.first)),
+         static_cast<int32_t>(
+             Geo_namespace::compress_lattitude_coord_geoint32(point.second))});
+  }
+  data.push_back(
+      {static_cast<int32_t>(Geo_namespace::compress_null_point_longitude_geoint32()),
+       static_cast<int32_t>(Geo_namespace::compress_null_point_lattitude_geoint32())});
+  updateWithArrayData(convertToArrayDatum(data, ArrayDatum()));
+  const auto bounding_box = getBoundingBox();
+  ASSERT_TRUE(bounding_box);
+  EXPECT_NEAR(bounding_box->min_x, -70, 1e-6);
+  EXPECT_NEAR(bounding_box->max_x, 10, 1e-6);
+  EXPECT_NEAR(bounding_box->min_y, -20, 1e-6);
+  EXPECT_NEAR(bounding_box->max_y, 40, 1e-6);
+}
+
+TEST_F(FixedLengthArrayNoneEncoderBoundingBoxTest, WriteAndReadMetadata) {
+  createGeoEncoder(kTINYINT, 2 * sizeof(double));
+  std::vector<std::vector<double>> data = {{1, 2}, {NULL_ARRAY_DOUBLE, NULL_DOUBLE}};
+  updateWithArrayData(convertToArrayDatum(data, ArrayDatum()));
+
+  std::unique_ptr<FILE, decltype(&fclose)> f(tmpfile(), &fclose);
+  ASSERT_TRUE(f);
+  buffer_->encoder->writeMetadata(f.get());
+  rewind(f.get());
+  createGeoEncoder(kTINYINT, 2 * sizeof(double));
+  buffer_->encoder->readMetadata(f.get());
+  const auto bounding_box = getBoundingBox();
+  ASSERT_TRUE(bounding_box);
+  EXPECT_EQ(*bounding_box, ChunkBoundingBox({1, 2, 1, 2}));
+
+  // stats rewritten without the bounding box that follows them
+  rewind(f.get());
+  const size_t num_elems{7};
+  fwrite(&num_elems, sizeof(size_t), 1, f.get());
+  rewind(f.get());
+  createGeoEncoder(kTINYINT, 2 * sizeof(double));
+  buffer_->encoder->readMetadata(f.get());
+  EXPECT_FALSE(getBoundingBox());
+}
+
+TEST_F(FixedLengthArrayNoneEncoderBoundingBoxTest, UpgradedChunkAppend) {
+  // metadata as written before bounding boxes were kept
+  const auto write_metadata_without_box = [](FILE* f, const size_t num_elems) {
+    Datum elem_min, elem_max;
+    elem_min.doubleval = 1;
+    elem_max.doubleval = 2;
+    const bool has_nulls{false};
+    const bool initialized{num_elems > 0};
+    fwrite(&num_elems, sizeof(size_t), 1, f);
+    fwrite(&elem_min, sizeof(Datum), 1, f);
+    fwrite(&elem_max, sizeof(Datum), 1, f);
+    fwrite(&has_nulls, sizeof(bool), 1, f);
+    fwrite(&initialized, sizeof(bool), 1, f);
+    rewind(f);
+  };
+  std::vector<std::vector<double>> data = {{5, 6}};
+
+  std::unique_ptr<FILE, decltype(&fclose)> f(tmpfile(), &fclose);
+  ASSERT_TRUE(f);
+  write_metadata_without_box(f.get(), 2);
+  createGeoEncoder(kTINYINT, 2 * sizeof(double));
+  buffer_->encoder->readMetadata(f.get());
+  EXPECT_FALSE(getBoundingBox());
+  // the rows read back aren't covered by a box of the appended ones
+  updateWithArrayData(convertToArrayDatum(data, ArrayDatum()));
+  EXPECT_FALSE(getBoundingBox());
+
+  // and stay unknown across a write
+  std::unique_ptr<FILE, decltype(&fclose)> g(tmpfile(), &fclose);
+  ASSERT_TRUE(g);
+  buffer_->encoder->writeMetadata(g.get());
+  rewind(g.get());
+  createGeoEncoder(kTINYINT, 2 * sizeof(double));
+  buffer_->encoder->readMetadata(g.get());
+  updateWithArrayData(convertToArrayDatum(data, ArrayDatum()));
+  EXPECT_FALSE(getBoundingBox());
+
+  // until every row is seen again
+  auto encoder = dynamic_cast<FixedLengthArrayNoneEncoder*>(buffer_->encoder.get());
+  ASSERT_TRUE(encoder);
+  encoder->resetBoundingBox();
+  std::vector<double> row{1, 2};
+  encoder->updateMetadata(reinterpret_cast<int8_t*>(row.data()));
+  auto bounding_box = getBoundingBox();
+  ASSERT_TRUE(bounding_box);
+  EXPECT_EQ(*bounding_box, ChunkBoundingBox({1, 2, 1, 2}));
+
+  // an empty chunk has no rows to miss
+  std::unique_ptr<FILE, decltype(&fclose)> h(tmpfile(), &fclose);
+  ASSERT_TRUE(h);
+  write_metadata_without_box(h.get(), 0);
+  createGeoEncoder(kTINYINT, 2 * sizeof(double));
+  buffer_->encoder->readMetadata(h.get());
+  updateWithArrayData(convertToArrayDatum(data, ArrayDatum()));
+  bounding_box = getBoundingBox();
+  ASSERT_TRUE(bounding_box);
+  EXPECT_EQ(*bounding_box, ChunkBoundingBox({5, 6, 5, 6}));
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -60,6 +60,8 @@ extern bool g_enable_window_functions;
 extern bool g_enable_bump_allocator;
 extern bool g_enable_interop;
 extern bool g_enable_union;
+extern bool g_enable_top_n_pruning;
+extern bool g_enable_geo_fragment_skipping;
 
 extern size_t g_leaf_count;
 extern bool g_cluster;
@@ -2019,6 +2021,68 @@ TEST(Select, ApproxCountDistinct) {
   }
 }
 
+TEST(Select, ApproxQuantile) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // the extreme quantiles of a t-digest are exact
+    ASSERT_EQ(7,
+              v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(x, 0) FROM test;", dt)));
+    ASSERT_EQ(8,
+              v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(x, 1) FROM test;", dt)));
+    ASSERT_EQ(7, v<double>(run_simple_agg("SELECT APPROX_MEDIAN(x) FROM test;", dt)));
+    ASSERT_EQ(
+        7, v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(x, 0.5) FROM test;", dt)));
+    ASSERT_DOUBLE_EQ(
+        111.1,
+        v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(dd, 0) FROM test;", dt)));
+    ASSERT_DOUBLE_EQ(
+        333.3,
+        v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(dd, 1) FROM test;", dt)));
+    ASSERT_FLOAT_EQ(
+        -1000.3,
+        v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(fn, 0) FROM test;", dt)));
+    ASSERT_FLOAT_EQ(
+        -101.2,
+        v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(fn, 1) FROM test;", dt)));
+    ASSERT_EQ(std::numeric_limits<double>::min(),
+              v<double>(run_simple_agg("SELECT APPROX_MEDIAN(x) FROM test_empty;", dt)));
+    ASSERT_EQ(std::numeric_limits<double>::min(),
+              v<double>(run_simple_agg(
+                  "SELECT APPROX_MEDIAN(fn) FROM test WHERE fn IS NULL;", dt)));
+    {
+      const auto rows = run_multiple_agg(
+          "SELECT z, APPROX_MEDIAN(x) FROM test GROUP BY z ORDER BY z;", dt);
+      ASSERT_EQ(size_t(3), rows->rowCount());
+      const std::vector<std::pair<int64_t, double>> expected{
+          {-78, 8}, {101, 7}, {102, 7}};
+      for (const auto& [z, median] : expected) {
+        const auto crt_row = rows->getNextRow(true, true);
+        ASSERT_EQ(z, v<int64_t>(crt_row[0]));
+        ASSERT_EQ(median, v<double>(crt_row[1]));
+      }
+    }
+    {
+      const auto rows = run_multiple_agg(
+          "SELECT z, APPROX_PERCENTILE(dd, 1) AS p FROM test GROUP BY z ORDER BY p DESC;",
+          dt);
+      ASSERT_EQ(size_t(3), rows->rowCount());
+      const std::vector<int64_t> expected{102, -78, 101};
+      for (const auto z : expected) {
+        const auto crt_row = rows->getNextRow(true, true);
+        ASSERT_EQ(z, v<int64_t>(crt_row[0]));
+      }
+    }
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_PERCENTILE(x, 2) FROM test;", dt),
+                 std::runtime_error);
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_PERCENTILE(x, -0.5) FROM test;", dt),
+                 std::runtime_error);
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_PERCENTILE(x, y) FROM test;", dt),
+                 std::runtime_error);
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_MEDIAN(str) FROM test;", dt),
+                 std::runtime_error);
+  }
+}
+
 TEST(Select, ScanNoAggregation) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -2180,6 +2244,93 @@ TEST(Select, OrderBy) {
   }
 }
 
+TEST(Select, StreamingTopNCompositeKey) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT x, z, t FROM test ORDER BY x DESC, z, t DESC LIMIT 5;", dt);
+    c("SELECT x, d, f FROM test ORDER BY x, d DESC, f LIMIT 7;", dt);
+    c("SELECT dd_notnull, x, t FROM test ORDER BY dd_notnull DESC, x, t LIMIT 3 OFFSET "
+      "2;",
+      dt);
+    c("SELECT x, y FROM test ORDER BY x DESC, y ASC NULLS FIRST LIMIT 4;",
+      "SELECT x, y FROM test ORDER BY x DESC, y ASC LIMIT 4;",
+      dt);
+    c("SELECT x, ofd FROM test ORDER BY x, ofd DESC NULLS LAST LIMIT 6;",
+      "SELECT x, ofd FROM test ORDER BY x, ofd DESC LIMIT 6;",
+      dt);
+  }
+}
+
+TEST(Select, GroupedTopNPruning) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  run_ddl_statement("DROP TABLE IF EXISTS top_n_pruning_test;");
+  run_ddl_statement(build_create_table_statement(
+      "id INT NOT NULL, x INT NOT NULL, y INT NOT NULL, z INT NOT NULL",
+      "top_n_pruning_test",
+      {"", 0},
+      {},
+      20,
+      g_use_temporary_tables,
+      true,
+      false));
+  g_sqlite_comparator.query("DROP TABLE IF EXISTS top_n_pruning_test;");
+  g_sqlite_comparator.query(
+      "CREATE TABLE top_n_pruning_test (id INT NOT NULL, x INT NOT NULL, y INT NOT NULL, "
+      "z INT NOT NULL);");
+  ScopeGuard reset = [] {
+    run_ddl_statement("DROP TABLE IF EXISTS top_n_pruning_test;");
+    g_sqlite_comparator.query("DROP TABLE IF EXISTS top_n_pruning_test;");
+  };
+  // every fragment holds many small groups, a few groups are much bigger than the others
+  std::vector<int> xs;
+  for (int i = 0; i < 120; ++i) {
+    xs.push_back(i % 30);
+  }
+  xs.insert(xs.end(), 30, 7);
+  xs.insert(xs.end(), 20, 3);
+  xs.insert(xs.end(), 12, 5);
+  for (size_t id = 0; id < xs.size(); ++id) {
+    const std::string insert_stmt{"INSERT INTO top_n_pruning_test VALUES (" +
+                                  std::to_string(id) + ", " + std::to_string(xs[id]) +
+                                  ", 1, " + std::to_string(xs[id] % 2) + ");"};
+    run_multiple_agg(insert_stmt, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_stmt);
+  }
+
+  const auto enable_top_n_pruning = g_enable_top_n_pruning;
+  ScopeGuard reset_top_n_pruning = [enable_top_n_pruning] {
+    g_enable_top_n_pruning = enable_top_n_pruning;
+  };
+  for (const bool enable_pruning : {true, false}) {
+    g_enable_top_n_pruning = enable_pruning;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      c("SELECT x, COUNT(*) AS n FROM top_n_pruning_test GROUP BY x ORDER BY n DESC "
+        "LIMIT 3;",
+        dt);
+      c("SELECT x, z, COUNT(*) AS n FROM top_n_pruning_test GROUP BY x, z ORDER BY n "
+        "DESC LIMIT 2 OFFSET 1;",
+        dt);
+      c("SELECT x, SUM(y) AS s FROM top_n_pruning_test GROUP BY x ORDER BY s DESC "
+        "LIMIT 3;",
+        dt);
+      c("SELECT x, SUM(-y) AS s FROM top_n_pruning_test GROUP BY x ORDER BY s ASC "
+        "LIMIT 3;",
+        dt);
+      c("SELECT x, MAX(id) AS m FROM top_n_pruning_test GROUP BY x ORDER BY m DESC "
+        "LIMIT 3;",
+        dt);
+      c("SELECT x, MIN(id) AS m FROM top_n_pruning_test GROUP BY x ORDER BY m ASC "
+        "LIMIT 3;",
+        dt);
+      c("SELECT x, MIN(id) AS m FROM top_n_pruning_test GROUP BY x ORDER BY m DESC "
+        "LIMIT 3;",
+        dt);
+    }
+  }
+}
+
 TEST(Select, VariableLengthOrderBy) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -2652,6 +2803,14 @@ TEST(Select, Strings) {
               v<int64_t>(run_simple_agg(
                   "SELECT COUNT(*) FROM test WHERE str REGEXP 'ba.' or str REGEXP 'fo.';",
                   dt)));
+    ASSERT_EQ(g_num_rows,
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM test WHERE REGEXP_LIKE(real_str, 'real_ba[rz]');",
+                  dt)));
+    ASSERT_EQ(3 * g_num_rows / 2,
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM test WHERE real_str REGEXP "
+                                        "'real_baz' or REGEXP_LIKE(real_str, 'r.*o+');",
+                                        dt)));
     EXPECT_ANY_THROW(run_simple_agg("SELECT LENGTH(NULL) FROM test;", dt));
   }
 }
@@ -4637,6 +4796,17 @@ TEST(Select, In) {
     c("SELECT COUNT(*) FROM test WHERE x IN (1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, "
       "14, 15, 16, 17, 18, 19, 20);",
       dt);
+    c("SELECT COUNT(*) FROM test WHERE x IN (1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, "
+      "14, 15, 16, 17, 18, 19, 20, NULL);",
+      dt);
+    c("SELECT COUNT(*) FROM test WHERE str IN ('str1', 'str2', 'str3', 'str4', 'str5', "
+      "'str6', 'str7', 'str8', 'str9', 'str10', 'str11', 'str12', 'str13', 'str14', "
+      "'str15', 'str16', 'bar');",
+      dt);
+    c("SELECT x, COUNT(*) FROM test WHERE x IN (7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, "
+      "18, 19, 20, 21, 22) OR y IN (41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, "
+      "54, 55, 56) GROUP BY x ORDER BY x;",
+      dt);
   }
 }
 
@@ -16467,6 +16637,62 @@ TEST(Select, GeoSpatial_GeoJoin) {
   }
 }
 
+TEST(Select, GeoSpatial_FragmentSkipping) {
+  run_ddl_statement("DROP TABLE IF EXISTS geo_fragment_skipping_test;");
+  run_ddl_statement(
+      "CREATE TABLE geo_fragment_skipping_test (id INT, p POINT) WITH "
+      "(fragment_size=2);");
+  ScopeGuard reset = [] {
+    run_ddl_statement("DROP TABLE IF EXISTS geo_fragment_skipping_test;");
+  };
+  // the points (i, i), two per fragment
+  for (int i = 0; i < 10; ++i) {
+    run_multiple_agg("INSERT INTO geo_fragment_skipping_test VALUES (" +
+                         std::to_string(i) + ", 'POINT(" + std::to_string(i) + " " +
+                         std::to_string(i) + ")');",
+                     ExecutorDeviceType::CPU);
+  }
+
+  const std::vector<std::pair<std::string, int64_t>> predicates_and_counts{
+      {"ST_Contains(ST_GeomFromText('POLYGON((3.5 3.5, 6.5 3.5, 6.5 6.5, 3.5 6.5, "
+       "3.5 3.5))'), p)",
+       3},
+      {"ST_Intersects(p, ST_GeomFromText('POLYGON((-1 -1, 1 -1, 1 1, -1 1, -1 -1))'))",
+       2},
+      {"ST_Intersects(p, ST_GeomFromText('POLYGON((20 20, 21 20, 21 21, 20 20))'))", 0},
+      {"ST_X(p) > 7", 2},
+      {"ST_X(p) >= 7", 3},
+      {"7 < ST_X(p)", 2},
+      {"7 <= ST_X(p)", 3},
+      {"2 >= ST_Y(p)", 3},
+      {"2 > ST_Y(p)", 2},
+      {"ST_Y(p) = 4", 1},
+      // (0, 0) and (2, 2) are exactly at distance 2 of (2, 0)
+      {"ST_Distance(p, 'POINT(2 0)') <= 2.0", 3},
+      {"ST_Distance(p, 'POINT(2 0)') < 2.0", 1},
+      {"2.0 >= ST_Distance(p, 'POINT(2 0)')", 3},
+      {"2.0 > ST_Distance(p, 'POINT(2 0)')", 1},
+      {"ST_Distance(p, 'POINT(9 9)') < 1.0", 1},
+      {"ST_DWithin(p, 'POINT(2 0)', 2.0)", 3}};
+
+  const auto enable_geo_fragment_skipping = g_enable_geo_fragment_skipping;
+  ScopeGuard reset_geo_fragment_skipping = [enable_geo_fragment_skipping] {
+    g_enable_geo_fragment_skipping = enable_geo_fragment_skipping;
+  };
+  for (const bool enable_skipping : {true, false}) {
+    g_enable_geo_fragment_skipping = enable_skipping;
+    for (const auto& [predicate, count] : predicates_and_counts) {
+      EXPECT_EQ(count,
+                v<int64_t>(run_simple_agg(
+                    "SELECT COUNT(*) FROM geo_fragment_skipping_test WHERE " +
+                        predicate + ";",
+                    ExecutorDeviceType::CPU)))
+          << predicate << (enable_skipping ? " with" : " without")
+          << " fragment skipping";
+    }
+  }
+}
+
 TEST(Rounding, ROUND) {
   SKIP_ALL_ON_AGGREGATOR();
 
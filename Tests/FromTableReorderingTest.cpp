@@ -16,6 +16,7 @@
 
 #include "TestHelpers.h"
 
+#include "../Catalog/ColumnStatistics.h"
 #include "../Import/Importer.h"
 #include "../Parser/parser.h"
 #include "../QueryEngine/ArrowResultSet.h"
@@ -31,6 +32,12 @@
 
 #include <gtest/gtest.h>
 
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+using QR = QueryRunner::QueryRunner;
+
 TEST(Ordering, Basic) {
   // Basic test of inner join ordering. Equal table sizes.
   {
@@ -362,15 +369,278 @@ TEST(Ordering, Triple) {
   }
 }
 
+TEST(ColumnStatistics, Selectivity) {
+  ColumnStatistics stats;
+  stats.num_rows = 1000;
+  stats.ndv = 12;
+  stats.null_fraction = 0.1;
+  stats.histogram_bounds = {0, 25, 50, 75, 100};
+  stats.most_common_values = {{42, 0.4}, {7, 0.1}};
+
+  // most common values keep their own frequency
+  ASSERT_DOUBLE_EQ(0.4, stats.estimateEqualsSelectivity(42));
+  ASSERT_DOUBLE_EQ(0.1, stats.estimateEqualsSelectivity(7));
+  // remaining rows are spread uniformly over the remaining distinct values
+  ASSERT_DOUBLE_EQ((1. - 0.1 - 0.5) / 10, stats.estimateEqualsSelectivity(10));
+  // values outside of the histogram may have been inserted since, count them as a row
+  ASSERT_DOUBLE_EQ(0.001, stats.minSelectivity());
+  ASSERT_DOUBLE_EQ(0.001, stats.estimateEqualsSelectivity(-1));
+  ASSERT_DOUBLE_EQ(0.001, stats.estimateEqualsSelectivity(101));
+
+  ASSERT_DOUBLE_EQ(0.9, stats.estimateRangeSelectivity(0, 100));
+  ASSERT_DOUBLE_EQ(0.45, stats.estimateRangeSelectivity(0, 50));
+  ASSERT_DOUBLE_EQ(0.9 / 8, stats.estimateRangeSelectivity(0, 12.5));
+  const auto inf = std::numeric_limits<double>::infinity();
+  ASSERT_DOUBLE_EQ(0.9, stats.estimateRangeSelectivity(-inf, inf));
+  ASSERT_DOUBLE_EQ(0.001, stats.estimateRangeSelectivity(200, 300));
+  ASSERT_DOUBLE_EQ(0, stats.estimateRangeSelectivity(60, 40));
+}
+
+TEST(ColumnStatistics, NoHistogram) {
+  ColumnStatistics stats;
+  stats.num_rows = 10;
+  stats.ndv = 5;
+  ASSERT_DOUBLE_EQ(ColumnStatistics::kDefaultRangeSelectivity,
+                   stats.estimateRangeSelectivity(0, 1));
+  ASSERT_DOUBLE_EQ(0.2, stats.estimateEqualsSelectivity(3));
+  ASSERT_DOUBLE_EQ(0.2, stats.averageEqualsSelectivity());
+
+  // the statistics of an empty table don't tell anything about the rows inserted since
+  ColumnStatistics empty;
+  ASSERT_DOUBLE_EQ(1, empty.estimateEqualsSelectivity(3));
+  ASSERT_DOUBLE_EQ(1, empty.estimateRangeSelectivity(0, 1));
+  ASSERT_DOUBLE_EQ(1, empty.averageEqualsSelectivity());
+}
+
+TEST(ColumnStatistics, Serialization) {
+  ColumnStatistics stats;
+  stats.histogram_bounds = {-1.5, 0, 3, 1e12};
+  stats.most_common_values = {{3, 0.25}, {-7, 0.125}};
+  stats.null_fraction = 1. / 3;
+
+  ColumnStatistics deserialized;
+  deserialized.deserializeHistogram(stats.serializeHistogram());
+  deserialized.deserializeMostCommonValues(stats.serializeMostCommonValues());
+  ASSERT_EQ(stats.histogram_bounds, deserialized.histogram_bounds);
+  ASSERT_EQ(stats.most_common_values, deserialized.most_common_values);
+  ASSERT_EQ(stats.null_fraction, std::stod(stats.serializeNullFraction()));
+
+  deserialized.deserializeHistogram("");
+  ASSERT_TRUE(deserialized.histogram_bounds.empty());
+}
+
+namespace {
+
+void run_ddl_statement(const std::string& stmt) {
+  QR::get()->runDDLStatement(stmt);
+}
+
+void run_insert(const std::string& stmt) {
+  QR::get()->runSQL(stmt, ExecutorDeviceType::CPU);
+}
+
+// x holds 0, ..., 19 and five nulls.
+void create_statistics_test_tables() {
+  run_ddl_statement("DROP TABLE IF EXISTS statistics_test_big;");
+  run_ddl_statement("DROP TABLE IF EXISTS statistics_test_small;");
+  run_ddl_statement("CREATE TABLE statistics_test_big (x INT);");
+  run_ddl_statement("CREATE TABLE statistics_test_small (y INT);");
+  for (int i = 0; i < 20; ++i) {
+    run_insert("INSERT INTO statistics_test_big VALUES (" + std::to_string(i) + ");");
+  }
+  for (int i = 0; i < 5; ++i) {
+    run_insert("INSERT INTO statistics_test_big VALUES (NULL);");
+  }
+  for (int i = 0; i < 10; ++i) {
+    run_insert("INSERT INTO statistics_test_small VALUES (" + std::to_string(i) + ");");
+  }
+}
+
+void drop_statistics_test_tables() {
+  run_ddl_statement("DROP TABLE IF EXISTS statistics_test_big;");
+  run_ddl_statement("DROP TABLE IF EXISTS statistics_test_small;");
+}
+
+}  // namespace
+
+TEST(ColumnStatistics, AnalyzeTable) {
+  create_statistics_test_tables();
+  ScopeGuard drop_tables = [] { drop_statistics_test_tables(); };
+  auto cat = QR::get()->getCatalog();
+  CHECK(cat);
+  const auto td = cat->getMetadataForTable("statistics_test_big");
+  CHECK(td);
+  const auto cd = cat->getMetadataForColumn(td->tableId, "x");
+  CHECK(cd);
+  ASSERT_FALSE(cat->getColumnStatistics(td->tableId, cd->columnId));
+
+  run_ddl_statement("ANALYZE TABLE statistics_test_big;");
+  const auto stats = cat->getColumnStatistics(td->tableId, cd->columnId);
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(int64_t(25), stats->num_rows);
+  // the sample holds every value, which bounds the estimate of the sketch
+  EXPECT_EQ(int64_t(20), stats->ndv);
+  EXPECT_DOUBLE_EQ(0.2, stats->null_fraction);
+  ASSERT_FALSE(stats->histogram_bounds.empty());
+  EXPECT_DOUBLE_EQ(0, stats->histogram_bounds.front());
+  EXPECT_DOUBLE_EQ(19, stats->histogram_bounds.back());
+
+  // the persisted rows, which the catalog is built from on startup
+  auto& sqlite_connector = cat->getSqliteConnector();
+  sqlite_connector.query_with_text_params(
+      "SELECT num_rows, ndv, histogram, most_common_values, null_fraction FROM "
+      "omnisci_column_statistics WHERE table_id = ? AND column_id = ?",
+      std::vector<std::string>{std::to_string(td->tableId),
+                               std::to_string(cd->columnId)});
+  ASSERT_EQ(size_t(1), sqlite_connector.getNumRows());
+  EXPECT_EQ(stats->num_rows, sqlite_connector.getData<int64_t>(0, 0));
+  EXPECT_EQ(stats->ndv, sqlite_connector.getData<int64_t>(0, 1));
+  ColumnStatistics persisted_stats;
+  persisted_stats.deserializeHistogram(sqlite_connector.getData<std::string>(0, 2));
+  persisted_stats.deserializeMostCommonValues(
+      sqlite_connector.getData<std::string>(0, 3));
+  EXPECT_EQ(stats->histogram_bounds, persisted_stats.histogram_bounds);
+  EXPECT_EQ(stats->most_common_values, persisted_stats.most_common_values);
+  EXPECT_EQ(stats->null_fraction, sqlite_connector.getData<double>(0, 4));
+
+  run_ddl_statement("TRUNCATE TABLE statistics_test_big;");
+  EXPECT_FALSE(cat->getColumnStatistics(td->tableId, cd->columnId));
+}
+
+TEST(ColumnStatistics, JoinOrdering) {
+  create_statistics_test_tables();
+  ScopeGuard drop_tables = [] { drop_statistics_test_tables(); };
+  auto cat = QR::get()->getCatalog();
+  CHECK(cat);
+  auto executor = Executor::getExecutor(cat->getCurrentDB().dbId);
+  CHECK(executor);
+  executor->setCatalog(cat.get());
+
+  const auto big_td = cat->getMetadataForTable("statistics_test_big");
+  const auto small_td = cat->getMetadataForTable("statistics_test_small");
+  CHECK(big_td && small_td);
+  const auto x_cd = cat->getMetadataForColumn(big_td->tableId, "x");
+  const auto y_cd = cat->getMetadataForColumn(small_td->tableId, "y");
+  CHECK(x_cd && y_cd);
+  const auto x = std::make_shared<Analyzer::ColumnVar>(
+      x_cd->columnType, big_td->tableId, x_cd->columnId, 0);
+  const auto y = std::make_shared<Analyzer::ColumnVar>(
+      y_cd->columnType, small_td->tableId, y_cd->columnId, 1);
+  Datum five;
+  five.intval = 5;
+  // statistics_test_big JOIN statistics_test_small ON x = y WHERE x = 5
+  const auto x_equals_five = std::make_shared<Analyzer::BinOper>(
+      kBOOLEAN, kEQ, kONE, x, std::make_shared<Analyzer::Constant>(kINT, false, five));
+  JoinQualsPerNestingLevel nesting_levels{
+      {{std::make_shared<Analyzer::BinOper>(kBOOLEAN, kEQ, kONE, x, y), x_equals_five},
+       JoinType::INNER}};
+  const std::vector<InputTableInfo> table_infos{
+      {big_td->tableId, executor->getTableInfo(big_td->tableId)},
+      {small_td->tableId, executor->getTableInfo(small_td->tableId)}};
+
+  // the join qual costs the same both ways, the larger table stays on the outer side
+  using Permutation = decltype(
+      get_node_input_permutation(nesting_levels, table_infos, executor.get()));
+  ASSERT_EQ(Permutation({0, 1}),
+            get_node_input_permutation(nesting_levels, table_infos, executor.get()));
+
+  // the filter on x leaves about one row of statistics_test_big, which is now the
+  // smaller input and goes on the inner side
+  run_ddl_statement("ANALYZE TABLE statistics_test_big;");
+  ASSERT_EQ(Permutation({1, 0}),
+            get_node_input_permutation(nesting_levels, table_infos, executor.get()));
+}
+
+TEST(ColumnStatistics, JoinFanOut) {
+  // fact.x holds 0, ..., 19 and fact.w 0 and 1, dim_x.k 0, ..., 9 and dim_w.k 0 and 1
+  // on 12 rows
+  run_ddl_statement("DROP TABLE IF EXISTS statistics_test_fact;");
+  run_ddl_statement("DROP TABLE IF EXISTS statistics_test_dim_x;");
+  run_ddl_statement("DROP TABLE IF EXISTS statistics_test_dim_w;");
+  ScopeGuard drop_tables = [] {
+    run_ddl_statement("DROP TABLE IF EXISTS statistics_test_fact;");
+    run_ddl_statement("DROP TABLE IF EXISTS statistics_test_dim_x;");
+    run_ddl_statement("DROP TABLE IF EXISTS statistics_test_dim_w;");
+  };
+  run_ddl_statement("CREATE TABLE statistics_test_fact (x INT, w INT);");
+  run_ddl_statement("CREATE TABLE statistics_test_dim_x (k INT);");
+  run_ddl_statement("CREATE TABLE statistics_test_dim_w (k INT);");
+  for (int i = 0; i < 25; ++i) {
+    run_insert("INSERT INTO statistics_test_fact VALUES (" + std::to_string(i % 20) +
+               ", " + std::to_string(i % 2) + ");");
+  }
+  for (int i = 0; i < 10; ++i) {
+    run_insert("INSERT INTO statistics_test_dim_x VALUES (" + std::to_string(i) + ");");
+  }
+  for (int i = 0; i < 12; ++i) {
+    run_insert("INSERT INTO statistics_test_dim_w VALUES (" + std::to_string(i % 2) +
+               ");");
+  }
+  auto cat = QR::get()->getCatalog();
+  CHECK(cat);
+  auto executor = Executor::getExecutor(cat->getCurrentDB().dbId);
+  CHECK(executor);
+  executor->setCatalog(cat.get());
+
+  const auto fact_td = cat->getMetadataForTable("statistics_test_fact");
+  const auto dim_x_td = cat->getMetadataForTable("statistics_test_dim_x");
+  const auto dim_w_td = cat->getMetadataForTable("statistics_test_dim_w");
+  CHECK(fact_td && dim_x_td && dim_w_td);
+  const auto make_column = [&cat](const TableDescriptor* td,
+                                  const std::string& column_name,
+                                  const int nest_level) {
+    const auto cd = cat->getMetadataForColumn(td->tableId, column_name);
+    CHECK(cd);
+    return std::make_shared<Analyzer::ColumnVar>(
+        cd->columnType, td->tableId, cd->columnId, nest_level);
+  };
+  // statistics_test_fact JOIN statistics_test_dim_x ON x = dim_x.k
+  //   JOIN statistics_test_dim_w ON w = dim_w.k
+  JoinQualsPerNestingLevel nesting_levels{
+      {{std::make_shared<Analyzer::BinOper>(kBOOLEAN,
+                                            kEQ,
+                                            kONE,
+                                            make_column(fact_td, "x", 0),
+                                            make_column(dim_x_td, "k", 1))},
+       JoinType::INNER},
+      {{std::make_shared<Analyzer::BinOper>(kBOOLEAN,
+                                            kEQ,
+                                            kONE,
+                                            make_column(fact_td, "w", 0),
+                                            make_column(dim_w_td, "k", 2))},
+       JoinType::INNER}};
+  const std::vector<InputTableInfo> table_infos{
+      {fact_td->tableId, executor->getTableInfo(fact_td->tableId)},
+      {dim_x_td->tableId, executor->getTableInfo(dim_x_td->tableId)},
+      {dim_w_td->tableId, executor->getTableInfo(dim_w_td->tableId)}};
+
+  // without statistics, the larger dimension table is joined first
+  using Permutation = decltype(
+      get_node_input_permutation(nesting_levels, table_infos, executor.get()));
+  ASSERT_EQ(Permutation({0, 2, 1}),
+            get_node_input_permutation(nesting_levels, table_infos, executor.get()));
+
+  // a fact row matches half a row of statistics_test_dim_x and six rows of
+  // statistics_test_dim_w, which is joined last to keep the intermediate result small
+  run_ddl_statement("ANALYZE TABLE statistics_test_fact;");
+  run_ddl_statement("ANALYZE TABLE statistics_test_dim_x;");
+  run_ddl_statement("ANALYZE TABLE statistics_test_dim_w;");
+  ASSERT_EQ(Permutation({0, 1, 2}),
+            get_node_input_permutation(nesting_levels, table_infos, executor.get()));
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
 
+  QR::init(BASE_PATH);
+
   int err{0};
   try {
     err = RUN_ALL_TESTS();
   } catch (const std::exception& e) {
     LOG(ERROR) << e.what();
   }
+  QR::reset();
   return err;
 }
@@ -17,9 +17,12 @@
 #include "TestHelpers.h"
 
 #include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <limits>
 #include <string>
 
+#include <arrow/api.h>
 #include <gtest/gtest.h>
 
 #include <boost/algorithm/string.hpp>
@@ -28,6 +31,7 @@
 #include "../Archive/PosixFileArchive.h"
 #include "../Catalog/Catalog.h"
 #include "../Import/Importer.h"
+#include "../Import/StreamIngestor.h"
 #include "../Parser/parser.h"
 #include "../QueryEngine/ResultSet.h"
 #include "../QueryRunner/QueryRunner.h"
@@ -594,6 +598,290 @@ TEST_F(ImportTestMixedVarlen, Fix_failed_import_arrays_after_geos) {
   CHECK_EQ(int64_t(1), v<int64_t>(crt_row[0]));
 }
 
+const char* create_table_arrow = R"(
+    CREATE TABLE import_test_arrow(
+      i INTEGER,
+      si SMALLINT,
+      d DOUBLE,
+      ts TIMESTAMP(3),
+      s TEXT ENCODING DICT(32),
+      sn TEXT ENCODING NONE
+    );
+)";
+
+class ImportTestArrow : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists import_test_arrow;"));
+    ASSERT_NO_THROW(run_ddl_statement(create_table_arrow));
+  }
+
+  void TearDown() override {
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists import_test_arrow;"));
+  }
+};
+
+// a batch of rows row_offset, ..., row_offset + row_count - 1, with every third row null
+std::vector<std::shared_ptr<arrow::Array>> make_arrow_batch(const int row_offset,
+                                                            const int row_count) {
+  arrow::Int32Builder i_builder;
+  arrow::Int16Builder si_builder;
+  arrow::DoubleBuilder d_builder;
+  arrow::TimestampBuilder ts_builder(arrow::timestamp(arrow::TimeUnit::MILLI),
+                                     arrow::default_memory_pool());
+  arrow::StringDictionary32Builder s_builder;
+  arrow::StringDictionary32Builder sn_builder;
+  for (int row = row_offset; row < row_offset + row_count; ++row) {
+    if (row % 3 == 2) {
+      CHECK(i_builder.AppendNull().ok());
+      CHECK(si_builder.AppendNull().ok());
+      CHECK(d_builder.AppendNull().ok());
+      CHECK(ts_builder.AppendNull().ok());
+      CHECK(s_builder.AppendNull().ok());
+      CHECK(sn_builder.AppendNull().ok());
+    } else {
+      CHECK(i_builder.Append(row).ok());
+      CHECK(si_builder.Append(row % 100).ok());
+      CHECK(d_builder.Append(row / 2.0).ok());
+      CHECK(ts_builder.Append(int64_t(row) * 1500).ok());
+      CHECK(s_builder.Append("str" + std::to_string(row % 4)).ok());
+      CHECK(sn_builder.Append("str" + std::to_string(row % 4)).ok());
+    }
+  }
+  std::vector<std::shared_ptr<arrow::Array>> columns(6);
+  CHECK(i_builder.Finish(&columns[0]).ok());
+  CHECK(si_builder.Finish(&columns[1]).ok());
+  CHECK(d_builder.Finish(&columns[2]).ok());
+  CHECK(ts_builder.Finish(&columns[3]).ok());
+  CHECK(s_builder.Finish(&columns[4]).ok());
+  CHECK(sn_builder.Finish(&columns[5]).ok());
+  return columns;
+}
+
+TEST_F(ImportTestArrow, MultipleBatches) {
+  SKIP_ALL_ON_AGGREGATOR();
+  auto& cat = QR::get()->getSession()->getCatalog();
+  const auto td = cat.getMetadataForTable("import_test_arrow");
+  CHECK(td);
+  auto loader = QR::get()->getLoader(td);
+  auto import_buffers = Importer_NS::setup_column_loaders(td, loader.get());
+  const auto& col_descs = loader->get_column_descs();
+  ASSERT_EQ(size_t(6), col_descs.size());
+
+  // the arrays of the first batch are sliced, such that they start at an offset
+  std::vector<std::vector<std::shared_ptr<arrow::Array>>> batches{
+      make_arrow_batch(0, 40), make_arrow_batch(30, 20)};
+  for (auto& array : batches.front()) {
+    array = array->Slice(10);
+  }
+  size_t col_idx = 0;
+  size_t row_count = 0;
+  for (const auto cd : col_descs) {
+    for (const auto& batch : batches) {
+      const auto& array = *batch[col_idx];
+      Importer_NS::ArraySliceRange row_slice(0, array.length());
+      row_count = import_buffers[col_idx]->add_arrow_values(
+          cd, array, true, row_slice, nullptr);
+    }
+    ++col_idx;
+  }
+  ASSERT_EQ(size_t(50), row_count);
+  loader->load(import_buffers, row_count);
+
+  // rows 10, ..., 39 and 30, ..., 49
+  int64_t i_sum{0};
+  int64_t si_sum{0};
+  int64_t non_null{0};
+  int64_t str1_count{0};
+  for (int row = 10; row < 50; ++row) {
+    if (row % 3 != 2) {
+      const int64_t weight = row >= 30 && row < 40 ? 2 : 1;
+      i_sum += weight * row;
+      si_sum += weight * (row % 100);
+      non_null += weight;
+      str1_count += row % 4 == 1 ? weight : 0;
+    }
+  }
+  auto rows = run_query(
+      "SELECT COUNT(*), COUNT(i), SUM(i), SUM(si), SUM(d), COUNT(s), "
+      "COUNT(DISTINCT s), COUNT(sn), MIN(ts) FROM import_test_arrow;");
+  auto crt_row = rows->getNextRow(true, true);
+  ASSERT_EQ(size_t(9), crt_row.size());
+  EXPECT_EQ(int64_t(50), v<int64_t>(crt_row[0]));
+  EXPECT_EQ(non_null, v<int64_t>(crt_row[1]));
+  EXPECT_EQ(i_sum, v<int64_t>(crt_row[2]));
+  EXPECT_EQ(si_sum, v<int64_t>(crt_row[3]));
+  EXPECT_DOUBLE_EQ(i_sum / 2.0, v<double>(crt_row[4]));
+  EXPECT_EQ(non_null, v<int64_t>(crt_row[5]));
+  EXPECT_EQ(int64_t(4), v<int64_t>(crt_row[6]));
+  EXPECT_EQ(non_null, v<int64_t>(crt_row[7]));
+  EXPECT_EQ(int64_t(10) * 1500, v<int64_t>(crt_row[8]));
+
+  rows = run_query(
+      "SELECT COUNT(*) FROM import_test_arrow WHERE s = 'str1' AND sn = 'str1' AND "
+      "MOD(i, 4) = 1;");
+  crt_row = rows->getNextRow(true, true);
+  ASSERT_EQ(size_t(1), crt_row.size());
+  EXPECT_EQ(str1_count, v<int64_t>(crt_row[0]));
+}
+
+TEST_F(ImportTestArrow, ReferencedDictionaryValues) {
+  SKIP_ALL_ON_AGGREGATOR();
+  auto& cat = QR::get()->getSession()->getCatalog();
+  const auto td = cat.getMetadataForTable("import_test_arrow");
+  CHECK(td);
+  auto loader = QR::get()->getLoader(td);
+  auto import_buffers = Importer_NS::setup_column_loaders(td, loader.get());
+  const auto& col_descs = loader->get_column_descs();
+
+  // the slices keep the whole dictionaries of str0, ..., str3 but only reference str0
+  // and str1
+  auto batch = make_arrow_batch(0, 8);
+  for (auto& array : batch) {
+    array = array->Slice(0, 2);
+  }
+  size_t col_idx = 0;
+  size_t row_count = 0;
+  for (const auto cd : col_descs) {
+    const auto& array = *batch[col_idx];
+    Importer_NS::ArraySliceRange row_slice(0, array.length());
+    row_count =
+        import_buffers[col_idx]->add_arrow_values(cd, array, true, row_slice, nullptr);
+    ++col_idx;
+  }
+  ASSERT_EQ(size_t(2), row_count);
+  loader->load(import_buffers, row_count);
+
+  const auto cd = cat.getMetadataForColumn(td->tableId, "s");
+  CHECK(cd);
+  const auto dd = cat.getMetadataForDict(cd->columnType.get_comp_param());
+  CHECK(dd && dd->stringDict);
+  EXPECT_NE(StringDictionary::INVALID_STR_ID, dd->stringDict->getIdOfString("str1"));
+  EXPECT_EQ(StringDictionary::INVALID_STR_ID, dd->stringDict->getIdOfString("str2"));
+  EXPECT_EQ(StringDictionary::INVALID_STR_ID, dd->stringDict->getIdOfString("str3"));
+
+  auto rows = run_query("SELECT COUNT(*) FROM import_test_arrow WHERE s = 'str1';");
+  auto crt_row = rows->getNextRow(true, true);
+  ASSERT_EQ(size_t(1), crt_row.size());
+  EXPECT_EQ(int64_t(1), v<int64_t>(crt_row[0]));
+}
+
+class ImportTestStream : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists import_test_stream;"));
+    ASSERT_NO_THROW(
+        run_ddl_statement("CREATE TABLE import_test_stream (i INTEGER, s TEXT);"));
+    stream_path_ = boost::filesystem::temp_directory_path() /
+                   boost::filesystem::unique_path("import_test_stream_%%%%%%.csv");
+  }
+
+  void TearDown() override {
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists import_test_stream;"));
+    boost::filesystem::remove(stream_path_);
+  }
+
+  void appendRows(const int first, const int last) {
+    std::ofstream stream_file(stream_path_.string(), std::ios::app);
+    for (int i = first; i < last; ++i) {
+      stream_file << i << ",str" << i << "\n";
+    }
+  }
+
+  std::unique_ptr<Importer_NS::StreamIngestor> startIngestion() {
+    Importer_NS::StreamIngestionParams params;
+    params.copy_params.delimiter = ',';
+    params.flush_row_count = 4;
+    params.flush_interval = std::chrono::milliseconds(100);
+    return std::make_unique<Importer_NS::StreamIngestor>(
+        QR::get()->getCatalog(),
+        "import_test_stream",
+        std::make_unique<Importer_NS::FileStreamSource>(stream_path_.string(), '\n'),
+        params);
+  }
+
+  static void waitForRows(const Importer_NS::StreamIngestor& ingestor,
+                          const size_t row_count) {
+    for (int i = 0; i < 200 && ingestor.getStatus().rows_loaded < row_count; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+  }
+
+  boost::filesystem::path stream_path_;
+};
+
+TEST_F(ImportTestStream, ResumeAfterCommittedOffset) {
+  SKIP_ALL_ON_AGGREGATOR();
+  appendRows(0, 10);
+  {
+    std::ofstream stream_file(stream_path_.string(), std::ios::app);
+    stream_file << "not,a,row\n";
+  }
+  auto ingestor = startIngestion();
+  waitForRows(*ingestor, 10);
+  // rows appended while the ingestion runs are picked up too
+  appendRows(10, 15);
+  waitForRows(*ingestor, 15);
+  ingestor->stop();
+  auto status = ingestor->getStatus();
+  EXPECT_FALSE(status.running);
+  EXPECT_TRUE(status.error.empty());
+  EXPECT_EQ(size_t(15), status.rows_loaded);
+  EXPECT_EQ(size_t(1), status.rows_rejected);
+  EXPECT_EQ(static_cast<int64_t>(boost::filesystem::file_size(stream_path_)),
+            status.committed_offset);
+
+  // a new ingestion continues after the committed rows
+  appendRows(15, 20);
+  ingestor = startIngestion();
+  waitForRows(*ingestor, 5);
+  ingestor->stop();
+  EXPECT_EQ(size_t(5), ingestor->getStatus().rows_loaded);
+
+  auto rows = run_query(
+      "SELECT COUNT(*), COUNT(DISTINCT i), SUM(i), COUNT(DISTINCT s) FROM "
+      "import_test_stream;");
+  auto crt_row = rows->getNextRow(true, true);
+  ASSERT_EQ(size_t(4), crt_row.size());
+  EXPECT_EQ(int64_t(20), v<int64_t>(crt_row[0]));
+  EXPECT_EQ(int64_t(20), v<int64_t>(crt_row[1]));
+  EXPECT_EQ(int64_t(190), v<int64_t>(crt_row[2]));
+  EXPECT_EQ(int64_t(20), v<int64_t>(crt_row[3]));
+}
+
+TEST_F(ImportTestStream, ResumeAfterRollback) {
+  SKIP_ALL_ON_AGGREGATOR();
+  auto& cat = QR::get()->getSession()->getCatalog();
+  const auto td = cat.getMetadataForTable("import_test_stream");
+  CHECK(td);
+  const auto db_id = cat.getCurrentDB().dbId;
+  appendRows(0, 5);
+  auto ingestor = startIngestion();
+  waitForRows(*ingestor, 5);
+  ingestor->stop();
+  const auto epoch = cat.getTableEpoch(db_id, td->tableId);
+  appendRows(5, 10);
+  ingestor = startIngestion();
+  waitForRows(*ingestor, 5);
+  ingestor->stop();
+  EXPECT_EQ(size_t(5), ingestor->getStatus().rows_loaded);
+
+  // the rows committed past the epoch rolled back to are ingested again
+  cat.setTableEpoch(db_id, td->tableId, epoch);
+  ingestor = startIngestion();
+  waitForRows(*ingestor, 5);
+  ingestor->stop();
+  EXPECT_EQ(size_t(5), ingestor->getStatus().rows_loaded);
+
+  auto rows = run_query("SELECT COUNT(*), COUNT(DISTINCT i), SUM(i) FROM "
+                        "import_test_stream;");
+  auto crt_row = rows->getNextRow(true, true);
+  ASSERT_EQ(size_t(3), crt_row.size());
+  EXPECT_EQ(int64_t(10), v<int64_t>(crt_row[0]));
+  EXPECT_EQ(int64_t(10), v<int64_t>(crt_row[1]));
+  EXPECT_EQ(int64_t(45), v<int64_t>(crt_row[2]));
+}
+
 const char* create_table_date = R"(
     CREATE TABLE import_test_date(
       date_text TEXT ENCODING DICT(32),
@@ -35,6 +35,7 @@
 #include "QueryEngine/UDFCompiler.h"
 #include "QueryRunner/QueryRunner.h"
 #include "Shared/Logger.h"
+#include "Shared/scope.h"
 #include "Shared/thread_count.h"
 #include "TestHelpers.h"
 
@@ -338,6 +339,49 @@ TEST(Build, PerfectOneToMany2) {
   }
 }
 
+TEST(Build, PerfectLayoutByTableGeneration) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    g_device_type = dt;
+
+    JoinHashTableCacheInvalidator::invalidateCaches();
+
+    sql(R"(
+      drop table if exists table1;
+      drop table if exists table2;
+
+      create table table1 (nums1 integer);
+      create table table2 (nums2 integer);
+
+      insert into table1 values (1);
+
+      insert into table2 values (0);
+      insert into table2 values (2);
+      insert into table2 values (3);
+    )");
+
+    auto hash_table1 = buildPerfect("table1", "nums1", "table2", "nums2");
+    EXPECT_EQ(hash_table1->getHashType(), JoinHashTableInterface::HashType::OneToOne);
+
+    // the layout known for the previous generation of table2 doesn't hold anymore
+    sql("insert into table2 values (2);");
+    // | perfect one-to-many | offsets 0 * 1 3 | counts 1 * 2 1 | payloads 0 1 3 2 |
+    const DecodedJoinHashBufferSet s1 = {{{0}, {0}}, {{2}, {1, 3}}, {{3}, {2}}};
+    auto hash_table2 = buildPerfect("table1", "nums1", "table2", "nums2");
+    EXPECT_EQ(hash_table2->getHashType(), JoinHashTableInterface::HashType::OneToMany);
+    EXPECT_EQ(s1, hash_table2->toSet(g_device_type, 0));
+
+    auto hash_table3 = buildPerfect("table1", "nums1", "table2", "nums2");
+    EXPECT_EQ(hash_table3->getHashType(), JoinHashTableInterface::HashType::OneToMany);
+    EXPECT_EQ(s1, hash_table3->toSet(g_device_type, 0));
+
+    sql(R"(
+      drop table if exists table1;
+      drop table if exists table2;
+    )");
+  }
+}
+
 TEST(Build, KeyedOneToOne) {
   auto catalog = QR::get()->getCatalog();
   CHECK(catalog);
@@ -750,6 +794,113 @@ TEST(MultiFragment, PerfectOneToMany) {
   }
 }
 
+TEST(RadixPartitioned, Perfect) {
+  g_device_type = ExecutorDeviceType::CPU;
+  const auto radix_partition_threshold = g_hash_join_radix_partition_threshold;
+  ScopeGuard reset_threshold = [radix_partition_threshold] {
+    g_hash_join_radix_partition_threshold = radix_partition_threshold;
+  };
+
+  // the keys span a few partitions of the hash tables
+  sql(R"(
+    drop table if exists table1;
+    drop table if exists table2;
+    drop table if exists table3;
+
+    create table table1 (nums1 integer);
+    create table table2 (nums2 integer) with (fragment_size = 3);
+    create table table3 (nums3 integer) with (fragment_size = 3);
+
+    insert into table1 values (1);
+
+    insert into table2 values (0);
+    insert into table2 values (70000);
+    insert into table2 values (null);
+    insert into table2 values (140001);
+    insert into table2 values (200000);
+
+    insert into table3 values (0);
+    insert into table3 values (200000);
+    insert into table3 values (70000);
+    insert into table3 values (null);
+    insert into table3 values (0);
+    insert into table3 values (140001);
+    insert into table3 values (200000);
+  )");
+
+  for (const auto& inner : std::vector<std::pair<std::string, std::string>>{
+           {"table2", "nums2"}, {"table3", "nums3"}}) {
+    g_hash_join_radix_partition_threshold = 0;
+    JoinHashTableCacheInvalidator::invalidateCaches();
+    auto hash_table1 = buildPerfect("table1", "nums1", inner.first, inner.second);
+    auto s1 = hash_table1->toSet(g_device_type, 0);
+
+    g_hash_join_radix_partition_threshold = 1;
+    JoinHashTableCacheInvalidator::invalidateCaches();
+    auto hash_table2 = buildPerfect("table1", "nums1", inner.first, inner.second);
+    EXPECT_EQ(hash_table1->getHashType(), hash_table2->getHashType());
+    auto s2 = hash_table2->toSet(g_device_type, 0);
+    EXPECT_EQ(s1, s2);
+  }
+
+  sql(R"(
+    drop table if exists table1;
+    drop table if exists table2;
+    drop table if exists table3;
+  )");
+}
+
+TEST(RuntimeFilters, Perfect) {
+  g_device_type = ExecutorDeviceType::CPU;
+  ScopeGuard reset_runtime_filters = [] { g_enable_join_runtime_filters = true; };
+
+  // the sparse keys make the hash table large enough to get a Bloom filter
+  sql(R"(
+    drop table if exists table1;
+    drop table if exists table2;
+
+    create table table1 (nums1 integer) with (fragment_size = 2);
+    create table table2 (nums2 integer);
+
+    insert into table1 values (5);
+    insert into table1 values (7);
+    insert into table1 values (100);
+    insert into table1 values (3000000);
+    insert into table1 values (5000000);
+    insert into table1 values (null);
+
+    insert into table2 values (100);
+    insert into table2 values (null);
+    insert into table2 values (3000000);
+  )");
+
+  g_enable_join_runtime_filters = false;
+  JoinHashTableCacheInvalidator::invalidateCaches();
+  auto hash_table1 = buildPerfect("table1", "nums1", "table2", "nums2");
+  EXPECT_FALSE(hash_table1->getKeyBounds());
+
+  g_enable_join_runtime_filters = true;
+  JoinHashTableCacheInvalidator::invalidateCaches();
+  auto hash_table2 = buildPerfect("table1", "nums1", "table2", "nums2");
+  EXPECT_EQ(hash_table2->getKeyBounds(), std::make_pair(int64_t(100), int64_t(3000000)));
+  EXPECT_EQ(hash_table1->toSet(g_device_type, 0), hash_table2->toSet(g_device_type, 0));
+
+  for (const bool enable_runtime_filters : {false, true}) {
+    g_enable_join_runtime_filters = enable_runtime_filters;
+    JoinHashTableCacheInvalidator::invalidateCaches();
+    const auto rows = QR::get()->runSQL(
+        "select count(*) from table1, table2 where nums1 = nums2;", g_device_type);
+    const auto crt_row = rows->getNextRow(true, true);
+    ASSERT_EQ(crt_row.size(), size_t(1));
+    EXPECT_EQ(v<int64_t>(crt_row[0]), int64_t(2));
+  }
+
+  sql(R"(
+    drop table if exists table1;
+    drop table if exists table2;
+  )");
+}
+
 TEST(MultiFragment, KeyedOneToOne) {
   auto catalog = QR::get()->getCatalog();
   CHECK(catalog);
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file QueryProfileTest.cpp
+ * @brief Test suite for the per query execution profile and EXPLAIN ANALYZE
+ */
+
+#include <gtest/gtest.h>
+
+#include "DBHandlerTestHelpers.h"
+#include "Shared/scope.h"
+#include "TestHelpers.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+extern bool g_enable_query_profile;
+
+class QueryProfileTest : public DBHandlerTestFixture {
+ protected:
+  static void SetUpTestSuite() {
+    createDBHandler();
+    sql("DROP TABLE IF EXISTS profile_test;");
+    sql("DROP TABLE IF EXISTS profile_dim;");
+    // three fragments, of i in [0, 1], [2, 3] and [4, 5]
+    sql("CREATE TABLE profile_test (i INTEGER, k INTEGER) WITH (FRAGMENT_SIZE=2);");
+    for (int i = 0; i < 6; ++i) {
+      sql("INSERT INTO profile_test VALUES (" + std::to_string(i) + ", " +
+          std::to_string(i % 3) + ");");
+    }
+    sql("CREATE TABLE profile_dim (k INTEGER, v INTEGER);");
+    for (int k = 0; k < 3; ++k) {
+      sql("INSERT INTO profile_dim VALUES (" + std::to_string(k) + ", " +
+          std::to_string(k * 10) + ");");
+    }
+  }
+
+  static void TearDownTestSuite() {
+    sql("DROP TABLE IF EXISTS profile_test;");
+    sql("DROP TABLE IF EXISTS profile_dim;");
+  }
+};
+
+TEST_F(QueryProfileTest, ExplainAnalyze) {
+  TQueryResult result;
+  sql(result, "EXPLAIN ANALYZE SELECT COUNT(*) FROM profile_test WHERE i > 3;");
+  ASSERT_EQ(result.row_set.row_desc.size(), size_t(1));
+  EXPECT_EQ(result.row_set.row_desc.front().col_name, "Explanation");
+  ASSERT_EQ(result.row_set.columns.size(), size_t(1));
+  ASSERT_EQ(result.row_set.columns.front().data.str_col.size(), size_t(1));
+  const auto& explanation = result.row_set.columns.front().data.str_col.front();
+  EXPECT_NE(explanation.find("rows: 6 -> 1"), std::string::npos) << explanation;
+
+  ASSERT_TRUE(result.__isset.profile);
+  ASSERT_EQ(result.profile.steps.size(), size_t(1));
+  const auto& step = result.profile.steps.front();
+  EXPECT_EQ(step.input_rows, 6);
+  EXPECT_EQ(step.output_rows, 1);
+  EXPECT_EQ(step.fragments_skipped, 2);
+  EXPECT_EQ(step.fragments_scanned, 1);
+  ASSERT_FALSE(step.kernels.empty());
+  EXPECT_EQ(step.kernels.front().fragment_ids, std::vector<int64_t>{2});
+}
+
+TEST_F(QueryProfileTest, CodeCacheHits) {
+  const std::string query{
+      "EXPLAIN ANALYZE SELECT k, SUM(i) FROM profile_test GROUP BY k;"};
+  TQueryResult first_result;
+  sql(first_result, query);
+  TQueryResult result;
+  sql(result, query);
+  ASSERT_TRUE(result.__isset.profile);
+  ASSERT_EQ(result.profile.steps.size(), size_t(1));
+  const auto& step = result.profile.steps.front();
+  EXPECT_EQ(step.output_rows, 3);
+  EXPECT_EQ(step.fragments_scanned, 3);
+  EXPECT_GE(step.code_cache_hits, 1);
+  EXPECT_EQ(step.code_cache_misses, 0);
+}
+
+TEST_F(QueryProfileTest, HashTableCacheHits) {
+  const std::string query{
+      "EXPLAIN ANALYZE SELECT COUNT(*) FROM profile_test t, profile_dim d WHERE t.k = "
+      "d.k;"};
+  TQueryResult first_result;
+  sql(first_result, query);
+  TQueryResult result;
+  sql(result, query);
+  ASSERT_TRUE(result.__isset.profile);
+  ASSERT_EQ(result.profile.steps.size(), size_t(1));
+  const auto& step = result.profile.steps.front();
+  EXPECT_EQ(step.input_rows, 9);
+  EXPECT_EQ(step.hash_tables, 1);
+  EXPECT_GE(step.hash_table_cache_hits, 1);
+}
+
+TEST_F(QueryProfileTest, ProfileWithResult) {
+  TQueryResult plain_result;
+  sql(plain_result, "SELECT COUNT(*) FROM profile_test;");
+  EXPECT_FALSE(plain_result.__isset.profile);
+
+  g_enable_query_profile = true;
+  ScopeGuard reset_profile = [] { g_enable_query_profile = false; };
+  TQueryResult result;
+  sql(result, "SELECT i FROM profile_test WHERE i < 4 ORDER BY i;");
+  ASSERT_EQ(result.row_set.columns.size(), size_t(1));
+  EXPECT_EQ(result.row_set.columns.front().data.int_col,
+            (std::vector<int64_t>{0, 1, 2, 3}));
+  ASSERT_TRUE(result.__isset.profile);
+  ASSERT_FALSE(result.profile.steps.empty());
+  EXPECT_EQ(result.profile.steps.back().output_rows, 4);
+}
+
+TEST_F(QueryProfileTest, ProfileMultiStep) {
+  g_enable_query_profile = true;
+  ScopeGuard reset_profile = [] { g_enable_query_profile = false; };
+  // the rows of every step are counted for the profile, before the result is sorted and
+  // limited
+  TQueryResult result;
+  sql(result,
+      "SELECT k, s FROM (SELECT k, SUM(i) AS s FROM profile_test GROUP BY k) ORDER BY s "
+      "DESC LIMIT 2;");
+  ASSERT_EQ(result.row_set.columns.size(), size_t(2));
+  EXPECT_EQ(result.row_set.columns.front().data.int_col, (std::vector<int64_t>{2, 1}));
+  EXPECT_EQ(result.row_set.columns.back().data.int_col, (std::vector<int64_t>{7, 5}));
+  ASSERT_TRUE(result.__isset.profile);
+  ASSERT_FALSE(result.profile.steps.empty());
+  EXPECT_EQ(result.profile.steps.back().output_rows, 2);
+
+  TQueryResult plain_result;
+  g_enable_query_profile = false;
+  sql(plain_result,
+      "SELECT k, s FROM (SELECT k, SUM(i) AS s FROM profile_test GROUP BY k) ORDER BY s "
+      "DESC LIMIT 2;");
+  EXPECT_EQ(plain_result.row_set.columns.back().data.int_col,
+            result.row_set.columns.back().data.int_col);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  DBHandlerTestFixture::initTestArgs(argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+
+  return err;
+}
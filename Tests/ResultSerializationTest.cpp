@@ -0,0 +1,342 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file ResultSerializationTest.cpp
+ * @brief Test suite for the conversion of query results to Thrift and paged fetches
+ */
+
+#include <gtest/gtest.h>
+
+#include "DBHandlerTestHelpers.h"
+#include "Shared/scope.h"
+#include "TestHelpers.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+extern bool g_enable_columnar_output;
+
+namespace {
+
+size_t get_row_count(const TQueryResult& result) {
+  if (result.row_set.is_columnar) {
+    return result.row_set.columns.empty() ? 0
+                                          : result.row_set.columns.front().nulls.size();
+  }
+  return result.row_set.rows.size();
+}
+
+}  // namespace
+
+class ResultSerializationTest : public DBHandlerTestFixture {
+ protected:
+  static void SetUpTestSuite() {
+    createDBHandler();
+    sql("DROP TABLE IF EXISTS serialization_test;");
+    sql("CREATE TABLE serialization_test (i INTEGER, b BIGINT, s SMALLINT, d DOUBLE, "
+        "f FLOAT, dec DECIMAL(10, 2), t TEXT ENCODING DICT(32), ts TIMESTAMP, "
+        "ai INTEGER[]);");
+    sql("INSERT INTO serialization_test VALUES (1, 10, 100, 1.5, 2.5, 3.25, 'a', "
+        "'2020-01-01 00:00:00', {1, 2});");
+    sql("INSERT INTO serialization_test VALUES (NULL, NULL, NULL, NULL, NULL, NULL, "
+        "NULL, NULL, NULL);");
+    sql("INSERT INTO serialization_test VALUES (-3, 30, -300, -4.5, 0.5, -1.75, 'b', "
+        "'1999-12-31 23:59:59', {});");
+    // grow the table past the threshold of the multi-threaded conversion
+    for (size_t i = 0; i < 13; ++i) {
+      sql("INSERT INTO serialization_test SELECT * FROM serialization_test;");
+    }
+  }
+
+  static void TearDownTestSuite() { sql("DROP TABLE IF EXISTS serialization_test;"); }
+
+  void sqlRowWise(TQueryResult& result, const std::string& query) {
+    auto [db_handler, session_id] = getDbHandlerAndSessionId();
+    db_handler->sql_execute(result, session_id, query, false, "", -1, -1);
+  }
+
+  void assertColumnsEqual(const TColumn& lhs, const TColumn& rhs) {
+    ASSERT_EQ(lhs.nulls, rhs.nulls);
+    ASSERT_EQ(lhs.data.int_col, rhs.data.int_col);
+    ASSERT_EQ(lhs.data.real_col, rhs.data.real_col);
+    ASSERT_EQ(lhs.data.str_col, rhs.data.str_col);
+    ASSERT_EQ(lhs.data.arr_col.size(), rhs.data.arr_col.size());
+    for (size_t i = 0; i < lhs.data.arr_col.size(); ++i) {
+      assertColumnsEqual(lhs.data.arr_col[i], rhs.data.arr_col[i]);
+    }
+  }
+
+  void assertColumnMatchesRows(const TColumn& column,
+                               const std::vector<TRow>& rows,
+                               const size_t col_idx,
+                               const TColumnType& col_type) {
+    ASSERT_EQ(column.nulls.size(), rows.size());
+    for (size_t row_idx = 0; row_idx < rows.size(); ++row_idx) {
+      const auto& datum = rows[row_idx].cols[col_idx];
+      ASSERT_EQ(column.nulls[row_idx], datum.is_null);
+      if (datum.is_null || col_type.col_type.is_array) {
+        continue;
+      }
+      switch (col_type.col_type.type) {
+        case TDatumType::SMALLINT:
+        case TDatumType::INT:
+        case TDatumType::BIGINT:
+        case TDatumType::TIMESTAMP:
+          ASSERT_EQ(column.data.int_col[row_idx], datum.val.int_val);
+          break;
+        case TDatumType::FLOAT:
+        case TDatumType::DOUBLE:
+        case TDatumType::DECIMAL:
+          ASSERT_DOUBLE_EQ(column.data.real_col[row_idx], datum.val.real_val);
+          break;
+        case TDatumType::STR:
+          ASSERT_EQ(column.data.str_col[row_idx], datum.val.str_val);
+          break;
+        default:
+          FAIL() << "Unexpected column type";
+      }
+    }
+  }
+
+  void assertColumnarMatchesRowWise(const std::string& query) {
+    TQueryResult columnar_result;
+    sql(columnar_result, query);
+    TQueryResult row_result;
+    sqlRowWise(row_result, query);
+    ASSERT_TRUE(columnar_result.row_set.is_columnar);
+    ASSERT_FALSE(row_result.row_set.is_columnar);
+    const auto& row_desc = columnar_result.row_set.row_desc;
+    ASSERT_EQ(row_desc.size(), columnar_result.row_set.columns.size());
+    for (size_t i = 0; i < row_desc.size(); ++i) {
+      assertColumnMatchesRows(
+          columnar_result.row_set.columns[i], row_result.row_set.rows, i, row_desc[i]);
+    }
+  }
+};
+
+TEST_F(ResultSerializationTest, ColumnarProjection) {
+  assertColumnarMatchesRowWise(
+      "SELECT i, b, s, d, f, dec, t, ts FROM serialization_test ORDER BY i, d;");
+}
+
+TEST_F(ResultSerializationTest, ColumnarOutputProjection) {
+  const auto enable_columnar_output = g_enable_columnar_output;
+  ScopeGuard reset_columnar_output = [enable_columnar_output] {
+    g_enable_columnar_output = enable_columnar_output;
+  };
+  // columnar projections are serialized straight from the result set buffers
+  g_enable_columnar_output = true;
+  TQueryResult direct_result;
+  sql(direct_result, "SELECT i, b, s, d, f, ts FROM serialization_test;");
+  g_enable_columnar_output = false;
+  TQueryResult result;
+  sql(result, "SELECT i, b, s, d, f, ts FROM serialization_test;");
+  ASSERT_EQ(size_t(24576), get_row_count(direct_result));
+  ASSERT_EQ(direct_result.row_set.columns.size(), result.row_set.columns.size());
+  for (size_t i = 0; i < result.row_set.columns.size(); ++i) {
+    assertColumnsEqual(direct_result.row_set.columns[i], result.row_set.columns[i]);
+  }
+}
+
+TEST_F(ResultSerializationTest, ColumnarGroupBy) {
+  assertColumnarMatchesRowWise(
+      "SELECT t, COUNT(*), SUM(b), AVG(d) FROM serialization_test GROUP BY t "
+      "ORDER BY t;");
+}
+
+TEST_F(ResultSerializationTest, ColumnarArrays) {
+  TQueryResult result;
+  sql(result, "SELECT ai FROM serialization_test;");
+  ASSERT_EQ(size_t(24576), get_row_count(result));
+  const auto& column = result.row_set.columns.front();
+  size_t null_count{0};
+  for (size_t i = 0; i < column.nulls.size(); ++i) {
+    null_count += column.nulls[i];
+  }
+  ASSERT_EQ(size_t(8192), null_count);
+}
+
+TEST_F(ResultSerializationTest, AtMostN) {
+  auto [db_handler, session_id] = getDbHandlerAndSessionId();
+  TQueryResult result;
+  const std::string query{"SELECT i FROM serialization_test;"};
+  EXPECT_THROW(db_handler->sql_execute(result, session_id, query, true, "", -1, 10),
+               TOmniSciException);
+  EXPECT_NO_THROW(db_handler->sql_execute(result,
+                                          session_id,
+                                          "SELECT i FROM serialization_test LIMIT 10;",
+                                          true,
+                                          "",
+                                          -1,
+                                          10));
+  ASSERT_EQ(size_t(10), get_row_count(result));
+}
+
+class PagedResultTest : public ResultSerializationTest {
+ protected:
+  void fetchAllPages(const std::string& query,
+                     const bool column_format,
+                     const int32_t page_size,
+                     std::vector<TQueryResult>& pages) {
+    auto [db_handler, session_id] = getDbHandlerAndSessionId();
+    TQueryResult page;
+    db_handler->sql_execute_paged(page, session_id, query, column_format, "", page_size);
+    pages.push_back(page);
+    while (!pages.back().result_handle.empty()) {
+      ASSERT_EQ(size_t(page_size), get_row_count(pages.back()));
+      TQueryResult next_page;
+      db_handler->fetch_next(
+          next_page, session_id, pages.back().result_handle, page_size);
+      pages.push_back(next_page);
+    }
+  }
+};
+
+TEST_F(PagedResultTest, Columnar) {
+  const std::string query{"SELECT i, d, t FROM serialization_test ORDER BY i, d, t;"};
+  std::vector<TQueryResult> pages;
+  fetchAllPages(query, true, 1000, pages);
+  TQueryResult result;
+  sql(result, query);
+
+  size_t row_offset{0};
+  for (const auto& page : pages) {
+    ASSERT_TRUE(page.row_set.is_columnar);
+    for (size_t i = 0; i < page.row_set.columns.size(); ++i) {
+      const auto& page_column = page.row_set.columns[i];
+      const auto& column = result.row_set.columns[i];
+      for (size_t j = 0; j < page_column.nulls.size(); ++j) {
+        ASSERT_EQ(page_column.nulls[j], column.nulls[row_offset + j]);
+        if (!column.data.int_col.empty()) {
+          ASSERT_EQ(page_column.data.int_col[j], column.data.int_col[row_offset + j]);
+        } else if (!column.data.real_col.empty()) {
+          ASSERT_EQ(page_column.data.real_col[j], column.data.real_col[row_offset + j]);
+        } else {
+          ASSERT_EQ(page_column.data.str_col[j], column.data.str_col[row_offset + j]);
+        }
+      }
+    }
+    row_offset += get_row_count(page);
+  }
+  ASSERT_EQ(get_row_count(result), row_offset);
+}
+
+TEST_F(PagedResultTest, RowWise) {
+  std::vector<TQueryResult> pages;
+  fetchAllPages(
+      "SELECT i FROM serialization_test LIMIT 2500 OFFSET 10;", false, 500, pages);
+  size_t row_count{0};
+  for (const auto& page : pages) {
+    ASSERT_FALSE(page.row_set.is_columnar);
+    row_count += get_row_count(page);
+  }
+  ASSERT_EQ(size_t(2500), row_count);
+  // the last full page can only be detected as such by the next, empty, fetch
+  ASSERT_EQ(size_t(0), get_row_count(pages.back()));
+}
+
+TEST_F(PagedResultTest, InvalidRequests) {
+  auto [db_handler, session_id] = getDbHandlerAndSessionId();
+  TQueryResult result;
+  EXPECT_THROW(db_handler->fetch_next(result, session_id, "not_a_handle", 10),
+               TOmniSciException);
+  EXPECT_THROW(db_handler->sql_execute_paged(
+                   result, session_id, "SELECT i FROM serialization_test;", true, "", 0),
+               TOmniSciException);
+  EXPECT_THROW(db_handler->sql_execute_paged(
+                   result, session_id, "DROP TABLE serialization_test;", true, "", 10),
+               TOmniSciException);
+
+  db_handler->sql_execute_paged(
+      result, session_id, "SELECT i FROM serialization_test;", true, "", 10);
+  ASSERT_FALSE(result.result_handle.empty());
+  const auto result_handle = result.result_handle;
+  db_handler->close_result(session_id, result_handle);
+  EXPECT_THROW(db_handler->fetch_next(result, session_id, result_handle, 10),
+               TOmniSciException);
+}
+
+TEST_F(PagedResultTest, ReleaseTableLocksOfMaterializedResult) {
+  sql("DROP TABLE IF EXISTS paged_lock_test;");
+  sql("CREATE TABLE paged_lock_test (i INTEGER, t TEXT ENCODING DICT(32));");
+  ScopeGuard drop_table = [] { sql("DROP TABLE IF EXISTS paged_lock_test;"); };
+  for (int i = 1; i <= 3; ++i) {
+    sql("INSERT INTO paged_lock_test VALUES (" + std::to_string(i) + ", 'str" +
+        std::to_string(i) + "');");
+  }
+  auto [db_handler, session_id] = getDbHandlerAndSessionId();
+  TQueryResult result;
+  db_handler->sql_execute_paged(
+      result, session_id, "SELECT i, t FROM paged_lock_test ORDER BY i;", false, "", 1);
+  ASSERT_FALSE(result.result_handle.empty());
+  // would wait for the read lock of the open result if it still held it
+  sql("TRUNCATE TABLE paged_lock_test;");
+  std::vector<int64_t> values;
+  while (true) {
+    for (const auto& row : result.row_set.rows) {
+      values.push_back(row.cols[0].val.int_val);
+      EXPECT_EQ("str" + std::to_string(values.back()), row.cols[1].val.str_val);
+    }
+    if (result.result_handle.empty()) {
+      break;
+    }
+    const auto result_handle = result.result_handle;
+    db_handler->fetch_next(result, session_id, result_handle, 1);
+  }
+  EXPECT_EQ(std::vector<int64_t>({1, 2, 3}), values);
+}
+
+TEST_F(PagedResultTest, EvictLeastRecentlyFetchedOfSession) {
+  auto [db_handler, session_id] = getDbHandlerAndSessionId();
+  // one more than the default limit of open paged results per session
+  std::vector<std::string> result_handles;
+  for (size_t i = 0; i < 9; ++i) {
+    TQueryResult result;
+    db_handler->sql_execute_paged(
+        result, session_id, "SELECT i FROM serialization_test;", true, "", 10);
+    ASSERT_FALSE(result.result_handle.empty());
+    result_handles.push_back(result.result_handle);
+    if (i == 7) {
+      // fetching from the first result makes the second the least recently fetched
+      db_handler->fetch_next(result, session_id, result_handles.front(), 10);
+    }
+  }
+  TQueryResult result;
+  EXPECT_THROW(db_handler->fetch_next(result, session_id, result_handles[1], 10),
+               TOmniSciException);
+  EXPECT_NO_THROW(db_handler->fetch_next(result, session_id, result_handles[0], 10));
+  EXPECT_NO_THROW(db_handler->fetch_next(result, session_id, result_handles.back(), 10));
+  for (const auto& result_handle : result_handles) {
+    db_handler->close_result(session_id, result_handle);
+  }
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  DBHandlerTestFixture::initTestArgs(argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+
+  return err;
+}
@@ -28,6 +28,7 @@
 #include "QueryEngine/ResultSet.h"
 #include "QueryEngine/ResultSetReductionJIT.h"
 #include "QueryEngine/RuntimeFunctions.h"
+#include "Shared/scope.h"
 #include "StringDictionary/StringDictionary.h"
 #include "Tests/TestHelpers.h"
 
@@ -37,6 +38,7 @@
 #include <random>
 
 extern bool g_is_test_env;
+extern size_t g_reduction_radix_partition_threshold;
 
 TEST(Construct, Allocate) {
   std::vector<TargetInfo> target_infos;
@@ -1752,6 +1754,22 @@ TEST(Reduce, BaselineHashColumnar) {
   test_reduce(target_infos, query_mem_desc, generator1, generator2, 1);
 }
 
+TEST(Reduce, BaselineHashRadixPartitioned) {
+  const auto radix_partition_threshold = g_reduction_radix_partition_threshold;
+  ScopeGuard reset_threshold = [radix_partition_threshold] {
+    g_reduction_radix_partition_threshold = radix_partition_threshold;
+  };
+  g_reduction_radix_partition_threshold = 1;
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  for (const bool output_columnar : {false, true}) {
+    query_mem_desc.setOutputColumnar(output_columnar);
+    EvenNumberGenerator generator1;
+    ReverseOddOrEvenNumberGenerator generator2(2 * query_mem_desc.getEntryCount() - 1);
+    test_reduce(target_infos, query_mem_desc, generator1, generator2, 1);
+  }
+}
+
 TEST(MoreReduce, MissingValues) {
   std::vector<TargetInfo> target_infos;
   SQLTypeInfo bigint_ti(kBIGINT, false);
@@ -0,0 +1,325 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file SpatialIndexTest.cpp
+ * @brief Test suite for the R-trees of spatial indexes
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Catalog/Catalog.h"
+#include "Catalog/SpatialIndex.h"
+#include "QueryRunner/QueryRunner.h"
+#include "TestHelpers.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+using QR = QueryRunner::QueryRunner;
+using namespace TestHelpers;
+
+namespace {
+
+using BoundingBox = FragmentSpatialIndex::BoundingBox;
+using Point = FragmentSpatialIndex::Point;
+
+BoundingBox make_box(const double min_x,
+                     const double min_y,
+                     const double max_x,
+                     const double max_y) {
+  return BoundingBox(Point(min_x, min_y), Point(max_x, max_y));
+}
+
+// A row every unit along the diagonal, from (first_row, first_row) on.
+std::vector<FragmentSpatialIndex::Node> make_diagonal_nodes(const uint32_t first_row,
+                                                           const uint32_t num_rows) {
+  std::vector<FragmentSpatialIndex::Node> nodes;
+  for (uint32_t row = first_row; row < first_row + num_rows; ++row) {
+    nodes.emplace_back(make_box(row, row, row + 0.5, row + 0.5), row);
+  }
+  return nodes;
+}
+
+}  // namespace
+
+TEST(FragmentSpatialIndex, Intersects) {
+  const FragmentSpatialIndex index(make_diagonal_nodes(0, 100), 100);
+  EXPECT_EQ(index.size(), size_t(100));
+  EXPECT_TRUE(index.intersects(make_box(10.2, 10.2, 10.3, 10.3)));
+  EXPECT_FALSE(index.intersects(make_box(10.6, 10.6, 10.9, 10.9)));
+  EXPECT_FALSE(index.intersects(make_box(0, 50, 10, 60)));
+  EXPECT_FALSE(index.intersects(make_box(200, 200, 300, 300)));
+
+  const FragmentSpatialIndex overlapping(
+      {{make_box(-10, -10, 0.1, 0.1), 0}, {make_box(1000, 1000, 1001, 1001), 1}}, 2);
+  EXPECT_TRUE(index.intersects(overlapping));
+  EXPECT_TRUE(overlapping.intersects(index));
+  // the envelopes intersect, none of the boxes do
+  const FragmentSpatialIndex disjoint(
+      {{make_box(50.6, 50.6, 50.9, 50.9), 0}, {make_box(0, 90, 5, 95), 1}}, 2);
+  EXPECT_FALSE(index.intersects(disjoint));
+  EXPECT_FALSE(disjoint.intersects(index));
+
+  const FragmentSpatialIndex empty({}, 10);
+  EXPECT_FALSE(empty.intersects(make_box(0, 0, 100, 100)));
+  EXPECT_FALSE(index.intersects(empty));
+}
+
+TEST(FragmentSpatialIndex, Query) {
+  const FragmentSpatialIndex index(make_diagonal_nodes(0, 100), 100);
+  auto row_offsets = index.query(make_box(9.4, 9.4, 12.1, 12.1));
+  std::sort(row_offsets.begin(), row_offsets.end());
+  EXPECT_EQ(row_offsets, std::vector<uint32_t>({9, 10, 11, 12}));
+  EXPECT_TRUE(index.query(make_box(-5, -5, -1, -1)).empty());
+}
+
+TEST(FragmentSpatialIndex, Extend) {
+  const FragmentSpatialIndex index(make_diagonal_nodes(0, 10), 10);
+  // null geometries are counted but not indexed
+  const auto extended = index.extend(make_diagonal_nodes(15, 5), 20);
+  EXPECT_EQ(index.getNumRowsIndexed(), size_t(10));
+  EXPECT_EQ(index.size(), size_t(10));
+  EXPECT_EQ(extended->getNumRowsIndexed(), size_t(20));
+  EXPECT_EQ(extended->size(), size_t(15));
+  EXPECT_FALSE(index.intersects(make_box(16, 16, 17, 17)));
+  EXPECT_TRUE(extended->intersects(make_box(16, 16, 17, 17)));
+  EXPECT_FALSE(extended->intersects(make_box(12, 12, 13, 13)));
+}
+
+class FragmentSpatialIndexFileTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    boost::filesystem::remove_all(data_path_);
+    boost::filesystem::create_directories(data_path_);
+  }
+
+  void TearDown() override { boost::filesystem::remove_all(data_path_); }
+
+  const boost::filesystem::path data_path_{boost::filesystem::path(BASE_PATH) /
+                                           "spatial_index_test"};
+  const std::string index_path_{(data_path_ / "spatial_index_1_0").string()};
+};
+
+TEST_F(FragmentSpatialIndexFileTest, SaveAndLoad) {
+  const FragmentSpatialIndex index(make_diagonal_nodes(0, 100), 120);
+  index.save(index_path_, 5);
+  EXPECT_FALSE(boost::filesystem::exists(index_path_ + ".tmp"));
+
+  const auto loaded = FragmentSpatialIndex::load(index_path_, 5);
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(loaded->getNumRowsIndexed(), size_t(120));
+  EXPECT_EQ(loaded->size(), size_t(100));
+  auto row_offsets = loaded->query(make_box(41.2, 41.2, 42.2, 42.2));
+  std::sort(row_offsets.begin(), row_offsets.end());
+  EXPECT_EQ(row_offsets, std::vector<uint32_t>({41, 42}));
+
+  // saved after the last checkpoint of the table
+  EXPECT_FALSE(FragmentSpatialIndex::load(index_path_, 4));
+}
+
+TEST_F(FragmentSpatialIndexFileTest, IgnoreUnreadableFiles) {
+  EXPECT_FALSE(FragmentSpatialIndex::load(index_path_, 1));
+
+  const FragmentSpatialIndex index(make_diagonal_nodes(0, 100), 100);
+  index.save(index_path_, 1);
+  boost::filesystem::resize_file(index_path_,
+                                 boost::filesystem::file_size(index_path_) / 2);
+  EXPECT_FALSE(FragmentSpatialIndex::load(index_path_, 1));
+
+  std::ofstream(index_path_, std::ios::trunc) << "not an index";
+  EXPECT_FALSE(FragmentSpatialIndex::load(index_path_, 1));
+}
+
+class SpatialIndexSqlTest : public testing::Test {
+ protected:
+  // Two rows per fragment, row i has a point at (10 i, 10 i) and a unit square above it.
+  void SetUp() override {
+    QR::get()->runDDLStatement("DROP TABLE IF EXISTS spatial_index_sql_test;");
+    QR::get()->runDDLStatement(
+        "CREATE TABLE spatial_index_sql_test (id INT, pt GEOMETRY(POINT), poly "
+        "GEOMETRY(POLYGON)) WITH (FRAGMENT_SIZE = 2);");
+    for (int id = 0; id < 8; ++id) {
+      insertRow(id, 10 * id);
+    }
+  }
+
+  void TearDown() override {
+    QR::get()->runDDLStatement("DROP TABLE IF EXISTS spatial_index_sql_test;");
+  }
+
+  static void insertRow(const int id, const int x) {
+    const auto x0 = std::to_string(x);
+    const auto x1 = std::to_string(x + 1);
+    QR::get()->runSQL("INSERT INTO spatial_index_sql_test VALUES (" +
+                          std::to_string(id) + ", 'POINT(" + x0 + " " + x0 +
+                          ")', 'POLYGON((" + x0 + " " + x0 + ", " + x1 + " " + x0 +
+                          ", " + x1 + " " + x1 + ", " + x0 + " " + x1 + ", " + x0 +
+                          " " + x0 + "))');",
+                      ExecutorDeviceType::CPU);
+  }
+
+  static int64_t count(const std::string& where_clause) {
+    const auto rows = QR::get()->runSQL(
+        "SELECT COUNT(*) FROM spatial_index_sql_test WHERE " + where_clause + ";",
+        ExecutorDeviceType::CPU);
+    const auto crt_row = rows->getNextRow(true, true);
+    CHECK_EQ(size_t(1), crt_row.size());
+    return v<int64_t>(crt_row[0]);
+  }
+
+  // The rows around (x, x), as counted by the predicates the spatial indexes prune
+  // fragments for.
+  static std::vector<int64_t> countAround(const int x) {
+    const auto x0 = std::to_string(x - 3);
+    const auto x1 = std::to_string(x + 3);
+    const auto box = "ST_GeomFromText('POLYGON((" + x0 + " " + x0 + ", " + x1 + " " +
+                     x0 + ", " + x1 + " " + x1 + ", " + x0 + " " + x1 + ", " + x0 +
+                     " " + x0 + "))')";
+    const auto center = std::to_string(x + 0.5);
+    return {count("ST_Contains(poly, ST_GeomFromText('POINT(" + center + " " + center +
+                  ")'))"),
+            count("ST_Intersects(poly, " + box + ")"),
+            count("ST_Intersects(pt, " + box + ")")};
+  }
+
+  static void createIndexes() {
+    QR::get()->runDDLStatement(
+        "CREATE INDEX spatial_index_sql_test_pt ON spatial_index_sql_test (pt) USING "
+        "RTREE;");
+    QR::get()->runDDLStatement(
+        "CREATE INDEX spatial_index_sql_test_poly ON spatial_index_sql_test (poly) "
+        "USING RTREE;");
+  }
+};
+
+TEST_F(SpatialIndexSqlTest, CreateAndDrop) {
+  const auto catalog = QR::get()->getCatalog();
+  const std::vector<int64_t> found{1, 1, 1};
+  const std::vector<int64_t> not_found{0, 0, 0};
+  EXPECT_EQ(countAround(30), found);
+  EXPECT_EQ(countAround(35), not_found);
+
+  createIndexes();
+  const auto index = catalog->getSpatialIndex("spatial_index_sql_test_poly");
+  ASSERT_TRUE(index);
+  const auto td = catalog->getMetadataForTable("spatial_index_sql_test");
+  ASSERT_TRUE(td);
+  EXPECT_EQ(index->table_id, td->tableId);
+  EXPECT_THROW(QR::get()->runDDLStatement(
+                   "CREATE INDEX spatial_index_sql_test_pt ON spatial_index_sql_test "
+                   "(poly) USING RTREE;"),
+               std::runtime_error);
+  EXPECT_THROW(QR::get()->runDDLStatement(
+                   "CREATE INDEX spatial_index_sql_test_id ON spatial_index_sql_test "
+                   "(id) USING RTREE;"),
+               std::runtime_error);
+  EXPECT_EQ(countAround(30), found);
+  EXPECT_EQ(countAround(35), not_found);
+
+  QR::get()->runDDLStatement("DROP INDEX spatial_index_sql_test_pt;");
+  QR::get()->runDDLStatement("DROP INDEX spatial_index_sql_test_poly;");
+  EXPECT_FALSE(catalog->getSpatialIndex("spatial_index_sql_test_poly"));
+  EXPECT_THROW(QR::get()->runDDLStatement("DROP INDEX spatial_index_sql_test_poly;"),
+               std::runtime_error);
+  EXPECT_EQ(countAround(30), found);
+  EXPECT_EQ(countAround(35), not_found);
+}
+
+TEST_F(SpatialIndexSqlTest, InvalidateAfterUpdate) {
+  createIndexes();
+  EXPECT_EQ(countAround(30), std::vector<int64_t>({1, 1, 1}));
+  QR::get()->runSQL(
+      "UPDATE spatial_index_sql_test SET pt = 'POINT(200 200)', poly = "
+      "'POLYGON((200 200, 201 200, 201 201, 200 201, 200 200))' WHERE id = 3;",
+      ExecutorDeviceType::CPU);
+  EXPECT_EQ(countAround(30), std::vector<int64_t>({0, 0, 0}));
+  EXPECT_EQ(countAround(200), std::vector<int64_t>({1, 1, 1}));
+}
+
+TEST_F(SpatialIndexSqlTest, InvalidateAfterTruncate) {
+  createIndexes();
+  EXPECT_EQ(countAround(30), std::vector<int64_t>({1, 1, 1}));
+  QR::get()->runDDLStatement("TRUNCATE TABLE spatial_index_sql_test;");
+  // the same number of rows per fragment as before, elsewhere
+  for (int id = 0; id < 8; ++id) {
+    insertRow(id, 200 + 10 * id);
+  }
+  EXPECT_EQ(countAround(30), std::vector<int64_t>({0, 0, 0}));
+  EXPECT_EQ(countAround(230), std::vector<int64_t>({1, 1, 1}));
+}
+
+TEST_F(SpatialIndexSqlTest, InvalidateAfterRollback) {
+  createIndexes();
+  const auto catalog = QR::get()->getCatalog();
+  const auto td = catalog->getMetadataForTable("spatial_index_sql_test");
+  ASSERT_TRUE(td);
+  const auto db_id = catalog->getCurrentDB().dbId;
+  const auto epoch = catalog->getTableEpoch(db_id, td->tableId);
+  // the R-tree of a new fragment is built with the row, which is then rolled back and
+  // replaced by a row elsewhere
+  insertRow(8, 80);
+  EXPECT_EQ(countAround(80), std::vector<int64_t>({1, 1, 1}));
+  catalog->setTableEpoch(db_id, td->tableId, epoch);
+  insertRow(8, 300);
+  EXPECT_EQ(countAround(80), std::vector<int64_t>({0, 0, 0}));
+  EXPECT_EQ(countAround(300), std::vector<int64_t>({1, 1, 1}));
+}
+
+// INDEX is a keyword of CREATE INDEX and DROP INDEX only, it still names tables and
+// columns.
+TEST(IndexKeyword, TableAndColumnNames) {
+  QR::get()->runDDLStatement("DROP TABLE IF EXISTS index;");
+  QR::get()->runDDLStatement("CREATE TABLE index (index INT, s TEXT);");
+  QR::get()->runSQL("INSERT INTO index (index, s) VALUES (1, 'a');",
+                    ExecutorDeviceType::CPU);
+  QR::get()->runSQL("INSERT INTO index (s, index) VALUES ('b', 2);",
+                    ExecutorDeviceType::CPU);
+  const auto catalog = QR::get()->getCatalog();
+  const auto td = catalog->getMetadataForTable("index");
+  ASSERT_TRUE(td);
+  EXPECT_TRUE(catalog->getMetadataForColumn(td->tableId, "index"));
+  const auto rows = QR::get()->runSQL("SELECT COUNT(*) FROM \"index\";",
+                                      ExecutorDeviceType::CPU);
+  const auto crt_row = rows->getNextRow(true, true);
+  ASSERT_EQ(size_t(1), crt_row.size());
+  EXPECT_EQ(int64_t(2), v<int64_t>(crt_row[0]));
+  QR::get()->runDDLStatement("DROP TABLE index;");
+  EXPECT_FALSE(catalog->getMetadataForTable("index"));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  QR::init(BASE_PATH);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  QR::reset();
+  return err;
+}
@@ -30,6 +30,8 @@
 #include "../Catalog/Catalog.h"
 #include "../DataMgr/DataMgr.h"
 #include "../Fragmenter/Fragmenter.h"
+#include "../Fragmenter/InsertLog.h"
+#include "../Shared/checked_alloc.h"
 #include "../Parser/ParserNode.h"
 #include "../Parser/parser.h"
 #include "../QueryRunner/QueryRunner.h"
@@ -50,6 +52,10 @@ using namespace Fragmenter_Namespace;
 #endif
 
 using QR = QueryRunner::QueryRunner;
+
+extern bool g_enable_insert_log;
+extern size_t g_insert_log_fold_interval_ms;
+
 namespace {
 
 inline void run_ddl_statement(const string& input_str) {
@@ -172,6 +178,286 @@ TEST(StorageSmallParallel, AllTypes) {
   ASSERT_NO_THROW(run_ddl_statement("drop table alltypes;"););
 }
 
+namespace {
+
+struct ReplayedBatch {
+  int table_id;
+  int epoch;
+  size_t num_rows;
+  std::vector<int32_t> ints;
+  std::vector<std::string> strings;
+  std::vector<std::vector<int32_t>> arrays;  // empty for null arrays
+};
+
+class InsertLogTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    boost::filesystem::remove_all(log_path_);
+    column_types_ = {SQLTypeInfo(kINT), SQLTypeInfo(kTEXT, false, kENCODING_NONE)};
+    SQLTypeInfo array_ti(kARRAY, false);
+    array_ti.set_subtype(kINT);
+    column_types_.push_back(array_ti);
+  }
+
+  void TearDown() override { boost::filesystem::remove_all(log_path_); }
+
+  // Opens the log, which replays and folds the batches left behind.
+  std::unique_ptr<InsertLog> openLog() {
+    return std::make_unique<InsertLog>(
+        log_path_,
+        3600 * 1000,
+        [this](const std::set<int>& table_ids) {
+          checkpointed_.insert(table_ids.begin(), table_ids.end());
+        },
+        [this](const int table_id, const int epoch, InsertData& insert_data) {
+          replayed_.push_back(decode(table_id, epoch, insert_data));
+        });
+  }
+
+  std::string encode(const std::vector<int32_t>& ints) {
+    std::vector<std::string> strings;
+    std::vector<ArrayDatum> arrays;
+    for (const auto i : ints) {
+      strings.push_back(std::to_string(i));
+      if (i % 2) {
+        arrays.emplace_back(0, nullptr, true);
+      } else {
+        auto data = static_cast<int8_t*>(checked_malloc(2 * sizeof(int32_t)));
+        const int32_t values[] = {i, -i};
+        std::memcpy(data, values, sizeof(values));
+        arrays.emplace_back(sizeof(values), data, false);
+      }
+    }
+    InsertData insert_data;
+    insert_data.columnIds = {1, 2, 3};
+    insert_data.numRows = ints.size();
+    insert_data.data.resize(3);
+    insert_data.data[0].numbersPtr =
+        reinterpret_cast<int8_t*>(const_cast<int32_t*>(ints.data()));
+    insert_data.data[1].stringsPtr = &strings;
+    insert_data.data[2].arraysPtr = &arrays;
+    return InsertLog::encode(insert_data, column_types_);
+  }
+
+  static ReplayedBatch decode(const int table_id,
+                              const int epoch,
+                              const InsertData& insert_data) {
+    ReplayedBatch batch{table_id, epoch, insert_data.numRows};
+    EXPECT_EQ(insert_data.columnIds, std::vector<int>({1, 2, 3}));
+    const auto ints = reinterpret_cast<const int32_t*>(insert_data.data[0].numbersPtr);
+    batch.ints.assign(ints, ints + insert_data.numRows);
+    batch.strings = *insert_data.data[1].stringsPtr;
+    for (const auto& array : *insert_data.data[2].arraysPtr) {
+      const auto values = reinterpret_cast<const int32_t*>(array.pointer);
+      batch.arrays.emplace_back(
+          array.is_null ? std::vector<int32_t>{}
+                        : std::vector<int32_t>(values,
+                                               values + array.length / sizeof(int32_t)));
+    }
+    return batch;
+  }
+
+  const std::string log_path_{std::string(BASE_PATH) + "/insert_log_test"};
+  std::vector<SQLTypeInfo> column_types_;
+  std::vector<ReplayedBatch> replayed_;
+  std::set<int> checkpointed_;
+};
+
+}  // namespace
+
+TEST_F(InsertLogTest, ReplayAndFold) {
+  {
+    auto log = openLog();
+    log->sync(log->append(7, 3, encode({1, 2, 3})));
+    log->sync(log->append(8, 5, encode({4})));
+  }
+  openLog();
+  ASSERT_EQ(replayed_.size(), size_t(2));
+  const auto& batch = replayed_[0];
+  EXPECT_EQ(batch.table_id, 7);
+  EXPECT_EQ(batch.epoch, 3);
+  EXPECT_EQ(batch.num_rows, size_t(3));
+  EXPECT_EQ(batch.ints, std::vector<int32_t>({1, 2, 3}));
+  EXPECT_EQ(batch.strings, std::vector<std::string>({"1", "2", "3"}));
+  EXPECT_EQ(batch.arrays, std::vector<std::vector<int32_t>>({{}, {2, -2}, {}}));
+  EXPECT_EQ(replayed_[1].table_id, 8);
+  EXPECT_EQ(replayed_[1].ints, std::vector<int32_t>({4}));
+  EXPECT_EQ(checkpointed_, std::set<int>({7, 8}));
+
+  // the replayed batches have been folded
+  replayed_.clear();
+  openLog();
+  EXPECT_TRUE(replayed_.empty());
+}
+
+TEST_F(InsertLogTest, Discard) {
+  {
+    auto log = openLog();
+    log->sync(log->append(1, 0, encode({1})));
+    log->sync(log->append(2, 0, encode({2})));
+    log->discard(1);
+    log->sync(log->append(1, 0, encode({3})));
+  }
+  openLog();
+  ASSERT_EQ(replayed_.size(), size_t(2));
+  EXPECT_EQ(replayed_[0].ints, std::vector<int32_t>({2}));
+  EXPECT_EQ(replayed_[1].ints, std::vector<int32_t>({3}));
+}
+
+TEST_F(InsertLogTest, Fold) {
+  auto log = openLog();
+  log->sync(log->append(1, 0, encode({1})));
+  log->fold();
+  EXPECT_EQ(checkpointed_, std::set<int>({1}));
+  log->sync(log->append(2, 0, encode({2})));
+  std::vector<ReplayedBatch> replayed;
+  log->replay(-1, [&replayed](const int table_id, const int epoch, InsertData& data) {
+    replayed.push_back(decode(table_id, epoch, data));
+  });
+  ASSERT_EQ(replayed.size(), size_t(1));
+  EXPECT_EQ(replayed[0].table_id, 2);
+}
+
+TEST_F(InsertLogTest, GroupCommit) {
+  constexpr int thread_count{8};
+  constexpr int batch_count{50};
+  {
+    auto log = openLog();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_count; ++i) {
+      threads.emplace_back([this, &log, i] {
+        for (int j = 0; j < batch_count; ++j) {
+          log->sync(log->append(i, 0, encode({j})));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  openLog();
+  ASSERT_EQ(replayed_.size(), size_t(thread_count * batch_count));
+  // the batches of every table are replayed in order
+  std::vector<int32_t> next_value(thread_count, 0);
+  for (const auto& batch : replayed_) {
+    EXPECT_EQ(batch.ints, std::vector<int32_t>({next_value[batch.table_id]++}));
+  }
+}
+
+TEST_F(InsertLogTest, TornRecord) {
+  {
+    auto log = openLog();
+    log->sync(log->append(1, 0, encode({1})));
+    log->sync(log->append(1, 0, encode({2})));
+  }
+  // cut the last record short, as if the server went down while writing it
+  for (const auto& entry : boost::filesystem::directory_iterator(log_path_)) {
+    const auto size = boost::filesystem::file_size(entry.path());
+    if (size) {
+      boost::filesystem::resize_file(entry.path(), size - 1);
+    }
+  }
+  openLog();
+  ASSERT_EQ(replayed_.size(), size_t(1));
+  EXPECT_EQ(replayed_[0].ints, std::vector<int32_t>({1}));
+}
+
+// Inserts through the server with the insert log enabled, then restarts it the way a
+// crash would, without checkpointing the tables.
+class InsertLogReplayTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    g_enable_insert_log = true;
+    // the log is only folded when it is opened, or by the test
+    g_insert_log_fold_interval_ms = 3600 * 1000;
+    restart();
+    run_ddl_statement("DROP TABLE IF EXISTS insert_log_replay_test;");
+    run_ddl_statement("CREATE TABLE insert_log_replay_test (i INT);");
+  }
+
+  void TearDown() override {
+    run_ddl_statement("DROP TABLE IF EXISTS insert_log_replay_test;");
+    g_enable_insert_log = false;
+    g_insert_log_fold_interval_ms = fold_interval_ms_;
+    restart();
+  }
+
+  static void restart() {
+    const auto db_name = QR::get()->getCatalog()->getCurrentDB().dbName;
+    Executor::nukeCacheOfExecutors();
+    // the catalog goes away along with its insert log, nothing is checkpointed
+    Catalog::remove(db_name);
+    QR::reset();
+    QR::init(BASE_PATH);
+  }
+
+  static void insert(const int value) {
+    QR::get()->runSQL(
+        "INSERT INTO insert_log_replay_test VALUES (" + std::to_string(value) + ");",
+        ExecutorDeviceType::CPU);
+  }
+
+  static int64_t count(const std::string& filter) {
+    const auto rows = QR::get()->runSQL(
+        "SELECT COUNT(*) FROM insert_log_replay_test WHERE " + filter + ";",
+        ExecutorDeviceType::CPU);
+    const auto crt_row = rows->getNextRow(true, true);
+    CHECK_EQ(size_t(1), crt_row.size());
+    return TestHelpers::v<int64_t>(crt_row[0]);
+  }
+
+  static int tableId() {
+    const auto td =
+        QR::get()->getCatalog()->getMetadataForTable("insert_log_replay_test");
+    CHECK(td);
+    return td->tableId;
+  }
+
+  static int tableEpoch() {
+    const auto cat = QR::get()->getCatalog();
+    return cat->getTableEpoch(cat->getCurrentDB().dbId, tableId());
+  }
+
+  const size_t fold_interval_ms_{g_insert_log_fold_interval_ms};
+};
+
+TEST_F(InsertLogReplayTest, RestartWithoutCheckpoint) {
+  const auto epoch = tableEpoch();
+  insert(1);
+  insert(2);
+  insert(3);
+  // the inserts were only logged
+  EXPECT_EQ(tableEpoch(), epoch);
+  restart();
+  EXPECT_EQ(count("i > 0"), int64_t(3));
+  EXPECT_EQ(count("i = 2"), int64_t(1));
+  // the replayed batches were folded when the log was opened, not replayed again
+  EXPECT_GT(tableEpoch(), epoch);
+  restart();
+  EXPECT_EQ(count("i > 0"), int64_t(3));
+}
+
+TEST_F(InsertLogReplayTest, RolledBackEpochIsNotReplayed) {
+  insert(1);
+  QR::get()->getCatalog()->getInsertLog()->fold();
+  const auto epoch = tableEpoch();
+  insert(2);
+  {
+    // rolling back to the last checkpoint replays the batch
+    const auto cat = QR::get()->getCatalog();
+    cat->setTableEpoch(cat->getCurrentDB().dbId, tableId(), epoch);
+  }
+  EXPECT_EQ(count("i = 2"), int64_t(1));
+  {
+    // rolling back further discards it
+    const auto cat = QR::get()->getCatalog();
+    cat->setTableEpoch(cat->getCurrentDB().dbId, tableId(), epoch - 1);
+  }
+  EXPECT_EQ(count("i = 2"), int64_t(0));
+  restart();
+  EXPECT_EQ(count("i = 2"), int64_t(0));
+}
+
 int main(int argc, char* argv[]) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   ::testing::InitGoogleTest(&argc, argv);
@@ -15,9 +15,13 @@
  */
 
 #include "../StringDictionary/StringDictionary.h"
+#include "../StringDictionary/StringDictionaryProxy.h"
 #include "TestHelpers.h"
 
+#include <algorithm>
+#include <boost/filesystem.hpp>
 #include <cstdlib>
+#include <fstream>
 #include <limits>
 
 #include <gtest/gtest.h>
@@ -89,6 +93,166 @@ TEST(StringDictionary, RecoverMany) {
   }
 }
 
+TEST(StringDictionary, RecoverFromHashIndex) {
+  const auto hash_index_path = boost::filesystem::path(BASE_PATH) / "DictHashIndex";
+  {
+    StringDictionary string_dict(BASE_PATH, false, false, g_cache_string_hash);
+    ASSERT_FALSE(boost::filesystem::exists(hash_index_path));
+    for (int i = 0; i < g_op_count; ++i) {
+      CHECK_EQ(i, string_dict.getOrAdd(std::to_string(i)));
+    }
+    ASSERT_TRUE(string_dict.checkpoint());
+    ASSERT_TRUE(boost::filesystem::exists(hash_index_path));
+    // too few for the index to be written again, hashed when the dictionary is opened
+    for (int i = g_op_count; i < g_op_count + 1000; ++i) {
+      CHECK_EQ(i, string_dict.getOrAdd(std::to_string(i)));
+    }
+    ASSERT_TRUE(string_dict.checkpoint());
+  }
+  StringDictionary string_dict(BASE_PATH, false, true, g_cache_string_hash);
+  ASSERT_EQ(size_t(g_op_count + 1000), string_dict.storageEntryCount());
+  for (int i = 0; i < g_op_count + 1000; ++i) {
+    CHECK_EQ(i, string_dict.getIdOfString(std::to_string(i)));
+    CHECK_EQ(std::to_string(i), string_dict.getString(i));
+  }
+  ASSERT_EQ(g_op_count + 1000, string_dict.getOrAdd("foo"));
+}
+
+TEST(StringDictionary, RecoverFromStaleHashIndex) {
+  const auto hash_index_path = boost::filesystem::path(BASE_PATH) / "DictHashIndex";
+  ASSERT_TRUE(boost::filesystem::exists(hash_index_path));
+  {
+    // clears the slots of the hash table past the header, the checksum no longer
+    // matches
+    std::fstream hash_index(hash_index_path.string(),
+                            std::ios::in | std::ios::out | std::ios::binary);
+    hash_index.seekp(1024);
+    const std::vector<char> zeros(4096, 0);
+    hash_index.write(zeros.data(), zeros.size());
+  }
+  StringDictionary string_dict(BASE_PATH, false, true, g_cache_string_hash);
+  ASSERT_EQ(size_t(g_op_count + 1001), string_dict.storageEntryCount());
+  for (int i = 0; i < g_op_count + 1000; ++i) {
+    CHECK_EQ(i, string_dict.getIdOfString(std::to_string(i)));
+  }
+  ASSERT_EQ(g_op_count + 1000, string_dict.getIdOfString("foo"));
+}
+
+TEST(StringDictionary, TranslationMap) {
+  auto source_dict =
+      std::make_shared<StringDictionary>("", true, false, g_cache_string_hash);
+  auto dest_dict =
+      std::make_shared<StringDictionary>("", true, false, g_cache_string_hash);
+  // large enough for the parallel translation
+  for (int i = 0; i < g_op_count; ++i) {
+    CHECK_EQ(i, source_dict->getOrAdd(std::to_string(i)));
+  }
+  for (int i = g_op_count - 1; i >= 0; i -= 2) {
+    dest_dict->getOrAdd(std::to_string(i));
+  }
+  const size_t dest_generation = dest_dict->storageEntryCount() - 1;
+  const auto translation_map =
+      source_dict->getTranslationMap(dest_dict, g_op_count, dest_generation);
+  ASSERT_EQ(static_cast<size_t>(g_op_count), translation_map->size());
+  for (int i = 0; i < g_op_count; ++i) {
+    const auto dest_id = truncate_to_generation(
+        dest_dict->getIdOfString(std::to_string(i)), dest_generation);
+    ASSERT_EQ(dest_id, (*translation_map)[i]);
+  }
+  // the last string added to the destination is past its generation
+  ASSERT_EQ(StringDictionary::INVALID_STR_ID, (*translation_map)[1]);
+  ASSERT_EQ(StringDictionary::INVALID_STR_ID, (*translation_map)[0]);
+  ASSERT_EQ(translation_map,
+            source_dict->getTranslationMap(dest_dict, g_op_count, dest_generation));
+  ASSERT_NE(translation_map,
+            source_dict->getTranslationMap(dest_dict, g_op_count, dest_generation + 1));
+}
+
+TEST(StringDictionaryProxy, TranslationMap) {
+  auto source_dict =
+      std::make_shared<StringDictionary>("", true, false, g_cache_string_hash);
+  auto dest_dict =
+      std::make_shared<StringDictionary>("", true, false, g_cache_string_hash);
+  source_dict->getOrAdd("foo");
+  source_dict->getOrAdd("bar");
+  dest_dict->getOrAdd("bar");
+  StringDictionaryProxy source_proxy(source_dict, source_dict->storageEntryCount());
+  StringDictionaryProxy dest_proxy(dest_dict, dest_dict->storageEntryCount());
+  const auto source_transient_id = source_proxy.getOrAddTransient("baz");
+  const auto dest_transient_id = dest_proxy.getOrAddTransient("foo");
+  const auto translation_map = source_proxy.buildTranslationMap(&dest_proxy);
+  ASSERT_EQ(dest_transient_id, translation_map.translate(0));
+  ASSERT_EQ(0, translation_map.translate(1));
+  ASSERT_EQ(StringDictionary::INVALID_STR_ID,
+            translation_map.translate(source_transient_id));
+  ASSERT_EQ(StringDictionary::INVALID_STR_ID,
+            translation_map.translate(StringDictionary::INVALID_STR_ID));
+  const auto dest_baz_id = dest_proxy.getOrAddTransient("baz");
+  ASSERT_EQ(dest_baz_id,
+            source_proxy.buildTranslationMap(&dest_proxy).translate(source_transient_id));
+}
+
+TEST(StringDictionaryProxy, StringOpTranslation) {
+  auto string_dict =
+      std::make_shared<StringDictionary>("", true, false, g_cache_string_hash);
+  // large enough for the parallel transform
+  for (int i = 0; i < g_op_count; ++i) {
+    CHECK_EQ(i, string_dict->getOrAdd("s" + std::to_string(i)));
+  }
+  const auto upper_id = string_dict->getOrAdd("S0");
+  StringDictionaryProxy proxy(string_dict, string_dict->storageEntryCount());
+  const auto transient_id = proxy.getOrAddTransient("t");
+  const auto to_upper = [](const std::string& str) {
+    auto upper_str = str;
+    std::transform(upper_str.begin(), upper_str.end(), upper_str.begin(), ::toupper);
+    return upper_str;
+  };
+  const auto& translation = proxy.getStringOpTranslation("UPPER", to_upper);
+  ASSERT_EQ(upper_id, translation.ids.translate(0));
+  ASSERT_EQ(upper_id, translation.ids.translate(upper_id));
+  const auto s1_upper_id = translation.ids.translate(1);
+  ASSERT_LT(s1_upper_id, StringDictionary::INVALID_STR_ID);
+  ASSERT_EQ("S1", proxy.getString(s1_upper_id));
+  ASSERT_EQ("T", proxy.getString(translation.ids.translate(transient_id)));
+  ASSERT_EQ(&translation, &proxy.getStringOpTranslation("UPPER", to_upper));
+
+  const auto& lengths = proxy.getStringValueMap(
+      "LENGTH", [](const std::string& str) { return static_cast<int32_t>(str.size()); });
+  ASSERT_EQ(2, lengths.translate(0));
+  ASSERT_EQ(7, lengths.translate(g_op_count - 1));
+  ASSERT_EQ(1, lengths.translate(transient_id));
+  ASSERT_EQ(2, lengths.translate(s1_upper_id));
+  // transient strings added since the map was built aren't covered
+  ASSERT_EQ(StringDictionary::INVALID_STR_ID,
+            lengths.translate(proxy.getOrAddTransient("later")));
+}
+
+TEST(StringDictionaryProxy, StringOpTranslationWithoutMap) {
+  auto string_dict =
+      std::make_shared<StringDictionary>("", true, false, g_cache_string_hash);
+  string_dict->getOrAdd("foo");
+  StringDictionaryProxy proxy(string_dict, string_dict->storageEntryCount());
+  const auto transient_id = proxy.getOrAddTransient("quux");
+  const auto to_upper = [](const std::string& str) {
+    auto upper_str = str;
+    std::transform(upper_str.begin(), upper_str.end(), upper_str.begin(), ::toupper);
+    return upper_str;
+  };
+  const auto& translation = proxy.getStringOpTranslation("UPPER", to_upper, false);
+  ASSERT_FALSE(translation.ids.ids);
+  ASSERT_EQ(StringDictionary::INVALID_STR_ID, translation.ids.translate(0));
+  ASSERT_EQ("FOO", translation.transform("foo"));
+  // nothing was transformed yet
+  ASSERT_EQ(StringDictionary::INVALID_STR_ID, proxy.getIdOfString("FOO"));
+  // a later query scanning enough rows builds the map in place
+  ASSERT_EQ(&translation, &proxy.getStringOpTranslation("UPPER", to_upper));
+  ASSERT_TRUE(translation.ids.ids);
+  ASSERT_EQ("FOO", proxy.getString(translation.ids.translate(0)));
+
+  ASSERT_EQ(size_t(3), proxy.getStringLength(0));
+  ASSERT_EQ(size_t(4), proxy.getStringLength(transient_id));
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
 
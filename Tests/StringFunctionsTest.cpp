@@ -328,6 +328,72 @@ TEST_F(LowerFunctionTest, SelectLowercase_ExperimentalStringFunctionsDisabled) {
 
 // end LOWER function tests
 
+// begin UPPER function tests
+
+/**
+ * @brief UPPER and nested string function test cases, on the tables of the LOWER ones
+ */
+class UpperFunctionTest : public LowerFunctionTest {};
+
+TEST_F(UpperFunctionTest, UppercaseProjection) {
+  auto result_set = sql("select upper(first_name) from lower_function_test_people;");
+  std::vector<std::vector<ScalarTargetValue>> expected_result_set{
+      {"JOHN"}, {"JOHN"}, {"JOHN"}, {"SUE"}};
+  compare_result_set(expected_result_set, result_set);
+}
+
+TEST_F(UpperFunctionTest, UppercaseFilter) {
+  auto result_set =
+      sql("select first_name, last_name from lower_function_test_people "
+          "where upper(country_code) = 'CA';");
+  std::vector<std::vector<ScalarTargetValue>> expected_result_set{{"JOHN", "Wilson"},
+                                                                  {"Sue", "Smith"}};
+  compare_result_set(expected_result_set, result_set);
+}
+
+TEST_F(UpperFunctionTest, SelectUppercaseLiteral) {
+  auto result_set =
+      sql("select first_name, upper('SMiTH') from lower_function_test_people;");
+  std::vector<std::vector<ScalarTargetValue>> expected_result_set{
+      {"JOHN", "SMITH"}, {"John", "SMITH"}, {"JOHN", "SMITH"}, {"Sue", "SMITH"}};
+  compare_result_set(expected_result_set, result_set);
+}
+
+TEST_F(UpperFunctionTest, NestedCaseConversionsGroupBy) {
+  auto result_set =
+      sql("select lower(upper(first_name)), count(*) from lower_function_test_people "
+          "group by lower(upper(first_name)) order by 1;");
+  std::vector<std::vector<ScalarTargetValue>> expected_result_set{{"john", int64_t(3)},
+                                                                  {"sue", int64_t(1)}};
+  compare_result_set(expected_result_set, result_set);
+}
+
+TEST_F(UpperFunctionTest, LengthOfEncodedColumns) {
+  auto result_set =
+      sql("select length(first_name), char_length(upper(country_code)) "
+          "from lower_function_test_people;");
+  std::vector<std::vector<ScalarTargetValue>> expected_result_set{
+      {int64_t(4), int64_t(2)},
+      {int64_t(4), int64_t(2)},
+      {int64_t(4), int64_t(2)},
+      {int64_t(3), int64_t(2)}};
+  compare_result_set(expected_result_set, result_set);
+}
+
+TEST_F(UpperFunctionTest, SelectUppercase_ExperimentalStringFunctionsDisabled) {
+  g_enable_experimental_string_functions = false;
+
+  try {
+    sql("select upper(first_name) from lower_function_test_people;");
+    FAIL() << "An exception should have been thrown for this test case";
+  } catch (const std::exception& e) {
+    ASSERT_STREQ("Function UPPER(TEXT) not supported.", e.what());
+    g_enable_experimental_string_functions = true;
+  }
+}
+
+// end UPPER function tests
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
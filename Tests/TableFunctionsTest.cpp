@@ -20,6 +20,7 @@
 
 #include "QueryEngine/ResultSet.h"
 #include "QueryRunner/QueryRunner.h"
+#include "Shared/scope.h"
 
 #ifndef BASE_PATH
 #define BASE_PATH "./tmp"
@@ -28,6 +29,7 @@
 using QR = QueryRunner::QueryRunner;
 
 extern bool g_enable_table_functions;
+extern size_t g_table_function_min_slice_rows;
 namespace {
 
 inline void run_ddl_statement(const std::string& stmt) {
@@ -178,6 +180,25 @@ TEST_F(RowCopierTableFunction, GroupByInAndOut) {
   }
 }
 
+TEST_F(RowCopierTableFunction, RowParallel) {
+  const auto min_slice_rows = g_table_function_min_slice_rows;
+  ScopeGuard reset_min_slice_rows = [min_slice_rows] {
+    g_table_function_min_slice_rows = min_slice_rows;
+  };
+  // split the input into several slices, the last one shorter than the others
+  g_table_function_min_slice_rows = 2;
+  const auto rows = run_multiple_agg(
+      "SELECT d, count(*) FROM TABLE(row_copier(cursor(SELECT d FROM tf_test), 3)) "
+      "GROUP BY d ORDER BY d;",
+      ExecutorDeviceType::CPU);
+  ASSERT_EQ(rows->rowCount(), size_t(5));
+  for (size_t i = 0; i < 5; i++) {
+    auto crt_row = rows->getNextRow(false, false);
+    ASSERT_DOUBLE_EQ(TestHelpers::v<double>(crt_row[0]), i * 1.1);
+    ASSERT_EQ(TestHelpers::v<int64_t>(crt_row[1]), int64_t(3));
+  }
+}
+
 TEST_F(RowCopierTableFunction, Unsupported) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
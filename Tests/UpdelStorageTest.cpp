@@ -24,6 +24,7 @@
 #include <boost/range/adaptor/transformed.hpp>
 #include "boost/filesystem.hpp"
 
+#include "Catalog/BackgroundVacuum.h"
 #include "Catalog/Catalog.h"
 #include "Fragmenter/InsertOrderFragmenter.h"
 #include "Import/Importer.h"
@@ -1050,6 +1051,58 @@ TEST_F(UpdateStorageTest, Half_boolean_deleted_rollback) {
       "trips", "deleted", UpdelTestConfig::fixNumRows, 2, true, false));
 }
 
+class BackgroundVacuumTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    run_ddl_statement("DROP TABLE IF EXISTS bg_vacuum;");
+    run_ddl_statement(
+        "CREATE TABLE bg_vacuum (i INTEGER, s TEXT ENCODING NONE) WITH "
+        "(FRAGMENT_SIZE = 10);");
+    for (int i = 0; i < 30; ++i) {
+      run_query("INSERT INTO bg_vacuum VALUES (" + std::to_string(i) + ", 'str" +
+                std::to_string(i) + "');");
+    }
+  }
+
+  void TearDown() override { run_ddl_statement("DROP TABLE IF EXISTS bg_vacuum;"); }
+
+  static std::vector<FragmentDeletedRows> getDeletedRowCounts() {
+    const auto& cat = *QR::get()->getCatalog();
+    const auto td = cat.getMetadataForTable("bg_vacuum");
+    CHECK(td);
+    return cat.getDeletedRowCounts(td);
+  }
+};
+
+TEST_F(BackgroundVacuumTest, VacuumFragmentsAboveThreshold) {
+  // 8 of 10 rows deleted in the first fragment, 1 of 10 in the second one
+  run_query("DELETE FROM bg_vacuum WHERE i < 8 OR i = 15;");
+  auto counts = getDeletedRowCounts();
+  ASSERT_EQ(size_t(3), counts.size());
+  EXPECT_EQ(size_t(8), counts[0].num_deleted_rows);
+  EXPECT_EQ(size_t(1), counts[1].num_deleted_rows);
+  EXPECT_EQ(size_t(0), counts[2].num_deleted_rows);
+
+  BackgroundVacuum background_vacuum(*QR::get()->getCatalog(), 3600000, 0.5, 0);
+  EXPECT_EQ(size_t(1), background_vacuum.vacuum());
+  counts = getDeletedRowCounts();
+  ASSERT_EQ(size_t(3), counts.size());
+  EXPECT_EQ(size_t(2), counts[0].num_rows);
+  EXPECT_EQ(size_t(0), counts[0].num_deleted_rows);
+  EXPECT_EQ(size_t(10), counts[1].num_rows);
+  EXPECT_EQ(size_t(1), counts[1].num_deleted_rows);
+
+  auto rows = run_query(
+      "SELECT COUNT(*), SUM(i), MIN(i), COUNT(s) FROM bg_vacuum WHERE "
+      "s LIKE 'str%';");
+  auto crt_row = rows->getNextRow(true, true);
+  ASSERT_EQ(size_t(4), crt_row.size());
+  EXPECT_EQ(int64_t(21), v<int64_t>(crt_row[0]));
+  EXPECT_EQ(int64_t(435 - 28 - 15), v<int64_t>(crt_row[1]));
+  EXPECT_EQ(int64_t(8), v<int64_t>(crt_row[2]));
+  EXPECT_EQ(int64_t(21), v<int64_t>(crt_row[3]));
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
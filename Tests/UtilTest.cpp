@@ -15,6 +15,7 @@
  */
 
 #include "Shared/Intervals.h"
+#include "Shared/TDigest.h"
 #include "TestHelpers.h"
 #include "Utils/Regexp.h"
 #include "Utils/StringLike.h"
@@ -25,6 +26,9 @@
 #include <array>
 #include <atomic>
 #include <future>
+#include <memory>
+#include <numeric>
+#include <random>
 
 // for (auto const interval : makeIntervals(0, M, n_workers)) {...}
 // iterates over interval={begin,end} pairs which satisfy:
@@ -147,6 +151,46 @@ TEST(Shared, IntervalsInvalidBounds) {
   EXPECT_TRUE(loop_body_executed);
 }
 
+TEST(Shared, TDigest) {
+  constexpr int N = 1000000;
+  std::vector<double> values(N);
+  std::iota(values.begin(), values.end(), 0);
+  std::shuffle(values.begin(), values.end(), std::mt19937_64(0));
+  // digest the values in several parts, the way kernels of a query do, then merge them
+  constexpr int kParts = 7;
+  std::vector<std::unique_ptr<TDigest>> parts;
+  for (int i = 0; i < kParts; ++i) {
+    parts.push_back(std::make_unique<TDigest>(0.5));
+  }
+  for (int i = 0; i < N; ++i) {
+    parts[i % kParts]->add(values[i]);
+  }
+  auto& t_digest = *parts.front();
+  for (int i = 1; i < kParts; ++i) {
+    t_digest.merge(*parts[i]);
+  }
+  EXPECT_EQ(0, t_digest.quantile(0));
+  EXPECT_EQ(N - 1, t_digest.quantile(1));
+  // the estimates are more accurate close to the tails
+  EXPECT_NEAR(N / 2, t_digest.quantile(), 0.01 * N);
+  EXPECT_NEAR(N / 10, t_digest.quantile(0.1), 0.01 * N);
+  EXPECT_NEAR(0.99 * N, t_digest.quantile(0.99), 0.001 * N);
+  EXPECT_NEAR(0.001 * N, t_digest.quantile(0.001), 0.0005 * N);
+}
+
+TEST(Shared, TDigestEmpty) {
+  TDigest t_digest(0.5);
+  EXPECT_TRUE(t_digest.empty());
+  EXPECT_TRUE(std::isnan(t_digest.quantile()));
+  t_digest.add(std::numeric_limits<double>::quiet_NaN());
+  EXPECT_TRUE(t_digest.empty());
+  t_digest.add(42);
+  EXPECT_FALSE(t_digest.empty());
+  EXPECT_EQ(42, t_digest.quantile(0));
+  EXPECT_EQ(42, t_digest.quantile());
+  EXPECT_EQ(42, t_digest.quantile(1));
+}
+
 TEST(Utils, StringLike) {
   ASSERT_TRUE(string_like("abc", 3, "abc", 3, '\\'));
   ASSERT_FALSE(string_like("abc", 3, "ABC", 3, '\\'));
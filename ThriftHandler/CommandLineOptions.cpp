@@ -143,6 +143,12 @@ void CommandLineOptions::fillOptions() {
                               ->implicit_value(true),
                           "Enable the overlaps hash join framework allowing for range "
                           "join (e.g. spatial overlaps) computation using a hash table.");
+  help_desc.add_options()("enable-query-profile",
+                          po::value<bool>(&g_enable_query_profile)
+                              ->default_value(g_enable_query_profile)
+                              ->implicit_value(true),
+                          "Return the execution profile of every query along with its "
+                          "result.");
   help_desc.add_options()("enable-runtime-query-interrupt",
                           po::value<bool>(&enable_runtime_query_interrupt)
                               ->default_value(enable_runtime_query_interrupt)
@@ -247,6 +253,35 @@ void CommandLineOptions::fillOptions() {
       po::value<size_t>(&g_overlaps_max_table_size_bytes)
           ->default_value(g_overlaps_max_table_size_bytes),
       "The maximum size in bytes of the hash table for an overlaps hash join.");
+  help_desc.add_options()(
+      "hash-join-radix-partition-threshold",
+      po::value<size_t>(&g_hash_join_radix_partition_threshold)
+          ->default_value(g_hash_join_radix_partition_threshold),
+      "The size in bytes of a hash table built on CPU above which the rows of the build "
+      "side are radix partitioned first, to fill the table a cache sized part at a time. "
+      "Only the build of perfect hash tables is partitioned, not the probes. 0 disables "
+      "partitioning.");
+  help_desc.add_options()(
+      "enable-join-runtime-filters",
+      po::value<bool>(&g_enable_join_runtime_filters)
+          ->default_value(g_enable_join_runtime_filters)
+          ->implicit_value(true),
+      "Derive the bounds and a Bloom filter of the keys of perfect join hash tables, to "
+      "skip the outer fragments out of the bounds and check the filter before probing.");
+  help_desc.add_options()(
+      "enable-geo-fragment-skipping",
+      po::value<bool>(&g_enable_geo_fragment_skipping)
+          ->default_value(g_enable_geo_fragment_skipping)
+          ->implicit_value(true),
+      "Skip the fragments whose bounding box of a geo column can't satisfy a spatial "
+      "predicate against a literal.");
+  help_desc.add_options()(
+      "reduction-radix-partition-threshold",
+      po::value<size_t>(&g_reduction_radix_partition_threshold)
+          ->default_value(g_reduction_radix_partition_threshold),
+      "The size in bytes of a reduced baseline hash group by buffer above which the "
+      "entries of the partial results are radix partitioned and each partition is "
+      "reduced by a single thread. 0 disables partitioning.");
   if (!dist_v5_) {
     help_desc.add_options()("port,p",
                             po::value<int>(&system_parameters.omnisci_server_port)
@@ -300,6 +335,80 @@ void CommandLineOptions::fillOptions() {
       po::value<bool>(&g_enable_fsi)->default_value(g_enable_fsi)->implicit_value(true),
       "Enable foreign storage interface.");
 #endif  // ENABLE_FSI
+  help_desc.add_options()(
+      "enable-insert-log",
+      po::value<bool>(&g_enable_insert_log)
+          ->default_value(g_enable_insert_log)
+          ->implicit_value(true),
+      "Make inserts and loads durable with a per-database log instead of a table "
+      "checkpoint. Concurrent inserts share the log sync, the log is folded into the "
+      "tables in the background.");
+  help_desc.add_options()(
+      "insert-log-fold-interval-ms",
+      po::value<size_t>(&g_insert_log_fold_interval_ms)
+          ->default_value(g_insert_log_fold_interval_ms),
+      "Interval in milliseconds at which the insert log is folded into the tables.");
+  help_desc.add_options()(
+      "enable-background-vacuum",
+      po::value<bool>(&g_enable_background_vacuum)
+          ->default_value(g_enable_background_vacuum)
+          ->implicit_value(true),
+      "Vacuum deleted rows in the background, one fragment at a time.");
+  help_desc.add_options()(
+      "background-vacuum-interval-ms",
+      po::value<size_t>(&g_background_vacuum_interval_ms)
+          ->default_value(g_background_vacuum_interval_ms),
+      "Interval in milliseconds at which the tables are checked for fragments to "
+      "vacuum.");
+  help_desc.add_options()(
+      "background-vacuum-threshold",
+      po::value<double>(&g_background_vacuum_threshold)
+          ->default_value(g_background_vacuum_threshold),
+      "Fraction of the rows of a fragment which have to be deleted for the background "
+      "vacuum to compact it.");
+  help_desc.add_options()(
+      "background-vacuum-max-mb-per-sec",
+      po::value<size_t>(&g_background_vacuum_max_mb_per_sec)
+          ->default_value(g_background_vacuum_max_mb_per_sec),
+      "Rate in MB per second at which the background vacuum rewrites fragments at most, "
+      "0 for no limit.");
+  help_desc.add_options()(
+      "enable-buffer-pool-warmup",
+      po::value<bool>(&system_parameters.enable_buffer_pool_warmup)
+          ->default_value(system_parameters.enable_buffer_pool_warmup)
+          ->implicit_value(true),
+      "Save the chunks requested most often and most recently from the CPU buffer pool "
+      "at checkpoints and shutdown, and reload them in the background on startup.");
+  help_desc.add_options()(
+      "buffer-pool-warmup-fraction",
+      po::value<double>(&system_parameters.buffer_pool_warmup_fraction)
+          ->default_value(system_parameters.buffer_pool_warmup_fraction),
+      "Fraction of the CPU buffer pool which the buffer pool warm-up fills at most.");
+  help_desc.add_options()(
+      "max-paged-results-per-session",
+      po::value<size_t>(&system_parameters.max_paged_results_per_session)
+          ->default_value(system_parameters.max_paged_results_per_session),
+      "Number of open paged results of a session, the least recently fetched are "
+      "closed beyond it.");
+  help_desc.add_options()(
+      "paged-result-idle-timeout",
+      po::value<size_t>(&system_parameters.paged_result_idle_timeout)
+          ->default_value(system_parameters.paged_result_idle_timeout),
+      "Seconds after which a paged result that isn't fetched from is closed. 0 to keep "
+      "paged results until closed.");
+  help_desc.add_options()(
+      "paged-result-lock-timeout",
+      po::value<size_t>(&system_parameters.paged_result_lock_timeout)
+          ->default_value(system_parameters.paged_result_lock_timeout),
+      "Seconds after which a paged result that isn't fetched from is closed if it holds "
+      "read locks on its tables, which it does when it projects arrays, geo or none "
+      "encoded strings. 0 to apply paged-result-idle-timeout to it as well.");
+  help_desc.add_options()(
+      "paged-results-max-mem-bytes",
+      po::value<size_t>(&system_parameters.paged_results_max_mem_bytes)
+          ->default_value(system_parameters.paged_results_max_mem_bytes),
+      "Memory held by all the open paged results, the least recently fetched are closed "
+      "beyond it.");
   help_desc.add_options()(
       "enable-interoperability",
       po::value<bool>(&g_enable_interop)
@@ -385,6 +494,12 @@ void CommandLineOptions::fillAdvancedOptions() {
                                    ->implicit_value(true),
                                "Enables/disables a more optimized columnarization method "
                                "for intermediate steps in multi-step queries.");
+  developer_desc.add_options()("enable-top-n-pruning",
+                               po::value<bool>(&g_enable_top_n_pruning)
+                                   ->default_value(g_enable_top_n_pruning)
+                                   ->implicit_value(true),
+                               "Prune the groups which can't make the top n of a "
+                               "grouped query before reducing its partial results.");
   developer_desc.add_options()(
       "offset-device-by-table-id",
       po::value<bool>(&g_use_table_device_offset)
@@ -402,6 +517,11 @@ void CommandLineOptions::fillAdvancedOptions() {
                                    ->default_value(g_enable_table_functions)
                                    ->implicit_value(true),
                                "Enable experimental table functions support.");
+  developer_desc.add_options()(
+      "table-function-min-slice-rows",
+      po::value<size_t>(&g_table_function_min_slice_rows)
+          ->default_value(g_table_function_min_slice_rows),
+      "Minimum number of input rows per invocation of a row parallel table function.");
   developer_desc.add_options()(
       "jit-debug-ir",
       po::value<bool>(&jit_debug)->default_value(jit_debug)->implicit_value(true),
@@ -621,6 +741,10 @@ void CommandLineOptions::validate() {
     throw std::runtime_error("File containing DB queries " + db_query_file +
                              " does not exist.");
   }
+  if (system_parameters.buffer_pool_warmup_fraction < 0 ||
+      system_parameters.buffer_pool_warmup_fraction > 1) {
+    throw std::runtime_error("buffer-pool-warmup-fraction must be between 0 and 1.");
+  }
   const auto db_file =
       boost::filesystem::path(base_path) / "mapd_catalogs" / OMNISCI_SYSTEM_CATALOG;
   if (!boost::filesystem::exists(db_file)) {
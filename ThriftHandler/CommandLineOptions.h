@@ -155,15 +155,22 @@ extern bool g_enable_columnar_output;
 extern bool g_enable_overlaps_hashjoin;
 extern bool g_enable_hashjoin_many_to_many;
 extern size_t g_overlaps_max_table_size_bytes;
+extern size_t g_hash_join_radix_partition_threshold;
+extern bool g_enable_join_runtime_filters;
+extern bool g_enable_geo_fragment_skipping;
 extern bool g_strip_join_covered_quals;
 extern size_t g_constrained_by_in_threshold;
 extern size_t g_big_group_threshold;
+extern size_t g_reduction_radix_partition_threshold;
 extern bool g_enable_window_functions;
 extern bool g_enable_table_functions;
+extern size_t g_table_function_min_slice_rows;
 extern size_t g_max_memory_allocation_size;
 extern double g_bump_allocator_step_reduction;
 extern bool g_enable_direct_columnarization;
+extern bool g_enable_top_n_pruning;
 extern bool g_enable_runtime_query_interrupt;
+extern bool g_enable_query_profile;
 extern unsigned g_runtime_query_interrupt_frequency;
 extern size_t g_gpu_smem_threshold;
 extern bool g_enable_smem_non_grouped_agg;
@@ -180,6 +187,12 @@ extern size_t g_min_memory_allocation_size;
 extern bool g_enable_experimental_string_functions;
 extern bool g_enable_table_functions;
 extern bool g_enable_fsi;
+extern bool g_enable_insert_log;
+extern size_t g_insert_log_fold_interval_ms;
+extern bool g_enable_background_vacuum;
+extern size_t g_background_vacuum_interval_ms;
+extern double g_background_vacuum_threshold;
+extern size_t g_background_vacuum_max_mb_per_sec;
 extern bool g_enable_interop;
 extern bool g_enable_union;
 extern bool g_use_tbb_pool;
@@ -58,6 +58,7 @@
 #include "QueryEngine/JoinFilterPushDown.h"
 #include "QueryEngine/JsonAccessors.h"
 #include "QueryEngine/QueryDispatchQueue.h"
+#include "QueryEngine/ResultSetBufferAccessors.h"
 #include "QueryEngine/TableFunctions/TableFunctionsFactory.h"
 #include "QueryEngine/TableOptimizer.h"
 #include "QueryEngine/ThriftSerializers.h"
@@ -69,6 +70,7 @@
 #include "Shared/mapd_shared_mutex.h"
 #include "Shared/measure.h"
 #include "Shared/scope.h"
+#include "Shared/thread_count.h"
 
 #include <fcntl.h>
 #include <picosha2.h>
@@ -172,6 +174,8 @@ SessionMap::iterator DBHandler::get_session_it_unsafe(
 extern std::unique_ptr<std::string> g_libgeos_so_filename;
 #endif
 
+extern double g_background_vacuum_threshold;
+
 DBHandler::DBHandler(const std::vector<LeafHostInfo>& db_leaves,
                      const std::vector<LeafHostInfo>& string_leaves,
                      const std::string& base_data_path,
@@ -374,9 +378,24 @@ DBHandler::DBHandler(const std::vector<LeafHostInfo>& db_leaves,
     LOG(INFO) << "Overriding default geos library with '" + *g_libgeos_so_filename + "'";
   }
 #endif
+
+  if (system_parameters_.paged_result_idle_timeout > 0 ||
+      system_parameters_.paged_result_lock_timeout > 0) {
+    paged_results_eviction_thread_ =
+        std::thread([this] { evictPagedResultsPeriodically(); });
+  }
 }
 
-DBHandler::~DBHandler() {}
+DBHandler::~DBHandler() {
+  {
+    std::lock_guard<std::mutex> paged_results_lock(paged_results_mutex_);
+    stop_paged_results_eviction_ = true;
+  }
+  paged_results_cv_.notify_all();
+  if (paged_results_eviction_thread_.joinable()) {
+    paged_results_eviction_thread_.join();
+  }
+}
 
 void DBHandler::parser_with_error_handler(
     const std::string& query_str,
@@ -585,6 +604,17 @@ void DBHandler::disconnect_impl(const SessionMap::iterator& session_it,
   sessions_.erase(session_it);
   write_lock.unlock();
 
+  {
+    std::lock_guard<std::mutex> paged_results_lock(paged_results_mutex_);
+    for (auto it = paged_results_.begin(); it != paged_results_.end();) {
+      if (it->second->session_id == session_id) {
+        it = paged_results_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
   if (render_handler_) {
     render_handler_->disconnect(session_id);
   }
@@ -1152,6 +1182,216 @@ void DBHandler::sql_execute_df(TDataFrame& _return,
       "Exception: DDL or update DML are not unsupported by current thrift API");
 }
 
+void DBHandler::sql_execute_paged(TQueryResult& _return,
+                                  const TSessionId& session,
+                                  const std::string& query_str,
+                                  const bool column_format,
+                                  const std::string& nonce,
+                                  const int32_t page_size) {
+  auto session_ptr = get_session_ptr(session);
+  auto query_state = create_query_state(session_ptr, query_str);
+  auto stdlog = STDLOG(session_ptr, query_state);
+  stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
+
+  if (page_size <= 0) {
+    THROW_MAPD_EXCEPTION("Exception: page_size must be a positive number of rows");
+  }
+  if (leaf_aggregator_.leafCount() > 0) {
+    THROW_MAPD_EXCEPTION(
+        "Exception: paged results are not supported in distributed mode");
+  }
+
+  _return.total_time_ms = measure<>::execution([&]() {
+    auto paged_result = std::make_shared<PagedResult>();
+    paged_result->session_id = session_ptr->get_session_id();
+    paged_result->query_str = query_str;
+    paged_result->column_format = column_format;
+    {
+      mapd_shared_lock<mapd_shared_mutex> executeReadLock(
+          *legacylockmgr::LockMgr<mapd_shared_mutex, bool>::getMutex(
+              legacylockmgr::ExecutorOuterLock, true));
+      try {
+        ParserWrapper pw{query_str};
+        if (pw.is_ddl || pw.is_update_dml || pw.is_ctas || pw.is_itas || pw.is_copy ||
+            pw.is_copy_to || pw.getExplainType() != ParserWrapper::ExplainType::None) {
+          throw std::runtime_error("only SELECT queries can be paged");
+        }
+        std::string query_ra;
+        _return.execution_time_ms += measure<>::execution([&]() {
+          TPlanResult result;
+          std::tie(result, paged_result->table_locks) =
+              parse_to_ra(query_state->createQueryStateProxy(),
+                          query_str,
+                          {},
+                          true,
+                          system_parameters_);
+          query_ra = result.plan_result;
+        });
+        const auto result = execute_rel_alg_paged(
+            _return, query_ra, query_state->createQueryStateProxy(), *session_ptr);
+        paged_result->targets = result.getTargetsMeta();
+        paged_result->rows = result.getRows();
+        // the rows are materialized, only varlen values still point into the chunks
+        if (std::none_of(paged_result->targets.begin(),
+                         paged_result->targets.end(),
+                         [](const TargetMetaInfo& target) {
+                           return target.get_type_info().is_varlen();
+                         })) {
+          paged_result->table_locks.clear();
+        }
+      } catch (std::exception& e) {
+        THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
+      }
+    }
+    const auto& rows = *paged_result->rows;
+    // the lazily fetched columns and varlen payloads aren't counted
+    paged_result->num_bytes =
+        rows.getStorage() ? rows.getQueryMemDesc().getRowSize() * rows.entryCount() : 0;
+    paged_result->last_access = std::chrono::steady_clock::now();
+    const auto result_handle = generate_random_string(32);
+    {
+      std::lock_guard<std::mutex> paged_results_lock(paged_results_mutex_);
+      evictPagedResults(paged_result->session_id, paged_result->num_bytes);
+      paged_results_.emplace(result_handle, paged_result);
+    }
+    fetch_page(_return,
+               query_state->createQueryStateProxy(),
+               result_handle,
+               *paged_result,
+               page_size);
+    _return.nonce = nonce;
+  });
+  stdlog.appendNameValuePairs("execution_time_ms",
+                              _return.execution_time_ms,
+                              "total_time_ms",
+                              stdlog.duration<std::chrono::milliseconds>());
+}
+
+void DBHandler::fetch_next(TQueryResult& _return,
+                           const TSessionId& session,
+                           const std::string& result_handle,
+                           const int32_t n) {
+  auto session_ptr = get_session_ptr(session);
+  std::shared_ptr<PagedResult> paged_result;
+  {
+    std::lock_guard<std::mutex> paged_results_lock(paged_results_mutex_);
+    const auto it = paged_results_.find(result_handle);
+    if (it == paged_results_.end() ||
+        it->second->session_id != session_ptr->get_session_id()) {
+      THROW_MAPD_EXCEPTION("Exception: invalid, exhausted or evicted result handle");
+    }
+    paged_result = it->second;
+    paged_result->last_access = std::chrono::steady_clock::now();
+  }
+  auto query_state = create_query_state(session_ptr, paged_result->query_str);
+  auto stdlog = STDLOG(session_ptr, query_state);
+  if (n <= 0) {
+    THROW_MAPD_EXCEPTION("Exception: the number of rows to fetch must be positive");
+  }
+  _return.total_time_ms = measure<>::execution([&]() {
+    fetch_page(
+        _return, query_state->createQueryStateProxy(), result_handle, *paged_result, n);
+  });
+}
+
+void DBHandler::close_result(const TSessionId& session,
+                             const std::string& result_handle) {
+  auto stdlog = STDLOG(get_session_ptr(session));
+  const auto session_id = stdlog.getConstSessionInfo()->get_session_id();
+  std::lock_guard<std::mutex> paged_results_lock(paged_results_mutex_);
+  const auto it = paged_results_.find(result_handle);
+  if (it != paged_results_.end() && it->second->session_id == session_id) {
+    paged_results_.erase(it);
+  }
+}
+
+void DBHandler::evictPagedResults(const std::string& session_id,
+                                  const size_t new_result_bytes) {
+  using PagedResultEntry = std::pair<const std::string, std::shared_ptr<PagedResult>>;
+  const auto now = std::chrono::steady_clock::now();
+  size_t session_results{0};
+  size_t total_bytes{0};
+  std::vector<const PagedResultEntry*> entries;
+  for (auto it = paged_results_.begin(); it != paged_results_.end();) {
+    const auto timeout =
+        it->second->table_locks.empty() || !system_parameters_.paged_result_lock_timeout
+            ? system_parameters_.paged_result_idle_timeout
+            : system_parameters_.paged_result_lock_timeout;
+    if (timeout > 0 && now - it->second->last_access > std::chrono::seconds(timeout)) {
+      it = paged_results_.erase(it);
+      continue;
+    }
+    session_results += it->second->session_id == session_id ? 1 : 0;
+    total_bytes += it->second->num_bytes;
+    entries.push_back(&*it);
+    ++it;
+  }
+  if (session_id.empty()) {
+    return;
+  }
+  // the least recently fetched first
+  std::sort(entries.begin(),
+            entries.end(),
+            [](const PagedResultEntry* lhs, const PagedResultEntry* rhs) {
+              return lhs->second->last_access < rhs->second->last_access;
+            });
+  std::vector<std::string> evicted_handles;
+  for (const auto entry : entries) {
+    const bool session_full =
+        entry->second->session_id == session_id &&
+        session_results >= system_parameters_.max_paged_results_per_session;
+    const bool memory_full =
+        total_bytes + new_result_bytes > system_parameters_.paged_results_max_mem_bytes;
+    if (!session_full && !memory_full) {
+      continue;
+    }
+    session_results -= entry->second->session_id == session_id ? 1 : 0;
+    total_bytes -= entry->second->num_bytes;
+    evicted_handles.push_back(entry->first);
+  }
+  for (const auto& result_handle : evicted_handles) {
+    paged_results_.erase(result_handle);
+  }
+}
+
+void DBHandler::evictPagedResultsPeriodically() {
+  std::unique_lock<std::mutex> paged_results_lock(paged_results_mutex_);
+  while (!stop_paged_results_eviction_) {
+    evictPagedResults("", 0);
+    paged_results_cv_.wait_for(paged_results_lock, std::chrono::seconds(1));
+  }
+}
+
+void DBHandler::fetch_page(TQueryResult& _return,
+                           QueryStateProxy query_state_proxy,
+                           const std::string& result_handle,
+                           PagedResult& paged_result,
+                           const int32_t n) {
+  std::lock_guard<std::mutex> fetch_lock(paged_result.fetch_mutex);
+  CHECK(paged_result.rows);
+  // rows are fetched through the result set cursor, every page continues the previous
+  convert_rows(_return,
+               query_state_proxy,
+               paged_result.targets,
+               *paged_result.rows,
+               paged_result.column_format,
+               n,
+               -1);
+  const auto& row_set = _return.row_set;
+  const size_t fetched = paged_result.column_format
+                             ? (row_set.columns.empty()
+                                    ? size_t(0)
+                                    : row_set.columns.front().nulls.size())
+                             : row_set.rows.size();
+  if (fetched == static_cast<size_t>(n)) {
+    _return.result_handle = result_handle;
+    return;
+  }
+  // a short page means the result set is exhausted
+  std::lock_guard<std::mutex> paged_results_lock(paged_results_mutex_);
+  paged_results_.erase(result_handle);
+}
+
 void DBHandler::sql_execute_gdf(TDataFrame& _return,
                                 const TSessionId& session,
                                 const std::string& query_str,
@@ -2212,6 +2452,53 @@ void DBHandler::get_tables_meta(std::vector<TTableMeta>& _return,
   }
 }
 
+void DBHandler::get_deleted_rows(std::vector<TTableDeletedRows>& _return,
+                                 const TSessionId& session) {
+  auto stdlog = STDLOG(get_session_ptr(session));
+  stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
+  auto session_ptr = stdlog.getConstSessionInfo();
+  const auto& cat = session_ptr->getCatalog();
+  try {
+    for (const auto td : cat.getAllTableMetadata()) {
+      if (td->shard >= 0 || td->isView || !td->hasDeletedCol ||
+          !hasTableAccessPrivileges(td, *session_ptr)) {
+        continue;
+      }
+      const auto td_with_lock =
+          lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+              cat, td->tableName);
+      const auto data_lock =
+          lockmgr::TableDataLockMgr::getReadLockForTable(cat, td->tableName);
+      TTableDeletedRows table_deleted_rows;
+      table_deleted_rows.table_name = td->tableName;
+      table_deleted_rows.num_rows = 0;
+      table_deleted_rows.num_deleted_rows = 0;
+      table_deleted_rows.num_fragments = 0;
+      table_deleted_rows.num_fragments_to_vacuum = 0;
+      for (const auto physical_td : cat.getPhysicalTablesDescriptors(td)) {
+        for (const auto& counts : cat.getDeletedRowCounts(physical_td)) {
+          table_deleted_rows.num_rows += counts.num_rows;
+          table_deleted_rows.num_deleted_rows += counts.num_deleted_rows;
+          ++table_deleted_rows.num_fragments;
+          if (counts.num_deleted_rows &&
+              counts.num_deleted_rows >=
+                  g_background_vacuum_threshold * counts.num_rows) {
+            ++table_deleted_rows.num_fragments_to_vacuum;
+          }
+        }
+      }
+      table_deleted_rows.deleted_ratio =
+          table_deleted_rows.num_rows ? static_cast<double>(
+                                            table_deleted_rows.num_deleted_rows) /
+                                            table_deleted_rows.num_rows
+                                      : 0;
+      _return.push_back(table_deleted_rows);
+    }
+  } catch (const std::exception& e) {
+    THROW_MAPD_EXCEPTION(e.what());
+  }
+}
+
 void DBHandler::get_users(std::vector<std::string>& user_names,
                           const TSessionId& session) {
   auto stdlog = STDLOG(get_session_ptr(session));
@@ -2616,40 +2903,76 @@ void DBHandler::load_table_binary_arrow(const TSessionId& session,
   check_read_only("load_table_binary_arrow");
 
   RecordBatchVector batches = loadArrowStream(arrow_stream);
-
-  // Assuming have one batch for now
-  if (batches.size() != 1) {
-    THROW_MAPD_EXCEPTION("Expected a single Arrow record batch. Import aborted");
+  if (batches.empty()) {
+    THROW_MAPD_EXCEPTION("Expected at least one Arrow record batch. Import aborted");
+  }
+  const auto num_columns = batches.front()->num_columns();
+  size_t numRows = 0;
+  for (const auto& batch : batches) {
+    if (batch->num_columns() != num_columns) {
+      THROW_MAPD_EXCEPTION(
+          "load_table_binary_arrow: Inconsistent number of columns in the Arrow record "
+          "batches, expecting " +
+          std::to_string(num_columns) + " columns, got " +
+          std::to_string(batch->num_columns()) + ". Import aborted");
+    }
+    numRows += batch->num_rows();
   }
-
-  std::shared_ptr<arrow::RecordBatch> batch = batches[0];
 
   std::unique_ptr<Importer_NS::Loader> loader;
   std::vector<std::unique_ptr<Importer_NS::TypedImportBuffer>> import_buffers;
   auto read_lock = prepare_columnar_loader(*session_ptr,
                                            table_name,
-                                           static_cast<size_t>(batch->num_columns()),
+                                           static_cast<size_t>(num_columns),
                                            &loader,
                                            &import_buffers);
   auto insert_data_lock = lockmgr::InsertDataLockMgr::getWriteLockForTable(
       session_ptr->getCatalog(), table_name);
 
-  size_t numRows = 0;
-  size_t col_idx = 0;
-  try {
-    for (auto cd : loader->get_column_descs()) {
-      auto& array = *batch->column(col_idx);
-      Importer_NS::ArraySliceRange row_slice(0, array.length());
-      numRows =
-          import_buffers[col_idx]->add_arrow_values(cd, array, true, row_slice, nullptr);
-      col_idx++;
+  // Columns are converted in parallel, each appending the column of every batch to its
+  // import buffer in turn.
+  const std::vector<const ColumnDescriptor*> col_descs(
+      loader->get_column_descs().begin(), loader->get_column_descs().end());
+  std::vector<std::exception_ptr> column_errors(col_descs.size());
+  const auto convert_column = [&](const size_t col_idx) {
+    try {
+      for (const auto& batch : batches) {
+        auto& array = *batch->column(col_idx);
+        Importer_NS::ArraySliceRange row_slice(0, array.length());
+        import_buffers[col_idx]->add_arrow_values(
+            col_descs[col_idx], array, true, row_slice, nullptr);
+      }
+    } catch (...) {
+      column_errors[col_idx] = std::current_exception();
+    }
+  };
+  const size_t thread_count =
+      std::min(col_descs.size(), static_cast<size_t>(cpu_threads()));
+  std::vector<std::future<void>> conversion_threads;
+  for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    conversion_threads.push_back(std::async(std::launch::async, [&, thread_idx] {
+      for (size_t col_idx = thread_idx; col_idx < col_descs.size();
+           col_idx += thread_count) {
+        convert_column(col_idx);
+      }
+    }));
+  }
+  for (auto& conversion_thread : conversion_threads) {
+    conversion_thread.get();
+  }
+  for (size_t col_idx = 0; col_idx < column_errors.size(); ++col_idx) {
+    if (!column_errors[col_idx]) {
+      continue;
+    }
+    try {
+      std::rethrow_exception(column_errors[col_idx]);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Input exception thrown: " << e.what()
+                 << ". Issue at column : " << (col_idx + 1) << ". Import aborted";
+      // TODO(tmostak): Go row-wise on binary columnar import to be consistent with our
+      // other import paths
+      THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
     }
-  } catch (const std::exception& e) {
-    LOG(ERROR) << "Input exception thrown: " << e.what()
-               << ". Issue at column : " << (col_idx + 1) << ". Import aborted";
-    // TODO(tmostak): Go row-wise on binary columnar import to be consistent with our
-    // other import paths
-    THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
   }
   loader->load(import_buffers, numRows);
 }
@@ -4374,6 +4697,126 @@ void DBHandler::import_table_status(TImportStatus& _return,
   _return.rows_rejected = is.rows_rejected;
 }
 
+void DBHandler::start_stream_ingestion(const TSessionId& session,
+                                       const std::string& table_name,
+                                       const std::string& source_path_in,
+                                       const TCopyParams& cp,
+                                       const int64_t flush_row_count,
+                                       const int64_t flush_interval_ms) {
+  try {
+    auto stdlog = STDLOG(get_session_ptr(session), "table_name", table_name);
+    stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
+    auto session_ptr = stdlog.getConstSessionInfo();
+    check_read_only("start_stream_ingestion");
+    if (leaf_aggregator_.leafCount() > 0) {
+      THROW_MAPD_EXCEPTION("Stream ingestion is not supported in distributed mode");
+    }
+    LOG(INFO) << "start_stream_ingestion " << table_name << " from " << source_path_in;
+    auto& cat = session_ptr->getCatalog();
+    int table_id;
+    {
+      const auto td_with_lock =
+          lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+              cat, table_name);
+      const auto td = td_with_lock();
+      CHECK(td);
+      table_id = td->tableId;
+    }
+    check_table_load_privileges(*session_ptr, table_name);
+
+    auto source_path = boost::filesystem::path(source_path_in);
+    if (!source_path.is_absolute()) {
+      source_path = import_path_ / picosha2::hash256_hex_string(session) /
+                    source_path.filename();
+    }
+    if (!boost::filesystem::exists(source_path)) {
+      THROW_MAPD_EXCEPTION("File does not exist: " + source_path.string());
+    }
+    Importer_NS::StreamIngestionParams params;
+    params.copy_params = thrift_to_copyparams(cp);
+    if (params.copy_params.delimiter == '\0') {
+      params.copy_params.delimiter = ',';
+      if (boost::filesystem::extension(source_path) == ".tsv") {
+        params.copy_params.delimiter = '\t';
+      }
+    }
+    if (flush_row_count > 0) {
+      params.flush_row_count = flush_row_count;
+    }
+    if (flush_interval_ms > 0) {
+      params.flush_interval = std::chrono::milliseconds(flush_interval_ms);
+    }
+
+    const auto key = std::make_pair(cat.getCurrentDB().dbId, table_id);
+    std::lock_guard<std::mutex> lock(stream_ingestors_mutex_);
+    auto& ingestor = stream_ingestors_[key];
+    if (ingestor && ingestor->getStatus().running) {
+      THROW_MAPD_EXCEPTION("A stream is already being ingested into table " +
+                           table_name);
+    }
+    ingestor.reset();
+    ingestor = std::make_unique<Importer_NS::StreamIngestor>(
+        session_ptr->get_catalog_ptr(),
+        table_name,
+        std::make_unique<Importer_NS::FileStreamSource>(source_path.string(),
+                                                        params.copy_params.line_delim),
+        params);
+  } catch (const TOmniSciException&) {
+    throw;
+  } catch (const std::exception& e) {
+    THROW_MAPD_EXCEPTION("Exception: " + std::string(e.what()));
+  }
+}
+
+void DBHandler::stop_stream_ingestion(const TSessionId& session,
+                                      const std::string& table_name) {
+  auto stdlog = STDLOG(get_session_ptr(session), "table_name", table_name);
+  stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
+  auto session_ptr = stdlog.getConstSessionInfo();
+  check_table_load_privileges(*session_ptr, table_name);
+  const auto& cat = session_ptr->getCatalog();
+  const auto td = cat.getMetadataForTable(table_name, false);
+  if (!td) {
+    THROW_MAPD_EXCEPTION("Table " + table_name + " does not exist.");
+  }
+  std::unique_ptr<Importer_NS::StreamIngestor> ingestor;
+  {
+    std::lock_guard<std::mutex> lock(stream_ingestors_mutex_);
+    const auto it = stream_ingestors_.find({cat.getCurrentDB().dbId, td->tableId});
+    if (it == stream_ingestors_.end()) {
+      THROW_MAPD_EXCEPTION("No stream is being ingested into table " + table_name);
+    }
+    ingestor = std::move(it->second);
+    stream_ingestors_.erase(it);
+  }
+  // commits the buffered rows, outside of the map lock
+  ingestor->stop();
+}
+
+void DBHandler::get_stream_ingestion_status(TStreamIngestionStatus& _return,
+                                            const TSessionId& session,
+                                            const std::string& table_name) {
+  auto stdlog = STDLOG(get_session_ptr(session), "table_name", table_name);
+  stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
+  auto session_ptr = stdlog.getConstSessionInfo();
+  const auto& cat = session_ptr->getCatalog();
+  const auto td = cat.getMetadataForTable(table_name, false);
+  if (!td) {
+    THROW_MAPD_EXCEPTION("Table " + table_name + " does not exist.");
+  }
+  std::lock_guard<std::mutex> lock(stream_ingestors_mutex_);
+  const auto it = stream_ingestors_.find({cat.getCurrentDB().dbId, td->tableId});
+  if (it == stream_ingestors_.end()) {
+    THROW_MAPD_EXCEPTION("No stream is being ingested into table " + table_name);
+  }
+  const auto status = it->second->getStatus();
+  _return.running = status.running;
+  _return.rows_loaded = status.rows_loaded;
+  _return.rows_rejected = status.rows_rejected;
+  _return.committed_offset = status.committed_offset;
+  _return.error = status.error;
+}
+
 void DBHandler::get_first_geo_file_in_archive(std::string& _return,
                                               const TSessionId& session,
                                               const std::string& archive_path_in,
@@ -4672,6 +5115,45 @@ void DBHandler::set_execution_mode_nolock(Catalog_Namespace::SessionInfo* sessio
   }
 }
 
+namespace {
+
+TQueryProfile convert_query_profile(const QueryProfile& query_profile) {
+  TQueryProfile profile;
+  for (const auto& step : query_profile.getSteps()) {
+    TQueryStepProfile step_profile;
+    step_profile.node_id = step.node_id;
+    step_profile.node_name = step.node_name;
+    step_profile.input_rows = step.input_rows;
+    step_profile.output_rows = step.output_rows;
+    step_profile.fragments_scanned = step.fragments_scanned;
+    step_profile.fragments_skipped = step.fragments_skipped;
+    step_profile.cpu_bytes_fetched = step.cpu_bytes_fetched;
+    step_profile.gpu_bytes_fetched = step.gpu_bytes_fetched;
+    step_profile.hash_tables = step.hash_tables;
+    step_profile.hash_table_cache_hits = step.hash_table_cache_hits;
+    step_profile.hash_table_build_time_us = step.hash_table_build_time_us;
+    step_profile.compilation_time_us = step.compilation_time_us;
+    step_profile.code_cache_hits = step.code_cache_hits;
+    step_profile.code_cache_misses = step.code_cache_misses;
+    step_profile.execution_time_us = step.execution_time_us;
+    for (const auto& kernel : step.kernels) {
+      TKernelProfile kernel_profile;
+      kernel_profile.device_type = kernel.device_type == ExecutorDeviceType::GPU
+                                       ? TDeviceType::GPU
+                                       : TDeviceType::CPU;
+      kernel_profile.device_id = kernel.device_id;
+      kernel_profile.fragment_ids.assign(kernel.fragment_ids.begin(),
+                                         kernel.fragment_ids.end());
+      kernel_profile.duration_us = kernel.duration_us;
+      step_profile.kernels.push_back(kernel_profile);
+    }
+    profile.steps.push_back(step_profile);
+  }
+  return profile;
+}
+
+}  // namespace
+
 std::vector<PushedDownFilterInfo> DBHandler::execute_rel_alg(
     TQueryResult& _return,
     QueryStateProxy query_state_proxy,
@@ -4722,6 +5204,11 @@ std::vector<PushedDownFilterInfo> DBHandler::execute_rel_alg(
                              cat,
                              query_ra,
                              query_state_proxy.getQueryState().shared_from_this());
+  std::shared_ptr<QueryProfile> query_profile;
+  if (explain_info.explain_analyze || (g_enable_query_profile && !just_validate)) {
+    query_profile = std::make_shared<QueryProfile>();
+    ra_executor.setQueryProfile(query_profile);
+  }
   ExecutionResult result{std::make_shared<ResultSet>(std::vector<TargetInfo>{},
                                                      ExecutorDeviceType::CPU,
                                                      QueryMemoryDescriptor(),
@@ -4738,8 +5225,13 @@ std::vector<PushedDownFilterInfo> DBHandler::execute_rel_alg(
   if (!filter_push_down_info.empty()) {
     return filter_push_down_info;
   }
+  if (query_profile) {
+    _return.__set_profile(convert_query_profile(*query_profile));
+  }
   if (explain_info.justExplain()) {
     convert_explain(_return, *result.getRows(), column_format);
+  } else if (explain_info.explain_analyze) {
+    convert_explain(_return, ResultSet(query_profile->toString()), column_format);
   } else if (!explain_info.justCalciteExplain()) {
     convert_rows(_return,
                  timer.createQueryStateProxy(),
@@ -4826,6 +5318,57 @@ void DBHandler::execute_rel_alg_df(TDataFrame& _return,
   _return.df_size = arrow_result.df_size;
 }
 
+ExecutionResult DBHandler::execute_rel_alg_paged(
+    TQueryResult& _return,
+    const std::string& query_ra,
+    QueryStateProxy query_state_proxy,
+    const Catalog_Namespace::SessionInfo& session_info) const {
+  query_state::Timer timer = query_state_proxy.createTimer(__func__);
+  const auto& cat = session_info.getCatalog();
+  // the rows are fetched from the tables up front, such that the result doesn't need
+  // them between pages
+  CompilationOptions co = {session_info.get_executor_device_type(),
+                           /*hoist_literals=*/true,
+                           ExecutorOptLevel::Default,
+                           g_enable_dynamic_watchdog,
+                           /*allow_lazy_fetch=*/false,
+                           /*add_delete_column=*/true,
+                           ExecutorExplainType::Default,
+                           intel_jit_profile_};
+  ExecutionOptions eo = {g_enable_columnar_output,
+                         allow_multifrag_,
+                         false,
+                         allow_loop_joins_,
+                         g_enable_watchdog,
+                         jit_debug_,
+                         false,
+                         g_enable_dynamic_watchdog,
+                         g_dynamic_watchdog_time_limit,
+                         false,
+                         false,
+                         system_parameters_.gpu_input_mem_limit,
+                         g_enable_runtime_query_interrupt,
+                         g_runtime_query_interrupt_frequency};
+  auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID,
+                                        jit_debug_ ? "/tmp" : "",
+                                        jit_debug_ ? "mapdquery" : "",
+                                        system_parameters_);
+  RelAlgExecutor ra_executor(executor.get(),
+                             cat,
+                             query_ra,
+                             query_state_proxy.getQueryState().shared_from_this());
+  ExecutionResult result{std::make_shared<ResultSet>(std::vector<TargetInfo>{},
+                                                     ExecutorDeviceType::CPU,
+                                                     QueryMemoryDescriptor(),
+                                                     nullptr,
+                                                     nullptr),
+                         {}};
+  _return.execution_time_ms += measure<>::execution(
+      [&]() { result = ra_executor.executeRelAlgQuery(co, eo, false, nullptr); });
+  _return.execution_time_ms -= result.getRows()->getQueueTime();
+  return result;
+}
+
 std::vector<TargetMetaInfo> DBHandler::getTargetMetaInfo(
     const std::vector<std::shared_ptr<Analyzer::TargetEntry>>& targets) const {
   std::vector<TargetMetaInfo> result;
@@ -4897,6 +5440,184 @@ TRowDescriptor DBHandler::convert_target_metainfo(
   return row_desc;
 }
 
+namespace {
+
+// Moves the values converted for a segment of rows to the end of a result column.
+void append_thrift_column(TColumn& column, TColumn& segment) {
+  auto move_append = [](auto& values, auto& segment_values) {
+    if (values.empty()) {
+      values = std::move(segment_values);
+      return;
+    }
+    values.insert(values.end(),
+                  std::make_move_iterator(segment_values.begin()),
+                  std::make_move_iterator(segment_values.end()));
+  };
+  move_append(column.data.int_col, segment.data.int_col);
+  move_append(column.data.real_col, segment.data.real_col);
+  move_append(column.data.str_col, segment.data.str_col);
+  move_append(column.data.arr_col, segment.data.arr_col);
+  column.nulls.insert(column.nulls.end(), segment.nulls.begin(), segment.nulls.end());
+}
+
+// Fixed width numeric targets of a columnar projection can be serialized straight from
+// the result set buffer, without going through a TargetValue per row.
+bool is_direct_thrift_conversion_possible(const ResultSet& results,
+                                          const std::vector<size_t>& slot_indices,
+                                          const size_t col_idx) {
+  if (!results.isDirectColumnarConversionPossible() ||
+      results.getQueryDescriptionType() != QueryDescriptionType::Projection ||
+      !results.isPermutationBufferEmpty() ||
+      !results.isZeroCopyColumnarConversionPossible(col_idx) ||
+      slot_indices[col_idx] != col_idx) {
+    return false;
+  }
+  const auto& target_info = results.getTargetInfos()[col_idx];
+  const auto& ti = target_info.sql_type;
+  if (target_info.is_agg || get_compact_type(target_info).is_date_in_days()) {
+    return false;
+  }
+  if (ti.is_fp()) {
+    return true;
+  }
+  if (ti.is_integer() || ti.is_boolean() || ti.is_time() || ti.is_timeinterval()) {
+    return results.getPaddedSlotWidthBytes(col_idx) >= ti.get_logical_size();
+  }
+  return false;
+}
+
+void fill_thrift_column_directly(TColumn& column,
+                                 const ResultSet& results,
+                                 const size_t col_idx,
+                                 const bool nullable,
+                                 const size_t start_row,
+                                 const size_t end_row) {
+  const auto& ti = results.getTargetInfos()[col_idx].sql_type;
+  const auto col_buff = results.getColumnarBuffer(col_idx);
+  const auto stride = results.getPaddedSlotWidthBytes(col_idx);
+  column.nulls.reserve(end_row - start_row);
+  if (ti.is_fp()) {
+    const auto& query_mem_desc = results.getQueryMemDesc();
+    size_t width = stride;
+    if (ti.get_type() == kFLOAT && !query_mem_desc.forceFourByteFloat()) {
+      width = query_mem_desc.isLogicalSizedColumnsAllowed() ? sizeof(float)
+                                                            : sizeof(double);
+    }
+    auto& values = column.data.real_col;
+    values.reserve(end_row - start_row);
+    for (size_t row_idx = start_row; row_idx < end_row; ++row_idx) {
+      const auto ptr = col_buff + row_idx * stride;
+      if (ti.get_type() == kFLOAT) {
+        const float val = width == sizeof(float)
+                              ? *reinterpret_cast<const float*>(ptr)
+                              : static_cast<float>(*reinterpret_cast<const double*>(ptr));
+        values.push_back(val);
+        column.nulls.push_back(nullable && val == NULL_FLOAT);
+      } else {
+        CHECK_EQ(width, sizeof(double));
+        const auto val = *reinterpret_cast<const double*>(ptr);
+        values.push_back(val);
+        column.nulls.push_back(nullable && val == NULL_DOUBLE);
+      }
+    }
+    return;
+  }
+  const auto null_val = inline_int_null_val(ti);
+  auto& values = column.data.int_col;
+  values.reserve(end_row - start_row);
+  for (size_t row_idx = start_row; row_idx < end_row; ++row_idx) {
+    const auto val = read_int_from_buff(col_buff + row_idx * stride, stride);
+    values.push_back(val);
+    column.nulls.push_back(nullable && val == null_val);
+  }
+}
+
+}  // namespace
+
+void DBHandler::convert_columns(std::vector<TColumn>& columns,
+                                const std::vector<TargetMetaInfo>& targets,
+                                const ResultSet& results,
+                                const int32_t at_most_n) const {
+  const auto row_count = results.rowCount();
+  if (at_most_n >= 0 && row_count > static_cast<size_t>(at_most_n)) {
+    THROW_MAPD_EXCEPTION("The result contains more rows than the specified cap of " +
+                         std::to_string(at_most_n));
+  }
+  const auto col_count = results.colCount();
+  columns.resize(col_count);
+  if (row_count == 0) {
+    return;
+  }
+
+  const auto slot_indices = results.getSlotIndicesForTargetIndices();
+  std::vector<bool> direct_columns(col_count);
+  bool all_columns_direct{true};
+  for (size_t i = 0; i < col_count; ++i) {
+    direct_columns[i] = is_direct_thrift_conversion_possible(results, slot_indices, i);
+    all_columns_direct = all_columns_direct && direct_columns[i];
+  }
+  // The rows of a projection which can be read directly are the first entries of its
+  // buffer, the remaining entries are empty.
+  const auto entry_count = all_columns_direct ? row_count : results.entryCount();
+
+  auto convert_segment = [&](std::vector<TColumn>& segment,
+                             const size_t start_entry,
+                             const size_t end_entry) {
+    const auto end_row = std::min(end_entry, row_count);
+    for (size_t i = 0; i < col_count; ++i) {
+      if (direct_columns[i] && start_entry < end_row) {
+        fill_thrift_column_directly(segment[i],
+                                    results,
+                                    i,
+                                    !targets[i].get_type_info().get_notnull(),
+                                    start_entry,
+                                    end_row);
+      }
+    }
+    if (all_columns_direct) {
+      return;
+    }
+    for (size_t entry_idx = start_entry; entry_idx < end_entry; ++entry_idx) {
+      const auto crt_row = results.getRowAt(entry_idx, direct_columns);
+      if (crt_row.empty()) {
+        continue;
+      }
+      for (size_t i = 0; i < col_count; ++i) {
+        if (!direct_columns[i]) {
+          value_to_thrift_column(crt_row[i], targets[i].get_type_info(), segment[i]);
+        }
+      }
+    }
+  };
+
+  const size_t worker_count = entry_count > 10000 ? cpu_threads() : 1;
+  const auto stride = (entry_count + worker_count - 1) / worker_count;
+  std::vector<std::vector<TColumn>> segments(worker_count,
+                                             std::vector<TColumn>(col_count));
+  if (worker_count == 1) {
+    convert_segment(segments.front(), 0, entry_count);
+  } else {
+    std::vector<std::future<void>> conversion_threads;
+    for (size_t i = 0, start_entry = 0; start_entry < entry_count;
+         ++i, start_entry += stride) {
+      const auto end_entry = std::min(entry_count, start_entry + stride);
+      conversion_threads.push_back(std::async(std::launch::async,
+                                              convert_segment,
+                                              std::ref(segments[i]),
+                                              start_entry,
+                                              end_entry));
+    }
+    for (auto& child : conversion_threads) {
+      child.get();
+    }
+  }
+  for (size_t i = 0; i < col_count; ++i) {
+    for (auto& segment : segments) {
+      append_thrift_column(columns[i], segment[i]);
+    }
+  }
+}
+
 template <class R>
 void DBHandler::convert_rows(TQueryResult& _return,
                              QueryStateProxy query_state_proxy,
@@ -4910,6 +5631,13 @@ void DBHandler::convert_rows(TQueryResult& _return,
   int32_t fetched{0};
   if (column_format) {
     _return.row_set.is_columnar = true;
+    if constexpr (std::is_same<R, ResultSet>::value) {
+      // offsets and limits are only honored by the sequential iteration below
+      if (first_n == -1 && !results.isTruncated()) {
+        convert_columns(_return.row_set.columns, targets, results, at_most_n);
+        return;
+      }
+    }
     std::vector<TColumn> tcolumns(results.colCount());
     while (first_n == -1 || fetched < first_n) {
       const auto crt_row = results.getNextRow(true, true);
@@ -5163,7 +5891,7 @@ void DBHandler::sql_execute_impl(TQueryResult& _return,
           first_n,
           at_most_n,
           /*just_validate=*/false,
-          g_enable_filter_push_down && !g_cluster,
+          g_enable_filter_push_down && !g_cluster && !explain_info.explain_analyze,
           explain_info,
           executor_index);
       if (explain_info.justCalciteExplain() && filter_push_down_requests.empty()) {
@@ -5844,6 +6572,11 @@ void DBHandler::get_license_claims(TLicenseInfo& _return,
 }
 
 void DBHandler::shutdown() {
+  {
+    // commit the rows buffered by the stream ingestions
+    std::lock_guard<std::mutex> lock(stream_ingestors_mutex_);
+    stream_ingestors_.clear();
+  }
   emergency_shutdown();
 
   if (render_handler_) {
@@ -6010,7 +6743,8 @@ void DBHandler::register_runtime_extension_functions(
             mapfrom(it->sizerType), static_cast<size_t>(it->sizerArgPos)},
         mapfrom(it->inputArgTypes),
         mapfrom(it->outputArgTypes),
-        /*is_runtime =*/true);
+        /*is_runtime =*/true,
+        /*is_row_parallel =*/it->rowParallel);
   }
 
   /* Register extension functions with Calcite server */
@@ -35,6 +35,7 @@
 #include "Catalog/Catalog.h"
 #include "Fragmenter/InsertOrderFragmenter.h"
 #include "Import/Importer.h"
+#include "Import/StreamIngestor.h"
 #include "LockMgr/LockMgr.h"
 #include "Parser/ParserWrapper.h"
 #include "Parser/ReservedKeywords.h"
@@ -81,7 +82,9 @@
 #include <boost/program_options.hpp>
 #include <boost/regex.hpp>
 #include <boost/tokenizer.hpp>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
 #include <csignal>
 #include <fstream>
 #include <list>
@@ -228,6 +231,8 @@ class DBHandler : public OmniSciIf {
   void get_views(std::vector<std::string>& _return, const TSessionId& session) override;
   void get_tables_meta(std::vector<TTableMeta>& _return,
                        const TSessionId& session) override;
+  void get_deleted_rows(std::vector<TTableDeletedRows>& _return,
+                        const TSessionId& session) override;
   void get_table_details(TTableDetails& _return,
                          const TSessionId& session,
                          const std::string& table_name) override;
@@ -271,6 +276,17 @@ class DBHandler : public OmniSciIf {
                             const TSessionId& session,
                             const std::string& sql,
                             const int cursor) override;
+  void sql_execute_paged(TQueryResult& _return,
+                         const TSessionId& session,
+                         const std::string& query,
+                         const bool column_format,
+                         const std::string& nonce,
+                         const int32_t page_size) override;
+  void fetch_next(TQueryResult& _return,
+                  const TSessionId& session,
+                  const std::string& result_handle,
+                  const int32_t n) override;
+  void close_result(const TSessionId& session, const std::string& result_handle) override;
   // TODO(miyu): merge the following two data frame APIs.
   void sql_execute_df(TDataFrame& _return,
                       const TSessionId& session,
@@ -397,6 +413,17 @@ class DBHandler : public OmniSciIf {
   void import_table_status(TImportStatus& _return,
                            const TSessionId& session,
                            const std::string& import_id) override;
+  void start_stream_ingestion(const TSessionId& session,
+                              const std::string& table_name,
+                              const std::string& source_path,
+                              const TCopyParams& copy_params,
+                              const int64_t flush_row_count,
+                              const int64_t flush_interval_ms) override;
+  void stop_stream_ingestion(const TSessionId& session,
+                             const std::string& table_name) override;
+  void get_stream_ingestion_status(TStreamIngestionStatus& _return,
+                                   const TSessionId& session,
+                                   const std::string& table_name) override;
   void get_first_geo_file_in_archive(std::string& _return,
                                      const TSessionId& session,
                                      const std::string& archive_path,
@@ -652,6 +679,43 @@ class DBHandler : public OmniSciIf {
                           const size_t device_id,
                           const int32_t first_n) const;
 
+  ExecutionResult execute_rel_alg_paged(
+      TQueryResult& _return,
+      const std::string& query_ra,
+      QueryStateProxy query_state_proxy,
+      const Catalog_Namespace::SessionInfo& session_info) const;
+
+  // Result sets of paged queries, kept until fully fetched, closed, evicted or
+  // disconnected.
+  struct PagedResult {
+    std::string session_id;
+    std::string query_str;
+    std::vector<TargetMetaInfo> targets;
+    std::shared_ptr<ResultSet> rows;
+    bool column_format;
+    std::mutex fetch_mutex;
+    // Varlen values of the rows point into the chunks of the tables, the read locks on
+    // them keep TRUNCATE, DROP, UPDATE and vacuum from rewriting the chunks between
+    // pages. Results without varlen targets don't keep them.
+    lockmgr::LockedTableDescriptors table_locks;
+    size_t num_bytes{0};
+    std::chrono::steady_clock::time_point last_access;
+  };
+
+  // Drops the paged results idle for longer than the timeout, then the least recently
+  // fetched ones of the session beyond the per-session limit and the least recently
+  // fetched ones beyond the memory limit, to make room for a new result of the session
+  // (an empty session_id makes no room). Must be called with paged_results_mutex_.
+  void evictPagedResults(const std::string& session_id, const size_t new_result_bytes);
+
+  void evictPagedResultsPeriodically();
+
+  void fetch_page(TQueryResult& _return,
+                  QueryStateProxy query_state_proxy,
+                  const std::string& result_handle,
+                  PagedResult& paged_result,
+                  const int32_t n);
+
   void executeDdl(TQueryResult& _return,
                   const std::string& query_ra,
                   std::shared_ptr<Catalog_Namespace::SessionInfo const> session_ptr);
@@ -694,6 +758,12 @@ class DBHandler : public OmniSciIf {
                     const int32_t first_n,
                     const int32_t at_most_n) const;
 
+  // Converts all the rows of a result set to columns, in parallel.
+  void convert_columns(std::vector<TColumn>& columns,
+                       const std::vector<TargetMetaInfo>& targets,
+                       const ResultSet& results,
+                       const int32_t at_most_n) const;
+
   void create_simple_result(TQueryResult& _return,
                             const ResultSet& results,
                             const bool column_format,
@@ -797,6 +867,18 @@ class DBHandler : public OmniSciIf {
   mutable std::mutex handle_to_dev_ptr_mutex_;
   mutable std::unordered_map<std::string, std::string> ipc_handle_to_dev_ptr_;
 
+  std::mutex paged_results_mutex_;
+  std::unordered_map<std::string, std::shared_ptr<PagedResult>> paged_results_;
+  // Evicts the idle paged results, their table locks block writers to the tables.
+  std::condition_variable paged_results_cv_;
+  bool stop_paged_results_eviction_{false};
+  std::thread paged_results_eviction_thread_;
+
+  // Stream ingestions running in the background, by database and table id.
+  std::mutex stream_ingestors_mutex_;
+  std::map<std::pair<int, int>, std::unique_ptr<Importer_NS::StreamIngestor>>
+      stream_ingestors_;
+
   friend void run_warmup_queries(mapd::shared_ptr<DBHandler> handler,
                                  std::string base_path,
                                  std::string query_file_path);
@@ -176,6 +176,7 @@ logger::Severity StdLog::stdlogBeginSeverity(char const* func) {
       {"get_tables_meta", logger::Severity::INFO},
       {"get_table_details", logger::Severity::INFO},
       {"sql_execute", logger::Severity::INFO},
+      {"sql_execute_paged", logger::Severity::INFO},
       {"sql_execute_df", logger::Severity::INFO},
       {"sql_execute_gdf", logger::Severity::INFO},
       {"sql_validate", logger::Severity::INFO},
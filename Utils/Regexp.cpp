@@ -26,6 +26,45 @@
 
 #ifndef __CUDACC__
 #include <boost/regex.hpp>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace {
+
+// Most threads only see the few distinct patterns of the REGEXP_LIKE calls of a query.
+constexpr size_t kMaxCompiledRegexpsPerThread{16};
+
+// The pattern of REGEXP_LIKE is a literal in practice, the same for all the rows of a
+// query: every thread keeps the regexps it compiled by pattern, up to a few of them, and
+// only compiles the patterns it hasn't seen. Returns nullptr if the pattern isn't a valid
+// regexp.
+const boost::regex* get_compiled_regexp(const char* pattern, const int32_t pat_len) {
+  // std::less<> allows the lookup by std::string_view, without copying the pattern
+  thread_local std::map<std::string, std::unique_ptr<const boost::regex>, std::less<>>
+      compiled_regexps;
+  const std::string_view pattern_view(pattern, pat_len);
+  const auto it = compiled_regexps.find(pattern_view);
+  if (it != compiled_regexps.end()) {
+    return it->second.get();
+  }
+  if (compiled_regexps.size() >= kMaxCompiledRegexpsPerThread) {
+    compiled_regexps.clear();
+  }
+  std::unique_ptr<const boost::regex> compiled_regexp;
+  try {
+    compiled_regexp =
+        std::make_unique<const boost::regex>(pattern, pat_len, boost::regex::extended);
+  } catch (std::runtime_error& error) {
+    // LOG(ERROR) << "Regexp compilation error: " << error.what();
+  }
+  return compiled_regexps.emplace(pattern_view, std::move(compiled_regexp))
+      .first->second.get();
+}
+
+}  // namespace
 #endif
 
 /*
@@ -43,11 +82,13 @@ extern "C" DEVICE bool regexp_like(const char* str,
                                    const int32_t pat_len,
                                    const char escape_char) {
 #ifndef __CUDACC__
+  const auto re = get_compiled_regexp(pattern, pat_len);
+  if (!re) {
+    return false;
+  }
   bool result;
   try {
-    boost::regex re(pattern, pat_len, boost::regex::extended);
-    boost::cmatch what;
-    result = boost::regex_match(str, str + str_len, what, re);
+    result = boost::regex_match(str, str + str_len, *re);
   } catch (std::runtime_error& error) {
     // LOG(ERROR) << "Regexp match error: " << error.what();
     result = false;
@@ -130,6 +130,36 @@ enum TQueryType {
   SCHEMA_WRITE
 }
 
+struct TKernelProfile {
+  1: common.TDeviceType device_type
+  2: i32 device_id
+  3: list<i64> fragment_ids
+  4: i64 duration_us
+}
+
+struct TQueryStepProfile {
+  1: i32 node_id
+  2: string node_name
+  3: i64 input_rows
+  4: i64 output_rows
+  5: i64 fragments_scanned
+  6: i64 fragments_skipped
+  7: i64 cpu_bytes_fetched
+  8: i64 gpu_bytes_fetched
+  9: i32 hash_tables
+  10: i32 hash_table_cache_hits
+  11: i64 hash_table_build_time_us
+  12: i64 compilation_time_us
+  13: i32 code_cache_hits
+  14: i32 code_cache_misses
+  15: i64 execution_time_us
+  16: list<TKernelProfile> kernels
+}
+
+struct TQueryProfile {
+  1: list<TQueryStepProfile> steps
+}
+
 struct TQueryResult {
   1: TRowSet row_set
   2: i64 execution_time_ms
@@ -138,6 +168,8 @@ struct TQueryResult {
   5: string debug
   6: bool success=true
   7: TQueryType query_type=TQueryType.UNKNOWN
+  8: string result_handle
+  9: optional TQueryProfile profile
 }
 
 struct TDataFrame {
@@ -201,6 +233,14 @@ struct TImportStatus {
   4: i64 rows_rejected
 }
 
+struct TStreamIngestionStatus {
+  1: bool running
+  2: i64 rows_loaded
+  3: i64 rows_rejected
+  4: i64 committed_offset
+  5: string error
+}
+
 struct TFrontendView {
   1: string view_name
   2: string view_state
@@ -294,6 +334,15 @@ struct TNodeMemoryInfo {
   6: list<TMemoryData> node_memory_data
 }
 
+struct TTableDeletedRows {
+  1: string table_name
+  2: i64 num_rows
+  3: i64 num_deleted_rows
+  4: double deleted_ratio
+  5: i64 num_fragments
+  6: i64 num_fragments_to_vacuum
+}
+
 struct TTableMeta {
   1: string table_name
   2: i64 num_cols
@@ -514,6 +563,7 @@ service OmniSci {
   list<string> get_physical_tables(1: TSessionId session) throws (1: TOmniSciException e)
   list<string> get_views(1: TSessionId session) throws (1: TOmniSciException e)
   list<TTableMeta> get_tables_meta(1: TSessionId session) throws (1: TOmniSciException e)
+  list<TTableDeletedRows> get_deleted_rows(1: TSessionId session) throws (1: TOmniSciException e)
   TTableDetails get_table_details(1: TSessionId session, 2: string table_name) throws (1: TOmniSciException e)
   TTableDetails get_internal_table_details(1: TSessionId session, 2: string table_name) throws (1: TOmniSciException e)
   list<string> get_users(1: TSessionId session) throws (1: TOmniSciException e)
@@ -532,6 +582,9 @@ service OmniSci {
   TSessionInfo get_session_info(1: TSessionId session) throws (1: TOmniSciException e)
   # query, render
   TQueryResult sql_execute(1: TSessionId session, 2: string query 3: bool column_format, 4: string nonce, 5: i32 first_n = -1, 6: i32 at_most_n = -1) throws (1: TOmniSciException e)
+  TQueryResult sql_execute_paged(1: TSessionId session, 2: string query 3: bool column_format, 4: string nonce, 5: i32 page_size) throws (1: TOmniSciException e)
+  TQueryResult fetch_next(1: TSessionId session, 2: string result_handle, 3: i32 n) throws (1: TOmniSciException e)
+  void close_result(1: TSessionId session, 2: string result_handle) throws (1: TOmniSciException e)
   TDataFrame sql_execute_df(1: TSessionId session, 2: string query 3: common.TDeviceType device_type 4: i32 device_id = 0 5: i32 first_n = -1) throws (1: TOmniSciException e)
   TDataFrame sql_execute_gdf(1: TSessionId session, 2: string query 3: i32 device_id = 0, 4: i32 first_n = -1) throws (1: TOmniSciException e)
   void deallocate_df(1: TSessionId session, 2: TDataFrame df, 3: common.TDeviceType device_type, 4: i32 device_id = 0) throws (1: TOmniSciException e)
@@ -563,6 +616,9 @@ service OmniSci {
   void import_table(1: TSessionId session, 2: string table_name, 3: string file_name, 4: TCopyParams copy_params) throws (1: TOmniSciException e)
   void import_geo_table(1: TSessionId session, 2: string table_name, 3: string file_name, 4: TCopyParams copy_params, 5: TRowDescriptor row_desc, 6: TCreateParams create_params) throws (1: TOmniSciException e)
   TImportStatus import_table_status(1: TSessionId session, 2: string import_id) throws (1: TOmniSciException e)
+  void start_stream_ingestion(1: TSessionId session, 2: string table_name, 3: string source_path, 4: TCopyParams copy_params, 5: i64 flush_row_count, 6: i64 flush_interval_ms) throws (1: TOmniSciException e)
+  void stop_stream_ingestion(1: TSessionId session, 2: string table_name) throws (1: TOmniSciException e)
+  TStreamIngestionStatus get_stream_ingestion_status(1: TSessionId session, 2: string table_name) throws (1: TOmniSciException e)
   string get_first_geo_file_in_archive(1: TSessionId session, 2: string archive_path, 3: TCopyParams copy_params) throws (1: TOmniSciException e)
   list<string> get_all_files_in_archive(1: TSessionId session, 2: string archive_path, 3: TCopyParams copy_params) throws (1: TOmniSciException e)
   list<TGeoFileLayerInfo> get_layers_in_geo_file(1: TSessionId session, 2: string file_name, 3: TCopyParams copy_params) throws (1: TOmniSciException e)